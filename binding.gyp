@@ -1,27 +1,101 @@
 {
-    "variables": {"openssl_fips": ""},
-    "targets": [
-        {
-            "target_name": "addon",
-            "sources": [
-                "native/src/addon.cpp",
-                "native/src/AudioSwitcher/AudioSwitcher.cpp",
-                "native/src/Utility/DeviceUtils.cpp",
-                "native/src/Utility/COMInitializer.cpp",
-            ],
-            "include_dirs": [
-                "native/include",
-                "node_modules/node-addon-api",
-                "<!(node -p \"require('node-addon-api').include\")",
-                "<!(node -p \"require('node-addon-api').include_dir\")",
-                "<!(node -p \"require('node-addon-api').include.replace(/\\/include$/, '') + '/include/node')\"",
-            ],
-            "defines": ["NAPI_CPP_EXCEPTIONS"],
-            "cflags_cc": ["/std:c++17"],
-            "conditions": [
-                [
-                    "OS=='win'",
+    "variables": {
+        "openssl_fips": "",
+        # Set to 1 (node-gyp rebuild -- -Dnative_tests=1) to also build the portable native
+        # test runner on Windows. It is always built elsewhere, where it is the only target.
+        "native_tests%": "0",
+        # Sanitizer for native_tests on Linux/macOS, e.g. -Dnative_sanitizer=thread for the
+        # lock-free stress tests. Empty builds without one.
+        "native_sanitizer%": "",
+    },
+    "conditions": [
+        [
+            "OS=='win'",
+            {
+                "targets": [
                     {
+                        "target_name": "addon",
+                        "sources": [
+                            "native/src/addon.cpp",
+                            "native/src/AudioSwitcher/AudioSwitcher.cpp",
+                            "native/src/Utility/DeviceUtils.cpp",
+                            "native/src/Utility/COMInitializer.cpp",
+                            "native/src/Utility/ComWorker.cpp",
+                            "native/src/Utility/OperationSupervisor.cpp",
+                            "native/src/Utility/StringUtils.cpp",
+                            "native/src/Utility/AudioRuntime.cpp",
+                            "native/src/Utility/Logger.cpp",
+                            "native/src/Utility/EpochDomain.cpp",
+                            "native/src/Utility/OutputFile.cpp",
+                            "native/src/Utility/Md5.cpp",
+                            "native/src/AudioSwitcher/DeviceSnapshot.cpp",
+                            "native/src/AudioSwitcher/ListenRouting.cpp",
+                            "native/src/AudioSwitcher/AudioEffects.cpp",
+                            "native/src/AudioSwitcher/ProcessInfoCache.cpp",
+                            "native/src/AudioSwitcher/Win32ProcessTable.cpp",
+                            "native/src/AudioSwitcher/SessionProcessTracker.cpp",
+                            "native/src/AudioSwitcher/SessionSnapshot.cpp",
+                            "native/src/AudioSwitcher/NotificationDispatcher.cpp",
+                            "native/src/AudioSwitcher/EndpointNotifier.cpp",
+                            "native/src/AudioSwitcher/EndpointKey.cpp",
+                            "native/src/AudioSwitcher/ServiceRecovery.cpp",
+                            "native/src/AudioSwitcher/DefaultHistory.cpp",
+                            "native/src/AudioSwitcher/AppRouting.cpp",
+                            "native/src/AudioSwitcher/Win32AppPolicy.cpp",
+                            "native/src/AudioSwitcher/TopologyGraph.cpp",
+                            "native/src/AudioSwitcher/DeviceTopology.cpp",
+                            "native/src/AudioSwitcher/JackPresence.cpp",
+                            "native/src/Dsp/SimdKernels.cpp",
+                            "native/src/Dsp/PolyphaseResampler.cpp",
+                            "native/src/Dsp/DriftController.cpp",
+                            "native/src/Dsp/SignalGenerator.cpp",
+                            "native/src/Dsp/Fft.cpp",
+                            "native/src/Dsp/DelayEstimator.cpp",
+                            "native/src/Dsp/WavDecoder.cpp",
+                            "native/src/Dsp/WavEncoder.cpp",
+                            "native/src/Dsp/FlacEncoder.cpp",
+                            "native/src/Dsp/FlacDecoder.cpp",
+                            "native/src/Dsp/VoiceActivity.cpp",
+                            "native/src/Streaming/PassthroughPipe.cpp",
+                            "native/src/Streaming/PassthroughRouter.cpp",
+                            "native/src/Streaming/SharedModeClient.cpp",
+                            "native/src/Streaming/SignalPlayer.cpp",
+                            "native/src/Streaming/LatencyProbe.cpp",
+                            "native/src/Streaming/AggregatePipe.cpp",
+                            "native/src/Streaming/AggregateRenderer.cpp",
+                            "native/src/Streaming/ClipMixer.cpp",
+                            "native/src/Streaming/ClipPlayer.cpp",
+                            "native/src/Streaming/RecordingSink.cpp",
+                            "native/src/Streaming/CaptureRecorder.cpp",
+                            "native/src/Streaming/VoiceActivityBank.cpp",
+                            "native/src/Streaming/VoiceActivityMonitor.cpp",
+                            "native/src/Bindings/BindingUtils.cpp",
+                            "native/src/Bindings/SnapshotBindings.cpp",
+                            "native/src/Bindings/RouterBindings.cpp",
+                            "native/src/Bindings/SessionBindings.cpp",
+                            "native/src/Bindings/NotificationBindings.cpp",
+                            "native/src/Bindings/LogBindings.cpp",
+                            "native/src/Bindings/RecoveryBindings.cpp",
+                            "native/src/Bindings/SwitchBindings.cpp",
+                            "native/src/Bindings/AppRoutingBindings.cpp",
+                            "native/src/Bindings/TopologyBindings.cpp",
+                            "native/src/Bindings/SignalBindings.cpp",
+                            "native/src/Bindings/LatencyBindings.cpp",
+                            "native/src/Bindings/AggregateBindings.cpp",
+                            "native/src/Bindings/ClipBindings.cpp",
+                            "native/src/Bindings/RecorderBindings.cpp",
+                            "native/src/Bindings/VoiceActivityBindings.cpp",
+                        ],
+                        "include_dirs": [
+                            "native/include",
+                            "node_modules/node-addon-api",
+                            "<!(node -p \"require('node-addon-api').include\")",
+                            "<!(node -p \"require('node-addon-api').include_dir\")",
+                            "<!(node -p \"require('node-addon-api').include.replace(/\\/include$/, '') + '/include/node')\"",
+                        ],
+                        "defines": ["NAPI_CPP_EXCEPTIONS"],
+                        "cflags_cc": ["/std:c++17"],
+                        "libraries": ["avrt.lib", "runtimeobject.lib"],
                         "msvs_settings": {
                             "VCCLCompilerTool": {
                                 "ExceptionHandling": 1,
@@ -31,8 +105,127 @@
                         },
                         # "msvs_windows_target_platform_version": "10.0.26100.0"
                     },
+                    {
+                        # Standalone CLI (audioswitch.exe) built from the same native sources, for
+                        # scripts that cannot afford Node startup. Static CRT keeps load time minimal.
+                        "target_name": "audioswitch",
+                        "type": "executable",
+                        "variables": {"win_delay_load_hook": "false"},
+                        "sources": [
+                            "native/src/Cli/AudioSwitchCli.cpp",
+                            "native/src/AudioSwitcher/AudioSwitcher.cpp",
+                            "native/src/AudioSwitcher/EndpointKey.cpp",
+                            "native/src/AudioSwitcher/ServiceRecovery.cpp",
+                            "native/src/Utility/DeviceUtils.cpp",
+                            "native/src/Utility/COMInitializer.cpp",
+                            "native/src/Utility/StringUtils.cpp",
+                            "native/src/Utility/AudioRuntime.cpp",
+                            "native/src/Utility/Logger.cpp",
+                        ],
+                        "include_dirs": ["native/include"],
+                        "msvs_settings": {
+                            "VCCLCompilerTool": {
+                                "ExceptionHandling": 1,
+                                "RuntimeLibrary": 0,
+                            },
+                            "VCLinkerTool": {
+                                "SubSystem": 1,
+                                "AdditionalDependencies": ["ole32.lib"],
+                            },
+                            "PlatformToolset": "v143",
+                        },
+                    },
+                ]
+            },
+        ],
+        [
+            "OS!='win' or native_tests==1",
+            {
+                "targets": [
+                    {
+                        # Tests and benchmarks for the platform-independent native code (DSP,
+                        # lock-free structures). Run with `npm run dev:test:native`.
+                        "target_name": "native_tests",
+                        "type": "executable",
+                        "variables": {"win_delay_load_hook": "false"},
+                        "sources": [
+                            "test/native/TestMain.cpp",
+                            "test/native/PassthroughTests.cpp",
+                            "test/native/ResamplerTests.cpp",
+                            "test/native/ProcessCacheTests.cpp",
+                            "test/native/NotificationTests.cpp",
+                            "test/native/LoggerTests.cpp",
+                            "test/native/EndpointKeyTests.cpp",
+                            "test/native/RcuTests.cpp",
+                            "test/native/ServiceRecoveryTests.cpp",
+                            "test/native/DefaultHistoryTests.cpp",
+                            "test/native/AppRoutingTests.cpp",
+                            "test/native/TopologyTests.cpp",
+                            "test/native/JackPresenceTests.cpp",
+                            "test/native/SignalTests.cpp",
+                            "test/native/LatencyTests.cpp",
+                            "test/native/AggregateTests.cpp",
+                            "test/native/ClipTests.cpp",
+                            "test/native/RecorderTests.cpp",
+                            "test/native/FlacTests.cpp",
+                            "test/native/VoiceActivityTests.cpp",
+                            "native/src/Dsp/SimdKernels.cpp",
+                            "native/src/Dsp/PolyphaseResampler.cpp",
+                            "native/src/Dsp/DriftController.cpp",
+                            "native/src/Dsp/SignalGenerator.cpp",
+                            "native/src/Dsp/Fft.cpp",
+                            "native/src/Dsp/DelayEstimator.cpp",
+                            "native/src/Dsp/WavDecoder.cpp",
+                            "native/src/Dsp/WavEncoder.cpp",
+                            "native/src/Dsp/FlacEncoder.cpp",
+                            "native/src/Dsp/FlacDecoder.cpp",
+                            "native/src/Dsp/VoiceActivity.cpp",
+                            "native/src/Streaming/PassthroughPipe.cpp",
+                            "native/src/Streaming/AggregatePipe.cpp",
+                            "native/src/Streaming/ClipMixer.cpp",
+                            "native/src/Streaming/RecordingSink.cpp",
+                            "native/src/Streaming/VoiceActivityBank.cpp",
+                            "native/src/AudioSwitcher/ProcessInfoCache.cpp",
+                            "native/src/AudioSwitcher/SessionProcessTracker.cpp",
+                            "native/src/AudioSwitcher/NotificationDispatcher.cpp",
+                            "native/src/AudioSwitcher/EndpointKey.cpp",
+                            "native/src/AudioSwitcher/ServiceRecovery.cpp",
+                            "native/src/AudioSwitcher/DefaultHistory.cpp",
+                            "native/src/AudioSwitcher/AppRouting.cpp",
+                            "native/src/AudioSwitcher/TopologyGraph.cpp",
+                            "native/src/AudioSwitcher/JackPresence.cpp",
+                            "native/src/Utility/Logger.cpp",
+                            "native/src/Utility/EpochDomain.cpp",
+                            "native/src/Utility/OutputFile.cpp",
+                            "native/src/Utility/Md5.cpp",
+                        ],
+                        "include_dirs": ["native/include", "test/native"],
+                        "cflags_cc": ["-std=c++17", "-pthread"],
+                        "cflags_cc!": ["-fno-exceptions", "-fno-rtti", "-std=gnu++17"],
+                        "ldflags": ["-pthread"],
+                        "xcode_settings": {
+                            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+                            "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+                        },
+                        "msvs_settings": {
+                            "VCCLCompilerTool": {
+                                "ExceptionHandling": 1,
+                                "AdditionalOptions": ["/std:c++17"],
+                            },
+                            "VCLinkerTool": {"SubSystem": 1},
+                        },
+                        "conditions": [
+                            [
+                                "native_sanitizer!=''",
+                                {
+                                    "cflags_cc": ["-fsanitize=<(native_sanitizer)", "-g", "-fno-omit-frame-pointer"],
+                                    "ldflags": ["-fsanitize=<(native_sanitizer)"],
+                                },
+                            ]
+                        ],
+                    }
                 ]
-            ],
-        }
+            },
+        ],
     ],
 }
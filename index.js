@@ -7,11 +7,50 @@
  *              - Device enumeration
  *              - Default device configuration
  *              - Mute control for both default and specific devices
+ *              - Watchdog deadlines for native calls (hung-driver isolation)
+ *              - Daemon mode so many processes share one audio state service
+ *              - In-memory device snapshot with "Listen to this device" routing
+ *              - Audio enhancement / spatial sound state per endpoint
+ *              - Drift-compensated software passthrough between any two endpoints
+ *              - Audio session listings with cached process names
+ *              - Batched endpoint change notifications from a native dispatcher thread
+ *              - Asynchronous native logging (off by default) to a callback or file
+ *              - Automatic recovery (with state replay) when the Windows Audio service restarts
+ *              - "Switch back" and cycling of the default device from a per-role history
+ *              - Per-application output/input devices, applied in batches
+ *              - Cached hardware topology: hardware volume/mute support, subunits, jacks
+ *              - Jack presence per endpoint and `jackConnected` events for auto-switching
+ *              - Test and calibration signals (sine, sweep, white/pink noise, clicks) per endpoint
+ *              - Output latency measurement (MLS/chirp, loopback or microphone) per endpoint
+ *
+ *              The native binary (`build/Release/addon.node`, built locally or unpacked there
+ *              by prebuild-install) is only loaded on the first call, so `require()` stays
+ *              cheap for short-lived scripts that may never touch audio.
  * 
  * @author [sameerbk201]
  * @copyright [2025] [sameerbk201]
  */
-const addon = require('./build/Release/addon.node');
+let addon = null;
+
+/**
+ * Resolves and loads the native addon on first use.
+ * @returns {object} The native addon exports
+ */
+function loadAddon() {
+    if (!addon) addon = require('./build/Release/addon.node');
+    return addon;
+}
+
+/**
+ * Wraps a native export so the addon is loaded by the first call rather than by require().
+ * @param {string} name - Name of the native export
+ * @returns {Function} Forwarding function
+ */
+function lazy(name) {
+    return function (...args) {
+        return loadAddon()[name](...args);
+    };
+}
 /**
  * Retrieves all available audio playback devices on the system.
  * @function listDevices
@@ -75,10 +114,776 @@ const addon = require('./build/Release/addon.node');
  *   muteDeviceById(speakers.id, true);
  * }
  */
+
+/**
+ * Enables watchdog-supervised execution of native calls.
+ * With a positive timeout every native call runs on a dedicated COM worker thread; if it
+ * misses the deadline the caller gets an Error with `code === 'ETIMEDOUT'`, the stuck worker
+ * is replaced, and the device is marked hung so further calls to it fail fast with
+ * `code === 'EDEVICEHUNG'` until the stuck call returns.
+ * @function setOperationTimeout
+ * @param {number} timeoutMs - Deadline in milliseconds, 0 to disable (default)
+ *
+ * @example
+ * const { setOperationTimeout, muteDeviceById } = require('node-windows-audio-manager-switcher');
+ * setOperationTimeout(2000);
+ * try {
+ *   muteDeviceById(bluetoothId, true);
+ * } catch (err) {
+ *   if (err.code === 'ETIMEDOUT' || err.code === 'EDEVICEHUNG') {
+ *     console.warn('Device driver is not responding');
+ *   }
+ * }
+ */
+
+/**
+ * Returns the current watchdog deadline.
+ * @function getOperationTimeout
+ * @returns {number} Timeout in milliseconds (0 = supervision disabled)
+ */
+
+/**
+ * Returns the per-device health tracked by the watchdog.
+ * @function getDeviceHealth
+ * @returns {Array<DeviceHealth>} Array of health records
+ * @property {string} id - Device ID, or `enumerate` / `default:render` for non-device calls
+ * @property {'healthy'|'slow'|'hung'} state - Current classification
+ * @property {number} timeouts - Number of calls that missed their deadline
+ * @property {number} lastLatencyMs - Latency of the last completed call
+ * @property {boolean} pending - True while a timed-out call is still stuck in the driver
+ */
+
+/**
+ * Forgets the health record of a device so the next call is attempted immediately.
+ * @function resetDeviceHealth
+ * @param {string} deviceId - Device ID (or pseudo key) from getDeviceHealth
+ */
+
+/**
+ * Returns all active render and capture endpoints from the native in-memory snapshot.
+ * The snapshot is built on the first call and served from memory afterwards.
+ * @function getDeviceSnapshot
+ * @param {object} [options]
+ * @param {boolean} [options.refresh=false] - Re-enumerate endpoints before answering
+ * @param {boolean} [options.effects=false] - Also load enhancement / spatial audio state (cached)
+ * @param {boolean} [options.jacks=false] - Also load jack presence (cached, kept current by notifications)
+ * @returns {Array<EndpointInfo>} Array of endpoints
+ * @property {string} id - Endpoint ID
+ * @property {string} name - Friendly name
+ * @property {'render'|'capture'} flow - Data flow
+ * @property {boolean} isDefault - Default for the console role
+ * @property {{console: boolean, multimedia: boolean, communications: boolean}} defaultRoles - Per-role default flags
+ * @property {{enabled: boolean, targetId: string}} [listen] - "Listen to this device" settings (capture only)
+ * @property {{enhancements: EffectState, spatialAudio: EffectState, spatialMaxObjects: number}} [effects] -
+ *           Present once effects were loaded; EffectState is 'enabled' | 'disabled' | 'unknown'
+ * @property {{present: boolean, connected: boolean, color?: string, connectionType?: string,
+ *           geoLocation?: string}} [jack] - Present once jacks were loaded; color is '#rrggbb'
+ */
+
+/**
+ * Returns audio enhancement and spatial sound state of every endpoint in one native call.
+ * Loaded into the device snapshot on first use and served from memory afterwards.
+ * @function getAudioEffects
+ * @param {object} [options]
+ * @param {boolean} [options.refresh=false] - Re-enumerate endpoints (and re-read effects)
+ * @returns {Array<{id: string, name: string, flow: 'render'|'capture', enhancements: string,
+ *          spatialAudio: string, spatialMaxObjects: number}>} States are 'enabled' | 'disabled' | 'unknown'
+ *
+ * @example
+ * const { getAudioEffects } = require('node-windows-audio-manager-switcher');
+ * const slow = getAudioEffects().filter(e => e.enhancements === 'enabled' || e.spatialAudio === 'enabled');
+ */
+
+/**
+ * Returns the "Listen to this device" routing of every capture endpoint, from memory.
+ * @function getListenRouting
+ * @returns {Array<{deviceId: string, name: string, enabled: boolean, targetId: string, targetName: string}>}
+ *          An empty targetId means "Default Playback Device"
+ */
+
+/**
+ * Sets "Listen to this device" routing for several capture endpoints in one native call.
+ * @function setListenRouting
+ * @param {Array<{deviceId: string, enabled: boolean, targetId?: string}>} changes - Changes to apply
+ * @returns {Array<boolean>} One result per change
+ *
+ * @example
+ * const { getDeviceSnapshot, setListenRouting } = require('node-windows-audio-manager-switcher');
+ * const endpoints = getDeviceSnapshot();
+ * const mic = endpoints.find(e => e.flow === 'capture');
+ * const speakers = endpoints.find(e => e.flow === 'render' && e.name.includes('Speakers'));
+ * setListenRouting([{ deviceId: mic.id, enabled: true, targetId: speakers.id }]);
+ */
+
+/**
+ * Starts streaming audio from one endpoint to another (microphone to speakers, or loopback
+ * of one output to another). Works across devices with different clocks and sample rates:
+ * clock drift is compensated by adaptive resampling so the route holds its latency target.
+ * @function startPassthrough
+ * @param {object} [options]
+ * @param {string} [options.captureId] - Source endpoint (default capture device, or default
+ *        render device with `loopback`)
+ * @param {string} [options.renderId] - Destination endpoint (default render device)
+ * @param {boolean} [options.loopback=false] - Capture what a render endpoint is playing
+ * @param {number} [options.latencyMs=40] - Target buffered audio (raised to at least one
+ *        period of each device)
+ * @returns {number} Route id
+ *
+ * @example
+ * const { startPassthrough, getPassthroughStats, stopPassthrough } = require('node-windows-audio-manager-switcher');
+ * const route = startPassthrough({ captureId: micId, renderId: headsetId, latencyMs: 30 });
+ * setInterval(() => console.log(getPassthroughStats(route)), 1000);
+ */
+
+/**
+ * Stops a passthrough route and releases both endpoints.
+ * @function stopPassthrough
+ * @param {number} id - Route id from startPassthrough
+ * @returns {boolean} False if the route did not exist
+ */
+
+/**
+ * Returns the counters of a passthrough route, or null for an unknown id.
+ * @function getPassthroughStats
+ * @param {number} id - Route id from startPassthrough
+ * @returns {PassthroughStats|null}
+ * @property {boolean} running - False once stopped or failed
+ * @property {string|null} error - Why the route stopped on its own (e.g. device removed)
+ * @property {number} captureRate - Source sample rate
+ * @property {number} renderRate - Destination sample rate
+ * @property {number} underruns - Render periods that ran out of audio
+ * @property {number} overruns - Capture packets dropped because the buffer was full
+ * @property {number} capturedFrames - Frames received from the source
+ * @property {number} renderedFrames - Frames written to the destination
+ * @property {number} latencyMs - Current (smoothed) buffered audio
+ * @property {number} targetLatencyMs - Latency target
+ * @property {number} driftPpm - Current clock drift correction
+ */
+
+/**
+ * Lists audio sessions (one per app stream) with the owning process. Process names are
+ * cached by pid + start time and resolved on background threads, so this returns
+ * immediately; sessions whose process is not resolved yet have `processResolved: false`.
+ * @function listAudioSessions
+ * @param {object} [options]
+ * @param {string} [options.deviceId] - Only sessions on this render endpoint (default: all)
+ * @param {boolean} [options.waitForNames=false] - Block until every process name is resolved
+ * @returns {Array<AudioSession>} Array of sessions
+ * @property {string} deviceId - Render endpoint of the session
+ * @property {string} sessionId - Session instance identifier
+ * @property {number} pid - Owning process id
+ * @property {string|null} processName - Executable name, e.g. "chrome.exe"
+ * @property {string|null} processPath - Full image path (null if access was denied)
+ * @property {boolean} processResolved - False while the name is still being looked up
+ * @property {string} displayName - Name set by the application (often empty)
+ * @property {string} iconPath - Icon set by the application (often empty)
+ * @property {'active'|'inactive'|'expired'} state - Session state
+ * @property {number} volume - Session volume (0.0 - 1.0)
+ * @property {boolean} muted - Session mute state
+ * @property {boolean} isSystemSounds - The shared "System Sounds" session
+ *
+ * @example
+ * const { listAudioSessions } = require('node-windows-audio-manager-switcher');
+ * listAudioSessions({ waitForNames: true })
+ *     .filter(s => s.state === 'active')
+ *     .forEach(s => console.log(`${s.processName} (${s.pid}) at ${Math.round(s.volume * 100)}%`));
+ */
+
+/**
+ * Returns counters of the session process-info cache.
+ * @function getSessionCacheStats
+ * @returns {{hits: number, misses: number, resolutions: number, evictions: number,
+ *            invalidations: number, size: number, pending: number}}
+ */
+
+/**
+ * Starts delivering endpoint change notifications (default device, add/remove, state,
+ * property and volume/mute changes). Core Audio callbacks are queued lock-free on the
+ * threads that raise them and delivered by a dedicated native thread in batches: bursts
+ * within the batch window are folded per endpoint, and default/volume changes that repeat
+ * the last delivered value are dropped. Calling it again replaces the subscription.
+ * @function startNotifications
+ * @param {function(Array<AudioNotification>): void} callback - Receives one batch per call
+ * @param {object} [options]
+ * @param {number} [options.batchWindowMs=2] - How long to collect after the first callback of a burst
+ * @param {string} [options.mmcss] - MMCSS task for the dispatcher thread, e.g. 'Audio' or 'Pro Audio'
+ * @returns {void}
+ * @property {'defaultChanged'|'deviceAdded'|'deviceRemoved'|'stateChanged'|'propertyChanged'|'volumeChanged'|
+ *           'serviceRestarted'|'jackConnected'} type
+ * @property {string} deviceId - Endpoint id ('' when a role has no default endpoint)
+ * @property {number} coalesced - Callbacks folded into this event
+ * @property {'render'|'capture'} [flow] - defaultChanged and jackConnected only
+ * @property {'console'|'multimedia'|'communications'} [role] - defaultChanged only
+ * @property {'active'|'disabled'|'unplugged'|'notpresent'} [state] - stateChanged only
+ * @property {number} [volume] - volumeChanged only (0.0 - 1.0)
+ * @property {boolean} [muted] - volumeChanged only
+ * @property {{present: boolean, connected: boolean, color?: string, connectionType?: string,
+ *           geoLocation?: string}} [jack] - jackConnected only: a plug went into a jack of a
+ *           non-default endpoint (follows the add, state or property change that revealed it)
+ *
+ * @example
+ * const { startNotifications } = require('node-windows-audio-manager-switcher');
+ * startNotifications((events) => {
+ *     for (const e of events) if (e.type === 'defaultChanged') console.log(`${e.flow}/${e.role} -> ${e.deviceId}`);
+ * }, { mmcss: 'Audio' });
+ */
+
+/**
+ * Stops endpoint change notifications.
+ * @function stopNotifications
+ * @returns {boolean} True if notifications were running
+ */
+
+/**
+ * Returns notification dispatcher metrics, or null if notifications are not running.
+ * Latencies are measured from the Core Audio callback to the hand-off by the dispatcher
+ * thread (`dispatchLatencyUs`) and to the JS callback (`deliveryLatencyUs`).
+ * @function getNotificationStats
+ * @param {object} [options]
+ * @param {boolean} [options.reset=false] - Restart latency and high-water tracking after reading
+ * @returns {{posted: number, coalesced: number, suppressed: number, delivered: number, batches: number,
+ *            queueDepth: number, queueHighWater: number, watchedEndpoints: number, mmcss: boolean,
+ *            dispatchLatencyUs: LatencyStats, deliveryLatencyUs: LatencyStats}|null}
+ *          LatencyStats is `{ count, last, average, max }` in microseconds
+ */
+
+/**
+ * Configures native logging, which is off by default. Native code records into per-thread
+ * lock-free buffers and a background thread formats and delivers them every ~20 ms, so
+ * logging never blocks an audio call. Pass `null` or `{ level: 'off' }` to disable.
+ * @function setLogging
+ * @param {object|null} options
+ * @param {'trace'|'debug'|'info'|'warn'|'error'|'off'} [options.level='info'] - Minimum level kept
+ * @param {function(Array<{time: number, level: string, component: string, thread: number, message: string}>): void}
+ *        [options.callback] - Receives batches of records (`time` in epoch ms)
+ * @param {string} [options.file] - Append formatted lines to this file instead
+ * @returns {void}
+ *
+ * @example
+ * const { setLogging } = require('node-windows-audio-manager-switcher');
+ * setLogging({ level: 'debug', callback: (records) => records.forEach((r) => console.log(`[${r.component}] ${r.message}`)) });
+ */
+
+/**
+ * Returns native logger counters.
+ * @function getLogStats
+ * @returns {{level: string, written: number, dropped: number, threads: number}} `dropped` counts
+ *          records lost because a thread logged faster than the buffers were drained
+ */
+
+/**
+ * Returns audio service restart recovery counters. While the Windows Audio service is
+ * down, calls throw an Error with `code === 'ESERVICELOST'` (and the failing `hresult`);
+ * a native thread waits for the service with exponential backoff, recreates cached COM
+ * objects, re-registers notifications (which then deliver `{ type: 'serviceRestarted' }`)
+ * and replays the default device and mutes set through this module.
+ * @function getServiceRecoveryStats
+ * @returns {{recovering: boolean, detections: number, restarts: number, attempts: number,
+ *            lastCause: number, lastDowntimeMs: number}}
+ */
+
+/**
+ * Switches the default device back to the one that was default before the current one.
+ * The target comes from a native per-role history (most recent first) kept from
+ * default-changed notifications and from switches made through this module; endpoints
+ * that are no longer active are skipped. Only one SetDefaultEndpoint call is made per
+ * role, with no enumeration once the device snapshot is loaded.
+ * @function switchToPrevious
+ * @param {'console'|'multimedia'|'communications'|'all'} [role='console']
+ * @param {object} [options]
+ * @param {'render'|'capture'} [options.flow='render']
+ * @returns {string|null} ID of the new default, or null if there is nothing to switch back to
+ *
+ * @example
+ * const { switchToPrevious } = require('node-windows-audio-manager-switcher');
+ * switchToPrevious('all'); // toggle headset <-> speakers
+ */
+
+/**
+ * Makes the next of a set of devices the default, wrapping around after the last one.
+ * @function cycleDefault
+ * @param {'console'|'multimedia'|'communications'|'all'} [role='console']
+ * @param {object} [filter]
+ * @param {'render'|'capture'} [filter.flow='render']
+ * @param {Array<string>} [filter.ids] - Candidates in cycling order (default: all active devices)
+ * @param {string} [filter.name] - Keep only devices whose name contains this (case-insensitive)
+ * @returns {string|null} ID of the new default, or null if no other candidate exists
+ *
+ * @example
+ * const { cycleDefault } = require('node-windows-audio-manager-switcher');
+ * cycleDefault('all', { name: 'headphones' });
+ */
+
+/**
+ * Returns the remembered default devices of one role, most recent first.
+ * @function getDefaultHistory
+ * @param {'console'|'multimedia'|'communications'|'all'} [role='console'] - 'all' reads the console history
+ * @param {object} [options]
+ * @param {'render'|'capture'} [options.flow='render']
+ * @returns {Array<string>} Device IDs (at most 8)
+ */
+
+/**
+ * Routes one application to a device without changing the system default (the setting
+ * behind Settings > "App volume and device preferences", Windows 10 1803+). An executable
+ * name applies to all of its running processes and is remembered for refreshAppEndpoints().
+ * Writes already in effect are skipped.
+ * @function setAppEndpoint
+ * @param {number|string} app - Process ID, or executable name / path (case-insensitive)
+ * @param {string|null} id - Device ID, or null to follow the system default again
+ * @param {'render'|'capture'} [flow='render']
+ * @param {'console'|'multimedia'|'communications'|'all'} [role='all']
+ * @returns {boolean} True if the app had a running process and every write succeeded
+ *
+ * @example
+ * const { setAppEndpoint } = require('node-windows-audio-manager-switcher');
+ * setAppEndpoint('Teams.exe', headsetId);
+ */
+
+/**
+ * Applies many per-application assignments in one batch, e.g. when a scene changes.
+ * Executables are resolved with one process listing for the whole batch; later entries
+ * for the same app, flow and role override earlier ones.
+ * @function setAppEndpoints
+ * @param {Array<{app: number|string, id: string|null, flow?: 'render'|'capture',
+ *         role?: 'console'|'multimedia'|'communications'|'all'}>} assignments
+ * @returns {{applied: number, unchanged: number, failed: number, unresolved: number, hresult?: number}}
+ *          `unresolved` counts executables with no running process
+ */
+
+/**
+ * Returns the per-application assignments made through this module, from memory.
+ * @function getAppEndpoints
+ * @returns {Array<{app: number|string, id: string, flow: string, role: string, pids: Array<number>,
+ *          hresult?: number}>} `pids` are the processes written at the last apply
+ */
+
+/**
+ * Rewrites every remembered assignment so processes started since pick it up.
+ * @function refreshAppEndpoints
+ * @returns {{applied: number, unchanged: number, failed: number, unresolved: number, hresult?: number}}
+ */
+
+/**
+ * Returns every application to the system default (including assignments made in
+ * Settings or by other tools) and empties the table.
+ * @function clearAppEndpoints
+ * @returns {boolean} True on success
+ */
+
+/**
+ * Returns the hardware topology of an endpoint (or of every active endpoint): the
+ * connectors and subunits between the endpoint and its jack, their controls, whether
+ * volume/mute/metering are done in hardware, and the jack descriptions. Each graph is
+ * walked once and cached until a device change notification invalidates it; without
+ * notifications running, pass `{ refresh: true }` after plugging hardware.
+ * @function getDeviceTopology
+ * @param {string} [id] - Endpoint ID (omit for all active endpoints)
+ * @param {object} [options]
+ * @param {boolean} [options.refresh=false] - Walk the graph again
+ * @returns {DeviceTopology|Array<DeviceTopology>|null} null if the ID is not an active endpoint
+ * @property {{volume: boolean, mute: boolean, meter: boolean}} hardware - QueryHardwareSupport
+ * @property {Array<string>} controls - Controls found on the path ('volume', 'mute', 'peakMeter', ...)
+ * @property {Array<{localId: number, name: string, type: 'connector'|'subunit', subType: string,
+ *           connectorType?: string, controls: Array<string>, links: Array<number>}>} parts - `links`
+ *           index into `parts`, one step further from the endpoint
+ * @property {Array<{color: string, connectionType: string, geoLocation: string, genLocation: number,
+ *           portConnection: number, connected: boolean}>} jacks
+ *
+ * @example
+ * const { getDeviceTopology } = require('node-windows-audio-manager-switcher');
+ * const hardwareMute = getDeviceTopology().filter((t) => t.hardware.mute).map((t) => t.id);
+ */
+
+/**
+ * Returns topology cache counters.
+ * @function getTopologyCacheStats
+ * @returns {{size: number, hits: number, builds: number, invalidations: number}}
+ */
+
+/**
+ * Plays a generated test signal on a render endpoint in shared mode. The stream is opened on
+ * first use and kept warm, so switching or restarting a signal takes a few milliseconds.
+ * One signal per endpoint; different endpoints play concurrently (up to 16).
+ * @function playTestSignal
+ * @param {object} [options]
+ * @param {string} [options.deviceId] - Render endpoint (default render endpoint if omitted)
+ * @param {'sine'|'sweep'|'white'|'pink'|'clicks'} [options.type='sine'] - Signal to generate
+ * @param {number} [options.frequency=1000] - Sine frequency, or sweep start, in Hz
+ * @param {number} [options.endFrequency=20000] - Sweep end in Hz (exponential sweep)
+ * @param {number} [options.sweepMs=5000] - Length of one sweep; it then repeats
+ * @param {number} [options.intervalMs=500] - Time between clicks
+ * @param {number} [options.levelDb=-20] - dBFS (≤ 0): peak for tones and clicks, RMS for noise
+ * @param {number} [options.channel=-1] - Play on this output channel only (-1 = all)
+ * @param {number} [options.durationMs=0] - Stop after this long (0 = until stopTestSignal)
+ * @param {number} [options.seed=1] - Noise seed
+ * @returns {{deviceId: string, sampleRate: number, channels: number, startMs: number}}
+ *
+ * @example
+ * const { listDevices, playTestSignal } = require('node-windows-audio-manager-switcher');
+ * for (const d of listDevices()) playTestSignal({ deviceId: d.id, type: 'pink', durationMs: 3000 });
+ */
+
+/**
+ * Opens the streams of one or more endpoints without playing, so the first playTestSignal
+ * on them is as fast as later ones.
+ * @function prepareTestSignal
+ * @param {string|Array<string>} [deviceIds] - Endpoint ID(s) (default render endpoint if omitted)
+ * @returns {Array<string>} Resolved endpoint IDs
+ */
+
+/**
+ * Stops the test signal on one endpoint, or on all of them.
+ * @function stopTestSignal
+ * @param {string|null} [deviceId] - Endpoint ID (omit for all)
+ * @param {object} [options]
+ * @param {boolean} [options.release=false] - Also close the stream instead of keeping it warm
+ * @returns {number} Number of endpoints stopped
+ */
+
+/**
+ * Returns the state of every endpoint used for test signals.
+ * @function getTestSignals
+ * @returns {Array<{deviceId: string, open: boolean, playing: boolean, sampleRate: number,
+ *          channels: number, framesRendered: number, lastStartMs: number, error: string|null}>}
+ */
+
+/**
+ * Measures the output latency of a render endpoint: plays an MLS or chirp, finds it in a
+ * capture with an FFT cross-correlation and repeats for a latency distribution. Loopback
+ * (no captureId) measures the Windows audio engine path; a microphone also hears what a
+ * Bluetooth or USB link and the speaker add. Runs in the background; the stimulus is audible.
+ * @function measureLatency
+ * @param {object} [options]
+ * @param {string} [options.deviceId] - Render endpoint (default render endpoint if omitted)
+ * @param {string} [options.captureId] - Microphone that hears it (loopback if omitted)
+ * @param {'mls'|'chirp'} [options.stimulus='mls'] - Chirps survive lossy Bluetooth codecs better
+ * @param {number} [options.trials=10] - Repetitions
+ * @param {number} [options.levelDb=-12] - Stimulus peak level in dBFS
+ * @param {number} [options.maxLatencyMs=1000] - Longest latency searched for
+ * @param {number} [options.gapMs=100] - Silence between trials
+ * @returns {Promise<{deviceId: string, captureId: string, loopback: boolean, sampleRate: number,
+ *          stimulusMs: number, trials: Array<{found: boolean, latencyMs: number|null,
+ *          bufferMs: number|null, correlation: number, prominence: number, glitched: boolean}>,
+ *          stats: {count: number, minMs: number, maxMs: number, meanMs: number, medianMs: number,
+ *          p95Ms: number, stdDevMs: number}}>}
+ * @example
+ * const { measureLatency } = require('node-windows-audio-manager-switcher');
+ * const { stats } = await measureLatency({ deviceId: btHeadsetId, captureId: micId, stimulus: 'chirp' });
+ */
+
+/**
+ * Plays one source on several render endpoints at once, time-aligned (e.g. the speakers of
+ * several rooms). The source is captured once into a shared buffer that every endpoint reads;
+ * each endpoint compensates its own output delay and clock drift, so all of them are heard
+ * `latencyMs` after capture.
+ * @function startAggregate
+ * @param {object} options
+ * @param {Array<string|{id?: string, delayMs?: number}>} options.endpoints - Render endpoints;
+ *        `delayMs` is the delay after the render buffer (default: the engine's stream latency).
+ *        Use measureLatency() for Bluetooth: `medianMs` minus the trials' `bufferMs`.
+ * @param {string} [options.sourceId] - Source endpoint (default capture device, or default
+ *        render device with `loopback`)
+ * @param {boolean} [options.loopback=false] - Capture what a render endpoint is playing
+ * @param {number} [options.latencyMs] - Source-to-ear latency (raised to what the slowest
+ *        endpoint needs)
+ * @returns {number} Aggregate id
+ *
+ * @example
+ * const { startAggregate, getAggregateStats } = require('node-windows-audio-manager-switcher');
+ * const id = startAggregate({ loopback: true, sourceId: virtualCableId, endpoints: [kitchenId, { id: patioBtId, delayMs: 180 }] });
+ * setInterval(() => console.log(getAggregateStats(id).endpoints.map((e) => e.errorMs)), 1000);
+ */
+
+/**
+ * Stops an aggregate output and releases every endpoint.
+ * @function stopAggregate
+ * @param {number} id - Aggregate id from startAggregate
+ * @returns {boolean} False if the aggregate did not exist
+ */
+
+/**
+ * Changes the compensated delay of one endpoint; it realigns within one period. Raises the
+ * shared latency of every endpoint if this one needs more.
+ * @function setAggregateDelay
+ * @param {number} id - Aggregate id from startAggregate
+ * @param {number} index - Position of the endpoint in `options.endpoints`
+ * @param {number} delayMs - Delay after the render buffer (negative = stream latency)
+ * @returns {boolean} False for an unknown id or index, or a delay the source cannot cover
+ */
+
+/**
+ * Returns the counters of an aggregate output, or null for an unknown id.
+ * @function getAggregateStats
+ * @param {number} id - Aggregate id from startAggregate
+ * @returns {{running: boolean, error: string|null, sourceRate: number, sourceChannels: number,
+ *          latencyMs: number, endpoints: Array<{id: string, running: boolean, error: string|null,
+ *          sampleRate: number, channels: number, aligned: boolean, underruns: number, laps: number,
+ *          renderedFrames: number, delayMs: number, errorMs: number, driftPpm: number}>}|null}
+ *          `errorMs` is the smoothed alignment error (positive = late)
+ */
+
+/**
+ * Decodes a sound clip once and keeps it in memory, converted to the mix format of the
+ * endpoints it will play on, and opens (warms) those endpoints' streams. WAV, RF64 and
+ * Wave64 files (PCM 8/16/24/32-bit, float 32/64-bit) and FLAC files are detected from
+ * their header; headerless PCM needs `format`, `sampleRate` and `channels`. Clips share
+ * a 256 MB pool.
+ * @function loadClip
+ * @param {Buffer|ArrayBuffer|Uint8Array} data - WAV or FLAC file, or raw interleaved little-endian PCM
+ * @param {object} [options]
+ * @param {string[]} [options.deviceIds] - Endpoints to prepare (default render endpoint if
+ *        neither this nor `deviceId` is given)
+ * @param {string} [options.deviceId] - One endpoint to prepare
+ * @param {'u8'|'s16'|'s24'|'s32'|'f32'|'f64'} [options.format] - Raw PCM sample format
+ * @param {number} [options.sampleRate=48000] - Raw PCM sample rate
+ * @param {number} [options.channels=2] - Raw PCM channel count
+ * @returns {{clipId: number, sampleRate: number, channels: number, durationMs: number,
+ *          deviceIds: string[]}} The clip's own format and the resolved endpoint IDs
+ *
+ * @example
+ * const { loadClip, playClip } = require('node-windows-audio-manager-switcher');
+ * const { clipId, deviceIds } = loadClip(fs.readFileSync('ding.wav'));
+ * playClip(clipId, deviceIds[0], 0.5);
+ */
+
+/**
+ * Starts a loaded clip, mixed with any clips already playing on the endpoint. On a warm
+ * endpoint this only queues a voice: the sound starts within two engine periods (under
+ * 10 ms where the driver supports small shared-mode periods; see getClipStats().latencyMs).
+ * Up to 32 clips mix per endpoint; more replace the one closest to its end.
+ * @function playClip
+ * @param {number} clipId - Clip id from loadClip
+ * @param {string|null} [deviceId] - Render endpoint (default render endpoint; pass the ID
+ *        for the fastest start)
+ * @param {number} [gain=1] - Linear gain, 0 to 16
+ * @returns {boolean} False for an unknown clip id
+ */
+
+/**
+ * Stops clips on one endpoint, or on all of them. Streams stay open (warm) unless
+ * `release` is set.
+ * @function stopClips
+ * @param {string|null} [deviceId] - Endpoint ID (every endpoint if omitted)
+ * @param {{clipId?: number, release?: boolean}} [options] - `clipId` stops only that clip
+ * @returns {number} Number of endpoints affected
+ */
+
+/**
+ * Frees a loaded clip. Voices still playing it are stopped first.
+ * @function unloadClip
+ * @param {number} clipId - Clip id from loadClip
+ * @returns {boolean} False for an unknown clip id
+ */
+
+/**
+ * Returns clip pool usage and the state of every endpoint used for clips.
+ * @function getClipStats
+ * @returns {{clips: number, buffers: number, bytes: number, budgetBytes: number,
+ *          players: Array<{deviceId: string, open: boolean, lowLatency: boolean,
+ *          sampleRate: number, channels: number, periodMs: number, latencyMs: number,
+ *          voices: number, started: number, finished: number, stolen: number,
+ *          rejected: number, error: string|null}>}} `latencyMs` is the time from
+ *          playClip() to sound: audio written ahead plus the stream latency
+ */
+
+/**
+ * Starts recording an endpoint to a file: by default loopback of the default render
+ * endpoint (what it plays). Capture hands 1 MB page-aligned blocks to a background writer
+ * thread, so a slow disk never stalls it; every `patchIntervalMs` the data is flushed and
+ * the header rewritten, so the file stays valid if the process or machine dies. A 'wav'
+ * file switches to RF64 past 4 GB. A 'flac' file is encoded losslessly on the writer
+ * thread (16 or 24-bit); if it is cut short it still decodes up to its last whole frame.
+ * Loopback silence (nothing playing) is recorded as silence, keeping the file in real time.
+ * @function startRecording
+ * @param {string} path - Output file (created or overwritten)
+ * @param {object} [options]
+ * @param {string} [options.deviceId] - Endpoint (default render, or default capture
+ *        without loopback)
+ * @param {boolean} [options.loopback=true] - Record what a render endpoint plays
+ * @param {'s16'|'s24'|'s32'|'f32'} [options.format='f32'] - Sample format in the file
+ *        ('s24' by default for FLAC, which takes only 's16' or 's24')
+ * @param {'wav'|'rf64'|'w64'|'flac'} [options.container='wav'] - File format
+ * @param {number} [options.blockSize=1048576] - Bytes per disk write (64 KB to 64 MB)
+ * @param {number} [options.blocks=8] - Blocks in flight (2 to 256)
+ * @param {number} [options.patchIntervalMs=1000] - Header rewrite interval, 0 for only at stop
+ * @param {boolean} [options.sync=true] - Flush to the device before each header rewrite
+ * @param {number} [options.threads=0] - FLAC encoding threads, 0 for one per core
+ * @returns {number} Recording id
+ *
+ * @example
+ * const { startRecording, stopRecording } = require('node-windows-audio-manager-switcher');
+ * const id = startRecording('session.wav', { format: 's24' });
+ * // ... hours later
+ * console.log(stopRecording(id)); // { durationMs, bytesWritten, droppedFrames, ... }
+ */
+
+/**
+ * Stops a recording and finishes its file.
+ * @function stopRecording
+ * @param {number} id - Recording id from startRecording
+ * @returns {object|null} Final stats (see getRecordingStats), or null for an unknown id
+ */
+
+/**
+ * Returns the counters of a recording.
+ * @function getRecordingStats
+ * @param {number} id - Recording id from startRecording
+ * @returns {{running: boolean, error: string|null, sampleRate: number, channels: number,
+ *          frames: number, durationMs: number, bytesWritten: number, droppedFrames: number,
+ *          gapFrames: number, glitches: number, queueDepth: number, maxQueueDepth: number,
+ *          blocks: number, writeMBps: number, maxWriteMs: number, maxPushUs: number,
+ *          headerPatches: number, rf64: boolean, compression: number,
+ *          encodeRealtime: number}|null} `queueDepth` counts blocks waiting for the disk
+ *          (frames drop once it reaches `blocks`); `writeMBps` is the disk rate while
+ *          writing; `maxPushUs` is the longest the capture thread spent on one packet;
+ *          for FLAC, `compression` is encoded size / PCM size and `encodeRealtime` how many
+ *          times faster than real time the encoder runs (both 0 otherwise)
+ */
+
+/**
+ * Starts voice activity detection on several microphones at once, to tell which one the
+ * user is speaking into (e.g. to make it the communications default). One background
+ * thread captures every endpoint and scores 16 ms frames on level over the noise floor,
+ * spectral flatness and zero-crossing rate, with a hangover across pauses between words;
+ * it writes each endpoint's speech probability to a shared buffer that getVoiceActivity
+ * reads without waiting. An endpoint that fails reports an error; the others keep running.
+ * @function startVoiceActivity
+ * @param {object} [options]
+ * @param {string[]} [options.deviceIds] - Capture endpoints (default: every active one)
+ * @param {number} [options.snrDb=6] - Level over the noise floor that counts as loud enough
+ * @param {number} [options.hangoverMs=300] - How long speech is held after the last speech-like frame
+ * @returns {number} Monitor id
+ *
+ * @example
+ * const { startVoiceActivity, getVoiceActivity, cycleDefault } = require('node-windows-audio-manager-switcher');
+ * const id = startVoiceActivity();
+ * setInterval(() => {
+ *   const { activeDeviceId } = getVoiceActivity(id);
+ *   if (activeDeviceId) cycleDefault('communications', { flow: 'capture', ids: [activeDeviceId] });
+ * }, 1000);
+ */
+
+/**
+ * Stops voice activity detection and releases every endpoint.
+ * @function stopVoiceActivity
+ * @param {number} id - Monitor id from startVoiceActivity
+ * @returns {object|null} Final state (see getVoiceActivity), or null for an unknown id
+ */
+
+/**
+ * Returns the speech state of every monitored endpoint.
+ * @function getVoiceActivity
+ * @param {number} id - Monitor id from startVoiceActivity
+ * @returns {{running: boolean, error: string|null, activeDeviceId: string|null,
+ *          loadPercent: number, endpoints: Array<{id: string, running: boolean,
+ *          error: string|null, sampleRate: number, channels: number, probability: number,
+ *          speaking: boolean, levelDb: number, noiseDb: number, flatness: number,
+ *          zeroCrossings: number, speechMs: number, updates: number}>}|null}
+ *          `activeDeviceId` is the speaking endpoint with the highest probability (ties go
+ *          to the best level over noise), or null when nobody speaks; `loadPercent` is the
+ *          share of one core the analysis thread uses
+ */
+
+/**
+ * Starts the audio state daemon in this process. The daemon owns the native addon,
+ * keeps a device snapshot, and serves other processes over a named pipe (Windows) or
+ * Unix socket. Queries are answered from the snapshot; commands are forwarded to the
+ * addon and subscribers receive `devicesChanged` events, and `serviceRestarted` once the
+ * addon has recovered (and replayed its defaults and mutes) after an audio service restart.
+ * @function startDaemon
+ * @param {object} [options]
+ * @param {string} [options.path] - Pipe/socket path (default `\\.\pipe\node-windows-audio-manager`)
+ * @param {number} [options.pollIntervalMs=2000] - Snapshot refresh interval, 0 to disable
+ * @param {{initialDelayMs?: number, maxDelayMs?: number}} [options.recovery] - Backoff for
+ *        audio service restart recovery (defaults 100 ms, doubling up to 5000 ms)
+ * @returns {Promise<DaemonServer>} The listening daemon (call `close()` to stop)
+ *
+ * @example
+ * const { startDaemon } = require('node-windows-audio-manager-switcher');
+ * startDaemon().then(() => console.log('Audio daemon ready'));
+ */
+function startDaemon(options = {}) {
+    const { startDaemonServer } = require('./lib/daemon/server');
+    return startDaemonServer({ ...options, backend: loadAddon() });
+}
+
+/**
+ * Connects to a running audio state daemon.
+ * @function connectDaemon
+ * @param {object} [options]
+ * @param {string} [options.path] - Pipe/socket path (must match the daemon)
+ * @returns {Promise<DaemonClient>} Client with promise-returning listDevices, setDefaultDevice,
+ *          setDefaultPlaybackMute, muteDeviceById, subscribe and unsubscribe
+ *
+ * @example
+ * const { connectDaemon } = require('node-windows-audio-manager-switcher');
+ * const client = await connectDaemon();
+ * client.on('devicesChanged', (devices) => console.log(devices));
+ * await client.subscribe();
+ * console.log(await client.listDevices());
+ */
+function connectDaemon(options) {
+    return require('./lib/daemon/client').connectDaemon(options);
+}
+
 module.exports = {
-    addon,
-    listDevices: addon.listDevices,
-    setDefaultDevice: addon.setDefaultDevice,
-    setDefaultPlaybackMute: addon.setDefaultPlaybackMute,
-    muteDeviceById: addon.muteDeviceById
+    listDevices: lazy('listDevices'),
+    setDefaultDevice: lazy('setDefaultDevice'),
+    setDefaultPlaybackMute: lazy('setDefaultPlaybackMute'),
+    muteDeviceById: lazy('muteDeviceById'),
+    setOperationTimeout: lazy('setOperationTimeout'),
+    getOperationTimeout: lazy('getOperationTimeout'),
+    getDeviceHealth: lazy('getDeviceHealth'),
+    resetDeviceHealth: lazy('resetDeviceHealth'),
+    getDeviceSnapshot: lazy('getDeviceSnapshot'),
+    getAudioEffects: lazy('getAudioEffects'),
+    getListenRouting: lazy('getListenRouting'),
+    setListenRouting: lazy('setListenRouting'),
+    startPassthrough: lazy('startPassthrough'),
+    stopPassthrough: lazy('stopPassthrough'),
+    getPassthroughStats: lazy('getPassthroughStats'),
+    listAudioSessions: lazy('listAudioSessions'),
+    getSessionCacheStats: lazy('getSessionCacheStats'),
+    startNotifications: lazy('startNotifications'),
+    stopNotifications: lazy('stopNotifications'),
+    getNotificationStats: lazy('getNotificationStats'),
+    setLogging: lazy('setLogging'),
+    getLogStats: lazy('getLogStats'),
+    getServiceRecoveryStats: lazy('getServiceRecoveryStats'),
+    switchToPrevious: lazy('switchToPrevious'),
+    cycleDefault: lazy('cycleDefault'),
+    getDefaultHistory: lazy('getDefaultHistory'),
+    setAppEndpoint: lazy('setAppEndpoint'),
+    setAppEndpoints: lazy('setAppEndpoints'),
+    getAppEndpoints: lazy('getAppEndpoints'),
+    refreshAppEndpoints: lazy('refreshAppEndpoints'),
+    clearAppEndpoints: lazy('clearAppEndpoints'),
+    getDeviceTopology: lazy('getDeviceTopology'),
+    getTopologyCacheStats: lazy('getTopologyCacheStats'),
+    playTestSignal: lazy('playTestSignal'),
+    prepareTestSignal: lazy('prepareTestSignal'),
+    stopTestSignal: lazy('stopTestSignal'),
+    getTestSignals: lazy('getTestSignals'),
+    measureLatency: lazy('measureLatency'),
+    startAggregate: lazy('startAggregate'),
+    stopAggregate: lazy('stopAggregate'),
+    setAggregateDelay: lazy('setAggregateDelay'),
+    getAggregateStats: lazy('getAggregateStats'),
+    loadClip: lazy('loadClip'),
+    playClip: lazy('playClip'),
+    stopClips: lazy('stopClips'),
+    unloadClip: lazy('unloadClip'),
+    getClipStats: lazy('getClipStats'),
+    startRecording: lazy('startRecording'),
+    stopRecording: lazy('stopRecording'),
+    getRecordingStats: lazy('getRecordingStats'),
+    startVoiceActivity: lazy('startVoiceActivity'),
+    stopVoiceActivity: lazy('stopVoiceActivity'),
+    getVoiceActivity: lazy('getVoiceActivity'),
+    startDaemon,
+    connectDaemon
 };
+
+// Raw native exports, loaded on first access
+Object.defineProperty(module.exports, 'addon', { enumerable: true, get: loadAddon });
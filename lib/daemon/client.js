@@ -0,0 +1,153 @@
+/**
+ * @file lib/daemon/client.js
+ * @description Client for the audio state daemon. Mirrors the synchronous module API
+ *              with promise-returning methods and emits `devicesChanged` and
+ *              `serviceRestarted` events once subscribed.
+ */
+const net = require('net');
+const { EventEmitter } = require('events');
+const {
+    FrameKind,
+    Op,
+    Status,
+    EventCode,
+    Writer,
+    Reader,
+    FrameParser,
+    encodeFrame,
+    readDevices,
+    defaultDaemonPath,
+} = require('./protocol');
+
+class DaemonClient extends EventEmitter {
+    constructor(socket) {
+        super();
+        this.socket = socket;
+        this.nextRequestId = 1;
+        this.pending = new Map();
+        this.closed = false;
+
+        const parser = new FrameParser((kind, requestId, payload) => this.handleFrame(kind, requestId, payload));
+        socket.on('data', (chunk) => {
+            try {
+                parser.push(chunk);
+            } catch (err) {
+                socket.destroy(err);
+            }
+        });
+        socket.on('close', () => this.failPending(new Error('Daemon connection closed')));
+        socket.on('error', (err) => this.failPending(err));
+    }
+
+    failPending(err) {
+        if (this.closed) return;
+        this.closed = true;
+        for (const { reject } of this.pending.values()) reject(err);
+        this.pending.clear();
+        this.emit('close', err);
+    }
+
+    handleFrame(kind, requestId, payload) {
+        const reader = new Reader(payload);
+
+        if (kind === FrameKind.EVENT) {
+            const code = reader.u8();
+            if (code === EventCode.DEVICES_CHANGED) {
+                this.emit('devicesChanged', readDevices(reader));
+            } else if (code === EventCode.SERVICE_RESTARTED) {
+                this.emit('serviceRestarted', {
+                    generation: reader.u32(),
+                    replayed: reader.u32(),
+                    replayFailed: reader.u32(),
+                    downtimeMs: reader.u32(),
+                });
+            }
+            return;
+        }
+
+        const request = this.pending.get(requestId);
+        if (!request) return;
+        this.pending.delete(requestId);
+
+        if (reader.u8() === Status.OK) {
+            request.resolve(request.decode ? request.decode(reader) : undefined);
+            return;
+        }
+        const err = new Error(reader.string());
+        const code = reader.string();
+        if (code) err.code = code;
+        request.reject(err);
+    }
+
+    request(op, encode, decode) {
+        const requestId = this.nextRequestId;
+        this.nextRequestId = requestId >= 0xffffffff ? 1 : requestId + 1;
+        const writer = new Writer();
+        writer.u8(op);
+        if (encode) encode(writer);
+
+        return new Promise((resolve, reject) => {
+            this.pending.set(requestId, { resolve, reject, decode });
+            this.socket.write(encodeFrame(FrameKind.REQUEST, requestId, writer.finish()));
+        });
+    }
+
+    /** @returns {Promise<void>} Round trip to the daemon */
+    ping() {
+        return this.request(Op.PING);
+    }
+
+    /** @returns {Promise<Array<{name: string, id: string, isDefault: boolean}>>} Snapshot device list */
+    listDevices() {
+        return this.request(Op.LIST_DEVICES, null, readDevices);
+    }
+
+    /** @returns {Promise<boolean>} Result of setDefaultDevice in the daemon */
+    setDefaultDevice(deviceId) {
+        return this.request(Op.SET_DEFAULT_DEVICE, (w) => w.string(deviceId), (r) => r.bool());
+    }
+
+    /** @returns {Promise<boolean>} Result of setDefaultPlaybackMute in the daemon */
+    setDefaultPlaybackMute(mute) {
+        return this.request(Op.SET_DEFAULT_PLAYBACK_MUTE, (w) => w.bool(mute), (r) => r.bool());
+    }
+
+    /** @returns {Promise<boolean>} Result of muteDeviceById in the daemon */
+    muteDeviceById(deviceId, mute) {
+        return this.request(Op.MUTE_DEVICE_BY_ID, (w) => w.string(deviceId).bool(mute), (r) => r.bool());
+    }
+
+    /** Starts receiving `devicesChanged` and `serviceRestarted` events. */
+    subscribe() {
+        return this.request(Op.SUBSCRIBE);
+    }
+
+    /** Stops receiving events. */
+    unsubscribe() {
+        return this.request(Op.UNSUBSCRIBE);
+    }
+
+    close() {
+        this.socket.end();
+    }
+}
+
+/**
+ * Connects to a running daemon.
+ * @param {object} [options]
+ * @param {string} [options.path] - Pipe/socket path (defaults to defaultDaemonPath())
+ * @returns {Promise<DaemonClient>} Connected client
+ */
+function connectDaemon({ path } = {}) {
+    return new Promise((resolve, reject) => {
+        const socket = net.connect(path || defaultDaemonPath());
+        socket.once('error', reject);
+        socket.once('connect', () => {
+            socket.off('error', reject);
+            socket.setNoDelay(true);
+            resolve(new DaemonClient(socket));
+        });
+    });
+}
+
+module.exports = { DaemonClient, connectDaemon };
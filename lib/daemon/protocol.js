@@ -0,0 +1,245 @@
+/**
+ * @file lib/daemon/protocol.js
+ * @description Compact binary protocol spoken between the audio daemon and its clients.
+ *
+ *              Every frame is length-prefixed:
+ *
+ *              | u32 LE length | u8 kind | u32 LE requestId | payload ... |
+ *
+ *              `length` counts everything after itself. Requests carry an opcode as the
+ *              first payload byte, responses a status byte, events an event code.
+ *              Strings are u16 LE length + UTF-8 bytes; booleans are one byte.
+ */
+
+const FrameKind = Object.freeze({
+    REQUEST: 1,
+    RESPONSE: 2,
+    EVENT: 3,
+});
+
+const Op = Object.freeze({
+    PING: 1,
+    LIST_DEVICES: 2,
+    SET_DEFAULT_DEVICE: 3,
+    SET_DEFAULT_PLAYBACK_MUTE: 4,
+    MUTE_DEVICE_BY_ID: 5,
+    SUBSCRIBE: 6,
+    UNSUBSCRIBE: 7,
+});
+
+const Status = Object.freeze({
+    OK: 0,
+    ERROR: 1,
+});
+
+const EventCode = Object.freeze({
+    DEVICES_CHANGED: 1,
+    // u32 generation, u32 replayed, u32 replayFailed, u32 downtimeMs
+    SERVICE_RESTARTED: 2,
+});
+
+const HEADER_SIZE = 4 + 1 + 4;
+const MAX_FRAME_SIZE = 1 << 20;
+
+/**
+ * Growable little-endian buffer writer.
+ */
+class Writer {
+    constructor(initialSize = 64) {
+        this.buffer = Buffer.allocUnsafe(initialSize);
+        this.offset = 0;
+    }
+
+    ensure(bytes) {
+        if (this.offset + bytes <= this.buffer.length) return;
+        let size = this.buffer.length * 2;
+        while (size < this.offset + bytes) size *= 2;
+        const next = Buffer.allocUnsafe(size);
+        this.buffer.copy(next, 0, 0, this.offset);
+        this.buffer = next;
+    }
+
+    u8(value) {
+        this.ensure(1);
+        this.buffer.writeUInt8(value, this.offset);
+        this.offset += 1;
+        return this;
+    }
+
+    u16(value) {
+        this.ensure(2);
+        this.buffer.writeUInt16LE(value, this.offset);
+        this.offset += 2;
+        return this;
+    }
+
+    u32(value) {
+        this.ensure(4);
+        this.buffer.writeUInt32LE(value >>> 0, this.offset);
+        this.offset += 4;
+        return this;
+    }
+
+    bool(value) {
+        return this.u8(value ? 1 : 0);
+    }
+
+    string(value) {
+        const length = Buffer.byteLength(value, 'utf8');
+        if (length > 0xffff) throw new RangeError('String too long for protocol');
+        this.u16(length);
+        this.ensure(length);
+        this.buffer.write(value, this.offset, length, 'utf8');
+        this.offset += length;
+        return this;
+    }
+
+    finish() {
+        return this.buffer.subarray(0, this.offset);
+    }
+}
+
+/**
+ * Little-endian buffer reader with bounds checking.
+ */
+class Reader {
+    constructor(buffer) {
+        this.buffer = buffer;
+        this.offset = 0;
+    }
+
+    need(bytes) {
+        if (this.offset + bytes > this.buffer.length) throw new RangeError('Truncated frame');
+    }
+
+    u8() {
+        this.need(1);
+        return this.buffer.readUInt8(this.offset++);
+    }
+
+    u16() {
+        this.need(2);
+        const value = this.buffer.readUInt16LE(this.offset);
+        this.offset += 2;
+        return value;
+    }
+
+    u32() {
+        this.need(4);
+        const value = this.buffer.readUInt32LE(this.offset);
+        this.offset += 4;
+        return value;
+    }
+
+    bool() {
+        return this.u8() !== 0;
+    }
+
+    string() {
+        const length = this.u16();
+        this.need(length);
+        const value = this.buffer.toString('utf8', this.offset, this.offset + length);
+        this.offset += length;
+        return value;
+    }
+}
+
+/**
+ * Builds a complete frame around an already encoded payload.
+ * @param {number} kind - FrameKind value
+ * @param {number} requestId - Correlation id (0 for events)
+ * @param {Buffer} payload - Encoded payload
+ * @returns {Buffer} Frame ready to write to the socket
+ */
+function encodeFrame(kind, requestId, payload) {
+    const frame = Buffer.allocUnsafe(HEADER_SIZE + payload.length);
+    frame.writeUInt32LE(1 + 4 + payload.length, 0);
+    frame.writeUInt8(kind, 4);
+    frame.writeUInt32LE(requestId >>> 0, 5);
+    payload.copy(frame, HEADER_SIZE);
+    return frame;
+}
+
+/**
+ * Encodes a device list as: u16 count, then per device u8 flags, string id, string name.
+ * @param {Writer} writer - Destination writer
+ * @param {Array<{id: string, name: string, isDefault: boolean}>} devices - Devices to encode
+ */
+function writeDevices(writer, devices) {
+    writer.u16(devices.length);
+    for (const device of devices) {
+        writer.u8(device.isDefault ? 1 : 0);
+        writer.string(device.id);
+        writer.string(device.name);
+    }
+}
+
+/**
+ * Decodes a device list written by writeDevices.
+ * @param {Reader} reader - Source reader
+ * @returns {Array<{id: string, name: string, isDefault: boolean}>} Devices
+ */
+function readDevices(reader) {
+    const count = reader.u16();
+    const devices = new Array(count);
+    for (let i = 0; i < count; i++) {
+        const flags = reader.u8();
+        const id = reader.string();
+        const name = reader.string();
+        devices[i] = { name, id, isDefault: (flags & 1) !== 0 };
+    }
+    return devices;
+}
+
+/**
+ * Incremental frame splitter for stream sockets.
+ * Feed it socket chunks; it calls `onFrame(kind, requestId, payload)` for each complete frame.
+ */
+class FrameParser {
+    constructor(onFrame) {
+        this.onFrame = onFrame;
+        this.pending = Buffer.alloc(0);
+    }
+
+    push(chunk) {
+        this.pending = this.pending.length ? Buffer.concat([this.pending, chunk]) : chunk;
+
+        let offset = 0;
+        while (this.pending.length - offset >= 4) {
+            const length = this.pending.readUInt32LE(offset);
+            if (length < 5 || length > MAX_FRAME_SIZE) throw new RangeError(`Invalid frame length ${length}`);
+            if (this.pending.length - offset - 4 < length) break;
+
+            const kind = this.pending.readUInt8(offset + 4);
+            const requestId = this.pending.readUInt32LE(offset + 5);
+            const payload = this.pending.subarray(offset + HEADER_SIZE, offset + 4 + length);
+            offset += 4 + length;
+            this.onFrame(kind, requestId, payload);
+        }
+
+        this.pending = offset === this.pending.length ? Buffer.alloc(0) : this.pending.subarray(offset);
+    }
+}
+
+/**
+ * Default rendezvous point: a named pipe on Windows, a Unix socket elsewhere.
+ * @returns {string} Pipe or socket path
+ */
+function defaultDaemonPath() {
+    if (process.platform === 'win32') return '\\\\.\\pipe\\node-windows-audio-manager';
+    return require('path').join(require('os').tmpdir(), 'node-windows-audio-manager.sock');
+}
+
+module.exports = {
+    FrameKind,
+    Op,
+    Status,
+    EventCode,
+    Writer,
+    Reader,
+    FrameParser,
+    encodeFrame,
+    writeDevices,
+    readDevices,
+    defaultDaemonPath,
+};
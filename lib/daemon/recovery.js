@@ -0,0 +1,146 @@
+/**
+ * @file lib/daemon/recovery.js
+ * @description Daemon-side recovery from Windows Audio service restarts.
+ *
+ *              When audiosrv restarts, backend calls fail with `code === 'ESERVICELOST'`
+ *              and the service comes back with its own defaults. The daemon reports such
+ *              failures here; a timer then probes the backend with exponential backoff
+ *              and emits `recovered` once it answers, so the daemon can tell its
+ *              subscribers. The native addon (`backend.recoversNatively`) replays the
+ *              defaults and mutes set through it by itself; for other backends this layer
+ *              remembers what the daemon's clients set and replays it before `recovered`.
+ */
+const { EventEmitter } = require('events');
+
+/**
+ * @returns {boolean} True if `err` means the audio service is gone
+ */
+function isServiceLost(err) {
+    return !!err && err.code === 'ESERVICELOST';
+}
+
+class ServiceRecovery extends EventEmitter {
+    /**
+     * @param {object} options
+     * @param {object} options.backend - listDevices, setDefaultDevice, setDefaultPlaybackMute
+     *        and muteDeviceById, as served by the daemon. State is replayed only if
+     *        `backend.recoversNatively` is not set
+     * @param {number} [options.initialDelayMs=100] - Wait before the first probe
+     * @param {number} [options.maxDelayMs=5000] - Backoff cap; the delay doubles per failed probe
+     */
+    constructor({ backend, initialDelayMs = 100, maxDelayMs = 5000 }) {
+        super();
+        this.backend = backend;
+        this.initialDelayMs = initialDelayMs;
+        this.maxDelayMs = maxDelayMs;
+        this.replays = backend.recoversNatively !== true;
+        this.desired = { defaultId: null, defaultMute: null, mutes: new Map() };
+        this.stats = { recovering: false, detections: 0, restarts: 0, attempts: 0, lastDowntimeMs: 0 };
+        this.timer = null;
+        this.lostSince = 0;
+    }
+
+    /** Records a successful setDefaultDevice. */
+    rememberDefault(deviceId) {
+        if (!this.replays) return;
+        this.desired.defaultId = deviceId;
+    }
+
+    /** Records a successful setDefaultPlaybackMute. */
+    rememberDefaultMute(mute) {
+        if (!this.replays) return;
+        this.desired.defaultMute = !!mute;
+    }
+
+    /** Records a successful muteDeviceById; later writes to the same device replace it. */
+    rememberMute(deviceId, mute) {
+        if (!this.replays) return;
+        this.desired.mutes.set(deviceId, !!mute);
+    }
+
+    /**
+     * Starts a recovery if `err` means the service is gone. Reports made while one is
+     * running are folded into it.
+     * @returns {boolean} True if `err` was a service-lost error
+     */
+    report(err) {
+        if (!isServiceLost(err)) return false;
+        this.stats.detections++;
+        if (this.stats.recovering) return true;
+
+        this.stats.recovering = true;
+        this.stats.attempts = 0;
+        this.lostSince = Date.now();
+        this.schedule(this.initialDelayMs);
+        this.emit('lost', err);
+        return true;
+    }
+
+    schedule(delayMs) {
+        this.timer = setTimeout(() => this.attempt(delayMs), delayMs);
+        this.timer.unref();
+    }
+
+    attempt(delayMs) {
+        this.timer = null;
+        this.stats.attempts++;
+        let replay;
+        try {
+            // Any answer other than "service lost" (even an error) means audiosrv is back
+            try {
+                this.backend.listDevices();
+            } catch (err) {
+                if (isServiceLost(err)) throw err;
+            }
+            replay = this.replay();
+        } catch {
+            this.schedule(Math.min(Math.max(delayMs * 2, 1), this.maxDelayMs));
+            return;
+        }
+
+        this.stats.recovering = false;
+        this.stats.restarts++;
+        this.stats.lastDowntimeMs = Date.now() - this.lostSince;
+        this.emit('recovered', {
+            generation: this.stats.restarts,
+            attempts: this.stats.attempts,
+            downtimeMs: this.stats.lastDowntimeMs,
+            ...replay,
+        });
+    }
+
+    /**
+     * Writes the desired state back: default first, since the default mute applies to
+     * whatever is default afterwards. Throws if the service goes away again. Counts
+     * stay 0 for a backend that replays its own state.
+     * @returns {{replayed: number, replayFailed: number}}
+     */
+    replay() {
+        let replayed = 0;
+        let replayFailed = 0;
+        const write = (fn) => {
+            let ok = false;
+            try {
+                ok = fn() === true;
+            } catch (err) {
+                if (isServiceLost(err)) throw err;
+            }
+            if (ok) replayed++;
+            else replayFailed++;
+        };
+
+        const { defaultId, defaultMute, mutes } = this.desired;
+        if (defaultId !== null) write(() => this.backend.setDefaultDevice(defaultId));
+        if (defaultMute !== null) write(() => this.backend.setDefaultPlaybackMute(defaultMute));
+        for (const [deviceId, mute] of mutes) write(() => this.backend.muteDeviceById(deviceId, mute));
+        return { replayed, replayFailed };
+    }
+
+    /** Cancels a pending probe. */
+    close() {
+        if (this.timer) clearTimeout(this.timer);
+        this.timer = null;
+    }
+}
+
+module.exports = { ServiceRecovery, isServiceLost };
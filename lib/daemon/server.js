@@ -0,0 +1,288 @@
+/**
+ * @file lib/daemon/server.js
+ * @description Audio state daemon. One process owns the native backend (COM worker,
+ *              device snapshot) and serves any number of local clients over a named pipe
+ *              (Windows) or Unix domain socket, using the binary protocol in protocol.js.
+ *
+ *              Queries are answered from the in-memory snapshot; only commands reach the
+ *              backend, after which the snapshot is refreshed and subscribers are notified
+ *              if anything changed. A poll timer picks up changes made outside the daemon.
+ *              If the Windows Audio service restarts, subscribers receive SERVICE_RESTARTED
+ *              once it is back; backends that do not restore state themselves get the
+ *              defaults and mutes set through the daemon replayed first (see recovery.js).
+ */
+const net = require('net');
+const fs = require('fs');
+const { EventEmitter } = require('events');
+const {
+    FrameKind,
+    Op,
+    Status,
+    EventCode,
+    Writer,
+    Reader,
+    FrameParser,
+    encodeFrame,
+    writeDevices,
+    defaultDaemonPath,
+} = require('./protocol');
+const { ServiceRecovery } = require('./recovery');
+
+/**
+ * Clears the way for listening on a Unix socket path. A file left behind by a crashed
+ * daemon is removed, but only once a connect attempt shows nobody is serving on it:
+ * a live daemon fails the new one with EADDRINUSE instead of losing its socket.
+ * Named pipes disappear with their owner, so there is nothing to do on Windows.
+ * @param {string} socketPath
+ * @returns {Promise<void>}
+ */
+function removeStaleSocket(socketPath) {
+    if (process.platform === 'win32') return Promise.resolve();
+    return new Promise((resolve, reject) => {
+        const probe = net.connect(socketPath);
+        probe.once('connect', () => {
+            probe.destroy();
+            const err = new Error(`A daemon is already listening on ${socketPath}`);
+            err.code = 'EADDRINUSE';
+            reject(err);
+        });
+        probe.once('error', (err) => {
+            if (err.code !== 'ECONNREFUSED' && err.code !== 'ENOENT') {
+                reject(err);
+                return;
+            }
+            try {
+                if (err.code === 'ECONNREFUSED') fs.unlinkSync(socketPath);
+                resolve();
+            } catch (unlinkErr) {
+                if (unlinkErr.code === 'ENOENT') resolve();
+                else reject(unlinkErr);
+            }
+        });
+    });
+}
+
+/**
+ * Compares two device lists for equality (order-sensitive, as returned by the backend).
+ */
+function sameDevices(a, b) {
+    if (a.length !== b.length) return false;
+    for (let i = 0; i < a.length; i++) {
+        if (a[i].id !== b[i].id || a[i].name !== b[i].name || a[i].isDefault !== b[i].isDefault) return false;
+    }
+    return true;
+}
+
+class DaemonServer extends EventEmitter {
+    /**
+     * @param {object} options
+     * @param {object} options.backend - Object exposing listDevices, setDefaultDevice,
+     *        setDefaultPlaybackMute and muteDeviceById (the addon, or a simulated backend)
+     * @param {string} [options.path] - Pipe/socket path (defaults to defaultDaemonPath())
+     * @param {number} [options.pollIntervalMs=2000] - Snapshot refresh interval, 0 to disable
+     * @param {object} [options.recovery] - `{ initialDelayMs, maxDelayMs }` for audio service
+     *        restart recovery
+     */
+    constructor({ backend, path, pollIntervalMs = 2000, recovery = {} }) {
+        super();
+        if (!backend) throw new TypeError('A backend is required');
+        this.backend = backend;
+        this.path = path || defaultDaemonPath();
+        this.pollIntervalMs = pollIntervalMs;
+        this.snapshot = [];
+        this.clients = new Set();
+        this.server = null;
+        this.pollTimer = null;
+        this.stats = { requests: 0, backendCalls: 0, eventsSent: 0 };
+        this.recovery = new ServiceRecovery({ backend, ...recovery });
+        this.recovery.on('recovered', (event) => this.onServiceRecovered(event));
+    }
+
+    /**
+     * Takes the initial snapshot and starts listening.
+     * @returns {Promise<DaemonServer>} Resolves once the daemon accepts connections; rejects
+     *          with EADDRINUSE if another daemon already serves the path
+     */
+    listen() {
+        this.refreshSnapshot(false);
+
+        return removeStaleSocket(this.path).then(() => new Promise((resolve, reject) => {
+            this.server = net.createServer((socket) => this.handleConnection(socket));
+            if (this.pollIntervalMs > 0) {
+                this.pollTimer = setInterval(() => this.refreshSnapshot(true), this.pollIntervalMs);
+                this.pollTimer.unref();
+            }
+
+            this.server.once('error', reject);
+            this.server.listen(this.path, () => {
+                this.server.off('error', reject);
+                resolve(this);
+            });
+        }));
+    }
+
+    /**
+     * Disconnects all clients and stops listening.
+     * @returns {Promise<void>}
+     */
+    close() {
+        if (this.pollTimer) clearInterval(this.pollTimer);
+        this.pollTimer = null;
+        this.recovery.close();
+        for (const client of this.clients) client.socket.destroy();
+        this.clients.clear();
+        if (!this.server) return Promise.resolve();
+        return new Promise((resolve) => this.server.close(() => resolve()));
+    }
+
+    /**
+     * Re-reads the device list from the backend.
+     * @param {boolean} notify - Broadcast DEVICES_CHANGED to subscribers if it differs
+     */
+    refreshSnapshot(notify) {
+        let devices;
+        try {
+            this.stats.backendCalls++;
+            devices = this.backend.listDevices() || [];
+        } catch (err) {
+            // Keep serving the last good snapshot; surface the failure only if someone listens
+            this.recovery.report(err);
+            if (this.listenerCount('error')) this.emit('error', err);
+            return;
+        }
+        if (sameDevices(devices, this.snapshot)) return;
+        this.snapshot = devices;
+        if (notify) this.broadcastDevicesChanged();
+    }
+
+    broadcastDevicesChanged() {
+        const writer = new Writer(256);
+        writer.u8(EventCode.DEVICES_CHANGED);
+        writeDevices(writer, this.snapshot);
+        const frame = encodeFrame(FrameKind.EVENT, 0, writer.finish());
+        for (const client of this.clients) {
+            if (!client.subscribed) continue;
+            client.socket.write(frame);
+            this.stats.eventsSent++;
+        }
+        this.emit('devicesChanged', this.snapshot);
+    }
+
+    /**
+     * The service is back and desired state replayed: tell subscribers first (their
+     * view is stale), then refresh, which broadcasts the restored device list.
+     */
+    onServiceRecovered(event) {
+        const writer = new Writer(32);
+        writer.u8(EventCode.SERVICE_RESTARTED)
+            .u32(event.generation)
+            .u32(event.replayed)
+            .u32(event.replayFailed)
+            .u32(Math.min(event.downtimeMs, 0xffffffff));
+        const frame = encodeFrame(FrameKind.EVENT, 0, writer.finish());
+        for (const client of this.clients) {
+            if (!client.subscribed) continue;
+            client.socket.write(frame);
+            this.stats.eventsSent++;
+        }
+        this.emit('serviceRestarted', event);
+        this.snapshot = [];
+        this.refreshSnapshot(true);
+    }
+
+    handleConnection(socket) {
+        const client = { socket, subscribed: false };
+        this.clients.add(client);
+
+        const parser = new FrameParser((kind, requestId, payload) => {
+            if (kind !== FrameKind.REQUEST) throw new RangeError(`Unexpected frame kind ${kind}`);
+            this.handleRequest(client, requestId, new Reader(payload));
+        });
+
+        socket.on('data', (chunk) => {
+            try {
+                parser.push(chunk);
+            } catch (err) {
+                // Malformed stream: drop the client rather than guess at framing
+                socket.destroy(err);
+            }
+        });
+        socket.on('close', () => this.clients.delete(client));
+        socket.on('error', () => this.clients.delete(client));
+    }
+
+    handleRequest(client, requestId, reader) {
+        this.stats.requests++;
+        const writer = new Writer();
+        let changed = false;
+
+        try {
+            const op = reader.u8();
+            switch (op) {
+                case Op.PING:
+                    writer.u8(Status.OK);
+                    break;
+                case Op.LIST_DEVICES:
+                    writer.u8(Status.OK);
+                    writeDevices(writer, this.snapshot);
+                    break;
+                case Op.SET_DEFAULT_DEVICE: {
+                    const id = reader.string();
+                    this.stats.backendCalls++;
+                    const result = this.backend.setDefaultDevice(id);
+                    writer.u8(Status.OK).bool(result);
+                    changed = result === true;
+                    if (changed) this.recovery.rememberDefault(id);
+                    break;
+                }
+                case Op.SET_DEFAULT_PLAYBACK_MUTE: {
+                    const mute = reader.bool();
+                    this.stats.backendCalls++;
+                    const result = this.backend.setDefaultPlaybackMute(mute);
+                    writer.u8(Status.OK).bool(result);
+                    if (result === true) this.recovery.rememberDefaultMute(mute);
+                    break;
+                }
+                case Op.MUTE_DEVICE_BY_ID: {
+                    const id = reader.string();
+                    const mute = reader.bool();
+                    this.stats.backendCalls++;
+                    const result = this.backend.muteDeviceById(id, mute);
+                    writer.u8(Status.OK).bool(result);
+                    if (result === true) this.recovery.rememberMute(id, mute);
+                    break;
+                }
+                case Op.SUBSCRIBE:
+                    client.subscribed = true;
+                    writer.u8(Status.OK);
+                    break;
+                case Op.UNSUBSCRIBE:
+                    client.subscribed = false;
+                    writer.u8(Status.OK);
+                    break;
+                default:
+                    throw new RangeError(`Unknown opcode ${op}`);
+            }
+        } catch (err) {
+            this.recovery.report(err);
+            writer.offset = 0;
+            writer.u8(Status.ERROR).string(String(err.message || err)).string(err.code || '');
+        }
+
+        client.socket.write(encodeFrame(FrameKind.RESPONSE, requestId, writer.finish()));
+
+        // Reply first, then fan out the new state so the caller sees its own result promptly
+        if (changed) this.refreshSnapshot(true);
+    }
+}
+
+/**
+ * Creates and starts a daemon.
+ * @param {object} options - See DaemonServer constructor
+ * @returns {Promise<DaemonServer>} The listening daemon
+ */
+function startDaemonServer(options) {
+    return new DaemonServer(options).listen();
+}
+
+module.exports = { DaemonServer, startDaemonServer };
@@ -0,0 +1,100 @@
+/**
+ * @file lib/simulatedBackend.js
+ * @description In-memory stand-in for the native addon. Implements the same function
+ *              surface over a fake device table so daemon and JS-side logic can be
+ *              exercised on machines without Windows audio (CI, Linux).
+ */
+
+/**
+ * Creates a simulated backend.
+ * @param {object} [options]
+ * @param {number} [options.deviceCount=4] - Number of fake render endpoints
+ * @param {number} [options.latencyMs=0] - Busy-wait per call to mimic driver cost
+ * @returns {object} Backend with listDevices, setDefaultDevice, setDefaultPlaybackMute,
+ *          muteDeviceById, plus `calls` counters and a `devices` table for assertions, and
+ *          restartService() to mimic the Windows Audio service restarting
+ */
+function createSimulatedBackend({ deviceCount = 4, latencyMs = 0 } = {}) {
+    const devices = [];
+    for (let i = 0; i < deviceCount; i++) {
+        const guid = `00000000-0000-0000-0000-${String(i).padStart(12, '0')}`;
+        devices.push({
+            id: `{0.0.0.00000000}.{${guid}}`,
+            name: `Simulated Speakers ${i + 1}`,
+            muted: false,
+        });
+    }
+    let defaultIndex = 0;
+    let downUntil = 0;
+    const calls = { listDevices: 0, setDefaultDevice: 0, setDefaultPlaybackMute: 0, muteDeviceById: 0 };
+
+    function spend() {
+        if (latencyMs <= 0) return;
+        const until = Date.now() + latencyMs;
+        while (Date.now() < until);
+    }
+
+    // Same shape as the addon's error while audiosrv is down
+    function checkService() {
+        if (Date.now() >= downUntil) return;
+        const err = new Error('[x] Failed to enumerate audio endpoints: audio service not running');
+        err.code = 'ESERVICELOST';
+        err.hresult = 0x88890010;
+        throw err;
+    }
+
+    return {
+        devices,
+        calls,
+
+        listDevices() {
+            calls.listDevices++;
+            spend();
+            checkService();
+            return devices.map((d, i) => ({ name: d.name, id: d.id, isDefault: i === defaultIndex }));
+        },
+
+        setDefaultDevice(deviceId) {
+            calls.setDefaultDevice++;
+            spend();
+            checkService();
+            const index = devices.findIndex((d) => d.id === deviceId);
+            if (index < 0) return false;
+            defaultIndex = index;
+            return true;
+        },
+
+        setDefaultPlaybackMute(mute) {
+            calls.setDefaultPlaybackMute++;
+            spend();
+            checkService();
+            devices[defaultIndex].muted = !!mute;
+            return true;
+        },
+
+        muteDeviceById(deviceId, mute) {
+            calls.muteDeviceById++;
+            spend();
+            checkService();
+            const device = devices.find((d) => d.id === deviceId);
+            if (!device) return false;
+            device.muted = !!mute;
+            return true;
+        },
+
+        /**
+         * Simulates a Windows Audio service restart: every call fails with
+         * `code === 'ESERVICELOST'` for `downMs`, and the service comes back with its
+         * defaults (first device, nothing muted) rather than what was set before.
+         * @param {object} [options]
+         * @param {number} [options.downMs=200] - How long the service stays down
+         */
+        restartService({ downMs = 200 } = {}) {
+            downUntil = Date.now() + downMs;
+            defaultIndex = 0;
+            for (const device of devices) device.muted = false;
+        },
+    };
+}
+
+module.exports = { createSimulatedBackend };
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief The application an assignment applies to: one process, or every process
+     *        running an executable.
+     */
+    struct AppTarget
+    {
+        uint32_t pid = 0; ///< Process ID, or 0 to match by `exe`.
+        std::wstring exe; ///< Lowercase file name (see AppRoutingTable::NormalizeExe()).
+
+        bool operator==(const AppTarget &other) const { return pid == other.pid && exe == other.exe; }
+    };
+
+    /**
+     * @brief One per-application endpoint assignment. Flow and role carry the numeric
+     *        values of EDataFlow and ERole, so this header stays platform independent.
+     */
+    struct AppAssignment
+    {
+        AppTarget target;
+        uint8_t flow = 0;
+        uint8_t role = 0;
+        std::wstring deviceId; ///< Endpoint ID; empty to make the app follow the system default again.
+    };
+
+    /**
+     * @brief A running process as listed by AppPolicy::ListProcesses().
+     */
+    struct AppProcess
+    {
+        uint32_t pid = 0;
+        std::wstring exe; ///< Normalized as by AppRoutingTable::NormalizeExe().
+    };
+
+    /**
+     * @brief Writes per-application default endpoints. The Windows implementation uses the
+     *        audio policy config factory behind Settings > App volume and device
+     *        preferences; tests substitute a simulated one.
+     *
+     * Status codes are HRESULTs: negative means failure.
+     */
+    class AppPolicy
+    {
+    public:
+        virtual ~AppPolicy() = default;
+
+        /// Lists running processes with one system snapshot. Returns false on failure.
+        virtual bool ListProcesses(std::vector<AppProcess> &processes) = 0;
+
+        /// Routes @p pid's @p flow / @p role streams to @p deviceId (empty: system default).
+        virtual int32_t SetEndpoint(uint32_t pid, uint8_t flow, uint8_t role, const std::wstring &deviceId) = 0;
+
+        /// Removes every per-application assignment, including ones made by other tools.
+        virtual int32_t ClearAll() = 0;
+    };
+
+    /**
+     * @brief Outcome of one AppRoutingTable::Apply() batch.
+     */
+    struct AppBatchResult
+    {
+        uint32_t applied = 0;    ///< Policy writes that succeeded.
+        uint32_t unchanged = 0;  ///< Writes skipped because the process already had that endpoint.
+        uint32_t failed = 0;     ///< Policy writes that failed.
+        uint32_t unresolved = 0; ///< Assignments whose executable had no running process.
+        int32_t lastError = 0;   ///< Status of the last failed write.
+    };
+
+    /**
+     * @brief An assignment as remembered by the table.
+     */
+    struct AppRoute
+    {
+        AppAssignment assignment;
+        std::vector<uint32_t> pids; ///< Processes it was written to at the last apply.
+        int32_t status = 0;         ///< Status of the last failed write, or 0.
+    };
+
+    /**
+     * @brief Cached table of per-application endpoint assignments.
+     *
+     * Apply() takes a whole scene change at once: executables are resolved to pids with
+     * a single process listing for the batch, later entries for the same app, flow and
+     * role override earlier ones, and a write is skipped when the table shows the process
+     * already has that endpoint. Routes() answers "what is assigned where" from memory.
+     *
+     * Assignments by executable stay in the table, so Reconcile() can extend them to
+     * processes started since (a new browser window, a restarted Teams).
+     */
+    class AppRoutingTable
+    {
+    public:
+        explicit AppRoutingTable(std::shared_ptr<AppPolicy> policy);
+
+        AppRoutingTable(const AppRoutingTable &) = delete;
+        AppRoutingTable &operator=(const AppRoutingTable &) = delete;
+
+        /// Records @p assignments and writes them, skipping writes already in effect.
+        AppBatchResult Apply(const std::vector<AppAssignment> &assignments);
+
+        /// Rewrites every remembered assignment, reaching processes started since.
+        AppBatchResult Reconcile();
+
+        /// Remembered assignments, sorted by app, flow and role.
+        std::vector<AppRoute> Routes() const;
+
+        /// Clears every per-application assignment and the table.
+        int32_t Clear();
+
+        /// Forgets what was written (e.g. after an audio service restart); the next apply rewrites.
+        void Invalidate();
+
+        /// Reduces an executable name or path to its lowercase file name.
+        static std::wstring NormalizeExe(const std::wstring &exe);
+
+    private:
+        /// App (pid, exe), flow, role.
+        using RouteKey = std::tuple<uint32_t, std::wstring, uint8_t, uint8_t>;
+        /// Pid, flow, role.
+        using WriteKey = std::tuple<uint32_t, uint8_t, uint8_t>;
+
+        AppBatchResult ApplyLocked(const std::vector<AppAssignment> &assignments);
+
+        std::shared_ptr<AppPolicy> m_policy;
+
+        mutable std::mutex m_mutex;          ///< Serializes batches; held across policy writes.
+        std::map<RouteKey, AppRoute> m_routes;
+        std::map<WriteKey, std::wstring> m_written; ///< Endpoint each process was last given.
+    };
+}
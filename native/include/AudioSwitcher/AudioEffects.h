@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <mmdeviceapi.h>
+#include <propsys.h>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Tri-state for settings that an endpoint may not expose at all.
+     */
+    enum class EffectState : uint8_t
+    {
+        Unknown,  ///< Not reported by the endpoint (e.g. no enhancement APOs installed).
+        Disabled,
+        Enabled,
+    };
+
+    /**
+     * @brief Processing that adds latency on an endpoint: audio enhancements (SysFx APOs)
+     *        and spatial sound (Windows Sonic, Dolby Atmos, DTS:X).
+     */
+    struct EffectsInfo
+    {
+        bool loaded = false;                        ///< False until read (effects are loaded lazily).
+        EffectState enhancements = EffectState::Unknown;
+        EffectState spatialAudio = EffectState::Unknown; ///< Render endpoints only.
+        uint32_t spatialMaxObjects = 0;             ///< Dynamic objects the spatial format offers.
+    };
+
+    /**
+     * @brief Reads enhancement and spatial audio state of one endpoint.
+     *
+     * Costs one property read plus, for render endpoints, one ISpatialAudioClient
+     * activation.
+     *
+     * @param device Endpoint to query.
+     * @param store Its property store, already opened for reading.
+     * @param flow Data flow of the endpoint.
+     * @return EffectsInfo With `loaded` set.
+     */
+    EffectsInfo ReadEffects(IMMDevice *device, IPropertyStore *store, EDataFlow flow);
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <mmdeviceapi.h> // Required for IMMDevice*
+#include "AudioSwitcher/EndpointKey.h"
 
 namespace AudioSwitcher
 {
@@ -12,6 +13,7 @@ namespace AudioSwitcher
     struct AudioDevice
     {
         std::wstring id;             ///< The unique ID of the audio device (used by the system).
+        EndpointKey key;             ///< Compact form of `id`, for comparisons.
         std::wstring name;           ///< Friendly name shown to the user (e.g., "Speakers", "Headset").
         IMMDevice *device = nullptr; ///< Pointer to the actual device object (optional for advanced use).
         // Explicit default constructor to fix the issue
@@ -31,6 +33,7 @@ namespace AudioSwitcher
         AudioDevice(AudioDevice &&other) noexcept
         {
             id = std::move(other.id);
+            key = other.key;
             name = std::move(other.name);
             device = other.device;
             other.device = nullptr;
@@ -43,6 +46,7 @@ namespace AudioSwitcher
                 if (device)
                     device->Release();
                 id = std::move(other.id);
+                key = other.key;
                 name = std::move(other.name);
                 device = other.device;
                 other.device = nullptr;
@@ -71,6 +75,15 @@ namespace AudioSwitcher
          * @return true if successful, false otherwise.
          */
         static bool setDefaultOutputDevice(const std::wstring &deviceId);
+
+        /**
+         * @brief Makes @p deviceId the default for a single role, through the cached
+         *        IPolicyConfig. Works for render and capture endpoints.
+         *
+         * @return true if SetDefaultEndpoint succeeded.
+         * @throws ServiceLostError If the Windows Audio service is not running.
+         */
+        static bool setDefaultEndpoint(const std::wstring &deviceId, ERole role);
     };
 
 } // namespace AudioSwitcher
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Most-recently-used history of default endpoints, one list per flow and role.
+     *
+     * Fed from default-changed notifications and from switches made through this library,
+     * so "switch back" and "cycle" can pick their target from memory instead of
+     * enumerating endpoints. The front of each list is the current default as last seen.
+     * Entries are never dropped when an endpoint disappears; callers skip unavailable
+     * ones, so a headset that is plugged back in is found again.
+     *
+     * Flow and role are the numeric EDataFlow (render, capture) and ERole values, which
+     * keeps this class platform independent.
+     */
+    class DefaultHistory
+    {
+    public:
+        static constexpr size_t kFlows = 2; ///< eRender, eCapture.
+        static constexpr size_t kRoles = 3; ///< eConsole, eMultimedia, eCommunications.
+        static constexpr size_t kDepth = 8; ///< Entries kept per flow and role.
+
+        using Available = std::function<bool(const EndpointKey &)>;
+
+        /// Process-wide history (leaked).
+        static DefaultHistory &Instance();
+
+        /**
+         * @brief Moves @p key to the front of the (flow, role) list.
+         * @return false if it already was the current entry, or the arguments are out of range.
+         */
+        bool Record(uint8_t flow, uint8_t role, const EndpointKey &key);
+
+        /// Current entry, or the empty key if nothing was recorded.
+        EndpointKey Current(uint8_t flow, uint8_t role) const;
+
+        /**
+         * @brief The most recent entry other than @p current for which @p available is true.
+         *
+         * @p current is normally the live default, which may differ from the front entry
+         * if a change was missed; it is skipped wherever it sits in the list.
+         *
+         * @return The empty key if there is no such entry.
+         */
+        EndpointKey Previous(uint8_t flow, uint8_t role, const EndpointKey &current, const Available &available) const;
+
+        /// Entries of the (flow, role) list, most recent first.
+        std::vector<EndpointKey> Entries(uint8_t flow, uint8_t role) const;
+
+        void Clear();
+
+        /**
+         * @brief Picks the candidate after @p current, wrapping around.
+         *
+         * @return The first candidate if @p current is not among them, the empty key if
+         *         there are no candidates.
+         */
+        static EndpointKey CycleAfter(const std::vector<EndpointKey> &candidates, const EndpointKey &current);
+
+    private:
+        struct Slot
+        {
+            std::array<EndpointKey, kDepth> entries;
+            uint8_t count = 0;
+        };
+
+        static bool InRange(uint8_t flow, uint8_t role) { return flow < kFlows && role < kRoles; }
+
+        mutable std::mutex m_mutex;
+        Slot m_slots[kFlows][kRoles];
+    };
+}
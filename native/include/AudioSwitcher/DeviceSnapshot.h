@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <mmdeviceapi.h>
+#include "AudioSwitcher/AudioEffects.h"
+#include "AudioSwitcher/EndpointKey.h"
+#include "AudioSwitcher/JackPresence.h"
+#include "AudioSwitcher/ListenRouting.h"
+#include "Utility/RcuCell.h"
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Plain-data description of one active endpoint (no COM pointers).
+     */
+    struct EndpointInfo
+    {
+        std::wstring id;              ///< Endpoint ID (IMMDevice::GetId()).
+        EndpointKey key;              ///< Compact form of `id`; compare this, not the string.
+        std::wstring name;            ///< Friendly name.
+        EDataFlow flow = eRender;     ///< eRender or eCapture.
+        uint8_t defaultRoles = 0;     ///< Bitmask of (1 << ERole) for roles this endpoint is default for.
+        ListenSettings listen;        ///< "Listen to this device" settings (capture endpoints only).
+        EffectsInfo effects;          ///< Enhancements / spatial audio, loaded on demand by LoadEffects().
+        JackState jack;               ///< Jack presence, loaded on demand by LoadJacks().
+
+        /// True if this endpoint is the default for @p role.
+        bool IsDefaultFor(ERole role) const { return (defaultRoles & (1u << role)) != 0; }
+    };
+
+    /**
+     * @brief In-memory table of all active render and capture endpoints.
+     *
+     * Built lazily on first use with one enumeration and one property store read per
+     * endpoint, then served from memory. Writers replace the whole table (copy-on-write),
+     * so a table returned by Get() is immutable and safe to read without locks.
+     *
+     * The table is published read-copy-update style: readers load it through an atomic
+     * pointer under an epoch pin and never lock, so the JS thread, workers and meter
+     * threads can read while the notification thread publishes. Writers are serialized
+     * among themselves only; a replaced table is freed once no reader can still see it.
+     */
+    class DeviceSnapshot
+    {
+    public:
+        using Table = std::vector<EndpointInfo>;
+
+        /**
+         * @brief Lock-free, reference-count-free view of the table current at Read().
+         *
+         * Valid until destroyed, which must happen on the creating thread. Use Get() to
+         * hand a table to another thread or keep it beyond the current scope.
+         */
+        class View
+        {
+        public:
+            /// False if no table is loaded.
+            explicit operator bool() const { return m_guard && *m_guard; }
+            const Table &operator*() const { return **m_guard; }
+            const Table *operator->() const { return m_guard->get(); }
+
+        private:
+            friend class DeviceSnapshot;
+            using Guard = Utility::RcuCell<std::shared_ptr<const Table>>::ReadGuard;
+            explicit View(Guard &&guard) : m_guard(std::move(guard)) {}
+
+            Guard m_guard;
+        };
+
+        /// Returns the process-wide snapshot (nothing is enumerated until first use).
+        static DeviceSnapshot &Instance();
+
+        /**
+         * @brief Returns the current table, building it on first use.
+         *
+         * Requires COM on the calling thread only when the table has to be built.
+         */
+        std::shared_ptr<const Table> Get();
+
+        /**
+         * @brief Returns the loaded table without building it. Never locks or blocks a
+         *        writer, and does not touch COM.
+         */
+        View Read() const;
+
+        /**
+         * @brief Re-enumerates endpoints and publishes a fresh table.
+         *
+         * @throws std::runtime_error If enumeration fails.
+         */
+        std::shared_ptr<const Table> Refresh();
+
+        /**
+         * @brief Copies the table, applies @p edit to the endpoint with @p id, and publishes it.
+         *
+         * Used to keep the snapshot in step with writes made through this library
+         * without re-enumerating.
+         *
+         * @return false if no table is loaded or the endpoint is not in it.
+         */
+        bool Update(const std::wstring &id, const std::function<void(EndpointInfo &)> &edit);
+
+        /**
+         * @brief Returns the table with effects loaded for every endpoint.
+         *
+         * Effects are not read when the table is built because they cost an extra COM
+         * activation per render endpoint. The first call reads them for all endpoints in
+         * one sweep and publishes them; later calls are served from memory until the
+         * next Refresh().
+         *
+         * @throws std::runtime_error If the table has to be built and enumeration fails.
+         */
+        std::shared_ptr<const Table> LoadEffects();
+
+        /**
+         * @brief Returns the table with jack presence loaded for every endpoint.
+         *
+         * Endpoints already known to JackTracker (kept current by endpoint notifications)
+         * are filled from memory; the rest are read through IKsJackDescription once and
+         * seeded into the tracker. Tables built later pick the tracked state up directly.
+         *
+         * @throws std::runtime_error If the table has to be built and enumeration fails.
+         */
+        std::shared_ptr<const Table> LoadJacks();
+
+        /// Drops the table; the next Get() rebuilds it.
+        void Invalidate();
+
+    private:
+        DeviceSnapshot() = default;
+
+        static std::shared_ptr<const Table> Build();
+
+        std::mutex m_writeMutex; ///< Serializes writers; readers never take it.
+        Utility::RcuCell<std::shared_ptr<const Table>> m_table;
+    };
+}
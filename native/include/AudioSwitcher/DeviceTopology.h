@@ -0,0 +1,32 @@
+#pragma once
+
+#include "AudioSwitcher/TopologyGraph.h"
+
+#include <mmdeviceapi.h>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Walks the IDeviceTopology graph of one endpoint, from its connector through
+     *        the adapter's subunits to the jack, and reads QueryHardwareSupport and jack
+     *        descriptions along the way.
+     *
+     * Costs one activation per part plus the control-interface queries; cache the result
+     * in TopologyCache rather than calling this per query.
+     *
+     * @param device Endpoint to walk.
+     * @param flow Its data flow (render walks downstream, capture upstream).
+     * @param id Its endpoint ID, stored in the result.
+     * @return The graph; parts is empty if the endpoint exposes no topology.
+     */
+    std::shared_ptr<const EndpointTopology> WalkTopology(IMMDevice *device, EDataFlow flow, const std::wstring &id);
+
+    /**
+     * @brief Reads only the jack descriptions of one endpoint: the part across the
+     *        endpoint connector carries IKsJackDescription, so this is three activations
+     *        instead of a full walk. Used to refresh jack presence on plug events.
+     *
+     * @return The endpoint's jacks; empty if it exposes none (e.g. USB or Bluetooth).
+     */
+    std::vector<JackDescription> ReadEndpointJacks(IMMDevice *device);
+}
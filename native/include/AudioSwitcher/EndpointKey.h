@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Fixed-size identity of an endpoint, used instead of its ID string as map key
+     *        and in comparisons.
+     *
+     * MMDevice endpoint IDs have the form `{0.0.F.00000000}.{guid}`, where F is the data
+     * flow (0 render, 1 capture) and the GUID is a random (version 4) UUID. Such IDs are
+     * packed into 128 bits: the GUID's fixed version nibble is replaced by the flow, so
+     * no information is lost and the key converts back to the exact original string.
+     *
+     * IDs that do not have this form (virtual drivers, uppercase GUIDs, other GUID
+     * versions) are interned in a process-wide table and keyed by their slot. Interned
+     * IDs are never freed, so only IDs reported by the system should be interned; input
+     * from callers goes through Lookup(), which never adds entries.
+     *
+     * The default-constructed key is empty and compares unequal to every ID.
+     */
+    class EndpointKey
+    {
+    public:
+        EndpointKey() = default;
+
+        /// Key for @p id, interning it if it is not in the standard form.
+        static EndpointKey Intern(const std::wstring &id);
+        static EndpointKey Intern(const std::string &utf8Id);
+
+        /**
+         * @brief Key for @p id without touching the intern table.
+         * @return The empty key for a non-standard ID that has not been interned, i.e.
+         *         one the system never reported.
+         */
+        static EndpointKey Lookup(const std::wstring &id);
+        static EndpointKey Lookup(const std::string &utf8Id);
+
+        /// True for the default-constructed key.
+        bool Empty() const { return m_high == 0 && m_low == 0; }
+
+        /// True if the ID was packed directly (standard form), false if interned or empty.
+        bool IsPacked() const;
+
+        /// 0 for render, 1 for capture, -1 if the ID is not in the standard form.
+        int Flow() const;
+
+        /// The original ID string.
+        std::wstring ToWString() const;
+        std::string ToUtf8() const;
+
+        /// 64-bit mix of both halves. Packed keys are mostly random bits already.
+        uint64_t Hash() const
+        {
+            uint64_t x = m_high ^ (m_low * 0x9E3779B97F4A7C15ull);
+            x ^= x >> 31;
+            x *= 0xBF58476D1CE4E5B9ull;
+            return x ^ (x >> 29);
+        }
+
+        bool operator==(const EndpointKey &other) const { return m_high == other.m_high && m_low == other.m_low; }
+        bool operator!=(const EndpointKey &other) const { return !(*this == other); }
+        bool operator<(const EndpointKey &other) const
+        {
+            return m_high != other.m_high ? m_high < other.m_high : m_low < other.m_low;
+        }
+
+    private:
+        EndpointKey(uint64_t high, uint64_t low) : m_high(high), m_low(low) {}
+
+        template <typename Char>
+        static bool Pack(const Char *id, size_t length, EndpointKey &key);
+
+        template <typename Char>
+        static EndpointKey Resolve(const std::basic_string<Char> &id, bool intern);
+
+        uint64_t m_high = 0; ///< GUID hex digits 0-15, with digit 12 holding the kind.
+        uint64_t m_low = 0;  ///< GUID hex digits 16-31, or the intern slot.
+    };
+
+    /**
+     * @brief Hasher for unordered containers keyed by EndpointKey.
+     */
+    struct EndpointKeyHash
+    {
+        size_t operator()(const EndpointKey &key) const noexcept { return static_cast<size_t>(key.Hash()); }
+    };
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+#include "AudioSwitcher/NotificationDispatcher.h"
+
+#include <Windows.h>
+#include <mmdeviceapi.h>
+#include <endpointvolume.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Subscribes to Core Audio endpoint callbacks and forwards them to a dispatcher.
+     *
+     * Registers one IMMNotificationClient (default, presence, state and property changes)
+     * and one IAudioEndpointVolumeCallback per active endpoint. The callbacks only build a
+     * Notification and Post() it, so the audio service's threads are never held up by
+     * anything downstream.
+     *
+     * Objects are owned by the notifier, not by their COM reference counts; they stay
+     * valid until Stop() has unregistered them.
+     */
+    class EndpointNotifier : public IMMNotificationClient
+    {
+    public:
+        explicit EndpointNotifier(NotificationDispatcher &dispatcher);
+        virtual ~EndpointNotifier();
+
+        EndpointNotifier(const EndpointNotifier &) = delete;
+        EndpointNotifier &operator=(const EndpointNotifier &) = delete;
+
+        /**
+         * @brief Registers for endpoint and volume callbacks. Requires an MTA thread.
+         * @throws std::runtime_error If the endpoint callback cannot be registered.
+         */
+        void Start();
+
+        /// Unregisters every callback. Requires an MTA thread.
+        void Stop();
+
+        /**
+         * @brief Re-registers every callback against a restarted audio service, whose
+         *        previous registrations died with it. No-op if not started.
+         */
+        void Restart();
+
+        /**
+         * @brief Subscribes volume callbacks of endpoints that became active and drops those
+         *        that went away. Must not be called from inside a Core Audio callback.
+         */
+        void SyncVolumeCallbacks();
+
+        /// Number of endpoints with a volume callback.
+        size_t WatchedEndpoints() const;
+
+        // IUnknown
+        ULONG STDMETHODCALLTYPE AddRef() override;
+        ULONG STDMETHODCALLTYPE Release() override;
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **object) override;
+
+        // IMMNotificationClient
+        HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR deviceId) override;
+        HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR deviceId) override;
+        HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR deviceId) override;
+        HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR deviceId, DWORD newState) override;
+        HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR deviceId, const PROPERTYKEY key) override;
+
+    private:
+        class VolumeCallback;
+
+        struct Subscription
+        {
+            IAudioEndpointVolume *volume = nullptr;
+            std::unique_ptr<VolumeCallback> callback;
+        };
+
+        void Post(NotificationKind kind, LPCWSTR deviceId);
+        void Unsubscribe(Subscription &subscription);
+
+        NotificationDispatcher &m_dispatcher;
+        std::atomic<ULONG> m_refs{1};
+
+        mutable std::mutex m_mutex;
+        IMMDeviceEnumerator *m_enumerator = nullptr;
+        std::unordered_map<EndpointKey, Subscription, EndpointKeyHash> m_subscriptions;
+    };
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// Required Windows headers
+#include <Windows.h>
+#include <mmdeviceapi.h>
+#include <inspectable.h>
+#include <hstring.h>
+
+// ----------------------------------------------------------------------------
+// IAudioPolicyConfig.h
+// Undocumented WinRT activation factory behind Settings > "App volume and device
+// preferences" (Windows 10 1803+), for per-process default audio endpoints.
+// Activated from the runtime class "Windows.Media.Internal.AudioPolicyConfig".
+// ----------------------------------------------------------------------------
+
+#define AUDIO_POLICY_CONFIG_CLASS L"Windows.Media.Internal.AudioPolicyConfig"
+
+// Device IDs passed to the factory are device interface paths:
+//   \\?\SWD#MMDEVAPI#<endpoint id>#<interface class>
+#define AUDIO_POLICY_DEVICE_PREFIX L"\\\\?\\SWD#MMDEVAPI#"
+#define AUDIO_POLICY_RENDER_INTERFACE L"#{e6327cad-dcec-4949-ae8a-991e976a79d2}"
+#define AUDIO_POLICY_CAPTURE_INTERFACE L"#{2eef81be-33fa-4800-9670-1cd474972c3f}"
+
+// ----------------------------------------------------------------------------
+// interface IAudioPolicyConfigFactory
+// Windows 10 21H2 and later use the first IID, 1803 through 21H1 the second; the
+// vtable layout is the same. Only the trailing three methods are used.
+// ----------------------------------------------------------------------------
+
+interface DECLSPEC_UUID("ab3d4648-e242-459f-b02f-541c70306324")
+    IAudioPolicyConfigFactory;
+
+static const IID IID_IAudioPolicyConfigFactoryDownlevel =
+    {0x2a59116d, 0x6c4f, 0x45e0, {0xa7, 0x4f, 0x70, 0x7e, 0x3f, 0xef, 0x92, 0x58}};
+
+interface IAudioPolicyConfigFactory : public IInspectable
+{
+public:
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__add_CtxVolumeChange() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__remove_CtxVolumeChanged() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__add_RingerVibrateStateChanged() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__remove_RingerVibrateStateChange() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__SetVolumeGroupGainForId() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetVolumeGroupGainForId() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetActiveVolumeGroupForEndpointId() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetVolumeGroupsForEndpoint() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetCurrentVolumeContext() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__SetVolumeGroupMuteForId() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetVolumeGroupMuteForId() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__SetRingerVibrateState() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetRingerVibrateState() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__SetPreferredChatApplication() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__ResetPreferredChatApplication() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetPreferredChatApplication() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__GetCurrentChatApplications() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__add_ChatContextChanged() = 0;
+    virtual HRESULT STDMETHODCALLTYPE __incomplete__remove_ChatContextChanged() = 0;
+
+    virtual HRESULT STDMETHODCALLTYPE SetPersistedDefaultAudioEndpoint(
+        UINT processId,
+        EDataFlow flow,
+        ERole role,
+        HSTRING deviceId) = 0;
+
+    virtual HRESULT STDMETHODCALLTYPE GetPersistedDefaultAudioEndpoint(
+        UINT processId,
+        EDataFlow flow,
+        ERole role,
+        HSTRING *deviceId) = 0;
+
+    virtual HRESULT STDMETHODCALLTYPE ClearAllPersistedApplicationDefaultEndpoints() = 0;
+};
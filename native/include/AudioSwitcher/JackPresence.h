@@ -0,0 +1,73 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+#include "AudioSwitcher/TopologyGraph.h"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Jack presence of one endpoint, summarized over its jacks.
+     */
+    struct JackState
+    {
+        bool loaded = false;        ///< False until read (jacks are loaded on demand).
+        bool present = false;       ///< The endpoint reports at least one jack.
+        bool connected = false;     ///< Any of its jacks has something plugged in.
+        uint32_t color = 0;         ///< 0x00RRGGBB of the connected jack (else the first one).
+        uint8_t connectionType = 0; ///< EPcxConnectionType of that jack.
+        uint8_t geoLocation = 0;    ///< EPcxGeoLocation of that jack.
+    };
+
+    /// Reduces IKsJackDescription entries to one JackState (with `loaded` set).
+    JackState SummarizeJacks(const std::vector<JackDescription> &jacks);
+
+    /**
+     * @brief Last known jack presence per endpoint, kept current from endpoint
+     *        notifications, so plug transitions can be told apart from repeats and the
+     *        snapshot can be rebuilt without re-reading every jack.
+     */
+    class JackTracker
+    {
+    public:
+        enum class Change : uint8_t
+        {
+            None,
+            Connected,    ///< Something was plugged in.
+            Disconnected, ///< The last plug was removed.
+        };
+
+        JackTracker() = default;
+        JackTracker(const JackTracker &) = delete;
+        JackTracker &operator=(const JackTracker &) = delete;
+
+        /// Process-wide tracker (leaked).
+        static JackTracker &Instance();
+
+        /**
+         * @brief Records @p state and reports the transition from the previous one.
+         *
+         * @param appeared True when the endpoint just became active (added, or its state
+         *        changed to active). An endpoint seen for the first time only reports
+         *        Connected in that case; otherwise it is recorded silently.
+         */
+        Change Update(const EndpointKey &key, const JackState &state, bool appeared);
+
+        /// Records @p state without reporting a change (initial load).
+        void Seed(const EndpointKey &key, const JackState &state);
+
+        /// Looks up the last known state. Returns false if the endpoint is unknown.
+        bool Find(const EndpointKey &key, JackState &state) const;
+
+        void Forget(const EndpointKey &key);
+        void Clear();
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<EndpointKey, JackState, EndpointKeyHash> m_states;
+    };
+}
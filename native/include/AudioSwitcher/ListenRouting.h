@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mmdeviceapi.h>
+#include <propsys.h>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief "Listen to this device" settings of a capture endpoint.
+     *
+     * Windows keeps these in the capture endpoint's property store; when enabled the
+     * audio engine plays the capture stream on the target render endpoint.
+     */
+    struct ListenSettings
+    {
+        bool valid = false;   ///< True if the property store could be read (capture endpoints only).
+        bool enabled = false; ///< "Listen to this device" checkbox.
+        std::wstring targetId; ///< Render endpoint ID; empty means "Default Playback Device".
+    };
+
+    /**
+     * @brief A requested change to the listen routing of one capture endpoint.
+     */
+    struct ListenChange
+    {
+        std::wstring captureId; ///< Capture endpoint to change.
+        bool enabled = false;   ///< New enable state.
+        std::wstring targetId;  ///< New render target (empty = default playback device).
+    };
+
+    /**
+     * @brief Reads listen settings from an already opened property store.
+     *
+     * @param store Property store of a capture endpoint (STGM_READ is enough).
+     * @return ListenSettings Settings with `valid` set if the store was readable.
+     */
+    ListenSettings ReadListenSettings(IPropertyStore *store);
+
+    /**
+     * @brief Applies several listen routing changes using a single IPolicyConfig instance.
+     *
+     * The target is written before the enable flag so audio never starts on the old target.
+     *
+     * @param changes Changes to apply, in order.
+     * @return std::vector<bool> One result per change (true = both values written).
+     * @throws std::runtime_error If the IPolicyConfig COM object cannot be created.
+     */
+    std::vector<bool> ApplyListenChanges(const std::vector<ListenChange> &changes);
+}
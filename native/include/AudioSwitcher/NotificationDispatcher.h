@@ -0,0 +1,202 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+#include "Utility/MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Kind of endpoint change reported by Core Audio.
+     */
+    enum class NotificationKind : uint8_t
+    {
+        DefaultChanged,  ///< A default endpoint changed (per flow and role).
+        DeviceAdded,
+        DeviceRemoved,
+        StateChanged,    ///< Active / disabled / unplugged / not present.
+        PropertyChanged, ///< Any property store value (name, format, ...).
+        VolumeChanged,   ///< Endpoint master volume or mute.
+        ServiceRestarted, ///< The audio service came back; earlier state may be stale.
+        JackConnected,   ///< A jack on a non-default endpoint was plugged in (derived, never posted by callbacks).
+    };
+
+    /**
+     * @brief One endpoint change, as queued by a callback thread.
+     *
+     * Only the fields relevant to `kind` are meaningful. Flow and role carry the numeric
+     * EDataFlow / ERole values so the dispatcher itself stays platform independent.
+     */
+    struct Notification
+    {
+        NotificationKind kind = NotificationKind::PropertyChanged;
+        uint8_t flow = 0;       ///< EDataFlow (DefaultChanged, JackConnected).
+        uint8_t role = 0;       ///< ERole (DefaultChanged).
+        std::wstring deviceId;  ///< Endpoint id; empty for "no default endpoint".
+        uint32_t state = 0;     ///< DEVICE_STATE_* (StateChanged).
+        float volume = 0.0f;    ///< Master volume scalar (VolumeChanged).
+        bool muted = false;     ///< Mute state (VolumeChanged).
+        uint32_t coalesced = 0; ///< Callbacks folded into this notification.
+        int64_t postedUs = 0;   ///< Arrival of the first folded callback (NowMicros clock).
+    };
+
+    /**
+     * @brief Latency summary in microseconds.
+     */
+    struct LatencyStats
+    {
+        uint64_t count = 0;
+        double lastUs = 0.0;
+        double averageUs = 0.0;
+        double maxUs = 0.0;
+    };
+
+    /**
+     * @brief Counters exposed for diagnostics.
+     */
+    struct DispatcherStats
+    {
+        uint64_t posted = 0;     ///< Callbacks received.
+        uint64_t coalesced = 0;  ///< Callbacks folded into a later one of the same batch.
+        uint64_t suppressed = 0; ///< Notifications dropped because nothing changed since the last delivery.
+        uint64_t delivered = 0;  ///< Notifications handed to the sink.
+        uint64_t batches = 0;
+        size_t queueDepth = 0;
+        size_t queueHighWater = 0;
+        LatencyStats dispatch; ///< Callback arrival → sink.
+        LatencyStats delivery; ///< Callback arrival → consumer (see RecordDelivery).
+    };
+
+    /**
+     * @brief Dispatcher tuning.
+     */
+    struct DispatcherOptions
+    {
+        /// How long to keep collecting after the first callback of a burst before delivering.
+        std::chrono::microseconds batchWindow{2000};
+
+        /// Upper bound on notifications per batch.
+        size_t maxBatch = 256;
+
+        /**
+         * @brief Wraps the dispatcher thread's loop, so platform code can hold per-thread
+         *        state (COM apartment, MMCSS registration) as RAII locals around it.
+         *        Must call @p loop exactly once. Defaults to calling it directly.
+         */
+        std::function<void(const std::function<void()> &loop)> threadScope;
+    };
+
+    /**
+     * @brief Moves endpoint callbacks off the COM threads that raise them.
+     *
+     * Post() timestamps the callback and pushes it onto a lock-free MPSC queue; it never
+     * blocks, so Core Audio's notification threads return immediately. A dedicated thread
+     * drains the queue in batches: callbacks that arrive within the batch window are
+     * folded per endpoint (and per flow/role for default changes), keeping the position of
+     * the first and the payload of the last, and default/volume notifications that repeat
+     * the last delivered value are dropped. Each batch is handed to the sink in arrival order.
+     */
+    class NotificationDispatcher
+    {
+    public:
+        using Sink = std::function<void(std::vector<Notification> &&batch)>;
+
+        /**
+         * @param sink Receives each batch on the dispatcher thread.
+         * @param options Batching and thread setup.
+         */
+        explicit NotificationDispatcher(Sink sink, DispatcherOptions options = {});
+
+        /// Stops the thread. Notifications still queued are discarded.
+        ~NotificationDispatcher();
+
+        NotificationDispatcher(const NotificationDispatcher &) = delete;
+        NotificationDispatcher &operator=(const NotificationDispatcher &) = delete;
+
+        /// Queues a callback. Lock-free; safe from any thread. Stamps `postedUs` if unset.
+        void Post(Notification notification);
+
+        /**
+         * @brief Records end-to-end latency for a batch once its consumer has seen it
+         *        (e.g. on the JS thread). Safe from any thread.
+         */
+        void RecordDelivery(const std::vector<Notification> &batch);
+
+        DispatcherStats Stats() const;
+
+        /// Clears latency figures and restarts high-water tracking; counters keep running.
+        void ResetLatency();
+
+        /// Monotonic clock shared by producers and consumers, in microseconds.
+        static int64_t NowMicros();
+
+    private:
+        /**
+         * @brief Key under which notifications of one batch are folded together: the kind
+         *        group plus the endpoint, or flow and role for default changes.
+         */
+        struct FoldKey
+        {
+            char group = 0;
+            uint8_t flow = 0;
+            uint8_t role = 0;
+            EndpointKey endpoint;
+
+            bool operator==(const FoldKey &other) const
+            {
+                return group == other.group && flow == other.flow && role == other.role && endpoint == other.endpoint;
+            }
+        };
+
+        struct FoldKeyHash
+        {
+            size_t operator()(const FoldKey &key) const noexcept
+            {
+                const size_t tag = (static_cast<size_t>(static_cast<uint8_t>(key.group)) << 16) | (key.flow << 8) | key.role;
+                return EndpointKeyHash()(key.endpoint) ^ (tag * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        static FoldKey KeyOf(const Notification &notification);
+
+        void Run();
+        void WaitForWork();
+        void Fold(Notification &&notification);
+        void Deliver();
+        bool IsRepeat(const Notification &notification);
+
+        static void Accumulate(LatencyStats &stats, double us);
+
+        Sink m_sink;
+        DispatcherOptions m_options;
+
+        Utility::MpscQueue<Notification> m_queue;
+        std::atomic<uint64_t> m_posted{0};
+
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wake;
+        std::atomic<bool> m_sleeping{false};
+        std::atomic<bool> m_stopping{false};
+
+        // Dispatcher thread only
+        std::vector<Notification> m_batch;
+        std::unordered_map<FoldKey, size_t, FoldKeyHash> m_batchIndex;       ///< Fold key → position in m_batch.
+        std::unordered_map<FoldKey, Notification, FoldKeyHash> m_lastSent; ///< Fold key → last delivered value.
+
+        mutable std::mutex m_statsMutex;
+        DispatcherStats m_stats;
+
+        std::thread m_thread;
+    };
+}
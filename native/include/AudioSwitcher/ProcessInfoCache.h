@@ -0,0 +1,168 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Identifies one process instance. Windows reuses pids, so the start time is
+     *        part of the key: an entry can never describe a later process with the same pid.
+     */
+    struct ProcessKey
+    {
+        uint32_t pid = 0;
+        uint64_t startTime = 0; ///< Creation time (FILETIME ticks on Windows).
+
+        bool operator==(const ProcessKey &other) const { return pid == other.pid && startTime == other.startTime; }
+    };
+
+    /**
+     * @brief What the cache knows about a process.
+     */
+    struct ProcessInfo
+    {
+        std::wstring name;       ///< Executable file name, e.g. "chrome.exe".
+        std::wstring path;       ///< Full image path (empty if access was denied).
+        bool accessible = false; ///< False for processes that could not be opened (protected, elevated).
+    };
+
+    /**
+     * @brief Source of process information. The Windows implementation uses OpenProcess and
+     *        QueryFullProcessImageName; tests substitute a fake table.
+     *
+     * Both calls may be made concurrently from the resolver threads.
+     */
+    class ProcessTable
+    {
+    public:
+        virtual ~ProcessTable() = default;
+
+        /// Reads the start time of @p pid. Returns false if the process does not exist.
+        virtual bool GetStartTime(uint32_t pid, uint64_t &startTime) = 0;
+
+        /**
+         * @brief Reads name and path of @p pid (the slow part).
+         * @return false if the process does not exist. A process that exists but cannot
+         *         be opened returns true with `accessible == false`.
+         */
+        virtual bool Query(uint32_t pid, ProcessInfo &info) = 0;
+    };
+
+    /**
+     * @brief Result of a cache lookup.
+     */
+    struct ProcessLookup
+    {
+        enum class State
+        {
+            Ready,   ///< `info` is valid.
+            Pending, ///< Queued for resolution; ask again later.
+            Gone,    ///< The process exited before it could be resolved.
+        };
+
+        State state = State::Pending;
+        ProcessKey key;
+        ProcessInfo info;
+    };
+
+    /**
+     * @brief Counters for diagnostics and tests.
+     */
+    struct ProcessCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t resolutions = 0; ///< ProcessTable::Query calls made.
+        uint64_t evictions = 0;   ///< Entries dropped for capacity.
+        uint64_t invalidations = 0;
+        size_t size = 0;
+        size_t pending = 0;
+    };
+
+    /**
+     * @brief Caches process name/path by pid + start time, resolved off the caller's thread.
+     *
+     * Lookup() never blocks on the process table: a miss queues the pid for a small pool of
+     * resolver threads and reports Pending, so session listings return immediately and
+     * fill in names on a later call. Entries live until their session expires
+     * (Invalidate()) or the least recently used entry is evicted to stay under capacity.
+     */
+    class ProcessInfoCache
+    {
+    public:
+        /**
+         * @param table Process information source.
+         * @param workers Number of resolver threads.
+         * @param capacity Maximum number of cached processes.
+         */
+        ProcessInfoCache(std::shared_ptr<ProcessTable> table, size_t workers = 2, size_t capacity = 1024);
+        ~ProcessInfoCache();
+
+        ProcessInfoCache(const ProcessInfoCache &) = delete;
+        ProcessInfoCache &operator=(const ProcessInfoCache &) = delete;
+
+        /// Returns the cached entry for @p pid, or queues it and returns Pending.
+        ProcessLookup Lookup(uint32_t pid);
+
+        /**
+         * @brief Returns the entry for exactly @p key, or Gone if that process instance is
+         *        not cached. Never queues a resolution.
+         */
+        ProcessLookup Peek(const ProcessKey &key);
+
+        /**
+         * @brief Drops the entry for @p key (e.g. its audio session expired). An entry for a
+         *        newer process that reused the pid is left alone.
+         */
+        void Invalidate(const ProcessKey &key);
+
+        /// Drops whatever entry is cached for @p pid.
+        void InvalidatePid(uint32_t pid);
+
+        /// Blocks until no resolution is queued or running.
+        void WaitIdle();
+
+        ProcessCacheStats Stats() const;
+
+    private:
+        struct Entry
+        {
+            ProcessKey key;
+            ProcessInfo info;
+        };
+
+        using LruList = std::list<Entry>;
+
+        void WorkerLoop();
+        void Insert(const ProcessKey &key, ProcessInfo info);
+        void Erase(std::unordered_map<uint32_t, LruList::iterator>::iterator it);
+
+        std::shared_ptr<ProcessTable> m_table;
+        size_t m_capacity;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_idle;
+        LruList m_lru;                                          ///< Most recently used first.
+        std::unordered_map<uint32_t, LruList::iterator> m_byPid; ///< At most one live process per pid.
+        std::unordered_set<uint32_t> m_gone;                    ///< Pids that exited before resolution.
+        std::deque<uint32_t> m_queue;
+        std::unordered_set<uint32_t> m_queued;                  ///< Queued or being resolved.
+        size_t m_active = 0;
+        bool m_stopping = false;
+        ProcessCacheStats m_stats;
+
+        std::vector<std::thread> m_workers;
+    };
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief HRESULTs that mean the Windows Audio service (audiosrv) went away, as opposed to
+     *        a single endpoint failing. Values are spelled out so this header stays portable.
+     */
+    namespace ServiceHResult
+    {
+        constexpr int32_t ServiceNotRunning = static_cast<int32_t>(0x88890010); ///< AUDCLNT_E_SERVICE_NOT_RUNNING
+        constexpr int32_t ServerDied = static_cast<int32_t>(0x80010007);        ///< RPC_E_SERVER_DIED
+        constexpr int32_t Disconnected = static_cast<int32_t>(0x80010108);      ///< RPC_E_DISCONNECTED
+        constexpr int32_t ServerDiedDne = static_cast<int32_t>(0x80010012);     ///< RPC_E_SERVER_DIED_DNE
+        constexpr int32_t ServerUnavailable = static_cast<int32_t>(0x800706BA); ///< RPC_S_SERVER_UNAVAILABLE
+        constexpr int32_t CallFailed = static_cast<int32_t>(0x800706BE);        ///< RPC_S_CALL_FAILED
+        constexpr int32_t CallFailedDne = static_cast<int32_t>(0x800706BF);     ///< RPC_S_CALL_FAILED_DNE
+        constexpr int32_t ObjectNotConnected = static_cast<int32_t>(0x800401FD); ///< CO_E_OBJNOTCONNECTED
+    }
+
+    /// True if @p hr means the audio service (and with it every cached COM object) is gone.
+    bool IsServiceLostError(int32_t hr);
+
+    /**
+     * @brief Thrown when a call fails because the audio service is not running. Surfaces to
+     *        JS with code 'ESERVICELOST'; recovery has already been scheduled.
+     */
+    class ServiceLostError : public std::runtime_error
+    {
+    public:
+        ServiceLostError(const std::string &message, int32_t hr) : std::runtime_error(message), m_hr(hr) {}
+
+        int32_t HResult() const { return m_hr; }
+
+    private:
+        int32_t m_hr;
+    };
+
+    /**
+     * @brief State set through this library that should survive a service restart.
+     *        Only successful writes are recorded.
+     */
+    struct DesiredState
+    {
+        std::map<uint8_t, std::wstring> defaults; ///< EDataFlow → endpoint made default for all roles.
+        bool hasDefaultMute = false;
+        bool defaultMute = false;                 ///< Mute of the default render endpoint.
+        std::vector<std::pair<std::wstring, bool>> mutes; ///< Per-endpoint mutes, in the order they were set.
+    };
+
+    /**
+     * @brief How recorded state is written back once the service answers again. Each
+     *        action returns false if the write failed; unset actions are skipped.
+     */
+    struct ReplayActions
+    {
+        std::function<bool(const std::wstring &id, uint8_t flow)> setDefault;
+        std::function<bool(bool mute)> setDefaultMute;
+        std::function<bool(const std::wstring &id, bool mute)> setMute;
+    };
+
+    /**
+     * @brief Reported to listeners after each completed recovery.
+     */
+    struct RecoveryEvent
+    {
+        uint64_t generation = 0; ///< Number of recoveries so far, including this one.
+        uint32_t attempts = 0;   ///< Probes it took.
+        int32_t cause = 0;       ///< HRESULT that triggered it.
+        double downtimeMs = 0;   ///< First detection → recovered.
+        uint32_t replayed = 0;   ///< Desired-state writes that succeeded.
+        uint32_t replayFailed = 0;
+    };
+
+    struct RecoveryStats
+    {
+        bool recovering = false;
+        uint64_t detections = 0; ///< Service-lost HRESULTs reported.
+        uint64_t restarts = 0;   ///< Completed recoveries.
+        uint32_t attempts = 0;   ///< Probes made by the current (or last) recovery.
+        int32_t lastCause = 0;
+        double lastDowntimeMs = 0;
+    };
+
+    struct RecoveryOptions
+    {
+        std::chrono::milliseconds initialDelay{100}; ///< Wait before the first probe.
+        std::chrono::milliseconds maxDelay{5000};    ///< Backoff cap; the delay doubles per failed probe.
+
+        /**
+         * @brief Wraps the recovery thread's loop so platform code can hold per-thread state
+         *        (the COM apartment) around it. Must call @p loop exactly once.
+         */
+        std::function<void(const std::function<void()> &loop)> threadScope;
+    };
+
+    /**
+     * @brief Brings the library back after the Windows Audio service restarts.
+     *
+     * When audiosrv restarts, every cached enumerator, policy-config and endpoint interface
+     * is dead and calls fail with AUDCLNT_E_SERVICE_NOT_RUNNING or RPC errors. Call sites
+     * hand such HRESULTs to ThrowIfLost(), which wakes a recovery thread and fails the call
+     * fast. The thread then, with exponential backoff between attempts:
+     *
+     *  1. runs the probe, which drops cached COM objects and recreates them, until the
+     *     service answers;
+     *  2. runs the registered hooks (notification re-subscription, cache invalidation);
+     *  3. replays the desired state (defaults, mutes);
+     *  4. notifies listeners.
+     *
+     * Reports that arrive while a recovery is in progress are folded into it. Without a
+     * probe (e.g. in the CLI) losses are only counted and thrown.
+     */
+    class ServiceRecovery
+    {
+    public:
+        using Probe = std::function<bool()>;
+        using Hook = std::function<void()>;
+        using Listener = std::function<void(const RecoveryEvent &)>;
+
+        explicit ServiceRecovery(RecoveryOptions options = {});
+
+        /// Stops the recovery thread; a recovery in progress is abandoned.
+        ~ServiceRecovery();
+
+        ServiceRecovery(const ServiceRecovery &) = delete;
+        ServiceRecovery &operator=(const ServiceRecovery &) = delete;
+
+        /// Process-wide instance (leaked). Configured by the bindings at load.
+        static ServiceRecovery &Instance();
+
+        /// Sets the probe and backoff. Call before the first report.
+        void Configure(Probe probe, RecoveryOptions options);
+
+        void SetReplay(ReplayActions actions);
+
+        /// Adds a step run after each successful probe, in registration order.
+        uint64_t AddHook(Hook hook);
+        void RemoveHook(uint64_t id);
+
+        uint64_t AddListener(Listener listener);
+        void RemoveListener(uint64_t id);
+
+        /**
+         * @brief Starts a recovery if @p hr means the service is gone.
+         * @return true if @p hr was a service-lost error.
+         */
+        bool Report(int32_t hr);
+
+        /// Report() and, if the service is gone, throw ServiceLostError with @p what.
+        void ThrowIfLost(int32_t hr, const char *what);
+
+        /// @name Desired state, recorded after successful writes.
+        /// @{
+        void RememberDefault(uint8_t flow, const std::wstring &id);
+        void RememberDefaultMute(bool mute);
+        void RememberMute(const std::wstring &id, bool mute);
+        DesiredState Desired() const;
+        /// @}
+
+        RecoveryStats Stats() const;
+
+        /// Blocks until no recovery is in progress or @p timeout elapses. Returns true if healthy.
+        bool WaitUntilHealthy(std::chrono::milliseconds timeout);
+
+    private:
+        void Run();
+        bool Recover(std::unique_lock<std::mutex> &lock);
+        RecoveryEvent Replay(const DesiredState &desired, const ReplayActions &actions);
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;    ///< Recovery thread: a report arrived or stopping.
+        std::condition_variable m_healthy; ///< Waiters: a recovery completed.
+        RecoveryOptions m_options;
+        Probe m_probe;
+        ReplayActions m_replay;
+        std::vector<std::pair<uint64_t, Hook>> m_hooks;
+        std::vector<std::pair<uint64_t, Listener>> m_listeners;
+        uint64_t m_nextId = 1;
+
+        DesiredState m_desired;
+        std::unordered_map<EndpointKey, size_t, EndpointKeyHash> m_muteIndex; ///< Endpoint → slot in m_desired.mutes.
+
+        RecoveryStats m_stats;
+        std::chrono::steady_clock::time_point m_lostSince{};
+        bool m_pending = false; ///< A report is waiting for the thread.
+        bool m_stopping = false;
+        std::thread m_thread;
+    };
+}
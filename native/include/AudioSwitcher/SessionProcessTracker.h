@@ -0,0 +1,60 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+#include "AudioSwitcher/ProcessInfoCache.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /// AudioSessionStateExpired, kept here so the tracker stays platform independent.
+    constexpr int kSessionStateExpired = 2;
+
+    /**
+     * @brief Plain-data description of one audio session (no COM pointers).
+     */
+    struct SessionInfo
+    {
+        std::wstring deviceId;     ///< Render endpoint the session plays on.
+        std::wstring sessionId;    ///< Session instance identifier (unique per session).
+        uint32_t pid = 0;
+        std::wstring displayName;  ///< Name the application set on the session, often empty.
+        std::wstring iconPath;     ///< Icon the application set on the session, often empty.
+        int state = 0;             ///< AudioSessionState (inactive, active, expired).
+        float volume = 1.0f;       ///< Session volume, 0.0 - 1.0.
+        bool muted = false;
+        bool systemSounds = false; ///< The shared "System Sounds" session.
+        ProcessLookup process;     ///< Resolved process, or Pending while the pool works on it.
+    };
+
+    /**
+     * @brief Attaches cached process information to session listings and retires the
+     *        cache entries of sessions that ended.
+     *
+     * The previous listing of each endpoint is kept. Sessions that vanished or expired
+     * since then are retired before anything in the new listing is looked up: Windows
+     * reuses pids, and a new session of a process that took over a dead one's pid must
+     * not be answered from the dead process's entry.
+     */
+    class SessionProcessTracker
+    {
+    public:
+        explicit SessionProcessTracker(ProcessInfoCache &cache);
+
+        /// Fills in `process` for every session of one endpoint's listing.
+        void Reconcile(const std::wstring &deviceId, std::vector<SessionInfo> &sessions);
+
+    private:
+        void Retire(const ProcessKey &key);
+
+        ProcessInfoCache &m_cache;
+        std::mutex m_mutex;
+        /// Last listing per endpoint: session instance id -> owning process.
+        std::unordered_map<EndpointKey, std::map<std::wstring, ProcessKey>, EndpointKeyHash> m_previous;
+    };
+}
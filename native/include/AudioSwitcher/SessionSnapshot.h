@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AudioSwitcher/ProcessInfoCache.h"
+#include "AudioSwitcher/SessionProcessTracker.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Lists audio sessions with process names resolved through a ProcessInfoCache.
+     *
+     * Session enumeration itself is cheap; naming the owning processes is not. Process
+     * info is cached by pid + start time and filled in by background resolvers, so a
+     * listing never waits on OpenProcess. A SessionProcessTracker keeps the previous
+     * listing of each endpoint to notice sessions that expired or vanished and drop their
+     * cache entries.
+     */
+    class SessionSnapshot
+    {
+    public:
+        /// Returns the process-wide instance (resolver threads start on first use).
+        static SessionSnapshot &Instance();
+
+        /**
+         * @brief Enumerates sessions on one render endpoint, or on all active ones.
+         *
+         * Requires COM on the calling thread.
+         *
+         * @param deviceId Endpoint ID, or empty for every active render endpoint.
+         * @throws std::runtime_error If the endpoints cannot be enumerated.
+         */
+        std::vector<SessionInfo> List(const std::wstring &deviceId);
+
+        /// Blocks until queued process lookups are resolved and updates pending entries of @p sessions.
+        void WaitForProcessNames(std::vector<SessionInfo> &sessions);
+
+        /// Counters of the process cache.
+        ProcessCacheStats CacheStats() const;
+
+    private:
+        SessionSnapshot();
+
+        std::unique_ptr<ProcessInfoCache> m_cache;
+        SessionProcessTracker m_tracker;
+    };
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "AudioSwitcher/EndpointKey.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    /// Control interfaces a topology part exposes, as a bitmask.
+    namespace TopologyControl
+    {
+        constexpr uint8_t Volume = 1 << 0;    ///< IAudioVolumeLevel
+        constexpr uint8_t Mute = 1 << 1;      ///< IAudioMute
+        constexpr uint8_t PeakMeter = 1 << 2; ///< IAudioPeakMeter
+        constexpr uint8_t Loudness = 1 << 3;  ///< IAudioLoudness
+        constexpr uint8_t Tone = 1 << 4;      ///< IAudioBass / IAudioMidrange / IAudioTreble
+        constexpr uint8_t Agc = 1 << 5;       ///< IAudioAutoGainControl
+    }
+
+    /// IAudioEndpointVolume::QueryHardwareSupport bits (ENDPOINT_HARDWARE_SUPPORT_*).
+    namespace HardwareSupport
+    {
+        constexpr uint32_t Volume = 0x1;
+        constexpr uint32_t Mute = 0x2;
+        constexpr uint32_t Meter = 0x4;
+    }
+
+    enum class TopologyPartType : uint8_t
+    {
+        Connector,
+        Subunit,
+    };
+
+    /**
+     * @brief One connector or subunit on the path between an endpoint and its jack.
+     */
+    struct TopologyPart
+    {
+        uint32_t localId = 0;         ///< IPart::GetLocalId (unique within one device topology).
+        std::wstring name;
+        TopologyPartType type = TopologyPartType::Subunit;
+        std::string subType;          ///< KSNODETYPE / pin category, e.g. "volume", "speaker", or "other".
+        std::string connectorType;    ///< Connectors only: "physicalExternal", "softwareIO", ...
+        uint8_t controls = 0;         ///< TopologyControl bits.
+        std::vector<uint32_t> links;  ///< Indices (into EndpointTopology::parts) one step further from the endpoint.
+    };
+
+    /**
+     * @brief One jack as reported by IKsJackDescription on a connector.
+     */
+    struct JackDescription
+    {
+        uint32_t color = 0;          ///< 0x00RRGGBB.
+        uint8_t connectionType = 0;  ///< EPcxConnectionType.
+        uint8_t geoLocation = 0;     ///< EPcxGeoLocation.
+        uint8_t genLocation = 0;     ///< EPcxGenLocation.
+        uint8_t portConnection = 0;  ///< EPxcPortConnection.
+        bool connected = false;      ///< Jack presence at the time of the walk.
+    };
+
+    /**
+     * @brief Hardware topology of one endpoint, walked once and then served from memory.
+     */
+    struct EndpointTopology
+    {
+        std::wstring endpointId;
+        uint32_t hardwareSupport = 0;      ///< HardwareSupport bits of the endpoint volume.
+        std::wstring adapterId;            ///< Device topology the endpoint connector is wired to.
+        std::vector<TopologyPart> parts;   ///< Breadth-first from the endpoint connector; parts[0] is the start.
+        std::vector<JackDescription> jacks;
+
+        /// Union of the control bits of every part on the path.
+        uint8_t Controls() const;
+
+        /// True if volume and mute are handled by the device rather than in software.
+        bool HardwareVolumeAndMute() const
+        {
+            return (hardwareSupport & (HardwareSupport::Volume | HardwareSupport::Mute)) ==
+                   (HardwareSupport::Volume | HardwareSupport::Mute);
+        }
+    };
+
+    struct TopologyCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t builds = 0;        ///< Graph walks performed.
+        uint64_t invalidations = 0; ///< Entries dropped by change notifications.
+        size_t size = 0;
+    };
+
+    /**
+     * @brief Per-endpoint cache of walked topology graphs.
+     *
+     * Walking IDeviceTopology costs dozens of COM calls per endpoint, and the graph only
+     * changes when a device is added, removed, changes state or its properties change. The
+     * cache keeps each graph until one of those notifications invalidates it. A walk that
+     * raced an invalidation is returned to its caller but not cached.
+     */
+    class TopologyCache
+    {
+    public:
+        using Builder = std::function<std::shared_ptr<const EndpointTopology>()>;
+
+        TopologyCache() = default;
+        TopologyCache(const TopologyCache &) = delete;
+        TopologyCache &operator=(const TopologyCache &) = delete;
+
+        /// Process-wide cache (leaked).
+        static TopologyCache &Instance();
+
+        /**
+         * @brief Returns the cached graph for @p key, or runs @p build (outside the lock)
+         *        and caches its result. A null result is not cached.
+         */
+        std::shared_ptr<const EndpointTopology> Get(const EndpointKey &key, const Builder &build);
+
+        /// Returns the cached graph without building; null if absent.
+        std::shared_ptr<const EndpointTopology> Peek(const EndpointKey &key) const;
+
+        /// Drops the graph of one endpoint.
+        void Invalidate(const EndpointKey &key);
+
+        /// Drops every graph (e.g. after an audio service restart).
+        void Clear();
+
+        TopologyCacheStats Stats() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<EndpointKey, std::shared_ptr<const EndpointTopology>, EndpointKeyHash> m_entries;
+        uint64_t m_generation = 0; ///< Bumped by every invalidation.
+        TopologyCacheStats m_stats;
+    };
+}
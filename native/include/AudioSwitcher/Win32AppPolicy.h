@@ -0,0 +1,37 @@
+#pragma once
+
+#include "AudioSwitcher/AppRouting.h"
+
+#include <mutex>
+
+struct IAudioPolicyConfigFactory;
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief AppPolicy backed by the audio policy config factory (per-process default
+     *        endpoints, Windows 10 1803+) and a Toolhelp process snapshot.
+     *
+     * The factory is activated on first use and cached; Reset() drops it after an audio
+     * service restart. Calls need COM (MTA) on the calling thread.
+     */
+    class Win32AppPolicy : public AppPolicy
+    {
+    public:
+        ~Win32AppPolicy() override;
+
+        bool ListProcesses(std::vector<AppProcess> &processes) override;
+        int32_t SetEndpoint(uint32_t pid, uint8_t flow, uint8_t role, const std::wstring &deviceId) override;
+        int32_t ClearAll() override;
+
+        /// Releases the cached factory; the next call activates it again.
+        void Reset();
+
+    private:
+        /// Returns the AddRef'd factory, or nullptr with @p hr set.
+        IAudioPolicyConfigFactory *AcquireFactory(int32_t &hr);
+
+        std::mutex m_mutex;
+        IAudioPolicyConfigFactory *m_factory = nullptr;
+    };
+}
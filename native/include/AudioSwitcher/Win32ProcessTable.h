@@ -0,0 +1,19 @@
+#pragma once
+
+#include "AudioSwitcher/ProcessInfoCache.h"
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief ProcessTable backed by OpenProcess / GetProcessTimes / QueryFullProcessImageName.
+     *
+     * Only PROCESS_QUERY_LIMITED_INFORMATION is requested, which is granted for most
+     * processes even without elevation.
+     */
+    class Win32ProcessTable : public ProcessTable
+    {
+    public:
+        bool GetStartTime(uint32_t pid, uint64_t &startTime) override;
+        bool Query(uint32_t pid, ProcessInfo &info) override;
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <napi.h>
+#include <cstdint>
+#include <string>
+
+namespace AudioSwitcher
+{
+    struct JackState;
+}
+
+namespace Bindings
+{
+    /**
+     * @brief   Rethrows the in-flight native exception as a JavaScript exception.
+     *
+     * @details Supervisor errors get a machine-readable `code` so JS callers can tell a
+     *          timeout (`ETIMEDOUT`), a known-hung device (`EDEVICEHUNG`) or a stopped
+     *          audio service (`ESERVICELOST`, with `hresult`) apart from ordinary failures.
+     *          Must be called from inside a catch block.
+     *
+     * @param   env      The N-API environment.
+     * @param   fallback Message for other failures, or nullptr to surface the native
+     *                   message as a TypeError.
+     * @return  Napi::Value Always env.Null(), for convenient `return` from bindings.
+     */
+    Napi::Value ThrowNativeError(Napi::Env env, const char *fallback);
+
+    /**
+     * @brief   Reads a JS string argument as a wide string (UTF-8 → UTF-16).
+     */
+    std::wstring ToWString(const Napi::Value &value);
+
+    /**
+     * @brief   Converts a wide string to a JS string (UTF-16 → UTF-8).
+     */
+    Napi::String ToJsString(Napi::Env env, const std::wstring &value);
+
+    /// Name of an EPcxConnectionType value ("3.5mm", "optical", ...).
+    const char *JackConnectionTypeName(uint8_t value);
+
+    /// Name of an EPcxGeoLocation value ("rear", "front", ...).
+    const char *JackGeoLocationName(uint8_t value);
+
+    /**
+     * @brief   Converts jack presence to `{ present, connected, color, connectionType,
+     *          geoLocation }` (color as "#rrggbb"), or undefined if it has not been loaded.
+     */
+    Napi::Value JackToObject(Napi::Env env, const AudioSwitcher::JackState &jack);
+
+    /// Registers device snapshot, audio effects and listen routing bindings.
+    void InitSnapshotBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers software passthrough routing bindings.
+    void InitRouterBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers audio session listing bindings.
+    void InitSessionBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers endpoint change notification bindings.
+    void InitNotificationBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers native logging bindings.
+    void InitLogBindings(Napi::Env env, Napi::Object exports);
+
+    /// Configures audio service restart recovery and registers its bindings.
+    void InitRecoveryBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers default-history ("switch back") and cycling bindings.
+    void InitSwitchBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers per-application endpoint routing bindings.
+    void InitAppRoutingBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers device topology (hardware controls, jacks) bindings.
+    void InitTopologyBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers test and calibration signal playback bindings.
+    void InitSignalBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers endpoint latency measurement bindings.
+    void InitLatencyBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers aggregate (multi-endpoint, time-aligned) output bindings.
+    void InitAggregateBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers sound clip (pre-decoded, low-latency playback) bindings.
+    void InitClipBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers recording (endpoint to WAV/RF64/Wave64/FLAC file) bindings.
+    void InitRecorderBindings(Napi::Env env, Napi::Object exports);
+
+    /// Registers voice activity detection (which microphone is being spoken into) bindings.
+    void InitVoiceActivityBindings(Napi::Env env, Napi::Object exports);
+}
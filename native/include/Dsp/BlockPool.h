@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Fixed set of equally sized float blocks handed out without locks or
+     *        allocation.
+     *
+     * Streams take their scratch buffers from a pool created up front, so starting one
+     * never allocates and the number of concurrent streams has a known memory bound.
+     * Free blocks are tracked in one 64-bit mask; Acquire() and Release() are a single
+     * compare-and-swap or fetch-or and may be called from any thread.
+     */
+    class BlockPool
+    {
+    public:
+        static constexpr size_t kMaxBlocks = 64;
+
+        /**
+         * @brief Allocates every block. This is the only allocation the pool makes.
+         * @param blockCount Number of blocks (clamped to 1..kMaxBlocks).
+         * @param blockFloats Floats per block.
+         */
+        BlockPool(size_t blockCount, size_t blockFloats)
+            : m_count(blockCount == 0 ? 1 : (blockCount > kMaxBlocks ? kMaxBlocks : blockCount)),
+              m_blockFloats(blockFloats),
+              m_storage(m_count * blockFloats),
+              m_free(m_count == kMaxBlocks ? ~uint64_t(0) : (uint64_t(1) << m_count) - 1)
+        {
+        }
+
+        BlockPool(const BlockPool &) = delete;
+        BlockPool &operator=(const BlockPool &) = delete;
+
+        /// Returns a free block, or nullptr if every block is in use.
+        float *Acquire()
+        {
+            uint64_t free = m_free.load(std::memory_order_relaxed);
+            while (free != 0)
+            {
+                const uint64_t lowest = free & (~free + 1);
+                if (m_free.compare_exchange_weak(free, free & ~lowest, std::memory_order_acquire, std::memory_order_relaxed))
+                    return &m_storage[IndexOf(lowest) * m_blockFloats];
+            }
+            return nullptr;
+        }
+
+        /// Returns @p block (from Acquire()) to the pool. Null is ignored.
+        void Release(float *block)
+        {
+            if (!block)
+                return;
+            const size_t index = static_cast<size_t>(block - m_storage.data()) / m_blockFloats;
+            m_free.fetch_or(uint64_t(1) << index, std::memory_order_release);
+        }
+
+        size_t BlockFloats() const { return m_blockFloats; }
+        size_t BlockCount() const { return m_count; }
+
+        /// Blocks currently handed out (a snapshot).
+        size_t InUse() const
+        {
+            uint64_t free = m_free.load(std::memory_order_relaxed);
+            size_t available = 0;
+            for (; free != 0; free &= free - 1)
+                ++available;
+            return m_count - available;
+        }
+
+    private:
+        static size_t IndexOf(uint64_t bit)
+        {
+            size_t index = 0;
+            while (bit >>= 1)
+                ++index;
+            return index;
+        }
+
+        const size_t m_count;
+        const size_t m_blockFloats;
+        std::vector<float> m_storage;
+        std::atomic<uint64_t> m_free;
+    };
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Dsp
+{
+    /**
+     * @brief Lock-free single-producer / multi-reader broadcast ring.
+     *
+     * The producer writes every element once; any number of readers follow at their own
+     * pace with a private cursor, so adding a reader costs no extra copy on the producer
+     * side. The producer never waits for readers: a reader that falls more than a ring
+     * behind is lapped, which it detects (including an overwrite racing its copy,
+     * seqlock-style) and recovers from by skipping to the newest data.
+     *
+     * Elements are relaxed atomics so a lapped read is a detected stale value rather than
+     * a data race; on x86 and ARM these are plain loads and stores.
+     *
+     * @tparam T Element type with lock-free atomics (e.g. float samples).
+     */
+    template <typename T>
+    class BroadcastRing
+    {
+    public:
+        /**
+         * @brief Outcome of a Read().
+         */
+        struct ReadResult
+        {
+            size_t count = 0;    ///< Elements copied.
+            bool lapped = false; ///< Data was overwritten first; the cursor moved to the head.
+        };
+
+        /**
+         * @brief Allocates the ring. This is the only allocation it ever makes.
+         * @param minCapacity Minimum number of elements the ring must hold.
+         */
+        explicit BroadcastRing(size_t minCapacity)
+        {
+            size_t capacity = 1;
+            while (capacity < minCapacity)
+                capacity <<= 1;
+            m_buffer.reset(new std::atomic<T>[capacity]);
+            for (size_t i = 0; i < capacity; ++i)
+                m_buffer[i].store(T(), std::memory_order_relaxed);
+            m_mask = capacity - 1;
+        }
+
+        BroadcastRing(const BroadcastRing &) = delete;
+        BroadcastRing &operator=(const BroadcastRing &) = delete;
+
+        size_t Capacity() const { return m_mask + 1; }
+
+        /// Elements written so far (the position the next write starts at).
+        uint64_t Head() const { return m_head.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Producer: appends @p count elements, overwriting the oldest ones. At most
+         *        Capacity() elements are written; the rest of a larger write is dropped.
+         */
+        void Write(const T *data, size_t count)
+        {
+            count = std::min(count, Capacity());
+            const uint64_t head = m_head.load(std::memory_order_relaxed);
+
+            // Announce the overwrite before touching the slots, so readers can tell
+            m_reserved.store(head + count, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < count; ++i)
+                m_buffer[(head + i) & m_mask].store(data[i], std::memory_order_relaxed);
+            m_head.store(head + count, std::memory_order_release);
+        }
+
+        /**
+         * @brief Reader: copies up to @p count elements from @p cursor and advances it.
+         */
+        ReadResult Read(uint64_t &cursor, T *data, size_t count) const
+        {
+            ReadResult result;
+            const uint64_t head = m_head.load(std::memory_order_acquire);
+            if (head - cursor > Capacity())
+                return Lap(cursor, result);
+
+            count = static_cast<size_t>(std::min<uint64_t>(count, head - cursor));
+            for (size_t i = 0; i < count; ++i)
+                data[i] = m_buffer[(cursor + i) & m_mask].load(std::memory_order_relaxed);
+
+            // Valid only if no write that reached into the copied slots had started
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_reserved.load(std::memory_order_relaxed) > cursor + Capacity())
+                return Lap(cursor, result);
+
+            cursor += count;
+            result.count = count;
+            return result;
+        }
+
+    private:
+        ReadResult Lap(uint64_t &cursor, ReadResult result) const
+        {
+            cursor = m_head.load(std::memory_order_acquire);
+            result.lapped = true;
+            return result;
+        }
+
+        std::unique_ptr<std::atomic<T>[]> m_buffer;
+        size_t m_mask = 0;
+
+        alignas(64) std::atomic<uint64_t> m_head{0};
+        alignas(64) std::atomic<uint64_t> m_reserved{0}; ///< End of the write in progress.
+    };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Dsp/Fft.h"
+#include "Dsp/SimdKernels.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Maximum length sequence of @p order (2..20): 2^order - 1 samples of
+     *        ±@p amplitude with a flat spectrum and a single-sample circular autocorrelation.
+     * @throws std::invalid_argument for an unsupported order.
+     */
+    std::vector<float> MaximumLengthSequence(unsigned order, float amplitude);
+
+    /**
+     * @brief Where a reference signal was found in a capture.
+     */
+    struct DelayEstimate
+    {
+        bool found = false;       ///< The peak stands out by at least the estimator's threshold.
+        double lagFrames = 0.0;   ///< Capture frame where the reference starts (sub-sample).
+        float correlation = 0.0f; ///< Normalized correlation at the peak, 0..1.
+        float prominence = 0.0f;  ///< Peak over the RMS of the correlation across all lags.
+    };
+
+    /**
+     * @brief Finds a known reference signal in a capture with an FFT cross-correlation.
+     *
+     * The reference spectrum is computed once; each estimate costs one forward and one
+     * inverse FFT of the capture, a SIMD conjugate multiply and a SIMD peak search, then
+     * refines the peak to a fraction of a sample with a parabolic fit. Estimates reuse
+     * scratch buffers, so one estimator must not be used by two threads at once.
+     */
+    class DelayEstimator
+    {
+    public:
+        /**
+         * @param reference Signal to look for.
+         * @param length Reference length in frames.
+         * @param maxLag Largest lag searched, in frames.
+         * @param minProminence Peak-to-RMS ratio below which an estimate is not found.
+         * @param kernels Kernel table to use (defaults to ActiveKernels()).
+         */
+        DelayEstimator(const float *reference, size_t length, size_t maxLag, float minProminence = 10.0f,
+                       const SimdKernels *kernels = nullptr);
+
+        /**
+         * @brief Locates the reference in @p captured, whose first sample is lag 0.
+         *        Captures shorter than CaptureFrames() are zero-padded; longer ones are cut.
+         */
+        DelayEstimate Estimate(const float *captured, size_t frames);
+
+        /// Capture length that covers every lag up to maxLag.
+        size_t CaptureFrames() const { return m_length + m_maxLag; }
+
+        size_t FftSize() const { return m_fft.Size(); }
+
+    private:
+        size_t m_length;
+        size_t m_maxLag;
+        float m_minProminence;
+        const SimdKernels *m_kernels;
+        Fft m_fft;
+        double m_referenceEnergy = 0.0;
+        std::vector<float> m_referenceRe;
+        std::vector<float> m_referenceIm;
+        std::vector<float> m_re;
+        std::vector<float> m_im;
+    };
+
+    /**
+     * @brief Distribution of repeated delay measurements, in the unit of the input.
+     */
+    struct DelayStatistics
+    {
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        double median = 0.0;
+        double p95 = 0.0;
+        double stdDev = 0.0;
+    };
+
+    /// Summarizes @p values (all zero when empty). Percentiles interpolate linearly.
+    DelayStatistics SummarizeDelays(std::vector<double> values);
+}
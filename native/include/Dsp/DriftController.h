@@ -0,0 +1,60 @@
+#pragma once
+
+namespace Dsp
+{
+    /**
+     * @brief Keeps a FIFO between two free-running clocks at a target fill level.
+     *
+     * A PI controller on the smoothed fill error nudges the resampling ratio so the
+     * consumer reads slightly faster when the FIFO grows and slower when it drains.
+     * The integral term converges to the relative clock drift, so after settling the
+     * FIFO sits at the target (i.e. the requested latency) with no steady-state error.
+     */
+    class DriftController
+    {
+    public:
+        /**
+         * @param nominalRatio Ratio at zero drift (producer rate / consumer rate).
+         * @param producerRate Producer sample rate, used to express fill in seconds.
+         * @param targetFill Desired FIFO fill, in producer frames.
+         * @param maxCorrectionPpm Clamp for the correction, in parts per million.
+         */
+        DriftController(double nominalRatio, double producerRate, double targetFill,
+                        double maxCorrectionPpm = 2000.0);
+
+        /**
+         * @brief Feeds one fill measurement (call once per consumer block).
+         * @param fillFrames Current FIFO fill, in producer frames.
+         * @param elapsedSeconds Time since the previous update.
+         * @return Ratio to apply to the resampler for the next block.
+         */
+        double Update(double fillFrames, double elapsedSeconds);
+
+        /// Current correction in ppm (positive = consuming faster than nominal).
+        double CorrectionPpm() const { return m_correction * 1e6; }
+
+        /// Smoothed fill used by the controller, in producer frames.
+        double SmoothedFill() const { return m_smoothedFill; }
+
+        /// Target fill in producer frames.
+        double TargetFill() const { return m_targetFill; }
+
+        /// Resets integrator and smoothing (e.g. after an underrun re-prime).
+        void Reset();
+
+        /**
+         * @brief Restarts the smoothing at the target but keeps the drift estimate, for
+         *        consumers that jump straight back to the target (the clocks did not change).
+         */
+        void ResetFill();
+
+    private:
+        double m_nominalRatio;
+        double m_producerRate;
+        double m_targetFill;
+        double m_maxCorrection;
+        double m_smoothedFill;
+        double m_integral = 0.0;
+        double m_correction = 0.0;
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Dsp/SimdKernels.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Complex radix-2 FFT of a fixed power-of-two size, on split (separate real
+     *        and imaginary) float arrays.
+     *
+     * Twiddles and the bit-reversal permutation are computed once; stages with at least
+     * eight butterflies per group run through the SIMD butterfly kernel. Transforms are
+     * const and allocation-free, so one instance can be shared between threads.
+     */
+    class Fft
+    {
+    public:
+        /**
+         * @param size Transform length: a power of two, at least 2.
+         * @param kernels Kernel table to use (defaults to ActiveKernels()).
+         * @throws std::invalid_argument if @p size is not a power of two.
+         */
+        explicit Fft(size_t size, const SimdKernels *kernels = nullptr);
+
+        /// In-place forward transform (e^{-i...}, unscaled).
+        void Forward(float *re, float *im) const;
+
+        /// In-place inverse transform, scaled by 1/size so Inverse(Forward(x)) == x.
+        void Inverse(float *re, float *im) const;
+
+        size_t Size() const { return m_size; }
+
+        /// Smallest power of two >= @p count (and >= 2).
+        static size_t SizeFor(size_t count);
+
+    private:
+        void Transform(float *re, float *im) const;
+
+        size_t m_size;
+        const SimdKernels *m_kernels;
+        std::vector<std::pair<uint32_t, uint32_t>> m_swaps; ///< Bit-reversal swaps.
+
+        // Twiddles e^{-iπk/half} of the stage with groups of 2 * half, at offset half - 1
+        std::vector<float> m_twiddleRe;
+        std::vector<float> m_twiddleIm;
+    };
+}
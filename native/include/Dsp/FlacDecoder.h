@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Dsp/WavDecoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief A decoded FLAC stream as the integers it was encoded from.
+     */
+    struct FlacPcm
+    {
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        unsigned bitsPerSample = 0;
+        std::vector<int32_t> samples; ///< Interleaved.
+        bool truncated = false;       ///< The stream ended inside a frame (as a crashed writer leaves it).
+        bool md5Checked = false;      ///< STREAMINFO carried an MD5 and the samples matched it.
+
+        size_t Frames() const { return channels ? samples.size() / channels : 0; }
+    };
+
+    /// True if @p data starts like a FLAC stream.
+    bool IsFlac(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Decodes a native FLAC stream held in memory, bit-exactly.
+     *
+     * Every frame's CRC is checked, and the samples are checked against the STREAMINFO
+     * MD5 when it is set. A stream that stops inside a frame, or runs into zeros (as a
+     * recording cut short leaves it), ends after its last complete frame. Samples of up
+     * to 24 bits are supported.
+     *
+     * @throws std::runtime_error if the stream is malformed, a CRC or the MD5 does not
+     *         match, or it uses an unsupported feature.
+     */
+    FlacPcm DecodeFlacPcm(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Decodes a FLAC stream to float samples, full scale = ±1.
+     * @throws std::runtime_error as DecodeFlacPcm().
+     */
+    DecodedAudio DecodeFlac(const uint8_t *data, size_t size);
+}
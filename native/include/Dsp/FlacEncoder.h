@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Utility/Md5.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Format of a FLAC stream.
+     */
+    struct FlacFormat
+    {
+        uint32_t sampleRate = 48000;
+        unsigned channels = 2;      ///< 1 to 8.
+        unsigned bitsPerSample = 24; ///< 8, 16 or 24.
+    };
+
+    /**
+     * @brief Encoder settings.
+     */
+    struct FlacEncoderOptions
+    {
+        unsigned blockSize = 4096;  ///< Frames per FLAC frame (16 to 65535).
+        unsigned maxLpcOrder = 8;   ///< Highest LPC order tried (0 = fixed predictors only, at most 32).
+        unsigned threads = 0;       ///< Threads encoding frames, the caller included; 0 = one per core.
+    };
+
+    /**
+     * @brief What STREAMINFO records about a finished stream; all zero while unknown.
+     */
+    struct FlacTotals
+    {
+        uint64_t frames = 0;       ///< Inter-channel samples.
+        uint32_t minFrameBytes = 0;
+        uint32_t maxFrameBytes = 0;
+        uint8_t md5[16] = {};      ///< MD5 of the samples as little-endian signed integers.
+    };
+
+    /// Size of the header BuildFlacHeader() writes ("fLaC" and STREAMINFO).
+    constexpr size_t kFlacHeaderBytes = 42;
+
+    /**
+     * @brief Builds the stream header: the "fLaC" marker and a STREAMINFO block.
+     *
+     * Its size never changes, so a header written with unknown (zero) totals when a
+     * stream starts can be rewritten in place once it ends.
+     */
+    std::vector<uint8_t> BuildFlacHeader(const FlacFormat &format, unsigned blockSize, const FlacTotals &totals);
+
+    /**
+     * @brief Encodes one FLAC frame at a time; single threaded, reusable.
+     *
+     * Each channel is coded as the smallest of a constant, a fixed polynomial predictor
+     * (orders 0 to 4), an LPC predictor (Levinson-Durbin on a Tukey-windowed
+     * autocorrelation, order picked from the prediction error) and verbatim samples,
+     * with partitioned Rice coding of the residual and wasted low bits shifted out.
+     * Stereo frames pick left/right, left/side, side/right or mid/side from a quick
+     * estimate of each channel's cost.
+     */
+    class FlacFrameEncoder
+    {
+    public:
+        /// @throws std::runtime_error if @p format or @p options are out of range.
+        FlacFrameEncoder(const FlacFormat &format, const FlacEncoderOptions &options);
+        ~FlacFrameEncoder();
+
+        /**
+         * @brief Appends the frame holding @p frames interleaved frames (at most the block
+         *        size; fewer only for the last frame of a stream) to @p out.
+         * @param frameNumber Index of this frame in the stream (its first sample / block size).
+         */
+        void Encode(const int32_t *samples, size_t frames, uint64_t frameNumber, std::vector<uint8_t> &out);
+
+    private:
+        struct Subframe;
+        struct BitWriter;
+        void AnalyzeChannel(const int32_t *signal, size_t count, unsigned bits, Subframe &subframe);
+        bool TryLpc(Subframe &subframe, size_t count, uint64_t &cost);
+        void WriteSubframe(BitWriter &writer, const Subframe &subframe, size_t count) const;
+
+        FlacFormat m_format;
+        FlacEncoderOptions m_options;
+        std::vector<int32_t> m_channels[8]; ///< Deinterleaved input (stereo adds mid and side at 2 and 3).
+        std::vector<double> m_windowed;
+        std::vector<double> m_window;       ///< Tukey window for m_windowSize samples.
+        size_t m_windowSize = 0;
+        std::vector<uint64_t> m_partitionSums;
+        std::unique_ptr<Subframe[]> m_subframes;
+    };
+
+    /**
+     * @brief Streaming FLAC encoder that spreads the frames of each call over a pool of
+     *        threads.
+     *
+     * Encode() splits its input into block-size frames, which the calling thread and the
+     * pool's workers encode in parallel while the caller also updates the stream MD5, then
+     * joins them in order. The output is byte-identical whatever the thread count.
+     */
+    class FlacEncoder
+    {
+    public:
+        /// @throws std::runtime_error if @p format or @p options are out of range.
+        FlacEncoder(const FlacFormat &format, const FlacEncoderOptions &options = {});
+        ~FlacEncoder();
+
+        FlacEncoder(const FlacEncoder &) = delete;
+        FlacEncoder &operator=(const FlacEncoder &) = delete;
+
+        /// The header to write before the first frame (totals unknown).
+        std::vector<uint8_t> Header() const;
+
+        /// The header to rewrite over it once the stream is finished.
+        std::vector<uint8_t> FinalHeader() const;
+
+        /**
+         * @brief Appends the frames for @p frames interleaved frames to @p out.
+         *
+         * Every call but the last must pass a multiple of the block size (FLAC allows only
+         * the final frame to be short).
+         *
+         * @throws std::runtime_error if called again after a partial frame.
+         */
+        void Encode(const int32_t *samples, size_t frames, std::vector<uint8_t> &out);
+
+        const FlacFormat &Format() const { return m_format; }
+        unsigned BlockSize() const { return m_options.blockSize; }
+        unsigned Threads() const { return m_options.threads; }
+        FlacTotals Totals() const;
+
+        /// Time spent encoding frames, summed over every thread.
+        double EncodeSeconds() const { return m_encodeNs.load(std::memory_order_relaxed) / 1e9; }
+
+    private:
+        void Worker(unsigned index);
+        void RunJobs(unsigned worker);
+        void UpdateMd5(const int32_t *samples, size_t count);
+
+        FlacFormat m_format;
+        FlacEncoderOptions m_options;
+        Utility::Md5 m_md5;
+        std::vector<uint8_t> m_md5Bytes;
+        uint64_t m_frames = 0;
+        uint32_t m_minFrameBytes = 0;
+        uint32_t m_maxFrameBytes = 0;
+        bool m_partial = false;
+        std::atomic<uint64_t> m_encodeNs{0};
+
+        // The current call's jobs, read by the workers
+        std::vector<std::unique_ptr<FlacFrameEncoder>> m_encoders; ///< One per thread, [0] = caller.
+        std::vector<std::vector<uint8_t>> m_outputs;                ///< One per frame of the call.
+        const int32_t *m_jobSamples = nullptr;
+        size_t m_jobFrames = 0;
+        uint64_t m_jobFirstFrame = 0;
+        std::atomic<size_t> m_nextJob{0};
+
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+        uint64_t m_generation = 0;
+        unsigned m_busy = 0;
+        bool m_stopping = false;
+        std::vector<std::thread> m_workers;
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Dsp/SimdKernels.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Streaming windowed-sinc sample-rate converter for interleaved float audio.
+     *
+     * A Kaiser-windowed sinc low-pass is tabulated at a fixed number of sub-sample phases;
+     * each output frame linearly interpolates the two nearest phases, so any ratio
+     * (including irrational ones and ratios that change every block for drift
+     * compensation) is supported with the same table. The cutoff follows the lower of the
+     * two rates so downsampling does not alias.
+     *
+     * The inner loops use the widest SIMD kernels the CPU supports (AVX2/FMA, SSE, or
+     * scalar). Usage per block is the same as for any streaming converter here: ask
+     * InputFramesWanted(n), Push() that many input frames, then Pull() up to n output
+     * frames. All memory is allocated by the constructor.
+     */
+    class PolyphaseResampler
+    {
+    public:
+        /**
+         * @param channels Interleaved channel count.
+         * @param inRate Input sample rate in Hz.
+         * @param outRate Output sample rate in Hz.
+         * @param maxInputFrames Largest number of input frames pushed before a Pull(), not
+         *        counting the filter lookahead (up to Taps()) requested after a Reset().
+         * @param kernels Kernel table to use (defaults to ActiveKernels()).
+         */
+        PolyphaseResampler(unsigned channels, double inRate, double outRate, size_t maxInputFrames,
+                           const SimdKernels *kernels = nullptr);
+
+        /**
+         * @brief Sets input frames consumed per output frame. Starts at inRate / outRate;
+         *        small adjustments (drift correction) keep the original cutoff.
+         */
+        void SetRatio(double ratio) { m_ratio = ratio; }
+
+        /// Current ratio.
+        double Ratio() const { return m_ratio; }
+
+        /// Number of input frames that must still be pushed to produce @p outFrames frames.
+        size_t InputFramesWanted(size_t outFrames) const;
+
+        /**
+         * @brief Appends interleaved input frames.
+         * @return Frames accepted (less than @p frames only if the buffer is full).
+         */
+        size_t Push(const float *input, size_t frames);
+
+        /**
+         * @brief Produces up to @p outFrames interleaved frames from buffered input.
+         * @return Frames produced; fewer than requested means the input ran out.
+         */
+        size_t Pull(float *output, size_t outFrames);
+
+        /// Input frames buffered (including the filter history).
+        size_t BufferedFrames() const { return m_frames; }
+
+        /**
+         * @brief Buffered input frames ahead of the input position of the next output frame
+         *        (fractional). The filter is centred, so pushed frames minus this is the
+         *        exact input position being played.
+         */
+        double PendingFrames() const { return static_cast<double>(m_frames) - static_cast<double>(m_index) - m_fraction; }
+
+        /// Filter length in input frames; the converter delays the signal by half of it.
+        size_t Taps() const { return m_taps; }
+
+        /// Name of the SIMD kernel set in use.
+        const char *KernelName() const { return m_kernels->name; }
+
+        /// Clears history and buffered input.
+        void Reset();
+
+    private:
+        void BuildTable(double cutoff);
+
+        unsigned m_channels;
+        size_t m_taps;                ///< Coefficients per phase (multiple of 8).
+        size_t m_capacityFrames;
+        const SimdKernels *m_kernels;
+
+        std::vector<float> m_table;   ///< (kPhases + 1) rows of m_taps coefficients.
+        std::vector<float> m_coefs;   ///< Interpolated coefficients for the current frame.
+        std::vector<float> m_history; ///< Planar: one run of m_capacityFrames per channel.
+        size_t m_frames = 0;
+        size_t m_index = 0;           ///< Whole part of the read position within m_history.
+        double m_fraction = 0.0;      ///< Sub-frame part of the read position, in [0, 1).
+        double m_ratio = 1.0;
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Dsp/SimdKernels.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Dsp
+{
+    enum class SignalType : uint8_t
+    {
+        Sine,
+        Sweep,      ///< Exponential (log) sweep, restarting after each period.
+        WhiteNoise,
+        PinkNoise,  ///< -3 dB per octave.
+        Clicks,     ///< One-sample impulses at a fixed interval.
+    };
+
+    /**
+     * @brief What to generate. Frequencies at or above Nyquist are clamped below it.
+     */
+    struct SignalSpec
+    {
+        SignalType type = SignalType::Sine;
+        double frequency = 1000.0;     ///< Sine frequency, or sweep start, in Hz.
+        double endFrequency = 20000.0; ///< Sweep end in Hz.
+        double sweepSeconds = 5.0;     ///< Length of one sweep.
+        double clickSeconds = 0.5;     ///< Interval between clicks.
+        double levelDb = -20.0;        ///< dBFS: peak for tones and clicks, RMS for noise.
+        uint32_t seed = 1;             ///< Noise seed (0 is replaced by 1).
+    };
+
+    /**
+     * @brief Calibration and test signal generator producing mono float samples.
+     *
+     * Tones keep their phase in double precision and evaluate the sine with the SIMD
+     * kernel of the running CPU, so a sine stays clean (below -120 dB distortion) for
+     * hours. Noise uses a xorshift generator; pink noise shapes it with Kellett's
+     * refined filter. The generator never allocates, so it can run on a render thread.
+     */
+    class SignalGenerator
+    {
+    public:
+        /**
+         * @param spec What to generate.
+         * @param sampleRate Output rate in Hz.
+         * @param kernels Kernel table to use (defaults to ActiveKernels()).
+         */
+        SignalGenerator(const SignalSpec &spec, double sampleRate, const SimdKernels *kernels = nullptr);
+
+        /// Writes the next @p frames samples.
+        void Render(float *out, size_t frames);
+
+        /// Restarts the signal from its first sample (same noise sequence).
+        void Reset();
+
+        const SignalSpec &Spec() const { return m_spec; }
+        const char *KernelName() const { return m_kernels->name; }
+
+    private:
+        static constexpr size_t kBlock = 256; ///< Frames per kernel call.
+
+        void RenderTone(float *out, size_t frames);
+        void RenderNoise(float *out, size_t frames);
+        void RenderClicks(float *out, size_t frames);
+        uint32_t NextRandom();
+
+        SignalSpec m_spec;
+        double m_sampleRate;
+        const SimdKernels *m_kernels;
+        float m_gain;
+
+        // Tones: phase in cycles within [-0.5, 0.5), advanced by the per-sample increment.
+        // Sweeps multiply the increment by m_sweepGrowth every sample.
+        double m_phase = 0.0;
+        double m_increment = 0.0;
+        double m_startIncrement = 0.0;
+        double m_sweepGrowth = 1.0;
+        uint64_t m_period = 1;   ///< Frames per sweep or click interval.
+        uint64_t m_position = 0; ///< Frames into the current period.
+
+        uint32_t m_random = 1;
+        float m_pink[7] = {};    ///< Kellett filter state.
+
+        alignas(32) float m_cycles[kBlock];
+    };
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Dsp
+{
+    /**
+     * @brief Instruction sets a kernel table can be built for.
+     */
+    enum class SimdLevel
+    {
+        Scalar,
+        Sse,
+        Avx2,
+    };
+
+    /**
+     * @brief Inner loops shared by the DSP code, in one implementation per instruction set.
+     *
+     * Lengths passed to these functions must be multiples of 8 (callers pad coefficient
+     * tables with zeros); pointers need no particular alignment.
+     */
+    struct SimdKernels
+    {
+        SimdLevel level;
+        const char *name;
+
+        /// Returns sum(a[i] * b[i]).
+        float (*dot)(const float *a, const float *b, size_t count);
+
+        /// out[i] = a[i] + t * (b[i] - a[i]).
+        void (*lerp)(float *out, const float *a, const float *b, float t, size_t count);
+
+        /**
+         * @brief out[i] = gain * sin(2π * cycles[i]), for phases given in cycles within
+         *        [-0.5, 0.5]. Polynomial, accurate to about 1e-7 (below float resolution).
+         */
+        void (*sine)(float *out, const float *cycles, float gain, size_t count);
+
+        /**
+         * @brief Radix-2 FFT butterflies on split complex data: v = x1 * w, then
+         *        x1 = x0 - v and x0 = x0 + v.
+         */
+        void (*butterfly)(float *re0, float *im0, float *re1, float *im1, const float *wRe, const float *wIm,
+                          size_t count);
+
+        /// out[i] = a[i] * conj(b[i]) on split complex data; out may alias a.
+        void (*multiplyConjugate)(float *outRe, float *outIm, const float *aRe, const float *aIm, const float *bRe,
+                                  const float *bIm, size_t count);
+
+        /// Index of the largest |x[i]| (the first one on ties).
+        size_t (*peak)(const float *x, size_t count);
+
+        /// out[i] += gain * in[i] (mixing a voice into a bus).
+        void (*mixAdd)(float *out, const float *in, float gain, size_t count);
+    };
+
+    /// Best kernel table supported by the running CPU (detected once).
+    const SimdKernels &ActiveKernels();
+
+    /**
+     * @brief Kernel table for a specific level, or nullptr if the CPU (or the build
+     *        target) does not support it. Used by tests and benchmarks to compare levels.
+     */
+    const SimdKernels *KernelsFor(SimdLevel level);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Lock-free single-producer / single-consumer ring buffer.
+     *
+     * One thread may call Write(), one other thread may call Read()/Discard(); neither
+     * ever blocks or allocates. Capacity is rounded up to a power of two. Indices grow
+     * monotonically and are masked on access, so full and empty are distinguishable
+     * without a spare slot.
+     *
+     * @tparam T Trivially copyable element type (e.g. float samples).
+     */
+    template <typename T>
+    class SpscRing
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SpscRing requires trivially copyable elements");
+
+    public:
+        /**
+         * @brief Allocates the ring. This is the only allocation it ever makes.
+         * @param minCapacity Minimum number of elements the ring must hold.
+         */
+        explicit SpscRing(size_t minCapacity)
+        {
+            size_t capacity = 1;
+            while (capacity < minCapacity)
+                capacity <<= 1;
+            m_buffer.resize(capacity);
+            m_mask = capacity - 1;
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        /// Total number of elements the ring can hold.
+        size_t Capacity() const { return m_mask + 1; }
+
+        /// Elements currently readable (exact for the consumer, a lower bound for others).
+        size_t AvailableToRead() const
+        {
+            return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+        }
+
+        /// Free space (exact for the producer, a lower bound for others).
+        size_t AvailableToWrite() const { return Capacity() - AvailableToRead(); }
+
+        /**
+         * @brief Producer: copies up to @p count elements into the ring.
+         * @return Number of elements written (less than @p count if the ring is full).
+         */
+        size_t Write(const T *data, size_t count)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            const size_t tail = m_tail.load(std::memory_order_acquire);
+            count = std::min(count, Capacity() - (head - tail));
+            if (count == 0)
+                return 0;
+
+            const size_t start = head & m_mask;
+            const size_t first = std::min(count, Capacity() - start);
+            std::memcpy(&m_buffer[start], data, first * sizeof(T));
+            std::memcpy(&m_buffer[0], data + first, (count - first) * sizeof(T));
+
+            m_head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * @brief Consumer: copies up to @p count elements out of the ring.
+         * @return Number of elements read (less than @p count if the ring ran dry).
+         */
+        size_t Read(T *data, size_t count)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t head = m_head.load(std::memory_order_acquire);
+            count = std::min(count, head - tail);
+            if (count == 0)
+                return 0;
+
+            const size_t start = tail & m_mask;
+            const size_t first = std::min(count, Capacity() - start);
+            std::memcpy(data, &m_buffer[start], first * sizeof(T));
+            std::memcpy(data + first, &m_buffer[0], (count - first) * sizeof(T));
+
+            m_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * @brief Consumer: drops up to @p count elements without copying them.
+         * @return Number of elements dropped.
+         */
+        size_t Discard(size_t count)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t head = m_head.load(std::memory_order_acquire);
+            count = std::min(count, head - tail);
+            m_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        std::vector<T> m_buffer;
+        size_t m_mask = 0;
+
+        // Producer and consumer indices live on separate cache lines to avoid false sharing
+        alignas(64) std::atomic<size_t> m_head{0};
+        alignas(64) std::atomic<size_t> m_tail{0};
+    };
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Dsp/Fft.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Tuning of a VoiceActivityDetector.
+     */
+    struct VoiceActivityOptions
+    {
+        double snrDb = 6.0;          ///< Speech-band level over the noise floor that counts as loud enough (50% point).
+        double minLevelDb = -65.0;   ///< Speech-band level (dBFS) below which nothing counts as speech.
+        double flatness = 0.3;       ///< Spectral flatness 50% point (0 = tonal/harmonic, about 0.5 = white or pink noise).
+        double zeroCrossings = 0.3;  ///< Zero crossings per analysis sample, 50% point.
+        double attackMs = 30.0;      ///< Time constant the probability rises with, so a lone click is not speech.
+        double hangoverMs = 300.0;   ///< Probability held after the last speech-like frame.
+        double releaseMs = 150.0;    ///< Decay time constant once the hangover has run out.
+        double floorRiseDbPerSecond = 3.0; ///< How fast the noise floor climbs under speech (10x under noise; it falls within a few frames).
+    };
+
+    /**
+     * @brief Features of the most recent analysis frame.
+     */
+    struct VoiceActivityFeatures
+    {
+        float levelDb = -120.0f;    ///< Speech-band (300 Hz - 4 kHz) level, dBFS.
+        float noiseDb = -120.0f;    ///< Tracked noise floor of the same band, dBFS.
+        float flatness = 0.0f;      ///< Geometric over arithmetic mean of the band's power spectrum, tilted +3 dB/octave.
+        float zeroCrossings = 0.0f; ///< Sign changes per analysis sample.
+        float frameProbability = 0.0f; ///< Speech likelihood of this frame alone, before hangover.
+    };
+
+    /**
+     * @brief Frame-based voice activity detector for one capture stream.
+     *
+     * Input of any rate and channel count is downmixed and decimated (by averaging) to
+     * about 16 kHz, then cut into 256-sample frames (16 ms at 16 kHz). Each frame yields
+     * three features: the speech-band level over a tracked noise floor (energy), the
+     * spectral flatness of that band (speech is harmonic, noise is flat) and the
+     * zero-crossing rate (voiced speech crosses rarely, hiss often). The energy gate times
+     * a logistic score of the two spectral features is the frame's probability; the
+     * reported probability follows it up within a few frames, holds it for the hangover,
+     * then decays, so pauses between words do not read as silence.
+     *
+     * Allocation-free after construction. Not thread-safe: one thread feeds a detector.
+     */
+    class VoiceActivityDetector
+    {
+    public:
+        /// Analysis frame length in (decimated) samples.
+        static constexpr size_t kFrame = 256;
+
+        /**
+         * @throws std::invalid_argument if @p sampleRate or @p channels is 0.
+         */
+        VoiceActivityDetector(uint32_t sampleRate, unsigned channels, const VoiceActivityOptions &options = {});
+
+        /**
+         * @brief Feeds @p frames interleaved frames.
+         * @return Number of analysis frames completed (the probability changed that often).
+         */
+        size_t Process(const float *input, size_t frames);
+
+        /// Forgets the signal (noise floor included) and reads as silence.
+        void Reset();
+
+        /// Smoothed speech probability, 0..1.
+        float Probability() const { return m_probability; }
+
+        const VoiceActivityFeatures &Features() const { return m_features; }
+
+        /// Analysis frames completed since construction or Reset().
+        uint64_t AnalyzedFrames() const { return m_analyzed; }
+
+        /// Rate of the decimated signal the features are computed on.
+        double AnalysisRate() const { return m_analysisRate; }
+
+    private:
+        void Analyze();
+
+        unsigned m_channels;
+        unsigned m_decimation;
+        double m_analysisRate;
+        VoiceActivityOptions m_options;
+        Fft m_fft;
+        std::vector<float> m_window;
+        std::vector<float> m_frame;
+        std::vector<float> m_re;
+        std::vector<float> m_im;
+        size_t m_firstBin = 0;
+        size_t m_endBin = 0;
+        size_t m_fill = 0;
+
+        // Decimator and DC blocker state
+        float m_sum = 0.0f;
+        unsigned m_summed = 0;
+        float m_dcIn = 0.0f;
+        float m_dcOut = 0.0f;
+
+        // Per-frame constants derived from the options
+        float m_floorRise = 0.0f;
+        float m_attack = 0.0f;
+        float m_release = 0.0f;
+        float m_levelScale = 0.0f;
+        unsigned m_hangoverFrames = 0;
+
+        VoiceActivityFeatures m_features;
+        bool m_floorValid = false;
+        unsigned m_hangover = 0;
+        float m_probability = 0.0f;
+        uint64_t m_analyzed = 0;
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief Sample encodings accepted for raw PCM (and found in WAV files).
+     */
+    enum class SampleEncoding : uint8_t
+    {
+        Unsigned8, ///< 8-bit unsigned, 128 = silence (WAV convention).
+        Int16,
+        Int24,     ///< Packed, 3 bytes per sample.
+        Int32,
+        Float32,
+        Float64,
+    };
+
+    /**
+     * @brief Layout of raw (headerless, little-endian, interleaved) PCM.
+     */
+    struct PcmFormat
+    {
+        uint32_t sampleRate = 48000;
+        unsigned channels = 2;
+        SampleEncoding encoding = SampleEncoding::Int16;
+    };
+
+    /**
+     * @brief Decoded audio: interleaved float samples, full scale = ±1.
+     */
+    struct DecodedAudio
+    {
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        std::vector<float> samples;
+
+        size_t Frames() const { return channels ? samples.size() / channels : 0; }
+    };
+
+    /// Bytes per sample of @p encoding.
+    size_t BytesPerSample(SampleEncoding encoding);
+
+    /// True if @p data starts like a RIFF/WAVE, RF64 or Wave64 file.
+    bool IsWav(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Decodes a RIFF/WAVE, RF64 or Wave64 file held in memory.
+     *
+     * Integer PCM of 8, 16, 24 and 32 bits, IEEE float of 32 and 64 bits, and their
+     * WAVE_FORMAT_EXTENSIBLE forms are supported. A data chunk whose size is 0 or runs
+     * past the end (as left by a writer that never finalized its header) is read to the
+     * end of the buffer; a trailing partial frame is dropped.
+     *
+     * @throws std::runtime_error if the file is malformed or uses another encoding.
+     */
+    DecodedAudio DecodeWav(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Decodes raw PCM in @p format. A trailing partial frame is dropped.
+     * @throws std::runtime_error if @p format has no channels or no sample rate.
+     */
+    DecodedAudio DecodePcm(const uint8_t *data, size_t size, const PcmFormat &format);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Dsp/WavDecoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    /**
+     * @brief File formats a recording can be written as.
+     */
+    enum class WavContainer : uint8_t
+    {
+        Wav,  ///< RIFF/WAVE, rewritten as RF64 once the data outgrows 4 GB.
+        Rf64, ///< RF64 (EBU 3306) from the start.
+        W64,  ///< Sony Wave64: GUID chunk ids, 64-bit sizes.
+        Flac, ///< FLAC (16 or 24-bit, lossless), written through FlacEncoder rather than BuildWavHeader().
+    };
+
+    /**
+     * @brief Format of a WAV file being written.
+     */
+    struct WavLayout
+    {
+        uint32_t sampleRate = 48000;
+        unsigned channels = 2;
+        SampleEncoding encoding = SampleEncoding::Float32;
+        WavContainer container = WavContainer::Wav;
+    };
+
+    /// Header size used by recordings: one page, so sample data starts page-aligned.
+    constexpr size_t kWavHeaderBytes = 4096;
+
+    /**
+     * @brief Builds a @p headerBytes header for @p dataBytes of sample data that follows it.
+     *
+     * The layout never moves as the size grows: RIFF reserves a 28-byte JUNK chunk where
+     * RF64 keeps its ds64 sizes, so a file is promoted to RF64 by rewriting the header
+     * alone. The gap up to the data chunk is filled with a JUNK chunk (W64 uses the same
+     * layout with GUID chunk ids and 64-bit sizes). Formats other than
+     * 8/16-bit PCM of one or two channels use WAVE_FORMAT_EXTENSIBLE.
+     *
+     * @throws std::runtime_error if @p headerBytes is too small for the header or not a
+     *         multiple of 8, or the container is Flac.
+     */
+    std::vector<uint8_t> BuildWavHeader(const WavLayout &layout, uint64_t dataBytes,
+                                        size_t headerBytes = kWavHeaderBytes);
+
+    /// True if BuildWavHeader() writes an RF64 header for these arguments.
+    bool UsesRf64(const WavLayout &layout, uint64_t dataBytes, size_t headerBytes = kWavHeaderBytes);
+
+    /**
+     * @brief Converts @p count float samples to little-endian @p encoding, clamped to
+     *        full scale and rounded. Writes BytesPerSample(encoding) * count bytes.
+     */
+    void EncodeSamples(const float *src, uint8_t *dst, size_t count, SampleEncoding encoding);
+
+    /**
+     * @brief Converts @p count float samples to signed integers of @p bits (8 to 32),
+     *        clamped and rounded exactly as EncodeSamples() does for that width.
+     */
+    void QuantizeSamples(const float *src, int32_t *dst, size_t count, unsigned bits);
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Dsp/BroadcastRing.h"
+#include "Dsp/DriftController.h"
+#include "Dsp/PolyphaseResampler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief The shared side of an aggregate output: one source stream, written once and
+     *        read by every endpoint's tap.
+     *
+     * Besides the samples it publishes a timeline (frames written and the time the last
+     * packet ended), from which taps extrapolate which source frame is current at any
+     * moment on the clock shared by all threads.
+     */
+    class AggregateSource
+    {
+    public:
+        /**
+         * @param channels Interleaved channel count of the source.
+         * @param sampleRate Source rate in Hz.
+         * @param historyMs Audio kept for the taps; must exceed the largest target latency.
+         */
+        AggregateSource(unsigned channels, double sampleRate, double historyMs);
+
+        /**
+         * @brief Producer: appends @p frames interleaved frames.
+         * @param timeSeconds Capture time of the end of the packet.
+         */
+        void Push(const float *input, size_t frames, double timeSeconds);
+
+        /**
+         * @brief Source position (in frames, fractional) at @p timeSeconds, extrapolated
+         *        from the last packet at the nominal rate. Negative before the first packet.
+         */
+        double FramesAt(double timeSeconds) const;
+
+        /// Frames written so far.
+        uint64_t WrittenFrames() const { return m_ring.Head() / m_channels; }
+
+        /// Frames the ring holds.
+        size_t HistoryFrames() const { return m_ring.Capacity() / m_channels; }
+
+        const Dsp::BroadcastRing<float> &Ring() const { return m_ring; }
+        unsigned Channels() const { return m_channels; }
+        double SampleRate() const { return m_sampleRate; }
+
+    private:
+        unsigned m_channels;
+        double m_sampleRate;
+        Dsp::BroadcastRing<float> m_ring;
+
+        // Timeline, published as a pair under a sequence counter (odd while writing)
+        std::atomic<uint32_t> m_sequence{0};
+        std::atomic<uint64_t> m_stampFrames{0};
+        std::atomic<double> m_stampTime{0.0};
+    };
+
+    /**
+     * @brief Counters published by a tap (readable from any thread).
+     */
+    struct TapStats
+    {
+        bool aligned = false;        ///< Playing the source (not waiting to (re)align).
+        uint64_t underruns = 0;      ///< Blocks that ran out of source audio.
+        uint64_t laps = 0;           ///< Times the tap fell a whole ring behind and skipped ahead.
+        uint64_t renderedFrames = 0; ///< Frames produced (including silence).
+        double delayMs = 0.0;        ///< Endpoint delay being compensated.
+        double targetMs = 0.0;       ///< Source-to-ear latency shared by all taps.
+        double errorMs = 0.0;        ///< Smoothed alignment error (positive = late).
+        double correctionPpm = 0.0;  ///< Current drift correction.
+    };
+
+    /**
+     * @brief One endpoint of an aggregate output: reads the shared source and resamples
+     *        it so the endpoint plays each source frame exactly targetLatency after it
+     *        was captured.
+     *
+     * Every call states when its first frame will actually be heard: the caller's time
+     * plus the audio already queued on the device, plus the endpoint delay set here
+     * (converter, Bluetooth link, ...). The tap plays the source frame that is
+     * targetLatency older than that moment. Taps on different endpoints therefore agree
+     * whatever their buffers, delays and clocks. On start (and after an underrun, a lap,
+     * or a change of delay or target) the tap seeks straight to the right frame; from
+     * then on a DriftController trims the resampling ratio against the endpoint's clock
+     * drift.
+     *
+     * Only the endpoint's render thread calls Pull(); setters and Stats() may be called
+     * from any thread.
+     */
+    class AggregateTap
+    {
+    public:
+        /**
+         * @param source Shared source; must outlive the tap.
+         * @param channels Endpoint channel count (the source is mapped onto it).
+         * @param sampleRate Endpoint rate in Hz.
+         * @param targetLatencyMs Source-to-ear latency, the same for every tap.
+         * @param delayMs Endpoint delay after the samples leave the render buffer.
+         * @param maxRenderFrames Largest block Pull() will be asked for.
+         */
+        AggregateTap(const AggregateSource &source, unsigned channels, double sampleRate, double targetLatencyMs,
+                     double delayMs, size_t maxRenderFrames);
+
+        /**
+         * @brief Render thread: fills @p frames interleaved frames (always fully written).
+         * @param timeSeconds When the first frame will leave the render buffer, on the
+         *        clock of AggregateSource::Push().
+         */
+        void Pull(float *output, size_t frames, double timeSeconds);
+
+        /// Changes the compensated endpoint delay; the tap realigns on its next block.
+        void SetDelay(double delayMs);
+
+        /// Changes the shared latency; the tap realigns on its next block.
+        void SetTargetLatency(double targetLatencyMs);
+
+        TapStats Stats() const;
+
+    private:
+        bool Seek(double sourceFrame);
+        void Realign();
+
+        const AggregateSource &m_source;
+        unsigned m_channels;
+        unsigned m_sourceChannels;
+        double m_sourceRate;
+        Dsp::PolyphaseResampler m_resampler;
+        Dsp::DriftController m_controller;
+        std::vector<float> m_input;     ///< Source frames read for one block.
+        std::vector<float> m_resampled; ///< One block at the source channel count.
+        size_t m_inputFrames;
+
+        std::atomic<double> m_delaySeconds;
+        std::atomic<double> m_targetSeconds;
+        double m_appliedDelay = -1.0;
+        double m_appliedTarget = -1.0;
+
+        uint64_t m_cursor = 0;    ///< Next ring element to read.
+        bool m_aligning = true;
+        double m_lastTime = -1.0;
+
+        std::atomic<bool> m_aligned{false};
+        std::atomic<uint64_t> m_underruns{0};
+        std::atomic<uint64_t> m_laps{0};
+        std::atomic<uint64_t> m_renderedFrames{0};
+        std::atomic<double> m_errorFrames{0.0};
+        std::atomic<double> m_correctionPpm{0.0};
+    };
+}
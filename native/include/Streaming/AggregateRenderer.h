@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Streaming/AggregatePipe.h"
+#include "Streaming/SharedModeClient.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief One output of an aggregate.
+     */
+    struct AggregateEndpoint
+    {
+        std::wstring id;       ///< Render endpoint; empty = default render.
+        double delayMs = -1.0; ///< Delay after the render buffer; negative = the engine's stream latency.
+    };
+
+    /**
+     * @brief Options for an aggregate output.
+     */
+    struct AggregateOptions
+    {
+        std::wstring sourceId;                ///< Source endpoint; empty = default capture (or default render with loopback).
+        bool loopback = false;                ///< Capture what a render endpoint is playing instead of a microphone.
+        std::vector<AggregateEndpoint> endpoints;
+        double latencyMs = 0.0;               ///< Source-to-ear latency; raised to what the slowest endpoint needs.
+    };
+
+    /**
+     * @brief Counters reported for one endpoint of a running aggregate.
+     */
+    struct AggregateEndpointStats
+    {
+        std::wstring id;
+        TapStats tap;
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        bool running = false;
+        std::string error; ///< Why this endpoint stopped on its own (device removed, ...), if it did.
+    };
+
+    /**
+     * @brief Counters reported for a running aggregate.
+     */
+    struct AggregateStats
+    {
+        uint32_t sourceRate = 0;
+        unsigned sourceChannels = 0;
+        bool running = false;
+        std::string error; ///< Why the source stopped on its own, if it did.
+        std::vector<AggregateEndpointStats> endpoints;
+    };
+
+    /**
+     * @brief Plays one source on several render endpoints at once, time-aligned.
+     *
+     * The source (a capture endpoint, or loopback of a render endpoint) is captured once
+     * into an AggregateSource; every endpoint runs its own AggregateTap on its own render
+     * thread, so adding an endpoint adds a reader, not another capture or copy. Each tap
+     * compensates its endpoint's delay and resamples against its clock, so all endpoints
+     * are heard the same source-to-ear latency after capture.
+     *
+     * Capture and every render stream run on "Pro Audio" MMCSS threads and are timed on
+     * the QPC clock. An endpoint that fails (e.g. is unplugged) stops alone; the others
+     * keep playing. Only 32-bit float mix formats are supported.
+     */
+    class AggregateRenderer
+    {
+    public:
+        explicit AggregateRenderer(AggregateOptions options);
+        ~AggregateRenderer();
+
+        AggregateRenderer(const AggregateRenderer &) = delete;
+        AggregateRenderer &operator=(const AggregateRenderer &) = delete;
+
+        /**
+         * @brief Opens the source and every endpoint and starts streaming.
+         * @throws std::runtime_error if any endpoint cannot be opened or uses an unsupported format.
+         */
+        void Start();
+
+        /// Stops streaming and releases every endpoint. Safe to call more than once.
+        void Stop();
+
+        /**
+         * @brief Changes the compensated delay of endpoint @p index (e.g. after measuring
+         *        it); negative restores the engine's stream latency. Raises the shared
+         *        latency of every endpoint if this one needs more.
+         * @return False if there is no such endpoint, or the delay exceeds the source history.
+         */
+        bool SetDelay(size_t index, double delayMs);
+
+        /// Shared source-to-ear latency in use.
+        double LatencyMs() const { return m_latencyMs.load(); }
+
+        /// Current counters.
+        AggregateStats Stats() const;
+
+    private:
+        /**
+         * @brief Render side of one endpoint.
+         */
+        struct Output
+        {
+            std::wstring id;
+            RenderStream stream;
+            double delayMs = 0.0;
+            std::unique_ptr<AggregateTap> tap;
+            std::thread thread;
+            std::atomic<bool> running{false};
+            std::atomic<const char *> error{nullptr};
+        };
+
+        double RequiredLatencyMs(const Output &output) const;
+        void OpenOutput(Output &output, const AggregateEndpoint &endpoint);
+        void CaptureLoop();
+        void RenderLoop(Output &output);
+        void Fail(const char *message);
+        void Release();
+
+        AggregateOptions m_options;
+        std::unique_ptr<AggregateSource> m_source;
+        std::vector<std::unique_ptr<Output>> m_outputs;
+        std::mutex m_configMutex;           ///< Serializes SetDelay().
+        std::atomic<double> m_latencyMs{0.0};
+        double m_historyMs = 0.0;
+
+        CaptureStream m_captureStream;
+
+        std::thread m_captureThread;
+        std::atomic<bool> m_running{false};
+        std::atomic<const char *> m_error{nullptr};
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Streaming/RecordingSink.h"
+#include "Streaming/SharedModeClient.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief Options for a CaptureRecorder.
+     */
+    struct CaptureRecorderOptions
+    {
+        std::wstring deviceId;  ///< Endpoint; empty = default render (loopback) or default capture.
+        bool loopback = true;   ///< Record what a render endpoint plays instead of a microphone.
+        RecordingOptions file;  ///< Path, encoding, container and buffering; rate and channels come from the mix format.
+    };
+
+    /**
+     * @brief Counters of a running recording.
+     */
+    struct CaptureRecorderStats
+    {
+        RecordingStats file;
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        uint64_t gapFrames = 0;     ///< Silence inserted where loopback delivered nothing (nothing was playing).
+        uint64_t glitches = 0;      ///< Packets the engine flagged as discontinuous.
+        double maxPushUs = 0.0;     ///< Longest time the capture thread spent handing one packet to the file.
+        bool running = false;
+        std::string error;          ///< Why capture stopped on its own (device removed, ...), if it did.
+    };
+
+    /**
+     * @brief Records an endpoint (by default loopback of the default render endpoint) to
+     *        a WAV, RF64 or Wave64 file for as long as needed.
+     *
+     * A "Pro Audio" MMCSS thread drains the capture client and hands each packet to a
+     * RecordingSink, which never blocks it on the disk. Loopback delivers no packets while
+     * nothing plays; those gaps are filled with silence from the packets' QPC timestamps
+     * (and, during long idle stretches, from the clock), so the file stays in real time.
+     * Only 32-bit float mix formats are supported.
+     */
+    class CaptureRecorder
+    {
+    public:
+        explicit CaptureRecorder(CaptureRecorderOptions options);
+        ~CaptureRecorder();
+
+        CaptureRecorder(const CaptureRecorder &) = delete;
+        CaptureRecorder &operator=(const CaptureRecorder &) = delete;
+
+        /**
+         * @brief Opens the endpoint and the file and starts recording.
+         * @throws std::runtime_error if either cannot be opened.
+         */
+        void Start();
+
+        /// Stops capture and finishes the file. Safe to call more than once.
+        void Stop();
+
+        CaptureRecorderStats Stats() const;
+
+    private:
+        void CaptureLoop();
+        void PushSilence(uint64_t frames);
+        void Fail(const char *message);
+        void Release();
+
+        CaptureRecorderOptions m_options;
+        std::unique_ptr<RecordingSink> m_sink;
+
+        CaptureStream m_stream;
+        std::vector<float> m_silence;
+
+        std::thread m_thread;
+        std::atomic<bool> m_running{false};
+        std::atomic<uint64_t> m_gapFrames{0};
+        std::atomic<uint64_t> m_glitches{0};
+        std::atomic<uint64_t> m_maxPushNs{0};
+        std::atomic<const char *> m_error{nullptr};
+    };
+}
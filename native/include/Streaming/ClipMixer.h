@@ -0,0 +1,228 @@
+#pragma once
+
+#include "Dsp/SimdKernels.h"
+#include "Dsp/SpscRing.h"
+#include "Dsp/WavDecoder.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief One clip converted to one output format (interleaved float).
+     *
+     * Voices reference the samples without owning them; @ref voices counts the
+     * references so the pool only frees a buffer no render thread is reading.
+     */
+    struct ClipBuffer
+    {
+        uint32_t clipId = 0;
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        size_t frames = 0;
+        std::vector<float> samples;
+        std::atomic<uint32_t> voices{0}; ///< References held by mixers (playing or queued).
+    };
+
+    /**
+     * @brief Counters reported by a ClipPool.
+     */
+    struct ClipPoolStats
+    {
+        size_t clips = 0;       ///< Loaded clips.
+        size_t buffers = 0;     ///< Clip buffers, one per clip and output format, retired ones included.
+        size_t retired = 0;     ///< Buffers of unloaded clips still referenced by a voice.
+        size_t bytes = 0;       ///< Sample memory in use.
+        size_t budgetBytes = 0;
+    };
+
+    /**
+     * @brief Decoded sound clips, converted once per output format and kept in memory.
+     *
+     * A clip is decoded once by Add(); Prepare() converts it (polyphase resampling and
+     * channel mapping) to an endpoint's mix format the first time that format is asked
+     * for and caches the result, so playing it never converts, allocates or touches
+     * the file again. All sample memory counts against a fixed budget.
+     *
+     * Every method is thread-safe. Buffers handed out by Acquire() stay valid until the
+     * reference is dropped, even if the clip is removed meanwhile: removed buffers are
+     * retired and freed by a later control call once no voice reads them, never on a
+     * render thread.
+     */
+    class ClipPool
+    {
+    public:
+        /// @param budgetBytes Upper bound on sample memory.
+        explicit ClipPool(size_t budgetBytes);
+
+        ClipPool(const ClipPool &) = delete;
+        ClipPool &operator=(const ClipPool &) = delete;
+
+        /**
+         * @brief Stores a decoded clip.
+         * @return Its id (never 0).
+         * @throws std::runtime_error if it is empty or does not fit in the budget.
+         */
+        uint32_t Add(Dsp::DecodedAudio audio);
+
+        /**
+         * @brief Converts clip @p id to @p sampleRate / @p channels unless already done.
+         * @return False for an unknown id.
+         * @throws std::runtime_error if the conversion does not fit in the budget.
+         */
+        bool Prepare(uint32_t id, uint32_t sampleRate, unsigned channels);
+
+        /**
+         * @brief Returns clip @p id in the given format (converting it if needed) with one
+         *        voice reference taken; drop it with ClipBuffer::voices when done.
+         * @return Nullptr for an unknown id.
+         * @throws std::runtime_error if the conversion does not fit in the budget.
+         */
+        ClipBuffer *Acquire(uint32_t id, uint32_t sampleRate, unsigned channels);
+
+        /// Removes clip @p id; returns false if there is none.
+        bool Remove(uint32_t id);
+
+        /// Removes every clip.
+        void Clear();
+
+        /// Frees retired buffers that no voice references any more.
+        void Collect();
+
+        /// Length of clip @p id in milliseconds, or a negative value for an unknown id.
+        double DurationMs(uint32_t id) const;
+
+        ClipPoolStats Stats() const;
+
+    private:
+        /// Buffers of one clip; the first is the decoded original.
+        using Buffers = std::vector<std::unique_ptr<ClipBuffer>>;
+
+        ClipBuffer *FindOrConvertLocked(uint32_t id, uint32_t sampleRate, unsigned channels);
+        void CollectLocked();
+
+        mutable std::mutex m_mutex;
+        std::map<uint32_t, Buffers> m_clips;
+        Buffers m_retired;
+        size_t m_budget;
+        size_t m_bytes = 0;
+        uint32_t m_nextId = 1;
+    };
+
+    /**
+     * @brief Converts @p source to @p sampleRate / @p channels (offline, whole clip).
+     *
+     * The resampler's centred filter is drained at the end, so the result is exactly
+     * ceil(frames * sampleRate / source rate) frames long and starts on the first input
+     * frame. Also used by tests.
+     */
+    std::vector<float> ConvertClip(const ClipBuffer &source, uint32_t sampleRate, unsigned channels);
+
+    /**
+     * @brief Counters published by a ClipMixer (readable from any thread).
+     */
+    struct ClipMixerStats
+    {
+        uint64_t started = 0;  ///< Voices started.
+        uint64_t finished = 0; ///< Voices that played to the end.
+        uint64_t stolen = 0;   ///< Voices cut off to make room for a new one.
+        uint64_t rejected = 0; ///< Play() calls refused because the command queue was full.
+        unsigned active = 0;   ///< Voices playing after the last block.
+        uint64_t renderedFrames = 0;
+    };
+
+    /**
+     * @brief Polyphonic clip mixer for one render stream.
+     *
+     * The control thread queues commands (play, stop) through a lock-free SPSC ring;
+     * the render thread applies them at the start of each block and mixes every active
+     * voice with the SIMD mixAdd kernel. A voice is a clip buffer in the stream's
+     * format, a position and a gain, so starting one costs a ring write and the sound
+     * begins on the very next block the stream renders. When every voice slot is busy,
+     * the voice closest to its end is stolen.
+     *
+     * Render() never blocks or allocates. Control calls must be serialized by the
+     * caller (one producer).
+     */
+    class ClipMixer
+    {
+    public:
+        /**
+         * @param channels Interleaved output channels (clip buffers must match).
+         * @param maxVoices Voices mixed at once.
+         * @param queueCapacity Commands that may be pending between two blocks.
+         * @param kernels Kernel table to use (defaults to ActiveKernels()).
+         */
+        ClipMixer(unsigned channels, size_t maxVoices = 32, size_t queueCapacity = 256,
+                  const Dsp::SimdKernels *kernels = nullptr);
+
+        /// Drops the references of every voice and queued command.
+        ~ClipMixer();
+
+        ClipMixer(const ClipMixer &) = delete;
+        ClipMixer &operator=(const ClipMixer &) = delete;
+
+        /**
+         * @brief Control: queues @p clip (one reference taken by ClipPool::Acquire, which
+         *        the mixer now owns) to start at @p gain on the next block.
+         * @return False if the queue is full; the reference is then still the caller's.
+         */
+        bool Play(ClipBuffer *clip, float gain);
+
+        /// Control: stops every voice of clip @p clipId, or all voices for 0.
+        bool Stop(uint32_t clipId = 0);
+
+        /**
+         * @brief Render: applies pending commands and writes the mix of every voice.
+         * @return True if any voice contributed (the block is not silent).
+         */
+        bool Render(float *output, size_t frames);
+
+        unsigned Channels() const { return m_channels; }
+        size_t MaxVoices() const { return m_voices.size(); }
+
+        ClipMixerStats Stats() const;
+
+    private:
+        enum class CommandType : uint8_t
+        {
+            Play,
+            Stop,
+        };
+
+        struct Command
+        {
+            CommandType type;
+            ClipBuffer *clip;
+            float gain;
+            uint32_t clipId;
+        };
+
+        struct Voice
+        {
+            ClipBuffer *clip = nullptr;
+            size_t position = 0; ///< Next frame to play.
+            float gain = 1.0f;
+        };
+
+        void Apply(const Command &command);
+        void Finish(Voice &voice);
+
+        const unsigned m_channels;
+        const Dsp::SimdKernels *m_kernels;
+        Dsp::SpscRing<Command> m_commands;
+        std::vector<Voice> m_voices; ///< Render thread only.
+
+        std::atomic<uint64_t> m_started{0};
+        std::atomic<uint64_t> m_finished{0};
+        std::atomic<uint64_t> m_stolen{0};
+        std::atomic<uint64_t> m_rejected{0};
+        std::atomic<unsigned> m_active{0};
+        std::atomic<uint64_t> m_renderedFrames{0};
+    };
+}
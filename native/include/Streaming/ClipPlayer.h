@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Streaming/ClipMixer.h"
+#include "Streaming/SharedModeClient.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Streaming
+{
+    struct ClipPlayerStats
+    {
+        bool open = false;         ///< The stream is initialized and running (warm).
+        bool lowLatency = false;   ///< Opened with an engine period below the default one.
+        uint32_t sampleRate = 0;
+        uint32_t channels = 0;
+        double periodMs = 0.0;     ///< Engine period of the stream.
+        double latencyMs = 0.0;    ///< Play() to sound: audio written ahead plus the stream latency.
+        ClipMixerStats mixer;
+        std::string error;         ///< Why the stream stopped on its own (device removed, ...), if it did.
+    };
+
+    /**
+     * @brief Plays clips from a ClipPool on one endpoint with low start latency.
+     *
+     * The shared-mode stream is opened once and kept running, rendering silence while
+     * nothing plays, so starting a clip only queues a voice on the ClipMixer: no
+     * activation, allocation or thread start. The stream uses the engine's smallest
+     * period when IAudioClient3 offers one, and the render thread ("Pro Audio" MMCSS)
+     * keeps only two periods written ahead, which bounds how long a new voice waits to
+     * be heard. One player per endpoint; clips on one endpoint mix, players on different
+     * endpoints run concurrently.
+     */
+    class ClipPlayer
+    {
+    public:
+        /**
+         * @param deviceId Render endpoint.
+         * @param maxVoices Clips mixed at once; more steal the voice closest to its end.
+         */
+        explicit ClipPlayer(std::wstring deviceId, size_t maxVoices = 32);
+        ~ClipPlayer();
+
+        ClipPlayer(const ClipPlayer &) = delete;
+        ClipPlayer &operator=(const ClipPlayer &) = delete;
+
+        /**
+         * @brief Initializes and starts the stream (silent), if not done yet.
+         * @throws std::runtime_error if the endpoint cannot be opened.
+         */
+        void Open();
+
+        /// True while the stream is open and has not failed: Play() needs no COM call.
+        bool IsWarm() const { return m_warm.load(); }
+
+        /**
+         * @brief Starts clip @p clipId of @p pool at @p gain, mixed with whatever plays.
+         *        The clip is converted to the stream's format first if it has not been.
+         * @return False if the pool has no such clip.
+         * @throws std::runtime_error if the endpoint cannot be opened or too many clips
+         *         were started within one period.
+         */
+        bool Play(ClipPool &pool, uint32_t clipId, float gain);
+
+        /// Stops every voice of clip @p clipId (all voices for 0); the stream keeps running.
+        void Stop(uint32_t clipId = 0);
+
+        /// Stops and releases the endpoint. Safe to call more than once.
+        void Close();
+
+        /// Mix format of the open stream (0 before Open()).
+        uint32_t SampleRate() const { return m_stream.sampleRate; }
+        uint32_t Channels() const { return m_stream.channels; }
+
+        ClipPlayerStats Stats() const;
+
+    private:
+        void OpenLocked();
+        void RenderLoop();
+        void Fail(const char *message);
+        void Release();
+
+        const std::wstring m_deviceId;
+        const size_t m_maxVoices;
+        mutable std::mutex m_controlMutex; ///< Serializes Open/Play/Stop/Close (the mixer's one producer).
+
+        RenderStream m_stream;     ///< Opened at the smallest engine period the endpoint allows.
+        HANDLE m_wakeEvent = nullptr;
+        UINT32 m_aheadFrames = 0;  ///< Frames kept written ahead of the engine.
+
+        std::unique_ptr<ClipMixer> m_mixer;
+        std::thread m_thread;
+        std::atomic<bool> m_closing{false};
+        std::atomic<bool> m_warm{false};
+        std::atomic<const char *> m_error{nullptr};
+    };
+}
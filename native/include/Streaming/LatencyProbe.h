@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Dsp/DelayEstimator.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Streaming
+{
+    enum class LatencyStimulus : uint8_t
+    {
+        Mls,   ///< Maximum length sequence (white, sharpest correlation peak).
+        Chirp, ///< Exponential sweep (survives lossy codecs and band-limited speakers better).
+    };
+
+    /**
+     * @brief What to measure: a render endpoint and where its output is captured back.
+     */
+    struct LatencyOptions
+    {
+        std::wstring renderId;  ///< Endpoint under test; empty = default render.
+        std::wstring captureId; ///< Microphone hearing it; empty = loopback of the render endpoint.
+        LatencyStimulus stimulus = LatencyStimulus::Mls;
+        unsigned trials = 10;
+        double levelDb = -12.0;       ///< Stimulus peak level in dBFS.
+        double maxLatencyMs = 1000.0; ///< Longest latency searched for.
+        double gapMs = 100.0;         ///< Silence between trials.
+    };
+
+    struct LatencyTrial
+    {
+        bool found = false;
+        double latencyMs = 0.0;   ///< Submission of the first stimulus frame to its capture.
+        double bufferMs = 0.0;    ///< Part of latencyMs spent behind audio already queued in the render buffer.
+        float correlation = 0.0f; ///< 0..1, see Dsp::DelayEstimate.
+        float prominence = 0.0f;
+        bool glitched = false;    ///< The capture reported a discontinuity during the trial.
+    };
+
+    struct LatencyReport
+    {
+        std::wstring renderId;
+        std::wstring captureId; ///< Same as renderId for loopback.
+        bool loopback = false;
+        uint32_t sampleRate = 0;
+        size_t stimulusFrames = 0;
+        std::vector<LatencyTrial> trials;
+        Dsp::DelayStatistics stats; ///< Latency (ms) over the trials that found the stimulus.
+    };
+
+    /**
+     * @brief Measures the latency of a render endpoint by playing a stimulus and finding
+     *        it again in a capture of the endpoint (loopback) or of a microphone.
+     *
+     * Both shared-mode streams run for the whole measurement and are serviced by the
+     * calling thread (MMCSS "Pro Audio"). For each trial the capture is recorded from a
+     * moment before the stimulus is submitted, and the stimulus is located in it with an
+     * FFT cross-correlation. Capture and submission times are both on the QPC clock, so
+     * the result does not depend on buffer sizes being reported correctly. Loopback
+     * measures the Windows audio engine path only; what a Bluetooth or USB link adds
+     * beyond it is heard by a microphone.
+     */
+    class LatencyProbe
+    {
+    public:
+        explicit LatencyProbe(LatencyOptions options);
+        ~LatencyProbe();
+
+        LatencyProbe(const LatencyProbe &) = delete;
+        LatencyProbe &operator=(const LatencyProbe &) = delete;
+
+        /**
+         * @brief Runs every trial. Blocks for roughly trials × (stimulus + latency + gap).
+         *        Requires COM on the calling thread.
+         * @throws std::runtime_error if an endpoint cannot be opened or fails mid-measurement.
+         */
+        LatencyReport Run();
+
+    private:
+        void Open();
+        void Release();
+        void ServiceRender();
+        void ServiceCapture();
+        void Idle(double milliseconds);
+        LatencyTrial RunTrial(Dsp::DelayEstimator &estimator);
+
+        LatencyOptions m_options;
+        LatencyReport m_report;
+
+        IAudioClient *m_renderClient = nullptr;
+        IAudioRenderClient *m_render = nullptr;
+        IAudioClient *m_captureClient = nullptr;
+        IAudioCaptureClient *m_capture = nullptr;
+        UINT32 m_renderBufferFrames = 0;
+        uint32_t m_renderChannels = 0;
+        uint32_t m_captureChannels = 0;
+
+        // Trial state, only touched by the thread in Run()
+        std::vector<float> m_stimulus;
+        size_t m_stimulusPosition = 0;
+        bool m_armed = false;          ///< Submit the stimulus on the next render service.
+        int64_t m_submitTime = 0;      ///< QPC in 100 ns units, like capture timestamps.
+        double m_bufferMs = 0.0;
+        bool m_recording = false;
+        std::vector<float> m_recorded;
+        size_t m_recordedFrames = 0;
+        int64_t m_recordStartTime = 0; ///< QPC of the first recorded frame, in 100 ns units.
+        bool m_glitched = false;
+    };
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Dsp/DriftController.h"
+#include "Dsp/PolyphaseResampler.h"
+#include "Dsp/SpscRing.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief Copies interleaved frames between channel layouts.
+     *
+     * Mono sources are duplicated to every output channel, mono outputs receive the
+     * average of all inputs, and otherwise channels map one-to-one with extra output
+     * channels left silent.
+     */
+    void MapChannels(const float *in, unsigned inChannels, float *out, unsigned outChannels, size_t frames);
+
+    /**
+     * @brief Counters published by a passthrough pipe (readable from any thread).
+     */
+    struct PipeStats
+    {
+        uint64_t underruns = 0;      ///< Render blocks that ran out of input and were padded.
+        uint64_t overruns = 0;       ///< Capture blocks (partially) dropped because the ring was full.
+        uint64_t capturedFrames = 0; ///< Frames accepted from the capture side.
+        uint64_t renderedFrames = 0; ///< Frames handed to the render side (including silence).
+        double fillMs = 0.0;         ///< Smoothed buffered audio, in milliseconds.
+        double targetMs = 0.0;       ///< Latency target, in milliseconds.
+        double correctionPpm = 0.0;  ///< Current drift correction.
+    };
+
+    /**
+     * @brief Platform-independent core of the capture -> render passthrough.
+     *
+     * The capture thread calls PushCapture(), the render thread calls PullRender(); the
+     * two only share a lock-free SPSC ring. The render side resamples from the capture
+     * rate to the render rate with a ratio trimmed by a DriftController so the ring stays
+     * at the latency target even though the two devices run on independent clocks.
+     *
+     * Both calls take a timestamp on a clock shared by the two threads. The fill seen by
+     * the controller is the ring level plus the frames captured since the last capture
+     * packet, which removes the block-size sawtooth (and the full-block jump each time
+     * the two device periods slip past each other) from the measurement.
+     *
+     * After an underrun the pipe outputs silence until the ring is re-primed to the
+     * target, instead of crackling on every block while the source catches up.
+     */
+    class PassthroughPipe
+    {
+    public:
+        /**
+         * @param channels Interleaved channel count (same on both sides).
+         * @param captureRate Capture sample rate in Hz.
+         * @param renderRate Render sample rate in Hz.
+         * @param targetLatencyMs Desired buffered audio between the two devices.
+         * @param maxRenderFrames Largest block PullRender() will be asked for.
+         */
+        PassthroughPipe(unsigned channels, double captureRate, double renderRate,
+                        double targetLatencyMs, size_t maxRenderFrames);
+
+        /**
+         * @brief Capture thread: queues @p frames interleaved frames.
+         * @param timeSeconds Capture time of the end of the packet.
+         */
+        void PushCapture(const float *input, size_t frames, double timeSeconds);
+
+        /**
+         * @brief Render thread: fills @p frames interleaved frames (always fully written).
+         * @param timeSeconds Current time on the same clock as PushCapture().
+         */
+        void PullRender(float *output, size_t frames, double timeSeconds);
+
+        /// Snapshot of the counters.
+        PipeStats Stats() const;
+
+        unsigned Channels() const { return m_channels; }
+
+    private:
+        size_t BufferedFrames() const;
+        double EstimatedFill(double timeSeconds) const;
+
+        unsigned m_channels;
+        double m_targetFrames;
+        double m_captureRate;
+        Dsp::SpscRing<float> m_ring;
+        Dsp::PolyphaseResampler m_resampler;
+        Dsp::DriftController m_controller;
+        std::vector<float> m_scratch;
+        size_t m_scratchFrames;
+        bool m_priming = true;
+        double m_lastRenderTime = -1.0;
+        std::atomic<double> m_lastCaptureTime{0.0};
+
+        std::atomic<uint64_t> m_underruns{0};
+        std::atomic<uint64_t> m_overruns{0};
+        std::atomic<uint64_t> m_capturedFrames{0};
+        std::atomic<uint64_t> m_renderedFrames{0};
+        std::atomic<double> m_fillFrames{0.0};
+        std::atomic<double> m_correctionPpm{0.0};
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Streaming/PassthroughPipe.h"
+#include "Streaming/SharedModeClient.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace Streaming
+{
+    /**
+     * @brief Options for a software passthrough route.
+     */
+    struct RouterOptions
+    {
+        std::wstring captureId;  ///< Source endpoint; empty = default capture (or default render with loopback).
+        std::wstring renderId;   ///< Destination endpoint; empty = default render.
+        bool loopback = false;   ///< Capture what a render endpoint is playing instead of a microphone.
+        double latencyMs = 40.0; ///< Target buffered audio between the devices.
+    };
+
+    /**
+     * @brief Counters reported for a running route.
+     */
+    struct RouterStats
+    {
+        PipeStats pipe;
+        uint32_t captureRate = 0;
+        uint32_t renderRate = 0;
+        bool running = false;
+        std::string error; ///< Why the route stopped on its own (device removed, ...), if it did.
+    };
+
+    /**
+     * @brief Streams audio from one endpoint to another in shared mode.
+     *
+     * Unlike "Listen to this device" (which the audio engine does for capture endpoints
+     * only), this works between any two endpoints, including loopback of a render
+     * endpoint, and between devices running on different clocks or sample rates: a
+     * PassthroughPipe compensates the drift with adaptive resampling.
+     *
+     * Capture and render each run on their own "Pro Audio" MMCSS thread. Only 32-bit float
+     * mix formats are supported, which is what the shared-mode engine uses.
+     */
+    class PassthroughRouter
+    {
+    public:
+        explicit PassthroughRouter(RouterOptions options);
+        ~PassthroughRouter();
+
+        PassthroughRouter(const PassthroughRouter &) = delete;
+        PassthroughRouter &operator=(const PassthroughRouter &) = delete;
+
+        /**
+         * @brief Opens both endpoints and starts streaming.
+         * @throws std::runtime_error if an endpoint cannot be opened or uses an unsupported format.
+         */
+        void Start();
+
+        /// Stops streaming and releases both endpoints. Safe to call more than once.
+        void Stop();
+
+        /// Current counters.
+        RouterStats Stats() const;
+
+    private:
+        void CaptureLoop();
+        void RenderLoop();
+        void Fail(const char *message);
+        void Release();
+
+        RouterOptions m_options;
+        std::unique_ptr<PassthroughPipe> m_pipe;
+
+        CaptureStream m_captureStream;
+        RenderStream m_renderStream;
+
+        std::thread m_captureThread;
+        std::thread m_renderThread;
+        std::atomic<bool> m_running{false};
+        std::atomic<const char *> m_error{nullptr};
+    };
+}
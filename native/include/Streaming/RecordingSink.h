@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Dsp/FlacEncoder.h"
+#include "Dsp/SpscRing.h"
+#include "Dsp/WavEncoder.h"
+#include "Utility/OutputFile.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief Options for a RecordingSink.
+     */
+    struct RecordingOptions
+    {
+        std::string path;              ///< UTF-8 file path; created or truncated.
+        Dsp::WavLayout layout;         ///< Rate, channels, sample encoding and container.
+        size_t blockBytes = 1u << 20;  ///< Size of each write; rounded up to 64 KB (FLAC: of each encoded batch, in whole frames).
+        size_t blocks = 8;             ///< Blocks in flight (at least 2): capture fills one while the disk writes the others.
+        uint32_t pollIntervalMs = 20;  ///< How often the I/O thread collects full blocks (they fill in about 2.7 s at 48 kHz stereo float).
+        uint32_t patchIntervalMs = 1000; ///< How often the header is rewritten with the current size; 0 = only on Close().
+        bool syncOnPatch = true;       ///< Flush data to the device before each header patch.
+        Dsp::FlacEncoderOptions flac;  ///< Frame size, LPC order and encoding threads when the container is Flac.
+    };
+
+    /**
+     * @brief Counters of a recording.
+     */
+    struct RecordingStats
+    {
+        uint64_t frames = 0;        ///< Frames accepted from the capture thread.
+        uint64_t droppedFrames = 0; ///< Frames lost because every block was waiting for the disk, or writing failed.
+        uint64_t bytesWritten = 0;  ///< Sample data on disk (the header excluded).
+        uint64_t writes = 0;        ///< Block writes issued.
+        uint64_t headerPatches = 0;
+        size_t queueDepth = 0;      ///< Full blocks waiting for the disk.
+        size_t maxQueueDepth = 0;
+        size_t blocks = 0;          ///< Blocks in flight, for comparison with the queue depth.
+        double writeMBps = 0.0;     ///< Disk throughput while writing (bytes over time spent in writes).
+        double maxWriteMs = 0.0;    ///< Slowest single block write.
+        bool rf64 = false;          ///< The header has been promoted to RF64.
+        double compression = 0.0;   ///< FLAC: bytes written over the PCM bytes they hold.
+        double encodeRealtime = 0.0; ///< FLAC: seconds of audio encoded per second of encoder time (x realtime per core).
+        std::string error;          ///< Why writing stopped (disk full, ...), if it did.
+    };
+
+    /**
+     * @brief Streams captured audio into a WAV, RF64 or Wave64 file without ever blocking
+     *        the capture thread on the disk.
+     *
+     * The capture thread encodes into one of a few large page-aligned blocks and hands
+     * each full block to a background I/O thread through a lock-free queue; the I/O thread
+     * writes it at its page-aligned file offset and returns it through a second queue.
+     * Push() takes no lock and makes no system call (the I/O thread polls the queue), so
+     * a slow disk shows up as queue depth and, once every block is queued, as dropped
+     * frames, never as a stalled capture thread.
+     *
+     * Every patch interval the I/O thread flushes the data written so far and rewrites
+     * the header with its size, so a recording cut short by a crash or power loss is a
+     * valid file missing at most the last interval. A WAV recording that outgrows 4 GB
+     * has its header rewritten as RF64 in place (the space is reserved up front).
+     *
+     * With the Flac container the capture thread stores 32-bit integers instead and the
+     * I/O thread compresses each full block (spread over FlacEncoder's threads) before
+     * appending it. FLAC frames are self-delimiting and the stream header leaves the
+     * totals unknown until Close(), so the patch interval only flushes the data: a cut-
+     * short FLAC recording is valid up to its last complete frame.
+     */
+    class RecordingSink
+    {
+    public:
+        explicit RecordingSink(RecordingOptions options);
+
+        /// Finishes the file, as Close().
+        ~RecordingSink();
+
+        RecordingSink(const RecordingSink &) = delete;
+        RecordingSink &operator=(const RecordingSink &) = delete;
+
+        /**
+         * @brief Creates the file, writes an empty header and starts the I/O thread.
+         * @throws std::runtime_error if the format is invalid or the file cannot be created.
+         */
+        void Open();
+
+        /**
+         * @brief Capture thread: appends @p frames interleaved frames.
+         * @return Frames accepted; the rest are dropped (and counted) because every block
+         *         is waiting for the disk.
+         */
+        size_t Push(const float *samples, size_t frames);
+
+        /// Capture thread: frames Push() can accept right now.
+        size_t WritableFrames() const;
+
+        /**
+         * @brief Writes what is buffered, the final header, and closes the file. Call once
+         *        the capture thread has stopped pushing. Safe to call more than once.
+         */
+        void Close();
+
+        RecordingStats Stats() const;
+
+        const Dsp::WavLayout &Layout() const { return m_options.layout; }
+
+    private:
+        static constexpr uint32_t kNoBlock = 0xFFFFFFFFu;
+
+        uint8_t *Block(uint32_t index) const { return m_blocks + size_t(index) * m_options.blockBytes; }
+        void Submit();
+        void Run();
+        void DrainBlocks();
+        void WriteData(const uint8_t *data, size_t bytes, size_t frames);
+        void PatchHeader(bool sync, bool final);
+        void Fail(const char *message);
+
+        RecordingOptions m_options;
+        size_t m_frameBytes = 0;           ///< Bytes per frame in a block (int32 samples for FLAC).
+        uint64_t m_dataOffset = 0;         ///< Where sample data starts in the file.
+        Utility::OutputFile m_file;
+        std::unique_ptr<Dsp::FlacEncoder> m_flac;
+
+        std::unique_ptr<uint8_t[]> m_storage;
+        uint8_t *m_blocks = nullptr;       ///< Page-aligned start of the blocks within m_storage.
+        std::vector<size_t> m_blockFill;   ///< Bytes used in each queued block (set before it is queued).
+        Dsp::SpscRing<uint32_t> m_full;    ///< Capture -> I/O: blocks to write.
+        Dsp::SpscRing<uint32_t> m_free;    ///< I/O -> capture: written blocks.
+
+        // Capture thread only
+        uint32_t m_current = kNoBlock;
+        size_t m_fill = 0;
+        std::vector<uint8_t> m_scratch;
+
+        // I/O thread only
+        uint64_t m_writeNs = 0;
+        uint64_t m_encodedFrames = 0;
+        std::vector<uint8_t> m_encoded;
+
+        std::atomic<uint64_t> m_frames{0};
+        std::atomic<uint64_t> m_dropped{0};
+        std::atomic<uint64_t> m_dataBytes{0};
+        std::atomic<uint64_t> m_writes{0};
+        std::atomic<uint64_t> m_patches{0};
+        std::atomic<uint64_t> m_maxWriteNs{0};
+        std::atomic<double> m_writeMBps{0.0};
+        std::atomic<size_t> m_maxQueueDepth{0};
+        std::atomic<bool> m_rf64{false};
+        std::atomic<double> m_compression{0.0};
+        std::atomic<double> m_encodeRealtime{0.0};
+        std::atomic<const char *> m_error{nullptr};
+
+        std::mutex m_threadMutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <cstdint>
+#include <string>
+
+namespace Streaming
+{
+    /**
+     * @brief Opens the requested endpoint, or the console default for @p flow when @p id
+     *        is empty. Returns nullptr if it does not exist.
+     */
+    IMMDevice *OpenEndpoint(const std::wstring &id, EDataFlow flow);
+
+    /**
+     * @brief Returns @p id, or the ID of the console default for @p flow when it is empty,
+     *        so per-endpoint state can be keyed by real IDs.
+     * @throws std::runtime_error if there is no default endpoint.
+     */
+    std::wstring ResolveEndpointId(const std::wstring &id, EDataFlow flow);
+
+    /**
+     * @brief Activates an IAudioClient and returns its shared-mode mix format, which must
+     *        be 32-bit float (what the shared-mode engine uses).
+     *
+     * @param format Receives the mix format; free it with CoTaskMemFree.
+     * @throws std::runtime_error on failure or an unsupported format.
+     */
+    IAudioClient *ActivateClient(IMMDevice *device, WAVEFORMATEX **format);
+
+    /**
+     * @brief A shared-mode capture stream, as opened by OpenCaptureStream().
+     */
+    struct CaptureStream
+    {
+        IAudioClient *client = nullptr;
+        IAudioCaptureClient *capture = nullptr;
+        HANDLE event = nullptr; ///< Signalled per packet; null for loopback, which is polled.
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        double periodMs = 10.0; ///< Device period; pollers wait about half of it.
+    };
+
+    /**
+     * @brief Opens an endpoint for shared-mode capture, or loopback capture of a render
+     *        endpoint, in its 32-bit float mix format. The stream is not started.
+     *
+     * @param id Endpoint ID; empty = default capture (or default render with loopback).
+     * @param bufferDuration Engine buffer, in 100 ns units.
+     * @param stream Receives the opened stream; release it with CloseCaptureStream().
+     * @throws std::runtime_error on failure, with nothing left open.
+     */
+    void OpenCaptureStream(const std::wstring &id, bool loopback, REFERENCE_TIME bufferDuration, CaptureStream &stream);
+
+    /**
+     * @brief Stops the stream and releases its COM objects and event. Safe on a stream
+     *        that is closed or was never opened; the format fields are kept.
+     */
+    void CloseCaptureStream(CaptureStream &stream);
+
+    /**
+     * @brief A shared-mode render stream, as opened by OpenRenderStream().
+     */
+    struct RenderStream
+    {
+        IAudioClient *client = nullptr;
+        IAudioRenderClient *render = nullptr;
+        HANDLE event = nullptr; ///< Signalled each time the engine wants more audio.
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        UINT32 bufferFrames = 0;
+        UINT32 periodFrames = 0;     ///< Engine period (half the buffer if the device does not say).
+        double periodMs = 10.0;
+        double streamLatencyMs = 0.0;
+        bool lowLatency = false;     ///< Runs below the default engine period (IAudioClient3).
+    };
+
+    /**
+     * @brief Opens a render endpoint for event-driven shared-mode rendering in its 32-bit
+     *        float mix format. The stream is not started.
+     *
+     * @param id Endpoint ID; empty = default render endpoint.
+     * @param lowLatency Ask for the smallest engine period the endpoint supports
+     *        (IAudioClient3), falling back to the regular period on older systems.
+     * @param stream Receives the opened stream; release it with CloseRenderStream().
+     * @throws std::runtime_error on failure, with nothing left open.
+     */
+    void OpenRenderStream(const std::wstring &id, bool lowLatency, RenderStream &stream);
+
+    /**
+     * @brief Stops the stream and releases its COM objects and event. Safe on a stream
+     *        that is closed or was never opened; the format fields are kept.
+     */
+    void CloseRenderStream(RenderStream &stream);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Dsp/BlockPool.h"
+#include "Dsp/SignalGenerator.h"
+#include "Streaming/SharedModeClient.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Streaming
+{
+    /**
+     * @brief What to play on one endpoint.
+     */
+    struct SignalOptions
+    {
+        Dsp::SignalSpec signal;
+        int channel = -1;         ///< Output channel index, or -1 for every channel.
+        double durationMs = 0.0;  ///< Stop after this long (silence follows); 0 plays until stopped.
+    };
+
+    struct SignalPlayerStats
+    {
+        bool open = false;         ///< The stream is initialized (warm) on the endpoint.
+        bool playing = false;      ///< A signal is playing (false once durationMs has elapsed).
+        uint32_t sampleRate = 0;
+        uint32_t channels = 0;
+        uint64_t framesRendered = 0;
+        double lastStartMs = 0.0;  ///< Time the last Play() took, stream open included.
+        std::string error;         ///< Why the stream stopped on its own (device removed, ...), if it did.
+    };
+
+    /**
+     * @brief Plays generated test signals on one endpoint in shared mode.
+     *
+     * The stream is opened once and kept initialized between signals, so switching or
+     * restarting a signal only stops the client, swaps the generator, pre-fills one
+     * buffer and starts it again: no activation, allocation or thread start. The render
+     * thread ("Pro Audio" MMCSS) takes its mono scratch buffer from a shared BlockPool
+     * and fans the signal out to the selected channels. One player per endpoint; players
+     * on different endpoints run concurrently.
+     */
+    class SignalPlayer
+    {
+    public:
+        /**
+         * @param deviceId Render endpoint.
+         * @param pool Scratch buffers shared by all players; must outlive the player.
+         */
+        SignalPlayer(std::wstring deviceId, Dsp::BlockPool &pool);
+        ~SignalPlayer();
+
+        SignalPlayer(const SignalPlayer &) = delete;
+        SignalPlayer &operator=(const SignalPlayer &) = delete;
+
+        /**
+         * @brief Initializes the stream and starts the render thread (idle), if not done yet.
+         * @throws std::runtime_error if the endpoint cannot be opened.
+         */
+        void Open();
+
+        /**
+         * @brief Starts @p options.signal from its first sample, replacing any signal playing.
+         * @throws std::runtime_error if the endpoint cannot be opened or every scratch
+         *         buffer in the pool is in use.
+         */
+        void Play(const SignalOptions &options);
+
+        /// Stops the signal; the stream stays open for the next Play().
+        void Stop();
+
+        /// Stops and releases the endpoint. Safe to call more than once.
+        void Close();
+
+        SignalPlayerStats Stats() const;
+
+    private:
+        void OpenLocked();
+        void Quiesce();
+        void RenderLoop();
+        void Fill(float *data, UINT32 frames);
+        void Fail(const char *message);
+        void Release();
+
+        const std::wstring m_deviceId;
+        Dsp::BlockPool &m_pool;
+        mutable std::mutex m_controlMutex; ///< Serializes Open/Play/Stop/Close.
+
+        RenderStream m_stream;
+        HANDLE m_wakeEvent = nullptr;
+
+        // Owned by the render thread while m_rendering is set; replaced only after Quiesce()
+        std::unique_ptr<Dsp::SignalGenerator> m_generator;
+        float *m_scratch = nullptr;
+        int m_channel = -1;
+        uint64_t m_remaining = 0;
+
+        std::thread m_thread;
+        std::atomic<bool> m_closing{false};
+        std::atomic<bool> m_playing{false};
+        std::atomic<bool> m_rendering{false};
+        std::atomic<bool> m_finished{false};
+        std::atomic<uint64_t> m_framesRendered{0};
+        std::atomic<const char *> m_error{nullptr};
+        double m_lastStartMs = 0.0;
+    };
+}
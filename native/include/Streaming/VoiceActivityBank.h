@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Dsp/VoiceActivity.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief Voice activity of one stream as last published.
+     */
+    struct VoiceActivityState
+    {
+        float probability = 0.0f;   ///< Smoothed speech probability, 0..1.
+        float levelDb = -120.0f;    ///< Speech-band level, dBFS.
+        float noiseDb = -120.0f;    ///< Tracked noise floor, dBFS.
+        float flatness = 0.0f;
+        float zeroCrossings = 0.0f;
+        bool speaking = false;      ///< Probability at or above one half.
+        double speechSeconds = 0.0; ///< Time spent speaking since the stream was configured.
+        uint64_t updates = 0;       ///< Analysis frames published; 0 = nothing heard yet.
+    };
+
+    /**
+     * @brief Shared buffer of per-stream voice activity: one writer, any number of readers.
+     *
+     * Each slot is a handful of relaxed atomics behind a sequence counter (odd while
+     * written), so Read() returns a consistent state without locks and the writer never
+     * waits for a reader.
+     */
+    class VoiceActivityBoard
+    {
+    public:
+        explicit VoiceActivityBoard(size_t slots);
+
+        VoiceActivityBoard(const VoiceActivityBoard &) = delete;
+        VoiceActivityBoard &operator=(const VoiceActivityBoard &) = delete;
+
+        /// Writer: replaces slot @p index.
+        void Publish(size_t index, const VoiceActivityState &state);
+
+        /// Any thread: the last state published to slot @p index (default state if out of range).
+        VoiceActivityState Read(size_t index) const;
+
+        size_t Size() const { return m_size; }
+
+        /**
+         * @brief Index of the stream the user is most likely speaking into, or -1 if
+         *        none is speaking. Among speaking streams the highest probability wins;
+         *        near-ties go to the best level over noise (the closest microphone).
+         */
+        int MostActive() const;
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint32_t> sequence{0};
+            std::atomic<float> probability{0.0f};
+            std::atomic<float> levelDb{-120.0f};
+            std::atomic<float> noiseDb{-120.0f};
+            std::atomic<float> flatness{0.0f};
+            std::atomic<float> zeroCrossings{0.0f};
+            std::atomic<double> speechSeconds{0.0};
+            std::atomic<uint64_t> updates{0};
+        };
+
+        size_t m_size;
+        std::unique_ptr<Slot[]> m_slots;
+    };
+
+    /**
+     * @brief Voice activity detectors for several capture streams, fed by one thread and
+     *        published to a VoiceActivityBoard.
+     *
+     * Configure() and Process() belong to the feeding thread; the board may be read from
+     * any thread. Processing allocates nothing.
+     */
+    class VoiceActivityBank
+    {
+    public:
+        VoiceActivityBank(size_t streams, const Dsp::VoiceActivityOptions &options = {});
+
+        /**
+         * @brief (Re)starts stream @p index at a new format, clearing what it learnt.
+         * @throws std::out_of_range for a bad index; std::invalid_argument for a bad format.
+         */
+        void Configure(size_t index, uint32_t sampleRate, unsigned channels);
+
+        /**
+         * @brief Feeds @p frames interleaved frames of stream @p index (ignored until
+         *        configured); publishes its state when an analysis frame completes.
+         */
+        void Process(size_t index, const float *input, size_t frames);
+
+        /// Feeds @p frames of digital silence (a packet the engine flagged silent).
+        void ProcessSilence(size_t index, size_t frames);
+
+        size_t Size() const { return m_streams.size(); }
+
+        const VoiceActivityBoard &Board() const { return m_board; }
+
+    private:
+        struct Stream
+        {
+            std::unique_ptr<Dsp::VoiceActivityDetector> detector;
+            unsigned channels = 0;
+            double speechSeconds = 0.0;
+        };
+
+        void Publish(size_t index, Stream &stream, size_t analyzed);
+
+        Dsp::VoiceActivityOptions m_options;
+        std::vector<Stream> m_streams;
+        std::vector<float> m_silence;
+        VoiceActivityBoard m_board;
+    };
+}
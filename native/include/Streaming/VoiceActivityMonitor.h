@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Streaming/SharedModeClient.h"
+#include "Streaming/VoiceActivityBank.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Streaming
+{
+    /**
+     * @brief Options for a VoiceActivityMonitor.
+     */
+    struct VoiceActivityMonitorOptions
+    {
+        std::vector<std::wstring> deviceIds; ///< Capture endpoints; empty = every active capture endpoint.
+        Dsp::VoiceActivityOptions detector;
+    };
+
+    /**
+     * @brief Voice activity of one monitored endpoint.
+     */
+    struct VoiceActivityEndpointStats
+    {
+        std::wstring id;
+        VoiceActivityState state;
+        uint32_t sampleRate = 0;
+        unsigned channels = 0;
+        bool running = false;
+        std::string error; ///< Why this endpoint stopped or never started (device removed, ...), if it did.
+    };
+
+    /**
+     * @brief Counters reported for a running monitor.
+     */
+    struct VoiceActivityMonitorStats
+    {
+        bool running = false;
+        std::string error;        ///< Why the monitor stopped on its own, if it did.
+        int mostActive = -1;      ///< Index into endpoints of VoiceActivityBoard::MostActive(), or -1.
+        double loadPercent = 0.0; ///< Share of one core the analysis thread spends processing.
+        std::vector<VoiceActivityEndpointStats> endpoints;
+    };
+
+    /**
+     * @brief Runs voice activity detection on several capture endpoints at once, on one
+     *        thread, to tell which microphone the user is speaking into.
+     *
+     * Every endpoint is opened in shared mode with its own event; a single thread waits
+     * on all the events, drains whichever streams have packets into a VoiceActivityBank
+     * and so publishes each endpoint's speech probability to the bank's board, which
+     * Stats() reads without locking. An endpoint that fails (e.g. is unplugged) stops
+     * alone; the others keep running. Only 32-bit float mix formats are supported.
+     */
+    class VoiceActivityMonitor
+    {
+    public:
+        explicit VoiceActivityMonitor(VoiceActivityMonitorOptions options);
+        ~VoiceActivityMonitor();
+
+        VoiceActivityMonitor(const VoiceActivityMonitor &) = delete;
+        VoiceActivityMonitor &operator=(const VoiceActivityMonitor &) = delete;
+
+        /**
+         * @brief Opens every endpoint and starts monitoring.
+         * @throws std::runtime_error if no endpoint can be opened, or too many are asked for.
+         */
+        void Start();
+
+        /// Stops monitoring and releases every endpoint. Safe to call more than once.
+        void Stop();
+
+        VoiceActivityMonitorStats Stats() const;
+
+    private:
+        /**
+         * @brief Capture side of one endpoint.
+         */
+        struct Input
+        {
+            std::wstring id;
+            CaptureStream stream;
+            std::atomic<bool> running{false};
+            std::atomic<const char *> error{nullptr};
+        };
+
+        std::vector<std::wstring> ResolveIds() const;
+        static void CloseInput(Input &input);
+        void MonitorLoop();
+        bool Drain(size_t index, Input &input);
+        void Release();
+
+        VoiceActivityMonitorOptions m_options;
+        std::vector<std::unique_ptr<Input>> m_inputs;
+        std::unique_ptr<VoiceActivityBank> m_bank;
+
+        std::thread m_thread;
+        std::atomic<bool> m_running{false};
+        std::atomic<const char *> m_error{nullptr};
+        std::atomic<double> m_load{0.0};
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mutex>
+#include <windows.h>
+#include <objbase.h>
+#include <mmdeviceapi.h>
+
+struct IPolicyConfig;
+
+namespace Utility
+{
+    /**
+     * @brief Lazily created, process-wide Core Audio state shared by all calls.
+     *
+     * Nothing is created when the addon (or CLI) loads. The first call that needs an
+     * enumerator pins the multithreaded apartment with CoIncrementMTAUsage, so cached
+     * objects survive the per-call COMInitializer scopes, and creates the device
+     * enumerator once. Later calls reuse it instead of paying CoCreateInstance each time.
+     */
+    class AudioRuntime
+    {
+    public:
+        /// Returns the process-wide runtime (no COM work is done here).
+        static AudioRuntime &Instance();
+
+        /**
+         * @brief Returns the cached device enumerator, creating it on first use.
+         *
+         * The calling thread must have COM initialized (MTA).
+         *
+         * @return IMMDeviceEnumerator* AddRef'd pointer the caller must release with
+         *         `SafeRelease()`, or nullptr if creation failed.
+         */
+        IMMDeviceEnumerator *AcquireEnumerator();
+
+        /**
+         * @brief Returns the cached IPolicyConfig (default endpoint writes), creating it on
+         *        first use so switching the default costs only the SetDefaultEndpoint call.
+         *
+         * @return IPolicyConfig* AddRef'd pointer the caller must release, or nullptr.
+         */
+        IPolicyConfig *AcquirePolicyConfig();
+
+        /// True once the first native call has set up the runtime.
+        bool IsInitialized() const;
+
+        /**
+         * @brief Drops every cached COM object; the next call recreates them.
+         */
+        void Reset();
+
+    private:
+        AudioRuntime() = default;
+        ~AudioRuntime() = default;
+        AudioRuntime(const AudioRuntime &) = delete;
+        AudioRuntime &operator=(const AudioRuntime &) = delete;
+
+        mutable std::mutex m_mutex;
+        IMMDeviceEnumerator *m_enumerator = nullptr;
+        IPolicyConfig *m_policyConfig = nullptr;
+        CO_MTA_USAGE_COOKIE m_mtaCookie = nullptr;
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Utility
+{
+    /**
+     * @brief Dedicated thread that owns a COM (MTA) apartment and runs queued tasks in order.
+     *
+     * The thread keeps a reference to its own worker object, so a worker that has been
+     * abandoned (e.g. because a driver call never returned) stays alive until the stuck
+     * task finishes and then exits on its own without blocking anyone.
+     */
+    class ComWorker : public std::enable_shared_from_this<ComWorker>
+    {
+    public:
+        /**
+         * @brief Creates a worker and starts its thread.
+         * @return std::shared_ptr<ComWorker> The running worker.
+         */
+        static std::shared_ptr<ComWorker> Create();
+
+        ~ComWorker() = default;
+
+        ComWorker(const ComWorker &) = delete;
+        ComWorker &operator=(const ComWorker &) = delete;
+
+        /**
+         * @brief Queues a task for execution on the worker thread.
+         * @param task Callable to run. Exceptions must be handled inside the task.
+         * @return false if the worker was abandoned and no longer accepts work.
+         */
+        bool Post(std::function<void()> task);
+
+        /**
+         * @brief Stops accepting work. Pending tasks are dropped, the running task (if any)
+         *        is allowed to finish, then the thread exits.
+         */
+        void Abandon();
+
+        /// True while the thread is executing a task.
+        bool IsBusy() const { return m_busy.load(std::memory_order_acquire); }
+
+        /// True once the thread has exited.
+        bool IsFinished() const { return m_finished.load(std::memory_order_acquire); }
+
+    private:
+        ComWorker() = default;
+        void Run();
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_abandoned = false;
+        std::atomic<bool> m_busy{false};
+        std::atomic<bool> m_finished{false};
+    };
+}
@@ -58,4 +58,41 @@ namespace Utility
      * @return true if successful, false otherwise.
      */
     bool MuteDevice(IMMDevice *device, bool mute);
+
+    /**
+     * @brief Opens an audio endpoint directly by its ID, without enumerating.
+     *
+     * Caller is responsible for releasing the returned pointer using `SafeRelease()`.
+     *
+     * @param deviceId The device ID string (from IMMDevice::GetId()).
+     * @return IMMDevice* Pointer to the device, or nullptr if it does not exist.
+     */
+    IMMDevice *GetDeviceById(const std::wstring &deviceId);
+
+    /**
+     * @brief Reads the mute state of the given device.
+     *
+     * @param device Pointer to the IMMDevice to query.
+     * @param[out] mute Receives the current mute state.
+     * @return true if successful, false otherwise.
+     */
+    bool GetDeviceMute(IMMDevice *device, bool &mute);
+
+    /**
+     * @brief Reads the master volume of the given device.
+     *
+     * @param device Pointer to the IMMDevice to query.
+     * @param[out] level Receives the scalar volume in the range 0.0 - 1.0.
+     * @return true if successful, false otherwise.
+     */
+    bool GetDeviceVolume(IMMDevice *device, float &level);
+
+    /**
+     * @brief Sets the master volume of the given device.
+     *
+     * @param device Pointer to the IMMDevice to change.
+     * @param level Scalar volume in the range 0.0 - 1.0 (clamped).
+     * @return true if successful, false otherwise.
+     */
+    bool SetDeviceVolume(IMMDevice *device, float level);
 }
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Utility
+{
+    /**
+     * @brief Counters exposed for diagnostics and tests.
+     */
+    struct EpochStats
+    {
+        uint64_t epoch = 0;     ///< Current global epoch.
+        size_t readers = 0;     ///< Threads registered as readers (exited threads are pruned on reclaim).
+        size_t pending = 0;     ///< Retired objects not yet freed.
+        uint64_t reclaimed = 0; ///< Retired objects freed so far.
+    };
+
+    /**
+     * @brief Epoch-based reclamation for read-mostly data published through atomic pointers.
+     *
+     * Readers Pin() the domain for as long as they dereference a published pointer. A pin
+     * costs one store to a cache line owned by the calling thread; it never locks, waits
+     * or writes shared state, so readers neither contend with each other nor block writers.
+     *
+     * A writer swaps the pointer and Retire()s the old object. Retiring advances the epoch
+     * and tags the object with the epoch it was replaced in; the object is freed once no
+     * reader is pinned at or before that epoch. Writers never wait for readers either: an
+     * object still in use simply stays on the retired list until a later Retire() or
+     * Reclaim() finds it unreferenced.
+     *
+     * Each thread registers a slot the first time it pins a domain (the only lock on the
+     * read path). Pins nest; only the outermost one publishes an epoch.
+     */
+    class EpochDomain
+    {
+        struct ReaderSlot;
+
+    public:
+        /**
+         * @brief Keeps the calling thread pinned until destroyed. Must be destroyed on the
+         *        thread that created it.
+         */
+        class Guard
+        {
+        public:
+            Guard(Guard &&other) noexcept : m_slot(other.m_slot) { other.m_slot = nullptr; }
+            Guard &operator=(Guard &&) = delete;
+            Guard(const Guard &) = delete;
+            ~Guard();
+
+        private:
+            friend class EpochDomain;
+            explicit Guard(ReaderSlot *slot) : m_slot(slot) {}
+
+            ReaderSlot *m_slot;
+        };
+
+        EpochDomain();
+
+        /// Frees everything still retired. No thread may be pinned.
+        ~EpochDomain();
+
+        EpochDomain(const EpochDomain &) = delete;
+        EpochDomain &operator=(const EpochDomain &) = delete;
+
+        /// Process-wide domain shared by all RCU cells that do not bring their own.
+        static EpochDomain &Global();
+
+        /// Pins the calling thread: objects retired from now on are not freed until unpinned.
+        Guard Pin();
+
+        /**
+         * @brief Hands an unlinked object to the domain; @p destroy runs once no reader can
+         *        still hold it. Safe from any thread, including while pinned.
+         */
+        void Retire(void *object, void (*destroy)(void *));
+
+        template <typename T>
+        void Retire(const T *object)
+        {
+            Retire(const_cast<T *>(object), [](void *p)
+                   { delete static_cast<T *>(p); });
+        }
+
+        /// Frees every retired object no pinned reader can reach. Returns how many were freed.
+        size_t Reclaim();
+
+        EpochStats Stats() const;
+
+    private:
+        struct Retired
+        {
+            void *object;
+            void (*destroy)(void *);
+            uint64_t epoch; ///< Epoch in which the object was unlinked.
+        };
+
+        ReaderSlot &LocalSlot();
+
+        const uint64_t m_id;
+        std::atomic<uint64_t> m_epoch{1};
+
+        mutable std::mutex m_mutex; ///< Guards everything below; never taken by a pinned read.
+        std::vector<std::shared_ptr<ReaderSlot>> m_slots;
+        std::vector<Retired> m_retired;
+        uint64_t m_reclaimed = 0;
+    };
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Utility
+{
+    enum class LogLevel : uint8_t
+    {
+        Trace,
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Off,
+    };
+
+    /// Bytes available for encoded arguments in one record.
+    constexpr size_t kLogPayloadCapacity = 224;
+
+    /**
+     * @brief One unformatted log entry as stored in a thread's ring: the format string
+     *        pointer plus its arguments in a small tagged encoding. Fixed-size and trivially
+     *        copyable, so logging neither allocates nor formats on the calling thread.
+     */
+    struct LogRecord
+    {
+        int64_t timeUs;        ///< Wall-clock time, microseconds since the Unix epoch.
+        const char *component; ///< Static string naming the subsystem, e.g. "snapshot".
+        const char *format;    ///< Static printf-style format string.
+        uint32_t threadId;     ///< OS thread id (Windows) or logger-assigned id.
+        LogLevel level;
+        uint8_t truncated; ///< Non-zero if arguments did not fit in the payload.
+        uint16_t size;     ///< Bytes used in `payload`.
+        uint8_t payload[kLogPayloadCapacity];
+    };
+
+    /**
+     * @brief A formatted entry, as handed to sinks.
+     */
+    struct LogEntry
+    {
+        int64_t timeUs = 0;
+        uint32_t threadId = 0;
+        LogLevel level = LogLevel::Info;
+        const char *component = "";
+        std::string message;
+    };
+
+    struct LogThreadBuffer;
+
+    struct LoggerStats
+    {
+        uint64_t written = 0; ///< Entries handed to a sink.
+        uint64_t dropped = 0; ///< Records lost because a thread's ring was full.
+        size_t threads = 0;   ///< Threads with a live ring.
+    };
+
+    namespace LogDetail
+    {
+        /// Argument tags in LogRecord::payload.
+        enum : uint8_t
+        {
+            kSigned = 'i',
+            kUnsigned = 'u',
+            kDouble = 'd',
+            kPointer = 'p',
+            kString = 's',
+            kWideString = 'w',
+        };
+
+        /**
+         * @brief Appends typed arguments to a record. Strings are copied (they may not
+         *        outlive the call); anything that does not fit marks the record truncated.
+         */
+        class ArgWriter
+        {
+        public:
+            explicit ArgWriter(LogRecord &record) : m_record(record) {}
+
+            template <typename T>
+            typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type Add(T value)
+            {
+                if (std::is_signed<T>::value || std::is_enum<T>::value)
+                    Scalar(kSigned, static_cast<int64_t>(value), sizeof(T));
+                else
+                    Scalar(kUnsigned, static_cast<uint64_t>(value), sizeof(T));
+            }
+
+            void Add(float value) { Scalar(kDouble, static_cast<double>(value)); }
+            void Add(double value) { Scalar(kDouble, value); }
+            void Add(const void *value) { Scalar(kPointer, reinterpret_cast<uint64_t>(value)); }
+            void Add(const char *value) { Bytes(kString, value ? value : "(null)", value ? std::strlen(value) : 6, 1); }
+            void Add(char *value) { Add(static_cast<const char *>(value)); }
+            void Add(const std::string &value) { Bytes(kString, value.data(), value.size(), 1); }
+            void Add(const wchar_t *value) { Bytes(kWideString, value ? value : L"(null)", value ? std::wcslen(value) : 6, sizeof(wchar_t)); }
+            void Add(wchar_t *value) { Add(static_cast<const wchar_t *>(value)); }
+            void Add(const std::wstring &value) { Bytes(kWideString, value.data(), value.size(), sizeof(wchar_t)); }
+
+        private:
+            /// Tag, width of the original type in bytes (so %x of a negative int stays 32-bit), value.
+            template <typename T>
+            void Scalar(uint8_t tag, T value, size_t width = sizeof(T))
+            {
+                if (m_record.size + 2 + sizeof(T) > kLogPayloadCapacity)
+                {
+                    m_record.truncated = 1;
+                    return;
+                }
+                m_record.payload[m_record.size] = tag;
+                m_record.payload[m_record.size + 1] = static_cast<uint8_t>(width);
+                std::memcpy(&m_record.payload[m_record.size + 2], &value, sizeof(T));
+                m_record.size = static_cast<uint16_t>(m_record.size + 2 + sizeof(T));
+            }
+
+            void Bytes(uint8_t tag, const void *data, size_t count, size_t unit)
+            {
+                const size_t header = 1 + sizeof(uint16_t);
+                if (m_record.size + header > kLogPayloadCapacity)
+                {
+                    m_record.truncated = 1;
+                    return;
+                }
+                const size_t room = (kLogPayloadCapacity - m_record.size - header) / unit;
+                if (count > room)
+                {
+                    count = room;
+                    m_record.truncated = 1;
+                }
+                const uint16_t length = static_cast<uint16_t>(count);
+                m_record.payload[m_record.size] = tag;
+                std::memcpy(&m_record.payload[m_record.size + 1], &length, sizeof(length));
+                std::memcpy(&m_record.payload[m_record.size + header], data, count * unit);
+                m_record.size = static_cast<uint16_t>(m_record.size + header + count * unit);
+            }
+
+            LogRecord &m_record;
+        };
+    }
+
+    /**
+     * @brief Structured logger whose hot path is a level check plus a copy into a
+     *        per-thread lock-free ring.
+     *
+     * Logging is off by default: with the level at Off, AUDIO_LOG costs one relaxed
+     * atomic load and its arguments are not evaluated. Otherwise the caller stores the
+     * format pointer and its raw arguments in its own ring (registered once, on the
+     * thread's first record); formatting happens on a background thread that drains all
+     * rings every few milliseconds into the sink. Records that do not fit in a full ring
+     * are counted and dropped rather than blocking the caller. Order is preserved per
+     * thread; across threads, entries of one drain pass are sorted by time.
+     *
+     * Format strings use printf conversions (%d %u %x %f %g %s %c %p ...; length modifiers
+     * are ignored because arguments carry their own type). `%s` accepts narrow and wide
+     * strings; wide strings are emitted as UTF-8. The format string and component must be
+     * string literals.
+     */
+    class Logger
+    {
+    public:
+        /// Receives drained, formatted entries on the logger thread.
+        using Sink = std::function<void(const std::vector<LogEntry> &entries)>;
+
+        /**
+         * @param bufferRecords Capacity of each thread's ring.
+         * @param drainInterval How often the background thread drains the rings.
+         */
+        explicit Logger(size_t bufferRecords = 256,
+                        std::chrono::milliseconds drainInterval = std::chrono::milliseconds(20));
+
+        /// Drains what is left, then stops the background thread.
+        ~Logger();
+
+        Logger(const Logger &) = delete;
+        Logger &operator=(const Logger &) = delete;
+
+        /// Process-wide logger used by AUDIO_LOG. Never destroyed.
+        static Logger &Instance();
+
+        /// True if records at @p level are currently kept.
+        bool Enabled(LogLevel level) const
+        {
+            return level >= m_level.load(std::memory_order_relaxed);
+        }
+
+        /// Sets the minimum level kept; starts the background thread on first enable.
+        void SetLevel(LogLevel level);
+        LogLevel Level() const { return m_level.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Replaces the sink. Once this returns the previous sink is never called
+         *        again. An empty sink discards entries.
+         */
+        void SetSink(Sink sink);
+
+        /**
+         * @brief Sink that appends one text line per entry to @p path.
+         * @return Empty Sink if the file cannot be opened.
+         */
+        static Sink FileSink(const std::string &path);
+
+        /// Records a message. Prefer AUDIO_LOG, which skips argument evaluation when disabled.
+        template <typename... Args>
+        void Write(LogLevel level, const char *component, const char *format, const Args &...args)
+        {
+            if (!Enabled(level))
+                return;
+            LogRecord record;
+            Begin(record, level, component, format);
+            LogDetail::ArgWriter writer(record);
+            (void)writer;
+            (writer.Add(args), ...);
+            Commit(record);
+        }
+
+        /// Drains every ring into the sink on the calling thread.
+        void Flush();
+
+        LoggerStats Stats() const;
+
+        static const char *LevelName(LogLevel level);
+
+        /// Parses "trace" … "error" / "off"; returns false for anything else.
+        static bool ParseLevel(const std::string &name, LogLevel &level);
+
+        /// Expands a record's format string with its stored arguments.
+        static std::string FormatMessage(const LogRecord &record);
+
+        /// Formats an entry as `2025-01-31T12:00:00.123456Z info  [component] (tid) message`.
+        static std::string FormatLine(const LogEntry &entry);
+
+    private:
+        void Begin(LogRecord &record, LogLevel level, const char *component, const char *format);
+        void Commit(LogRecord &record);
+        LogThreadBuffer &CurrentBuffer();
+        void StartThread();
+        void Run();
+        void DrainLocked();
+
+        const uint64_t m_instanceId;
+        const size_t m_bufferRecords;
+        const std::chrono::milliseconds m_drainInterval;
+
+        std::atomic<LogLevel> m_level{LogLevel::Off};
+        std::atomic<uint64_t> m_dropped{0};
+
+        mutable std::mutex m_buffersMutex;
+        std::vector<std::shared_ptr<LogThreadBuffer>> m_buffers;
+
+        mutable std::mutex m_drainMutex; ///< Serializes ring consumers and sink calls.
+        Sink m_sink;
+        std::vector<LogRecord> m_scratch;
+        std::vector<LogEntry> m_entries;
+        uint64_t m_written = 0;
+
+        std::mutex m_threadMutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+        std::thread m_thread;
+    };
+}
+
+/**
+ * @brief Logs through the process-wide logger, e.g.
+ *        `AUDIO_LOG(Warn, "snapshot", "Device %s not found", deviceId);`
+ *        Arguments are only evaluated when the level is enabled.
+ */
+#define AUDIO_LOG(level, component, ...)                                           \
+    do                                                                             \
+    {                                                                              \
+        ::Utility::Logger &audioLogger = ::Utility::Logger::Instance();             \
+        if (audioLogger.Enabled(::Utility::LogLevel::level))                       \
+            audioLogger.Write(::Utility::LogLevel::level, component, __VA_ARGS__); \
+    } while (0)
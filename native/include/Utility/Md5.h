@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Utility
+{
+    /**
+     * @brief Incremental MD5 (RFC 1321), as FLAC stores over the decoded samples.
+     *
+     * Not for anything security related: it only detects accidental corruption.
+     */
+    class Md5
+    {
+    public:
+        Md5() { Reset(); }
+
+        void Reset();
+
+        /// Hashes @p bytes more bytes.
+        void Update(const void *data, size_t bytes);
+
+        /// Writes the digest of everything hashed so far. The state is left unchanged.
+        void Finish(uint8_t digest[16]) const;
+
+    private:
+        void Transform(const uint8_t *block);
+
+        uint32_t m_state[4];
+        uint64_t m_length = 0; ///< Bytes hashed.
+        uint8_t m_buffer[64];
+    };
+}
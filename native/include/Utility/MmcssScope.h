@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Windows.h>
+#include <avrt.h>
+
+namespace Utility
+{
+    /**
+     * @brief Joins an MMCSS task (e.g. "Pro Audio", "Audio") for the lifetime of the object.
+     *
+     * Registration is best effort: if the task is unknown or the service refuses, the
+     * thread keeps its normal priority and Active() returns false.
+     */
+    class MmcssScope
+    {
+    public:
+        explicit MmcssScope(const wchar_t *task = L"Pro Audio")
+        {
+            DWORD taskIndex = 0;
+            if (task && *task)
+                m_handle = AvSetMmThreadCharacteristicsW(task, &taskIndex);
+        }
+
+        ~MmcssScope()
+        {
+            if (m_handle)
+                AvRevertMmThreadCharacteristics(m_handle);
+        }
+
+        MmcssScope(const MmcssScope &) = delete;
+        MmcssScope &operator=(const MmcssScope &) = delete;
+
+        /// True if the thread is registered with the task.
+        bool Active() const { return m_handle != nullptr; }
+
+    private:
+        HANDLE m_handle = nullptr;
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace Utility
+{
+    /**
+     * @brief Unbounded lock-free multi-producer / single-consumer queue.
+     *
+     * Any number of threads may call Push(); exactly one thread may call TryPop(). Push is
+     * wait-free (one exchange and one store) and never blocks behind the consumer, which
+     * makes it safe to call from COM callback threads. Nodes are linked through a stub so
+     * the consumer never touches the producers' end.
+     *
+     * A push is visible to the consumer only once its link store completes; until then
+     * TryPop() may report empty even though Size() already counts the element.
+     *
+     * @tparam T Movable, default-constructible element type.
+     */
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue()
+            : m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed))
+        {
+        }
+
+        ~MpscQueue()
+        {
+            T discarded;
+            while (TryPop(discarded))
+            {
+            }
+            delete m_tail;
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        /// Appends an element. Safe from any thread.
+        void Push(T value)
+        {
+            Node *node = new Node();
+            node->value = std::move(value);
+
+            const size_t depth = m_size.fetch_add(1) + 1;
+            size_t highWater = m_highWater.load(std::memory_order_relaxed);
+            while (depth > highWater &&
+                   !m_highWater.compare_exchange_weak(highWater, depth, std::memory_order_relaxed))
+            {
+            }
+
+            Node *previous = m_head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        /// Removes the oldest element. Consumer thread only.
+        bool TryPop(T &out)
+        {
+            Node *tail = m_tail;
+            Node *next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            out = std::move(next->value);
+            m_tail = next;
+            delete tail;
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Elements pushed but not yet popped (approximate while producers are active).
+         *        Counted before the element is linked, with sequentially consistent
+         *        ordering, so a consumer can use it to decide whether it may go to sleep.
+         */
+        size_t Size() const { return m_size.load(); }
+
+        /// Largest Size() observed since construction or the last ResetHighWater().
+        size_t HighWater() const { return m_highWater.load(std::memory_order_relaxed); }
+
+        /// Restarts high-water tracking from the current depth.
+        void ResetHighWater() { m_highWater.store(Size(), std::memory_order_relaxed); }
+
+    private:
+        struct Node
+        {
+            std::atomic<Node *> next{nullptr};
+            T value{};
+        };
+
+        alignas(64) std::atomic<Node *> m_head; ///< Producers' end (most recent node).
+        alignas(64) Node *m_tail;               ///< Consumer's end (already-consumed stub).
+        alignas(64) std::atomic<size_t> m_size{0};
+        std::atomic<size_t> m_highWater{0};
+    };
+}
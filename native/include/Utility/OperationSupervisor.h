@@ -0,0 +1,184 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "AudioSwitcher/EndpointKey.h"
+#include "Utility/ComWorker.h"
+
+namespace Utility
+{
+    /**
+     * @brief Health classification of a device (or pseudo-device key such as "default:render").
+     */
+    enum class DeviceHealthState
+    {
+        Healthy, ///< Last call completed well within the deadline.
+        Slow,    ///< Last call took more than half the deadline, or recovered from a hang.
+        Hung     ///< A call exceeded the deadline and has not returned yet.
+    };
+
+    /**
+     * @brief Health record tracked per device key by the OperationSupervisor.
+     */
+    struct DeviceHealth
+    {
+        DeviceHealthState state = DeviceHealthState::Healthy;
+        uint32_t timeouts = 0;     ///< Number of calls that exceeded the deadline.
+        double lastLatencyMs = 0;  ///< Latency of the last completed call.
+        bool pending = false;      ///< True while a timed-out call is still stuck in the driver.
+        std::chrono::steady_clock::time_point hungSince{};
+    };
+
+    /**
+     * @brief Thrown when a supervised call does not complete before its deadline.
+     */
+    class OperationTimeoutError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * @brief Thrown without touching the driver when a device is known to be hung.
+     */
+    class DeviceHungError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * @brief Watchdog that runs native calls on a COM worker thread with a deadline.
+     *
+     * With a timeout of 0 (the default) calls run inline on the calling thread, exactly as
+     * before. With a positive timeout each call is posted to a ComWorker; if it misses its
+     * deadline the caller gets an OperationTimeoutError, the stuck worker is quarantined and
+     * replaced, and the device key is marked Hung so further calls fail fast with
+     * DeviceHungError until the stuck call returns or the probe interval elapses.
+     */
+    class OperationSupervisor
+    {
+    public:
+        /// Returns the process-wide supervisor.
+        static OperationSupervisor &Instance();
+
+        /**
+         * @brief Sets the per-call deadline. 0 disables supervision.
+         */
+        void SetTimeout(std::chrono::milliseconds timeout);
+
+        /// Current per-call deadline (0 = supervision disabled).
+        std::chrono::milliseconds GetTimeout() const;
+
+        /**
+         * @brief Runs @p fn under the watchdog.
+         *
+         * @param deviceKey Key used for health tracking (device id or pseudo key); interned
+         *        once per call and tracked by its EndpointKey.
+         * @param fn Callable returning a value. It must own everything it touches (capture
+         *           by value), because it may outlive the caller after a timeout.
+         * @return Whatever @p fn returns.
+         * @throws OperationTimeoutError if the deadline is missed.
+         * @throws DeviceHungError if the device is currently marked Hung.
+         * @throws Any exception thrown by @p fn.
+         */
+        template <typename Fn>
+        auto Run(const std::wstring &deviceKey, Fn fn) -> std::invoke_result_t<Fn &>;
+
+        /**
+         * @brief Returns a copy of the health table.
+         */
+        std::vector<std::pair<std::wstring, DeviceHealth>> GetHealth() const;
+
+        /**
+         * @brief Forgets the health record of a device so it is tried again immediately.
+         */
+        void ResetHealth(const std::wstring &deviceKey);
+
+    private:
+        OperationSupervisor() = default;
+
+        void CheckHealth(AudioSwitcher::EndpointKey key);
+        std::shared_ptr<ComWorker> AcquireWorker();
+        void QuarantineWorker(const std::shared_ptr<ComWorker> &worker);
+        void RecordCompletion(AudioSwitcher::EndpointKey key, double latencyMs);
+        void RecordTimeout(AudioSwitcher::EndpointKey key);
+        void RecordLateCompletion(AudioSwitcher::EndpointKey key, double latencyMs);
+
+        mutable std::mutex m_mutex;
+        std::chrono::milliseconds m_timeout{0};
+        std::shared_ptr<ComWorker> m_worker;
+        std::vector<std::shared_ptr<ComWorker>> m_quarantined;
+        std::unordered_map<AudioSwitcher::EndpointKey, DeviceHealth, AudioSwitcher::EndpointKeyHash> m_health;
+    };
+
+    template <typename Fn>
+    auto OperationSupervisor::Run(const std::wstring &deviceKey, Fn fn) -> std::invoke_result_t<Fn &>
+    {
+        using Result = std::invoke_result_t<Fn &>;
+
+        const std::chrono::milliseconds timeout = GetTimeout();
+        if (timeout.count() <= 0)
+            return fn();
+
+        const AudioSwitcher::EndpointKey key = AudioSwitcher::EndpointKey::Intern(deviceKey);
+        CheckHealth(key);
+
+        struct CallState
+        {
+            std::mutex mutex;
+            bool finished = false;
+            bool abandoned = false;
+        };
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        std::future<Result> future = task->get_future();
+        auto call = std::make_shared<CallState>();
+        const auto start = std::chrono::steady_clock::now();
+
+        std::shared_ptr<ComWorker> worker = AcquireWorker();
+        bool posted = worker->Post([this, task, call, key, start]()
+                                   {
+            (*task)();
+            bool abandoned = false;
+            {
+                std::lock_guard<std::mutex> lock(call->mutex);
+                call->finished = true;
+                abandoned = call->abandoned;
+            }
+            if (abandoned)
+            {
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                RecordLateCompletion(key, elapsed.count());
+            } });
+        if (!posted)
+            throw std::runtime_error("[x] Native worker is unavailable.");
+
+        if (future.wait_for(timeout) != std::future_status::ready)
+        {
+            std::unique_lock<std::mutex> lock(call->mutex);
+            // The task may have finished between wait_for and taking the lock.
+            if (!call->finished)
+            {
+                call->abandoned = true;
+                RecordTimeout(key);
+                lock.unlock();
+                QuarantineWorker(worker);
+                throw OperationTimeoutError("[x] Native audio call timed out after " +
+                                            std::to_string(timeout.count()) + " ms.");
+            }
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        RecordCompletion(key, elapsed.count());
+        return future.get();
+    }
+}
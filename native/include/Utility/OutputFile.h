@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Utility
+{
+    /**
+     * @brief A file written with positioned writes: no shared file pointer, so data can be
+     *        appended by one thread while another rewrites a header, and no stdio
+     *        buffering between the caller's (large, aligned) blocks and the OS.
+     */
+    class OutputFile
+    {
+    public:
+        OutputFile() = default;
+        ~OutputFile();
+
+        OutputFile(const OutputFile &) = delete;
+        OutputFile &operator=(const OutputFile &) = delete;
+
+        /**
+         * @brief Creates (or truncates) @p path, a UTF-8 path. Closes any file already open.
+         * @return False if the file cannot be created.
+         */
+        bool Open(const std::string &path);
+
+        bool IsOpen() const;
+
+        /**
+         * @brief Writes @p bytes at @p offset, retrying short writes.
+         * @return False on an I/O error (disk full, device gone, ...).
+         */
+        bool WriteAt(uint64_t offset, const void *data, size_t bytes);
+
+        /// Flushes written data and metadata to the device (fsync / FlushFileBuffers).
+        bool Sync();
+
+        /// Closes the file. Safe to call more than once.
+        void Close();
+
+    private:
+#ifdef _WIN32
+        void *m_handle = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+}
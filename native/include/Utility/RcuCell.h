@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Utility/EpochDomain.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace Utility
+{
+    /**
+     * @brief Holds one immutable object that readers access without locks while writers
+     *        replace it (read-copy-update).
+     *
+     * Read() pins the epoch domain and loads the pointer; the object stays valid until the
+     * returned guard is destroyed, even if a writer publishes a replacement meanwhile.
+     * Publish() swaps the pointer and retires the previous object, which the domain frees
+     * once no reader can still see it. Neither side ever waits for the other.
+     *
+     * Publish() itself is safe from any thread. A read-modify-write (copy the current
+     * object, edit, publish) needs the writers to be serialized by the caller.
+     *
+     * @tparam T Type of the published object; readers only ever see `const T`.
+     */
+    template <typename T>
+    class RcuCell
+    {
+    public:
+        /**
+         * @brief Pinned view of the object current at the time of Read(). Empty if nothing
+         *        was published. Must be destroyed on the thread that created it.
+         */
+        class ReadGuard
+        {
+        public:
+            const T *get() const { return m_value; }
+            const T &operator*() const { return *m_value; }
+            const T *operator->() const { return m_value; }
+            explicit operator bool() const { return m_value != nullptr; }
+
+        private:
+            friend class RcuCell;
+            ReadGuard(EpochDomain::Guard &&pin, const T *value) : m_pin(std::move(pin)), m_value(value) {}
+
+            EpochDomain::Guard m_pin;
+            const T *m_value;
+        };
+
+        explicit RcuCell(EpochDomain &domain = EpochDomain::Global()) : m_domain(domain) {}
+
+        /// Deletes the current object directly; no reader may be active.
+        ~RcuCell() { delete m_value.load(std::memory_order_acquire); }
+
+        RcuCell(const RcuCell &) = delete;
+        RcuCell &operator=(const RcuCell &) = delete;
+
+        /// Lock-free read of the current object.
+        ReadGuard Read() const
+        {
+            EpochDomain::Guard pin = m_domain.Pin();
+            return ReadGuard(std::move(pin), m_value.load());
+        }
+
+        /// Replaces the current object (nullptr clears it) and retires the old one.
+        void Publish(std::unique_ptr<const T> value)
+        {
+            const T *previous = m_value.exchange(value.release());
+            if (previous)
+                m_domain.Retire(previous);
+        }
+
+        void Publish(T value) { Publish(std::unique_ptr<const T>(new T(std::move(value)))); }
+
+        void Reset() { Publish(std::unique_ptr<const T>()); }
+
+    private:
+        EpochDomain &m_domain;
+        std::atomic<const T *> m_value{nullptr};
+    };
+}
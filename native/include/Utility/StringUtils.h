@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace Utility
+{
+    /**
+     * @brief Converts a wide Unicode string (std::wstring) to a UTF-8 encoded std::string.
+     *
+     * @param wstr The wide-character string to convert.
+     * @return std::string UTF-8 encoded version of the input.
+     */
+    std::string WStringToUtf8(const std::wstring &wstr);
+
+    /**
+     * @brief Converts a UTF-8 encoded string to a wide character string.
+     *
+     * @param str The input UTF-8 encoded string to convert.
+     * @return std::wstring The converted wide character string.
+     */
+    std::wstring Utf8ToWString(const std::string &str);
+}
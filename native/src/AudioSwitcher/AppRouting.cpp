@@ -0,0 +1,146 @@
+#include "AudioSwitcher/AppRouting.h"
+
+#include <cwctype>
+#include <iterator>
+#include <unordered_set>
+
+namespace AudioSwitcher
+{
+    AppRoutingTable::AppRoutingTable(std::shared_ptr<AppPolicy> policy)
+        : m_policy(std::move(policy))
+    {
+    }
+
+    std::wstring AppRoutingTable::NormalizeExe(const std::wstring &exe)
+    {
+        const size_t slash = exe.find_last_of(L"\\/");
+        std::wstring name = slash == std::wstring::npos ? exe : exe.substr(slash + 1);
+        for (wchar_t &c : name)
+            c = static_cast<wchar_t>(std::towlower(c));
+        return name;
+    }
+
+    AppBatchResult AppRoutingTable::Apply(const std::vector<AppAssignment> &assignments)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return ApplyLocked(assignments);
+    }
+
+    AppBatchResult AppRoutingTable::Reconcile()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<AppAssignment> assignments;
+        assignments.reserve(m_routes.size());
+        for (const auto &entry : m_routes)
+            assignments.push_back(entry.second.assignment);
+        return ApplyLocked(assignments);
+    }
+
+    AppBatchResult AppRoutingTable::ApplyLocked(const std::vector<AppAssignment> &assignments)
+    {
+        AppBatchResult result;
+
+        // Later entries for the same app, flow and role win; keep first-seen order otherwise
+        std::vector<const AppAssignment *> batch;
+        std::map<RouteKey, size_t> positions;
+        bool byExe = false;
+        for (const AppAssignment &assignment : assignments)
+        {
+            const RouteKey key{assignment.target.pid, assignment.target.exe, assignment.flow, assignment.role};
+            auto inserted = positions.emplace(key, batch.size());
+            if (inserted.second)
+                batch.push_back(&assignment);
+            else
+                batch[inserted.first->second] = &assignment;
+            byExe = byExe || assignment.target.pid == 0;
+        }
+
+        // One process listing serves every executable in the batch, and tells which
+        // processes have exited so their entries can be dropped
+        std::vector<AppProcess> processes;
+        const bool listed = byExe && m_policy->ListProcesses(processes);
+        if (listed)
+        {
+            std::unordered_set<uint32_t> alive;
+            for (const AppProcess &process : processes)
+                alive.insert(process.pid);
+            for (auto it = m_written.begin(); it != m_written.end();)
+                it = alive.count(std::get<0>(it->first)) ? std::next(it) : m_written.erase(it);
+        }
+
+        for (const AppAssignment *assignment : batch)
+        {
+            AppRoute route{*assignment, {}, 0};
+            if (assignment->target.pid != 0)
+                route.pids.push_back(assignment->target.pid);
+            else if (listed)
+            {
+                for (const AppProcess &process : processes)
+                {
+                    if (process.exe == assignment->target.exe)
+                        route.pids.push_back(process.pid);
+                }
+            }
+            if (route.pids.empty())
+                ++result.unresolved;
+
+            for (uint32_t pid : route.pids)
+            {
+                const WriteKey writeKey{pid, assignment->flow, assignment->role};
+                auto written = m_written.find(writeKey);
+                if (written != m_written.end() && written->second == assignment->deviceId)
+                {
+                    ++result.unchanged;
+                    continue;
+                }
+
+                const int32_t status = m_policy->SetEndpoint(pid, assignment->flow, assignment->role, assignment->deviceId);
+                if (status < 0)
+                {
+                    ++result.failed;
+                    result.lastError = route.status = status;
+                    if (written != m_written.end())
+                        m_written.erase(written); // state unknown now
+                    continue;
+                }
+                ++result.applied;
+                m_written[writeKey] = assignment->deviceId;
+            }
+
+            const RouteKey key{assignment->target.pid, assignment->target.exe, assignment->flow, assignment->role};
+            if (assignment->deviceId.empty())
+                m_routes.erase(key); // back on the system default: nothing left to remember
+            else
+                m_routes[key] = std::move(route);
+        }
+        return result;
+    }
+
+    std::vector<AppRoute> AppRoutingTable::Routes() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<AppRoute> routes;
+        routes.reserve(m_routes.size());
+        for (const auto &entry : m_routes)
+            routes.push_back(entry.second);
+        return routes;
+    }
+
+    int32_t AppRoutingTable::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const int32_t status = m_policy->ClearAll();
+        if (status >= 0)
+        {
+            m_routes.clear();
+            m_written.clear();
+        }
+        return status;
+    }
+
+    void AppRoutingTable::Invalidate()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_written.clear();
+    }
+}
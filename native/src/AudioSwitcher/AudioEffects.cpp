@@ -0,0 +1,66 @@
+#include "AudioSwitcher/AudioEffects.h"
+#include "Utility/SafeRelease.h"
+
+#include <spatialaudioclient.h>
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        // {1DA5D803-D492-4EDD-8C23-E0C0FFEE7F0E},5 : PKEY_AudioEndpoint_Disable_SysFx (VT_UI4, 1 = disabled)
+        const PROPERTYKEY PKEY_DisableSysFx = {
+            {0x1da5d803, 0xd492, 0x4edd, {0x8c, 0x23, 0xe0, 0xc0, 0xff, 0xee, 0x7f, 0x0e}}, 5};
+
+        /**
+         * @brief Reads the "Disable all enhancements" flag. Endpoints without enhancement
+         *        APOs usually do not have the value at all.
+         */
+        EffectState ReadEnhancements(IPropertyStore *store)
+        {
+            EffectState state = EffectState::Unknown;
+            PROPVARIANT prop;
+            PropVariantInit(&prop);
+            if (SUCCEEDED(store->GetValue(PKEY_DisableSysFx, &prop)) && prop.vt == VT_UI4)
+                state = prop.ulVal != 0 ? EffectState::Disabled : EffectState::Enabled;
+            PropVariantClear(&prop);
+            return state;
+        }
+
+        /**
+         * @brief Asks the spatial audio client whether object streams are available, which
+         *        is the case exactly when the user selected a spatial sound format.
+         */
+        EffectState ReadSpatialAudio(IMMDevice *device, uint32_t &maxObjects)
+        {
+            ISpatialAudioClient *client = nullptr;
+            HRESULT hr = device->Activate(__uuidof(ISpatialAudioClient), CLSCTX_INPROC_SERVER, nullptr, (void **)&client);
+            if (FAILED(hr) || !client)
+                return EffectState::Unknown; // Pre-1703 Windows or a driver without support
+
+            EffectState state = EffectState::Disabled;
+            if (client->IsSpatialAudioStreamAvailable(__uuidof(ISpatialAudioObjectRenderStream), nullptr) == S_OK)
+            {
+                state = EffectState::Enabled;
+                UINT32 count = 0;
+                if (SUCCEEDED(client->GetMaxDynamicObjectCount(&count)))
+                    maxObjects = count;
+            }
+            Utility::SafeRelease(client);
+            return state;
+        }
+    }
+
+    /**
+     * @brief Reads enhancement and spatial audio state of one endpoint.
+     */
+    EffectsInfo ReadEffects(IMMDevice *device, IPropertyStore *store, EDataFlow flow)
+    {
+        EffectsInfo info;
+        if (store)
+            info.enhancements = ReadEnhancements(store);
+        if (device && flow == eRender)
+            info.spatialAudio = ReadSpatialAudio(device, info.spatialMaxObjects);
+        info.loaded = true;
+        return info;
+    }
+}
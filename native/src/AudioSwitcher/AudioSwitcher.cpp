@@ -1,9 +1,12 @@
 #include "AudioSwitcher/AudioSwitcher.h"
 #include "AudioSwitcher/IPolicyConfig.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/Logger.h"
+#include "Utility/SafeRelease.h"
 
 #include <mmdeviceapi.h>
 #include <functiondiscoverykeys_devpkey.h>
-#include <iostream>
 #include <comdef.h>
 
 namespace AudioSwitcher
@@ -15,6 +18,7 @@ namespace AudioSwitcher
      *
      * @return std::vector<AudioDevice> A list of devices with their IDs and friendly names.
      *
+     * @throws ServiceLostError If the Windows Audio service is not running (recovery is scheduled).
      * @throws std::runtime_error If any COM operation fails (enumeration, property access, etc.).
      */
     std::vector<AudioDevice> AudioManager::listOutputDevices()
@@ -29,16 +33,18 @@ namespace AudioSwitcher
 
         try
         {
-            // Create an instance of the device enumerator
-            HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
-                                          __uuidof(IMMDeviceEnumerator), (void **)&pEnum);
-            if (FAILED(hr))
+            // Get the shared device enumerator (created lazily on first use)
+            pEnum = Utility::AudioRuntime::Instance().AcquireEnumerator();
+            if (!pEnum)
                 throw std::runtime_error("[x] Failed to create device enumerator.");
 
             // Get all active render (playback) devices
-            hr = pEnum->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &pDevices);
+            HRESULT hr = pEnum->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &pDevices);
             if (FAILED(hr))
+            {
+                ServiceRecovery::Instance().ThrowIfLost(hr, "Failed to enumerate audio endpoints");
                 throw std::runtime_error("[x] Failed to enumerate audio endpoints.");
+            }
 
             // Get the number of playback devices
             UINT count = 0;
@@ -57,12 +63,16 @@ namespace AudioSwitcher
                 // Get the i-th device
                 hr = pDevices->Item(i, &pDevice);
                 if (FAILED(hr))
+                {
+                    AUDIO_LOG(Debug, "audioswitcher", "Skipping endpoint %u: Item failed (hr=0x%08lX)", i, hr);
                     continue; // Skip if failed
+                }
 
                 // Get the unique device ID (used for switching)
                 hr = pDevice->GetId(&deviceId);
                 if (FAILED(hr) && pDevice)
                 {
+                    AUDIO_LOG(Debug, "audioswitcher", "Skipping endpoint %u: GetId failed (hr=0x%08lX)", i, hr);
                     pDevice->Release();
                     continue;
                 }
@@ -85,6 +95,7 @@ namespace AudioSwitcher
                     // Successfully gathered all info: add to device list
                     AudioDevice device;
                     device.id = deviceId;
+                    device.key = EndpointKey::Intern(device.id);
                     device.name = prop.pwszVal;
                     device.device = pDevice; // Store raw pointer for future use
 
@@ -119,7 +130,8 @@ namespace AudioSwitcher
                 pEnum->Release();
             // CoUninitialize();
 
-            throw std::runtime_error(e.what());
+            AUDIO_LOG(Error, "audioswitcher", "Listing output devices failed: %s", e.what());
+            throw;
         }
     }
 
@@ -135,6 +147,7 @@ namespace AudioSwitcher
      * @param deviceId The unique device ID string (from IMMDevice::GetId()).
      * @return true if the operation was successful for all roles.
      * @return false if initialization or switching failed.
+     * @throws ServiceLostError If the Windows Audio service is not running (recovery is scheduled).
      */
     bool AudioManager::setDefaultOutputDevice(const std::wstring &deviceId)
     {
@@ -155,7 +168,10 @@ namespace AudioSwitcher
                                   __uuidof(IPolicyConfig), (LPVOID *)&pPolicyConfig);
 
             if (FAILED(hr) || !pPolicyConfig)
+            {
+                ServiceRecovery::Instance().ThrowIfLost(hr, "Failed to create IPolicyConfig COM object");
                 throw std::runtime_error("[x] Failed to create IPolicyConfig COM object.");
+            }
 
             // Set the selected device as the default for all 3 roles
             HRESULT hr1 = pPolicyConfig->SetDefaultEndpoint(deviceId.c_str(), eConsole);
@@ -163,19 +179,62 @@ namespace AudioSwitcher
             HRESULT hr3 = pPolicyConfig->SetDefaultEndpoint(deviceId.c_str(), eCommunications);
 
             pPolicyConfig->Release();
+            pPolicyConfig = nullptr;
             // CoUninitialize();
 
+            if (FAILED(hr1) || FAILED(hr2) || FAILED(hr3))
+            {
+                AUDIO_LOG(Warn, "audioswitcher", "SetDefaultEndpoint failed (console=0x%08lX, multimedia=0x%08lX, communications=0x%08lX)",
+                          hr1, hr2, hr3);
+                ServiceRecovery::Instance().ThrowIfLost(FAILED(hr1) ? hr1 : FAILED(hr2) ? hr2 : hr3, "Failed to set default endpoint");
+            }
+
             // Return true only if all 3 roles succeeded
             return SUCCEEDED(hr1) && SUCCEEDED(hr2) && SUCCEEDED(hr3);
         }
+        catch (const ServiceLostError &)
+        {
+            if (pPolicyConfig)
+                pPolicyConfig->Release();
+            throw;
+        }
         catch (const std::exception &e)
         {
             if (pPolicyConfig)
                 pPolicyConfig->Release();
             // CoUninitialize();
 
-            std::wcerr << L"[x] Error: " << e.what() << L"\n";
+            AUDIO_LOG(Error, "audioswitcher", "%s", e.what());
             return false;
         }
     }
+
+    /**
+     * @brief Sets the default endpoint for one role with a single SetDefaultEndpoint call.
+     *
+     * Unlike setDefaultOutputDevice(), the policy-config object is reused across calls
+     * and only the requested role changes, so "switch back" costs one COM call.
+     *
+     * @param deviceId The endpoint ID (render or capture).
+     * @param role     eConsole, eMultimedia or eCommunications.
+     * @return true if the default was changed.
+     */
+    bool AudioManager::setDefaultEndpoint(const std::wstring &deviceId, ERole role)
+    {
+        IPolicyConfig *pPolicyConfig = Utility::AudioRuntime::Instance().AcquirePolicyConfig();
+        if (!pPolicyConfig)
+        {
+            AUDIO_LOG(Error, "audioswitcher", "Failed to create IPolicyConfig COM object.");
+            return false;
+        }
+
+        const HRESULT hr = pPolicyConfig->SetDefaultEndpoint(deviceId.c_str(), role);
+        Utility::SafeRelease(pPolicyConfig);
+        if (FAILED(hr))
+        {
+            AUDIO_LOG(Warn, "audioswitcher", "SetDefaultEndpoint failed (role=%d, hr=0x%08lX)", static_cast<int>(role), hr);
+            ServiceRecovery::Instance().ThrowIfLost(hr, "Failed to set default endpoint");
+        }
+        return SUCCEEDED(hr);
+    }
 } // namespace AudioSwitcher
@@ -0,0 +1,95 @@
+#include "AudioSwitcher/DefaultHistory.h"
+
+#include <algorithm>
+
+namespace AudioSwitcher
+{
+    DefaultHistory &DefaultHistory::Instance()
+    {
+        static DefaultHistory *history = new DefaultHistory();
+        return *history;
+    }
+
+    bool DefaultHistory::Record(uint8_t flow, uint8_t role, const EndpointKey &key)
+    {
+        if (!InRange(flow, role) || key.Empty())
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Slot &slot = m_slots[flow][role];
+        auto begin = slot.entries.begin();
+        auto end = begin + slot.count;
+        auto it = std::find(begin, end, key);
+        if (it == begin && slot.count > 0)
+            return false;
+
+        if (it == end)
+        {
+            // New entry: the oldest falls off once the list is full
+            if (slot.count < kDepth)
+                ++slot.count;
+            it = begin + slot.count - 1;
+            *it = key;
+        }
+        std::rotate(begin, it, it + 1);
+        return true;
+    }
+
+    EndpointKey DefaultHistory::Current(uint8_t flow, uint8_t role) const
+    {
+        if (!InRange(flow, role))
+            return EndpointKey();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Slot &slot = m_slots[flow][role];
+        return slot.count ? slot.entries[0] : EndpointKey();
+    }
+
+    EndpointKey DefaultHistory::Previous(uint8_t flow, uint8_t role, const EndpointKey &current, const Available &available) const
+    {
+        if (!InRange(flow, role))
+            return EndpointKey();
+
+        // Copy out so the availability check never runs under the lock
+        Slot slot;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            slot = m_slots[flow][role];
+        }
+        for (uint8_t i = 0; i < slot.count; ++i)
+        {
+            const EndpointKey &key = slot.entries[i];
+            if (key != current && (!available || available(key)))
+                return key;
+        }
+        return EndpointKey();
+    }
+
+    std::vector<EndpointKey> DefaultHistory::Entries(uint8_t flow, uint8_t role) const
+    {
+        if (!InRange(flow, role))
+            return {};
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Slot &slot = m_slots[flow][role];
+        return std::vector<EndpointKey>(slot.entries.begin(), slot.entries.begin() + slot.count);
+    }
+
+    void DefaultHistory::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &flow : m_slots)
+            for (Slot &slot : flow)
+                slot.count = 0;
+    }
+
+    EndpointKey DefaultHistory::CycleAfter(const std::vector<EndpointKey> &candidates, const EndpointKey &current)
+    {
+        if (candidates.empty())
+            return EndpointKey();
+        auto it = std::find(candidates.begin(), candidates.end(), current);
+        if (it == candidates.end() || ++it == candidates.end())
+            return candidates.front();
+        return *it;
+    }
+}
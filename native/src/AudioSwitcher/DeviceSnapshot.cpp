@@ -0,0 +1,301 @@
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/DeviceTopology.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/SafeRelease.h"
+
+#include <functiondiscoverykeys_devpkey.h>
+#include <stdexcept>
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        /**
+         * @brief Returns the ID of the default endpoint for a flow/role, or empty if none.
+         */
+        std::wstring DefaultEndpointId(IMMDeviceEnumerator *pEnum, EDataFlow flow, ERole role)
+        {
+            std::wstring id;
+            IMMDevice *device = nullptr;
+            if (FAILED(pEnum->GetDefaultAudioEndpoint(flow, role, &device)) || !device)
+                return id;
+
+            LPWSTR buffer = nullptr;
+            if (SUCCEEDED(device->GetId(&buffer)) && buffer)
+            {
+                id = buffer;
+                CoTaskMemFree(buffer);
+            }
+            Utility::SafeRelease(device);
+            return id;
+        }
+
+        /**
+         * @brief Reads the data flow of an endpoint through IMMEndpoint.
+         */
+        EDataFlow EndpointFlow(IMMDevice *device)
+        {
+            EDataFlow flow = eRender;
+            IMMEndpoint *endpoint = nullptr;
+            if (SUCCEEDED(device->QueryInterface(__uuidof(IMMEndpoint), (void **)&endpoint)) && endpoint)
+            {
+                endpoint->GetDataFlow(&flow);
+                Utility::SafeRelease(endpoint);
+            }
+            return flow;
+        }
+    }
+
+    /**
+     * @brief Returns the process-wide snapshot instance.
+     */
+    DeviceSnapshot &DeviceSnapshot::Instance()
+    {
+        static DeviceSnapshot instance;
+        return instance;
+    }
+
+    /**
+     * @brief Returns the current table, building it on first use.
+     */
+    std::shared_ptr<const DeviceSnapshot::Table> DeviceSnapshot::Get()
+    {
+        {
+            View view = Read();
+            if (view)
+                return *view.m_guard;
+        }
+        return Refresh();
+    }
+
+    /**
+     * @brief Pins the current table for the calling scope.
+     */
+    DeviceSnapshot::View DeviceSnapshot::Read() const
+    {
+        return View(m_table.Read());
+    }
+
+    /**
+     * @brief Re-enumerates all endpoints and publishes the new table.
+     */
+    std::shared_ptr<const DeviceSnapshot::Table> DeviceSnapshot::Refresh()
+    {
+        std::shared_ptr<const Table> table = Build();
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_table.Publish(table);
+        return table;
+    }
+
+    /**
+     * @brief Applies an in-place edit to one endpoint via copy-on-write.
+     */
+    bool DeviceSnapshot::Update(const std::wstring &id, const std::function<void(EndpointInfo &)> &edit)
+    {
+        const EndpointKey key = EndpointKey::Lookup(id);
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        View current = Read();
+        if (!current || key.Empty())
+            return false;
+
+        auto copy = std::make_shared<Table>(*current);
+        for (EndpointInfo &endpoint : *copy)
+        {
+            if (endpoint.key == key)
+            {
+                edit(endpoint);
+                m_table.Publish(std::shared_ptr<const Table>(std::move(copy)));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reads effects for endpoints that do not have them yet and publishes the result.
+     *
+     * The COM work runs without the lock. If another writer published a table in the
+     * meantime, the effects are merged into that table by endpoint ID.
+     */
+    std::shared_ptr<const DeviceSnapshot::Table> DeviceSnapshot::LoadEffects()
+    {
+        std::shared_ptr<const Table> base = Get();
+
+        std::vector<std::pair<EndpointKey, EffectsInfo>> loaded;
+        for (const EndpointInfo &endpoint : *base)
+        {
+            if (endpoint.effects.loaded)
+                continue;
+
+            IMMDevice *device = Utility::GetDeviceById(endpoint.id);
+            if (!device)
+                continue;
+            IPropertyStore *store = nullptr;
+            device->OpenPropertyStore(STGM_READ, &store);
+            loaded.emplace_back(endpoint.key, ReadEffects(device, store, endpoint.flow));
+            Utility::SafeRelease(store);
+            Utility::SafeRelease(device);
+        }
+        if (loaded.empty())
+            return base;
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        View current = Read();
+        auto copy = std::make_shared<Table>(current ? *current : *base);
+        for (EndpointInfo &endpoint : *copy)
+        {
+            for (const auto &entry : loaded)
+            {
+                if (entry.first == endpoint.key)
+                    endpoint.effects = entry.second;
+            }
+        }
+        m_table.Publish(std::shared_ptr<const Table>(copy));
+        return copy;
+    }
+
+    /**
+     * @brief Fills jack presence for endpoints that do not have it yet and publishes the
+     *        result, merging by endpoint key like LoadEffects().
+     */
+    std::shared_ptr<const DeviceSnapshot::Table> DeviceSnapshot::LoadJacks()
+    {
+        std::shared_ptr<const Table> base = Get();
+        JackTracker &tracker = JackTracker::Instance();
+
+        std::vector<std::pair<EndpointKey, JackState>> loaded;
+        for (const EndpointInfo &endpoint : *base)
+        {
+            if (endpoint.jack.loaded)
+                continue;
+
+            JackState state;
+            if (!tracker.Find(endpoint.key, state))
+            {
+                IMMDevice *device = Utility::GetDeviceById(endpoint.id);
+                if (!device)
+                    continue;
+                state = SummarizeJacks(ReadEndpointJacks(device));
+                Utility::SafeRelease(device);
+                tracker.Seed(endpoint.key, state);
+            }
+            loaded.emplace_back(endpoint.key, state);
+        }
+        if (loaded.empty())
+            return base;
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        View current = Read();
+        auto copy = std::make_shared<Table>(current ? *current : *base);
+        for (EndpointInfo &endpoint : *copy)
+        {
+            for (const auto &entry : loaded)
+            {
+                if (entry.first == endpoint.key)
+                    endpoint.jack = entry.second;
+            }
+        }
+        m_table.Publish(std::shared_ptr<const Table>(copy));
+        return copy;
+    }
+
+    /**
+     * @brief Drops the current table.
+     */
+    void DeviceSnapshot::Invalidate()
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_table.Reset();
+    }
+
+    /**
+     * @brief Enumerates active endpoints of both flows and reads their properties.
+     *
+     * Each endpoint's property store is opened once and every cached property is read
+     * from it, so a refresh costs one enumeration plus O(endpoints) COM calls.
+     *
+     * @throws ServiceLostError If the Windows Audio service is not running.
+     * @throws std::runtime_error If the enumerator or the endpoint collection is unavailable.
+     */
+    std::shared_ptr<const DeviceSnapshot::Table> DeviceSnapshot::Build()
+    {
+        IMMDeviceEnumerator *pEnum = Utility::AudioRuntime::Instance().AcquireEnumerator();
+        if (!pEnum)
+            throw std::runtime_error("[x] Failed to create device enumerator.");
+
+        IMMDeviceCollection *pDevices = nullptr;
+        HRESULT hr = pEnum->EnumAudioEndpoints(eAll, DEVICE_STATE_ACTIVE, &pDevices);
+        if (FAILED(hr) || !pDevices)
+        {
+            Utility::SafeRelease(pEnum);
+            ServiceRecovery::Instance().ThrowIfLost(hr, "Failed to enumerate audio endpoints");
+            throw std::runtime_error("[x] Failed to enumerate audio endpoints.");
+        }
+
+        // Default endpoint keys, indexed [flow][role]
+        EndpointKey defaults[2][ERole_enum_count];
+        for (int flow = eRender; flow <= eCapture; ++flow)
+            for (int role = eConsole; role < ERole_enum_count; ++role)
+                defaults[flow][role] = EndpointKey::Intern(DefaultEndpointId(pEnum, static_cast<EDataFlow>(flow), static_cast<ERole>(role)));
+
+        auto table = std::make_shared<Table>();
+
+        UINT count = 0;
+        pDevices->GetCount(&count);
+        table->reserve(count);
+
+        for (UINT i = 0; i < count; ++i)
+        {
+            IMMDevice *pDevice = nullptr;
+            if (FAILED(pDevices->Item(i, &pDevice)) || !pDevice)
+                continue;
+
+            LPWSTR deviceId = nullptr;
+            if (FAILED(pDevice->GetId(&deviceId)) || !deviceId)
+            {
+                Utility::SafeRelease(pDevice);
+                continue;
+            }
+
+            EndpointInfo info;
+            info.id = deviceId;
+            info.key = EndpointKey::Intern(info.id);
+            CoTaskMemFree(deviceId);
+            info.flow = EndpointFlow(pDevice);
+
+            for (int role = eConsole; role < ERole_enum_count; ++role)
+            {
+                if (!info.key.Empty() && defaults[info.flow][role] == info.key)
+                    info.defaultRoles |= static_cast<uint8_t>(1u << role);
+            }
+
+            // Jack presence tracked from notifications costs nothing to carry over
+            JackTracker::Instance().Find(info.key, info.jack);
+
+            IPropertyStore *pStore = nullptr;
+            if (SUCCEEDED(pDevice->OpenPropertyStore(STGM_READ, &pStore)) && pStore)
+            {
+                PROPVARIANT prop;
+                PropVariantInit(&prop);
+                if (SUCCEEDED(pStore->GetValue(PKEY_Device_FriendlyName, &prop)) && prop.vt == VT_LPWSTR)
+                    info.name = prop.pwszVal;
+                PropVariantClear(&prop);
+
+                if (info.flow == eCapture)
+                    info.listen = ReadListenSettings(pStore);
+
+                Utility::SafeRelease(pStore);
+            }
+
+            table->push_back(std::move(info));
+            Utility::SafeRelease(pDevice);
+        }
+
+        Utility::SafeRelease(pDevices);
+        Utility::SafeRelease(pEnum);
+        return table;
+    }
+}
@@ -0,0 +1,307 @@
+#include "AudioSwitcher/DeviceTopology.h"
+#include "Utility/SafeRelease.h"
+
+#include <algorithm>
+#include <deque>
+#include <endpointvolume.h>
+#include <devicetopology.h>
+#include <ks.h>
+#include <ksmedia.h>
+#include <unordered_map>
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        /// Bounds the walk on drivers with unusually large (or cyclic) graphs.
+        constexpr size_t kMaxParts = 256;
+
+        struct SubTypeName
+        {
+            const GUID *guid;
+            const char *name;
+        };
+
+        const SubTypeName kSubTypes[] = {
+            {&KSNODETYPE_VOLUME, "volume"},
+            {&KSNODETYPE_MUTE, "mute"},
+            {&KSNODETYPE_PEAKMETER, "peakMeter"},
+            {&KSNODETYPE_LOUDNESS, "loudness"},
+            {&KSNODETYPE_TONE, "tone"},
+            {&KSNODETYPE_AGC, "agc"},
+            {&KSNODETYPE_SUM, "sum"},
+            {&KSNODETYPE_MUX, "mux"},
+            {&KSNODETYPE_SUPERMIX, "supermix"},
+            {&KSNODETYPE_SRC, "src"},
+            {&KSNODETYPE_DAC, "dac"},
+            {&KSNODETYPE_ADC, "adc"},
+            {&KSNODETYPE_SPEAKER, "speaker"},
+            {&KSNODETYPE_HEADPHONES, "headphones"},
+            {&KSNODETYPE_HEADSET_SPEAKERS, "headsetSpeakers"},
+            {&KSNODETYPE_MICROPHONE, "microphone"},
+            {&KSNODETYPE_MICROPHONE_ARRAY, "microphoneArray"},
+            {&KSNODETYPE_HEADSET_MICROPHONE, "headsetMicrophone"},
+            {&KSNODETYPE_LINE_CONNECTOR, "lineConnector"},
+            {&KSNODETYPE_SPDIF_INTERFACE, "spdif"},
+            {&KSNODETYPE_HDMI_INTERFACE, "hdmi"},
+            {&KSNODETYPE_DISPLAYPORT_INTERFACE, "displayPort"},
+        };
+
+        const char *SubTypeLabel(const GUID &subType)
+        {
+            for (const SubTypeName &entry : kSubTypes)
+            {
+                if (IsEqualGUID(*entry.guid, subType))
+                    return entry.name;
+            }
+            return "other";
+        }
+
+        const char *ConnectorTypeLabel(ConnectorType type)
+        {
+            switch (type)
+            {
+            case Physical_Internal:
+                return "physicalInternal";
+            case Physical_External:
+                return "physicalExternal";
+            case Software_IO:
+                return "softwareIO";
+            case Software_Fixed:
+                return "softwareFixed";
+            case Network:
+                return "network";
+            default:
+                return "unknown";
+            }
+        }
+
+        /**
+         * @brief Maps the part's control interfaces to TopologyControl bits without
+         *        activating any of them.
+         */
+        uint8_t ReadControls(IPart *part)
+        {
+            uint8_t controls = 0;
+            UINT count = 0;
+            if (FAILED(part->GetControlInterfaceCount(&count)))
+                return 0;
+            for (UINT i = 0; i < count; ++i)
+            {
+                IControlInterface *control = nullptr;
+                IID iid = {};
+                if (SUCCEEDED(part->GetControlInterface(i, &control)) && control && SUCCEEDED(control->GetIID(&iid)))
+                {
+                    if (IsEqualIID(iid, __uuidof(IAudioVolumeLevel)))
+                        controls |= TopologyControl::Volume;
+                    else if (IsEqualIID(iid, __uuidof(IAudioMute)))
+                        controls |= TopologyControl::Mute;
+                    else if (IsEqualIID(iid, __uuidof(IAudioPeakMeter)))
+                        controls |= TopologyControl::PeakMeter;
+                    else if (IsEqualIID(iid, __uuidof(IAudioLoudness)))
+                        controls |= TopologyControl::Loudness;
+                    else if (IsEqualIID(iid, __uuidof(IAudioBass)) || IsEqualIID(iid, __uuidof(IAudioMidrange)) ||
+                             IsEqualIID(iid, __uuidof(IAudioTreble)))
+                        controls |= TopologyControl::Tone;
+                    else if (IsEqualIID(iid, __uuidof(IAudioAutoGainControl)))
+                        controls |= TopologyControl::Agc;
+                }
+                Utility::SafeRelease(control);
+            }
+            return controls;
+        }
+
+        /// Appends the jacks described on @p part (bridge-pin connectors carry them).
+        void ReadJacks(IPart *part, std::vector<JackDescription> &jacks)
+        {
+            IKsJackDescription *description = nullptr;
+            if (FAILED(part->Activate(CLSCTX_INPROC_SERVER, __uuidof(IKsJackDescription), (void **)&description)) || !description)
+                return;
+
+            UINT count = 0;
+            if (SUCCEEDED(description->GetJackCount(&count)))
+            {
+                for (UINT i = 0; i < count; ++i)
+                {
+                    KSJACK_DESCRIPTION jack = {};
+                    if (FAILED(description->GetJackDescription(i, &jack)))
+                        continue;
+                    JackDescription info;
+                    info.color = jack.Color & 0x00FFFFFF;
+                    info.connectionType = static_cast<uint8_t>(jack.ConnectionType);
+                    info.geoLocation = static_cast<uint8_t>(jack.GeoLocation);
+                    info.genLocation = static_cast<uint8_t>(jack.GenLocation);
+                    info.portConnection = static_cast<uint8_t>(jack.PortConnection);
+                    info.connected = jack.IsConnected != FALSE;
+                    jacks.push_back(info);
+                }
+            }
+            Utility::SafeRelease(description);
+        }
+
+        std::wstring TakeString(LPWSTR value)
+        {
+            std::wstring result = value ? value : L"";
+            CoTaskMemFree(value);
+            return result;
+        }
+
+        /// Returns the part on the other side of a connected connector, or nullptr.
+        IPart *AcrossConnector(IConnector *connector)
+        {
+            BOOL connected = FALSE;
+            if (FAILED(connector->IsConnected(&connected)) || !connected)
+                return nullptr;
+            IConnector *peer = nullptr;
+            IPart *part = nullptr;
+            if (SUCCEEDED(connector->GetConnectedTo(&peer)) && peer)
+                peer->QueryInterface(__uuidof(IPart), (void **)&part);
+            Utility::SafeRelease(peer);
+            return part;
+        }
+    }
+
+    std::shared_ptr<const EndpointTopology> WalkTopology(IMMDevice *device, EDataFlow flow, const std::wstring &id)
+    {
+        auto topology = std::make_shared<EndpointTopology>();
+        topology->endpointId = id;
+
+        IAudioEndpointVolume *volume = nullptr;
+        if (SUCCEEDED(device->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr, (void **)&volume)) && volume)
+        {
+            DWORD mask = 0;
+            if (SUCCEEDED(volume->QueryHardwareSupport(&mask)))
+                topology->hardwareSupport = mask;
+            Utility::SafeRelease(volume);
+        }
+
+        IDeviceTopology *endpointTopology = nullptr;
+        if (FAILED(device->Activate(__uuidof(IDeviceTopology), CLSCTX_ALL, nullptr, (void **)&endpointTopology)) || !endpointTopology)
+            return topology;
+
+        // The endpoint's own topology has one connector, wired to the adapter
+        IConnector *endpointConnector = nullptr;
+        IPart *start = nullptr;
+        if (SUCCEEDED(endpointTopology->GetConnector(0, &endpointConnector)) && endpointConnector)
+            start = AcrossConnector(endpointConnector);
+        Utility::SafeRelease(endpointConnector);
+        Utility::SafeRelease(endpointTopology);
+        if (!start)
+            return topology;
+
+        IDeviceTopology *adapter = nullptr;
+        if (SUCCEEDED(start->GetTopologyObject(&adapter)) && adapter)
+        {
+            LPWSTR adapterId = nullptr;
+            if (SUCCEEDED(adapter->GetDeviceId(&adapterId)))
+                topology->adapterId = TakeString(adapterId);
+            Utility::SafeRelease(adapter);
+        }
+
+        // Breadth-first toward the jack: render data flows out of the adapter's input
+        // connector, capture data flows into the adapter's output connector
+        std::unordered_map<std::wstring, uint32_t> visited; // global ID → part index
+        std::deque<std::pair<IPart *, uint32_t>> queue;     // part, index of the part that reached it
+        queue.emplace_back(start, UINT32_MAX);
+        while (!queue.empty())
+        {
+            IPart *part = queue.front().first;
+            const uint32_t from = queue.front().second;
+            queue.pop_front();
+
+            LPWSTR globalId = nullptr;
+            const std::wstring key = SUCCEEDED(part->GetGlobalId(&globalId)) ? TakeString(globalId) : std::wstring();
+            auto seen = key.empty() ? visited.end() : visited.find(key);
+            if (seen != visited.end() || topology->parts.size() >= kMaxParts)
+            {
+                // Record joins, but not the way back across a connector pair
+                if (seen != visited.end() && from != UINT32_MAX)
+                {
+                    const std::vector<uint32_t> &back = topology->parts[seen->second].links;
+                    if (std::find(back.begin(), back.end(), from) == back.end())
+                        topology->parts[from].links.push_back(seen->second);
+                }
+                Utility::SafeRelease(part);
+                continue;
+            }
+
+            const uint32_t index = static_cast<uint32_t>(topology->parts.size());
+            if (!key.empty())
+                visited.emplace(key, index);
+            if (from != UINT32_MAX)
+                topology->parts[from].links.push_back(index);
+
+            TopologyPart info;
+            UINT localId = 0;
+            if (SUCCEEDED(part->GetLocalId(&localId)))
+                info.localId = localId;
+            LPWSTR name = nullptr;
+            if (SUCCEEDED(part->GetName(&name)))
+                info.name = TakeString(name);
+            PartType type = Subunit;
+            part->GetPartType(&type);
+            info.type = type == Connector ? TopologyPartType::Connector : TopologyPartType::Subunit;
+            GUID subType = GUID_NULL;
+            info.subType = SUCCEEDED(part->GetSubType(&subType)) ? SubTypeLabel(subType) : "other";
+            info.controls = ReadControls(part);
+            topology->parts.push_back(std::move(info));
+
+            if (type == Connector)
+            {
+                IConnector *connector = nullptr;
+                if (SUCCEEDED(part->QueryInterface(__uuidof(IConnector), (void **)&connector)) && connector)
+                {
+                    ConnectorType connectorType = Unknown_Connector;
+                    if (SUCCEEDED(connector->GetType(&connectorType)))
+                        topology->parts[index].connectorType = ConnectorTypeLabel(connectorType);
+                    // Filters inside one adapter are separate device topologies joined by connectors
+                    if (index != 0)
+                    {
+                        if (IPart *next = AcrossConnector(connector))
+                            queue.emplace_back(next, index);
+                    }
+                    Utility::SafeRelease(connector);
+                }
+                ReadJacks(part, topology->jacks);
+            }
+
+            IPartsList *parts = nullptr;
+            HRESULT hr = flow == eRender ? part->EnumPartsOutgoing(&parts) : part->EnumPartsIncoming(&parts);
+            if (SUCCEEDED(hr) && parts)
+            {
+                UINT count = 0;
+                parts->GetCount(&count);
+                for (UINT i = 0; i < count; ++i)
+                {
+                    IPart *next = nullptr;
+                    if (SUCCEEDED(parts->GetPart(i, &next)) && next)
+                        queue.emplace_back(next, index);
+                }
+            }
+            Utility::SafeRelease(parts);
+            Utility::SafeRelease(part);
+        }
+        return topology;
+    }
+
+    std::vector<JackDescription> ReadEndpointJacks(IMMDevice *device)
+    {
+        std::vector<JackDescription> jacks;
+        IDeviceTopology *endpointTopology = nullptr;
+        if (FAILED(device->Activate(__uuidof(IDeviceTopology), CLSCTX_ALL, nullptr, (void **)&endpointTopology)) || !endpointTopology)
+            return jacks;
+
+        IConnector *endpointConnector = nullptr;
+        if (SUCCEEDED(endpointTopology->GetConnector(0, &endpointConnector)) && endpointConnector)
+        {
+            if (IPart *bridge = AcrossConnector(endpointConnector))
+            {
+                ReadJacks(bridge, jacks);
+                Utility::SafeRelease(bridge);
+            }
+        }
+        Utility::SafeRelease(endpointConnector);
+        Utility::SafeRelease(endpointTopology);
+        return jacks;
+    }
+}
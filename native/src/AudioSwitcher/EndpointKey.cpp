@@ -0,0 +1,266 @@
+#include "AudioSwitcher/EndpointKey.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        // `{0.0.F.00000000}.{xxxxxxxx-xxxx-4xxx-Vxxx-xxxxxxxxxxxx}`
+        constexpr size_t kStandardLength = 55;
+        constexpr size_t kFlowOffset = 5;
+        constexpr size_t kGuidOffset = 18;
+        constexpr char kPrefix[] = "{0.0.?.00000000}.{";
+
+        constexpr unsigned kVersionDigit = 12; ///< GUID hex digit holding the UUID version.
+        constexpr unsigned kVariantDigit = 16; ///< GUID hex digit holding the variant bits.
+        constexpr uint64_t kKindShift = (15 - kVersionDigit) * 4;
+        constexpr uint64_t kKindMask = 0xFull << kKindShift;
+        constexpr uint64_t kInterned = 0xF; ///< Kind of interned keys; packed keys use flow + 1.
+
+        /// Lowercase hex digit values; everything else (uppercase included, so ToUtf8()
+        /// round-trips) maps to 0xFF.
+        struct HexTable
+        {
+            uint8_t values[128];
+
+            HexTable()
+            {
+                for (uint8_t &value : values)
+                    value = 0xFF;
+                for (int i = 0; i < 10; ++i)
+                    values['0' + i] = static_cast<uint8_t>(i);
+                for (int i = 0; i < 6; ++i)
+                    values['a' + i] = static_cast<uint8_t>(10 + i);
+            }
+        };
+
+        template <typename Char>
+        unsigned HexValue(Char c)
+        {
+            static const HexTable table;
+            const auto code = static_cast<typename std::make_unsigned<Char>::type>(c);
+            return code < 128 ? table.values[code] : 0xFFu;
+        }
+
+        bool IsDash(size_t guidIndex) { return guidIndex == 8 || guidIndex == 13 || guidIndex == 18 || guidIndex == 23; }
+
+        void AppendUtf8(std::string &out, uint32_t cp)
+        {
+            if (cp < 0x80)
+                out += static_cast<char>(cp);
+            else if (cp < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            else if (cp < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (cp >> 18));
+                out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+
+        /// UTF-16 (Windows) or UTF-32 wide string to UTF-8. Lone surrogates become U+FFFD.
+        std::string WideToUtf8(const std::wstring &wide)
+        {
+            std::string out;
+            out.reserve(wide.size());
+            for (size_t i = 0; i < wide.size(); ++i)
+            {
+                uint32_t cp = static_cast<uint32_t>(wide[i]);
+                if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDFFF)
+                {
+                    const uint32_t next = i + 1 < wide.size() ? static_cast<uint32_t>(wide[i + 1]) : 0;
+                    if (cp <= 0xDBFF && next >= 0xDC00 && next <= 0xDFFF)
+                    {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (next - 0xDC00);
+                        ++i;
+                    }
+                    else
+                        cp = 0xFFFD;
+                }
+                AppendUtf8(out, cp > 0x10FFFF ? 0xFFFD : cp);
+            }
+            return out;
+        }
+
+        /// UTF-8 to wide. Only used for strings produced by WideToUtf8 or checked by Pack.
+        std::wstring Utf8ToWide(const std::string &utf8)
+        {
+            std::wstring out;
+            out.reserve(utf8.size());
+            for (size_t i = 0; i < utf8.size();)
+            {
+                const uint8_t lead = static_cast<uint8_t>(utf8[i]);
+                const size_t extra = lead < 0x80 ? 0 : lead < 0xE0 ? 1 : lead < 0xF0 ? 2 : 3;
+                uint32_t cp = extra == 0 ? lead : lead & (0x3F >> extra);
+                for (size_t k = 1; k <= extra && i + k < utf8.size(); ++k)
+                    cp = (cp << 6) | (static_cast<uint8_t>(utf8[i + k]) & 0x3F);
+                i += extra + 1;
+
+                if (sizeof(wchar_t) == 2 && cp >= 0x10000)
+                {
+                    cp -= 0x10000;
+                    out += static_cast<wchar_t>(0xD800 + (cp >> 10));
+                    out += static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+                }
+                else
+                    out += static_cast<wchar_t>(cp);
+            }
+            return out;
+        }
+
+        std::string ToUtf8String(const std::string &id) { return id; }
+        std::string ToUtf8String(const std::wstring &id) { return WideToUtf8(id); }
+
+        /**
+         * @brief Process-wide table of non-standard IDs. Reads take a shared lock; inserts
+         *        happen once per distinct ID the system reports.
+         */
+        struct InternTable
+        {
+            std::shared_mutex mutex;
+            std::unordered_map<std::string, uint64_t> slots;
+            std::vector<std::string> ids;
+        };
+
+        InternTable &Interned()
+        {
+            static InternTable *table = new InternTable(); // leaked: keys may outlive static destruction
+            return *table;
+        }
+    }
+
+    template <typename Char>
+    bool EndpointKey::Pack(const Char *id, size_t length, EndpointKey &key)
+    {
+        if (length != kStandardLength)
+            return false;
+        for (size_t i = 0; i < kGuidOffset; ++i)
+        {
+            if (i != kFlowOffset && id[i] != static_cast<Char>(kPrefix[i]))
+                return false;
+        }
+        const Char flowChar = id[kFlowOffset];
+        if (flowChar != '0' && flowChar != '1')
+            return false;
+        if (id[kStandardLength - 1] != '}')
+            return false;
+
+        uint64_t halves[2] = {0, 0};
+        unsigned digit = 0;
+        for (size_t g = 0; g < 36; ++g)
+        {
+            const Char c = id[kGuidOffset + g];
+            if (IsDash(g))
+            {
+                if (c != '-')
+                    return false;
+                continue;
+            }
+            const unsigned value = HexValue(c);
+            if (value > 0xF)
+                return false;
+            if (digit == kVersionDigit && value != 4)
+                return false;
+            if (digit == kVariantDigit && (value & 0xC) != 0x8)
+                return false;
+            halves[digit / 16] = (halves[digit / 16] << 4) | static_cast<uint64_t>(value);
+            ++digit;
+        }
+
+        const uint64_t kind = static_cast<uint64_t>(flowChar - '0') + 1;
+        key = EndpointKey((halves[0] & ~kKindMask) | (kind << kKindShift), halves[1]);
+        return true;
+    }
+
+    template <typename Char>
+    EndpointKey EndpointKey::Resolve(const std::basic_string<Char> &id, bool intern)
+    {
+        EndpointKey key;
+        if (id.empty() || Pack(id.data(), id.size(), key))
+            return key;
+
+        const std::string utf8 = ToUtf8String(id);
+        InternTable &table = Interned();
+        {
+            std::shared_lock<std::shared_mutex> lock(table.mutex);
+            auto it = table.slots.find(utf8);
+            if (it != table.slots.end())
+                return EndpointKey(kInterned << kKindShift, it->second);
+        }
+        if (!intern)
+            return EndpointKey();
+
+        std::unique_lock<std::shared_mutex> lock(table.mutex);
+        auto inserted = table.slots.emplace(utf8, static_cast<uint64_t>(table.ids.size()));
+        if (inserted.second)
+            table.ids.push_back(utf8);
+        return EndpointKey(kInterned << kKindShift, inserted.first->second);
+    }
+
+    EndpointKey EndpointKey::Intern(const std::wstring &id) { return Resolve(id, true); }
+    EndpointKey EndpointKey::Intern(const std::string &utf8Id) { return Resolve(utf8Id, true); }
+    EndpointKey EndpointKey::Lookup(const std::wstring &id) { return Resolve(id, false); }
+    EndpointKey EndpointKey::Lookup(const std::string &utf8Id) { return Resolve(utf8Id, false); }
+
+    bool EndpointKey::IsPacked() const
+    {
+        const uint64_t kind = (m_high & kKindMask) >> kKindShift;
+        return kind == 1 || kind == 2;
+    }
+
+    int EndpointKey::Flow() const
+    {
+        return IsPacked() ? static_cast<int>(((m_high & kKindMask) >> kKindShift) - 1) : -1;
+    }
+
+    std::string EndpointKey::ToUtf8() const
+    {
+        if (Empty())
+            return std::string();
+        if (!IsPacked())
+        {
+            InternTable &table = Interned();
+            std::shared_lock<std::shared_mutex> lock(table.mutex);
+            return m_low < table.ids.size() ? table.ids[m_low] : std::string();
+        }
+
+        static const char kHex[] = "0123456789abcdef";
+        std::string id(kPrefix);
+        id[kFlowOffset] = static_cast<char>('0' + Flow());
+        const uint64_t high = (m_high & ~kKindMask) | (4ull << kKindShift);
+        unsigned digit = 0;
+        for (size_t g = 0; g < 36; ++g)
+        {
+            if (IsDash(g))
+            {
+                id += '-';
+                continue;
+            }
+            const uint64_t half = digit < 16 ? high : m_low;
+            id += kHex[(half >> ((15 - digit % 16) * 4)) & 0xF];
+            ++digit;
+        }
+        id += '}';
+        return id;
+    }
+
+    std::wstring EndpointKey::ToWString() const
+    {
+        return Utf8ToWide(ToUtf8());
+    }
+}
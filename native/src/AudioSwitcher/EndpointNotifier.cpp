@@ -0,0 +1,262 @@
+#include "AudioSwitcher/EndpointNotifier.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/SafeRelease.h"
+
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Forwards master volume / mute changes of one endpoint.
+     */
+    class EndpointNotifier::VolumeCallback : public IAudioEndpointVolumeCallback
+    {
+    public:
+        VolumeCallback(NotificationDispatcher &dispatcher, std::wstring deviceId)
+            : m_dispatcher(dispatcher), m_deviceId(std::move(deviceId))
+        {
+        }
+
+        virtual ~VolumeCallback() = default;
+
+        ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refs; }
+        ULONG STDMETHODCALLTYPE Release() override { return --m_refs; }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **object) override
+        {
+            if (!object)
+                return E_POINTER;
+            if (riid == __uuidof(IUnknown) || riid == __uuidof(IAudioEndpointVolumeCallback))
+            {
+                *object = static_cast<IAudioEndpointVolumeCallback *>(this);
+                AddRef();
+                return S_OK;
+            }
+            *object = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        HRESULT STDMETHODCALLTYPE OnNotify(PAUDIO_VOLUME_NOTIFICATION_DATA data) override
+        {
+            if (!data)
+                return E_POINTER;
+            Notification notification;
+            notification.kind = NotificationKind::VolumeChanged;
+            notification.deviceId = m_deviceId;
+            notification.volume = data->fMasterVolume;
+            notification.muted = data->bMuted != FALSE;
+            m_dispatcher.Post(std::move(notification));
+            return S_OK;
+        }
+
+    private:
+        NotificationDispatcher &m_dispatcher;
+        std::wstring m_deviceId;
+        std::atomic<ULONG> m_refs{1};
+    };
+
+    EndpointNotifier::EndpointNotifier(NotificationDispatcher &dispatcher)
+        : m_dispatcher(dispatcher)
+    {
+    }
+
+    EndpointNotifier::~EndpointNotifier()
+    {
+        Stop();
+    }
+
+    void EndpointNotifier::Start()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_enumerator)
+                return;
+
+            IMMDeviceEnumerator *enumerator = AudioRuntime::Instance().AcquireEnumerator();
+            if (!enumerator)
+                throw std::runtime_error("[x] Failed to create device enumerator");
+            const HRESULT hr = enumerator->RegisterEndpointNotificationCallback(this);
+            if (FAILED(hr))
+            {
+                SafeRelease(enumerator);
+                ServiceRecovery::Instance().ThrowIfLost(hr, "Failed to register endpoint notifications");
+                throw std::runtime_error("[x] Failed to register endpoint notifications");
+            }
+            m_enumerator = enumerator;
+        }
+        SyncVolumeCallbacks();
+    }
+
+    void EndpointNotifier::Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enumerator)
+            return;
+
+        m_enumerator->UnregisterEndpointNotificationCallback(this);
+        for (auto &entry : m_subscriptions)
+            Unsubscribe(entry.second);
+        m_subscriptions.clear();
+        SafeRelease(m_enumerator);
+    }
+
+    void EndpointNotifier::Restart()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_enumerator)
+                return;
+        }
+        // Unregistering against the dead service fails harmlessly; the objects are released
+        Stop();
+        Start();
+    }
+
+    void EndpointNotifier::SyncVolumeCallbacks()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enumerator)
+            return;
+
+        IMMDeviceCollection *collection = nullptr;
+        if (FAILED(m_enumerator->EnumAudioEndpoints(eAll, DEVICE_STATE_ACTIVE, &collection)))
+            return;
+
+        UINT count = 0;
+        collection->GetCount(&count);
+        std::unordered_map<EndpointKey, Subscription, EndpointKeyHash> current;
+        for (UINT i = 0; i < count; ++i)
+        {
+            IMMDevice *device = nullptr;
+            LPWSTR id = nullptr;
+            if (FAILED(collection->Item(i, &device)) || FAILED(device->GetId(&id)))
+            {
+                SafeRelease(device);
+                continue;
+            }
+            std::wstring deviceId(id);
+            CoTaskMemFree(id);
+            const EndpointKey key = EndpointKey::Intern(deviceId);
+
+            auto existing = m_subscriptions.find(key);
+            if (existing != m_subscriptions.end())
+            {
+                current.emplace(key, std::move(existing->second));
+                m_subscriptions.erase(existing);
+                SafeRelease(device);
+                continue;
+            }
+
+            Subscription subscription;
+            if (SUCCEEDED(device->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr,
+                                           reinterpret_cast<void **>(&subscription.volume))))
+            {
+                subscription.callback = std::make_unique<VolumeCallback>(m_dispatcher, deviceId);
+                if (SUCCEEDED(subscription.volume->RegisterControlChangeNotify(subscription.callback.get())))
+                    current.emplace(key, std::move(subscription));
+                else
+                    SafeRelease(subscription.volume);
+            }
+            SafeRelease(device);
+        }
+        SafeRelease(collection);
+
+        // Whatever is left is no longer active
+        for (auto &entry : m_subscriptions)
+            Unsubscribe(entry.second);
+        m_subscriptions.swap(current);
+    }
+
+    size_t EndpointNotifier::WatchedEndpoints() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_subscriptions.size();
+    }
+
+    void EndpointNotifier::Unsubscribe(Subscription &subscription)
+    {
+        if (subscription.volume)
+        {
+            subscription.volume->UnregisterControlChangeNotify(subscription.callback.get());
+            SafeRelease(subscription.volume);
+        }
+        subscription.callback.reset();
+    }
+
+    void EndpointNotifier::Post(NotificationKind kind, LPCWSTR deviceId)
+    {
+        Notification notification;
+        notification.kind = kind;
+        if (deviceId)
+            notification.deviceId = deviceId;
+        m_dispatcher.Post(std::move(notification));
+    }
+
+    ULONG STDMETHODCALLTYPE EndpointNotifier::AddRef()
+    {
+        return ++m_refs;
+    }
+
+    ULONG STDMETHODCALLTYPE EndpointNotifier::Release()
+    {
+        return --m_refs;
+    }
+
+    HRESULT STDMETHODCALLTYPE EndpointNotifier::QueryInterface(REFIID riid, void **object)
+    {
+        if (!object)
+            return E_POINTER;
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IMMNotificationClient))
+        {
+            *object = static_cast<IMMNotificationClient *>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    HRESULT STDMETHODCALLTYPE EndpointNotifier::OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR deviceId)
+    {
+        Notification notification;
+        notification.kind = NotificationKind::DefaultChanged;
+        notification.flow = static_cast<uint8_t>(flow);
+        notification.role = static_cast<uint8_t>(role);
+        if (deviceId)
+            notification.deviceId = deviceId;
+        m_dispatcher.Post(std::move(notification));
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE EndpointNotifier::OnDeviceAdded(LPCWSTR deviceId)
+    {
+        Post(NotificationKind::DeviceAdded, deviceId);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE EndpointNotifier::OnDeviceRemoved(LPCWSTR deviceId)
+    {
+        Post(NotificationKind::DeviceRemoved, deviceId);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE EndpointNotifier::OnDeviceStateChanged(LPCWSTR deviceId, DWORD newState)
+    {
+        Notification notification;
+        notification.kind = NotificationKind::StateChanged;
+        notification.state = newState;
+        if (deviceId)
+            notification.deviceId = deviceId;
+        m_dispatcher.Post(std::move(notification));
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE EndpointNotifier::OnPropertyValueChanged(LPCWSTR deviceId, const PROPERTYKEY)
+    {
+        Post(NotificationKind::PropertyChanged, deviceId);
+        return S_OK;
+    }
+}
@@ -0,0 +1,83 @@
+#include "AudioSwitcher/JackPresence.h"
+
+namespace AudioSwitcher
+{
+    JackState SummarizeJacks(const std::vector<JackDescription> &jacks)
+    {
+        JackState state;
+        state.loaded = true;
+        state.present = !jacks.empty();
+
+        const JackDescription *describe = jacks.empty() ? nullptr : &jacks.front();
+        for (const JackDescription &jack : jacks)
+        {
+            if (jack.connected)
+            {
+                state.connected = true;
+                describe = &jack;
+                break;
+            }
+        }
+        if (describe)
+        {
+            state.color = describe->color;
+            state.connectionType = describe->connectionType;
+            state.geoLocation = describe->geoLocation;
+        }
+        return state;
+    }
+
+    JackTracker &JackTracker::Instance()
+    {
+        static JackTracker *tracker = new JackTracker();
+        return *tracker;
+    }
+
+    JackTracker::Change JackTracker::Update(const EndpointKey &key, const JackState &state, bool appeared)
+    {
+        if (key.Empty())
+            return Change::None;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_states.find(key);
+        const bool wasConnected = it != m_states.end() && it->second.connected;
+        const bool known = it != m_states.end();
+        m_states[key] = state;
+
+        if (state.connected && !wasConnected && (known || appeared))
+            return Change::Connected;
+        if (!state.connected && wasConnected)
+            return Change::Disconnected;
+        return Change::None;
+    }
+
+    void JackTracker::Seed(const EndpointKey &key, const JackState &state)
+    {
+        if (key.Empty())
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_states[key] = state;
+    }
+
+    bool JackTracker::Find(const EndpointKey &key, JackState &state) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_states.find(key);
+        if (it == m_states.end())
+            return false;
+        state = it->second;
+        return true;
+    }
+
+    void JackTracker::Forget(const EndpointKey &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_states.erase(key);
+    }
+
+    void JackTracker::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_states.clear();
+    }
+}
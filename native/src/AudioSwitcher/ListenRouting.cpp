@@ -0,0 +1,113 @@
+#include "AudioSwitcher/ListenRouting.h"
+#include "AudioSwitcher/IPolicyConfig.h"
+#include "Utility/SafeRelease.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        // {24DBB0FC-9311-4B3D-9CF0-18FF155639D4},0 : listen target render endpoint ID (VT_LPWSTR)
+        const PROPERTYKEY PKEY_ListenPlaybackTarget = {
+            {0x24dbb0fc, 0x9311, 0x4b3d, {0x9c, 0xf0, 0x18, 0xff, 0x15, 0x56, 0x39, 0xd4}}, 0};
+
+        // {24DBB0FC-9311-4B3D-9CF0-18FF155639D4},1 : "Listen to this device" enabled (VT_BOOL)
+        const PROPERTYKEY PKEY_ListenEnabled = {
+            {0x24dbb0fc, 0x9311, 0x4b3d, {0x9c, 0xf0, 0x18, 0xff, 0x15, 0x56, 0x39, 0xd4}}, 1};
+
+        /**
+         * @brief Writes a VT_LPWSTR value through IPolicyConfig (which notifies the audio engine).
+         */
+        HRESULT WriteString(IPolicyConfig *policy, const std::wstring &deviceId, const PROPERTYKEY &key,
+                            const std::wstring &value)
+        {
+            PROPVARIANT prop;
+            PropVariantInit(&prop);
+
+            size_t bytes = (value.size() + 1) * sizeof(wchar_t);
+            prop.pwszVal = static_cast<LPWSTR>(CoTaskMemAlloc(bytes));
+            if (!prop.pwszVal)
+                return E_OUTOFMEMORY;
+            std::memcpy(prop.pwszVal, value.c_str(), bytes);
+            prop.vt = VT_LPWSTR;
+
+            HRESULT hr = policy->SetPropertyValue(deviceId.c_str(), key, &prop);
+            PropVariantClear(&prop);
+            return hr;
+        }
+
+        /**
+         * @brief Writes a VT_BOOL value through IPolicyConfig.
+         */
+        HRESULT WriteBool(IPolicyConfig *policy, const std::wstring &deviceId, const PROPERTYKEY &key, bool value)
+        {
+            PROPVARIANT prop;
+            PropVariantInit(&prop);
+            prop.vt = VT_BOOL;
+            prop.boolVal = value ? VARIANT_TRUE : VARIANT_FALSE;
+            return policy->SetPropertyValue(deviceId.c_str(), key, &prop);
+        }
+    }
+
+    /**
+     * @brief Reads the listen enable flag and target from a capture endpoint's property store.
+     *
+     * Missing values are treated as Windows does: disabled, default playback device.
+     *
+     * @param store Property store of the endpoint (not owned).
+     * @return ListenSettings The settings; `valid` is false only if @p store is null.
+     */
+    ListenSettings ReadListenSettings(IPropertyStore *store)
+    {
+        ListenSettings settings;
+        if (!store)
+            return settings;
+
+        PROPVARIANT prop;
+        PropVariantInit(&prop);
+        if (SUCCEEDED(store->GetValue(PKEY_ListenEnabled, &prop)) && prop.vt == VT_BOOL)
+            settings.enabled = prop.boolVal != VARIANT_FALSE;
+        PropVariantClear(&prop);
+
+        PropVariantInit(&prop);
+        if (SUCCEEDED(store->GetValue(PKEY_ListenPlaybackTarget, &prop)) && prop.vt == VT_LPWSTR && prop.pwszVal)
+            settings.targetId = prop.pwszVal;
+        PropVariantClear(&prop);
+
+        settings.valid = true;
+        return settings;
+    }
+
+    /**
+     * @brief Applies listen routing changes in one batch.
+     *
+     * @param changes Changes to apply.
+     * @return std::vector<bool> Per-change success flags.
+     * @throws std::runtime_error If IPolicyConfig cannot be created.
+     */
+    std::vector<bool> ApplyListenChanges(const std::vector<ListenChange> &changes)
+    {
+        std::vector<bool> results(changes.size(), false);
+        if (changes.empty())
+            return results;
+
+        IPolicyConfig *pPolicyConfig = nullptr;
+        HRESULT hr = CoCreateInstance(__uuidof(CPolicyConfigClient), NULL, CLSCTX_ALL,
+                                      __uuidof(IPolicyConfig), (LPVOID *)&pPolicyConfig);
+        if (FAILED(hr) || !pPolicyConfig)
+            throw std::runtime_error("[x] Failed to create IPolicyConfig COM object.");
+
+        for (size_t i = 0; i < changes.size(); ++i)
+        {
+            const ListenChange &change = changes[i];
+            HRESULT hrTarget = WriteString(pPolicyConfig, change.captureId, PKEY_ListenPlaybackTarget, change.targetId);
+            HRESULT hrEnable = WriteBool(pPolicyConfig, change.captureId, PKEY_ListenEnabled, change.enabled);
+            results[i] = SUCCEEDED(hrTarget) && SUCCEEDED(hrEnable);
+        }
+
+        Utility::SafeRelease(pPolicyConfig);
+        return results;
+    }
+}
@@ -0,0 +1,283 @@
+#include "AudioSwitcher/NotificationDispatcher.h"
+
+#include <algorithm>
+
+namespace AudioSwitcher
+{
+    /**
+     * @brief Returns the key a notification is folded under. Added and removed share a
+     *        key so a device that flaps within one window ends up in its final state.
+     */
+    NotificationDispatcher::FoldKey NotificationDispatcher::KeyOf(const Notification &notification)
+    {
+        FoldKey key;
+        switch (notification.kind)
+        {
+        case NotificationKind::DefaultChanged:
+            key.group = 'd';
+            key.flow = notification.flow;
+            key.role = notification.role;
+            return key;
+        case NotificationKind::DeviceAdded:
+        case NotificationKind::DeviceRemoved:
+            key.group = 'e';
+            break;
+        case NotificationKind::StateChanged:
+            key.group = 's';
+            break;
+        case NotificationKind::VolumeChanged:
+            key.group = 'v';
+            break;
+        case NotificationKind::ServiceRestarted:
+            key.group = 'r';
+            return key;
+        default:
+            key.group = 'p';
+            break;
+        }
+        // Callback IDs come from the system, so interning non-standard ones stays bounded
+        key.endpoint = EndpointKey::Intern(notification.deviceId);
+        return key;
+    }
+
+    NotificationDispatcher::NotificationDispatcher(Sink sink, DispatcherOptions options)
+        : m_sink(std::move(sink)), m_options(std::move(options))
+    {
+        if (m_options.maxBatch == 0)
+            m_options.maxBatch = 1;
+        m_thread = std::thread([this]()
+                               {
+            if (m_options.threadScope)
+                m_options.threadScope([this]() { Run(); });
+            else
+                Run(); });
+    }
+
+    NotificationDispatcher::~NotificationDispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stopping.store(true);
+            m_sleeping.store(false);
+        }
+        m_wake.notify_one();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    int64_t NotificationDispatcher::NowMicros()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void NotificationDispatcher::Post(Notification notification)
+    {
+        if (notification.postedUs == 0)
+            notification.postedUs = NowMicros();
+        m_posted.fetch_add(1, std::memory_order_relaxed);
+        m_queue.Push(std::move(notification));
+
+        // The queue counts the element with a seq_cst increment before we read the flag,
+        // and WaitForWork sets the flag before reading the count: either the dispatcher
+        // sees this element on its re-check, or we see it asleep and wake it.
+        if (m_sleeping.load())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_sleeping.store(false, std::memory_order_relaxed);
+            }
+            m_wake.notify_one();
+        }
+    }
+
+    void NotificationDispatcher::WaitForWork()
+    {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleeping.store(true);
+        if (m_queue.Size() > 0 || m_stopping.load())
+        {
+            m_sleeping.store(false, std::memory_order_relaxed);
+            return;
+        }
+        m_wake.wait(lock, [this]()
+                    { return !m_sleeping.load(std::memory_order_relaxed) || m_stopping.load(); });
+    }
+
+    void NotificationDispatcher::Run()
+    {
+        const int64_t windowUs = m_options.batchWindow.count();
+
+        while (!m_stopping.load())
+        {
+            Notification notification;
+            if (!m_queue.TryPop(notification))
+            {
+                // Size() counts a push whose link is still in flight; spin briefly for it
+                if (m_queue.Size() > 0)
+                    std::this_thread::yield();
+                else
+                    WaitForWork();
+                continue;
+            }
+
+            // Collect the burst this callback starts, up to the window or the batch limit.
+            // Callbacks already queued have waited long enough and are folded as they are;
+            // past that the window is checked before every pop, so a steady stream (a
+            // volume slider drag) cannot hold the batch open.
+            const int64_t deadline = notification.postedUs + windowUs;
+            size_t backlog = m_queue.Size();
+            Fold(std::move(notification));
+            while (m_batch.size() < m_options.maxBatch && !m_stopping.load())
+            {
+                if (backlog > 0)
+                    --backlog;
+                else if (NowMicros() >= deadline)
+                    break;
+                if (m_queue.TryPop(notification))
+                {
+                    Fold(std::move(notification));
+                    continue;
+                }
+                backlog = 0;
+                const int64_t now = NowMicros();
+                if (now >= deadline)
+                    break;
+                std::this_thread::sleep_for(std::chrono::microseconds(std::min<int64_t>(deadline - now, 1000)));
+            }
+
+            if (!m_stopping.load())
+                Deliver();
+            m_batch.clear();
+            m_batchIndex.clear();
+        }
+    }
+
+    void NotificationDispatcher::Fold(Notification &&notification)
+    {
+        const FoldKey key = KeyOf(notification);
+        auto it = m_batchIndex.find(key);
+        if (it == m_batchIndex.end())
+        {
+            m_batchIndex.emplace(key, m_batch.size());
+            m_batch.push_back(std::move(notification));
+            return;
+        }
+
+        // Keep the slot (and arrival time) of the first callback, the payload of the latest
+        Notification &slot = m_batch[it->second];
+        const int64_t firstPosted = slot.postedUs;
+        const uint32_t folded = slot.coalesced + notification.coalesced + 1;
+        slot = std::move(notification);
+        slot.postedUs = firstPosted;
+        slot.coalesced = folded;
+
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.coalesced;
+    }
+
+    bool NotificationDispatcher::IsRepeat(const Notification &notification)
+    {
+        if (notification.kind == NotificationKind::DeviceAdded || notification.kind == NotificationKind::DeviceRemoved)
+        {
+            // A device that comes back starts from a clean slate
+            FoldKey key = KeyOf(notification);
+            key.group = 's';
+            m_lastSent.erase(key);
+            key.group = 'v';
+            m_lastSent.erase(key);
+            return false;
+        }
+        if (notification.kind == NotificationKind::ServiceRestarted)
+        {
+            // Nothing delivered before the restart can be trusted to still hold
+            m_lastSent.clear();
+            return false;
+        }
+        if (notification.kind == NotificationKind::PropertyChanged)
+            return false;
+
+        const FoldKey key = KeyOf(notification);
+        auto it = m_lastSent.find(key);
+        if (it != m_lastSent.end())
+        {
+            const Notification &last = it->second;
+            const bool same = notification.deviceId == last.deviceId && notification.state == last.state &&
+                              notification.volume == last.volume && notification.muted == last.muted;
+            if (same)
+                return true;
+            it->second = notification;
+            return false;
+        }
+        m_lastSent.emplace(key, notification);
+        return false;
+    }
+
+    void NotificationDispatcher::Deliver()
+    {
+        std::vector<Notification> batch;
+        batch.reserve(m_batch.size());
+        uint64_t suppressed = 0;
+        for (Notification &notification : m_batch)
+        {
+            if (IsRepeat(notification))
+                ++suppressed;
+            else
+                batch.push_back(std::move(notification));
+        }
+
+        const int64_t now = NowMicros();
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_stats.suppressed += suppressed;
+            if (!batch.empty())
+            {
+                ++m_stats.batches;
+                m_stats.delivered += batch.size();
+                for (const Notification &notification : batch)
+                    Accumulate(m_stats.dispatch, static_cast<double>(now - notification.postedUs));
+            }
+        }
+
+        if (!batch.empty() && m_sink)
+            m_sink(std::move(batch));
+    }
+
+    void NotificationDispatcher::RecordDelivery(const std::vector<Notification> &batch)
+    {
+        const int64_t now = NowMicros();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        for (const Notification &notification : batch)
+            Accumulate(m_stats.delivery, static_cast<double>(now - notification.postedUs));
+    }
+
+    void NotificationDispatcher::Accumulate(LatencyStats &stats, double us)
+    {
+        ++stats.count;
+        stats.lastUs = us;
+        stats.averageUs += (us - stats.averageUs) / static_cast<double>(stats.count);
+        stats.maxUs = std::max(stats.maxUs, us);
+    }
+
+    DispatcherStats NotificationDispatcher::Stats() const
+    {
+        DispatcherStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            stats = m_stats;
+        }
+        stats.posted = m_posted.load(std::memory_order_relaxed);
+        stats.queueDepth = m_queue.Size();
+        stats.queueHighWater = m_queue.HighWater();
+        return stats;
+    }
+
+    void NotificationDispatcher::ResetLatency()
+    {
+        m_queue.ResetHighWater();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.dispatch = LatencyStats();
+        m_stats.delivery = LatencyStats();
+    }
+}
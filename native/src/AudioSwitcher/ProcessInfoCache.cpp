@@ -0,0 +1,212 @@
+#include "AudioSwitcher/ProcessInfoCache.h"
+
+namespace AudioSwitcher
+{
+    ProcessInfoCache::ProcessInfoCache(std::shared_ptr<ProcessTable> table, size_t workers, size_t capacity)
+        : m_table(std::move(table)),
+          m_capacity(capacity ? capacity : 1)
+    {
+        for (size_t i = 0; i < (workers ? workers : 1); ++i)
+            m_workers.emplace_back(&ProcessInfoCache::WorkerLoop, this);
+    }
+
+    /**
+     * @brief Stops the resolver threads; queued pids are dropped.
+     */
+    ProcessInfoCache::~ProcessInfoCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            m_queue.clear();
+        }
+        m_workAvailable.notify_all();
+        for (std::thread &worker : m_workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Returns the cached entry, or queues the pid for the resolver pool.
+     */
+    ProcessLookup ProcessInfoCache::Lookup(uint32_t pid)
+    {
+        ProcessLookup result;
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto it = m_byPid.find(pid);
+        if (it != m_byPid.end())
+        {
+            // Move to the front of the LRU list without reallocating the node
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            ++m_stats.hits;
+            result.state = ProcessLookup::State::Ready;
+            result.key = it->second->key;
+            result.info = it->second->info;
+            return result;
+        }
+
+        if (m_gone.count(pid))
+        {
+            result.state = ProcessLookup::State::Gone;
+            result.key.pid = pid;
+            return result;
+        }
+
+        ++m_stats.misses;
+        result.key.pid = pid;
+        if (m_queued.insert(pid).second)
+        {
+            m_queue.push_back(pid);
+            lock.unlock();
+            m_workAvailable.notify_one();
+        }
+        return result;
+    }
+
+    ProcessLookup ProcessInfoCache::Peek(const ProcessKey &key)
+    {
+        ProcessLookup result;
+        result.state = ProcessLookup::State::Gone;
+        result.key = key;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byPid.find(key.pid);
+        if (it != m_byPid.end() && it->second->key == key)
+        {
+            ++m_stats.hits;
+            result.state = ProcessLookup::State::Ready;
+            result.info = it->second->info;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Drops the entry for @p key if it still describes that process instance.
+     */
+    void ProcessInfoCache::Invalidate(const ProcessKey &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byPid.find(key.pid);
+        if (it != m_byPid.end() && it->second->key == key)
+        {
+            Erase(it);
+            ++m_stats.invalidations;
+        }
+        m_gone.erase(key.pid);
+    }
+
+    /**
+     * @brief Drops any entry or "gone" marker for @p pid.
+     */
+    void ProcessInfoCache::InvalidatePid(uint32_t pid)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_byPid.find(pid);
+        if (it != m_byPid.end())
+        {
+            Erase(it);
+            ++m_stats.invalidations;
+        }
+        m_gone.erase(pid);
+    }
+
+    void ProcessInfoCache::Erase(std::unordered_map<uint32_t, LruList::iterator>::iterator it)
+    {
+        m_lru.erase(it->second);
+        m_byPid.erase(it);
+    }
+
+    /**
+     * @brief Publishes a resolved process, replacing an older process with the same pid
+     *        and evicting the least recently used entry if the cache is full.
+     */
+    void ProcessInfoCache::Insert(const ProcessKey &key, ProcessInfo info)
+    {
+        auto it = m_byPid.find(key.pid);
+        if (it != m_byPid.end())
+            Erase(it);
+
+        m_lru.push_front(Entry{key, std::move(info)});
+        m_byPid[key.pid] = m_lru.begin();
+
+        while (m_lru.size() > m_capacity)
+        {
+            m_byPid.erase(m_lru.back().key.pid);
+            m_lru.pop_back();
+            ++m_stats.evictions;
+        }
+    }
+
+    /**
+     * @brief Resolver thread: takes pids off the queue and queries the process table
+     *        without holding the lock.
+     *
+     * The start time is read before and after the query; if it changed, the pid was
+     * reused mid-query and the result (which may describe either process) is discarded.
+     */
+    void ProcessInfoCache::WorkerLoop()
+    {
+        for (;;)
+        {
+            uint32_t pid = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_workAvailable.wait(lock, [this]
+                                     { return m_stopping || !m_queue.empty(); });
+                if (m_stopping)
+                    return;
+                pid = m_queue.front();
+                m_queue.pop_front();
+                ++m_active;
+            }
+
+            ProcessKey key{pid, 0};
+            ProcessInfo info;
+            uint64_t after = 0;
+            const bool exists = m_table->GetStartTime(pid, key.startTime) && m_table->Query(pid, info) &&
+                                m_table->GetStartTime(pid, after);
+            const bool stable = exists && after == key.startTime;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_stats.resolutions;
+                if (stable)
+                    Insert(key, std::move(info));
+                else if (!exists)
+                {
+                    // Markers are only a guard against re-querying dead pids every listing
+                    if (m_gone.size() >= m_capacity)
+                        m_gone.clear();
+                    m_gone.insert(pid);
+                }
+                else
+                    m_queue.push_back(pid); // Reused mid-query: resolve the new process
+
+                if (stable || !exists)
+                    m_queued.erase(pid);
+                --m_active;
+            }
+            if (exists && !stable)
+                m_workAvailable.notify_one();
+            m_idle.notify_all();
+        }
+    }
+
+    /**
+     * @brief Waits for the resolver pool to drain (used by tests and by blocking callers).
+     */
+    void ProcessInfoCache::WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]
+                    { return m_stopping || (m_queue.empty() && m_active == 0); });
+    }
+
+    ProcessCacheStats ProcessInfoCache::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ProcessCacheStats stats = m_stats;
+        stats.size = m_lru.size();
+        stats.pending = m_queued.size();
+        return stats;
+    }
+}
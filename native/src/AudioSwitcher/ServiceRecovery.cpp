@@ -0,0 +1,289 @@
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/Logger.h"
+
+#include <algorithm>
+
+namespace AudioSwitcher
+{
+    bool IsServiceLostError(int32_t hr)
+    {
+        switch (hr)
+        {
+        case ServiceHResult::ServiceNotRunning:
+        case ServiceHResult::ServerDied:
+        case ServiceHResult::Disconnected:
+        case ServiceHResult::ServerDiedDne:
+        case ServiceHResult::ServerUnavailable:
+        case ServiceHResult::CallFailed:
+        case ServiceHResult::CallFailedDne:
+        case ServiceHResult::ObjectNotConnected:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    ServiceRecovery::ServiceRecovery(RecoveryOptions options)
+        : m_options(std::move(options))
+    {
+    }
+
+    ServiceRecovery::~ServiceRecovery()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    ServiceRecovery &ServiceRecovery::Instance()
+    {
+        static ServiceRecovery *instance = new ServiceRecovery(); // leaked: COM must not be touched during static destruction
+        return *instance;
+    }
+
+    void ServiceRecovery::Configure(Probe probe, RecoveryOptions options)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_probe = std::move(probe);
+        m_options = std::move(options);
+    }
+
+    void ServiceRecovery::SetReplay(ReplayActions actions)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_replay = std::move(actions);
+    }
+
+    uint64_t ServiceRecovery::AddHook(Hook hook)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hooks.emplace_back(m_nextId, std::move(hook));
+        return m_nextId++;
+    }
+
+    void ServiceRecovery::RemoveHook(uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hooks.erase(std::remove_if(m_hooks.begin(), m_hooks.end(), [id](const std::pair<uint64_t, Hook> &entry)
+                                     { return entry.first == id; }),
+                      m_hooks.end());
+    }
+
+    uint64_t ServiceRecovery::AddListener(Listener listener)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_listeners.emplace_back(m_nextId, std::move(listener));
+        return m_nextId++;
+    }
+
+    void ServiceRecovery::RemoveListener(uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(), [id](const std::pair<uint64_t, Listener> &entry)
+                                         { return entry.first == id; }),
+                          m_listeners.end());
+    }
+
+    bool ServiceRecovery::Report(int32_t hr)
+    {
+        if (!IsServiceLostError(hr))
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.detections;
+        m_stats.lastCause = hr;
+        if (!m_probe || m_stats.recovering || m_stopping)
+            return true;
+
+        AUDIO_LOG(Warn, "recovery", "Audio service lost (hr=0x%08X), recovering", static_cast<uint32_t>(hr));
+        m_stats.recovering = true;
+        m_stats.attempts = 0;
+        m_lostSince = std::chrono::steady_clock::now();
+        m_pending = true;
+        if (!m_thread.joinable())
+        {
+            m_thread = std::thread([this]()
+                                   {
+                std::function<void(const std::function<void()> &)> scope;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    scope = m_options.threadScope;
+                }
+                if (scope)
+                    scope([this]() { Run(); });
+                else
+                    Run(); });
+        }
+        m_wake.notify_all();
+        return true;
+    }
+
+    void ServiceRecovery::ThrowIfLost(int32_t hr, const char *what)
+    {
+        if (Report(hr))
+            throw ServiceLostError(std::string("[x] ") + what + ": audio service not running", hr);
+    }
+
+    void ServiceRecovery::RememberDefault(uint8_t flow, const std::wstring &id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_desired.defaults[flow] = id;
+    }
+
+    void ServiceRecovery::RememberDefaultMute(bool mute)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_desired.hasDefaultMute = true;
+        m_desired.defaultMute = mute;
+    }
+
+    void ServiceRecovery::RememberMute(const std::wstring &id, bool mute)
+    {
+        // The write succeeded, so the ID came from the system and interning it is bounded
+        const EndpointKey key = EndpointKey::Intern(id);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_muteIndex.find(key);
+        if (it != m_muteIndex.end())
+        {
+            m_desired.mutes[it->second].second = mute;
+            return;
+        }
+        m_muteIndex.emplace(key, m_desired.mutes.size());
+        m_desired.mutes.emplace_back(id, mute);
+    }
+
+    DesiredState ServiceRecovery::Desired() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_desired;
+    }
+
+    RecoveryStats ServiceRecovery::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    bool ServiceRecovery::WaitUntilHealthy(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_healthy.wait_for(lock, timeout, [this]()
+                                  { return !m_stats.recovering; });
+    }
+
+    void ServiceRecovery::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [this]()
+                        { return m_pending || m_stopping; });
+            if (m_stopping)
+                return;
+            m_pending = false;
+            if (!Recover(lock))
+                return;
+        }
+    }
+
+    bool ServiceRecovery::Recover(std::unique_lock<std::mutex> &lock)
+    {
+        std::chrono::milliseconds delay = m_options.initialDelay;
+        while (true)
+        {
+            // The service usually needs a moment to come back; probing at once just fails
+            if (m_wake.wait_for(lock, delay, [this]()
+                                { return m_stopping; }))
+                return false;
+            ++m_stats.attempts;
+
+            const Probe probe = m_probe;
+            const std::vector<std::pair<uint64_t, Hook>> hooks = m_hooks;
+            const DesiredState desired = m_desired;
+            const ReplayActions actions = m_replay;
+            lock.unlock();
+
+            bool recovered = false;
+            RecoveryEvent event;
+            try
+            {
+                recovered = probe();
+                if (recovered)
+                {
+                    for (const auto &hook : hooks)
+                        hook.second();
+                    event = Replay(desired, actions);
+                }
+            }
+            catch (const ServiceLostError &)
+            {
+                recovered = false; // went away again mid-recovery
+            }
+            catch (const std::exception &ex)
+            {
+                AUDIO_LOG(Error, "recovery", "Recovery step failed: %s", ex.what());
+                recovered = false;
+            }
+
+            lock.lock();
+            if (m_stopping)
+                return false;
+            if (!recovered)
+            {
+                delay = std::min(std::max(delay * 2, std::chrono::milliseconds(1)), m_options.maxDelay);
+                AUDIO_LOG(Debug, "recovery", "Audio service not back yet (attempt %u), retrying in %lld ms",
+                          m_stats.attempts, static_cast<long long>(delay.count()));
+                continue;
+            }
+
+            m_stats.recovering = false;
+            m_stats.lastDowntimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_lostSince).count();
+            event.generation = ++m_stats.restarts;
+            event.attempts = m_stats.attempts;
+            event.cause = m_stats.lastCause;
+            event.downtimeMs = m_stats.lastDowntimeMs;
+            const std::vector<std::pair<uint64_t, Listener>> listeners = m_listeners;
+            m_healthy.notify_all();
+
+            AUDIO_LOG(Info, "recovery", "Audio service recovered after %u attempt(s), %.0f ms; replayed %u write(s), %u failed",
+                      event.attempts, event.downtimeMs, event.replayed, event.replayFailed);
+
+            lock.unlock();
+            for (const auto &listener : listeners)
+                listener.second(event);
+            lock.lock();
+            return true;
+        }
+    }
+
+    RecoveryEvent ServiceRecovery::Replay(const DesiredState &desired, const ReplayActions &actions)
+    {
+        RecoveryEvent event;
+        auto count = [&event](bool ok)
+        {
+            if (ok)
+                ++event.replayed;
+            else
+                ++event.replayFailed;
+        };
+
+        // Defaults first: the default-mute write applies to whatever is default afterwards
+        if (actions.setDefault)
+        {
+            for (const auto &entry : desired.defaults)
+                count(actions.setDefault(entry.second, entry.first));
+        }
+        if (desired.hasDefaultMute && actions.setDefaultMute)
+            count(actions.setDefaultMute(desired.defaultMute));
+        if (actions.setMute)
+        {
+            for (const auto &entry : desired.mutes)
+                count(actions.setMute(entry.first, entry.second));
+        }
+        return event;
+    }
+}
@@ -0,0 +1,99 @@
+#include "AudioSwitcher/SessionProcessTracker.h"
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        /// Sessions whose owning process is looked up (not System Sounds, not pid 0).
+        bool IsTracked(const SessionInfo &session)
+        {
+            return !session.systemSounds && session.pid != 0;
+        }
+    }
+
+    SessionProcessTracker::SessionProcessTracker(ProcessInfoCache &cache)
+        : m_cache(cache)
+    {
+    }
+
+    /**
+     * @brief Drops the cache entry a retired session pointed at. A session that was still
+     *        pending when last listed only knew its pid, so whatever was resolved for that
+     *        pid since goes.
+     */
+    void SessionProcessTracker::Retire(const ProcessKey &key)
+    {
+        if (key.startTime != 0)
+            m_cache.Invalidate(key);
+        else
+            m_cache.InvalidatePid(key.pid);
+    }
+
+    /**
+     * @brief Retires sessions that ended, then attaches process info to the rest.
+     *
+     * An expired session that was listed before is described by exactly the process it
+     * was resolved to (if that is still cached), never by a newer process with its pid.
+     * A session seen for the first time clears a stale "exited" marker for its pid, since
+     * a new process may have reused it.
+     */
+    void SessionProcessTracker::Reconcile(const std::wstring &deviceId, std::vector<SessionInfo> &sessions)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::map<std::wstring, ProcessKey> &previous = m_previous[EndpointKey::Intern(deviceId)];
+
+        std::map<std::wstring, SessionInfo *> listed;
+        for (SessionInfo &session : sessions)
+        {
+            if (IsTracked(session))
+                listed[session.sessionId] = &session;
+        }
+        for (const auto &entry : previous)
+        {
+            auto it = listed.find(entry.first);
+            if (it == listed.end())
+            {
+                Retire(entry.second);
+                continue;
+            }
+            SessionInfo &session = *it->second;
+            if (session.state == kSessionStateExpired)
+            {
+                session.process = m_cache.Peek(entry.second);
+                Retire(entry.second);
+            }
+        }
+
+        std::map<std::wstring, ProcessKey> current;
+        for (SessionInfo &session : sessions)
+        {
+            if (!IsTracked(session))
+            {
+                session.process.state = ProcessLookup::State::Ready;
+                session.process.key.pid = session.pid;
+                session.process.info.name = L"System Sounds";
+                continue;
+            }
+
+            const bool known = previous.count(session.sessionId) != 0;
+            if (session.state == kSessionStateExpired)
+            {
+                if (known)
+                    continue; // described and retired above
+                session.process = m_cache.Lookup(session.pid);
+                if (session.process.state == ProcessLookup::State::Ready)
+                    m_cache.Invalidate(session.process.key);
+                continue;
+            }
+
+            session.process = m_cache.Lookup(session.pid);
+            if (!known && session.process.state == ProcessLookup::State::Gone)
+            {
+                m_cache.InvalidatePid(session.pid);
+                session.process = m_cache.Lookup(session.pid);
+            }
+            current[session.sessionId] = session.process.key;
+        }
+        previous.swap(current);
+    }
+}
@@ -0,0 +1,197 @@
+#include "AudioSwitcher/SessionSnapshot.h"
+#include "AudioSwitcher/Win32ProcessTable.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/SafeRelease.h"
+
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audiopolicy.h>
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        constexpr size_t kResolverThreads = 2;
+        constexpr size_t kCacheCapacity = 512;
+
+        static_assert(kSessionStateExpired == AudioSessionStateExpired, "Session state values must match AudioSessionState");
+
+        /// Copies a CoTaskMem string into a wstring and frees it.
+        std::wstring TakeString(LPWSTR value)
+        {
+            std::wstring result;
+            if (value)
+            {
+                result = value;
+                CoTaskMemFree(value);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Appends the sessions of one endpoint to @p out.
+         */
+        void ListDeviceSessions(IMMDevice *device, const std::wstring &deviceId, std::vector<SessionInfo> &out)
+        {
+            IAudioSessionManager2 *manager = nullptr;
+            if (FAILED(device->Activate(__uuidof(IAudioSessionManager2), CLSCTX_ALL, nullptr, (void **)&manager)) || !manager)
+                return;
+
+            IAudioSessionEnumerator *sessions = nullptr;
+            if (FAILED(manager->GetSessionEnumerator(&sessions)) || !sessions)
+            {
+                SafeRelease(manager);
+                return;
+            }
+
+            int count = 0;
+            sessions->GetCount(&count);
+            for (int i = 0; i < count; ++i)
+            {
+                IAudioSessionControl *control = nullptr;
+                if (FAILED(sessions->GetSession(i, &control)) || !control)
+                    continue;
+
+                IAudioSessionControl2 *control2 = nullptr;
+                if (FAILED(control->QueryInterface(__uuidof(IAudioSessionControl2), (void **)&control2)) || !control2)
+                {
+                    SafeRelease(control);
+                    continue;
+                }
+
+                SessionInfo info;
+                info.deviceId = deviceId;
+
+                DWORD pid = 0;
+                control2->GetProcessId(&pid); // AUDCLNT_S_NO_SINGLE_PROCESS still reports the creator
+                info.pid = pid;
+                info.systemSounds = control2->IsSystemSoundsSession() == S_OK;
+
+                LPWSTR text = nullptr;
+                if (SUCCEEDED(control2->GetSessionInstanceIdentifier(&text)))
+                    info.sessionId = TakeString(text);
+                text = nullptr;
+                if (SUCCEEDED(control2->GetDisplayName(&text)))
+                    info.displayName = TakeString(text);
+                text = nullptr;
+                if (SUCCEEDED(control2->GetIconPath(&text)))
+                    info.iconPath = TakeString(text);
+
+                AudioSessionState state = AudioSessionStateInactive;
+                control2->GetState(&state);
+                info.state = state;
+
+                ISimpleAudioVolume *volume = nullptr;
+                if (SUCCEEDED(control2->QueryInterface(__uuidof(ISimpleAudioVolume), (void **)&volume)) && volume)
+                {
+                    BOOL muted = FALSE;
+                    volume->GetMasterVolume(&info.volume);
+                    volume->GetMute(&muted);
+                    info.muted = muted != FALSE;
+                    SafeRelease(volume);
+                }
+
+                SafeRelease(control2);
+                SafeRelease(control);
+                out.push_back(std::move(info));
+            }
+
+            SafeRelease(sessions);
+            SafeRelease(manager);
+        }
+    }
+
+    SessionSnapshot::SessionSnapshot()
+        : m_cache(std::make_unique<ProcessInfoCache>(std::make_shared<Win32ProcessTable>(), kResolverThreads, kCacheCapacity)),
+          m_tracker(*m_cache)
+    {
+    }
+
+    /**
+     * @brief Returns the process-wide instance. Leaked so resolver threads are never
+     *        joined during static destruction.
+     */
+    SessionSnapshot &SessionSnapshot::Instance()
+    {
+        static SessionSnapshot *instance = new SessionSnapshot();
+        return *instance;
+    }
+
+    /**
+     * @brief Enumerates sessions and attaches cached process information.
+     */
+    std::vector<SessionInfo> SessionSnapshot::List(const std::wstring &deviceId)
+    {
+        std::vector<std::pair<std::wstring, std::vector<SessionInfo>>> perDevice;
+
+        if (!deviceId.empty())
+        {
+            IMMDevice *device = GetDeviceById(deviceId);
+            if (!device)
+                throw std::runtime_error("[x] Device not found.");
+            perDevice.emplace_back(deviceId, std::vector<SessionInfo>());
+            ListDeviceSessions(device, deviceId, perDevice.back().second);
+            SafeRelease(device);
+        }
+        else
+        {
+            IMMDeviceEnumerator *pEnum = AudioRuntime::Instance().AcquireEnumerator();
+            if (!pEnum)
+                throw std::runtime_error("[x] Failed to create device enumerator.");
+
+            IMMDeviceCollection *devices = nullptr;
+            HRESULT hr = pEnum->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &devices);
+            SafeRelease(pEnum);
+            if (FAILED(hr) || !devices)
+                throw std::runtime_error("[x] Failed to enumerate audio endpoints.");
+
+            UINT count = 0;
+            devices->GetCount(&count);
+            for (UINT i = 0; i < count; ++i)
+            {
+                IMMDevice *device = nullptr;
+                LPWSTR id = nullptr;
+                if (FAILED(devices->Item(i, &device)) || !device)
+                    continue;
+                if (SUCCEEDED(device->GetId(&id)) && id)
+                {
+                    perDevice.emplace_back(TakeString(id), std::vector<SessionInfo>());
+                    ListDeviceSessions(device, perDevice.back().first, perDevice.back().second);
+                }
+                SafeRelease(device);
+            }
+            SafeRelease(devices);
+        }
+
+        std::vector<SessionInfo> result;
+        for (auto &entry : perDevice)
+        {
+            m_tracker.Reconcile(entry.first, entry.second);
+            for (SessionInfo &session : entry.second)
+                result.push_back(std::move(session));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Waits for the resolver pool, then fills in sessions that were still pending.
+     */
+    void SessionSnapshot::WaitForProcessNames(std::vector<SessionInfo> &sessions)
+    {
+        m_cache->WaitIdle();
+        for (SessionInfo &session : sessions)
+        {
+            if (session.process.state == ProcessLookup::State::Pending)
+                session.process = m_cache->Lookup(session.pid);
+        }
+    }
+
+    ProcessCacheStats SessionSnapshot::CacheStats() const
+    {
+        return m_cache->Stats();
+    }
+}
@@ -0,0 +1,73 @@
+#include "AudioSwitcher/TopologyGraph.h"
+
+namespace AudioSwitcher
+{
+    uint8_t EndpointTopology::Controls() const
+    {
+        uint8_t controls = 0;
+        for (const TopologyPart &part : parts)
+            controls |= part.controls;
+        return controls;
+    }
+
+    TopologyCache &TopologyCache::Instance()
+    {
+        static TopologyCache *cache = new TopologyCache();
+        return *cache;
+    }
+
+    std::shared_ptr<const EndpointTopology> TopologyCache::Get(const EndpointKey &key, const Builder &build)
+    {
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end())
+            {
+                ++m_stats.hits;
+                return it->second;
+            }
+            generation = m_generation;
+        }
+
+        // Walk without the lock: it is slow and may block on a driver
+        std::shared_ptr<const EndpointTopology> topology = build();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.builds;
+        if (topology && generation == m_generation)
+            m_entries[key] = topology;
+        return topology;
+    }
+
+    std::shared_ptr<const EndpointTopology> TopologyCache::Peek(const EndpointKey &key) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        return it == m_entries.end() ? nullptr : it->second;
+    }
+
+    void TopologyCache::Invalidate(const EndpointKey &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        if (m_entries.erase(key))
+            ++m_stats.invalidations;
+    }
+
+    void TopologyCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        m_stats.invalidations += m_entries.size();
+        m_entries.clear();
+    }
+
+    TopologyCacheStats TopologyCache::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TopologyCacheStats stats = m_stats;
+        stats.size = m_entries.size();
+        return stats;
+    }
+}
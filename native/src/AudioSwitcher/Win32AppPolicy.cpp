@@ -0,0 +1,107 @@
+#include "AudioSwitcher/Win32AppPolicy.h"
+#include "AudioSwitcher/IAudioPolicyConfig.h"
+#include "Utility/SafeRelease.h"
+
+#include <roapi.h>
+#include <tlhelp32.h>
+#include <winstring.h>
+
+namespace AudioSwitcher
+{
+    Win32AppPolicy::~Win32AppPolicy()
+    {
+        Reset();
+    }
+
+    /**
+     * @brief Lists running processes from one Toolhelp snapshot.
+     */
+    bool Win32AppPolicy::ListProcesses(std::vector<AppProcess> &processes)
+    {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return false;
+
+        PROCESSENTRY32W entry = {};
+        entry.dwSize = sizeof(entry);
+        processes.clear();
+        for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry))
+            processes.push_back({entry.th32ProcessID, AppRoutingTable::NormalizeExe(entry.szExeFile)});
+        CloseHandle(snapshot);
+        return true;
+    }
+
+    /**
+     * @brief Writes the per-process default; an empty ID resets it to the system default.
+     */
+    int32_t Win32AppPolicy::SetEndpoint(uint32_t pid, uint8_t flow, uint8_t role, const std::wstring &deviceId)
+    {
+        int32_t hr = S_OK;
+        IAudioPolicyConfigFactory *factory = AcquireFactory(hr);
+        if (!factory)
+            return hr;
+
+        HSTRING path = nullptr;
+        if (!deviceId.empty())
+        {
+            const std::wstring full = AUDIO_POLICY_DEVICE_PREFIX + deviceId +
+                                      (flow == eCapture ? AUDIO_POLICY_CAPTURE_INTERFACE : AUDIO_POLICY_RENDER_INTERFACE);
+            hr = WindowsCreateString(full.c_str(), static_cast<UINT32>(full.size()), &path);
+        }
+        if (SUCCEEDED(hr))
+            hr = factory->SetPersistedDefaultAudioEndpoint(pid, static_cast<EDataFlow>(flow), static_cast<ERole>(role), path);
+
+        WindowsDeleteString(path);
+        Utility::SafeRelease(factory);
+        return hr;
+    }
+
+    int32_t Win32AppPolicy::ClearAll()
+    {
+        int32_t hr = S_OK;
+        IAudioPolicyConfigFactory *factory = AcquireFactory(hr);
+        if (!factory)
+            return hr;
+
+        hr = factory->ClearAllPersistedApplicationDefaultEndpoints();
+        Utility::SafeRelease(factory);
+        return hr;
+    }
+
+    void Win32AppPolicy::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Utility::SafeRelease(m_factory);
+    }
+
+    /**
+     * @brief Activates the factory on first use, trying the current IID before the
+     *        one used up to Windows 10 21H1.
+     */
+    IAudioPolicyConfigFactory *Win32AppPolicy::AcquireFactory(int32_t &hr)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_factory)
+        {
+            HSTRING_HEADER header;
+            HSTRING className = nullptr;
+            hr = WindowsCreateStringReference(AUDIO_POLICY_CONFIG_CLASS,
+                                              static_cast<UINT32>(wcslen(AUDIO_POLICY_CONFIG_CLASS)), &header, &className);
+            if (FAILED(hr))
+                return nullptr;
+
+            hr = RoGetActivationFactory(className, __uuidof(IAudioPolicyConfigFactory), (void **)&m_factory);
+            if (hr == E_NOINTERFACE)
+                hr = RoGetActivationFactory(className, IID_IAudioPolicyConfigFactoryDownlevel, (void **)&m_factory);
+            if (FAILED(hr) || !m_factory)
+            {
+                m_factory = nullptr;
+                return nullptr;
+            }
+        }
+
+        m_factory->AddRef();
+        return m_factory;
+    }
+}
@@ -0,0 +1,68 @@
+#include "AudioSwitcher/Win32ProcessTable.h"
+
+#include <windows.h>
+
+namespace AudioSwitcher
+{
+    namespace
+    {
+        /**
+         * @brief Opens a process for limited queries.
+         * @param[out] exists False only if the pid does not name a running process.
+         */
+        HANDLE OpenForQuery(uint32_t pid, bool &exists)
+        {
+            HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+            exists = process != nullptr || GetLastError() == ERROR_ACCESS_DENIED;
+            return process;
+        }
+    }
+
+    /**
+     * @brief Reads the creation time of a process (0 if it exists but cannot be opened).
+     */
+    bool Win32ProcessTable::GetStartTime(uint32_t pid, uint64_t &startTime)
+    {
+        bool exists = false;
+        HANDLE process = OpenForQuery(pid, exists);
+        startTime = 0;
+        if (!process)
+            return exists;
+
+        FILETIME creation, exit, kernel, user;
+        if (GetProcessTimes(process, &creation, &exit, &kernel, &user))
+            startTime = (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+
+        // A handle can outlive the process; an exit code other than STILL_ACTIVE means it is gone
+        DWORD exitCode = 0;
+        const bool running = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+        CloseHandle(process);
+        return running;
+    }
+
+    /**
+     * @brief Reads the full image path and derives the executable name from it.
+     */
+    bool Win32ProcessTable::Query(uint32_t pid, ProcessInfo &info)
+    {
+        bool exists = false;
+        HANDLE process = OpenForQuery(pid, exists);
+        if (!process)
+        {
+            info.accessible = false;
+            return exists;
+        }
+
+        wchar_t path[MAX_PATH * 2];
+        DWORD length = static_cast<DWORD>(sizeof(path) / sizeof(path[0]));
+        if (QueryFullProcessImageNameW(process, 0, path, &length))
+        {
+            info.path.assign(path, length);
+            const size_t slash = info.path.find_last_of(L"\\/");
+            info.name = slash == std::wstring::npos ? info.path : info.path.substr(slash + 1);
+            info.accessible = true;
+        }
+        CloseHandle(process);
+        return true;
+    }
+}
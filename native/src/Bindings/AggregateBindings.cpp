@@ -0,0 +1,305 @@
+/**
+ * @file AggregateBindings.cpp
+ * @brief N-API bindings for aggregate outputs: one source played time-aligned on several
+ *        render endpoints.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "Streaming/AggregateRenderer.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Running aggregates by id. Like passthrough routes, they outlive the calls
+         *        that created them and are stopped explicitly or at environment shutdown.
+         */
+        struct AggregateRegistry
+        {
+            std::mutex mutex;
+            std::map<uint32_t, std::shared_ptr<AggregateRenderer>> renderers;
+            uint32_t nextId = 1;
+        };
+
+        AggregateRegistry &Registry()
+        {
+            static AggregateRegistry *registry = new AggregateRegistry();
+            return *registry;
+        }
+
+        std::shared_ptr<AggregateRenderer> FindRenderer(uint32_t id)
+        {
+            AggregateRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.renderers.find(id);
+            return it == registry.renderers.end() ? nullptr : it->second;
+        }
+
+        /**
+         * @brief Stops every aggregate; runs when the Node environment is torn down.
+         */
+        void StopAllRenderers()
+        {
+            std::map<uint32_t, std::shared_ptr<AggregateRenderer>> renderers;
+            {
+                AggregateRegistry &registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                renderers.swap(registry.renderers);
+            }
+            for (auto &entry : renderers)
+                entry.second->Stop();
+        }
+
+        /**
+         * @brief Reads one entry of `endpoints`: an id string, or `{ id?, delayMs? }`.
+         * @return False if the entry has the wrong shape.
+         */
+        bool ReadEndpoint(const Napi::Value &value, AggregateEndpoint &endpoint)
+        {
+            if (value.IsString())
+            {
+                endpoint.id = ToWString(value);
+                return true;
+            }
+            if (!value.IsObject())
+                return false;
+
+            Napi::Object obj = value.As<Napi::Object>();
+            Napi::Value id = obj.Get("id");
+            Napi::Value delayMs = obj.Get("delayMs");
+            if (!(id.IsUndefined() || id.IsString()) || !(delayMs.IsUndefined() || delayMs.IsNumber()))
+                return false;
+            if (id.IsString())
+                endpoint.id = ToWString(id);
+            if (delayMs.IsNumber())
+                endpoint.delayMs = delayMs.As<Napi::Number>().DoubleValue();
+            return true;
+        }
+    }
+
+    /**
+     * @brief   Starts playing one source on several render endpoints, time-aligned.
+     *
+     * @details The source is captured once into a shared lock-free buffer; every endpoint
+     *          reads it on its own real-time thread, compensating its output delay and
+     *          clock drift, so all endpoints are heard the same latency after capture.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: `{ endpoints: Array<string | { id?: string, delayMs?: number }>,
+     *                sourceId?: string, loopback?: boolean, latencyMs?: number }`. An omitted
+     *                source is the default capture endpoint (default render with `loopback`);
+     *                an omitted delay is the engine's reported stream latency.
+     * @return  Napi::Number Aggregate id for stopAggregate / getAggregateStats / setAggregateDelay
+     * @throws  Napi::Error When an endpoint cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * const id = startAggregate({ loopback: true, endpoints: [speakersId, { id: btId, delayMs: 180 }] });
+     */
+    Napi::Value StartAggregate(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        const char *usage = "Expected { endpoints: Array<string | { id?: string, delayMs?: number }>, sourceId?: string, loopback?: boolean, latencyMs?: number }";
+
+        if (info.Length() < 1 || !info[0].IsObject())
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object obj = info[0].As<Napi::Object>();
+        Napi::Value endpoints = obj.Get("endpoints");
+        Napi::Value sourceId = obj.Get("sourceId");
+        Napi::Value loopback = obj.Get("loopback");
+        Napi::Value latencyMs = obj.Get("latencyMs");
+        if (!endpoints.IsArray() || !(sourceId.IsUndefined() || sourceId.IsString()) ||
+            !(loopback.IsUndefined() || loopback.IsBoolean()) || !(latencyMs.IsUndefined() || latencyMs.IsNumber()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        AggregateOptions options;
+        Napi::Array list = endpoints.As<Napi::Array>();
+        for (uint32_t i = 0; i < list.Length(); ++i)
+        {
+            AggregateEndpoint endpoint;
+            if (!ReadEndpoint(list.Get(i), endpoint))
+            {
+                Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.endpoints.push_back(std::move(endpoint));
+        }
+        if (sourceId.IsString())
+            options.sourceId = ToWString(sourceId);
+        if (loopback.IsBoolean())
+            options.loopback = loopback.As<Napi::Boolean>().Value();
+        if (latencyMs.IsNumber())
+            options.latencyMs = latencyMs.As<Napi::Number>().DoubleValue();
+
+        try
+        {
+            std::shared_ptr<AggregateRenderer> renderer = OperationSupervisor::Instance().Run(L"aggregate", [options]()
+                                                                                              {
+                COMInitializer com;
+                auto renderer = std::make_shared<AggregateRenderer>(options);
+                renderer->Start();
+                return renderer; });
+
+            AggregateRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const uint32_t id = registry.nextId++;
+            registry.renderers.emplace(id, std::move(renderer));
+            return Napi::Number::New(env, id);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to start aggregate output");
+        }
+    }
+
+    /**
+     * @brief   Stops an aggregate output and releases every endpoint.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Aggregate id returned by startAggregate
+     * @return  Napi::Boolean true if the aggregate existed
+     */
+    Napi::Value StopAggregate(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Aggregate id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<AggregateRenderer> renderer;
+        {
+            AggregateRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.renderers.find(info[0].As<Napi::Number>().Uint32Value());
+            if (it == registry.renderers.end())
+                return Napi::Boolean::New(env, false);
+            renderer = std::move(it->second);
+            registry.renderers.erase(it);
+        }
+
+        try
+        {
+            OperationSupervisor::Instance().Run(L"aggregate", [renderer]()
+                                                { renderer->Stop(); });
+            return Napi::Boolean::New(env, true);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop aggregate output");
+        }
+    }
+
+    /**
+     * @brief   Changes the compensated delay of one endpoint of an aggregate, e.g. with a
+     *          value from measureLatency(). The endpoint realigns within one period.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Aggregate id returned by startAggregate
+     *              - args[1]: Index of the endpoint in the `endpoints` option
+     *              - args[2]: Delay in ms after the render buffer (negative = stream latency)
+     * @return  Napi::Boolean false for an unknown id or index, or a delay beyond the
+     *              audio the source keeps
+     */
+    Napi::Value SetAggregateDelay(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber())
+        {
+            Napi::TypeError::New(env, "Expected (id: number, index: number, delayMs: number)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<AggregateRenderer> renderer = FindRenderer(info[0].As<Napi::Number>().Uint32Value());
+        if (!renderer)
+            return Napi::Boolean::New(env, false);
+        return Napi::Boolean::New(env, renderer->SetDelay(info[1].As<Napi::Number>().Uint32Value(),
+                                                          info[2].As<Napi::Number>().DoubleValue()));
+    }
+
+    /**
+     * @brief   Returns the counters of an aggregate output.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Aggregate id returned by startAggregate
+     * @return  Napi::Value `{ running, error, sourceRate, sourceChannels, latencyMs,
+     *              endpoints: [{ id, running, error, sampleRate, channels, aligned, underruns,
+     *              laps, renderedFrames, delayMs, errorMs, driftPpm }] }`, or null for an
+     *              unknown id
+     */
+    Napi::Value GetAggregateStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Aggregate id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<AggregateRenderer> renderer = FindRenderer(info[0].As<Napi::Number>().Uint32Value());
+        if (!renderer)
+            return env.Null();
+
+        const AggregateStats stats = renderer->Stats();
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("running", Napi::Boolean::New(env, stats.running));
+        obj.Set("error", stats.error.empty() ? env.Null() : Napi::String::New(env, stats.error));
+        obj.Set("sourceRate", Napi::Number::New(env, stats.sourceRate));
+        obj.Set("sourceChannels", Napi::Number::New(env, stats.sourceChannels));
+        obj.Set("latencyMs", Napi::Number::New(env, renderer->LatencyMs()));
+
+        Napi::Array endpoints = Napi::Array::New(env, stats.endpoints.size());
+        for (size_t i = 0; i < stats.endpoints.size(); ++i)
+        {
+            const AggregateEndpointStats &endpoint = stats.endpoints[i];
+            Napi::Object item = Napi::Object::New(env);
+            item.Set("id", ToJsString(env, endpoint.id));
+            item.Set("running", Napi::Boolean::New(env, endpoint.running));
+            item.Set("error", endpoint.error.empty() ? env.Null() : Napi::String::New(env, endpoint.error));
+            item.Set("sampleRate", Napi::Number::New(env, endpoint.sampleRate));
+            item.Set("channels", Napi::Number::New(env, endpoint.channels));
+            item.Set("aligned", Napi::Boolean::New(env, endpoint.tap.aligned));
+            item.Set("underruns", Napi::Number::New(env, static_cast<double>(endpoint.tap.underruns)));
+            item.Set("laps", Napi::Number::New(env, static_cast<double>(endpoint.tap.laps)));
+            item.Set("renderedFrames", Napi::Number::New(env, static_cast<double>(endpoint.tap.renderedFrames)));
+            item.Set("delayMs", Napi::Number::New(env, endpoint.tap.delayMs));
+            item.Set("errorMs", Napi::Number::New(env, endpoint.tap.errorMs));
+            item.Set("driftPpm", Napi::Number::New(env, endpoint.tap.correctionPpm));
+            endpoints.Set(static_cast<uint32_t>(i), item);
+        }
+        obj.Set("endpoints", endpoints);
+        return obj;
+    }
+
+    /**
+     * @brief Registers aggregate output functions on the module exports.
+     */
+    void InitAggregateBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("startAggregate", Napi::Function::New(env, StartAggregate));
+        exports.Set("stopAggregate", Napi::Function::New(env, StopAggregate));
+        exports.Set("setAggregateDelay", Napi::Function::New(env, SetAggregateDelay));
+        exports.Set("getAggregateStats", Napi::Function::New(env, GetAggregateStats));
+        env.AddCleanupHook(StopAllRenderers);
+    }
+}
@@ -0,0 +1,342 @@
+/**
+ * @file AppRoutingBindings.cpp
+ * @brief N-API bindings for per-application default endpoints ("App volume and device
+ *        preferences"), applied in batches through a cached routing table.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/AppRouting.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "AudioSwitcher/Win32AppPolicy.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <mmdeviceapi.h>
+#include <mutex>
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        const std::shared_ptr<Win32AppPolicy> &Policy()
+        {
+            static auto *policy = new std::shared_ptr<Win32AppPolicy>(std::make_shared<Win32AppPolicy>());
+            return *policy;
+        }
+
+        AppRoutingTable &Table()
+        {
+            static AppRoutingTable *table = new AppRoutingTable(Policy());
+            return *table;
+        }
+
+        const char *RoleName(uint8_t role)
+        {
+            switch (role)
+            {
+            case eConsole:
+                return "console";
+            case eMultimedia:
+                return "multimedia";
+            default:
+                return "communications";
+            }
+        }
+
+        /**
+         * @brief Parses one `{ app, id, flow?, role? }` into assignments (three for role
+         *        'all'). Returns an error message, or nullptr on success.
+         */
+        const char *ParseAssignment(const Napi::Value &app, const Napi::Value &id, const Napi::Value &flow,
+                                    const Napi::Value &role, std::vector<AppAssignment> &out)
+        {
+            AppAssignment assignment;
+            if (app.IsNumber())
+            {
+                const double pid = app.As<Napi::Number>().DoubleValue();
+                if (pid < 1 || pid > 0xFFFFFFFFu || pid != static_cast<double>(static_cast<uint32_t>(pid)))
+                    return "Expected app to be a process ID or an executable name";
+                assignment.target.pid = static_cast<uint32_t>(pid);
+            }
+            else if (app.IsString() && !app.As<Napi::String>().Utf8Value().empty())
+                assignment.target.exe = AppRoutingTable::NormalizeExe(ToWString(app));
+            else
+                return "Expected app to be a process ID or an executable name";
+
+            if (id.IsString())
+                assignment.deviceId = ToWString(id);
+            else if (!id.IsNull() && !id.IsUndefined())
+                return "Expected id to be a device ID string or null";
+
+            assignment.flow = static_cast<uint8_t>(eRender);
+            if (flow.IsString() && flow.As<Napi::String>().Utf8Value() == "capture")
+                assignment.flow = static_cast<uint8_t>(eCapture);
+            else if (!flow.IsUndefined() && !flow.IsNull() && !(flow.IsString() && flow.As<Napi::String>().Utf8Value() == "render"))
+                return "Expected flow: 'render' | 'capture'";
+
+            std::string roleName = "all";
+            if (role.IsString())
+                roleName = role.As<Napi::String>().Utf8Value();
+            else if (!role.IsUndefined() && !role.IsNull())
+                return "Expected role: 'console' | 'multimedia' | 'communications' | 'all'";
+
+            if (roleName == "all")
+            {
+                for (uint8_t r : {eConsole, eMultimedia, eCommunications})
+                {
+                    assignment.role = r;
+                    out.push_back(assignment);
+                }
+                return nullptr;
+            }
+            if (roleName == "console")
+                assignment.role = eConsole;
+            else if (roleName == "multimedia")
+                assignment.role = eMultimedia;
+            else if (roleName == "communications")
+                assignment.role = eCommunications;
+            else
+                return "Expected role: 'console' | 'multimedia' | 'communications' | 'all'";
+            out.push_back(assignment);
+            return nullptr;
+        }
+
+        /**
+         * @brief Applies a batch under the watchdog; a lost audio service is thrown.
+         */
+        AppBatchResult ApplyBatch(std::vector<AppAssignment> assignments, bool reconcile)
+        {
+            const AppBatchResult result = OperationSupervisor::Instance().Run(L"app-routing", [&assignments, reconcile]()
+                                                                              {
+                COMInitializer com;
+                return reconcile ? Table().Reconcile() : Table().Apply(assignments); });
+            if (result.failed)
+                ServiceRecovery::Instance().ThrowIfLost(result.lastError, "Failed to set app endpoint");
+            return result;
+        }
+
+        Napi::Object ResultToObject(Napi::Env env, const AppBatchResult &result)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("applied", Napi::Number::New(env, result.applied));
+            obj.Set("unchanged", Napi::Number::New(env, result.unchanged));
+            obj.Set("failed", Napi::Number::New(env, result.failed));
+            obj.Set("unresolved", Napi::Number::New(env, result.unresolved));
+            if (result.failed)
+                obj.Set("hresult", Napi::Number::New(env, static_cast<uint32_t>(result.lastError)));
+            return obj;
+        }
+
+        /// Registers the service-restart hook once per process.
+        void ConfigureRecovery()
+        {
+            // The factory died with the service, and what Windows holds is unknown until rewritten
+            ServiceRecovery::Instance().AddHook([]()
+                                                {
+                Policy()->Reset();
+                Table().Invalidate(); });
+        }
+    }
+
+    /**
+     * @brief   Routes one application to an endpoint without changing the system default.
+     *
+     * @details Uses the per-process default endpoint that Settings > "App volume and device
+     *          preferences" writes (Windows 10 1803+). An executable name applies to every
+     *          running process of that executable and is remembered, so
+     *          refreshAppEndpoints() can extend it to processes started later. A write the
+     *          table shows is already in effect is skipped.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: process ID (number) or executable name / path (string)
+     *              - args[1]: endpoint ID, or null to follow the system default again
+     *              - args[2] (optional): 'render' (default) | 'capture'
+     *              - args[3] (optional): 'console' | 'multimedia' | 'communications' |
+     *                'all' (default)
+     * @return  Napi::Boolean true if the app had a running process and every write succeeded
+     *
+     * @example
+     * // JavaScript usage:
+     * setAppEndpoint('Teams.exe', headsetId);
+     */
+    Napi::Value SetAppEndpoint(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        std::vector<AppAssignment> assignments;
+        if (const char *error = ParseAssignment(info[0], info[1], info[2], info[3], assignments))
+        {
+            Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        try
+        {
+            const AppBatchResult result = ApplyBatch(std::move(assignments), false);
+            return Napi::Boolean::New(env, result.failed == 0 && result.unresolved == 0);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Applies many per-application assignments in one batch (a scene change).
+     *
+     * @details Executables are resolved with one process listing for the whole batch,
+     *          later entries for the same app, flow and role override earlier ones, and
+     *          writes already in effect are skipped.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: `Array<{ app: number | string, id: string | null,
+     *                flow?: 'render' | 'capture', role?: string }>`
+     * @return  Napi::Object `{ applied, unchanged, failed, unresolved, hresult? }`
+     *
+     * @example
+     * // JavaScript usage:
+     * setAppEndpoints([
+     *     { app: 'Teams.exe', id: headsetId },
+     *     { app: 'Teams.exe', id: headsetMicId, flow: 'capture' },
+     *     { app: 'chrome.exe', id: speakersId },
+     * ]);
+     */
+    Napi::Value SetAppEndpoints(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected an array of { app, id, flow?, role? }").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<AppAssignment> assignments;
+        Napi::Array list = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < list.Length(); ++i)
+        {
+            Napi::Value item = list.Get(i);
+            if (!item.IsObject())
+            {
+                Napi::TypeError::New(env, "Expected an array of { app, id, flow?, role? }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Object entry = item.As<Napi::Object>();
+            if (const char *error = ParseAssignment(entry.Get("app"), entry.Get("id"), entry.Get("flow"), entry.Get("role"), assignments))
+            {
+                Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+                return env.Null();
+            }
+        }
+
+        try
+        {
+            return ResultToObject(env, ApplyBatch(std::move(assignments), false));
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns the per-application assignments made through this module.
+     *
+     * @details Served from the routing table without any system call.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Array `Array<{ app, id, flow, role, pids, hresult? }>`; `pids` are the
+     *          processes written at the last apply, `hresult` is set if a write failed
+     */
+    Napi::Value GetAppEndpoints(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const std::vector<AppRoute> routes = Table().Routes();
+        Napi::Array result = Napi::Array::New(env, routes.size());
+        for (size_t i = 0; i < routes.size(); ++i)
+        {
+            const AppRoute &route = routes[i];
+            const AppAssignment &assignment = route.assignment;
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("app", assignment.target.pid ? Napi::Value(Napi::Number::New(env, assignment.target.pid))
+                                                 : Napi::Value(ToJsString(env, assignment.target.exe)));
+            obj.Set("id", ToJsString(env, assignment.deviceId));
+            obj.Set("flow", Napi::String::New(env, assignment.flow == eCapture ? "capture" : "render"));
+            obj.Set("role", Napi::String::New(env, RoleName(assignment.role)));
+            Napi::Array pids = Napi::Array::New(env, route.pids.size());
+            for (size_t p = 0; p < route.pids.size(); ++p)
+                pids.Set(p, Napi::Number::New(env, route.pids[p]));
+            obj.Set("pids", pids);
+            if (route.status < 0)
+                obj.Set("hresult", Napi::Number::New(env, static_cast<uint32_t>(route.status)));
+            result.Set(i, obj);
+        }
+        return result;
+    }
+
+    /**
+     * @brief   Rewrites every remembered assignment, reaching processes started since.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Object `{ applied, unchanged, failed, unresolved, hresult? }`
+     */
+    Napi::Value RefreshAppEndpoints(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        try
+        {
+            return ResultToObject(env, ApplyBatch({}, true));
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns every application to the system default, including assignments
+     *          made in Settings or by other tools, and empties the table.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Boolean true on success
+     */
+    Napi::Value ClearAppEndpoints(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        try
+        {
+            const int32_t hr = OperationSupervisor::Instance().Run(L"app-routing", []()
+                                                                   {
+                COMInitializer com;
+                return Table().Clear(); });
+            ServiceRecovery::Instance().ThrowIfLost(hr, "Failed to clear app endpoints");
+            return Napi::Boolean::New(env, SUCCEEDED(hr));
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief Registers per-application routing functions on the module exports.
+     */
+    void InitAppRoutingBindings(Napi::Env env, Napi::Object exports)
+    {
+        static std::once_flag configured;
+        std::call_once(configured, ConfigureRecovery);
+
+        exports.Set("setAppEndpoint", Napi::Function::New(env, SetAppEndpoint));
+        exports.Set("setAppEndpoints", Napi::Function::New(env, SetAppEndpoints));
+        exports.Set("getAppEndpoints", Napi::Function::New(env, GetAppEndpoints));
+        exports.Set("refreshAppEndpoints", Napi::Function::New(env, RefreshAppEndpoints));
+        exports.Set("clearAppEndpoints", Napi::Function::New(env, ClearAppEndpoints));
+    }
+}
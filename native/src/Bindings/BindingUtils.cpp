@@ -0,0 +1,131 @@
+/**
+ * @file BindingUtils.cpp
+ * @brief Helpers shared by all N-API binding translation units.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/JackPresence.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/OperationSupervisor.h"
+#include "Utility/Logger.h"
+#include "Utility/StringUtils.h"
+
+#include <cstdio>
+
+using namespace Utility;
+
+namespace Bindings
+{
+    /**
+     * @brief   Rethrows the in-flight native exception as a JavaScript exception.
+     *
+     * @param   env      The N-API environment.
+     * @param   fallback Message for generic failures, or nullptr to surface the native
+     *                   message as a TypeError (the historical behaviour of the bindings).
+     * @return  Napi::Value Always env.Null().
+     */
+    Napi::Value ThrowNativeError(Napi::Env env, const char *fallback)
+    {
+        try
+        {
+            throw;
+        }
+        catch (const OperationTimeoutError &ex)
+        {
+            Napi::Error error = Napi::Error::New(env, ex.what());
+            error.Set("code", Napi::String::New(env, "ETIMEDOUT"));
+            error.ThrowAsJavaScriptException();
+        }
+        catch (const DeviceHungError &ex)
+        {
+            Napi::Error error = Napi::Error::New(env, ex.what());
+            error.Set("code", Napi::String::New(env, "EDEVICEHUNG"));
+            error.ThrowAsJavaScriptException();
+        }
+        catch (const AudioSwitcher::ServiceLostError &ex)
+        {
+            Napi::Error error = Napi::Error::New(env, ex.what());
+            error.Set("code", Napi::String::New(env, "ESERVICELOST"));
+            error.Set("hresult", Napi::Number::New(env, static_cast<uint32_t>(ex.HResult())));
+            error.ThrowAsJavaScriptException();
+        }
+        catch (const std::exception &ex)
+        {
+            AUDIO_LOG(Error, "binding", "Exception: %s", ex.what());
+            if (fallback)
+                Napi::Error::New(env, fallback).ThrowAsJavaScriptException();
+            else
+                Napi::TypeError::New(env, ex.what()).ThrowAsJavaScriptException();
+        }
+        catch (...)
+        {
+            Napi::Error::New(env, fallback ? fallback : "Unknown native error").ThrowAsJavaScriptException();
+        }
+        return env.Null();
+    }
+
+    /**
+     * @brief   Reads a JS string value as UTF-16.
+     */
+    std::wstring ToWString(const Napi::Value &value)
+    {
+        return Utf8ToWString(value.As<Napi::String>().Utf8Value());
+    }
+
+    /**
+     * @brief   Creates a JS string from a UTF-16 string.
+     */
+    Napi::String ToJsString(Napi::Env env, const std::wstring &value)
+    {
+        return Napi::String::New(env, WStringToUtf8(value));
+    }
+
+    namespace
+    {
+        const char *const kConnectionTypes[] = {
+            "unknown", "3.5mm", "quarterInch", "atapiInternal", "rca", "optical", "otherDigital",
+            "otherAnalog", "multichannelAnalogDin", "xlr", "rj11Modem", "combination"};
+
+        const char *const kGeoLocations[] = {
+            "unknown", "rear", "front", "left", "right", "top", "bottom", "rearPanel", "riser",
+            "insideMobileLid", "driveBay", "hdmi", "outsideMobileLid", "atapi", "notApplicable", "reserved"};
+
+        template <size_t N>
+        const char *EnumName(const char *const (&names)[N], uint8_t value)
+        {
+            return value < N ? names[value] : "unknown";
+        }
+    }
+
+    const char *JackConnectionTypeName(uint8_t value)
+    {
+        return EnumName(kConnectionTypes, value);
+    }
+
+    const char *JackGeoLocationName(uint8_t value)
+    {
+        return EnumName(kGeoLocations, value);
+    }
+
+    /**
+     * @brief   Converts jack presence to a JS object, or undefined if not loaded.
+     */
+    Napi::Value JackToObject(Napi::Env env, const AudioSwitcher::JackState &jack)
+    {
+        if (!jack.loaded)
+            return env.Undefined();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("present", Napi::Boolean::New(env, jack.present));
+        obj.Set("connected", Napi::Boolean::New(env, jack.connected));
+        if (jack.present)
+        {
+            char color[8];
+            std::snprintf(color, sizeof(color), "#%06x", jack.color);
+            obj.Set("color", Napi::String::New(env, color));
+            obj.Set("connectionType", Napi::String::New(env, JackConnectionTypeName(jack.connectionType)));
+            obj.Set("geoLocation", Napi::String::New(env, JackGeoLocationName(jack.geoLocation)));
+        }
+        return obj;
+    }
+}
@@ -0,0 +1,544 @@
+/**
+ * @file ClipBindings.cpp
+ * @brief N-API bindings for sound clips: decoded once into a memory pool in each
+ *        endpoint's mix format, then started on always-warm render streams.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/EndpointKey.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Dsp/FlacDecoder.h"
+#include "Dsp/WavDecoder.h"
+#include "Streaming/ClipPlayer.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/OperationSupervisor.h"
+#include "Utility/SafeRelease.h"
+
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace AudioSwitcher;
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        constexpr size_t kPoolBytes = 256u << 20; ///< Sample memory for every clip in every format.
+        constexpr size_t kMaxVoices = 32;         ///< Clips mixed at once per endpoint.
+
+        /**
+         * @brief The clip pool and one warm player per endpoint. Players are kept between
+         *        clips so starting one is a queue write.
+         */
+        using PlayerMap = std::unordered_map<EndpointKey, std::shared_ptr<ClipPlayer>, EndpointKeyHash>;
+
+        struct ClipRegistry
+        {
+            std::mutex mutex;
+            PlayerMap players;
+            ClipPool pool{kPoolBytes};
+        };
+
+        ClipRegistry &Registry()
+        {
+            static ClipRegistry *registry = new ClipRegistry();
+            return *registry;
+        }
+
+        /// @param id Endpoint ID; the supervisor interns it for the same call anyway.
+        std::shared_ptr<ClipPlayer> PlayerFor(const std::wstring &id)
+        {
+            const EndpointKey key = EndpointKey::Intern(id);
+            ClipRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::shared_ptr<ClipPlayer> &player = registry.players[key];
+            if (!player)
+                player = std::make_shared<ClipPlayer>(id, kMaxVoices);
+            return player;
+        }
+
+        std::vector<std::pair<EndpointKey, std::shared_ptr<ClipPlayer>>> AllPlayers()
+        {
+            ClipRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            return {registry.players.begin(), registry.players.end()};
+        }
+
+        bool ParseEncoding(const std::string &name, Dsp::SampleEncoding &encoding)
+        {
+            static const std::pair<const char *, Dsp::SampleEncoding> kEncodings[] = {
+                {"u8", Dsp::SampleEncoding::Unsigned8},
+                {"s16", Dsp::SampleEncoding::Int16},
+                {"s24", Dsp::SampleEncoding::Int24},
+                {"s32", Dsp::SampleEncoding::Int32},
+                {"f32", Dsp::SampleEncoding::Float32},
+                {"f64", Dsp::SampleEncoding::Float64},
+            };
+            for (const auto &entry : kEncodings)
+            {
+                if (name == entry.first)
+                {
+                    encoding = entry.second;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Reads the bytes of a Buffer, ArrayBuffer or typed array.
+         * @return False for any other value.
+         */
+        bool ReadBytes(const Napi::Value &value, const uint8_t *&data, size_t &size)
+        {
+            if (value.IsBuffer())
+            {
+                Napi::Buffer<uint8_t> buffer = value.As<Napi::Buffer<uint8_t>>();
+                data = buffer.Data();
+                size = buffer.Length();
+                return true;
+            }
+            if (value.IsTypedArray())
+            {
+                Napi::TypedArray array = value.As<Napi::TypedArray>();
+                data = static_cast<const uint8_t *>(array.ArrayBuffer().Data()) + array.ByteOffset();
+                size = array.ByteLength();
+                return true;
+            }
+            if (value.IsArrayBuffer())
+            {
+                Napi::ArrayBuffer buffer = value.As<Napi::ArrayBuffer>();
+                data = static_cast<const uint8_t *>(buffer.Data());
+                size = buffer.ByteLength();
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Converts clip @p clipId to the mix format of endpoint @p id, as reported by
+         *        GetDeviceFormatInfo. Requires COM.
+         */
+        void PrepareFor(uint32_t clipId, const std::wstring &id)
+        {
+            IMMDevice *device = OpenEndpoint(id, eRender);
+            if (!device)
+                throw std::runtime_error("[x] Render endpoint not found");
+            const DeviceFormatInfo info = GetDeviceFormatInfo(device);
+            SafeRelease(device);
+            if (!info.valid)
+                throw std::runtime_error("[x] Failed to read mix format");
+            Registry().pool.Prepare(clipId, info.sampleRate, info.channels);
+        }
+
+        /**
+         * @brief Closes every player; they reopen on the next play. Used when the audio
+         *        service restarts (the streams died with it) and at environment teardown.
+         */
+        void CloseAllPlayers()
+        {
+            PlayerMap players;
+            {
+                ClipRegistry &registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                players.swap(registry.players);
+            }
+            for (auto &entry : players)
+                entry.second->Close();
+            Registry().pool.Collect();
+        }
+
+        void CloseOnCleanup()
+        {
+            try
+            {
+                CloseAllPlayers();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    /**
+     * @brief   Decodes a sound clip once and keeps it in memory, converted to the mix
+     *          format of the endpoints it will play on.
+     *
+     * @details WAV, RF64 and Wave64 files (8/16/24/32-bit PCM, 32/64-bit float) and FLAC
+     *          files are detected from their header; headerless PCM needs `format`, `sampleRate` and
+     *          `channels`. The clip is resampled and channel-mapped to the mix format of
+     *          each endpoint in `deviceIds` (the default render endpoint if omitted), and
+     *          those endpoints' streams are opened and kept warm, so playClip() starts it
+     *          without converting or activating anything. Clips share a 256 MB pool.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Buffer, ArrayBuffer or Uint8Array with the clip
+     *              - args[1] (optional): `{ deviceIds?: string[], deviceId?: string,
+     *                format?: 'u8'|'s16'|'s24'|'s32'|'f32'|'f64', sampleRate?: number,
+     *                channels?: number }`
+     * @return  Napi::Object `{ clipId, sampleRate, channels, durationMs, deviceIds }` (the
+     *              clip's own format and the resolved endpoint IDs)
+     * @throws  Napi::Error When the data cannot be decoded, the pool is full or an
+     *              endpoint cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * const { clipId } = loadClip(fs.readFileSync('ding.wav'), { deviceIds: [speakersId] });
+     */
+    Napi::Value LoadClip(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        const char *usage = "Expected (data: Buffer, options?: { deviceIds?: string[], deviceId?: string, format?: string, sampleRate?: number, channels?: number })";
+
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+        if (info.Length() < 1 || !ReadBytes(info[0], data, size) ||
+            (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsObject()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object obj = info.Length() > 1 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+
+        std::vector<std::wstring> ids;
+        Napi::Value deviceIds = obj.Get("deviceIds");
+        Napi::Value deviceId = obj.Get("deviceId");
+        Napi::Value format = obj.Get("format");
+        Napi::Value sampleRate = obj.Get("sampleRate");
+        Napi::Value channels = obj.Get("channels");
+        if (!(deviceIds.IsUndefined() || deviceIds.IsArray()) || !(deviceId.IsUndefined() || deviceId.IsString()) ||
+            !(format.IsUndefined() || format.IsString()) || !(sampleRate.IsUndefined() || sampleRate.IsNumber()) ||
+            !(channels.IsUndefined() || channels.IsNumber()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (deviceIds.IsArray())
+        {
+            Napi::Array array = deviceIds.As<Napi::Array>();
+            for (uint32_t i = 0; i < array.Length(); ++i)
+            {
+                Napi::Value value = array.Get(i);
+                if (!value.IsString())
+                {
+                    Napi::TypeError::New(env, "Expected endpoint ID strings").ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+                ids.push_back(ToWString(value));
+            }
+        }
+        if (deviceId.IsString())
+            ids.push_back(ToWString(deviceId));
+        if (ids.empty())
+            ids.emplace_back();
+
+        Dsp::PcmFormat pcm;
+        const bool raw = format.IsString();
+        if (raw && !ParseEncoding(format.As<Napi::String>().Utf8Value(), pcm.encoding))
+        {
+            Napi::TypeError::New(env, "format must be 'u8', 's16', 's24', 's32', 'f32' or 'f64'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (sampleRate.IsNumber())
+            pcm.sampleRate = sampleRate.As<Napi::Number>().Uint32Value();
+        if (channels.IsNumber())
+            pcm.channels = channels.As<Napi::Number>().Uint32Value();
+
+        ClipPool &pool = Registry().pool;
+        uint32_t clipId = 0;
+        uint32_t clipRate = 0;
+        unsigned clipChannels = 0;
+        try
+        {
+            Dsp::DecodedAudio audio = raw                        ? Dsp::DecodePcm(data, size, pcm)
+                                       : Dsp::IsFlac(data, size) ? Dsp::DecodeFlac(data, size)
+                                                                 : Dsp::DecodeWav(data, size);
+            clipRate = audio.sampleRate;
+            clipChannels = audio.channels;
+            clipId = pool.Add(std::move(audio));
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+
+        try
+        {
+            Napi::Array resolvedIds = Napi::Array::New(env, ids.size());
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                const std::wstring requested = ids[i];
+                const std::wstring resolved = OperationSupervisor::Instance().Run(L"clip", [requested, clipId]()
+                                                                                  {
+                    COMInitializer com;
+                    const std::wstring id = ResolveEndpointId(requested, eRender);
+                    PrepareFor(clipId, id);
+                    return id; });
+
+                std::shared_ptr<ClipPlayer> player = PlayerFor(resolved);
+                OperationSupervisor::Instance().Run(resolved, [player]()
+                                                    {
+                    COMInitializer com;
+                    player->Open(); });
+                resolvedIds.Set(i, ToJsString(env, resolved));
+            }
+
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("clipId", Napi::Number::New(env, clipId));
+            result.Set("sampleRate", Napi::Number::New(env, clipRate));
+            result.Set("channels", Napi::Number::New(env, clipChannels));
+            result.Set("durationMs", Napi::Number::New(env, pool.DurationMs(clipId)));
+            result.Set("deviceIds", resolvedIds);
+            return result;
+        }
+        catch (...)
+        {
+            pool.Remove(clipId);
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Starts a loaded clip on a render endpoint, mixed with any clips already
+     *          playing there.
+     *
+     * @details On an endpoint the clip was loaded for, this only queues a voice on the
+     *          warm stream: the sound starts within two engine periods (a few ms on
+     *          endpoints that support small shared-mode periods). Up to 32 clips mix per
+     *          endpoint; a 33rd replaces the one closest to its end. Pass an explicit
+     *          deviceId for the fastest start; the default endpoint is looked up per call.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Clip id returned by loadClip
+     *              - args[1] (optional): Endpoint ID (default render endpoint if omitted or null)
+     *              - args[2] (optional): Linear gain (default 1)
+     * @return  Napi::Boolean false for an unknown clip id
+     * @throws  Napi::Error When the endpoint cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * playClip(clipId, speakersId, 0.5);
+     */
+    Napi::Value PlayClip(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsNumber() ||
+            (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsNull() && !info[1].IsString()) ||
+            (info.Length() > 2 && !info[2].IsUndefined() && !info[2].IsNumber()))
+        {
+            Napi::TypeError::New(env, "Expected (clipId: number, deviceId?: string, gain?: number)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        const uint32_t clipId = info[0].As<Napi::Number>().Uint32Value();
+        const std::wstring deviceId = info.Length() > 1 && info[1].IsString() ? ToWString(info[1]) : std::wstring();
+        const double gain = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().DoubleValue() : 1.0;
+        if (!(gain >= 0.0 && gain <= 16.0))
+        {
+            Napi::RangeError::New(env, "gain must be between 0 and 16").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        try
+        {
+            ClipPool &pool = Registry().pool;
+            if (!deviceId.empty())
+            {
+                // Warm stream: queueing the voice needs neither COM nor the supervisor
+                std::shared_ptr<ClipPlayer> player = PlayerFor(deviceId);
+                if (player->IsWarm())
+                    return Napi::Boolean::New(env, player->Play(pool, clipId, static_cast<float>(gain)));
+            }
+
+            const std::wstring resolved = deviceId.empty()
+                                              ? OperationSupervisor::Instance().Run(L"clip", [deviceId]()
+                                                                                    {
+                    COMInitializer com;
+                    return ResolveEndpointId(deviceId, eRender); })
+                                              : deviceId;
+            std::shared_ptr<ClipPlayer> player = PlayerFor(resolved);
+            const bool played = OperationSupervisor::Instance().Run(resolved, [player, &pool, clipId, gain]()
+                                                                    {
+                COMInitializer com;
+                return player->Play(pool, clipId, static_cast<float>(gain)); });
+            return Napi::Boolean::New(env, played);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Stops clips on one endpoint, or on all of them.
+     *
+     * @details Streams stay open for a fast restart unless `{ release: true }` is passed.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): endpoint ID (omit or null for every endpoint)
+     *              - args[1] (optional): `{ clipId?: number, release?: boolean }`; clipId
+     *                stops only that clip
+     * @return  Napi::Number Number of endpoints affected
+     */
+    Napi::Value StopClips(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const bool single = info.Length() > 0 && info[0].IsString();
+        if (info.Length() > 0 && !single && !info[0].IsUndefined() && !info[0].IsNull())
+        {
+            Napi::TypeError::New(env, "Expected an endpoint ID string").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        bool release = false;
+        uint32_t clipId = 0;
+        if (info.Length() > 1 && info[1].IsObject())
+        {
+            Napi::Object options = info[1].As<Napi::Object>();
+            Napi::Value value = options.Get("release");
+            release = value.IsBoolean() && value.As<Napi::Boolean>().Value();
+            Napi::Value clip = options.Get("clipId");
+            if (clip.IsNumber())
+                clipId = clip.As<Napi::Number>().Uint32Value();
+        }
+
+        std::vector<std::pair<EndpointKey, std::shared_ptr<ClipPlayer>>> players;
+        {
+            ClipRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const EndpointKey key = single ? EndpointKey::Lookup(ToWString(info[0])) : EndpointKey();
+            for (auto it = registry.players.begin(); it != registry.players.end();)
+            {
+                if (single && it->first != key)
+                {
+                    ++it;
+                    continue;
+                }
+                players.emplace_back(it->first, it->second);
+                it = release ? registry.players.erase(it) : std::next(it);
+            }
+        }
+
+        try
+        {
+            for (auto &entry : players)
+            {
+                std::shared_ptr<ClipPlayer> player = entry.second;
+                if (!release)
+                {
+                    player->Stop(clipId);
+                    continue;
+                }
+                OperationSupervisor::Instance().Run(entry.first.ToWString(), [player]()
+                                                    {
+                    COMInitializer com;
+                    player->Close(); });
+            }
+            Registry().pool.Collect();
+            return Napi::Number::New(env, static_cast<double>(players.size()));
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop clips");
+        }
+    }
+
+    /**
+     * @brief   Frees a loaded clip. Voices still playing it are stopped; its memory is
+     *          reclaimed once every render thread has let go of it.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Clip id returned by loadClip
+     * @return  Napi::Boolean false for an unknown clip id
+     */
+    Napi::Value UnloadClip(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Clip id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        const uint32_t clipId = info[0].As<Napi::Number>().Uint32Value();
+        if (clipId == 0)
+            return Napi::Boolean::New(env, false);
+
+        for (auto &entry : AllPlayers())
+            entry.second->Stop(clipId);
+        return Napi::Boolean::New(env, Registry().pool.Remove(clipId));
+    }
+
+    /**
+     * @brief   Returns the clip pool usage and the state of every endpoint used for clips.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Object `{ clips, buffers, bytes, budgetBytes, players: [{ deviceId,
+     *              open, lowLatency, sampleRate, channels, periodMs, latencyMs, voices,
+     *              started, finished, stolen, rejected, error }] }`
+     */
+    Napi::Value GetClipStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        ClipPool &pool = Registry().pool;
+        pool.Collect();
+        const ClipPoolStats poolStats = pool.Stats();
+        const auto players = AllPlayers();
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("clips", Napi::Number::New(env, static_cast<double>(poolStats.clips)));
+        result.Set("buffers", Napi::Number::New(env, static_cast<double>(poolStats.buffers)));
+        result.Set("bytes", Napi::Number::New(env, static_cast<double>(poolStats.bytes)));
+        result.Set("budgetBytes", Napi::Number::New(env, static_cast<double>(poolStats.budgetBytes)));
+
+        Napi::Array list = Napi::Array::New(env, players.size());
+        for (size_t i = 0; i < players.size(); ++i)
+        {
+            const ClipPlayerStats stats = players[i].second->Stats();
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("deviceId", ToJsString(env, players[i].first.ToWString()));
+            obj.Set("open", Napi::Boolean::New(env, stats.open));
+            obj.Set("lowLatency", Napi::Boolean::New(env, stats.lowLatency));
+            obj.Set("sampleRate", Napi::Number::New(env, stats.sampleRate));
+            obj.Set("channels", Napi::Number::New(env, stats.channels));
+            obj.Set("periodMs", Napi::Number::New(env, stats.periodMs));
+            obj.Set("latencyMs", Napi::Number::New(env, stats.latencyMs));
+            obj.Set("voices", Napi::Number::New(env, stats.mixer.active));
+            obj.Set("started", Napi::Number::New(env, static_cast<double>(stats.mixer.started)));
+            obj.Set("finished", Napi::Number::New(env, static_cast<double>(stats.mixer.finished)));
+            obj.Set("stolen", Napi::Number::New(env, static_cast<double>(stats.mixer.stolen)));
+            obj.Set("rejected", Napi::Number::New(env, static_cast<double>(stats.mixer.rejected)));
+            obj.Set("error", stats.error.empty() ? env.Null() : Napi::String::New(env, stats.error));
+            list.Set(i, obj);
+        }
+        result.Set("players", list);
+        return result;
+    }
+
+    /**
+     * @brief Registers sound clip functions on the module exports.
+     */
+    void InitClipBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("loadClip", Napi::Function::New(env, LoadClip));
+        exports.Set("playClip", Napi::Function::New(env, PlayClip));
+        exports.Set("stopClips", Napi::Function::New(env, StopClips));
+        exports.Set("unloadClip", Napi::Function::New(env, UnloadClip));
+        exports.Set("getClipStats", Napi::Function::New(env, GetClipStats));
+        env.AddCleanupHook(CloseOnCleanup);
+
+        static std::once_flag recoveryRegistered;
+        std::call_once(recoveryRegistered, []()
+                       { ServiceRecovery::Instance().AddHook(CloseAllPlayers); });
+    }
+}
@@ -0,0 +1,215 @@
+/**
+ * @file LatencyBindings.cpp
+ * @brief N-API binding for round-trip latency measurement of a render endpoint.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "Streaming/LatencyProbe.h"
+#include "Utility/COMInitializer.h"
+
+#include <string>
+
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        Napi::Object StatsToObject(Napi::Env env, const Dsp::DelayStatistics &stats)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("count", Napi::Number::New(env, static_cast<double>(stats.count)));
+            obj.Set("minMs", Napi::Number::New(env, stats.min));
+            obj.Set("maxMs", Napi::Number::New(env, stats.max));
+            obj.Set("meanMs", Napi::Number::New(env, stats.mean));
+            obj.Set("medianMs", Napi::Number::New(env, stats.median));
+            obj.Set("p95Ms", Napi::Number::New(env, stats.p95));
+            obj.Set("stdDevMs", Napi::Number::New(env, stats.stdDev));
+            return obj;
+        }
+
+        Napi::Object ReportToObject(Napi::Env env, const LatencyReport &report)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("deviceId", ToJsString(env, report.renderId));
+            obj.Set("captureId", ToJsString(env, report.captureId));
+            obj.Set("loopback", Napi::Boolean::New(env, report.loopback));
+            obj.Set("sampleRate", Napi::Number::New(env, report.sampleRate));
+            obj.Set("stimulusMs", Napi::Number::New(env, 1000.0 * report.stimulusFrames / report.sampleRate));
+
+            Napi::Array trials = Napi::Array::New(env, report.trials.size());
+            for (size_t i = 0; i < report.trials.size(); ++i)
+            {
+                const LatencyTrial &trial = report.trials[i];
+                Napi::Object item = Napi::Object::New(env);
+                item.Set("found", Napi::Boolean::New(env, trial.found));
+                item.Set("latencyMs", trial.found ? Napi::Number::New(env, trial.latencyMs) : env.Null());
+                item.Set("bufferMs", trial.found ? Napi::Number::New(env, trial.bufferMs) : env.Null());
+                item.Set("correlation", Napi::Number::New(env, trial.correlation));
+                item.Set("prominence", Napi::Number::New(env, trial.prominence));
+                item.Set("glitched", Napi::Boolean::New(env, trial.glitched));
+                trials.Set(static_cast<uint32_t>(i), item);
+            }
+            obj.Set("trials", trials);
+            obj.Set("stats", StatsToObject(env, report.stats));
+            return obj;
+        }
+
+        /**
+         * @brief Runs a measurement on the libuv thread pool; it takes seconds, which is
+         *        far too long for the JS thread (and for the supervisor's call deadline).
+         */
+        class LatencyWorker : public Napi::AsyncWorker
+        {
+        public:
+            LatencyWorker(Napi::Env env, LatencyOptions options)
+                : Napi::AsyncWorker(env), m_deferred(Napi::Promise::Deferred::New(env)), m_options(std::move(options))
+            {
+            }
+
+            Napi::Promise Promise() const { return m_deferred.Promise(); }
+
+            void Execute() override
+            {
+                try
+                {
+                    COMInitializer com;
+                    LatencyProbe probe(m_options);
+                    m_report = probe.Run();
+                }
+                catch (const std::exception &ex)
+                {
+                    SetError(ex.what());
+                }
+                catch (...)
+                {
+                    SetError("[x] Latency measurement failed");
+                }
+            }
+
+            void OnOK() override
+            {
+                m_deferred.Resolve(ReportToObject(Env(), m_report));
+            }
+
+            void OnError(const Napi::Error &error) override
+            {
+                m_deferred.Reject(error.Value());
+            }
+
+        private:
+            Napi::Promise::Deferred m_deferred;
+            LatencyOptions m_options;
+            LatencyReport m_report;
+        };
+    }
+
+    /**
+     * @brief   Measures the output latency of a render endpoint.
+     *
+     * @details Plays a stimulus (MLS or chirp) repeatedly and finds it again in a capture
+     *          with an FFT cross-correlation. Without `captureId` the endpoint's loopback
+     *          is captured, which measures the Windows audio engine path; pass a
+     *          microphone to include what a Bluetooth or USB link and the speaker add.
+     *          Latency runs from handing the first stimulus frame to the engine to its
+     *          capture, so it includes the audio already queued (reported as bufferMs).
+     *          Runs in the background; the stimulus is audible.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ deviceId?: string, captureId?: string,
+     *                stimulus?: 'mls'|'chirp', trials?: number, levelDb?: number,
+     *                maxLatencyMs?: number, gapMs?: number }`
+     * @return  Napi::Promise Resolves to `{ deviceId, captureId, loopback, sampleRate,
+     *              stimulusMs, trials: [{ found, latencyMs, bufferMs, correlation,
+     *              prominence, glitched }], stats: { count, minMs, maxMs, meanMs,
+     *              medianMs, p95Ms, stdDevMs } }`
+     * @throws  Napi::TypeError On invalid options (the promise rejects on device errors)
+     *
+     * @example
+     * // JavaScript usage:
+     * const { stats } = await measureLatency({ deviceId, captureId: micId, trials: 20 });
+     */
+    Napi::Value MeasureLatency(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsObject())
+        {
+            Napi::TypeError::New(env, "Expected latency options").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object obj = info.Length() > 0 && info[0].IsObject() ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+        LatencyOptions options;
+        Napi::Value deviceId = obj.Get("deviceId");
+        Napi::Value captureId = obj.Get("captureId");
+        Napi::Value stimulus = obj.Get("stimulus");
+        if (!(deviceId.IsUndefined() || deviceId.IsNull() || deviceId.IsString()) ||
+            !(captureId.IsUndefined() || captureId.IsNull() || captureId.IsString()) ||
+            !(stimulus.IsUndefined() || stimulus.IsString()))
+        {
+            Napi::TypeError::New(env, "Expected { deviceId?: string, captureId?: string, stimulus?: string }")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (deviceId.IsString())
+            options.renderId = ToWString(deviceId);
+        if (captureId.IsString())
+            options.captureId = ToWString(captureId);
+        if (stimulus.IsString())
+        {
+            const std::string name = stimulus.As<Napi::String>().Utf8Value();
+            if (name != "mls" && name != "chirp")
+            {
+                Napi::TypeError::New(env, "stimulus must be 'mls' or 'chirp'").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.stimulus = name == "mls" ? LatencyStimulus::Mls : LatencyStimulus::Chirp;
+        }
+
+        // Numeric options: name, destination, allowed range
+        struct NumberOption
+        {
+            const char *name;
+            double *target;
+            double min;
+            double max;
+        };
+        double trials = options.trials;
+        const NumberOption numbers[] = {
+            {"trials", &trials, 1.0, 1000.0},
+            {"levelDb", &options.levelDb, -60.0, 0.0},
+            {"maxLatencyMs", &options.maxLatencyMs, 1.0, 5000.0},
+            {"gapMs", &options.gapMs, 0.0, 10000.0},
+        };
+        for (const NumberOption &option : numbers)
+        {
+            Napi::Value value = obj.Get(option.name);
+            if (value.IsUndefined())
+                continue;
+            const double number = value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : -1e300;
+            if (!(number >= option.min && number <= option.max))
+            {
+                const std::string message = std::string("Invalid ") + option.name;
+                Napi::RangeError::New(env, message).ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            *option.target = number;
+        }
+        options.trials = static_cast<unsigned>(trials);
+
+        LatencyWorker *worker = new LatencyWorker(env, std::move(options));
+        Napi::Promise promise = worker->Promise();
+        worker->Queue();
+        return promise;
+    }
+
+    /**
+     * @brief Registers the latency measurement function on the module exports.
+     */
+    void InitLatencyBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("measureLatency", Napi::Function::New(env, MeasureLatency));
+    }
+}
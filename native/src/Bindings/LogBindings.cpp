@@ -0,0 +1,193 @@
+/**
+ * @file LogBindings.cpp
+ * @brief N-API bindings for the native asynchronous logger.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "Utility/Logger.h"
+
+#include <memory>
+#include <mutex>
+
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief The JS callback sink currently installed, if any. Replaced sinks are
+         *        released only after the logger has switched away from them.
+         */
+        struct LogState
+        {
+            std::mutex mutex;
+            std::unique_ptr<Napi::ThreadSafeFunction> callback;
+        };
+
+        LogState &State()
+        {
+            static LogState *state = new LogState();
+            return *state;
+        }
+
+        void CallJs(Napi::Env env, Napi::Function callback, std::vector<LogEntry> *entries)
+        {
+            std::unique_ptr<std::vector<LogEntry>> owned(entries);
+            if (!env)
+                return;
+
+            Napi::Array records = Napi::Array::New(env, owned->size());
+            for (size_t i = 0; i < owned->size(); ++i)
+            {
+                const LogEntry &entry = (*owned)[i];
+                Napi::Object obj = Napi::Object::New(env);
+                obj.Set("time", Napi::Number::New(env, static_cast<double>(entry.timeUs) / 1000.0));
+                obj.Set("level", Napi::String::New(env, Logger::LevelName(entry.level)));
+                obj.Set("component", Napi::String::New(env, entry.component));
+                obj.Set("thread", Napi::Number::New(env, entry.threadId));
+                obj.Set("message", Napi::String::New(env, entry.message));
+                records.Set(i, obj);
+            }
+            callback.Call({records});
+        }
+
+        /**
+         * @brief Installs @p sink and swaps in @p callback (or none), releasing the previous
+         *        thread-safe function once the logger can no longer call it.
+         */
+        void ReplaceSink(Logger::Sink sink, std::unique_ptr<Napi::ThreadSafeFunction> callback)
+        {
+            LogState &state = State();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            Logger::Instance().SetSink(std::move(sink));
+            if (state.callback)
+                state.callback->Release();
+            state.callback = std::move(callback);
+        }
+
+        void DisableOnCleanup()
+        {
+            Logger::Instance().SetLevel(LogLevel::Off);
+            ReplaceSink(Logger::Sink(), nullptr);
+        }
+    }
+
+    /**
+     * @brief   Configures native logging (off by default).
+     *
+     * @details Native code records messages into per-thread lock-free buffers; a background
+     *          thread formats them and hands them to the sink every ~20 ms, so logging never
+     *          blocks an audio call. Pass `null` or `{ level: 'off' }` to disable.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: `{ level?: 'trace'|'debug'|'info'|'warn'|'error'|'off',
+     *                callback?: (records) => void, file?: string }` or null. `level`
+     *                defaults to 'info'; each record is `{ time, level, component, thread,
+     *                message }` with `time` in epoch milliseconds.
+     * @return  Napi::Value undefined
+     * @throws  Napi::TypeError On invalid options; Napi::Error if the file cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * setLogging({ level: 'debug', callback: (records) => records.forEach((r) => console.log(r.message)) });
+     * setLogging({ level: 'warn', file: 'C:\\logs\\audio.log' });
+     */
+    Napi::Value SetLogging(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined())
+        {
+            Logger::Instance().SetLevel(LogLevel::Off);
+            ReplaceSink(Logger::Sink(), nullptr);
+            return env.Undefined();
+        }
+
+        const char *usage = "Expected { level?: 'trace'|'debug'|'info'|'warn'|'error'|'off', callback?: function, file?: string } or null";
+        if (!info[0].IsObject())
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        Napi::Object options = info[0].As<Napi::Object>();
+        Napi::Value levelValue = options.Get("level");
+        Napi::Value callbackValue = options.Get("callback");
+        Napi::Value fileValue = options.Get("file");
+
+        LogLevel level = LogLevel::Info;
+        if (!(levelValue.IsUndefined() || (levelValue.IsString() && Logger::ParseLevel(levelValue.As<Napi::String>().Utf8Value(), level))) ||
+            !(callbackValue.IsUndefined() || callbackValue.IsFunction()) || !(fileValue.IsUndefined() || fileValue.IsString()) ||
+            (callbackValue.IsFunction() && fileValue.IsString()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        if (level == LogLevel::Off)
+        {
+            Logger::Instance().SetLevel(LogLevel::Off);
+            ReplaceSink(Logger::Sink(), nullptr);
+            return env.Undefined();
+        }
+
+        if (fileValue.IsString())
+        {
+            Logger::Sink sink = Logger::FileSink(fileValue.As<Napi::String>().Utf8Value());
+            if (!sink)
+            {
+                Napi::Error::New(env, "[x] Failed to open log file").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            ReplaceSink(std::move(sink), nullptr);
+        }
+        else if (callbackValue.IsFunction())
+        {
+            auto callback = std::make_unique<Napi::ThreadSafeFunction>(
+                Napi::ThreadSafeFunction::New(env, callbackValue.As<Napi::Function>(), "audioLogger", 0, 1));
+            // Logging alone should not keep the process alive
+            callback->Unref(env);
+            Napi::ThreadSafeFunction tsfn = *callback;
+            ReplaceSink([tsfn](const std::vector<LogEntry> &entries) mutable
+                        {
+                auto *copy = new std::vector<LogEntry>(entries);
+                if (tsfn.NonBlockingCall(copy, CallJs) != napi_ok)
+                    delete copy; },
+                        std::move(callback));
+        }
+
+        Logger::Instance().SetLevel(level);
+        return env.Undefined();
+    }
+
+    /**
+     * @brief   Returns logger counters.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Object `{ level, written, dropped, threads }`
+     */
+    Napi::Value GetLogStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        Logger &logger = Logger::Instance();
+        const LoggerStats stats = logger.Stats();
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("level", Napi::String::New(env, Logger::LevelName(logger.Level())));
+        obj.Set("written", Napi::Number::New(env, static_cast<double>(stats.written)));
+        obj.Set("dropped", Napi::Number::New(env, static_cast<double>(stats.dropped)));
+        obj.Set("threads", Napi::Number::New(env, static_cast<double>(stats.threads)));
+        return obj;
+    }
+
+    /**
+     * @brief Registers logging functions on the module exports.
+     */
+    void InitLogBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("setLogging", Napi::Function::New(env, SetLogging));
+        exports.Set("getLogStats", Napi::Function::New(env, GetLogStats));
+        env.AddCleanupHook(DisableOnCleanup);
+    }
+}
@@ -0,0 +1,606 @@
+/**
+ * @file NotificationBindings.cpp
+ * @brief N-API bindings for endpoint change notifications delivered through the
+ *        native dispatcher thread.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/DefaultHistory.h"
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/DeviceTopology.h"
+#include "AudioSwitcher/EndpointNotifier.h"
+#include "AudioSwitcher/JackPresence.h"
+#include "AudioSwitcher/NotificationDispatcher.h"
+#include "AudioSwitcher/TopologyGraph.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/MmcssScope.h"
+#include "Utility/OperationSupervisor.h"
+#include "Utility/SafeRelease.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief One active subscription. Pending JS calls hold a reference, so a batch
+         *        already queued when notifications stop is dropped instead of touching
+         *        freed state.
+         */
+        struct NotificationSession
+        {
+            std::unique_ptr<NotificationDispatcher> dispatcher;
+            std::unique_ptr<EndpointNotifier> notifier;
+            Napi::ThreadSafeFunction callback;
+            std::wstring mmcssTask;
+            std::atomic<bool> mmcssActive{false};
+            std::atomic<bool> stopped{false};
+        };
+
+        struct PendingBatch
+        {
+            std::shared_ptr<NotificationSession> session;
+            std::vector<Notification> notifications;
+        };
+
+        std::mutex &SessionMutex()
+        {
+            static std::mutex *mutex = new std::mutex();
+            return *mutex;
+        }
+
+        std::shared_ptr<NotificationSession> &ActiveSession()
+        {
+            static std::shared_ptr<NotificationSession> *session = new std::shared_ptr<NotificationSession>();
+            return *session;
+        }
+
+        const char *KindName(NotificationKind kind)
+        {
+            switch (kind)
+            {
+            case NotificationKind::DefaultChanged:
+                return "defaultChanged";
+            case NotificationKind::DeviceAdded:
+                return "deviceAdded";
+            case NotificationKind::DeviceRemoved:
+                return "deviceRemoved";
+            case NotificationKind::StateChanged:
+                return "stateChanged";
+            case NotificationKind::VolumeChanged:
+                return "volumeChanged";
+            case NotificationKind::ServiceRestarted:
+                return "serviceRestarted";
+            case NotificationKind::JackConnected:
+                return "jackConnected";
+            default:
+                return "propertyChanged";
+            }
+        }
+
+        const char *RoleName(uint8_t role)
+        {
+            switch (role)
+            {
+            case eConsole:
+                return "console";
+            case eMultimedia:
+                return "multimedia";
+            default:
+                return "communications";
+            }
+        }
+
+        const char *StateName(uint32_t state)
+        {
+            switch (state)
+            {
+            case DEVICE_STATE_ACTIVE:
+                return "active";
+            case DEVICE_STATE_DISABLED:
+                return "disabled";
+            case DEVICE_STATE_UNPLUGGED:
+                return "unplugged";
+            default:
+                return "notpresent";
+            }
+        }
+
+        Napi::Object NotificationToObject(Napi::Env env, const Notification &notification)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("type", Napi::String::New(env, KindName(notification.kind)));
+            obj.Set("deviceId", ToJsString(env, notification.deviceId));
+            switch (notification.kind)
+            {
+            case NotificationKind::DefaultChanged:
+                obj.Set("flow", Napi::String::New(env, notification.flow == eCapture ? "capture" : "render"));
+                obj.Set("role", Napi::String::New(env, RoleName(notification.role)));
+                break;
+            case NotificationKind::StateChanged:
+                obj.Set("state", Napi::String::New(env, StateName(notification.state)));
+                break;
+            case NotificationKind::VolumeChanged:
+                obj.Set("volume", Napi::Number::New(env, notification.volume));
+                obj.Set("muted", Napi::Boolean::New(env, notification.muted));
+                break;
+            case NotificationKind::JackConnected:
+            {
+                obj.Set("flow", Napi::String::New(env, notification.flow == eCapture ? "capture" : "render"));
+                JackState jack;
+                JackTracker::Instance().Find(EndpointKey::Lookup(notification.deviceId), jack);
+                obj.Set("jack", JackToObject(env, jack));
+                break;
+            }
+            default:
+                break;
+            }
+            obj.Set("coalesced", Napi::Number::New(env, notification.coalesced));
+            return obj;
+        }
+
+        /// Runs on the JS thread for each batch.
+        void CallJs(Napi::Env env, Napi::Function callback, PendingBatch *batch)
+        {
+            std::unique_ptr<PendingBatch> owned(batch);
+            if (!env || owned->session->stopped.load())
+                return;
+
+            Napi::Array events = Napi::Array::New(env, owned->notifications.size());
+            for (size_t i = 0; i < owned->notifications.size(); ++i)
+                events.Set(i, NotificationToObject(env, owned->notifications[i]));
+
+            owned->session->dispatcher->RecordDelivery(owned->notifications);
+            callback.Call({events});
+        }
+
+        /**
+         * @brief True if @p key is the console default endpoint for @p flow.
+         */
+        bool IsConsoleDefault(EDataFlow flow, const EndpointKey &key)
+        {
+            IMMDeviceEnumerator *pEnum = AudioRuntime::Instance().AcquireEnumerator();
+            if (!pEnum)
+                return false;
+            bool isDefault = false;
+            IMMDevice *device = nullptr;
+            if (SUCCEEDED(pEnum->GetDefaultAudioEndpoint(flow, eConsole, &device)) && device)
+            {
+                LPWSTR defaultId = nullptr;
+                if (SUCCEEDED(device->GetId(&defaultId)) && defaultId)
+                {
+                    isDefault = key == EndpointKey::Intern(std::wstring(defaultId));
+                    CoTaskMemFree(defaultId);
+                }
+            }
+            SafeRelease(device);
+            SafeRelease(pEnum);
+            return isDefault;
+        }
+
+        /**
+         * @brief Re-reads jack presence of the endpoints a batch touched and appends a
+         *        JackConnected event for each non-default endpoint that was just plugged in.
+         *
+         * Runs on the dispatcher thread (MTA). Property changes are frequent, so they only
+         * re-read endpoints whose jacks are already tracked (every active endpoint is seeded
+         * when notifications start); an endpoint that becomes active or is added is always
+         * read, since that is how drivers with one endpoint per jack report a plug.
+         */
+        void TrackJacks(std::vector<Notification> &batch)
+        {
+            JackTracker &tracker = JackTracker::Instance();
+            std::vector<Notification> plugged;
+            for (const Notification &notification : batch)
+            {
+                const EndpointKey key = EndpointKey::Lookup(notification.deviceId);
+                JackState known;
+                const bool tracked = tracker.Find(key, known);
+                switch (notification.kind)
+                {
+                case NotificationKind::DeviceRemoved:
+                    tracker.Forget(key);
+                    continue;
+                case NotificationKind::StateChanged:
+                    if (notification.state != DEVICE_STATE_ACTIVE)
+                    {
+                        if (tracked)
+                        {
+                            known.connected = false;
+                            tracker.Update(key, known, false);
+                        }
+                        continue;
+                    }
+                    break;
+                case NotificationKind::PropertyChanged:
+                    if (!tracked)
+                        continue;
+                    break;
+                case NotificationKind::DeviceAdded:
+                    break;
+                default:
+                    continue;
+                }
+
+                IMMDevice *device = GetDeviceById(notification.deviceId);
+                if (!device)
+                    continue;
+                DWORD state = 0;
+                EDataFlow flow = eRender;
+                IMMEndpoint *endpoint = nullptr;
+                if (SUCCEEDED(device->QueryInterface(__uuidof(IMMEndpoint), (void **)&endpoint)) && endpoint)
+                {
+                    endpoint->GetDataFlow(&flow);
+                    SafeRelease(endpoint);
+                }
+                JackState jack;
+                if (SUCCEEDED(device->GetState(&state)) && state == DEVICE_STATE_ACTIVE)
+                    jack = SummarizeJacks(ReadEndpointJacks(device));
+                else
+                    jack.loaded = true;
+                SafeRelease(device);
+
+                const bool appeared = notification.kind != NotificationKind::PropertyChanged;
+                const EndpointKey interned = key.Empty() ? EndpointKey::Intern(notification.deviceId) : key;
+                if (tracker.Update(interned, jack, appeared) == JackTracker::Change::Connected &&
+                    !IsConsoleDefault(flow, interned))
+                {
+                    Notification event;
+                    event.kind = NotificationKind::JackConnected;
+                    event.flow = static_cast<uint8_t>(flow);
+                    event.deviceId = notification.deviceId;
+                    event.coalesced = 1;
+                    event.postedUs = notification.postedUs;
+                    plugged.push_back(std::move(event));
+                }
+            }
+            for (Notification &event : plugged)
+                batch.push_back(std::move(event));
+        }
+
+        /**
+         * @brief Runs on the dispatcher thread: keeps native caches coherent, then hands the
+         *        batch to JS without blocking.
+         */
+        void OnBatch(const std::shared_ptr<NotificationSession> &session, std::vector<Notification> &&batch)
+        {
+            bool topology = false;
+            bool membership = false;
+            for (const Notification &notification : batch)
+            {
+                topology = topology || notification.kind != NotificationKind::VolumeChanged;
+                membership = membership || notification.kind == NotificationKind::DeviceAdded ||
+                             notification.kind == NotificationKind::DeviceRemoved ||
+                             notification.kind == NotificationKind::StateChanged ||
+                             notification.kind == NotificationKind::ServiceRestarted;
+                if (notification.kind == NotificationKind::DefaultChanged)
+                    DefaultHistory::Instance().Record(notification.flow, notification.role,
+                                                      EndpointKey::Intern(notification.deviceId));
+                else if (notification.kind == NotificationKind::ServiceRestarted)
+                    TopologyCache::Instance().Clear();
+                else if (notification.kind != NotificationKind::VolumeChanged)
+                    TopologyCache::Instance().Invalidate(EndpointKey::Lookup(notification.deviceId));
+            }
+            if (topology)
+            {
+                TrackJacks(batch);
+                DeviceSnapshot::Instance().Invalidate();
+            }
+            if (membership && session->notifier)
+                session->notifier->SyncVolumeCallbacks();
+
+            auto *pending = new PendingBatch{session, std::move(batch)};
+            if (session->callback.NonBlockingCall(pending, CallJs) != napi_ok)
+                delete pending;
+        }
+
+        /**
+         * @brief Stops the active subscription (if any). Safe to call repeatedly.
+         */
+        void StopSession()
+        {
+            std::shared_ptr<NotificationSession> session;
+            {
+                std::lock_guard<std::mutex> lock(SessionMutex());
+                session.swap(ActiveSession());
+            }
+            if (!session)
+                return;
+
+            session->stopped = true;
+            OperationSupervisor::Instance().Run(L"notifications", [session]()
+                                                {
+                COMInitializer com;
+                session->notifier->Stop(); });
+            // Joins the dispatcher thread, so nothing calls into the notifier or the
+            // thread-safe function afterwards
+            session->dispatcher.reset();
+            session->callback.Release();
+        }
+
+        /**
+         * @brief Reads the jack presence of every active endpoint into JackTracker, so later
+         *        property changes can be compared against it. Best effort: an endpoint whose
+         *        jacks cannot be read is simply tracked from its next add or state change.
+         */
+        void SeedJacks()
+        {
+            try
+            {
+                DeviceSnapshot::Instance().LoadJacks();
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+
+        /**
+         * @brief Recovery hook (recovery thread, MTA): the old registrations died with the
+         *        audio service, so register the active session's callbacks again and
+         *        re-seed the jack presence the recovery cleared.
+         */
+        void RestartNotifier()
+        {
+            std::shared_ptr<NotificationSession> session;
+            {
+                std::lock_guard<std::mutex> lock(SessionMutex());
+                session = ActiveSession();
+            }
+            if (session && !session->stopped)
+            {
+                session->notifier->Restart();
+                SeedJacks();
+            }
+        }
+
+        /**
+         * @brief Recovery listener: tells the JS subscriber that earlier state may be stale.
+         *        Posted under the session lock so a concurrent stop cannot free the dispatcher.
+         */
+        void PostServiceRestarted(const RecoveryEvent &)
+        {
+            std::lock_guard<std::mutex> lock(SessionMutex());
+            const std::shared_ptr<NotificationSession> &session = ActiveSession();
+            if (!session)
+                return;
+            Notification notification;
+            notification.kind = NotificationKind::ServiceRestarted;
+            session->dispatcher->Post(std::move(notification));
+        }
+
+        void StopOnCleanup()
+        {
+            try
+            {
+                StopSession();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    /**
+     * @brief   Starts delivering endpoint change notifications to a JS callback.
+     *
+     * @details Core Audio raises callbacks on its own threads. They are timestamped and
+     *          queued lock-free, then a dedicated native thread (optionally registered with
+     *          an MMCSS task) folds bursts within the batch window, drops repeats of the
+     *          last delivered default/volume value and calls @p callback once per batch.
+     *          Calling it again replaces the previous subscription.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: `(events) => void`, where each event is
+     *                `{ type, deviceId, coalesced, flow?, role?, state?, volume?, muted? }`.
+     *                `type` is 'serviceRestarted' after the audio service came back; the
+     *                subscription has been re-registered and earlier state may be stale.
+     *                'jackConnected' (with `flow` and `jack`) follows the add, state or
+     *                property change of a non-default endpoint whose jack was plugged in.
+     *              - args[1] (optional): `{ batchWindowMs?: number, mmcss?: string }`.
+     *                `mmcss` names the task to join, e.g. 'Audio' or 'Pro Audio'.
+     * @return  Napi::Value undefined
+     * @throws  Napi::Error When the endpoint callbacks cannot be registered
+     *
+     * @example
+     * // JavaScript usage:
+     * startNotifications((events) => console.log(events), { batchWindowMs: 5, mmcss: 'Audio' });
+     */
+    Napi::Value StartNotifications(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsFunction())
+        {
+            Napi::TypeError::New(env, "Expected a callback function").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        DispatcherOptions options;
+        std::wstring mmcssTask;
+        if (info.Length() > 1 && !info[1].IsUndefined())
+        {
+            if (!info[1].IsObject())
+            {
+                Napi::TypeError::New(env, "Expected { batchWindowMs?: number, mmcss?: string }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Object obj = info[1].As<Napi::Object>();
+            Napi::Value window = obj.Get("batchWindowMs");
+            Napi::Value mmcss = obj.Get("mmcss");
+            if (!(window.IsUndefined() || (window.IsNumber() && window.As<Napi::Number>().DoubleValue() >= 0)) ||
+                !(mmcss.IsUndefined() || mmcss.IsString()))
+            {
+                Napi::TypeError::New(env, "Expected { batchWindowMs?: number >= 0, mmcss?: string }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            if (window.IsNumber())
+                options.batchWindow = std::chrono::microseconds(
+                    static_cast<int64_t>(window.As<Napi::Number>().DoubleValue() * 1000.0));
+            if (mmcss.IsString())
+                mmcssTask = ToWString(mmcss);
+        }
+
+        try
+        {
+            StopSession();
+
+            auto session = std::make_shared<NotificationSession>();
+            session->mmcssTask = mmcssTask;
+            session->callback = Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "audioNotifications", 0, 1);
+
+            // The dispatcher thread owns an MTA apartment (volume re-subscription) and,
+            // if asked, an MMCSS registration for its whole lifetime
+            NotificationSession *raw = session.get();
+            options.threadScope = [raw](const std::function<void()> &loop)
+            {
+                COMInitializer com;
+                MmcssScope mmcss(raw->mmcssTask.c_str());
+                raw->mmcssActive = mmcss.Active();
+                loop();
+            };
+            std::weak_ptr<NotificationSession> weak = session;
+            session->dispatcher = std::make_unique<NotificationDispatcher>(
+                [weak](std::vector<Notification> &&batch)
+                {
+                    if (auto locked = weak.lock())
+                        OnBatch(locked, std::move(batch));
+                },
+                options);
+            session->notifier = std::make_unique<EndpointNotifier>(*session->dispatcher);
+
+            try
+            {
+                OperationSupervisor::Instance().Run(L"notifications", [session]()
+                                                    {
+                    COMInitializer com;
+                    session->notifier->Start();
+                    SeedJacks(); });
+            }
+            catch (...)
+            {
+                session->stopped = true;
+                session->dispatcher.reset();
+                session->callback.Release();
+                throw;
+            }
+
+            std::lock_guard<std::mutex> lock(SessionMutex());
+            ActiveSession() = std::move(session);
+            return env.Undefined();
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to start notifications");
+        }
+    }
+
+    /**
+     * @brief   Stops endpoint change notifications and unregisters all callbacks.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Boolean true if notifications were running
+     */
+    Napi::Value StopNotifications(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        bool running = false;
+        {
+            std::lock_guard<std::mutex> lock(SessionMutex());
+            running = static_cast<bool>(ActiveSession());
+        }
+
+        try
+        {
+            StopSession();
+            return Napi::Boolean::New(env, running);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop notifications");
+        }
+    }
+
+    /**
+     * @brief   Returns dispatcher counters, queue depth and latency figures.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ reset?: boolean }` to restart latency and
+     *                high-water tracking after reading
+     * @return  Napi::Value `{ posted, coalesced, suppressed, delivered, batches, queueDepth,
+     *              queueHighWater, watchedEndpoints, mmcss, dispatchLatencyUs,
+     *              deliveryLatencyUs }` (latencies as `{ count, last, average, max }`),
+     *              or null if notifications are not running
+     */
+    Napi::Value GetNotificationStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        std::shared_ptr<NotificationSession> session;
+        {
+            std::lock_guard<std::mutex> lock(SessionMutex());
+            session = ActiveSession();
+        }
+        if (!session)
+            return env.Null();
+
+        const DispatcherStats stats = session->dispatcher->Stats();
+        auto latency = [env](const LatencyStats &value)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("count", Napi::Number::New(env, static_cast<double>(value.count)));
+            obj.Set("last", Napi::Number::New(env, value.lastUs));
+            obj.Set("average", Napi::Number::New(env, value.averageUs));
+            obj.Set("max", Napi::Number::New(env, value.maxUs));
+            return obj;
+        };
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("posted", Napi::Number::New(env, static_cast<double>(stats.posted)));
+        obj.Set("coalesced", Napi::Number::New(env, static_cast<double>(stats.coalesced)));
+        obj.Set("suppressed", Napi::Number::New(env, static_cast<double>(stats.suppressed)));
+        obj.Set("delivered", Napi::Number::New(env, static_cast<double>(stats.delivered)));
+        obj.Set("batches", Napi::Number::New(env, static_cast<double>(stats.batches)));
+        obj.Set("queueDepth", Napi::Number::New(env, static_cast<double>(stats.queueDepth)));
+        obj.Set("queueHighWater", Napi::Number::New(env, static_cast<double>(stats.queueHighWater)));
+        obj.Set("watchedEndpoints", Napi::Number::New(env, static_cast<double>(session->notifier->WatchedEndpoints())));
+        obj.Set("mmcss", Napi::Boolean::New(env, session->mmcssActive.load()));
+        obj.Set("dispatchLatencyUs", latency(stats.dispatch));
+        obj.Set("deliveryLatencyUs", latency(stats.delivery));
+
+        if (info.Length() > 0 && info[0].IsObject())
+        {
+            Napi::Value reset = info[0].As<Napi::Object>().Get("reset");
+            if (reset.IsBoolean() && reset.As<Napi::Boolean>().Value())
+                session->dispatcher->ResetLatency();
+        }
+        return obj;
+    }
+
+    /**
+     * @brief Registers endpoint notification functions on the module exports.
+     */
+    void InitNotificationBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("startNotifications", Napi::Function::New(env, StartNotifications));
+        exports.Set("stopNotifications", Napi::Function::New(env, StopNotifications));
+        exports.Set("getNotificationStats", Napi::Function::New(env, GetNotificationStats));
+        env.AddCleanupHook(StopOnCleanup);
+
+        static std::once_flag recoveryRegistered;
+        std::call_once(recoveryRegistered, []()
+                       {
+            ServiceRecovery::Instance().AddHook(RestartNotifier);
+            ServiceRecovery::Instance().AddListener(PostServiceRestarted); });
+    }
+}
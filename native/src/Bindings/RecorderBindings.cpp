@@ -0,0 +1,343 @@
+/**
+ * @file RecorderBindings.cpp
+ * @brief N-API bindings for long recordings of an endpoint (loopback by default) to
+ *        crash-safe WAV, RF64 or Wave64 files.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "Streaming/CaptureRecorder.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Running recordings by id. Like aggregates, they outlive the calls that
+         *        created them and are stopped explicitly or at environment shutdown.
+         */
+        struct RecorderRegistry
+        {
+            std::mutex mutex;
+            std::map<uint32_t, std::shared_ptr<CaptureRecorder>> recorders;
+            uint32_t nextId = 1;
+        };
+
+        RecorderRegistry &Registry()
+        {
+            static RecorderRegistry *registry = new RecorderRegistry();
+            return *registry;
+        }
+
+        /**
+         * @brief Stops every recording, finishing its file; runs when the Node environment
+         *        is torn down.
+         */
+        void StopAllRecorders()
+        {
+            std::map<uint32_t, std::shared_ptr<CaptureRecorder>> recorders;
+            {
+                RecorderRegistry &registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                recorders.swap(registry.recorders);
+            }
+            for (auto &entry : recorders)
+                entry.second->Stop();
+        }
+
+        bool ParseEncoding(const std::string &name, Dsp::SampleEncoding &encoding)
+        {
+            static const std::pair<const char *, Dsp::SampleEncoding> kEncodings[] = {
+                {"s16", Dsp::SampleEncoding::Int16},
+                {"s24", Dsp::SampleEncoding::Int24},
+                {"s32", Dsp::SampleEncoding::Int32},
+                {"f32", Dsp::SampleEncoding::Float32},
+            };
+            for (const auto &entry : kEncodings)
+            {
+                if (name == entry.first)
+                {
+                    encoding = entry.second;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ParseContainer(const std::string &name, Dsp::WavContainer &container)
+        {
+            if (name == "wav")
+                container = Dsp::WavContainer::Wav;
+            else if (name == "rf64")
+                container = Dsp::WavContainer::Rf64;
+            else if (name == "w64")
+                container = Dsp::WavContainer::W64;
+            else if (name == "flac")
+                container = Dsp::WavContainer::Flac;
+            else
+                return false;
+            return true;
+        }
+
+        Napi::Object StatsToObject(Napi::Env env, const CaptureRecorderStats &stats)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("running", Napi::Boolean::New(env, stats.running));
+            obj.Set("error", !stats.error.empty()        ? Napi::String::New(env, stats.error)
+                             : !stats.file.error.empty() ? Napi::String::New(env, stats.file.error)
+                                                         : env.Null());
+            obj.Set("sampleRate", Napi::Number::New(env, stats.sampleRate));
+            obj.Set("channels", Napi::Number::New(env, stats.channels));
+            obj.Set("frames", Napi::Number::New(env, static_cast<double>(stats.file.frames)));
+            obj.Set("durationMs", Napi::Number::New(env, stats.sampleRate ? stats.file.frames * 1000.0 / stats.sampleRate : 0.0));
+            obj.Set("bytesWritten", Napi::Number::New(env, static_cast<double>(stats.file.bytesWritten)));
+            obj.Set("droppedFrames", Napi::Number::New(env, static_cast<double>(stats.file.droppedFrames)));
+            obj.Set("gapFrames", Napi::Number::New(env, static_cast<double>(stats.gapFrames)));
+            obj.Set("glitches", Napi::Number::New(env, static_cast<double>(stats.glitches)));
+            obj.Set("queueDepth", Napi::Number::New(env, static_cast<double>(stats.file.queueDepth)));
+            obj.Set("maxQueueDepth", Napi::Number::New(env, static_cast<double>(stats.file.maxQueueDepth)));
+            obj.Set("blocks", Napi::Number::New(env, static_cast<double>(stats.file.blocks)));
+            obj.Set("writeMBps", Napi::Number::New(env, stats.file.writeMBps));
+            obj.Set("maxWriteMs", Napi::Number::New(env, stats.file.maxWriteMs));
+            obj.Set("maxPushUs", Napi::Number::New(env, stats.maxPushUs));
+            obj.Set("headerPatches", Napi::Number::New(env, static_cast<double>(stats.file.headerPatches)));
+            obj.Set("rf64", Napi::Boolean::New(env, stats.file.rf64));
+            obj.Set("compression", Napi::Number::New(env, stats.file.compression));
+            obj.Set("encodeRealtime", Napi::Number::New(env, stats.file.encodeRealtime));
+            return obj;
+        }
+    }
+
+    /**
+     * @brief   Starts recording an endpoint to a file, by default what the default render
+     *          endpoint plays (loopback).
+     *
+     * @details Captured packets are handed to a background I/O thread in 1 MB page-aligned
+     *          blocks, so the capture thread never waits on the disk; a disk that cannot
+     *          keep up shows as queue depth, then as dropped frames. Every `patchIntervalMs`
+     *          the data is flushed and the header rewritten, so the file is valid even if
+     *          the process or machine dies. A 'wav' file switches to RF64 past 4 GB; 'rf64'
+     *          and 'w64' (Wave64) use 64-bit sizes from the start. 'flac' encodes each block
+     *          losslessly on the I/O thread (16 or 24-bit, spread over `threads` threads);
+     *          a FLAC file cut short decodes up to its last whole frame. Loopback gaps
+     *          (nothing playing) are recorded as silence, keeping the file in real time.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Output file path
+     *              - args[1] (optional): `{ deviceId?: string, loopback?: boolean (default
+     *                true), format?: 's16'|'s24'|'s32'|'f32' (default 'f32', 's24' for
+     *                FLAC), container?: 'wav'|'rf64'|'w64'|'flac', blockSize?: number,
+     *                blocks?: number, patchIntervalMs?: number, sync?: boolean, threads?:
+     *                number (FLAC encoding threads, default one per core) }`
+     * @return  Napi::Number Recording id for stopRecording / getRecordingStats
+     * @throws  Napi::Error When the endpoint or the file cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * const id = startRecording('C:\\rec\\session.wav', { format: 's24' });
+     * const flacId = startRecording('C:\\rec\\session.flac', { container: 'flac' });
+     */
+    Napi::Value StartRecording(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        const char *usage = "Expected (path: string, options?: { deviceId?: string, loopback?: boolean, format?: string, container?: string, blockSize?: number, blocks?: number, patchIntervalMs?: number, sync?: boolean, threads?: number })";
+
+        if (info.Length() < 1 || !info[0].IsString() || (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsObject()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object obj = info.Length() > 1 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+        Napi::Value deviceId = obj.Get("deviceId");
+        Napi::Value loopback = obj.Get("loopback");
+        Napi::Value format = obj.Get("format");
+        Napi::Value container = obj.Get("container");
+        Napi::Value blockSize = obj.Get("blockSize");
+        Napi::Value blocks = obj.Get("blocks");
+        Napi::Value patchIntervalMs = obj.Get("patchIntervalMs");
+        Napi::Value sync = obj.Get("sync");
+        Napi::Value threads = obj.Get("threads");
+        if (!(deviceId.IsUndefined() || deviceId.IsString()) || !(loopback.IsUndefined() || loopback.IsBoolean()) ||
+            !(format.IsUndefined() || format.IsString()) || !(container.IsUndefined() || container.IsString()) ||
+            !(blockSize.IsUndefined() || blockSize.IsNumber()) || !(blocks.IsUndefined() || blocks.IsNumber()) ||
+            !(patchIntervalMs.IsUndefined() || patchIntervalMs.IsNumber()) || !(sync.IsUndefined() || sync.IsBoolean()) ||
+            !(threads.IsUndefined() || threads.IsNumber()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        CaptureRecorderOptions options;
+        options.file.path = info[0].As<Napi::String>().Utf8Value();
+        if (deviceId.IsString())
+            options.deviceId = ToWString(deviceId);
+        if (loopback.IsBoolean())
+            options.loopback = loopback.As<Napi::Boolean>().Value();
+        if (format.IsString() && !ParseEncoding(format.As<Napi::String>().Utf8Value(), options.file.layout.encoding))
+        {
+            Napi::TypeError::New(env, "format must be 's16', 's24', 's32' or 'f32'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (container.IsString() && !ParseContainer(container.As<Napi::String>().Utf8Value(), options.file.layout.container))
+        {
+            Napi::TypeError::New(env, "container must be 'wav', 'rf64', 'w64' or 'flac'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (options.file.layout.container == Dsp::WavContainer::Flac)
+        {
+            if (!format.IsString())
+                options.file.layout.encoding = Dsp::SampleEncoding::Int24;
+            else if (options.file.layout.encoding != Dsp::SampleEncoding::Int16 && options.file.layout.encoding != Dsp::SampleEncoding::Int24)
+            {
+                Napi::TypeError::New(env, "FLAC recordings must be 's16' or 's24'").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+        }
+        if (blockSize.IsNumber())
+        {
+            const double bytes = blockSize.As<Napi::Number>().DoubleValue();
+            if (!(bytes >= 64 * 1024 && bytes <= 64 * 1024 * 1024))
+            {
+                Napi::RangeError::New(env, "blockSize must be between 64 KB and 64 MB").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.file.blockBytes = static_cast<size_t>(bytes);
+        }
+        if (blocks.IsNumber())
+        {
+            const uint32_t count = blocks.As<Napi::Number>().Uint32Value();
+            if (count < 2 || count > 256)
+            {
+                Napi::RangeError::New(env, "blocks must be between 2 and 256").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.file.blocks = count;
+        }
+        if (patchIntervalMs.IsNumber())
+            options.file.patchIntervalMs = patchIntervalMs.As<Napi::Number>().Uint32Value();
+        if (sync.IsBoolean())
+            options.file.syncOnPatch = sync.As<Napi::Boolean>().Value();
+        if (threads.IsNumber())
+        {
+            const uint32_t count = threads.As<Napi::Number>().Uint32Value();
+            if (count > 64)
+            {
+                Napi::RangeError::New(env, "threads must be between 0 and 64").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.file.flac.threads = count;
+        }
+
+        try
+        {
+            std::shared_ptr<CaptureRecorder> recorder = OperationSupervisor::Instance().Run(L"recorder", [options]()
+                                                                                            {
+                COMInitializer com;
+                auto recorder = std::make_shared<CaptureRecorder>(options);
+                recorder->Start();
+                return recorder; });
+
+            RecorderRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const uint32_t id = registry.nextId++;
+            registry.recorders.emplace(id, std::move(recorder));
+            return Napi::Number::New(env, id);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to start recording");
+        }
+    }
+
+    /**
+     * @brief   Stops a recording and finishes its file (final header, flushed to disk).
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Recording id returned by startRecording
+     * @return  Napi::Value The final stats (as getRecordingStats), or null for an unknown id
+     */
+    Napi::Value StopRecording(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Recording id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<CaptureRecorder> recorder;
+        {
+            RecorderRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.recorders.find(info[0].As<Napi::Number>().Uint32Value());
+            if (it == registry.recorders.end())
+                return env.Null();
+            recorder = std::move(it->second);
+            registry.recorders.erase(it);
+        }
+
+        try
+        {
+            OperationSupervisor::Instance().Run(L"recorder", [recorder]()
+                                                { recorder->Stop(); });
+            return StatsToObject(env, recorder->Stats());
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop recording");
+        }
+    }
+
+    /**
+     * @brief   Returns the counters of a recording.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Recording id returned by startRecording
+     * @return  Napi::Value `{ running, error, sampleRate, channels, frames, durationMs,
+     *              bytesWritten, droppedFrames, gapFrames, glitches, queueDepth, maxQueueDepth,
+     *              blocks, writeMBps, maxWriteMs, maxPushUs, headerPatches, rf64 }`, or null
+     *              for an unknown id
+     */
+    Napi::Value GetRecordingStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Recording id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<CaptureRecorder> recorder;
+        {
+            RecorderRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.recorders.find(info[0].As<Napi::Number>().Uint32Value());
+            if (it == registry.recorders.end())
+                return env.Null();
+            recorder = it->second;
+        }
+        return StatsToObject(env, recorder->Stats());
+    }
+
+    /**
+     * @brief Registers recording functions on the module exports.
+     */
+    void InitRecorderBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("startRecording", Napi::Function::New(env, StartRecording));
+        exports.Set("stopRecording", Napi::Function::New(env, StopRecording));
+        exports.Set("getRecordingStats", Napi::Function::New(env, GetRecordingStats));
+        env.AddCleanupHook(StopAllRecorders);
+    }
+}
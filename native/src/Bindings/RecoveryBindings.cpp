@@ -0,0 +1,134 @@
+/**
+ * @file RecoveryBindings.cpp
+ * @brief Wires audio service restart recovery to the Core Audio runtime and exposes its
+ *        counters to JS.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/AudioSwitcher.h"
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/JackPresence.h"
+#include "AudioSwitcher/TopologyGraph.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/SafeRelease.h"
+
+#include <mutex>
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Recovery probe (recovery thread, MTA): drops the dead cached objects and
+         *        checks that a fresh enumerator can list endpoints again.
+         */
+        bool ProbeAudioService()
+        {
+            AudioRuntime::Instance().Reset();
+            IMMDeviceEnumerator *enumerator = AudioRuntime::Instance().AcquireEnumerator();
+            if (!enumerator)
+                return false;
+
+            IMMDeviceCollection *collection = nullptr;
+            const HRESULT hr = enumerator->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &collection);
+            SafeRelease(collection);
+            SafeRelease(enumerator);
+            return SUCCEEDED(hr);
+        }
+
+        ReplayActions CoreAudioReplay()
+        {
+            ReplayActions actions;
+            actions.setDefault = [](const std::wstring &id, uint8_t flow)
+            {
+                // Only render defaults are ever set through this library
+                return flow == eRender && AudioManager::setDefaultOutputDevice(id);
+            };
+            actions.setDefaultMute = [](bool mute)
+            {
+                return SetDefaultPlaybackDeviceMute(mute);
+            };
+            actions.setMute = [](const std::wstring &id, bool mute)
+            {
+                IMMDevice *device = GetDeviceById(id);
+                if (!device)
+                    return false; // endpoint did not come back
+                const bool muted = MuteDevice(device, mute);
+                SafeRelease(device);
+                return muted;
+            };
+            return actions;
+        }
+
+        void ConfigureRecovery()
+        {
+            ServiceRecovery &recovery = ServiceRecovery::Instance();
+
+            RecoveryOptions options;
+            options.threadScope = [](const std::function<void()> &loop)
+            {
+                COMInitializer com;
+                loop();
+            };
+            recovery.Configure(ProbeAudioService, options);
+            recovery.SetReplay(CoreAudioReplay());
+            // First hook: every later step reads through a fresh snapshot
+            recovery.AddHook([]()
+                             {
+                DeviceSnapshot::Instance().Invalidate();
+                TopologyCache::Instance().Clear();
+                JackTracker::Instance().Clear(); });
+        }
+    }
+
+    /**
+     * @brief   Returns the audio service recovery counters.
+     *
+     * @details When the Windows Audio service restarts, calls fail with an Error whose
+     *          `code` is 'ESERVICELOST' while a background thread waits for the service
+     *          (with exponential backoff), recreates the cached COM objects, re-registers
+     *          notifications and replays the defaults and mutes set through this module.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Object `{ recovering, detections, restarts, attempts, lastCause,
+     *              lastDowntimeMs }`; `lastCause` is the triggering HRESULT
+     *
+     * @example
+     * // JavaScript usage:
+     * const { recovering, restarts } = getServiceRecoveryStats();
+     */
+    Napi::Value GetServiceRecoveryStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const RecoveryStats stats = ServiceRecovery::Instance().Stats();
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("recovering", Napi::Boolean::New(env, stats.recovering));
+        obj.Set("detections", Napi::Number::New(env, static_cast<double>(stats.detections)));
+        obj.Set("restarts", Napi::Number::New(env, static_cast<double>(stats.restarts)));
+        obj.Set("attempts", Napi::Number::New(env, stats.attempts));
+        obj.Set("lastCause", Napi::Number::New(env, static_cast<uint32_t>(stats.lastCause)));
+        obj.Set("lastDowntimeMs", Napi::Number::New(env, stats.lastDowntimeMs));
+        return obj;
+    }
+
+    /**
+     * @brief Configures recovery (once per process) and registers its functions, plus the
+     *        `recoversNatively` flag.
+     */
+    void InitRecoveryBindings(Napi::Env env, Napi::Object exports)
+    {
+        static std::once_flag configured;
+        std::call_once(configured, ConfigureRecovery);
+
+        exports.Set("getServiceRecoveryStats", Napi::Function::New(env, GetServiceRecoveryStats));
+        // The daemon leaves replaying defaults and mutes to the addon (see lib/daemon/recovery.js)
+        exports.Set("recoversNatively", Napi::Boolean::New(env, true));
+    }
+}
@@ -0,0 +1,224 @@
+/**
+ * @file RouterBindings.cpp
+ * @brief N-API bindings for software passthrough routes between two endpoints.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "Streaming/PassthroughRouter.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Running routes by id. Routes outlive the calls that created them, so they
+         *        are owned here and stopped explicitly or when the environment shuts down.
+         */
+        struct RouterRegistry
+        {
+            std::mutex mutex;
+            std::map<uint32_t, std::shared_ptr<PassthroughRouter>> routers;
+            uint32_t nextId = 1;
+        };
+
+        RouterRegistry &Registry()
+        {
+            static RouterRegistry *registry = new RouterRegistry();
+            return *registry;
+        }
+
+        std::shared_ptr<PassthroughRouter> FindRouter(uint32_t id)
+        {
+            RouterRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.routers.find(id);
+            return it == registry.routers.end() ? nullptr : it->second;
+        }
+
+        /**
+         * @brief Stops every route; runs when the Node environment is torn down.
+         */
+        void StopAllRouters()
+        {
+            std::map<uint32_t, std::shared_ptr<PassthroughRouter>> routers;
+            {
+                RouterRegistry &registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                routers.swap(registry.routers);
+            }
+            for (auto &entry : routers)
+                entry.second->Stop();
+        }
+    }
+
+    /**
+     * @brief   Starts streaming audio from one endpoint to another.
+     *
+     * @details Capture and render run on dedicated real-time threads connected by a
+     *          lock-free ring; clock drift between the devices is compensated by adaptive
+     *          resampling, so the route holds its latency indefinitely.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ captureId?: string, renderId?: string,
+     *                loopback?: boolean, latencyMs?: number }`. Omitted ids use the
+     *                default endpoints; with `loopback` the capture id is a render endpoint.
+     * @return  Napi::Number Route id for stopPassthrough / getPassthroughStats
+     * @throws  Napi::Error When an endpoint cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * const id = startPassthrough({ captureId: micId, renderId: speakersId, latencyMs: 30 });
+     */
+    Napi::Value StartPassthrough(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        RouterOptions options;
+        if (info.Length() > 0 && !info[0].IsUndefined())
+        {
+            if (!info[0].IsObject())
+            {
+                Napi::TypeError::New(env, "Expected { captureId?, renderId?, loopback?, latencyMs? }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Object obj = info[0].As<Napi::Object>();
+            Napi::Value captureId = obj.Get("captureId");
+            Napi::Value renderId = obj.Get("renderId");
+            Napi::Value loopback = obj.Get("loopback");
+            Napi::Value latencyMs = obj.Get("latencyMs");
+            if (!(captureId.IsUndefined() || captureId.IsString()) || !(renderId.IsUndefined() || renderId.IsString()) ||
+                !(loopback.IsUndefined() || loopback.IsBoolean()) || !(latencyMs.IsUndefined() || latencyMs.IsNumber()))
+            {
+                Napi::TypeError::New(env, "Expected { captureId?: string, renderId?: string, loopback?: boolean, latencyMs?: number }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            if (captureId.IsString())
+                options.captureId = ToWString(captureId);
+            if (renderId.IsString())
+                options.renderId = ToWString(renderId);
+            if (loopback.IsBoolean())
+                options.loopback = loopback.As<Napi::Boolean>().Value();
+            if (latencyMs.IsNumber())
+                options.latencyMs = latencyMs.As<Napi::Number>().DoubleValue();
+        }
+
+        try
+        {
+            std::shared_ptr<PassthroughRouter> router = OperationSupervisor::Instance().Run(L"passthrough", [options]()
+                                                                                           {
+                COMInitializer com;
+                auto router = std::make_shared<PassthroughRouter>(options);
+                router->Start();
+                return router; });
+
+            RouterRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const uint32_t id = registry.nextId++;
+            registry.routers.emplace(id, std::move(router));
+            return Napi::Number::New(env, id);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to start passthrough");
+        }
+    }
+
+    /**
+     * @brief   Stops a passthrough route and releases both endpoints.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Route id returned by startPassthrough
+     * @return  Napi::Boolean true if the route existed
+     */
+    Napi::Value StopPassthrough(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Route id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<PassthroughRouter> router;
+        {
+            RouterRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.routers.find(info[0].As<Napi::Number>().Uint32Value());
+            if (it == registry.routers.end())
+                return Napi::Boolean::New(env, false);
+            router = std::move(it->second);
+            registry.routers.erase(it);
+        }
+
+        try
+        {
+            OperationSupervisor::Instance().Run(L"passthrough", [router]()
+                                                { router->Stop(); });
+            return Napi::Boolean::New(env, true);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop passthrough");
+        }
+    }
+
+    /**
+     * @brief   Returns the counters of a passthrough route.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Route id returned by startPassthrough
+     * @return  Napi::Value `{ running, error, captureRate, renderRate, underruns, overruns,
+     *              capturedFrames, renderedFrames, latencyMs, targetLatencyMs, driftPpm }`,
+     *              or null for an unknown id
+     */
+    Napi::Value GetPassthroughStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Route id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<PassthroughRouter> router = FindRouter(info[0].As<Napi::Number>().Uint32Value());
+        if (!router)
+            return env.Null();
+
+        const RouterStats stats = router->Stats();
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("running", Napi::Boolean::New(env, stats.running));
+        obj.Set("error", stats.error.empty() ? env.Null() : Napi::String::New(env, stats.error));
+        obj.Set("captureRate", Napi::Number::New(env, stats.captureRate));
+        obj.Set("renderRate", Napi::Number::New(env, stats.renderRate));
+        obj.Set("underruns", Napi::Number::New(env, static_cast<double>(stats.pipe.underruns)));
+        obj.Set("overruns", Napi::Number::New(env, static_cast<double>(stats.pipe.overruns)));
+        obj.Set("capturedFrames", Napi::Number::New(env, static_cast<double>(stats.pipe.capturedFrames)));
+        obj.Set("renderedFrames", Napi::Number::New(env, static_cast<double>(stats.pipe.renderedFrames)));
+        obj.Set("latencyMs", Napi::Number::New(env, stats.pipe.fillMs));
+        obj.Set("targetLatencyMs", Napi::Number::New(env, stats.pipe.targetMs));
+        obj.Set("driftPpm", Napi::Number::New(env, stats.pipe.correctionPpm));
+        return obj;
+    }
+
+    /**
+     * @brief Registers passthrough routing functions on the module exports.
+     */
+    void InitRouterBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("startPassthrough", Napi::Function::New(env, StartPassthrough));
+        exports.Set("stopPassthrough", Napi::Function::New(env, StopPassthrough));
+        exports.Set("getPassthroughStats", Napi::Function::New(env, GetPassthroughStats));
+        env.AddCleanupHook(StopAllRouters);
+    }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file SessionBindings.cpp
+ * @brief N-API bindings for audio session listings with cached process names.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/SessionSnapshot.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <audiopolicy.h>
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        const char *SessionStateName(int state)
+        {
+            switch (state)
+            {
+            case AudioSessionStateActive:
+                return "active";
+            case AudioSessionStateExpired:
+                return "expired";
+            default:
+                return "inactive";
+            }
+        }
+
+        /**
+         * @brief Converts one session to a JS object. Process fields are null while the
+         *        owning process is still being resolved (or if it has exited).
+         */
+        Napi::Object SessionToObject(Napi::Env env, const SessionInfo &session)
+        {
+            const bool ready = session.process.state == ProcessLookup::State::Ready;
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("deviceId", ToJsString(env, session.deviceId));
+            obj.Set("sessionId", ToJsString(env, session.sessionId));
+            obj.Set("pid", Napi::Number::New(env, session.pid));
+            obj.Set("processName", ready ? Napi::Value(ToJsString(env, session.process.info.name)) : env.Null());
+            obj.Set("processPath", ready && !session.process.info.path.empty() ? Napi::Value(ToJsString(env, session.process.info.path)) : env.Null());
+            obj.Set("processResolved", Napi::Boolean::New(env, session.process.state != ProcessLookup::State::Pending));
+            obj.Set("displayName", ToJsString(env, session.displayName));
+            obj.Set("iconPath", ToJsString(env, session.iconPath));
+            obj.Set("state", Napi::String::New(env, SessionStateName(session.state)));
+            obj.Set("volume", Napi::Number::New(env, session.volume));
+            obj.Set("muted", Napi::Boolean::New(env, session.muted));
+            obj.Set("isSystemSounds", Napi::Boolean::New(env, session.systemSounds));
+            return obj;
+        }
+    }
+
+    /**
+     * @brief   Lists audio sessions with the name and path of the owning process.
+     *
+     * @details Process information is cached by pid + start time and resolved by a
+     *          background pool, so this call never waits on OpenProcess. A session whose
+     *          process has not been resolved yet has `processResolved: false` and null
+     *          process fields; pass `{ waitForNames: true }` to block until it is.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ deviceId?: string, waitForNames?: boolean }`
+     * @return  Napi::Array Array of `{ deviceId, sessionId, pid, processName, processPath,
+     *              processResolved, displayName, iconPath, state, volume, muted, isSystemSounds }`
+     */
+    Napi::Value ListAudioSessions(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        std::wstring deviceId;
+        bool waitForNames = false;
+        if (info.Length() > 0 && !info[0].IsUndefined())
+        {
+            if (!info[0].IsObject())
+            {
+                Napi::TypeError::New(env, "Expected { deviceId?, waitForNames? }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Object options = info[0].As<Napi::Object>();
+            Napi::Value id = options.Get("deviceId");
+            Napi::Value wait = options.Get("waitForNames");
+            if (!(id.IsUndefined() || id.IsString()) || !(wait.IsUndefined() || wait.IsBoolean()))
+            {
+                Napi::TypeError::New(env, "Expected { deviceId?: string, waitForNames?: boolean }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            if (id.IsString())
+                deviceId = ToWString(id);
+            waitForNames = wait.IsBoolean() && wait.As<Napi::Boolean>().Value();
+        }
+
+        try
+        {
+            std::vector<SessionInfo> sessions = OperationSupervisor::Instance().Run(deviceId.empty() ? L"sessions" : deviceId, [deviceId, waitForNames]()
+                                                                                    {
+                COMInitializer com;
+                std::vector<SessionInfo> result = SessionSnapshot::Instance().List(deviceId);
+                if (waitForNames)
+                    SessionSnapshot::Instance().WaitForProcessNames(result);
+                return result; });
+
+            Napi::Array result = Napi::Array::New(env, sessions.size());
+            for (size_t i = 0; i < sessions.size(); ++i)
+                result.Set(i, SessionToObject(env, sessions[i]));
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns counters of the session process-info cache.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Object `{ hits, misses, resolutions, evictions, invalidations, size, pending }`
+     */
+    Napi::Value GetSessionCacheStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        const ProcessCacheStats stats = SessionSnapshot::Instance().CacheStats();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+        obj.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+        obj.Set("resolutions", Napi::Number::New(env, static_cast<double>(stats.resolutions)));
+        obj.Set("evictions", Napi::Number::New(env, static_cast<double>(stats.evictions)));
+        obj.Set("invalidations", Napi::Number::New(env, static_cast<double>(stats.invalidations)));
+        obj.Set("size", Napi::Number::New(env, static_cast<double>(stats.size)));
+        obj.Set("pending", Napi::Number::New(env, static_cast<double>(stats.pending)));
+        return obj;
+    }
+
+    /**
+     * @brief Registers audio session functions on the module exports.
+     */
+    void InitSessionBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("listAudioSessions", Napi::Function::New(env, ListAudioSessions));
+        exports.Set("getSessionCacheStats", Napi::Function::New(env, GetSessionCacheStats));
+    }
+}
@@ -0,0 +1,407 @@
+/**
+ * @file SignalBindings.cpp
+ * @brief N-API bindings for test and calibration signals (sine, sweep, noise, clicks)
+ *        played on render endpoints.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/EndpointKey.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Streaming/SharedModeClient.h"
+#include "Streaming/SignalPlayer.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace AudioSwitcher;
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        constexpr size_t kMaxSignals = 16;         ///< Endpoints playing at once.
+        constexpr size_t kScratchFloats = 8192;    ///< Mono frames generated per block.
+
+        /**
+         * @brief One warm player per endpoint, kept between signals so restarting is cheap.
+         */
+        using PlayerMap = std::unordered_map<EndpointKey, std::shared_ptr<SignalPlayer>, EndpointKeyHash>;
+
+        struct SignalRegistry
+        {
+            std::mutex mutex;
+            PlayerMap players;
+            Dsp::BlockPool pool{kMaxSignals, kScratchFloats};
+        };
+
+        SignalRegistry &Registry()
+        {
+            static SignalRegistry *registry = new SignalRegistry();
+            return *registry;
+        }
+
+        /// @param id Resolved endpoint ID; the supervisor has interned it already.
+        std::shared_ptr<SignalPlayer> PlayerFor(const std::wstring &id)
+        {
+            const EndpointKey key = EndpointKey::Intern(id);
+            SignalRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::shared_ptr<SignalPlayer> &player = registry.players[key];
+            if (!player)
+                player = std::make_shared<SignalPlayer>(id, registry.pool);
+            return player;
+        }
+
+        bool ParseSignalType(const std::string &name, Dsp::SignalType &type)
+        {
+            static const std::pair<const char *, Dsp::SignalType> kTypes[] = {
+                {"sine", Dsp::SignalType::Sine},
+                {"sweep", Dsp::SignalType::Sweep},
+                {"white", Dsp::SignalType::WhiteNoise},
+                {"pink", Dsp::SignalType::PinkNoise},
+                {"clicks", Dsp::SignalType::Clicks},
+            };
+            for (const auto &entry : kTypes)
+            {
+                if (name == entry.first)
+                {
+                    type = entry.second;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Closes every player; they reopen on the next play. Used when the audio
+         *        service restarts (the streams died with it) and at environment teardown.
+         */
+        void CloseAllPlayers()
+        {
+            PlayerMap players;
+            {
+                SignalRegistry &registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                players.swap(registry.players);
+            }
+            for (auto &entry : players)
+                entry.second->Close();
+        }
+
+        void CloseOnCleanup()
+        {
+            try
+            {
+                CloseAllPlayers();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    /**
+     * @brief   Plays a generated test signal on a render endpoint.
+     *
+     * @details The endpoint's shared-mode stream is opened on first use and kept warm, so
+     *          later calls switch or restart the signal in a few milliseconds without
+     *          re-activating the device. Each endpoint plays one signal at a time; signals
+     *          on different endpoints play concurrently (up to 16). Noise levels are RMS,
+     *          tone and click levels are peak.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: `{ deviceId?: string, type?: 'sine'|'sweep'|'white'|'pink'|'clicks',
+     *                frequency?: number, endFrequency?: number, sweepMs?: number,
+     *                intervalMs?: number, levelDb?: number, channel?: number,
+     *                durationMs?: number, seed?: number }`. Omitting deviceId uses the
+     *                default render endpoint; `channel` limits the signal to one channel.
+     * @return  Napi::Object `{ deviceId, sampleRate, channels, startMs }`
+     * @throws  Napi::Error When the endpoint cannot be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * playTestSignal({ deviceId, type: 'pink', levelDb: -20, durationMs: 5000 });
+     */
+    Napi::Value PlayTestSignal(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsObject())
+        {
+            Napi::TypeError::New(env, "Expected signal options").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object obj = info.Length() > 0 && info[0].IsObject() ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+        SignalOptions options;
+        std::wstring deviceId;
+        Napi::Value id = obj.Get("deviceId");
+        Napi::Value type = obj.Get("type");
+        if (!(id.IsUndefined() || id.IsNull() || id.IsString()) || !(type.IsUndefined() || type.IsString()))
+        {
+            Napi::TypeError::New(env, "Expected { deviceId?: string, type?: string }").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (id.IsString())
+            deviceId = ToWString(id);
+        if (type.IsString() && !ParseSignalType(type.As<Napi::String>().Utf8Value(), options.signal.type))
+        {
+            Napi::TypeError::New(env, "type must be 'sine', 'sweep', 'white', 'pink' or 'clicks'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        // Numeric options: name, destination, scale from the JS unit, lower bound (exclusive)
+        struct NumberOption
+        {
+            const char *name;
+            double *target;
+            double scale;
+            double above;
+        };
+        double channel = -1.0;
+        double seed = options.signal.seed;
+        const NumberOption numbers[] = {
+            {"frequency", &options.signal.frequency, 1.0, 0.0},
+            {"endFrequency", &options.signal.endFrequency, 1.0, 0.0},
+            {"sweepMs", &options.signal.sweepSeconds, 0.001, 0.0},
+            {"intervalMs", &options.signal.clickSeconds, 0.001, 0.0},
+            {"levelDb", &options.signal.levelDb, 1.0, -200.0},
+            {"durationMs", &options.durationMs, 1.0, -1.0},
+            {"channel", &channel, 1.0, -2.0},
+            {"seed", &seed, 1.0, -1.0},
+        };
+        for (const NumberOption &option : numbers)
+        {
+            Napi::Value value = obj.Get(option.name);
+            if (value.IsUndefined())
+                continue;
+            if (!value.IsNumber() || !(value.As<Napi::Number>().DoubleValue() > option.above))
+            {
+                const std::string message = std::string("Invalid ") + option.name;
+                Napi::TypeError::New(env, message).ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            *option.target = value.As<Napi::Number>().DoubleValue() * option.scale;
+        }
+        options.channel = static_cast<int>(channel);
+        options.signal.seed = static_cast<uint32_t>(seed);
+        if (options.signal.levelDb > 0.0)
+        {
+            Napi::RangeError::New(env, "levelDb must be at most 0 (dBFS)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        try
+        {
+            const std::wstring resolved = OperationSupervisor::Instance().Run(L"signal", [deviceId]()
+                                                                              {
+                COMInitializer com;
+                return ResolveEndpointId(deviceId, eRender); });
+
+            std::shared_ptr<SignalPlayer> player = PlayerFor(resolved);
+            const SignalPlayerStats stats = OperationSupervisor::Instance().Run(resolved, [player, options]()
+                                                                                {
+                COMInitializer com;
+                player->Play(options);
+                return player->Stats(); });
+
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("deviceId", ToJsString(env, resolved));
+            result.Set("sampleRate", Napi::Number::New(env, stats.sampleRate));
+            result.Set("channels", Napi::Number::New(env, stats.channels));
+            result.Set("startMs", Napi::Number::New(env, stats.lastStartMs));
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Opens (warms up) the stream of one or more endpoints without playing, so
+     *          the first playTestSignal on them starts as fast as later ones.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): endpoint ID or array of IDs (default render endpoint if omitted)
+     * @return  Napi::Array Resolved endpoint IDs
+     * @throws  Napi::Error When an endpoint cannot be opened
+     */
+    Napi::Value PrepareTestSignal(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        std::vector<std::wstring> ids;
+        if (info.Length() == 0 || info[0].IsUndefined())
+            ids.emplace_back();
+        else if (info[0].IsString())
+            ids.push_back(ToWString(info[0]));
+        else if (info[0].IsArray())
+        {
+            Napi::Array array = info[0].As<Napi::Array>();
+            for (uint32_t i = 0; i < array.Length(); ++i)
+            {
+                Napi::Value value = array.Get(i);
+                if (!value.IsString())
+                {
+                    Napi::TypeError::New(env, "Expected endpoint ID strings").ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+                ids.push_back(ToWString(value));
+            }
+        }
+        else
+        {
+            Napi::TypeError::New(env, "Expected an endpoint ID or an array of IDs").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        try
+        {
+            Napi::Array result = Napi::Array::New(env, ids.size());
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                const std::wstring requested = ids[i];
+                const std::wstring resolved = OperationSupervisor::Instance().Run(L"signal", [requested]()
+                                                                                  {
+                    COMInitializer com;
+                    return ResolveEndpointId(requested, eRender); });
+                std::shared_ptr<SignalPlayer> player = PlayerFor(resolved);
+                OperationSupervisor::Instance().Run(resolved, [player]()
+                                                    {
+                    COMInitializer com;
+                    player->Open(); });
+                result.Set(i, ToJsString(env, resolved));
+            }
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Stops the test signal on one endpoint, or on all of them.
+     *
+     * @details Streams stay open for a fast restart unless `{ release: true }` is passed.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): endpoint ID (omit or null for every endpoint)
+     *              - args[1] (optional): `{ release?: boolean }`
+     * @return  Napi::Number Number of endpoints stopped
+     */
+    Napi::Value StopTestSignal(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const bool single = info.Length() > 0 && info[0].IsString();
+        if (info.Length() > 0 && !single && !info[0].IsUndefined() && !info[0].IsNull())
+        {
+            Napi::TypeError::New(env, "Expected an endpoint ID string").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        bool release = false;
+        if (info.Length() > 1 && info[1].IsObject())
+        {
+            Napi::Value value = info[1].As<Napi::Object>().Get("release");
+            release = value.IsBoolean() && value.As<Napi::Boolean>().Value();
+        }
+
+        std::vector<std::pair<EndpointKey, std::shared_ptr<SignalPlayer>>> players;
+        {
+            SignalRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const EndpointKey key = single ? EndpointKey::Lookup(ToWString(info[0])) : EndpointKey();
+            for (auto it = registry.players.begin(); it != registry.players.end();)
+            {
+                if (single && it->first != key)
+                {
+                    ++it;
+                    continue;
+                }
+                players.emplace_back(it->first, it->second);
+                it = release ? registry.players.erase(it) : std::next(it);
+            }
+        }
+
+        try
+        {
+            for (auto &entry : players)
+            {
+                std::shared_ptr<SignalPlayer> player = entry.second;
+                OperationSupervisor::Instance().Run(entry.first.ToWString(), [player, release]()
+                                                    {
+                    COMInitializer com;
+                    if (release)
+                        player->Close();
+                    else
+                        player->Stop(); });
+            }
+            return Napi::Number::New(env, static_cast<double>(players.size()));
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop test signal");
+        }
+    }
+
+    /**
+     * @brief   Returns the state of every endpoint used for test signals.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Array `[{ deviceId, open, playing, sampleRate, channels, framesRendered,
+     *              lastStartMs, error }]`
+     */
+    Napi::Value GetTestSignals(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        std::vector<std::pair<EndpointKey, std::shared_ptr<SignalPlayer>>> players;
+        {
+            SignalRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            players.assign(registry.players.begin(), registry.players.end());
+        }
+
+        Napi::Array result = Napi::Array::New(env, players.size());
+        for (size_t i = 0; i < players.size(); ++i)
+        {
+            const SignalPlayerStats stats = players[i].second->Stats();
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("deviceId", ToJsString(env, players[i].first.ToWString()));
+            obj.Set("open", Napi::Boolean::New(env, stats.open));
+            obj.Set("playing", Napi::Boolean::New(env, stats.playing));
+            obj.Set("sampleRate", Napi::Number::New(env, stats.sampleRate));
+            obj.Set("channels", Napi::Number::New(env, stats.channels));
+            obj.Set("framesRendered", Napi::Number::New(env, static_cast<double>(stats.framesRendered)));
+            obj.Set("lastStartMs", Napi::Number::New(env, stats.lastStartMs));
+            obj.Set("error", stats.error.empty() ? env.Null() : Napi::String::New(env, stats.error));
+            result.Set(i, obj);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Registers test signal functions on the module exports.
+     */
+    void InitSignalBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("playTestSignal", Napi::Function::New(env, PlayTestSignal));
+        exports.Set("prepareTestSignal", Napi::Function::New(env, PrepareTestSignal));
+        exports.Set("stopTestSignal", Napi::Function::New(env, StopTestSignal));
+        exports.Set("getTestSignals", Napi::Function::New(env, GetTestSignals));
+        env.AddCleanupHook(CloseOnCleanup);
+
+        static std::once_flag recoveryRegistered;
+        std::call_once(recoveryRegistered, []()
+                       { ServiceRecovery::Instance().AddHook(CloseAllPlayers); });
+    }
+}
@@ -0,0 +1,338 @@
+/**
+ * @file SnapshotBindings.cpp
+ * @brief N-API bindings for the in-memory device snapshot, audio effects state and
+ *        "Listen to this device" routing.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/ListenRouting.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Loads (or refreshes) the snapshot under the watchdog.
+         */
+        std::shared_ptr<const DeviceSnapshot::Table> LoadSnapshot(bool refresh, bool effects = false, bool jacks = false)
+        {
+            return OperationSupervisor::Instance().Run(L"snapshot", [refresh, effects, jacks]()
+                                                       {
+                COMInitializer com;
+                DeviceSnapshot &snapshot = DeviceSnapshot::Instance();
+                if (refresh)
+                    snapshot.Refresh();
+                std::shared_ptr<const DeviceSnapshot::Table> table = effects ? snapshot.LoadEffects() : snapshot.Get();
+                return jacks ? snapshot.LoadJacks() : table; });
+        }
+
+        /**
+         * @brief Reads a boolean option from an optional options object.
+         */
+        bool BoolOption(const Napi::CallbackInfo &info, const char *name)
+        {
+            if (info.Length() == 0 || !info[0].IsObject())
+                return false;
+            Napi::Value value = info[0].As<Napi::Object>().Get(name);
+            return value.IsBoolean() && value.As<Napi::Boolean>().Value();
+        }
+
+        const char *EffectStateName(EffectState state)
+        {
+            switch (state)
+            {
+            case EffectState::Enabled:
+                return "enabled";
+            case EffectState::Disabled:
+                return "disabled";
+            default:
+                return "unknown";
+            }
+        }
+
+        /**
+         * @brief Converts effects to `{ enhancements, spatialAudio, spatialMaxObjects }`,
+         *        or undefined if they have not been loaded.
+         */
+        Napi::Value EffectsToObject(Napi::Env env, const EffectsInfo &effects)
+        {
+            if (!effects.loaded)
+                return env.Undefined();
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("enhancements", Napi::String::New(env, EffectStateName(effects.enhancements)));
+            obj.Set("spatialAudio", Napi::String::New(env, EffectStateName(effects.spatialAudio)));
+            obj.Set("spatialMaxObjects", Napi::Number::New(env, effects.spatialMaxObjects));
+            return obj;
+        }
+
+        /**
+         * @brief Looks up the friendly name of an endpoint in a snapshot table.
+         */
+        const EndpointInfo *FindEndpoint(const DeviceSnapshot::Table &table, const std::wstring &id)
+        {
+            const EndpointKey key = EndpointKey::Lookup(id);
+            if (key.Empty())
+                return nullptr;
+            for (const EndpointInfo &endpoint : table)
+            {
+                if (endpoint.key == key)
+                    return &endpoint;
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Converts listen settings to `{ enabled, targetId }`, or undefined for render endpoints.
+         */
+        Napi::Value ListenToObject(Napi::Env env, const ListenSettings &listen)
+        {
+            if (!listen.valid)
+                return env.Undefined();
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("enabled", Napi::Boolean::New(env, listen.enabled));
+            obj.Set("targetId", ToJsString(env, listen.targetId));
+            return obj;
+        }
+
+        /**
+         * @brief Converts one snapshot entry to a JS object.
+         */
+        Napi::Object EndpointToObject(Napi::Env env, const EndpointInfo &endpoint)
+        {
+            Napi::Object roles = Napi::Object::New(env);
+            roles.Set("console", Napi::Boolean::New(env, endpoint.IsDefaultFor(eConsole)));
+            roles.Set("multimedia", Napi::Boolean::New(env, endpoint.IsDefaultFor(eMultimedia)));
+            roles.Set("communications", Napi::Boolean::New(env, endpoint.IsDefaultFor(eCommunications)));
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("id", ToJsString(env, endpoint.id));
+            obj.Set("name", ToJsString(env, endpoint.name));
+            obj.Set("flow", Napi::String::New(env, endpoint.flow == eCapture ? "capture" : "render"));
+            obj.Set("isDefault", Napi::Boolean::New(env, endpoint.IsDefaultFor(eConsole)));
+            obj.Set("defaultRoles", roles);
+            obj.Set("listen", ListenToObject(env, endpoint.listen));
+            obj.Set("effects", EffectsToObject(env, endpoint.effects));
+            obj.Set("jack", JackToObject(env, endpoint.jack));
+            return obj;
+        }
+    }
+
+    /**
+     * @brief   Returns every active render and capture endpoint from the in-memory snapshot.
+     *
+     * @details The snapshot is built on the first call (one enumeration plus one property
+     *          store read per endpoint) and served from memory afterwards. Pass
+     *          `{ refresh: true }` to re-enumerate. With `{ effects: true }` enhancement and
+     *          spatial audio state is read for all endpoints that do not have it yet and
+     *          cached with the snapshot. `{ jacks: true }` does the same for jack presence,
+     *          which endpoint notifications then keep current.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ refresh?: boolean, effects?: boolean, jacks?: boolean }`
+     * @return  Napi::Array Array of
+     *              `{ id, name, flow: 'render'|'capture', isDefault, defaultRoles, listen?, effects?, jack? }`
+     */
+    Napi::Value GetDeviceSnapshot(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const bool refresh = BoolOption(info, "refresh");
+        const bool effects = BoolOption(info, "effects");
+        const bool jacks = BoolOption(info, "jacks");
+
+        try
+        {
+            auto table = LoadSnapshot(refresh, effects, jacks);
+            Napi::Array result = Napi::Array::New(env, table->size());
+            for (size_t i = 0; i < table->size(); ++i)
+                result.Set(i, EndpointToObject(env, (*table)[i]));
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns enhancement and spatial audio state of every endpoint in one call.
+     *
+     * @details Loads effects into the snapshot on first use (one property read and, for
+     *          render endpoints, one spatial audio client activation each); later calls
+     *          are answered from memory until the snapshot is refreshed.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ refresh?: boolean }`
+     * @return  Napi::Array Array of `{ id, name, flow, enhancements, spatialAudio,
+     *              spatialMaxObjects }` where states are 'enabled' | 'disabled' | 'unknown'
+     */
+    Napi::Value GetAudioEffects(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        try
+        {
+            auto table = LoadSnapshot(BoolOption(info, "refresh"), true);
+            Napi::Array result = Napi::Array::New(env, table->size());
+            for (size_t i = 0; i < table->size(); ++i)
+            {
+                const EndpointInfo &endpoint = (*table)[i];
+                Napi::Object obj = Napi::Object::New(env);
+                obj.Set("id", ToJsString(env, endpoint.id));
+                obj.Set("name", ToJsString(env, endpoint.name));
+                obj.Set("flow", Napi::String::New(env, endpoint.flow == eCapture ? "capture" : "render"));
+                obj.Set("enhancements", Napi::String::New(env, EffectStateName(endpoint.effects.enhancements)));
+                obj.Set("spatialAudio", Napi::String::New(env, EffectStateName(endpoint.effects.spatialAudio)));
+                obj.Set("spatialMaxObjects", Napi::Number::New(env, endpoint.effects.spatialMaxObjects));
+                result.Set(i, obj);
+            }
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns the listen routing topology of all capture endpoints from memory.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Array Array of
+     *              `{ deviceId, name, enabled, targetId, targetName }` where an empty
+     *              `targetId` means "Default Playback Device".
+     */
+    Napi::Value GetListenRouting(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        try
+        {
+            auto table = LoadSnapshot(false);
+            Napi::Array result = Napi::Array::New(env);
+            uint32_t index = 0;
+            for (const EndpointInfo &endpoint : *table)
+            {
+                if (endpoint.flow != eCapture || !endpoint.listen.valid)
+                    continue;
+
+                const EndpointInfo *target = FindEndpoint(*table, endpoint.listen.targetId);
+
+                Napi::Object obj = Napi::Object::New(env);
+                obj.Set("deviceId", ToJsString(env, endpoint.id));
+                obj.Set("name", ToJsString(env, endpoint.name));
+                obj.Set("enabled", Napi::Boolean::New(env, endpoint.listen.enabled));
+                obj.Set("targetId", ToJsString(env, endpoint.listen.targetId));
+                obj.Set("targetName", target ? ToJsString(env, target->name) : Napi::String::New(env, ""));
+                result.Set(index++, obj);
+            }
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Sets "Listen to this device" routing for several capture endpoints in one call.
+     *
+     * @details All changes go through a single IPolicyConfig instance. Successful changes
+     *          are applied to the snapshot so later queries reflect them without a refresh.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Array of `{ deviceId: string, enabled: boolean, targetId?: string }`
+     * @return  Napi::Array Array of booleans, one per change
+     * @throws  Napi::TypeError When the argument is not an array of change objects
+     *
+     * @example
+     * // JavaScript usage:
+     * setListenRouting([{ deviceId: micId, enabled: true, targetId: speakersId }]);
+     */
+    Napi::Value SetListenRouting(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected an array of { deviceId, enabled, targetId? }").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        Napi::Array input = info[0].As<Napi::Array>();
+        std::vector<ListenChange> changes;
+        changes.reserve(input.Length());
+        for (uint32_t i = 0; i < input.Length(); ++i)
+        {
+            Napi::Value item = input.Get(i);
+            if (!item.IsObject())
+            {
+                Napi::TypeError::New(env, "Each change must be an object").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Object obj = item.As<Napi::Object>();
+            Napi::Value deviceId = obj.Get("deviceId");
+            Napi::Value enabled = obj.Get("enabled");
+            Napi::Value targetId = obj.Get("targetId");
+            if (!deviceId.IsString() || !enabled.IsBoolean() || !(targetId.IsUndefined() || targetId.IsString()))
+            {
+                Napi::TypeError::New(env, "Expected { deviceId: string, enabled: boolean, targetId?: string }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+
+            ListenChange change;
+            change.captureId = ToWString(deviceId);
+            change.enabled = enabled.As<Napi::Boolean>().Value();
+            if (targetId.IsString())
+                change.targetId = ToWString(targetId);
+            changes.push_back(std::move(change));
+        }
+
+        try
+        {
+            std::vector<bool> results = OperationSupervisor::Instance().Run(L"listen", [changes]()
+                                                                            {
+                COMInitializer com;
+                return ApplyListenChanges(changes); });
+
+            Napi::Array output = Napi::Array::New(env, results.size());
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                output.Set(i, Napi::Boolean::New(env, results[i]));
+                if (!results[i])
+                    continue;
+
+                const ListenChange &change = changes[i];
+                DeviceSnapshot::Instance().Update(change.captureId, [&change](EndpointInfo &endpoint)
+                                                  {
+                    endpoint.listen.valid = true;
+                    endpoint.listen.enabled = change.enabled;
+                    endpoint.listen.targetId = change.targetId; });
+            }
+            return output;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief Registers snapshot, audio effects and listen routing functions on the module exports.
+     */
+    void InitSnapshotBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("getDeviceSnapshot", Napi::Function::New(env, GetDeviceSnapshot));
+        exports.Set("getAudioEffects", Napi::Function::New(env, GetAudioEffects));
+        exports.Set("getListenRouting", Napi::Function::New(env, GetListenRouting));
+        exports.Set("setListenRouting", Napi::Function::New(env, SetListenRouting));
+    }
+}
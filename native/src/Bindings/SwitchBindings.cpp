@@ -0,0 +1,365 @@
+/**
+ * @file SwitchBindings.cpp
+ * @brief N-API bindings for switching the default endpoint from memory: back to the
+ *        previous default, or on to the next of a set of candidates.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/AudioSwitcher.h"
+#include "AudioSwitcher/DefaultHistory.h"
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/ServiceRecovery.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <algorithm>
+#include <cwctype>
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Roles and flow a switch applies to. History and cycling are resolved on
+         *        the first role; 'all' sets the three roles one after the other.
+         */
+        struct SwitchScope
+        {
+            std::vector<ERole> roles;
+            EDataFlow flow = eRender;
+        };
+
+        /**
+         * @brief Parses `(role?, { flow? })`. Throws a TypeError and returns false on bad input.
+         */
+        bool ParseScope(const Napi::CallbackInfo &info, SwitchScope &scope)
+        {
+            Napi::Env env = info.Env();
+
+            std::string role = "console";
+            if (info.Length() > 0 && !info[0].IsUndefined())
+            {
+                if (!info[0].IsString())
+                {
+                    Napi::TypeError::New(env, "Expected role: 'console' | 'multimedia' | 'communications' | 'all'").ThrowAsJavaScriptException();
+                    return false;
+                }
+                role = info[0].As<Napi::String>().Utf8Value();
+            }
+            if (role == "console")
+                scope.roles = {eConsole};
+            else if (role == "multimedia")
+                scope.roles = {eMultimedia};
+            else if (role == "communications")
+                scope.roles = {eCommunications};
+            else if (role == "all")
+                scope.roles = {eConsole, eMultimedia, eCommunications};
+            else
+            {
+                Napi::TypeError::New(env, "Expected role: 'console' | 'multimedia' | 'communications' | 'all'").ThrowAsJavaScriptException();
+                return false;
+            }
+
+            if (info.Length() > 1 && info[1].IsObject())
+            {
+                Napi::Value flow = info[1].As<Napi::Object>().Get("flow");
+                if (flow.IsString() && flow.As<Napi::String>().Utf8Value() == "capture")
+                    scope.flow = eCapture;
+                else if (!flow.IsUndefined() && !(flow.IsString() && flow.As<Napi::String>().Utf8Value() == "render"))
+                {
+                    Napi::TypeError::New(env, "Expected flow: 'render' | 'capture'").ThrowAsJavaScriptException();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Returns the snapshot, building it under the watchdog on first use.
+         */
+        std::shared_ptr<const DeviceSnapshot::Table> LoadTable()
+        {
+            return OperationSupervisor::Instance().Run(L"snapshot", []()
+                                                       {
+                COMInitializer com;
+                return DeviceSnapshot::Instance().Get(); });
+        }
+
+        const EndpointInfo *FindEndpoint(const DeviceSnapshot::Table &table, const EndpointKey &key, EDataFlow flow)
+        {
+            for (const EndpointInfo &endpoint : table)
+            {
+                if (endpoint.key == key && endpoint.flow == flow)
+                    return &endpoint;
+            }
+            return nullptr;
+        }
+
+        EndpointKey CurrentDefault(const DeviceSnapshot::Table &table, EDataFlow flow, ERole role)
+        {
+            for (const EndpointInfo &endpoint : table)
+            {
+                if (endpoint.flow == flow && endpoint.IsDefaultFor(role))
+                    return endpoint.key;
+            }
+            return EndpointKey();
+        }
+
+        /**
+         * @brief Records the snapshot's defaults, so the history is usable even when
+         *        notifications are not running. A no-op for defaults already current.
+         */
+        void SyncHistory(const DeviceSnapshot::Table &table)
+        {
+            DefaultHistory &history = DefaultHistory::Instance();
+            for (const EndpointInfo &endpoint : table)
+            {
+                for (uint8_t role = 0; role < DefaultHistory::kRoles; ++role)
+                {
+                    if (endpoint.IsDefaultFor(static_cast<ERole>(role)))
+                        history.Record(static_cast<uint8_t>(endpoint.flow), role, endpoint.key);
+                }
+            }
+        }
+
+        bool ContainsNoCase(const std::wstring &haystack, const std::wstring &needle)
+        {
+            auto lower = [](wchar_t c)
+            { return static_cast<wchar_t>(std::towlower(c)); };
+            auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                                  [&](wchar_t a, wchar_t b)
+                                  { return lower(a) == lower(b); });
+            return it != haystack.end();
+        }
+
+        /**
+         * @brief Makes @p target the default for every role in @p scope, then updates the
+         *        history and the snapshot in place instead of re-enumerating.
+         */
+        bool SwitchTo(const DeviceSnapshot::Table &table, const EndpointInfo &target, const SwitchScope &scope)
+        {
+            const std::wstring id = target.id;
+            const std::vector<ERole> roles = scope.roles;
+            const bool switched = OperationSupervisor::Instance().Run(id, [id, roles]()
+                                                                      {
+                COMInitializer com;
+                bool ok = true;
+                for (ERole role : roles)
+                    ok = AudioManager::setDefaultEndpoint(id, role) && ok;
+                return ok; });
+            if (!switched)
+            {
+                DeviceSnapshot::Instance().Invalidate(); // some roles may have changed
+                return false;
+            }
+
+            uint8_t mask = 0;
+            for (ERole role : roles)
+            {
+                mask |= static_cast<uint8_t>(1u << role);
+                DefaultHistory::Instance().Record(static_cast<uint8_t>(scope.flow), static_cast<uint8_t>(role), target.key);
+            }
+            DeviceSnapshot &snapshot = DeviceSnapshot::Instance();
+            for (const EndpointInfo &endpoint : table)
+            {
+                if (endpoint.flow == scope.flow && endpoint.key != target.key && (endpoint.defaultRoles & mask))
+                    snapshot.Update(endpoint.id, [mask](EndpointInfo &info)
+                                    { info.defaultRoles &= static_cast<uint8_t>(~mask); });
+            }
+            snapshot.Update(id, [mask](EndpointInfo &info)
+                            { info.defaultRoles |= mask; });
+
+            if (scope.flow == eRender && roles.size() == DefaultHistory::kRoles)
+                ServiceRecovery::Instance().RememberDefault(static_cast<uint8_t>(eRender), id);
+            return true;
+        }
+    }
+
+    /**
+     * @brief   Switches back to the endpoint that was default before the current one.
+     *
+     * @details The target comes from an in-memory MRU history per role, maintained from
+     *          default-changed notifications and from switches made through this module,
+     *          and skips endpoints that are no longer active. The switch is a single
+     *          role-scoped SetDefaultEndpoint on a cached policy-config object; nothing
+     *          is enumerated once the snapshot is loaded.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): 'console' (default) | 'multimedia' |
+     *                'communications' | 'all'
+     *              - args[1] (optional): `{ flow?: 'render' | 'capture' }`
+     * @return  Napi::Value ID of the new default, or null if there is no previous endpoint
+     *          or the switch failed
+     *
+     * @example
+     * // JavaScript usage:
+     * switchToPrevious('all'); // headset <-> speakers
+     */
+    Napi::Value SwitchToPrevious(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        SwitchScope scope;
+        if (!ParseScope(info, scope))
+            return env.Null();
+
+        try
+        {
+            auto table = LoadTable();
+            SyncHistory(*table);
+
+            const ERole role = scope.roles.front();
+            const EndpointKey current = CurrentDefault(*table, scope.flow, role);
+            const EndpointKey previous = DefaultHistory::Instance().Previous(
+                static_cast<uint8_t>(scope.flow), static_cast<uint8_t>(role), current,
+                [&](const EndpointKey &key)
+                { return FindEndpoint(*table, key, scope.flow) != nullptr; });
+
+            const EndpointInfo *target = previous.Empty() ? nullptr : FindEndpoint(*table, previous, scope.flow);
+            if (!target || !SwitchTo(*table, *target, scope))
+                return env.Null();
+            return ToJsString(env, target->id);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Makes the next matching endpoint the default, wrapping around.
+     *
+     * @details Candidates are the active endpoints of the flow, in snapshot order or in
+     *          the order of `ids`, optionally narrowed by a case-insensitive name match.
+     *          The endpoint after the current default becomes the default (the first one
+     *          if the current default is not a candidate).
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): role, as for switchToPrevious()
+     *              - args[1] (optional): `{ flow?: 'render' | 'capture', ids?: string[],
+     *                name?: string }`
+     * @return  Napi::Value ID of the new default, or null if no other candidate exists or
+     *          the switch failed
+     *
+     * @example
+     * // JavaScript usage:
+     * cycleDefault('all', { ids: [speakersId, headsetId, hdmiId] });
+     */
+    Napi::Value CycleDefault(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        SwitchScope scope;
+        if (!ParseScope(info, scope))
+            return env.Null();
+
+        std::vector<std::wstring> ids;
+        std::wstring name;
+        if (info.Length() > 1 && info[1].IsObject())
+        {
+            Napi::Object filter = info[1].As<Napi::Object>();
+            Napi::Value idsValue = filter.Get("ids");
+            Napi::Value nameValue = filter.Get("name");
+            if (!(idsValue.IsUndefined() || idsValue.IsArray()) || !(nameValue.IsUndefined() || nameValue.IsString()))
+            {
+                Napi::TypeError::New(env, "Expected filter { flow?: string, ids?: string[], name?: string }").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            if (idsValue.IsArray())
+            {
+                Napi::Array array = idsValue.As<Napi::Array>();
+                for (uint32_t i = 0; i < array.Length(); ++i)
+                {
+                    Napi::Value id = array.Get(i);
+                    if (!id.IsString())
+                    {
+                        Napi::TypeError::New(env, "Expected ids to be strings").ThrowAsJavaScriptException();
+                        return env.Null();
+                    }
+                    ids.push_back(ToWString(id));
+                }
+            }
+            if (nameValue.IsString())
+                name = ToWString(nameValue);
+        }
+
+        try
+        {
+            auto table = LoadTable();
+            SyncHistory(*table);
+
+            auto matches = [&](const EndpointInfo &endpoint)
+            { return name.empty() || ContainsNoCase(endpoint.name, name); };
+
+            std::vector<EndpointKey> candidates;
+            if (!ids.empty())
+            {
+                for (const std::wstring &id : ids)
+                {
+                    const EndpointInfo *endpoint = FindEndpoint(*table, EndpointKey::Lookup(id), scope.flow);
+                    if (endpoint && matches(*endpoint))
+                        candidates.push_back(endpoint->key);
+                }
+            }
+            else
+            {
+                for (const EndpointInfo &endpoint : *table)
+                {
+                    if (endpoint.flow == scope.flow && matches(endpoint))
+                        candidates.push_back(endpoint.key);
+                }
+            }
+
+            const EndpointKey current = CurrentDefault(*table, scope.flow, scope.roles.front());
+            const EndpointKey next = DefaultHistory::CycleAfter(candidates, current);
+            if (next.Empty() || next == current)
+                return env.Null();
+
+            const EndpointInfo *target = FindEndpoint(*table, next, scope.flow);
+            if (!target || !SwitchTo(*table, *target, scope))
+                return env.Null();
+            return ToJsString(env, target->id);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns the remembered defaults of one role, most recent first.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): role (for 'all', the console history)
+     *              - args[1] (optional): `{ flow?: 'render' | 'capture' }`
+     * @return  Napi::Array Endpoint IDs; the first is the current default as last seen
+     */
+    Napi::Value GetDefaultHistory(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        SwitchScope scope;
+        if (!ParseScope(info, scope))
+            return env.Null();
+
+        const std::vector<EndpointKey> entries = DefaultHistory::Instance().Entries(
+            static_cast<uint8_t>(scope.flow), static_cast<uint8_t>(scope.roles.front()));
+        Napi::Array result = Napi::Array::New(env, entries.size());
+        for (size_t i = 0; i < entries.size(); ++i)
+            result.Set(i, ToJsString(env, entries[i].ToWString()));
+        return result;
+    }
+
+    /**
+     * @brief Registers default-switching functions on the module exports.
+     */
+    void InitSwitchBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("switchToPrevious", Napi::Function::New(env, SwitchToPrevious));
+        exports.Set("cycleDefault", Napi::Function::New(env, CycleDefault));
+        exports.Set("getDefaultHistory", Napi::Function::New(env, GetDefaultHistory));
+    }
+}
@@ -0,0 +1,223 @@
+/**
+ * @file TopologyBindings.cpp
+ * @brief N-API bindings for the cached hardware topology of endpoints: connectors,
+ *        subunits, hardware volume/mute/meter support and jack descriptions.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/DeviceTopology.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/OperationSupervisor.h"
+#include "Utility/SafeRelease.h"
+
+#include <cstdio>
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        Napi::Array ControlNames(Napi::Env env, uint8_t controls)
+        {
+            static const std::pair<uint8_t, const char *> kNames[] = {
+                {TopologyControl::Volume, "volume"},
+                {TopologyControl::Mute, "mute"},
+                {TopologyControl::PeakMeter, "peakMeter"},
+                {TopologyControl::Loudness, "loudness"},
+                {TopologyControl::Tone, "tone"},
+                {TopologyControl::Agc, "agc"},
+            };
+            Napi::Array result = Napi::Array::New(env);
+            uint32_t count = 0;
+            for (const auto &entry : kNames)
+            {
+                if (controls & entry.first)
+                    result.Set(count++, Napi::String::New(env, entry.second));
+            }
+            return result;
+        }
+
+        Napi::Object TopologyToObject(Napi::Env env, const EndpointTopology &topology)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("id", ToJsString(env, topology.endpointId));
+            obj.Set("adapterId", ToJsString(env, topology.adapterId));
+
+            Napi::Object hardware = Napi::Object::New(env);
+            hardware.Set("volume", Napi::Boolean::New(env, (topology.hardwareSupport & HardwareSupport::Volume) != 0));
+            hardware.Set("mute", Napi::Boolean::New(env, (topology.hardwareSupport & HardwareSupport::Mute) != 0));
+            hardware.Set("meter", Napi::Boolean::New(env, (topology.hardwareSupport & HardwareSupport::Meter) != 0));
+            obj.Set("hardware", hardware);
+            obj.Set("controls", ControlNames(env, topology.Controls()));
+
+            Napi::Array parts = Napi::Array::New(env, topology.parts.size());
+            for (size_t i = 0; i < topology.parts.size(); ++i)
+            {
+                const TopologyPart &part = topology.parts[i];
+                Napi::Object item = Napi::Object::New(env);
+                item.Set("localId", Napi::Number::New(env, part.localId));
+                item.Set("name", ToJsString(env, part.name));
+                item.Set("type", Napi::String::New(env, part.type == TopologyPartType::Connector ? "connector" : "subunit"));
+                item.Set("subType", Napi::String::New(env, part.subType));
+                if (part.type == TopologyPartType::Connector)
+                    item.Set("connectorType", Napi::String::New(env, part.connectorType.empty() ? "unknown" : part.connectorType));
+                item.Set("controls", ControlNames(env, part.controls));
+                Napi::Array links = Napi::Array::New(env, part.links.size());
+                for (size_t l = 0; l < part.links.size(); ++l)
+                    links.Set(l, Napi::Number::New(env, part.links[l]));
+                item.Set("links", links);
+                parts.Set(i, item);
+            }
+            obj.Set("parts", parts);
+
+            Napi::Array jacks = Napi::Array::New(env, topology.jacks.size());
+            for (size_t i = 0; i < topology.jacks.size(); ++i)
+            {
+                const JackDescription &jack = topology.jacks[i];
+                char color[8];
+                std::snprintf(color, sizeof(color), "#%06x", jack.color);
+                Napi::Object item = Napi::Object::New(env);
+                item.Set("color", Napi::String::New(env, color));
+                item.Set("connectionType", Napi::String::New(env, JackConnectionTypeName(jack.connectionType)));
+                item.Set("geoLocation", Napi::String::New(env, JackGeoLocationName(jack.geoLocation)));
+                item.Set("genLocation", Napi::Number::New(env, jack.genLocation));
+                item.Set("portConnection", Napi::Number::New(env, jack.portConnection));
+                item.Set("connected", Napi::Boolean::New(env, jack.connected));
+                jacks.Set(i, item);
+            }
+            obj.Set("jacks", jacks);
+            return obj;
+        }
+
+        /**
+         * @brief Returns the endpoint's graph from the cache, walking it under the watchdog
+         *        on a miss.
+         */
+        std::shared_ptr<const EndpointTopology> LoadTopology(const EndpointInfo &endpoint, bool refresh)
+        {
+            TopologyCache &cache = TopologyCache::Instance();
+            if (refresh)
+                cache.Invalidate(endpoint.key);
+
+            const std::wstring id = endpoint.id;
+            const EDataFlow flow = endpoint.flow;
+            return cache.Get(endpoint.key, [&id, flow]()
+                             { return OperationSupervisor::Instance().Run(id, [&id, flow]() -> std::shared_ptr<const EndpointTopology>
+                                                                          {
+                COMInitializer com;
+                IMMDevice *device = GetDeviceById(id);
+                if (!device)
+                    return nullptr;
+                auto topology = WalkTopology(device, flow, id);
+                SafeRelease(device);
+                return topology; }); });
+        }
+    }
+
+    /**
+     * @brief   Returns the hardware topology of one endpoint, or of every active endpoint.
+     *
+     * @details The IDeviceTopology graph (endpoint connector → adapter subunits → jack)
+     *          is walked once per endpoint and cached. Endpoint change notifications
+     *          (added, removed, state or property changes) drop the affected graph;
+     *          without notifications running, pass `{ refresh: true }` after hardware
+     *          changes. `hardware` is QueryHardwareSupport: where volume and mute are
+     *          true, muting is done by the device and costs no software processing.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): endpoint ID (omit for all active endpoints)
+     *              - args[1] (optional): `{ refresh?: boolean }`
+     * @return  Napi::Value `{ id, adapterId, hardware: { volume, mute, meter }, controls,
+     *              parts: [{ localId, name, type, subType, connectorType?, controls, links }],
+     *              jacks: [{ color, connectionType, geoLocation, genLocation, portConnection,
+     *              connected }] }`, an array of them, or null if the ID is not active
+     *
+     * @example
+     * // JavaScript usage:
+     * getDeviceTopology().filter((t) => t.hardware.mute).map((t) => t.id);
+     */
+    Napi::Value GetDeviceTopology(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const bool single = info.Length() > 0 && info[0].IsString();
+        if (info.Length() > 0 && !single && !info[0].IsUndefined() && !info[0].IsNull())
+        {
+            Napi::TypeError::New(env, "Expected an endpoint ID string").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        bool refresh = false;
+        if (info.Length() > 1 && info[1].IsObject())
+        {
+            Napi::Value value = info[1].As<Napi::Object>().Get("refresh");
+            refresh = value.IsBoolean() && value.As<Napi::Boolean>().Value();
+        }
+
+        try
+        {
+            auto table = OperationSupervisor::Instance().Run(L"snapshot", []()
+                                                             {
+                COMInitializer com;
+                return DeviceSnapshot::Instance().Get(); });
+
+            if (single)
+            {
+                const EndpointKey key = EndpointKey::Lookup(ToWString(info[0]));
+                for (const EndpointInfo &endpoint : *table)
+                {
+                    if (endpoint.key == key)
+                    {
+                        auto topology = LoadTopology(endpoint, refresh);
+                        return topology ? Napi::Value(TopologyToObject(env, *topology)) : env.Null();
+                    }
+                }
+                return env.Null();
+            }
+
+            Napi::Array result = Napi::Array::New(env);
+            uint32_t count = 0;
+            for (const EndpointInfo &endpoint : *table)
+            {
+                if (auto topology = LoadTopology(endpoint, refresh))
+                    result.Set(count++, TopologyToObject(env, *topology));
+            }
+            return result;
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, nullptr);
+        }
+    }
+
+    /**
+     * @brief   Returns topology cache counters.
+     *
+     * @param   info Napi::CallbackInfo (unused parameters)
+     * @return  Napi::Object `{ size, hits, builds, invalidations }`
+     */
+    Napi::Value GetTopologyCacheStats(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        const TopologyCacheStats stats = TopologyCache::Instance().Stats();
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("size", Napi::Number::New(env, static_cast<double>(stats.size)));
+        obj.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+        obj.Set("builds", Napi::Number::New(env, static_cast<double>(stats.builds)));
+        obj.Set("invalidations", Napi::Number::New(env, static_cast<double>(stats.invalidations)));
+        return obj;
+    }
+
+    /**
+     * @brief Registers device topology functions on the module exports.
+     */
+    void InitTopologyBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("getDeviceTopology", Napi::Function::New(env, GetDeviceTopology));
+        exports.Set("getTopologyCacheStats", Napi::Function::New(env, GetTopologyCacheStats));
+    }
+}
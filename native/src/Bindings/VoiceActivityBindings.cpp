@@ -0,0 +1,275 @@
+/**
+ * @file VoiceActivityBindings.cpp
+ * @brief N-API bindings for voice activity detection across several capture endpoints,
+ *        to tell which microphone the user is speaking into.
+ */
+
+#include "Bindings/BindingUtils.h"
+#include "Streaming/VoiceActivityMonitor.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/OperationSupervisor.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+using namespace Streaming;
+using namespace Utility;
+
+namespace Bindings
+{
+    namespace
+    {
+        /**
+         * @brief Running monitors by id. Like recordings, they outlive the calls that
+         *        created them and are stopped explicitly or at environment shutdown.
+         */
+        struct MonitorRegistry
+        {
+            std::mutex mutex;
+            std::map<uint32_t, std::shared_ptr<VoiceActivityMonitor>> monitors;
+            uint32_t nextId = 1;
+        };
+
+        MonitorRegistry &Registry()
+        {
+            static MonitorRegistry *registry = new MonitorRegistry();
+            return *registry;
+        }
+
+        /**
+         * @brief Stops every monitor; runs when the Node environment is torn down.
+         */
+        void StopAllMonitors()
+        {
+            std::map<uint32_t, std::shared_ptr<VoiceActivityMonitor>> monitors;
+            {
+                MonitorRegistry &registry = Registry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                monitors.swap(registry.monitors);
+            }
+            for (auto &entry : monitors)
+                entry.second->Stop();
+        }
+
+        Napi::Object StatsToObject(Napi::Env env, const VoiceActivityMonitorStats &stats)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("running", Napi::Boolean::New(env, stats.running));
+            obj.Set("error", stats.error.empty() ? env.Null() : Napi::String::New(env, stats.error));
+            obj.Set("activeDeviceId", stats.mostActive >= 0 ? ToJsString(env, stats.endpoints[stats.mostActive].id) : env.Null());
+            obj.Set("loadPercent", Napi::Number::New(env, stats.loadPercent));
+
+            Napi::Array endpoints = Napi::Array::New(env, stats.endpoints.size());
+            for (size_t i = 0; i < stats.endpoints.size(); ++i)
+            {
+                const VoiceActivityEndpointStats &endpoint = stats.endpoints[i];
+                Napi::Object item = Napi::Object::New(env);
+                item.Set("id", ToJsString(env, endpoint.id));
+                item.Set("running", Napi::Boolean::New(env, endpoint.running));
+                item.Set("error", endpoint.error.empty() ? env.Null() : Napi::String::New(env, endpoint.error));
+                item.Set("sampleRate", Napi::Number::New(env, endpoint.sampleRate));
+                item.Set("channels", Napi::Number::New(env, endpoint.channels));
+                item.Set("probability", Napi::Number::New(env, endpoint.state.probability));
+                item.Set("speaking", Napi::Boolean::New(env, endpoint.state.speaking));
+                item.Set("levelDb", Napi::Number::New(env, endpoint.state.levelDb));
+                item.Set("noiseDb", Napi::Number::New(env, endpoint.state.noiseDb));
+                item.Set("flatness", Napi::Number::New(env, endpoint.state.flatness));
+                item.Set("zeroCrossings", Napi::Number::New(env, endpoint.state.zeroCrossings));
+                item.Set("speechMs", Napi::Number::New(env, endpoint.state.speechSeconds * 1000.0));
+                item.Set("updates", Napi::Number::New(env, static_cast<double>(endpoint.state.updates)));
+                endpoints.Set(static_cast<uint32_t>(i), item);
+            }
+            obj.Set("endpoints", endpoints);
+            return obj;
+        }
+
+        std::shared_ptr<VoiceActivityMonitor> FindMonitor(uint32_t id)
+        {
+            MonitorRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.monitors.find(id);
+            return it == registry.monitors.end() ? nullptr : it->second;
+        }
+    }
+
+    /**
+     * @brief   Starts voice activity detection on several capture endpoints at once.
+     *
+     * @details Every endpoint is captured in shared mode and analysed on one background
+     *          thread: each 16 ms frame (at about 16 kHz) is scored on its speech-band
+     *          level over a tracked noise floor, its spectral flatness and its
+     *          zero-crossing rate, and the resulting probability is held through a
+     *          hangover so pauses between words still count as speech. The thread
+     *          publishes every endpoint's state to a shared lock-free buffer, which
+     *          getVoiceActivity() reads. An endpoint that cannot be opened or is removed
+     *          reports an error; the others keep running.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0] (optional): `{ deviceIds?: string[] (default: every active
+     *                capture endpoint), snrDb?: number, hangoverMs?: number }`
+     * @return  Napi::Number Monitor id for getVoiceActivity / stopVoiceActivity
+     * @throws  Napi::Error When no endpoint can be opened
+     *
+     * @example
+     * // JavaScript usage:
+     * const id = startVoiceActivity();
+     * const { activeDeviceId } = getVoiceActivity(id);
+     */
+    Napi::Value StartVoiceActivity(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+        const char *usage = "Expected (options?: { deviceIds?: string[], snrDb?: number, hangoverMs?: number })";
+
+        if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsObject())
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object obj = info.Length() > 0 && info[0].IsObject() ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+        Napi::Value deviceIds = obj.Get("deviceIds");
+        Napi::Value snrDb = obj.Get("snrDb");
+        Napi::Value hangoverMs = obj.Get("hangoverMs");
+        if (!(deviceIds.IsUndefined() || deviceIds.IsArray()) || !(snrDb.IsUndefined() || snrDb.IsNumber()) ||
+            !(hangoverMs.IsUndefined() || hangoverMs.IsNumber()))
+        {
+            Napi::TypeError::New(env, usage).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        VoiceActivityMonitorOptions options;
+        if (deviceIds.IsArray())
+        {
+            Napi::Array array = deviceIds.As<Napi::Array>();
+            for (uint32_t i = 0; i < array.Length(); ++i)
+            {
+                Napi::Value value = array.Get(i);
+                if (!value.IsString())
+                {
+                    Napi::TypeError::New(env, "Expected endpoint ID strings").ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+                options.deviceIds.push_back(ToWString(value));
+            }
+        }
+        if (snrDb.IsNumber())
+        {
+            const double value = snrDb.As<Napi::Number>().DoubleValue();
+            if (!(value >= 0.0 && value <= 40.0))
+            {
+                Napi::RangeError::New(env, "snrDb must be between 0 and 40").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.detector.snrDb = value;
+        }
+        if (hangoverMs.IsNumber())
+        {
+            const double value = hangoverMs.As<Napi::Number>().DoubleValue();
+            if (!(value >= 0.0 && value <= 5000.0))
+            {
+                Napi::RangeError::New(env, "hangoverMs must be between 0 and 5000").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            options.detector.hangoverMs = value;
+        }
+
+        try
+        {
+            std::shared_ptr<VoiceActivityMonitor> monitor = OperationSupervisor::Instance().Run(L"voice-activity", [options]()
+                                                                                                {
+                COMInitializer com;
+                auto monitor = std::make_shared<VoiceActivityMonitor>(options);
+                monitor->Start();
+                return monitor; });
+
+            MonitorRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            const uint32_t id = registry.nextId++;
+            registry.monitors.emplace(id, std::move(monitor));
+            return Napi::Number::New(env, id);
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to start voice activity detection");
+        }
+    }
+
+    /**
+     * @brief   Stops voice activity detection and releases every endpoint.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Monitor id returned by startVoiceActivity
+     * @return  Napi::Value The final state (as getVoiceActivity), or null for an unknown id
+     */
+    Napi::Value StopVoiceActivity(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Voice activity id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<VoiceActivityMonitor> monitor;
+        {
+            MonitorRegistry &registry = Registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.monitors.find(info[0].As<Napi::Number>().Uint32Value());
+            if (it == registry.monitors.end())
+                return env.Null();
+            monitor = std::move(it->second);
+            registry.monitors.erase(it);
+        }
+
+        try
+        {
+            OperationSupervisor::Instance().Run(L"voice-activity", [monitor]()
+                                                { monitor->Stop(); });
+            return StatsToObject(env, monitor->Stats());
+        }
+        catch (...)
+        {
+            return ThrowNativeError(env, "Failed to stop voice activity detection");
+        }
+    }
+
+    /**
+     * @brief   Returns the current speech probability of every monitored endpoint. Reads
+     *          the shared buffer the analysis thread writes; never waits for it.
+     *
+     * @param   info Napi::CallbackInfo containing:
+     *              - args[0]: Monitor id returned by startVoiceActivity
+     * @return  Napi::Value `{ running, error, activeDeviceId, loadPercent, endpoints: [{ id,
+     *              running, error, sampleRate, channels, probability, speaking, levelDb,
+     *              noiseDb, flatness, zeroCrossings, speechMs, updates }] }`, or null for
+     *              an unknown id
+     */
+    Napi::Value GetVoiceActivity(const Napi::CallbackInfo &info)
+    {
+        Napi::Env env = info.Env();
+
+        if (info.Length() != 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Voice activity id expected").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::shared_ptr<VoiceActivityMonitor> monitor = FindMonitor(info[0].As<Napi::Number>().Uint32Value());
+        if (!monitor)
+            return env.Null();
+        return StatsToObject(env, monitor->Stats());
+    }
+
+    /**
+     * @brief Registers voice activity functions on the module exports.
+     */
+    void InitVoiceActivityBindings(Napi::Env env, Napi::Object exports)
+    {
+        exports.Set("startVoiceActivity", Napi::Function::New(env, StartVoiceActivity));
+        exports.Set("stopVoiceActivity", Napi::Function::New(env, StopVoiceActivity));
+        exports.Set("getVoiceActivity", Napi::Function::New(env, GetVoiceActivity));
+        env.AddCleanupHook(StopAllMonitors);
+    }
+}
@@ -0,0 +1,475 @@
+/**
+ * @file AudioSwitchCli.cpp
+ * @brief Standalone command-line front end for the AudioSwitcher and Utility libraries.
+ *
+ * Built as its own executable (`audioswitch.exe`) from the same sources as the addon, so
+ * login scripts can switch devices without paying for Node startup and module load.
+ *
+ * Usage:
+ *   audioswitch [--json|--tab] list
+ *   audioswitch [--json|--tab] set-default <target>
+ *   audioswitch [--json|--tab] mute <target> | unmute <target>
+ *   audioswitch [--json|--tab] volume <target> [0-100]
+ *   audioswitch [--json|--tab] format <target>
+ *   audioswitch [--json|--tab] batch <file|->
+ *
+ * `<target>` is a device ID (`{0.0.0.00000000}.{guid}`), `default`, or a case-insensitive
+ * substring of the friendly name. Batch mode runs one command per line (blank lines and
+ * `#` comments are skipped) inside a single COM context; in JSON mode every command
+ * prints exactly one JSON object per line.
+ */
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cwctype>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mmdeviceapi.h>
+#include "AudioSwitcher/AudioSwitcher.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/SafeRelease.h"
+#include "Utility/StringUtils.h"
+
+using namespace AudioSwitcher;
+using namespace Utility;
+
+namespace
+{
+    enum class OutputFormat
+    {
+        Tab,
+        Json
+    };
+
+    OutputFormat g_format = OutputFormat::Tab;
+
+    /**
+     * @brief Escapes a UTF-8 string for inclusion in a JSON string literal.
+     */
+    std::string JsonEscape(const std::string &text)
+    {
+        std::string out;
+        out.reserve(text.size() + 2);
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        return out;
+    }
+
+    /// Quotes and escapes a wide string as a JSON string value.
+    std::string JsonString(const std::wstring &text)
+    {
+        return "\"" + JsonEscape(WStringToUtf8(text)) + "\"";
+    }
+
+    void PrintLine(const std::string &line)
+    {
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        std::fputc('\n', stdout);
+    }
+
+    /**
+     * @brief Reports a failed command and returns the process exit code for it.
+     *
+     * JSON mode keeps stdout machine-readable by emitting `{ ok: false }`; tab mode
+     * writes the message to stderr.
+     */
+    int Fail(const char *command, const std::string &message)
+    {
+        if (g_format == OutputFormat::Json)
+            PrintLine(std::string("{\"command\":\"") + command + "\",\"ok\":false,\"error\":\"" + JsonEscape(message) + "\"}");
+        else
+            std::fprintf(stderr, "[x] %s: %s\n", command, message.c_str());
+        return 1;
+    }
+
+    std::wstring ToLower(std::wstring text)
+    {
+        for (wchar_t &c : text)
+            c = static_cast<wchar_t>(std::towlower(c));
+        return text;
+    }
+
+    /**
+     * @brief Reads the ID of the current default render device.
+     * @return std::wstring The ID, or empty on failure.
+     */
+    std::wstring GetDefaultDeviceId()
+    {
+        std::wstring id;
+        IMMDevice *device = GetDefaultAudioPlaybackDevice();
+        if (!device)
+            return id;
+
+        LPWSTR buffer = nullptr;
+        if (SUCCEEDED(device->GetId(&buffer)) && buffer)
+        {
+            id = buffer;
+            CoTaskMemFree(buffer);
+        }
+        SafeRelease(device);
+        return id;
+    }
+
+    /**
+     * @brief Turns a user supplied target into a device ID.
+     *
+     * IDs are used as-is (no enumeration, which keeps the common scripted path fast),
+     * `default` resolves to the current default render device, anything else is matched
+     * against friendly names.
+     *
+     * @param target Device ID, `default`, or name substring.
+     * @return std::wstring The device ID, or empty if nothing matched.
+     */
+    std::wstring ResolveDeviceId(const std::wstring &target)
+    {
+        if (!target.empty() && target[0] == L'{')
+            return target;
+        if (target == L"default")
+            return GetDefaultDeviceId();
+
+        std::wstring needle = ToLower(target);
+        for (const AudioDevice &device : AudioManager::listOutputDevices())
+        {
+            if (ToLower(device.name).find(needle) != std::wstring::npos)
+                return device.id;
+        }
+        return {};
+    }
+
+    int CmdList()
+    {
+        const EndpointKey defaultKey = EndpointKey::Intern(GetDefaultDeviceId());
+        auto devices = AudioManager::listOutputDevices();
+
+        if (g_format == OutputFormat::Json)
+        {
+            std::string line = "[";
+            for (size_t i = 0; i < devices.size(); ++i)
+            {
+                if (i)
+                    line += ",";
+                line += "{\"name\":" + JsonString(devices[i].name) +
+                        ",\"id\":" + JsonString(devices[i].id) +
+                        ",\"isDefault\":" + (devices[i].key == defaultKey ? "true" : "false") + "}";
+            }
+            PrintLine(line + "]");
+            return 0;
+        }
+
+        for (const AudioDevice &device : devices)
+        {
+            PrintLine(WStringToUtf8(device.id) + "\t" + WStringToUtf8(device.name) +
+                      (device.key == defaultKey ? "\tdefault" : "\t-"));
+        }
+        return 0;
+    }
+
+    int CmdSetDefault(const std::vector<std::wstring> &args)
+    {
+        if (args.size() != 2)
+            return Fail("set-default", "usage: set-default <target>");
+
+        std::wstring id = ResolveDeviceId(args[1]);
+        if (id.empty())
+            return Fail("set-default", "device not found");
+        if (!AudioManager::setDefaultOutputDevice(id))
+            return Fail("set-default", "SetDefaultEndpoint failed");
+
+        if (g_format == OutputFormat::Json)
+            PrintLine("{\"command\":\"set-default\",\"ok\":true,\"id\":" + JsonString(id) + "}");
+        else
+            PrintLine("ok\t" + WStringToUtf8(id));
+        return 0;
+    }
+
+    int CmdMute(const std::vector<std::wstring> &args, bool mute)
+    {
+        const char *command = mute ? "mute" : "unmute";
+        if (args.size() != 2)
+            return Fail(command, mute ? "usage: mute <target>" : "usage: unmute <target>");
+
+        std::wstring id = ResolveDeviceId(args[1]);
+        IMMDevice *device = id.empty() ? nullptr : GetDeviceById(id);
+        if (!device)
+            return Fail(command, "device not found");
+
+        bool ok = MuteDevice(device, mute);
+        SafeRelease(device);
+        if (!ok)
+            return Fail(command, "SetMute failed");
+
+        if (g_format == OutputFormat::Json)
+            PrintLine(std::string("{\"command\":\"") + command + "\",\"ok\":true,\"id\":" + JsonString(id) + "}");
+        else
+            PrintLine("ok\t" + WStringToUtf8(id));
+        return 0;
+    }
+
+    int CmdVolume(const std::vector<std::wstring> &args)
+    {
+        if (args.size() != 2 && args.size() != 3)
+            return Fail("volume", "usage: volume <target> [0-100]");
+
+        std::wstring id = ResolveDeviceId(args[1]);
+        IMMDevice *device = id.empty() ? nullptr : GetDeviceById(id);
+        if (!device)
+            return Fail("volume", "device not found");
+
+        bool ok = true;
+        if (args.size() == 3)
+        {
+            wchar_t *end = nullptr;
+            double percent = std::wcstod(args[2].c_str(), &end);
+            if (end == args[2].c_str() || *end != L'\0' || percent < 0 || percent > 100)
+            {
+                SafeRelease(device);
+                return Fail("volume", "volume must be a number between 0 and 100");
+            }
+            ok = SetDeviceVolume(device, static_cast<float>(percent / 100.0));
+        }
+
+        float level = 0.0f;
+        bool muted = false;
+        ok = ok && GetDeviceVolume(device, level);
+        GetDeviceMute(device, muted);
+        SafeRelease(device);
+        if (!ok)
+            return Fail("volume", "endpoint volume unavailable");
+
+        int percent = static_cast<int>(level * 100.0f + 0.5f);
+        if (g_format == OutputFormat::Json)
+            PrintLine("{\"command\":\"volume\",\"ok\":true,\"id\":" + JsonString(id) +
+                      ",\"volume\":" + std::to_string(percent) + ",\"muted\":" + (muted ? "true" : "false") + "}");
+        else
+            PrintLine(WStringToUtf8(id) + "\t" + std::to_string(percent) + (muted ? "\tmuted" : "\t-"));
+        return 0;
+    }
+
+    int CmdFormat(const std::vector<std::wstring> &args)
+    {
+        if (args.size() != 2)
+            return Fail("format", "usage: format <target>");
+
+        std::wstring id = ResolveDeviceId(args[1]);
+        IMMDevice *device = id.empty() ? nullptr : GetDeviceById(id);
+        if (!device)
+            return Fail("format", "device not found");
+
+        DeviceFormatInfo info = GetDeviceFormatInfo(device);
+        SafeRelease(device);
+        if (!info.valid)
+            return Fail("format", "mix format unavailable");
+
+        if (g_format == OutputFormat::Json)
+            PrintLine("{\"command\":\"format\",\"ok\":true,\"id\":" + JsonString(id) +
+                      ",\"sampleRate\":" + std::to_string(info.sampleRate) +
+                      ",\"channels\":" + std::to_string(info.channels) +
+                      ",\"bitDepth\":" + std::to_string(info.bitDepth) +
+                      ",\"blockAlign\":" + std::to_string(info.blockAlign) + "}");
+        else
+            PrintLine(WStringToUtf8(id) + "\t" + std::to_string(info.sampleRate) + "\t" +
+                      std::to_string(info.channels) + "\t" + std::to_string(info.bitDepth) + "\t" +
+                      std::to_string(info.blockAlign));
+        return 0;
+    }
+
+    int RunBatch(const std::vector<std::wstring> &args);
+
+    /**
+     * @brief Dispatches one command. COM must already be initialized on this thread.
+     * @return 0 on success, non-zero on failure.
+     */
+    int RunCommand(const std::vector<std::wstring> &args)
+    {
+        if (args.empty())
+            return Fail("audioswitch", "missing command");
+
+        const std::wstring &command = args[0];
+        try
+        {
+            if (command == L"list")
+                return CmdList();
+            if (command == L"set-default")
+                return CmdSetDefault(args);
+            if (command == L"mute")
+                return CmdMute(args, true);
+            if (command == L"unmute")
+                return CmdMute(args, false);
+            if (command == L"volume")
+                return CmdVolume(args);
+            if (command == L"format")
+                return CmdFormat(args);
+            if (command == L"batch")
+                return RunBatch(args);
+        }
+        catch (const std::exception &ex)
+        {
+            return Fail(WStringToUtf8(command).c_str(), ex.what());
+        }
+
+        return Fail(WStringToUtf8(command).c_str(), "unknown command");
+    }
+
+    /**
+     * @brief Splits a batch line into arguments. Double quotes group words.
+     */
+    std::vector<std::wstring> Tokenize(const std::wstring &line)
+    {
+        std::vector<std::wstring> tokens;
+        std::wstring current;
+        bool quoted = false;
+        bool hasToken = false;
+
+        for (wchar_t c : line)
+        {
+            if (c == L'"')
+            {
+                quoted = !quoted;
+                hasToken = true;
+            }
+            else if (!quoted && std::iswspace(c))
+            {
+                if (hasToken)
+                    tokens.push_back(current);
+                current.clear();
+                hasToken = false;
+            }
+            else
+            {
+                current += c;
+                hasToken = true;
+            }
+        }
+        if (hasToken)
+            tokens.push_back(current);
+        return tokens;
+    }
+
+    /**
+     * @brief Runs every line of a script file (or stdin for `-`) in this process.
+     *
+     * Failures do not stop the batch; the exit code is non-zero if any command failed.
+     */
+    int RunBatch(const std::vector<std::wstring> &args)
+    {
+        if (args.size() != 2)
+            return Fail("batch", "usage: batch <file|->");
+
+        std::ifstream file;
+        if (args[1] != L"-")
+        {
+            file.open(args[1].c_str(), std::ios::binary);
+            if (!file)
+                return Fail("batch", "cannot open script");
+        }
+        std::istream &input = file.is_open() ? static_cast<std::istream &>(file) : std::cin;
+
+        int failures = 0;
+        std::string line;
+        while (std::getline(input, line))
+        {
+            std::vector<std::wstring> tokens = Tokenize(Utf8ToWString(line));
+            if (tokens.empty() || tokens[0][0] == L'#')
+                continue;
+            if (tokens[0] == L"batch")
+            {
+                failures += Fail("batch", "nested batch is not allowed");
+                continue;
+            }
+            failures += RunCommand(tokens) != 0 ? 1 : 0;
+        }
+        return failures ? 1 : 0;
+    }
+
+    void PrintUsage()
+    {
+        std::fputs(
+            "Usage: audioswitch [--json|--tab] <command> [args]\n"
+            "\n"
+            "Commands:\n"
+            "  list                        List active playback devices\n"
+            "  set-default <target>        Make a device the default for all roles\n"
+            "  mute <target>               Mute a device\n"
+            "  unmute <target>             Unmute a device\n"
+            "  volume <target> [0-100]     Show or set master volume\n"
+            "  format <target>             Show the shared-mode mix format\n"
+            "  batch <file|->              Run one command per line in one process\n"
+            "\n"
+            "<target> is a device ID, 'default', or part of the device name.\n",
+            stdout);
+    }
+}
+
+int wmain(int argc, wchar_t *argv[])
+{
+    std::vector<std::wstring> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::wstring arg = argv[i];
+        if (arg == L"--json")
+            g_format = OutputFormat::Json;
+        else if (arg == L"--tab")
+            g_format = OutputFormat::Tab;
+        else if (arg == L"--help" || arg == L"-h")
+        {
+            PrintUsage();
+            return 0;
+        }
+        else
+            args.push_back(std::move(arg));
+    }
+
+    if (args.empty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    try
+    {
+        // One COM context for the whole process, including every command of a batch
+        COMInitializer com;
+        int code = RunCommand(args);
+        std::fflush(stdout);
+        return code;
+    }
+    catch (const std::exception &ex)
+    {
+        std::fprintf(stderr, "[x] %s\n", ex.what());
+        return 1;
+    }
+}
@@ -0,0 +1,159 @@
+#include "Dsp/DelayEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        /**
+         * @brief Exponents of a primitive feedback polynomial per order (x^order plus
+         *        these, plus 1), terminated by 0.
+         */
+        const unsigned kMlsTaps[][4] = {
+            {0},           {0},           {1, 0},        {2, 0},        {3, 0},        {3, 0},
+            {5, 0},        {6, 0},        {6, 5, 4},     {5, 0},        {7, 0},        {9, 0},
+            {11, 10, 4},   {12, 11, 8},   {13, 12, 2},   {14, 0},       {15, 13, 4},   {14, 0},
+            {11, 0},       {18, 17, 14},  {17, 0},
+        };
+
+        constexpr unsigned kMaxMlsOrder = 20;
+    }
+
+    std::vector<float> MaximumLengthSequence(unsigned order, float amplitude)
+    {
+        if (order < 2 || order > kMaxMlsOrder)
+            throw std::invalid_argument("[x] MLS order must be between 2 and 20");
+
+        // Fibonacci LFSR: the new bit is the XOR of the tapped bits; any non-zero seed
+        // walks through all 2^order - 1 states
+        const size_t length = (size_t(1) << order) - 1;
+        std::vector<float> sequence(length);
+        uint32_t state = 1;
+        for (size_t i = 0; i < length; ++i)
+        {
+            sequence[i] = (state & 1) ? amplitude : -amplitude;
+            uint32_t bit = state;
+            for (const unsigned *tap = kMlsTaps[order]; *tap; ++tap)
+                bit ^= state >> (order - *tap);
+            state = (state >> 1) | ((bit & 1) << (order - 1));
+        }
+        return sequence;
+    }
+
+    DelayEstimator::DelayEstimator(const float *reference, size_t length, size_t maxLag, float minProminence,
+                                   const SimdKernels *kernels)
+        : m_length(length),
+          m_maxLag(maxLag),
+          m_minProminence(minProminence),
+          m_kernels(kernels ? kernels : &ActiveKernels()),
+          // Lags 0..maxLag of a circular correlation cannot wrap once the transform holds
+          // the whole capture; 16 keeps every kernel call a multiple of 8
+          m_fft(std::max<size_t>(16, Fft::SizeFor(length + maxLag)), m_kernels)
+    {
+        if (length == 0)
+            throw std::invalid_argument("[x] Empty reference signal");
+
+        const size_t size = m_fft.Size();
+        m_referenceRe.assign(size, 0.0f);
+        m_referenceIm.assign(size, 0.0f);
+        m_re.resize(size);
+        m_im.resize(size);
+        for (size_t i = 0; i < length; ++i)
+        {
+            m_referenceRe[i] = reference[i];
+            m_referenceEnergy += double(reference[i]) * reference[i];
+        }
+        m_fft.Forward(m_referenceRe.data(), m_referenceIm.data());
+    }
+
+    DelayEstimate DelayEstimator::Estimate(const float *captured, size_t frames)
+    {
+        const size_t size = m_fft.Size();
+        frames = std::min(frames, CaptureFrames());
+        std::copy(captured, captured + frames, m_re.begin());
+        std::fill(m_re.begin() + frames, m_re.end(), 0.0f);
+        std::fill(m_im.begin(), m_im.end(), 0.0f);
+
+        // r[k] = sum(captured[n + k] * reference[n])
+        m_fft.Forward(m_re.data(), m_im.data());
+        m_kernels->multiplyConjugate(m_re.data(), m_im.data(), m_re.data(), m_im.data(), m_referenceRe.data(),
+                                     m_referenceIm.data(), size);
+        m_fft.Inverse(m_re.data(), m_im.data());
+
+        // The search is padded to a multiple of 8 with zeros, which never win
+        const size_t lags = m_maxLag + 1;
+        const size_t searched = std::min(size, (lags + 7) & ~size_t(7));
+        std::fill(m_re.begin() + lags, m_re.begin() + searched, 0.0f);
+        const size_t peak = m_kernels->peak(m_re.data(), searched);
+
+        DelayEstimate estimate;
+        double power = 0.0;
+        for (size_t k = 0; k < lags; ++k)
+            power += double(m_re[k]) * m_re[k];
+        const double rms = std::sqrt(power / static_cast<double>(lags));
+        const float value = m_re[peak];
+        if (rms <= 0.0 || value == 0.0f)
+            return estimate;
+
+        // Parabola through the peak and its neighbours (sign-corrected for inverted captures)
+        double offset = 0.0;
+        if (peak > 0 && peak < m_maxLag)
+        {
+            const double sign = value < 0.0f ? -1.0 : 1.0;
+            const double left = sign * m_re[peak - 1];
+            const double centre = sign * value;
+            const double right = sign * m_re[peak + 1];
+            const double curvature = left - 2.0 * centre + right;
+            if (curvature < 0.0)
+                offset = std::clamp(0.5 * (left - right) / curvature, -0.5, 0.5);
+        }
+
+        double segment = 0.0;
+        for (size_t i = peak; i < std::min(frames, peak + m_length); ++i)
+            segment += double(captured[i]) * captured[i];
+
+        estimate.lagFrames = static_cast<double>(peak) + offset;
+        estimate.prominence = static_cast<float>(std::fabs(value) / rms);
+        if (segment > 0.0)
+            estimate.correlation = static_cast<float>(std::min(1.0, std::fabs(value) / std::sqrt(m_referenceEnergy * segment)));
+        estimate.found = estimate.prominence >= m_minProminence;
+        return estimate;
+    }
+
+    DelayStatistics SummarizeDelays(std::vector<double> values)
+    {
+        DelayStatistics stats;
+        if (values.empty())
+            return stats;
+
+        std::sort(values.begin(), values.end());
+        const auto percentile = [&](double p)
+        {
+            const double position = p * static_cast<double>(values.size() - 1);
+            const size_t index = static_cast<size_t>(position);
+            const double fraction = position - static_cast<double>(index);
+            if (index + 1 >= values.size())
+                return values.back();
+            return values[index] + fraction * (values[index + 1] - values[index]);
+        };
+
+        double sum = 0.0;
+        for (double value : values)
+            sum += value;
+        stats.count = values.size();
+        stats.min = values.front();
+        stats.max = values.back();
+        stats.mean = sum / static_cast<double>(values.size());
+        stats.median = percentile(0.5);
+        stats.p95 = percentile(0.95);
+
+        double variance = 0.0;
+        for (double value : values)
+            variance += (value - stats.mean) * (value - stats.mean);
+        stats.stdDev = std::sqrt(variance / static_cast<double>(values.size()));
+        return stats;
+    }
+}
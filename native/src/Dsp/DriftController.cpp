@@ -0,0 +1,60 @@
+#include "Dsp/DriftController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Dsp
+{
+    namespace
+    {
+        // The loop is e'' + Kp e' + Ki e = 0 with e the latency error in seconds, so
+        // Ki = w^2 and Kp = 2 * zeta * w. w = 0.3 rad/s with critical damping settles a
+        // +/-200 ppm offset in ~20 s while keeping corrections far below audible pitch
+        // shifts; the smoothing removes the sawtooth caused by mismatched block sizes.
+        constexpr double kSmoothingSeconds = 0.5; ///< Time constant of the fill EMA.
+        constexpr double kProportional = 0.6;     ///< Correction per second of latency error.
+        constexpr double kIntegral = 0.09;        ///< Correction per second^2 of latency error.
+    }
+
+    DriftController::DriftController(double nominalRatio, double producerRate, double targetFill,
+                                     double maxCorrectionPpm)
+        : m_nominalRatio(nominalRatio),
+          m_producerRate(producerRate > 0.0 ? producerRate : 48000.0),
+          m_targetFill(targetFill),
+          m_maxCorrection(maxCorrectionPpm * 1e-6),
+          m_smoothedFill(targetFill)
+    {
+    }
+
+    /**
+     * @brief Updates the controller with a new fill measurement and returns the ratio.
+     */
+    double DriftController::Update(double fillFrames, double elapsedSeconds)
+    {
+        const double alpha = 1.0 - std::exp(-elapsedSeconds / kSmoothingSeconds);
+        m_smoothedFill += alpha * (fillFrames - m_smoothedFill);
+        const double error = (m_smoothedFill - m_targetFill) / m_producerRate;
+
+        // Anti-windup: the integrator alone may never exceed the clamp
+        m_integral = std::clamp(m_integral + kIntegral * error * elapsedSeconds, -m_maxCorrection, m_maxCorrection);
+        m_correction = std::clamp(kProportional * error + m_integral, -m_maxCorrection, m_maxCorrection);
+
+        return m_nominalRatio * (1.0 + m_correction);
+    }
+
+    /**
+     * @brief Clears controller state; the integrator keeps no memory of past drift.
+     */
+    void DriftController::Reset()
+    {
+        m_smoothedFill = m_targetFill;
+        m_integral = 0.0;
+        m_correction = 0.0;
+    }
+
+    void DriftController::ResetFill()
+    {
+        m_smoothedFill = m_targetFill;
+        m_correction = m_integral;
+    }
+}
@@ -0,0 +1,103 @@
+#include "Dsp/Fft.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+
+        /// Kernels need multiples of 8; shorter groups (the first three stages) stay scalar.
+        constexpr size_t kKernelMinimum = 8;
+
+        void ButterflyShort(float *re0, float *im0, float *re1, float *im1, const float *wRe, const float *wIm,
+                            size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float vr = re1[i] * wRe[i] - im1[i] * wIm[i];
+                const float vi = re1[i] * wIm[i] + im1[i] * wRe[i];
+                re1[i] = re0[i] - vr;
+                im1[i] = im0[i] - vi;
+                re0[i] += vr;
+                im0[i] += vi;
+            }
+        }
+    }
+
+    Fft::Fft(size_t size, const SimdKernels *kernels)
+        : m_size(size),
+          m_kernels(kernels ? kernels : &ActiveKernels())
+    {
+        if (size < 2 || (size & (size - 1)) != 0 || size > (size_t(1) << 31))
+            throw std::invalid_argument("[x] FFT size must be a power of two");
+
+        for (size_t i = 1, j = 0; i < size; ++i)
+        {
+            size_t bit = size >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                m_swaps.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+        }
+
+        // Computed in double so the large stages do not accumulate rounding error
+        m_twiddleRe.resize(size - 1);
+        m_twiddleIm.resize(size - 1);
+        for (size_t half = 1; half < size; half <<= 1)
+        {
+            for (size_t k = 0; k < half; ++k)
+            {
+                const double angle = -kPi * static_cast<double>(k) / static_cast<double>(half);
+                m_twiddleRe[half - 1 + k] = static_cast<float>(std::cos(angle));
+                m_twiddleIm[half - 1 + k] = static_cast<float>(std::sin(angle));
+            }
+        }
+    }
+
+    size_t Fft::SizeFor(size_t count)
+    {
+        size_t size = 2;
+        while (size < count)
+            size <<= 1;
+        return size;
+    }
+
+    void Fft::Transform(float *re, float *im) const
+    {
+        for (const auto &swap : m_swaps)
+        {
+            std::swap(re[swap.first], re[swap.second]);
+            std::swap(im[swap.first], im[swap.second]);
+        }
+
+        for (size_t half = 1; half < m_size; half <<= 1)
+        {
+            const float *wRe = &m_twiddleRe[half - 1];
+            const float *wIm = &m_twiddleIm[half - 1];
+            const auto butterfly = half >= kKernelMinimum ? m_kernels->butterfly : ButterflyShort;
+            for (size_t i = 0; i < m_size; i += 2 * half)
+                butterfly(re + i, im + i, re + i + half, im + i + half, wRe, wIm, half);
+        }
+    }
+
+    void Fft::Forward(float *re, float *im) const
+    {
+        Transform(re, im);
+    }
+
+    void Fft::Inverse(float *re, float *im) const
+    {
+        // Swapping real and imaginary parts conjugates the transform: IDFT(x) = swap(DFT(swap(x))) / N
+        Transform(im, re);
+        const float scale = 1.0f / static_cast<float>(m_size);
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            re[i] *= scale;
+            im[i] *= scale;
+        }
+    }
+}
@@ -0,0 +1,498 @@
+#include "Dsp/FlacDecoder.h"
+#include "Utility/Md5.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr unsigned kMaxChannels = 8;
+        constexpr unsigned kMaxBits = 24;
+
+        struct CrcTables
+        {
+            uint8_t crc8[256];
+            uint16_t crc16[256];
+
+            CrcTables()
+            {
+                for (unsigned i = 0; i < 256; ++i)
+                {
+                    unsigned c8 = i;
+                    unsigned c16 = i << 8;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        c8 = (c8 & 0x80) ? (c8 << 1) ^ 0x07 : c8 << 1;
+                        c16 = (c16 & 0x8000) ? (c16 << 1) ^ 0x8005 : c16 << 1;
+                    }
+                    crc8[i] = static_cast<uint8_t>(c8);
+                    crc16[i] = static_cast<uint16_t>(c16);
+                }
+            }
+        };
+
+        const CrcTables &Crc()
+        {
+            static const CrcTables tables;
+            return tables;
+        }
+
+        unsigned LeadingZeros(uint64_t value)
+        {
+            unsigned zeros = 0;
+            for (unsigned step = 32; step > 0; step /= 2)
+            {
+                if ((value >> (64 - step)) == 0)
+                {
+                    zeros += step;
+                    value <<= step;
+                }
+            }
+            return zeros;
+        }
+
+        /**
+         * @brief MSB-first bit reader. Reading past the end sets overrun and yields zeros.
+         */
+        struct BitReader
+        {
+            const uint8_t *data;
+            size_t size;
+            size_t pos = 0; ///< In bits.
+            bool overrun = false;
+
+            BitReader(const uint8_t *p, size_t bytes) : data(p), size(bytes) {}
+
+            /// 64 bits starting at the current position (zeros past the end).
+            uint64_t Peek() const
+            {
+                const size_t byte = pos / 8;
+                uint64_t window = 0;
+                if (byte + 8 <= size)
+                {
+                    for (int i = 0; i < 8; ++i)
+                        window = window << 8 | data[byte + i];
+                }
+                else
+                {
+                    for (size_t i = 0; i < 8; ++i)
+                        window = window << 8 | (byte + i < size ? data[byte + i] : 0);
+                }
+                return window << (pos % 8);
+            }
+
+            uint32_t Read(unsigned bits)
+            {
+                if (bits == 0)
+                    return 0;
+                if (pos + bits > size * 8)
+                {
+                    overrun = true;
+                    pos = size * 8;
+                    return 0;
+                }
+                const uint32_t value = static_cast<uint32_t>(Peek() >> (64 - bits));
+                pos += bits;
+                return value;
+            }
+
+            int32_t ReadSigned(unsigned bits)
+            {
+                if (bits == 0)
+                    return 0;
+                const uint32_t value = Read(bits);
+                const uint32_t sign = 1u << (bits - 1);
+                return static_cast<int32_t>((value ^ sign) - sign);
+            }
+
+            /// Counts zeros up to and including the terminating one.
+            uint32_t ReadUnary()
+            {
+                uint32_t zeros = 0;
+                for (;;)
+                {
+                    if (pos >= size * 8)
+                    {
+                        overrun = true;
+                        return 0;
+                    }
+                    const uint64_t window = Peek() >> 8 << 8; // the low byte may be short of a full load
+                    if (window != 0)
+                    {
+                        const unsigned count = LeadingZeros(window);
+                        pos += count + 1;
+                        if (pos > size * 8)
+                        {
+                            overrun = true;
+                            pos = size * 8;
+                            return 0;
+                        }
+                        return zeros + count;
+                    }
+                    zeros += 56;
+                    pos += 56;
+                }
+            }
+
+            void AlignToByte() { pos = (pos + 7) / 8 * 8; }
+        };
+
+        struct StreamInfo
+        {
+            uint32_t sampleRate = 0;
+            unsigned channels = 0;
+            unsigned bits = 0;
+            uint64_t frames = 0;
+            uint8_t md5[16] = {};
+        };
+
+        /**
+         * @brief Reads the partitioned Rice residual of a predictor of @p order into
+         *        out[order..count).
+         */
+        bool ReadResidual(BitReader &reader, size_t count, unsigned order, int32_t *out)
+        {
+            const unsigned method = reader.Read(2);
+            if (method > 1)
+                throw std::runtime_error("[x] Unsupported FLAC residual coding");
+            const unsigned parameterBits = method == 0 ? 4 : 5;
+            const unsigned escape = (1u << parameterBits) - 1;
+            const unsigned partitionOrder = reader.Read(4);
+            const size_t partitions = size_t(1) << partitionOrder;
+            const size_t partitionSize = count >> partitionOrder;
+            if (count % partitions != 0 || partitionSize < order)
+                throw std::runtime_error("[x] Malformed FLAC residual");
+
+            size_t i = order;
+            for (size_t p = 0; p < partitions; ++p)
+            {
+                const unsigned parameter = reader.Read(parameterBits);
+                const size_t end = (p + 1) * partitionSize;
+                if (parameter == escape)
+                {
+                    const unsigned bits = reader.Read(5);
+                    for (; i < end; ++i)
+                        out[i] = reader.ReadSigned(bits);
+                }
+                else
+                {
+                    for (; i < end; ++i)
+                    {
+                        const uint32_t quotient = reader.ReadUnary();
+                        const uint32_t value = quotient << parameter | reader.Read(parameter);
+                        out[i] = static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+                    }
+                }
+                if (reader.overrun)
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Decodes one subframe of @p count samples of @p bits into @p out.
+         * @return False if the data ran out.
+         */
+        bool ReadSubframe(BitReader &reader, size_t count, unsigned bits, int32_t *out)
+        {
+            if (reader.Read(1) != 0)
+                throw std::runtime_error("[x] Malformed FLAC subframe");
+            const unsigned type = reader.Read(6);
+            unsigned wasted = 0;
+            if (reader.Read(1))
+                wasted = reader.ReadUnary() + 1;
+            if (wasted >= bits)
+                throw std::runtime_error("[x] Malformed FLAC subframe");
+            bits -= wasted;
+
+            if (type == 0)
+            {
+                std::fill(out, out + count, reader.ReadSigned(bits));
+            }
+            else if (type == 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    out[i] = reader.ReadSigned(bits);
+            }
+            else if (type >= 8 && type <= 12)
+            {
+                const unsigned order = type - 8;
+                if (order > count)
+                    throw std::runtime_error("[x] Malformed FLAC subframe");
+                for (unsigned i = 0; i < order; ++i)
+                    out[i] = reader.ReadSigned(bits);
+                if (!ReadResidual(reader, count, order, out))
+                    return false;
+                for (size_t i = order; i < count; ++i)
+                {
+                    int64_t prediction = 0;
+                    switch (order)
+                    {
+                    case 1: prediction = out[i - 1]; break;
+                    case 2: prediction = 2 * int64_t(out[i - 1]) - out[i - 2]; break;
+                    case 3: prediction = 3 * int64_t(out[i - 1]) - 3 * int64_t(out[i - 2]) + out[i - 3]; break;
+                    case 4: prediction = 4 * int64_t(out[i - 1]) - 6 * int64_t(out[i - 2]) + 4 * int64_t(out[i - 3]) - out[i - 4]; break;
+                    default: break;
+                    }
+                    out[i] = static_cast<int32_t>(out[i] + prediction);
+                }
+            }
+            else if (type >= 32)
+            {
+                const unsigned order = (type & 31) + 1;
+                if (order > count)
+                    throw std::runtime_error("[x] Malformed FLAC subframe");
+                for (unsigned i = 0; i < order; ++i)
+                    out[i] = reader.ReadSigned(bits);
+                const unsigned precision = reader.Read(4) + 1;
+                const int shift = reader.ReadSigned(5);
+                if (precision > 15 || shift < 0)
+                    throw std::runtime_error("[x] Unsupported FLAC LPC subframe");
+                int32_t coefficients[32];
+                for (unsigned j = 0; j < order; ++j)
+                    coefficients[j] = reader.ReadSigned(precision);
+                if (!ReadResidual(reader, count, order, out))
+                    return false;
+                for (size_t i = order; i < count; ++i)
+                {
+                    int64_t sum = 0;
+                    for (unsigned j = 0; j < order; ++j)
+                        sum += int64_t(coefficients[j]) * out[i - 1 - j];
+                    out[i] = static_cast<int32_t>(out[i] + (sum >> shift));
+                }
+            }
+            else
+            {
+                throw std::runtime_error("[x] Malformed FLAC subframe");
+            }
+
+            if (wasted > 0)
+                for (size_t i = 0; i < count; ++i)
+                    out[i] = static_cast<int32_t>(static_cast<uint32_t>(out[i]) << wasted);
+            return !reader.overrun;
+        }
+
+        bool OnlyZeros(const uint8_t *data, size_t size)
+        {
+            return std::all_of(data, data + size, [](uint8_t b)
+                               { return b == 0; });
+        }
+    }
+
+    bool IsFlac(const uint8_t *data, size_t size)
+    {
+        return data && size >= 4 && std::memcmp(data, "fLaC", 4) == 0;
+    }
+
+    FlacPcm DecodeFlacPcm(const uint8_t *data, size_t size)
+    {
+        if (!IsFlac(data, size))
+            throw std::runtime_error("[x] Not a FLAC stream");
+
+        // Metadata blocks: STREAMINFO first, the others skipped
+        StreamInfo info;
+        bool haveInfo = false;
+        size_t offset = 4;
+        for (bool last = false; !last;)
+        {
+            if (offset + 4 > size)
+                throw std::runtime_error("[x] Truncated FLAC metadata");
+            last = (data[offset] & 0x80) != 0;
+            const unsigned type = data[offset] & 0x7F;
+            const size_t length = size_t(data[offset + 1]) << 16 | size_t(data[offset + 2]) << 8 | data[offset + 3];
+            offset += 4;
+            if (offset + length > size)
+                throw std::runtime_error("[x] Truncated FLAC metadata");
+            if (type == 0 && length >= 34)
+            {
+                const uint8_t *p = data + offset;
+                uint64_t packed = 0;
+                for (int i = 0; i < 8; ++i)
+                    packed = packed << 8 | p[10 + i];
+                info.sampleRate = static_cast<uint32_t>(packed >> 44);
+                info.channels = static_cast<unsigned>((packed >> 41) & 7) + 1;
+                info.bits = static_cast<unsigned>((packed >> 36) & 31) + 1;
+                info.frames = packed & 0xFFFFFFFFFull;
+                std::memcpy(info.md5, p + 18, 16);
+                haveInfo = true;
+            }
+            offset += length;
+        }
+        if (!haveInfo)
+            throw std::runtime_error("[x] FLAC stream has no STREAMINFO");
+        if (info.bits > kMaxBits || info.bits < 4)
+            throw std::runtime_error("[x] Unsupported FLAC sample size");
+
+        FlacPcm pcm;
+        pcm.sampleRate = info.sampleRate;
+        pcm.channels = info.channels;
+        pcm.bitsPerSample = info.bits;
+        if (info.frames > 0)
+            pcm.samples.reserve(static_cast<size_t>(std::min<uint64_t>(info.frames, uint64_t(1) << 31) * info.channels));
+
+        const CrcTables &crc = Crc();
+        std::vector<int32_t> channels[kMaxChannels];
+        while (offset < size)
+        {
+            if (size - offset < 2 || data[offset] != 0xFF || (data[offset + 1] & 0xFE) != 0xF8)
+            {
+                if (OnlyZeros(data + offset, size - offset))
+                    break;
+                if (size - offset < 16)
+                {
+                    pcm.truncated = true;
+                    break;
+                }
+                throw std::runtime_error("[x] FLAC frame sync lost");
+            }
+
+            BitReader reader(data + offset, size - offset);
+            reader.Read(16);
+            const unsigned blockCode = reader.Read(4);
+            const unsigned rateCode = reader.Read(4);
+            const unsigned assignment = reader.Read(4);
+            const unsigned sizeCode = reader.Read(3);
+            reader.Read(1);
+
+            // Coded frame / sample number: only skipped
+            const uint32_t lead = reader.Read(8);
+            unsigned extra = 0;
+            while (extra < 7 && (lead & (0x80u >> extra)))
+                ++extra;
+            if (extra == 1 || (extra == 7 && lead != 0xFE))
+                throw std::runtime_error("[x] Malformed FLAC frame header");
+            for (unsigned i = 1; i < extra; ++i)
+                reader.Read(8);
+
+            size_t frames = 0;
+            if (blockCode == 1)
+                frames = 192;
+            else if (blockCode >= 2 && blockCode <= 5)
+                frames = size_t(576) << (blockCode - 2);
+            else if (blockCode == 6)
+                frames = reader.Read(8) + 1;
+            else if (blockCode == 7)
+                frames = reader.Read(16) + 1;
+            else if (blockCode >= 8)
+                frames = size_t(256) << (blockCode - 8);
+            else
+                throw std::runtime_error("[x] Malformed FLAC frame header");
+            if (rateCode == 12)
+                reader.Read(8);
+            else if (rateCode == 13 || rateCode == 14)
+                reader.Read(16);
+            else if (rateCode == 15)
+                throw std::runtime_error("[x] Malformed FLAC frame header");
+
+            static const unsigned kSizes[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+            const unsigned bits = sizeCode == 0 ? info.bits : kSizes[sizeCode];
+            const unsigned channelCount = assignment < 8 ? assignment + 1 : 2;
+            if (assignment > 10 || bits != info.bits || channelCount != info.channels)
+                throw std::runtime_error("[x] Unsupported FLAC frame");
+
+            const size_t headerBytes = reader.pos / 8;
+            if (reader.overrun || headerBytes + 1 > size - offset)
+            {
+                pcm.truncated = true;
+                break;
+            }
+            uint8_t crc8 = 0;
+            for (size_t i = 0; i < headerBytes; ++i)
+                crc8 = crc.crc8[crc8 ^ data[offset + i]];
+            if (crc8 != reader.Read(8))
+                throw std::runtime_error("[x] FLAC frame header CRC mismatch");
+
+            bool complete = true;
+            for (unsigned c = 0; c < channelCount && complete; ++c)
+            {
+                const bool side = (assignment == 8 && c == 1) || (assignment == 9 && c == 0) || (assignment == 10 && c == 1);
+                channels[c].resize(frames);
+                complete = ReadSubframe(reader, frames, bits + (side ? 1 : 0), channels[c].data());
+            }
+            reader.AlignToByte();
+            const size_t frameBytes = reader.pos / 8;
+            const uint32_t stored = reader.Read(16);
+            if (!complete || reader.overrun)
+            {
+                pcm.truncated = true;
+                break;
+            }
+            uint16_t crc16 = 0;
+            for (size_t i = 0; i < frameBytes; ++i)
+                crc16 = static_cast<uint16_t>((crc16 << 8) ^ crc.crc16[(crc16 >> 8) ^ data[offset + i]]);
+            if (crc16 != stored)
+                throw std::runtime_error("[x] FLAC frame CRC mismatch");
+
+            int32_t *a = channels[0].data();
+            int32_t *b = channels[1].data();
+            for (size_t i = 0; assignment >= 8 && i < frames; ++i)
+            {
+                switch (assignment)
+                {
+                case 8: // left, side
+                    b[i] = a[i] - b[i];
+                    break;
+                case 9: // side, right
+                    a[i] = a[i] + b[i];
+                    break;
+                case 10: // mid, side
+                {
+                    const int32_t mid = static_cast<int32_t>(static_cast<uint32_t>(a[i]) << 1) | (b[i] & 1);
+                    const int32_t side = b[i];
+                    a[i] = (mid + side) >> 1;
+                    b[i] = (mid - side) >> 1;
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+
+            const size_t base = pcm.samples.size();
+            pcm.samples.resize(base + frames * channelCount);
+            for (unsigned c = 0; c < channelCount; ++c)
+            {
+                const int32_t *source = channels[c].data();
+                int32_t *target = pcm.samples.data() + base + c;
+                for (size_t i = 0; i < frames; ++i)
+                    target[i * channelCount] = source[i];
+            }
+            offset += reader.pos / 8;
+        }
+
+        static const uint8_t kUnset[16] = {};
+        if (!pcm.truncated && std::memcmp(info.md5, kUnset, 16) != 0)
+        {
+            Utility::Md5 md5;
+            const size_t width = (info.bits + 7) / 8;
+            std::vector<uint8_t> bytes(pcm.samples.size() * width);
+            uint8_t *p = bytes.data();
+            for (int32_t sample : pcm.samples)
+                for (size_t b = 0; b < width; ++b)
+                    *p++ = static_cast<uint8_t>(static_cast<uint32_t>(sample) >> (8 * b));
+            md5.Update(bytes.data(), bytes.size());
+            uint8_t digest[16];
+            md5.Finish(digest);
+            if (std::memcmp(digest, info.md5, 16) != 0)
+                throw std::runtime_error("[x] FLAC MD5 mismatch");
+            pcm.md5Checked = true;
+        }
+        return pcm;
+    }
+
+    DecodedAudio DecodeFlac(const uint8_t *data, size_t size)
+    {
+        const FlacPcm pcm = DecodeFlacPcm(data, size);
+        DecodedAudio audio;
+        audio.sampleRate = pcm.sampleRate;
+        audio.channels = pcm.channels;
+        audio.samples.resize(pcm.samples.size());
+        const float scale = 1.0f / static_cast<float>(1u << (pcm.bitsPerSample - 1));
+        for (size_t i = 0; i < pcm.samples.size(); ++i)
+            audio.samples[i] = pcm.samples[i] * scale;
+        return audio;
+    }
+}
@@ -0,0 +1,872 @@
+#include "Dsp/FlacEncoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr unsigned kMaxChannels = 8;
+        constexpr unsigned kMaxLpcOrder = 32;
+        constexpr unsigned kMaxPartitionOrder = 8;
+        constexpr unsigned kMaxRiceParameter = 30; ///< RICE2 allows 0..30 (31 escapes).
+        constexpr unsigned kMaxShift = 15;         ///< LPC shift is a 5-bit signed field.
+        constexpr double kTukeyAlpha = 0.5;
+        constexpr double kPi = 3.14159265358979323846;
+
+        enum ChannelAssignment : unsigned
+        {
+            kLeftSide = 8,
+            kSideRight = 9,
+            kMidSide = 10,
+        };
+
+        struct CrcTables
+        {
+            uint8_t crc8[256];
+            uint16_t crc16[256];
+
+            CrcTables()
+            {
+                for (unsigned i = 0; i < 256; ++i)
+                {
+                    unsigned c8 = i;
+                    unsigned c16 = i << 8;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        c8 = (c8 & 0x80) ? (c8 << 1) ^ 0x07 : c8 << 1;
+                        c16 = (c16 & 0x8000) ? (c16 << 1) ^ 0x8005 : c16 << 1;
+                    }
+                    crc8[i] = static_cast<uint8_t>(c8);
+                    crc16[i] = static_cast<uint16_t>(c16);
+                }
+            }
+        };
+
+        const CrcTables &Crc()
+        {
+            static const CrcTables tables;
+            return tables;
+        }
+
+        unsigned FloorLog2(uint64_t value)
+        {
+            unsigned log = 0;
+            while (value >>= 1)
+                ++log;
+            return log;
+        }
+
+        uint32_t ZigZag(int32_t value)
+        {
+            return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        }
+
+        /// Frame header block-size code; 6 and 7 mean "n - 1 follows in 8 / 16 bits".
+        unsigned BlockSizeCode(size_t frames)
+        {
+            switch (frames)
+            {
+            case 192: return 1;
+            case 576: return 2;
+            case 1152: return 3;
+            case 2304: return 4;
+            case 4608: return 5;
+            case 256: return 8;
+            case 512: return 9;
+            case 1024: return 10;
+            case 2048: return 11;
+            case 4096: return 12;
+            case 8192: return 13;
+            case 16384: return 14;
+            case 32768: return 15;
+            default: return frames <= 256 ? 6 : 7;
+            }
+        }
+
+        /// Frame header sample-rate code; 0 = as in STREAMINFO.
+        unsigned SampleRateCode(uint32_t rate)
+        {
+            switch (rate)
+            {
+            case 88200: return 1;
+            case 176400: return 2;
+            case 192000: return 3;
+            case 8000: return 4;
+            case 16000: return 5;
+            case 22050: return 6;
+            case 24000: return 7;
+            case 32000: return 8;
+            case 44100: return 9;
+            case 48000: return 10;
+            case 96000: return 11;
+            default: return 0;
+            }
+        }
+
+        unsigned SampleSizeCode(unsigned bits)
+        {
+            return bits == 8 ? 1 : bits == 16 ? 4 : 6;
+        }
+
+        /// Appends @p value in FLAC's extended UTF-8 coding (up to 36 bits, 7 bytes).
+        size_t PutUtf8(uint8_t *p, uint64_t value)
+        {
+            if (value < 0x80)
+            {
+                p[0] = static_cast<uint8_t>(value);
+                return 1;
+            }
+            size_t bytes = value < 0x800 ? 2 : value < 0x10000 ? 3 : value < 0x200000 ? 4 : value < 0x4000000 ? 5 : value < 0x80000000ull ? 6 : 7;
+            p[0] = bytes == 7 ? 0xFE : static_cast<uint8_t>((0xFF00u >> bytes) | (value >> (6 * (bytes - 1))));
+            for (size_t i = 1; i < bytes; ++i)
+                p[i] = static_cast<uint8_t>(0x80 | ((value >> (6 * (bytes - 1 - i))) & 0x3F));
+            return bytes;
+        }
+
+        /// Rice parameter for a partition whose zigzagged residuals sum to @p sum, and its cost.
+        unsigned RiceParameter(uint64_t sum, size_t count, uint64_t &bits)
+        {
+            const unsigned guess = sum > count ? std::min(FloorLog2(sum / count), kMaxRiceParameter) : 0;
+            unsigned best = guess;
+            bits = UINT64_MAX;
+            for (unsigned k = guess > 0 ? guess - 1 : 0; k <= std::min(guess + 1, kMaxRiceParameter); ++k)
+            {
+                // An upper bound: sum >> k >= the sum of each value >> k
+                const uint64_t cost = uint64_t(count) * (k + 1) + (sum >> k);
+                if (cost < bits)
+                {
+                    bits = cost;
+                    best = k;
+                }
+            }
+            return best;
+        }
+
+        /**
+         * @brief Partitioned Rice coding chosen for one residual.
+         */
+        struct RiceChoice
+        {
+            unsigned order = 0; ///< Partition order: 2^order partitions.
+            bool rice2 = false; ///< 5-bit parameters (some exceed 14).
+            uint8_t parameters[1u << kMaxPartitionOrder];
+        };
+
+        /**
+         * @brief Picks the partition order and Rice parameters for the residual of a
+         *        predictor of @p predictorOrder (residual[predictorOrder..count) is coded).
+         * @return Bits the residual section takes, at most.
+         */
+        uint64_t ChooseRice(const int32_t *residual, size_t count, unsigned predictorOrder,
+                            std::vector<uint64_t> &sums, RiceChoice &choice)
+        {
+            unsigned maxOrder = 0;
+            while (maxOrder < kMaxPartitionOrder && count % (size_t(2) << maxOrder) == 0 &&
+                   (count >> (maxOrder + 1)) > predictorOrder)
+                ++maxOrder;
+
+            // Sums of the finest partitions, merged pairwise for each coarser order
+            size_t partitions = size_t(1) << maxOrder;
+            const size_t size = count >> maxOrder;
+            sums.assign(partitions, 0);
+            for (size_t p = 0, i = predictorOrder; p < partitions; ++p)
+            {
+                uint64_t sum = 0;
+                for (const size_t end = (p + 1) * size; i < end; ++i)
+                    sum += ZigZag(residual[i]);
+                sums[p] = sum;
+            }
+
+            uint64_t bestBits = UINT64_MAX;
+            for (unsigned order = maxOrder + 1; order-- > 0;)
+            {
+                const size_t partitionSize = count >> order;
+                uint64_t bits = 0;
+                unsigned maxParameter = 0;
+                uint8_t parameters[1u << kMaxPartitionOrder];
+                for (size_t p = 0; p < partitions; ++p)
+                {
+                    uint64_t cost = 0;
+                    const size_t values = partitionSize - (p == 0 ? predictorOrder : 0);
+                    parameters[p] = static_cast<uint8_t>(RiceParameter(sums[p], values, cost));
+                    maxParameter = std::max<unsigned>(maxParameter, parameters[p]);
+                    bits += cost;
+                }
+                bits += 6 + partitions * (maxParameter > 14 ? 5 : 4);
+                if (bits < bestBits)
+                {
+                    bestBits = bits;
+                    choice.order = order;
+                    choice.rice2 = maxParameter > 14;
+                    std::memcpy(choice.parameters, parameters, partitions);
+                }
+
+                partitions /= 2;
+                for (size_t p = 0; p < partitions; ++p)
+                    sums[p] = sums[2 * p] + sums[2 * p + 1];
+            }
+            return bestBits;
+        }
+    }
+
+    /**
+     * @brief How one channel of a frame is coded.
+     */
+    struct FlacFrameEncoder::Subframe
+    {
+        enum class Type
+        {
+            Constant,
+            Verbatim,
+            Fixed,
+            Lpc,
+        };
+
+        Type type = Type::Verbatim;
+        unsigned bits = 0;   ///< Bits per sample as coded (after removing wasted bits).
+        unsigned wasted = 0;
+        unsigned order = 0;
+        int32_t value = 0;   ///< Constant subframes.
+        unsigned precision = 0;
+        unsigned shift = 0;
+        int32_t coefficients[kMaxLpcOrder];
+        RiceChoice rice;
+        RiceChoice candidateRice;
+        std::vector<int32_t> samples;   ///< Input with the wasted bits shifted out.
+        std::vector<int32_t> residual;
+        std::vector<int32_t> candidate; ///< Residual of the predictor being tried.
+    };
+
+    /**
+     * @brief MSB-first bit writer into a buffer known to be large enough.
+     */
+    struct FlacFrameEncoder::BitWriter
+    {
+        uint8_t *out;
+        uint64_t acc = 0;
+        unsigned count = 0; ///< Bits pending in acc (fewer than 32 between calls).
+
+        explicit BitWriter(uint8_t *p) : out(p) {}
+
+        void Put(uint32_t value, unsigned bits)
+        {
+            if (bits == 0)
+                return;
+            acc = (acc << bits) | (value & (0xFFFFFFFFu >> (32 - bits)));
+            count += bits;
+            if (count >= 32)
+            {
+                count -= 32;
+                const uint32_t word = static_cast<uint32_t>(acc >> count);
+                out[0] = static_cast<uint8_t>(word >> 24);
+                out[1] = static_cast<uint8_t>(word >> 16);
+                out[2] = static_cast<uint8_t>(word >> 8);
+                out[3] = static_cast<uint8_t>(word);
+                out += 4;
+            }
+        }
+
+        void PutRice(uint32_t value, unsigned k)
+        {
+            uint32_t quotient = value >> k;
+            const uint32_t low = k ? value & (0xFFFFFFFFu >> (32 - k)) : 0;
+            if (uint64_t(quotient) + 1 + k <= 32)
+            {
+                Put((1u << k) | low, quotient + 1 + k);
+                return;
+            }
+            for (; quotient >= 32; quotient -= 32)
+                Put(0, 32);
+            Put(1, quotient + 1);
+            Put(low, k);
+        }
+
+        /// Pads to a byte boundary with zeros and returns the end of the output.
+        uint8_t *Finish()
+        {
+            Put(0, (8 - count % 8) % 8);
+            while (count >= 8)
+            {
+                count -= 8;
+                *out++ = static_cast<uint8_t>(acc >> count);
+            }
+            return out;
+        }
+    };
+
+    std::vector<uint8_t> BuildFlacHeader(const FlacFormat &format, unsigned blockSize, const FlacTotals &totals)
+    {
+        std::vector<uint8_t> header(kFlacHeaderBytes, 0);
+        uint8_t *p = header.data();
+        std::memcpy(p, "fLaC", 4);
+        p[4] = 0x80; // last metadata block, type 0 (STREAMINFO)
+        p[7] = 34;   // its length
+
+        uint8_t *info = p + 8;
+        info[0] = static_cast<uint8_t>(blockSize >> 8);
+        info[1] = static_cast<uint8_t>(blockSize);
+        info[2] = static_cast<uint8_t>(blockSize >> 8);
+        info[3] = static_cast<uint8_t>(blockSize);
+        for (int i = 0; i < 3; ++i)
+        {
+            info[4 + i] = static_cast<uint8_t>(totals.minFrameBytes >> (16 - 8 * i));
+            info[7 + i] = static_cast<uint8_t>(totals.maxFrameBytes >> (16 - 8 * i));
+        }
+        // 20 bits rate, 3 bits channels - 1, 5 bits bits - 1, 36 bits total frames
+        const uint64_t packed = uint64_t(format.sampleRate & 0xFFFFF) << 44 | uint64_t(format.channels - 1) << 41 |
+                                uint64_t(format.bitsPerSample - 1) << 36 | (totals.frames & 0xFFFFFFFFFull);
+        for (int i = 0; i < 8; ++i)
+            info[10 + i] = static_cast<uint8_t>(packed >> (56 - 8 * i));
+        std::memcpy(info + 18, totals.md5, 16);
+        return header;
+    }
+
+    FlacFrameEncoder::FlacFrameEncoder(const FlacFormat &format, const FlacEncoderOptions &options)
+        : m_format(format),
+          m_options(options),
+          m_subframes(new Subframe[kMaxChannels])
+    {
+        if (format.channels == 0 || format.channels > kMaxChannels || format.sampleRate == 0 || format.sampleRate > 655350 ||
+            (format.bitsPerSample != 8 && format.bitsPerSample != 16 && format.bitsPerSample != 24))
+            throw std::runtime_error("[x] Unsupported FLAC format");
+        if (options.blockSize < 16 || options.blockSize > 65535 || options.maxLpcOrder > kMaxLpcOrder)
+            throw std::runtime_error("[x] Unsupported FLAC encoder options");
+    }
+
+    FlacFrameEncoder::~FlacFrameEncoder() = default;
+
+    /**
+     * @brief Picks the cheapest coding of @p signal (@p count samples of @p bits).
+     */
+    void FlacFrameEncoder::AnalyzeChannel(const int32_t *signal, size_t count, unsigned bits, Subframe &subframe)
+    {
+        subframe.wasted = 0;
+        subframe.bits = bits;
+        if (std::all_of(signal, signal + count, [&](int32_t value)
+                        { return value == signal[0]; }))
+        {
+            subframe.type = Subframe::Type::Constant;
+            subframe.value = signal[0];
+            return;
+        }
+
+        // Low bits that are zero in every sample (e.g. 16-bit audio in a 24-bit stream)
+        uint32_t any = 0;
+        for (size_t i = 0; i < count; ++i)
+            any |= static_cast<uint32_t>(signal[i]);
+        while (!(any & 1u))
+        {
+            any >>= 1;
+            ++subframe.wasted;
+        }
+        subframe.bits = bits - subframe.wasted;
+        subframe.samples.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            subframe.samples[i] = signal[i] >> subframe.wasted;
+        subframe.residual.resize(count);
+        subframe.candidate.resize(count);
+
+        subframe.type = Subframe::Type::Verbatim;
+        uint64_t best = uint64_t(count) * subframe.bits;
+
+        const int32_t *x = subframe.samples.data();
+        if (count > 4)
+        {
+            // Fixed predictors: pick the order whose residual is smallest
+            uint64_t sums[5] = {};
+            int64_t last0 = x[3];
+            int64_t last1 = int64_t(x[3]) - x[2];
+            int64_t last2 = last1 - (int64_t(x[2]) - x[1]);
+            int64_t last3 = last2 - (int64_t(x[2]) - 2 * int64_t(x[1]) + x[0]);
+            for (size_t i = 4; i < count; ++i)
+            {
+                const int64_t e0 = x[i];
+                const int64_t e1 = e0 - last0;
+                const int64_t e2 = e1 - last1;
+                const int64_t e3 = e2 - last2;
+                const int64_t e4 = e3 - last3;
+                sums[0] += static_cast<uint64_t>(e0 < 0 ? -e0 : e0);
+                sums[1] += static_cast<uint64_t>(e1 < 0 ? -e1 : e1);
+                sums[2] += static_cast<uint64_t>(e2 < 0 ? -e2 : e2);
+                sums[3] += static_cast<uint64_t>(e3 < 0 ? -e3 : e3);
+                sums[4] += static_cast<uint64_t>(e4 < 0 ? -e4 : e4);
+                last0 = e0;
+                last1 = e1;
+                last2 = e2;
+                last3 = e3;
+            }
+            const unsigned order = static_cast<unsigned>(std::min_element(sums, sums + 5) - sums);
+
+            int32_t *r = subframe.candidate.data();
+            for (size_t i = order; i < count; ++i)
+            {
+                switch (order)
+                {
+                case 0: r[i] = x[i]; break;
+                case 1: r[i] = x[i] - x[i - 1]; break;
+                case 2: r[i] = x[i] - 2 * x[i - 1] + x[i - 2]; break;
+                case 3: r[i] = x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3]; break;
+                default: r[i] = x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4]; break;
+                }
+            }
+            const uint64_t cost = uint64_t(order) * subframe.bits +
+                                  ChooseRice(r, count, order, m_partitionSums, subframe.candidateRice);
+            if (cost < best)
+            {
+                best = cost;
+                subframe.type = Subframe::Type::Fixed;
+                subframe.order = order;
+                subframe.residual.swap(subframe.candidate);
+                std::swap(subframe.rice, subframe.candidateRice);
+            }
+        }
+
+        if (m_options.maxLpcOrder > 0 && count > 2 * size_t(m_options.maxLpcOrder))
+            TryLpc(subframe, count, best);
+    }
+
+    /**
+     * @brief Tries an LPC predictor on subframe.samples; keeps it if it beats @p cost.
+     */
+    bool FlacFrameEncoder::TryLpc(Subframe &subframe, size_t count, uint64_t &cost)
+    {
+        const unsigned maxOrder = m_options.maxLpcOrder;
+        if (m_windowSize != count)
+        {
+            // Tukey window: flat middle, cosine tapers over a quarter at each end
+            m_window.assign(count, 1.0);
+            const double taper = kTukeyAlpha * (count - 1) / 2.0;
+            for (size_t i = 0; i < count && i < taper; ++i)
+            {
+                const double w = 0.5 * (1.0 - std::cos(kPi * i / taper));
+                m_window[i] = w;
+                m_window[count - 1 - i] = w;
+            }
+            m_windowSize = count;
+        }
+        m_windowed.resize(count);
+        const int32_t *x = subframe.samples.data();
+        for (size_t i = 0; i < count; ++i)
+            m_windowed[i] = x[i] * m_window[i];
+
+        double autoc[kMaxLpcOrder + 1];
+        for (unsigned lag = 0; lag <= maxOrder; ++lag)
+        {
+            double sum = 0.0;
+            for (size_t i = lag; i < count; ++i)
+                sum += m_windowed[i] * m_windowed[i - lag];
+            autoc[lag] = sum;
+        }
+        if (autoc[0] <= 0.0)
+            return false;
+
+        // Levinson-Durbin: predictors of every order and their errors
+        double lpc[kMaxLpcOrder];
+        double predictors[kMaxLpcOrder][kMaxLpcOrder];
+        double errors[kMaxLpcOrder];
+        double error = autoc[0];
+        for (unsigned i = 0; i < maxOrder; ++i)
+        {
+            double r = -autoc[i + 1];
+            for (unsigned j = 0; j < i; ++j)
+                r -= lpc[j] * autoc[i - j];
+            r /= error;
+            lpc[i] = r;
+            unsigned j = 0;
+            for (; j < i / 2; ++j)
+            {
+                const double tmp = lpc[j];
+                lpc[j] += r * lpc[i - 1 - j];
+                lpc[i - 1 - j] += r * tmp;
+            }
+            if (i & 1)
+                lpc[j] += lpc[j] * r;
+            error *= 1.0 - r * r;
+            for (j = 0; j <= i; ++j)
+                predictors[i][j] = -lpc[j];
+            errors[i] = error;
+        }
+
+        // Order with the fewest expected bits (residual from its error, plus coefficients)
+        const unsigned precision = std::min(15u, (count <= 1152 ? 10u : count <= 4608 ? 12u : 13u) + (subframe.bits > 16 ? 2u : 0u));
+        unsigned order = 1;
+        double bestBits = 1e300;
+        for (unsigned i = 0; i < maxOrder; ++i)
+        {
+            const double residuals = static_cast<double>(count - i - 1);
+            const double scaled = errors[i] * 0.5 / residuals;
+            const double perSample = scaled > 0.0 ? std::max(0.0, 0.5 * std::log2(scaled)) : 0.0;
+            const double bits = perSample * residuals + (i + 1) * double(precision + subframe.bits);
+            if (bits < bestBits)
+            {
+                bestBits = bits;
+                order = i + 1;
+            }
+        }
+
+        // Quantize with error feedback so the rounding errors do not accumulate
+        const double *coefficients = predictors[order - 1];
+        double cmax = 0.0;
+        for (unsigned j = 0; j < order; ++j)
+            cmax = std::max(cmax, std::fabs(coefficients[j]));
+        if (cmax <= 0.0)
+            return false;
+        int log2cmax = 0;
+        std::frexp(cmax, &log2cmax);
+        const int shift = std::min<int>(int(precision) - 1 - log2cmax, kMaxShift);
+        if (shift < 0)
+            return false;
+        const int32_t qmax = (1 << (precision - 1)) - 1;
+        const int32_t qmin = -(1 << (precision - 1));
+        int32_t quantized[kMaxLpcOrder];
+        double carry = 0.0;
+        for (unsigned j = 0; j < order; ++j)
+        {
+            carry += coefficients[j] * (1 << shift);
+            const int32_t q = static_cast<int32_t>(std::max<long>(qmin, std::min<long>(qmax, std::lround(carry))));
+            carry -= q;
+            quantized[j] = q;
+        }
+
+        int32_t *r = subframe.candidate.data();
+        for (size_t i = order; i < count; ++i)
+        {
+            int64_t sum = 0;
+            for (unsigned j = 0; j < order; ++j)
+                sum += int64_t(quantized[j]) * x[i - 1 - j];
+            const int64_t residual = x[i] - (sum >> shift);
+            if (residual > INT32_MAX || residual < INT32_MIN)
+                return false;
+            r[i] = static_cast<int32_t>(residual);
+        }
+
+        const uint64_t bits = uint64_t(order) * subframe.bits + 4 + 5 + uint64_t(order) * precision +
+                              ChooseRice(r, count, order, m_partitionSums, subframe.candidateRice);
+        if (bits >= cost)
+            return false;
+        cost = bits;
+        subframe.type = Subframe::Type::Lpc;
+        subframe.order = order;
+        subframe.precision = precision;
+        subframe.shift = static_cast<unsigned>(shift);
+        std::memcpy(subframe.coefficients, quantized, order * sizeof(int32_t));
+        subframe.residual.swap(subframe.candidate);
+        std::swap(subframe.rice, subframe.candidateRice);
+        return true;
+    }
+
+    void FlacFrameEncoder::WriteSubframe(BitWriter &writer, const Subframe &subframe, size_t count) const
+    {
+        unsigned type = 0;
+        switch (subframe.type)
+        {
+        case Subframe::Type::Constant: type = 0; break;
+        case Subframe::Type::Verbatim: type = 1; break;
+        case Subframe::Type::Fixed: type = 8 | subframe.order; break;
+        case Subframe::Type::Lpc: type = 32 | (subframe.order - 1); break;
+        }
+        writer.Put(type << 1 | (subframe.wasted ? 1 : 0), 8);
+        if (subframe.wasted)
+            writer.Put(1, subframe.wasted); // unary: wasted - 1 zeros, then a one
+
+        const unsigned bits = subframe.bits;
+        if (subframe.type == Subframe::Type::Constant)
+        {
+            writer.Put(static_cast<uint32_t>(subframe.value), bits);
+            return;
+        }
+        const int32_t *x = subframe.samples.data();
+        if (subframe.type == Subframe::Type::Verbatim)
+        {
+            for (size_t i = 0; i < count; ++i)
+                writer.Put(static_cast<uint32_t>(x[i]), bits);
+            return;
+        }
+
+        for (unsigned i = 0; i < subframe.order; ++i)
+            writer.Put(static_cast<uint32_t>(x[i]), bits);
+        if (subframe.type == Subframe::Type::Lpc)
+        {
+            writer.Put(subframe.precision - 1, 4);
+            writer.Put(subframe.shift, 5);
+            for (unsigned j = 0; j < subframe.order; ++j)
+                writer.Put(static_cast<uint32_t>(subframe.coefficients[j]), subframe.precision);
+        }
+
+        const RiceChoice &rice = subframe.rice;
+        writer.Put(rice.rice2 ? 1 : 0, 2);
+        writer.Put(rice.order, 4);
+        const size_t partitionSize = count >> rice.order;
+        const int32_t *r = subframe.residual.data();
+        size_t i = subframe.order;
+        for (size_t p = 0; p < (size_t(1) << rice.order); ++p)
+        {
+            const unsigned k = rice.parameters[p];
+            writer.Put(k, rice.rice2 ? 5 : 4);
+            for (const size_t end = (p + 1) * partitionSize; i < end; ++i)
+                writer.PutRice(ZigZag(r[i]), k);
+        }
+    }
+
+    void FlacFrameEncoder::Encode(const int32_t *samples, size_t frames, uint64_t frameNumber, std::vector<uint8_t> &out)
+    {
+        const unsigned channels = m_format.channels;
+        const unsigned bits = m_format.bitsPerSample;
+        for (unsigned c = 0; c < channels; ++c)
+        {
+            m_channels[c].resize(frames);
+            for (size_t i = 0; i < frames; ++i)
+                m_channels[c][i] = samples[i * channels + c];
+        }
+
+        unsigned assignment = channels - 1;
+        if (channels == 2)
+        {
+            // Side needs one bit more; mid/side usually wins on correlated channels
+            m_channels[2].resize(frames);
+            m_channels[3].resize(frames);
+            for (size_t i = 0; i < frames; ++i)
+            {
+                const int32_t left = m_channels[0][i];
+                const int32_t right = m_channels[1][i];
+                m_channels[2][i] = (left + right) >> 1;
+                m_channels[3][i] = left - right;
+            }
+            uint64_t estimate[4];
+            for (unsigned c = 0; c < 4; ++c)
+            {
+                const int32_t *x = m_channels[c].data();
+                uint64_t sums[3] = {};
+                for (size_t i = 2; i < frames; ++i)
+                {
+                    const int64_t e1 = int64_t(x[i]) - x[i - 1];
+                    const int64_t e2 = e1 - (int64_t(x[i - 1]) - x[i - 2]);
+                    sums[0] += static_cast<uint64_t>(x[i] < 0 ? -int64_t(x[i]) : x[i]);
+                    sums[1] += static_cast<uint64_t>(e1 < 0 ? -e1 : e1);
+                    sums[2] += static_cast<uint64_t>(e2 < 0 ? -e2 : e2);
+                }
+                uint64_t cost = 0;
+                RiceParameter(*std::min_element(sums, sums + 3), std::max<size_t>(frames, 3) - 2, cost);
+                estimate[c] = cost;
+            }
+            const uint64_t options[4] = {estimate[0] + estimate[1], estimate[0] + estimate[3],
+                                         estimate[3] + estimate[1], estimate[2] + estimate[3]};
+            switch (std::min_element(options, options + 4) - options)
+            {
+            case 1: assignment = kLeftSide; break;
+            case 2: assignment = kSideRight; break;
+            case 3: assignment = kMidSide; break;
+            default: break;
+            }
+        }
+
+        for (unsigned c = 0; c < channels; ++c)
+        {
+            unsigned source = c;
+            if (assignment == kLeftSide && c == 1)
+                source = 3;
+            else if (assignment == kSideRight && c == 0)
+                source = 3;
+            else if (assignment == kMidSide)
+                source = c == 0 ? 2 : 3;
+            const bool side = assignment >= kLeftSide && source == 3;
+            AnalyzeChannel(m_channels[source].data(), frames, bits + (side ? 1 : 0), m_subframes[c]);
+        }
+
+        // No subframe is larger than verbatim, so this bounds the frame
+        const size_t start = out.size();
+        out.resize(start + 32 + channels * (frames * (bits + 1) / 8 + 16));
+        uint8_t *header = out.data() + start;
+
+        const unsigned blockCode = BlockSizeCode(frames);
+        size_t length = 0;
+        header[length++] = 0xFF;
+        header[length++] = 0xF8; // fixed block size
+        header[length++] = static_cast<uint8_t>(blockCode << 4 | SampleRateCode(m_format.sampleRate));
+        header[length++] = static_cast<uint8_t>(assignment << 4 | SampleSizeCode(bits) << 1);
+        length += PutUtf8(header + length, frameNumber);
+        if (blockCode == 6)
+            header[length++] = static_cast<uint8_t>(frames - 1);
+        else if (blockCode == 7)
+        {
+            header[length++] = static_cast<uint8_t>((frames - 1) >> 8);
+            header[length++] = static_cast<uint8_t>(frames - 1);
+        }
+        const CrcTables &crc = Crc();
+        uint8_t crc8 = 0;
+        for (size_t i = 0; i < length; ++i)
+            crc8 = crc.crc8[crc8 ^ header[i]];
+        header[length++] = crc8;
+
+        BitWriter writer(header + length);
+        for (unsigned c = 0; c < channels; ++c)
+            WriteSubframe(writer, m_subframes[c], frames);
+        uint8_t *end = writer.Finish();
+
+        uint16_t crc16 = 0;
+        for (const uint8_t *p = header; p < end; ++p)
+            crc16 = static_cast<uint16_t>((crc16 << 8) ^ crc.crc16[(crc16 >> 8) ^ *p]);
+        *end++ = static_cast<uint8_t>(crc16 >> 8);
+        *end++ = static_cast<uint8_t>(crc16);
+        out.resize(static_cast<size_t>(end - out.data()));
+    }
+
+    FlacEncoder::FlacEncoder(const FlacFormat &format, const FlacEncoderOptions &options)
+        : m_format(format),
+          m_options(options)
+    {
+        if (m_options.threads == 0)
+            m_options.threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < m_options.threads; ++i)
+            m_encoders.push_back(std::make_unique<FlacFrameEncoder>(format, options));
+        for (unsigned i = 1; i < m_options.threads; ++i)
+            m_workers.emplace_back(&FlacEncoder::Worker, this, i);
+    }
+
+    FlacEncoder::~FlacEncoder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_start.notify_all();
+        for (std::thread &worker : m_workers)
+            worker.join();
+    }
+
+    std::vector<uint8_t> FlacEncoder::Header() const
+    {
+        return BuildFlacHeader(m_format, m_options.blockSize, FlacTotals{});
+    }
+
+    std::vector<uint8_t> FlacEncoder::FinalHeader() const
+    {
+        return BuildFlacHeader(m_format, m_options.blockSize, Totals());
+    }
+
+    FlacTotals FlacEncoder::Totals() const
+    {
+        FlacTotals totals;
+        totals.frames = m_frames;
+        totals.minFrameBytes = m_minFrameBytes;
+        totals.maxFrameBytes = m_maxFrameBytes;
+        m_md5.Finish(totals.md5);
+        return totals;
+    }
+
+    void FlacEncoder::Worker(unsigned index)
+    {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            m_start.wait(lock, [&]()
+                         { return m_stopping || m_generation != seen; });
+            if (m_stopping)
+                return;
+            seen = m_generation;
+            lock.unlock();
+            RunJobs(index);
+            lock.lock();
+            if (--m_busy == 0)
+                m_done.notify_one();
+        }
+    }
+
+    /**
+     * @brief Encodes frames of the current call until none are left.
+     */
+    void FlacEncoder::RunJobs(unsigned worker)
+    {
+        const size_t blockSize = m_options.blockSize;
+        const size_t jobs = (m_jobFrames + blockSize - 1) / blockSize;
+        FlacFrameEncoder &encoder = *m_encoders[worker];
+        for (size_t job; (job = m_nextJob.fetch_add(1, std::memory_order_relaxed)) < jobs;)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const size_t first = job * blockSize;
+            encoder.Encode(m_jobSamples + first * m_format.channels, std::min(blockSize, m_jobFrames - first),
+                           m_jobFirstFrame + job, m_outputs[job]);
+            m_encodeNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                           std::chrono::steady_clock::now() - start)
+                                                           .count()),
+                                 std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Hashes samples as FLAC does: little-endian, bitsPerSample / 8 bytes each.
+     */
+    void FlacEncoder::UpdateMd5(const int32_t *samples, size_t count)
+    {
+        const size_t width = m_format.bitsPerSample / 8;
+        constexpr size_t kChunk = 4096;
+        m_md5Bytes.resize(kChunk * width);
+        while (count > 0)
+        {
+            const size_t step = std::min(count, kChunk);
+            uint8_t *p = m_md5Bytes.data();
+            for (size_t i = 0; i < step; ++i)
+                for (size_t b = 0; b < width; ++b)
+                    *p++ = static_cast<uint8_t>(static_cast<uint32_t>(samples[i]) >> (8 * b));
+            m_md5.Update(m_md5Bytes.data(), step * width);
+            samples += step;
+            count -= step;
+        }
+    }
+
+    void FlacEncoder::Encode(const int32_t *samples, size_t frames, std::vector<uint8_t> &out)
+    {
+        if (frames == 0)
+            return;
+        if (m_partial)
+            throw std::runtime_error("[x] FLAC stream already ended with a partial frame");
+
+        const size_t blockSize = m_options.blockSize;
+        const size_t jobs = (frames + blockSize - 1) / blockSize;
+        m_partial = frames % blockSize != 0;
+        if (m_outputs.size() < jobs)
+            m_outputs.resize(jobs);
+        for (size_t job = 0; job < jobs; ++job)
+            m_outputs[job].clear();
+        m_jobSamples = samples;
+        m_jobFrames = frames;
+        m_jobFirstFrame = m_frames / blockSize;
+        m_nextJob.store(0, std::memory_order_relaxed);
+
+        const bool parallel = jobs > 1 && !m_workers.empty();
+        if (parallel)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_generation;
+            m_busy = static_cast<unsigned>(m_workers.size());
+        }
+        if (parallel)
+            m_start.notify_all();
+
+        // The hash is serial, so this thread does it while the workers start on the frames
+        UpdateMd5(samples, frames * m_format.channels);
+        RunJobs(0);
+        if (parallel)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]()
+                        { return m_busy == 0; });
+        }
+
+        for (size_t job = 0; job < jobs; ++job)
+        {
+            const std::vector<uint8_t> &frame = m_outputs[job];
+            const uint32_t bytes = static_cast<uint32_t>(frame.size());
+            m_minFrameBytes = m_minFrameBytes == 0 ? bytes : std::min(m_minFrameBytes, bytes);
+            m_maxFrameBytes = std::max(m_maxFrameBytes, bytes);
+            out.insert(out.end(), frame.begin(), frame.end());
+        }
+        m_frames += frames;
+    }
+}
@@ -0,0 +1,173 @@
+#include "Dsp/PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr size_t kPhases = 256;       ///< Table resolution between input samples.
+        constexpr size_t kBaseTaps = 64;      ///< Filter length when upsampling.
+        constexpr size_t kMaxTaps = 256;      ///< Cap for large downsampling ratios.
+        constexpr double kKaiserBeta = 9.0;   ///< About 90 dB stopband attenuation.
+        constexpr double kPassband = 0.91;    ///< Cutoff as a fraction of the lower Nyquist.
+        constexpr double kPi = 3.14159265358979323846;
+
+        /// Modified Bessel function of the first kind, order 0 (series expansion).
+        double BesselI0(double x)
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            const double half = x / 2.0;
+            for (int k = 1; k < 50; ++k)
+            {
+                term *= (half / k) * (half / k);
+                sum += term;
+                if (term < sum * 1e-12)
+                    break;
+            }
+            return sum;
+        }
+
+        size_t RoundUpTo8(size_t value) { return (value + 7) & ~size_t(7); }
+    }
+
+    PolyphaseResampler::PolyphaseResampler(unsigned channels, double inRate, double outRate,
+                                           size_t maxInputFrames, const SimdKernels *kernels)
+        : m_channels(channels ? channels : 1),
+          m_kernels(kernels ? kernels : &ActiveKernels()),
+          m_ratio(inRate / outRate)
+    {
+        // A narrower cutoff needs a proportionally longer filter for the same transition
+        const double scale = std::min(1.0, outRate / inRate);
+        m_taps = std::min(kMaxTaps, RoundUpTo8(static_cast<size_t>(std::ceil(kBaseTaps / scale))));
+        m_capacityFrames = maxInputFrames + 2 * m_taps;
+
+        m_coefs.assign(m_taps, 0.0f);
+        m_history.assign(m_capacityFrames * m_channels, 0.0f);
+        BuildTable(0.5 * kPassband * scale);
+        Reset();
+    }
+
+    /**
+     * @brief Tabulates the Kaiser-windowed sinc at kPhases + 1 fractional offsets.
+     *
+     * Row p holds the coefficients for an output that lies p / kPhases of the way from
+     * input frame n to n + 1, applied to frames n - taps/2 + 1 .. n + taps/2. Each row is
+     * normalized to unity DC gain so interpolating between rows cannot ripple the level.
+     *
+     * @param cutoff Cutoff frequency in cycles per input sample.
+     */
+    void PolyphaseResampler::BuildTable(double cutoff)
+    {
+        const double half = static_cast<double>(m_taps) / 2.0;
+        const double windowNorm = BesselI0(kKaiserBeta);
+        m_table.assign((kPhases + 1) * m_taps, 0.0f);
+        std::vector<double> row(m_taps);
+
+        for (size_t p = 0; p <= kPhases; ++p)
+        {
+            const double frac = static_cast<double>(p) / kPhases;
+            double sum = 0.0;
+            for (size_t k = 0; k < m_taps; ++k)
+            {
+                const double d = (static_cast<double>(k) - half + 1.0) - frac;
+                const double x = d / half;
+                const double window = std::fabs(x) >= 1.0 ? 0.0 : BesselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) / windowNorm;
+                const double arg = 2.0 * cutoff * d;
+                const double sinc = std::fabs(arg) < 1e-12 ? 1.0 : std::sin(kPi * arg) / (kPi * arg);
+                row[k] = 2.0 * cutoff * sinc * window;
+                sum += row[k];
+            }
+            for (size_t k = 0; k < m_taps; ++k)
+                m_table[p * m_taps + k] = static_cast<float>(row[k] / sum);
+        }
+    }
+
+    /**
+     * @brief Resets to a zero-filled history so the first input frame is centred on the filter.
+     */
+    void PolyphaseResampler::Reset()
+    {
+        std::fill(m_history.begin(), m_history.end(), 0.0f);
+        m_frames = m_taps / 2 - 1;
+        m_index = m_frames;
+        m_fraction = 0.0;
+    }
+
+    /**
+     * @brief Output frame k at position p_k needs frames up to floor(p_k) + taps/2.
+     */
+    size_t PolyphaseResampler::InputFramesWanted(size_t outFrames) const
+    {
+        if (outFrames == 0)
+            return 0;
+        const double last = m_fraction + static_cast<double>(outFrames - 1) * m_ratio;
+        const size_t needed = m_index + static_cast<size_t>(std::floor(last)) + m_taps / 2 + 1;
+        return needed > m_frames ? needed - m_frames : 0;
+    }
+
+    /**
+     * @brief De-interleaves input frames into the per-channel history.
+     */
+    size_t PolyphaseResampler::Push(const float *input, size_t frames)
+    {
+        frames = std::min(frames, m_capacityFrames - m_frames);
+        for (unsigned c = 0; c < m_channels; ++c)
+        {
+            float *dst = &m_history[c * m_capacityFrames + m_frames];
+            const float *src = input + c;
+            for (size_t i = 0; i < frames; ++i, src += m_channels)
+                dst[i] = *src;
+        }
+        m_frames += frames;
+        return frames;
+    }
+
+    /**
+     * @brief Filters buffered input into output frames, then drops consumed history.
+     */
+    size_t PolyphaseResampler::Pull(float *output, size_t outFrames)
+    {
+        const size_t halfTaps = m_taps / 2;
+        size_t produced = 0;
+
+        while (produced < outFrames && m_index + halfTaps < m_frames)
+        {
+            const double phase = m_fraction * kPhases;
+            const size_t row = std::min(static_cast<size_t>(phase), kPhases - 1);
+            const float t = static_cast<float>(phase - static_cast<double>(row));
+            m_kernels->lerp(m_coefs.data(), &m_table[row * m_taps], &m_table[(row + 1) * m_taps], t, m_taps);
+
+            const size_t first = m_index + 1 - halfTaps;
+            for (unsigned c = 0; c < m_channels; ++c)
+                output[produced * m_channels + c] = m_kernels->dot(&m_history[c * m_capacityFrames + first], m_coefs.data(), m_taps);
+
+            ++produced;
+
+            // Whole and fractional parts are kept apart so dropping consumed frames
+            // never perturbs the phase; output is bit-identical for any block size
+            m_fraction += m_ratio;
+            const double whole = std::floor(m_fraction);
+            m_index += static_cast<size_t>(whole);
+            m_fraction -= whole;
+        }
+
+        // Keep the taps/2 - 1 frames of history the next output still needs
+        const size_t drop = std::min(m_index + 1 > halfTaps ? m_index + 1 - halfTaps : 0, m_frames);
+        if (drop > 0)
+        {
+            for (unsigned c = 0; c < m_channels; ++c)
+            {
+                float *run = &m_history[c * m_capacityFrames];
+                std::memmove(run, run + drop, (m_frames - drop) * sizeof(float));
+            }
+            m_frames -= drop;
+            m_index -= drop;
+        }
+
+        return produced;
+    }
+}
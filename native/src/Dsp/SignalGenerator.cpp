@@ -0,0 +1,186 @@
+#include "Dsp/SignalGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace Dsp
+{
+    namespace
+    {
+        /// Highest tone frequency, as a fraction of the sample rate.
+        constexpr double kMaxCycles = 0.49;
+
+        /// Uniform [-1, 1) white noise has RMS 1/sqrt(3).
+        constexpr double kWhiteRms = 0.57735026918962576;
+
+        /// Kellett's refined pink filter applied to one white sample.
+        float PinkStep(float (&b)[7], float white)
+        {
+            b[0] = 0.99886f * b[0] + white * 0.0555179f;
+            b[1] = 0.99332f * b[1] + white * 0.0750759f;
+            b[2] = 0.96900f * b[2] + white * 0.1538520f;
+            b[3] = 0.86650f * b[3] + white * 0.3104856f;
+            b[4] = 0.55000f * b[4] + white * 0.5329522f;
+            b[5] = -0.7616f * b[5] - white * 0.0168980f;
+            const float pink = b[0] + b[1] + b[2] + b[3] + b[4] + b[5] + b[6] + white * 0.5362f;
+            b[6] = white * 0.115926f;
+            return pink;
+        }
+
+        /**
+         * @brief RMS of the pink filter's output per unit RMS of white input: the square
+         *        root of its impulse response energy.
+         */
+        double PinkGain()
+        {
+            static const double gain = []()
+            {
+                float state[7] = {};
+                double energy = 0.0;
+                for (int n = 0; n < 1 << 16; ++n)
+                {
+                    const double h = PinkStep(state, n == 0 ? 1.0f : 0.0f);
+                    energy += h * h;
+                }
+                return std::sqrt(energy);
+            }();
+            return gain;
+        }
+    }
+
+    SignalGenerator::SignalGenerator(const SignalSpec &spec, double sampleRate, const SimdKernels *kernels)
+        : m_spec(spec),
+          m_sampleRate(sampleRate),
+          m_kernels(kernels ? kernels : &ActiveKernels())
+    {
+        const double level = std::pow(10.0, m_spec.levelDb / 20.0);
+        switch (m_spec.type)
+        {
+        case SignalType::WhiteNoise:
+            m_gain = static_cast<float>(level / kWhiteRms);
+            break;
+        case SignalType::PinkNoise:
+            m_gain = static_cast<float>(level / (kWhiteRms * PinkGain()));
+            break;
+        default:
+            m_gain = static_cast<float>(level);
+            break;
+        }
+
+        const double start = std::min(std::max(m_spec.frequency, 0.0) / sampleRate, kMaxCycles);
+        m_startIncrement = start;
+        if (m_spec.type == SignalType::Sweep)
+        {
+            const double end = std::min(std::max(m_spec.endFrequency, 1e-3) / sampleRate, kMaxCycles);
+            m_period = std::max<uint64_t>(1, static_cast<uint64_t>(m_spec.sweepSeconds * sampleRate));
+            if (start > 0.0)
+                m_sweepGrowth = std::exp(std::log(end / start) / static_cast<double>(m_period));
+        }
+        else if (m_spec.type == SignalType::Clicks)
+        {
+            m_period = std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(m_spec.clickSeconds * sampleRate)));
+        }
+        Reset();
+    }
+
+    void SignalGenerator::Reset()
+    {
+        m_phase = 0.0;
+        m_increment = m_startIncrement;
+        m_position = 0;
+        m_random = m_spec.seed ? m_spec.seed : 1;
+        std::fill(std::begin(m_pink), std::end(m_pink), 0.0f);
+    }
+
+    void SignalGenerator::Render(float *out, size_t frames)
+    {
+        switch (m_spec.type)
+        {
+        case SignalType::Sine:
+        case SignalType::Sweep:
+            RenderTone(out, frames);
+            break;
+        case SignalType::WhiteNoise:
+        case SignalType::PinkNoise:
+            RenderNoise(out, frames);
+            break;
+        case SignalType::Clicks:
+            RenderClicks(out, frames);
+            break;
+        }
+    }
+
+    /**
+     * @brief Fills phases block by block in double precision, then evaluates them with the
+     *        sine kernel. Kernel lengths are padded to 8 with zero phases.
+     */
+    void SignalGenerator::RenderTone(float *out, size_t frames)
+    {
+        const bool sweep = m_spec.type == SignalType::Sweep;
+        alignas(32) float samples[kBlock];
+        while (frames > 0)
+        {
+            const size_t count = std::min(frames, kBlock);
+            const size_t padded = (count + 7) & ~size_t(7);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                m_cycles[i] = static_cast<float>(m_phase);
+                m_phase += m_increment;
+                if (m_phase >= 0.5)
+                    m_phase -= 1.0;
+                if (!sweep)
+                    continue;
+                m_increment *= m_sweepGrowth;
+                if (++m_position == m_period)
+                {
+                    m_position = 0;
+                    m_phase = 0.0;
+                    m_increment = m_startIncrement;
+                }
+            }
+            std::fill(m_cycles + count, m_cycles + padded, 0.0f);
+
+            m_kernels->sine(samples, m_cycles, m_gain, padded);
+            std::memcpy(out, samples, count * sizeof(float));
+            out += count;
+            frames -= count;
+        }
+    }
+
+    uint32_t SignalGenerator::NextRandom()
+    {
+        uint32_t x = m_random;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        m_random = x;
+        return x;
+    }
+
+    void SignalGenerator::RenderNoise(float *out, size_t frames)
+    {
+        const bool pink = m_spec.type == SignalType::PinkNoise;
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const float white = static_cast<float>(static_cast<int32_t>(NextRandom())) * (1.0f / 2147483648.0f);
+            out[i] = m_gain * (pink ? PinkStep(m_pink, white) : white);
+        }
+    }
+
+    void SignalGenerator::RenderClicks(float *out, size_t frames)
+    {
+        std::fill(out, out + frames, 0.0f);
+        size_t i = 0;
+        while (i < frames)
+        {
+            if (m_position == 0)
+                out[i] = m_gain;
+            const size_t step = static_cast<size_t>(std::min<uint64_t>(m_period - m_position, frames - i));
+            i += step;
+            m_position = (m_position + step) % m_period;
+        }
+    }
+}
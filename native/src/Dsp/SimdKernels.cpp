@@ -0,0 +1,429 @@
+#include "Dsp/SimdKernels.h"
+
+#include <cmath>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DSP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2/FMA instructions inside functions that opt in; MSVC
+// accepts the intrinsics anywhere. Either way they only run after the CPUID check.
+#if defined(DSP_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DSP_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define DSP_TARGET_AVX2
+#endif
+
+namespace Dsp
+{
+    namespace
+    {
+        // Taylor coefficients of sin(2πr) in powers of r, for |r| <= 1/4 (|2πr| <= π/2).
+        // The first omitted term is below 6e-8.
+        constexpr float kSin1 = 6.28318531f;
+        constexpr float kSin3 = -41.3417022f;
+        constexpr float kSin5 = 81.6052493f;
+        constexpr float kSin7 = -76.7058597f;
+        constexpr float kSin9 = 42.0586940f;
+        constexpr float kSin11 = -15.0946426f;
+
+#if defined(DSP_X86)
+        /// Index of the lowest set bit of a non-zero mask.
+        inline int CountTrailingZeros(unsigned mask)
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+#endif
+
+        float DotScalar(const float *a, const float *b, size_t count)
+        {
+            // Four accumulators keep the dependency chain short without SIMD
+            float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+            for (size_t i = 0; i < count; i += 4)
+            {
+                s0 += a[i] * b[i];
+                s1 += a[i + 1] * b[i + 1];
+                s2 += a[i + 2] * b[i + 2];
+                s3 += a[i + 3] * b[i + 3];
+            }
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        void LerpScalar(float *out, const float *a, const float *b, float t, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = a[i] + t * (b[i] - a[i]);
+        }
+
+        void SineScalar(float *out, const float *cycles, float gain, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                // sin(π - x) = sin(x) folds the half period into a quarter
+                const float r = cycles[i];
+                const float a = std::fabs(r);
+                const float q = std::copysign(std::fmin(a, 0.5f - a), r);
+                const float q2 = q * q;
+                const float p = kSin1 + q2 * (kSin3 + q2 * (kSin5 + q2 * (kSin7 + q2 * (kSin9 + q2 * kSin11))));
+                out[i] = gain * q * p;
+            }
+        }
+
+        void ButterflyScalar(float *re0, float *im0, float *re1, float *im1, const float *wRe, const float *wIm,
+                             size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float vr = re1[i] * wRe[i] - im1[i] * wIm[i];
+                const float vi = re1[i] * wIm[i] + im1[i] * wRe[i];
+                re1[i] = re0[i] - vr;
+                im1[i] = im0[i] - vi;
+                re0[i] += vr;
+                im0[i] += vi;
+            }
+        }
+
+        void MultiplyConjugateScalar(float *outRe, float *outIm, const float *aRe, const float *aIm, const float *bRe,
+                                     const float *bIm, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float re = aRe[i] * bRe[i] + aIm[i] * bIm[i];
+                const float im = aIm[i] * bRe[i] - aRe[i] * bIm[i];
+                outRe[i] = re;
+                outIm[i] = im;
+            }
+        }
+
+        size_t PeakScalar(const float *x, size_t count)
+        {
+            size_t best = 0;
+            float bestValue = -1.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float value = std::fabs(x[i]);
+                if (value > bestValue)
+                {
+                    best = i;
+                    bestValue = value;
+                }
+            }
+            return best;
+        }
+
+        void MixAddScalar(float *out, const float *in, float gain, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] += gain * in[i];
+        }
+
+#if defined(DSP_X86)
+        float DotSse(const float *a, const float *b, size_t count)
+        {
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            for (size_t i = 0; i < count; i += 8)
+            {
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+            }
+            __m128 sum = _mm_add_ps(acc0, acc1);
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+            return _mm_cvtss_f32(sum);
+        }
+
+        void LerpSse(float *out, const float *a, const float *b, float t, size_t count)
+        {
+            const __m128 vt = _mm_set1_ps(t);
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const __m128 va = _mm_loadu_ps(a + i);
+                const __m128 vb = _mm_loadu_ps(b + i);
+                _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(vt, _mm_sub_ps(vb, va))));
+            }
+        }
+
+        void MixAddSse(float *out, const float *in, float gain, size_t count)
+        {
+            const __m128 vg = _mm_set1_ps(gain);
+            for (size_t i = 0; i < count; i += 4)
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(vg, _mm_loadu_ps(in + i))));
+        }
+
+        void SineSse(float *out, const float *cycles, float gain, size_t count)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 vgain = _mm_set1_ps(gain);
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const __m128 r = _mm_loadu_ps(cycles + i);
+                const __m128 sign = _mm_and_ps(r, signMask);
+                const __m128 a = _mm_andnot_ps(signMask, r);
+                const __m128 q = _mm_or_ps(_mm_min_ps(a, _mm_sub_ps(half, a)), sign);
+                const __m128 q2 = _mm_mul_ps(q, q);
+                __m128 p = _mm_add_ps(_mm_set1_ps(kSin9), _mm_mul_ps(q2, _mm_set1_ps(kSin11)));
+                p = _mm_add_ps(_mm_set1_ps(kSin7), _mm_mul_ps(q2, p));
+                p = _mm_add_ps(_mm_set1_ps(kSin5), _mm_mul_ps(q2, p));
+                p = _mm_add_ps(_mm_set1_ps(kSin3), _mm_mul_ps(q2, p));
+                p = _mm_add_ps(_mm_set1_ps(kSin1), _mm_mul_ps(q2, p));
+                _mm_storeu_ps(out + i, _mm_mul_ps(vgain, _mm_mul_ps(q, p)));
+            }
+        }
+
+        void ButterflySse(float *re0, float *im0, float *re1, float *im1, const float *wRe, const float *wIm,
+                          size_t count)
+        {
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const __m128 xr = _mm_loadu_ps(re1 + i);
+                const __m128 xi = _mm_loadu_ps(im1 + i);
+                const __m128 wr = _mm_loadu_ps(wRe + i);
+                const __m128 wi = _mm_loadu_ps(wIm + i);
+                const __m128 vr = _mm_sub_ps(_mm_mul_ps(xr, wr), _mm_mul_ps(xi, wi));
+                const __m128 vi = _mm_add_ps(_mm_mul_ps(xr, wi), _mm_mul_ps(xi, wr));
+                const __m128 ur = _mm_loadu_ps(re0 + i);
+                const __m128 ui = _mm_loadu_ps(im0 + i);
+                _mm_storeu_ps(re1 + i, _mm_sub_ps(ur, vr));
+                _mm_storeu_ps(im1 + i, _mm_sub_ps(ui, vi));
+                _mm_storeu_ps(re0 + i, _mm_add_ps(ur, vr));
+                _mm_storeu_ps(im0 + i, _mm_add_ps(ui, vi));
+            }
+        }
+
+        void MultiplyConjugateSse(float *outRe, float *outIm, const float *aRe, const float *aIm, const float *bRe,
+                                  const float *bIm, size_t count)
+        {
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const __m128 ar = _mm_loadu_ps(aRe + i);
+                const __m128 ai = _mm_loadu_ps(aIm + i);
+                const __m128 br = _mm_loadu_ps(bRe + i);
+                const __m128 bi = _mm_loadu_ps(bIm + i);
+                _mm_storeu_ps(outRe + i, _mm_add_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi)));
+                _mm_storeu_ps(outIm + i, _mm_sub_ps(_mm_mul_ps(ai, br), _mm_mul_ps(ar, bi)));
+            }
+        }
+
+        size_t PeakSse(const float *x, size_t count)
+        {
+            // First pass finds the largest magnitude, the second where it first occurs
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            __m128 best = _mm_setzero_ps();
+            for (size_t i = 0; i < count; i += 4)
+                best = _mm_max_ps(best, _mm_andnot_ps(signMask, _mm_loadu_ps(x + i)));
+            best = _mm_max_ps(best, _mm_movehl_ps(best, best));
+            best = _mm_max_ps(best, _mm_shuffle_ps(best, best, 1));
+            best = _mm_shuffle_ps(best, best, 0);
+
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_andnot_ps(signMask, _mm_loadu_ps(x + i)), best));
+                if (mask)
+                    return i + static_cast<size_t>(CountTrailingZeros(static_cast<unsigned>(mask)));
+            }
+            return 0;
+        }
+
+        DSP_TARGET_AVX2 float DotAvx2(const float *a, const float *b, size_t count)
+        {
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+            }
+            if (i < count)
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+
+            const __m256 acc = _mm256_add_ps(acc0, acc1);
+            __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+            return _mm_cvtss_f32(sum);
+        }
+
+        DSP_TARGET_AVX2 void LerpAvx2(float *out, const float *a, const float *b, float t, size_t count)
+        {
+            const __m256 vt = _mm256_set1_ps(t);
+            for (size_t i = 0; i < count; i += 8)
+            {
+                const __m256 va = _mm256_loadu_ps(a + i);
+                const __m256 vb = _mm256_loadu_ps(b + i);
+                _mm256_storeu_ps(out + i, _mm256_fmadd_ps(vt, _mm256_sub_ps(vb, va), va));
+            }
+        }
+
+        DSP_TARGET_AVX2 void MixAddAvx2(float *out, const float *in, float gain, size_t count)
+        {
+            const __m256 vg = _mm256_set1_ps(gain);
+            for (size_t i = 0; i < count; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_fmadd_ps(vg, _mm256_loadu_ps(in + i), _mm256_loadu_ps(out + i)));
+        }
+
+        DSP_TARGET_AVX2 void SineAvx2(float *out, const float *cycles, float gain, size_t count)
+        {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 vgain = _mm256_set1_ps(gain);
+            for (size_t i = 0; i < count; i += 8)
+            {
+                const __m256 r = _mm256_loadu_ps(cycles + i);
+                const __m256 sign = _mm256_and_ps(r, signMask);
+                const __m256 a = _mm256_andnot_ps(signMask, r);
+                const __m256 q = _mm256_or_ps(_mm256_min_ps(a, _mm256_sub_ps(half, a)), sign);
+                const __m256 q2 = _mm256_mul_ps(q, q);
+                __m256 p = _mm256_fmadd_ps(q2, _mm256_set1_ps(kSin11), _mm256_set1_ps(kSin9));
+                p = _mm256_fmadd_ps(q2, p, _mm256_set1_ps(kSin7));
+                p = _mm256_fmadd_ps(q2, p, _mm256_set1_ps(kSin5));
+                p = _mm256_fmadd_ps(q2, p, _mm256_set1_ps(kSin3));
+                p = _mm256_fmadd_ps(q2, p, _mm256_set1_ps(kSin1));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(vgain, _mm256_mul_ps(q, p)));
+            }
+        }
+
+        DSP_TARGET_AVX2 void ButterflyAvx2(float *re0, float *im0, float *re1, float *im1, const float *wRe,
+                                           const float *wIm, size_t count)
+        {
+            for (size_t i = 0; i < count; i += 8)
+            {
+                const __m256 xr = _mm256_loadu_ps(re1 + i);
+                const __m256 xi = _mm256_loadu_ps(im1 + i);
+                const __m256 wr = _mm256_loadu_ps(wRe + i);
+                const __m256 wi = _mm256_loadu_ps(wIm + i);
+                const __m256 vr = _mm256_fmsub_ps(xr, wr, _mm256_mul_ps(xi, wi));
+                const __m256 vi = _mm256_fmadd_ps(xr, wi, _mm256_mul_ps(xi, wr));
+                const __m256 ur = _mm256_loadu_ps(re0 + i);
+                const __m256 ui = _mm256_loadu_ps(im0 + i);
+                _mm256_storeu_ps(re1 + i, _mm256_sub_ps(ur, vr));
+                _mm256_storeu_ps(im1 + i, _mm256_sub_ps(ui, vi));
+                _mm256_storeu_ps(re0 + i, _mm256_add_ps(ur, vr));
+                _mm256_storeu_ps(im0 + i, _mm256_add_ps(ui, vi));
+            }
+        }
+
+        DSP_TARGET_AVX2 void MultiplyConjugateAvx2(float *outRe, float *outIm, const float *aRe, const float *aIm,
+                                                   const float *bRe, const float *bIm, size_t count)
+        {
+            for (size_t i = 0; i < count; i += 8)
+            {
+                const __m256 ar = _mm256_loadu_ps(aRe + i);
+                const __m256 ai = _mm256_loadu_ps(aIm + i);
+                const __m256 br = _mm256_loadu_ps(bRe + i);
+                const __m256 bi = _mm256_loadu_ps(bIm + i);
+                _mm256_storeu_ps(outRe + i, _mm256_fmadd_ps(ar, br, _mm256_mul_ps(ai, bi)));
+                _mm256_storeu_ps(outIm + i, _mm256_fmsub_ps(ai, br, _mm256_mul_ps(ar, bi)));
+            }
+        }
+
+        DSP_TARGET_AVX2 size_t PeakAvx2(const float *x, size_t count)
+        {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            __m256 best0 = _mm256_setzero_ps();
+            __m256 best1 = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                best0 = _mm256_max_ps(best0, _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + i)));
+                best1 = _mm256_max_ps(best1, _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + i + 8)));
+            }
+            if (i < count)
+                best0 = _mm256_max_ps(best0, _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + i)));
+
+            const __m256 both = _mm256_max_ps(best0, best1);
+            __m128 best = _mm_max_ps(_mm256_castps256_ps128(both), _mm256_extractf128_ps(both, 1));
+            best = _mm_max_ps(best, _mm_movehl_ps(best, best));
+            best = _mm_max_ps(best, _mm_shuffle_ps(best, best, 1));
+            const __m256 target = _mm256_set1_ps(_mm_cvtss_f32(best));
+
+            for (i = 0; i < count; i += 8)
+            {
+                const __m256 value = _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + i));
+                const int mask = _mm256_movemask_ps(_mm256_cmp_ps(value, target, _CMP_EQ_OQ));
+                if (mask)
+                    return i + static_cast<size_t>(CountTrailingZeros(static_cast<unsigned>(mask)));
+            }
+            return 0;
+        }
+
+        /**
+         * @brief True if the CPU and OS support AVX2 and FMA (including saved YMM state).
+         */
+        bool CpuHasAvx2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuid(info, 1);
+            const bool fma = (info[2] & (1 << 12)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6)
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+
+        const SimdKernels kSse{SimdLevel::Sse, "sse", DotSse, LerpSse, SineSse, ButterflySse,
+                                MultiplyConjugateSse, PeakSse, MixAddSse};
+        const SimdKernels kAvx2{SimdLevel::Avx2, "avx2", DotAvx2, LerpAvx2, SineAvx2, ButterflyAvx2,
+                                 MultiplyConjugateAvx2, PeakAvx2, MixAddAvx2};
+#endif
+
+        const SimdKernels kScalar{SimdLevel::Scalar, "scalar", DotScalar, LerpScalar, SineScalar, ButterflyScalar,
+                                  MultiplyConjugateScalar, PeakScalar, MixAddScalar};
+    }
+
+    const SimdKernels *KernelsFor(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::Scalar:
+            return &kScalar;
+#if defined(DSP_X86)
+        case SimdLevel::Sse:
+            return &kSse; // Baseline on every x86-64 CPU
+        case SimdLevel::Avx2:
+        {
+            static const bool supported = CpuHasAvx2();
+            return supported ? &kAvx2 : nullptr;
+        }
+#endif
+        default:
+            return nullptr;
+        }
+    }
+
+    const SimdKernels &ActiveKernels()
+    {
+        static const SimdKernels &active = *[]()
+        {
+            for (SimdLevel level : {SimdLevel::Avx2, SimdLevel::Sse})
+            {
+                if (const SimdKernels *kernels = KernelsFor(level))
+                    return kernels;
+            }
+            return &kScalar;
+        }();
+        return active;
+    }
+}
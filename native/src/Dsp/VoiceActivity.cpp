@@ -0,0 +1,181 @@
+#include "Dsp/VoiceActivity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kTargetRate = 16000.0;
+        constexpr double kBandLow = 300.0;   ///< Speech band used for level and flatness, Hz.
+        constexpr double kBandHigh = 4000.0;
+        constexpr float kDcPole = 0.995f;    ///< DC blocker pole (about 13 Hz at 16 kHz).
+        constexpr float kFloorFall = 0.5f;   ///< Share of a drop below the floor taken per frame.
+        constexpr float kFloorMarginDb = 10.0f; ///< The floor never sits further below minLevelDb.
+        constexpr float kNoiseRiseFactor = 10.0f; ///< Floor climb speed-up under noise-like frames.
+        constexpr float kEnergySlopeDb = 1.5f;
+        constexpr float kFlatnessWeight = 20.0f;
+        constexpr float kCrossingWeight = 8.0f;
+        constexpr float kSilenceDb = -120.0f;
+
+        float Logistic(float x)
+        {
+            return 1.0f / (1.0f + std::exp(-x));
+        }
+    }
+
+    VoiceActivityDetector::VoiceActivityDetector(uint32_t sampleRate, unsigned channels, const VoiceActivityOptions &options)
+        : m_channels(channels),
+          m_decimation(std::max(1u, static_cast<unsigned>(std::lround(sampleRate / kTargetRate)))),
+          m_analysisRate(static_cast<double>(sampleRate) / m_decimation),
+          m_options(options),
+          m_fft(kFrame),
+          m_window(kFrame),
+          m_frame(kFrame),
+          m_re(kFrame),
+          m_im(kFrame)
+    {
+        if (sampleRate == 0 || channels == 0)
+            throw std::invalid_argument("[x] Voice activity needs a sample rate and channels");
+
+        // Periodic Hann window; Parseval then turns a band's power back into mean square
+        double windowEnergy = 0.0;
+        for (size_t i = 0; i < kFrame; ++i)
+        {
+            m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / kFrame));
+            windowEnergy += double(m_window[i]) * m_window[i];
+        }
+        // One-sided band power -> mean square, relative to a full-scale sine (0 dBFS)
+        m_levelScale = static_cast<float>(2.0 * 2.0 / (kFrame * windowEnergy));
+
+        const double binHz = m_analysisRate / kFrame;
+        m_firstBin = std::max<size_t>(1, static_cast<size_t>(std::ceil(kBandLow / binHz)));
+        m_endBin = std::min<size_t>(kFrame / 2, static_cast<size_t>(kBandHigh / binHz) + 1);
+
+        const double frameSeconds = kFrame / m_analysisRate;
+        m_floorRise = static_cast<float>(options.floorRiseDbPerSecond * frameSeconds);
+        m_attack = options.attackMs > 0.0 ? static_cast<float>(1.0 - std::exp(-frameSeconds * 1000.0 / options.attackMs)) : 1.0f;
+        m_release = options.releaseMs > 0.0 ? static_cast<float>(std::exp(-frameSeconds * 1000.0 / options.releaseMs)) : 0.0f;
+        m_hangoverFrames = static_cast<unsigned>(std::lround(options.hangoverMs / (frameSeconds * 1000.0)));
+    }
+
+    void VoiceActivityDetector::Reset()
+    {
+        m_fill = 0;
+        m_sum = 0.0f;
+        m_summed = 0;
+        m_dcIn = 0.0f;
+        m_dcOut = 0.0f;
+        m_features = {};
+        m_floorValid = false;
+        m_hangover = 0;
+        m_probability = 0.0f;
+        m_analyzed = 0;
+    }
+
+    size_t VoiceActivityDetector::Process(const float *input, size_t frames)
+    {
+        const float mix = 1.0f / (static_cast<float>(m_channels) * m_decimation);
+        size_t analyzed = 0;
+        for (size_t f = 0; f < frames; ++f)
+        {
+            const float *frame = input + f * m_channels;
+            float sample = frame[0];
+            for (unsigned c = 1; c < m_channels; ++c)
+                sample += frame[c];
+            m_sum += sample;
+            if (++m_summed < m_decimation)
+                continue;
+
+            // Averaging decimator, then a DC blocker so offsets do not count as level
+            const float x = m_sum * mix;
+            m_sum = 0.0f;
+            m_summed = 0;
+            m_dcOut = x - m_dcIn + kDcPole * m_dcOut;
+            m_dcIn = x;
+            m_frame[m_fill] = m_dcOut;
+            if (++m_fill == kFrame)
+            {
+                Analyze();
+                m_fill = 0;
+                ++analyzed;
+            }
+        }
+        return analyzed;
+    }
+
+    /**
+     * @brief Computes the features of the full frame and moves the probability.
+     */
+    void VoiceActivityDetector::Analyze()
+    {
+        unsigned crossings = 0;
+        for (size_t i = 1; i < kFrame; ++i)
+            crossings += (m_frame[i - 1] < 0.0f) != (m_frame[i] < 0.0f);
+
+        for (size_t i = 0; i < kFrame; ++i)
+        {
+            m_re[i] = m_frame[i] * m_window[i];
+            m_im[i] = 0.0f;
+        }
+        m_fft.Forward(m_re.data(), m_im.data());
+
+        // Flatness: geometric over arithmetic mean of the band's power, tilted by +3 dB
+        // per octave so pink noise reads as flat as white noise
+        double power = 0.0;
+        double tiltedPower = 0.0;
+        double logPower = 0.0;
+        for (size_t k = m_firstBin; k < m_endBin; ++k)
+        {
+            const double bin = double(m_re[k]) * m_re[k] + double(m_im[k]) * m_im[k] + 1e-20;
+            power += bin;
+            const double tilted = bin * k;
+            tiltedPower += tilted;
+            logPower += std::log(tilted);
+        }
+        const double bins = static_cast<double>(m_endBin - m_firstBin);
+        const double mean = tiltedPower / bins;
+
+        VoiceActivityFeatures &features = m_features;
+        features.flatness = static_cast<float>(std::min(1.0, std::exp(logPower / bins) / mean));
+        features.zeroCrossings = static_cast<float>(crossings) / (kFrame - 1);
+        features.levelDb = std::max(kSilenceDb, static_cast<float>(10.0 * std::log10(power * m_levelScale + 1e-30)));
+
+        const float spectral = Logistic(kFlatnessWeight * (static_cast<float>(m_options.flatness) - features.flatness) +
+                                        kCrossingWeight * (static_cast<float>(m_options.zeroCrossings) - features.zeroCrossings));
+
+        // Noise floor: drops quickly to quieter frames and climbs slowly under louder ones,
+        // faster when they sound like noise (so a fan switching on is learnt in seconds)
+        const float level = std::max(features.levelDb, static_cast<float>(m_options.minLevelDb) - kFloorMarginDb);
+        if (!m_floorValid)
+        {
+            features.noiseDb = level;
+            m_floorValid = true;
+        }
+        else if (level < features.noiseDb)
+            features.noiseDb += (level - features.noiseDb) * kFloorFall;
+        else
+            features.noiseDb = std::min(level, features.noiseDb + m_floorRise * (spectral < 0.5f ? kNoiseRiseFactor : 1.0f));
+
+        const float snr = features.levelDb - features.noiseDb;
+        const float energy = features.levelDb < m_options.minLevelDb
+                                 ? 0.0f
+                                 : Logistic((snr - static_cast<float>(m_options.snrDb)) / kEnergySlopeDb);
+        const float frame = energy * spectral;
+        features.frameProbability = frame;
+
+        // Rise with the attack constant; hold through the hangover; then release
+        if (frame >= m_probability)
+            m_probability += (frame - m_probability) * m_attack;
+        else if (m_hangover > 0)
+            --m_hangover;
+        else
+            m_probability = frame + (m_probability - frame) * m_release;
+        if (frame >= 0.5f && m_probability >= 0.5f)
+            m_hangover = m_hangoverFrames;
+        ++m_analyzed;
+    }
+}
@@ -0,0 +1,268 @@
+#include "Dsp/WavDecoder.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr uint16_t kFormatPcm = 0x0001;
+        constexpr uint16_t kFormatFloat = 0x0003;
+        constexpr uint16_t kFormatExtensible = 0xFFFE;
+        constexpr unsigned kMaxChannels = 32;
+        constexpr uint32_t kMaxSampleRate = 768000;
+
+        uint16_t ReadU16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+        uint32_t ReadU32(const uint8_t *p)
+        {
+            return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+
+        uint64_t ReadU64(const uint8_t *p) { return ReadU32(p) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32); }
+
+        /// Wave64 "riff" GUID; the other chunk GUIDs are a fourcc followed by kW64Suffix.
+        constexpr uint8_t kW64Riff[16] = {'r', 'i', 'f', 'f', 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+        constexpr uint8_t kW64Suffix[12] = {0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+
+        bool IsW64Guid(const uint8_t *guid, const char *fourcc)
+        {
+            return std::memcmp(guid, fourcc, 4) == 0 && std::memcmp(guid + 4, kW64Suffix, sizeof(kW64Suffix)) == 0;
+        }
+
+        /**
+         * @brief Converts @p count little-endian samples to float.
+         */
+        void ConvertSamples(const uint8_t *src, float *dst, size_t count, SampleEncoding encoding)
+        {
+            switch (encoding)
+            {
+            case SampleEncoding::Unsigned8:
+                for (size_t i = 0; i < count; ++i)
+                    dst[i] = (static_cast<int>(src[i]) - 128) * (1.0f / 128.0f);
+                break;
+            case SampleEncoding::Int16:
+                for (size_t i = 0; i < count; ++i, src += 2)
+                    dst[i] = static_cast<int16_t>(ReadU16(src)) * (1.0f / 32768.0f);
+                break;
+            case SampleEncoding::Int24:
+                for (size_t i = 0; i < count; ++i, src += 3)
+                {
+                    // Place the 24 bits at the top of an int32 so the sign extends
+                    const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(src[0]) << 8) |
+                                                               (static_cast<uint32_t>(src[1]) << 16) |
+                                                               (static_cast<uint32_t>(src[2]) << 24));
+                    dst[i] = static_cast<float>(value * (1.0 / 2147483648.0));
+                }
+                break;
+            case SampleEncoding::Int32:
+                for (size_t i = 0; i < count; ++i, src += 4)
+                    dst[i] = static_cast<float>(static_cast<int32_t>(ReadU32(src)) * (1.0 / 2147483648.0));
+                break;
+            case SampleEncoding::Float32:
+                for (size_t i = 0; i < count; ++i, src += 4)
+                {
+                    const uint32_t bits = ReadU32(src);
+                    std::memcpy(&dst[i], &bits, sizeof(float));
+                }
+                break;
+            case SampleEncoding::Float64:
+                for (size_t i = 0; i < count; ++i, src += 8)
+                {
+                    const uint64_t bits = ReadU64(src);
+                    double value = 0.0;
+                    std::memcpy(&value, &bits, sizeof(double));
+                    dst[i] = static_cast<float>(value);
+                }
+                break;
+            }
+        }
+
+        /**
+         * @brief Maps a WAVE format tag and sample width to an encoding.
+         * @return False for anything but integer PCM and IEEE float.
+         */
+        bool EncodingFor(uint16_t tag, uint16_t bits, SampleEncoding &encoding)
+        {
+            if (tag == kFormatPcm)
+            {
+                switch (bits)
+                {
+                case 8: encoding = SampleEncoding::Unsigned8; return true;
+                case 16: encoding = SampleEncoding::Int16; return true;
+                case 24: encoding = SampleEncoding::Int24; return true;
+                case 32: encoding = SampleEncoding::Int32; return true;
+                default: return false;
+                }
+            }
+            if (tag == kFormatFloat)
+            {
+                if (bits == 32)
+                    encoding = SampleEncoding::Float32;
+                else if (bits == 64)
+                    encoding = SampleEncoding::Float64;
+                else
+                    return false;
+                return true;
+            }
+            return false;
+        }
+        /**
+         * @brief Reads a "fmt " chunk body (WAVEFORMATEX or WAVEFORMATEXTENSIBLE).
+         * @throws std::runtime_error if it is truncated or not PCM / float.
+         */
+        void ParseFormat(const uint8_t *body, uint64_t chunkSize, size_t available, PcmFormat &format)
+        {
+            if (chunkSize < 16 || chunkSize > available)
+                throw std::runtime_error("[x] Truncated WAV format chunk");
+
+            uint16_t tag = ReadU16(body);
+            const uint16_t channels = ReadU16(body + 2);
+            const uint32_t rate = ReadU32(body + 4);
+            const uint16_t blockAlign = ReadU16(body + 12);
+            const uint16_t bits = ReadU16(body + 14);
+            if (tag == kFormatExtensible)
+            {
+                // The real tag is the first two bytes of the sub-format GUID
+                if (chunkSize < 40)
+                    throw std::runtime_error("[x] Truncated WAV format chunk");
+                tag = ReadU16(body + 24);
+            }
+            if (!EncodingFor(tag, bits, format.encoding))
+                throw std::runtime_error("[x] Unsupported WAV encoding (only PCM and float)");
+            if (blockAlign != channels * BytesPerSample(format.encoding))
+                throw std::runtime_error("[x] Unsupported WAV sample packing");
+            format.channels = channels;
+            format.sampleRate = rate;
+        }
+
+        /**
+         * @brief Wave64 counterpart of DecodeWav: 16-byte GUID chunk ids, 64-bit sizes
+         *        that include the 24-byte chunk header, chunks aligned to 8 bytes.
+         */
+        DecodedAudio DecodeW64(const uint8_t *data, size_t size)
+        {
+            constexpr size_t kChunkHeader = 24;
+            PcmFormat format;
+            bool haveFormat = false;
+            size_t offset = 40;
+            while (offset + kChunkHeader <= size)
+            {
+                const uint8_t *chunk = data + offset;
+                const uint64_t chunkSize = ReadU64(chunk + 16);
+                const uint8_t *body = chunk + kChunkHeader;
+                const size_t available = size - offset - kChunkHeader;
+                const uint64_t bodySize = chunkSize >= kChunkHeader ? chunkSize - kChunkHeader : 0;
+
+                if (IsW64Guid(chunk, "fmt "))
+                {
+                    ParseFormat(body, bodySize, available, format);
+                    haveFormat = true;
+                }
+                else if (IsW64Guid(chunk, "data"))
+                {
+                    if (!haveFormat)
+                        throw std::runtime_error("[x] WAV data chunk before format chunk");
+                    const size_t bytes = bodySize == 0 || bodySize > available ? available : static_cast<size_t>(bodySize);
+                    return DecodePcm(body, bytes, format);
+                }
+
+                if (chunkSize < kChunkHeader || bodySize > available)
+                    break;
+                offset += static_cast<size_t>((chunkSize + 7) & ~uint64_t(7));
+            }
+            throw std::runtime_error("[x] WAV file has no audio data");
+        }
+    }
+
+    size_t BytesPerSample(SampleEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case SampleEncoding::Unsigned8: return 1;
+        case SampleEncoding::Int16: return 2;
+        case SampleEncoding::Int24: return 3;
+        case SampleEncoding::Int32: return 4;
+        case SampleEncoding::Float32: return 4;
+        case SampleEncoding::Float64: return 8;
+        }
+        return 1;
+    }
+
+    bool IsWav(const uint8_t *data, size_t size)
+    {
+        if (size >= 40 && std::memcmp(data, kW64Riff, sizeof(kW64Riff)) == 0)
+            return IsW64Guid(data + 24, "wave");
+        return size >= 12 && (std::memcmp(data, "RIFF", 4) == 0 || std::memcmp(data, "RF64", 4) == 0) &&
+               std::memcmp(data + 8, "WAVE", 4) == 0;
+    }
+
+    DecodedAudio DecodePcm(const uint8_t *data, size_t size, const PcmFormat &format)
+    {
+        if (format.channels == 0 || format.channels > kMaxChannels)
+            throw std::runtime_error("[x] Unsupported channel count");
+        if (format.sampleRate == 0 || format.sampleRate > kMaxSampleRate)
+            throw std::runtime_error("[x] Unsupported sample rate");
+
+        const size_t frameBytes = BytesPerSample(format.encoding) * format.channels;
+        const size_t frames = size / frameBytes;
+
+        DecodedAudio audio;
+        audio.sampleRate = format.sampleRate;
+        audio.channels = format.channels;
+        audio.samples.resize(frames * format.channels);
+        ConvertSamples(data, audio.samples.data(), audio.samples.size(), format.encoding);
+        return audio;
+    }
+
+    /**
+     * @brief Walks the chunk list for "fmt " and "data"; chunks are word aligned and
+     *        unknown ones (LIST, fact, cue, ...) are skipped. In RF64 files a data size of
+     *        0xFFFFFFFF defers to the 64-bit size in the ds64 chunk.
+     */
+    DecodedAudio DecodeWav(const uint8_t *data, size_t size)
+    {
+        if (!IsWav(data, size))
+            throw std::runtime_error("[x] Not a WAV file");
+        if (size >= 40 && std::memcmp(data, kW64Riff, sizeof(kW64Riff)) == 0)
+            return DecodeW64(data, size);
+
+        const bool rf64 = std::memcmp(data, "RF64", 4) == 0;
+        uint64_t ds64DataSize = 0;
+        PcmFormat format;
+        bool haveFormat = false;
+        size_t offset = 12;
+        while (offset + 8 <= size)
+        {
+            const uint8_t *chunk = data + offset;
+            const size_t chunkSize = ReadU32(chunk + 4);
+            const uint8_t *body = chunk + 8;
+            const size_t available = size - offset - 8;
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0)
+            {
+                ParseFormat(body, chunkSize, available, format);
+                haveFormat = true;
+            }
+            else if (std::memcmp(chunk, "ds64", 4) == 0 && rf64 && chunkSize >= 16 && chunkSize <= available)
+            {
+                ds64DataSize = ReadU64(body + 8);
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0)
+            {
+                if (!haveFormat)
+                    throw std::runtime_error("[x] WAV data chunk before format chunk");
+                const uint64_t declared = rf64 && chunkSize == 0xFFFFFFFFu ? ds64DataSize : chunkSize;
+                const size_t bytes = declared == 0 || declared > available ? available : static_cast<size_t>(declared);
+                return DecodePcm(body, bytes, format);
+            }
+
+            if (chunkSize > available)
+                break;
+            offset += 8 + chunkSize + (chunkSize & 1);
+        }
+        throw std::runtime_error("[x] WAV file has no audio data");
+    }
+}
@@ -0,0 +1,236 @@
+#include "Dsp/WavEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Dsp
+{
+    namespace
+    {
+        constexpr uint16_t kFormatPcm = 0x0001;
+        constexpr uint16_t kFormatFloat = 0x0003;
+        constexpr uint16_t kFormatExtensible = 0xFFFE;
+        constexpr size_t kDs64Bytes = 28;   ///< riff size, data size, sample count (64-bit each), table length.
+        constexpr size_t kW64ChunkHeader = 24;
+
+        /// Bytes 4..15 shared by the Wave64 "wave", "fmt ", "data" and "junk" GUIDs.
+        constexpr uint8_t kW64Suffix[12] = {0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+        constexpr uint8_t kW64Riff[16] = {'r', 'i', 'f', 'f', 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+
+        /// Second half of KSDATAFORMAT_SUBTYPE_PCM / _IEEE_FLOAT after the format tag.
+        constexpr uint8_t kSubFormatSuffix[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+        void PutU16(uint8_t *p, uint16_t value)
+        {
+            p[0] = static_cast<uint8_t>(value);
+            p[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        void PutU32(uint8_t *p, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                p[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        void PutU64(uint8_t *p, uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                p[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+
+        void PutW64Guid(uint8_t *p, const char *fourcc)
+        {
+            std::memcpy(p, fourcc, 4);
+            std::memcpy(p + 4, kW64Suffix, sizeof(kW64Suffix));
+        }
+
+        /// Speaker mask for the usual layouts; 0 (unassigned) for the others.
+        uint32_t ChannelMask(unsigned channels)
+        {
+            switch (channels)
+            {
+            case 1: return 0x4;   // FC
+            case 2: return 0x3;   // FL FR
+            case 4: return 0x33;  // FL FR BL BR
+            case 6: return 0x3F;  // 5.1
+            case 8: return 0x63F; // 7.1
+            default: return 0;
+            }
+        }
+
+        /**
+         * @brief The "fmt " chunk body: WAVEFORMATEX for 8/16-bit mono or stereo PCM,
+         *        WAVEFORMATEXTENSIBLE for everything else (as Windows itself writes).
+         */
+        std::vector<uint8_t> FormatBody(const WavLayout &layout)
+        {
+            const bool isFloat = layout.encoding == SampleEncoding::Float32 || layout.encoding == SampleEncoding::Float64;
+            const uint16_t tag = isFloat ? kFormatFloat : kFormatPcm;
+            const uint16_t bits = static_cast<uint16_t>(BytesPerSample(layout.encoding) * 8);
+            const uint16_t blockAlign = static_cast<uint16_t>(BytesPerSample(layout.encoding) * layout.channels);
+            const bool extensible = isFloat || bits > 16 || layout.channels > 2;
+
+            std::vector<uint8_t> body(extensible ? 40 : 16, 0);
+            PutU16(&body[0], extensible ? kFormatExtensible : tag);
+            PutU16(&body[2], static_cast<uint16_t>(layout.channels));
+            PutU32(&body[4], layout.sampleRate);
+            PutU32(&body[8], layout.sampleRate * blockAlign);
+            PutU16(&body[12], blockAlign);
+            PutU16(&body[14], bits);
+            if (extensible)
+            {
+                PutU16(&body[16], 22);
+                PutU16(&body[18], bits);
+                PutU32(&body[20], ChannelMask(layout.channels));
+                PutU16(&body[24], tag);
+                std::memcpy(&body[26], kSubFormatSuffix, sizeof(kSubFormatSuffix));
+            }
+            return body;
+        }
+
+        std::vector<uint8_t> RiffHeader(const WavLayout &layout, uint64_t dataBytes, size_t headerBytes, bool rf64)
+        {
+            const std::vector<uint8_t> format = FormatBody(layout);
+            const size_t fmtOffset = 12 + 8 + kDs64Bytes;
+            const size_t padOffset = fmtOffset + 8 + format.size();
+            if (headerBytes < padOffset + 16)
+                throw std::runtime_error("[x] WAV header size too small");
+
+            std::vector<uint8_t> header(headerBytes, 0);
+            uint8_t *p = header.data();
+            const uint64_t riffBytes = headerBytes - 8 + dataBytes + (dataBytes & 1);
+
+            std::memcpy(p, rf64 ? "RF64" : "RIFF", 4);
+            PutU32(p + 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(riffBytes));
+            std::memcpy(p + 8, "WAVE", 4);
+
+            std::memcpy(p + 12, rf64 ? "ds64" : "JUNK", 4);
+            PutU32(p + 16, static_cast<uint32_t>(kDs64Bytes));
+            if (rf64)
+            {
+                const size_t frameBytes = BytesPerSample(layout.encoding) * layout.channels;
+                PutU64(p + 20, riffBytes);
+                PutU64(p + 28, dataBytes);
+                PutU64(p + 36, dataBytes / frameBytes);
+            }
+
+            std::memcpy(p + fmtOffset, "fmt ", 4);
+            PutU32(p + fmtOffset + 4, static_cast<uint32_t>(format.size()));
+            std::memcpy(p + fmtOffset + 8, format.data(), format.size());
+
+            std::memcpy(p + padOffset, "JUNK", 4);
+            PutU32(p + padOffset + 4, static_cast<uint32_t>(headerBytes - padOffset - 16));
+
+            std::memcpy(p + headerBytes - 8, "data", 4);
+            PutU32(p + headerBytes - 4, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(dataBytes));
+            return header;
+        }
+
+        std::vector<uint8_t> W64Header(const WavLayout &layout, uint64_t dataBytes, size_t headerBytes)
+        {
+            const std::vector<uint8_t> format = FormatBody(layout);
+            const size_t fmtOffset = 40;
+            const size_t junkOffset = fmtOffset + kW64ChunkHeader + format.size();
+            if (headerBytes < junkOffset + 2 * kW64ChunkHeader)
+                throw std::runtime_error("[x] WAV header size too small");
+
+            std::vector<uint8_t> header(headerBytes, 0);
+            uint8_t *p = header.data();
+
+            std::memcpy(p, kW64Riff, sizeof(kW64Riff));
+            PutU64(p + 16, headerBytes + ((dataBytes + 7) & ~uint64_t(7)));
+            PutW64Guid(p + 24, "wave");
+
+            PutW64Guid(p + fmtOffset, "fmt ");
+            PutU64(p + fmtOffset + 16, kW64ChunkHeader + format.size());
+            std::memcpy(p + fmtOffset + kW64ChunkHeader, format.data(), format.size());
+
+            PutW64Guid(p + junkOffset, "junk");
+            PutU64(p + junkOffset + 16, headerBytes - kW64ChunkHeader - junkOffset);
+
+            PutW64Guid(p + headerBytes - kW64ChunkHeader, "data");
+            PutU64(p + headerBytes - 8, kW64ChunkHeader + dataBytes);
+            return header;
+        }
+
+        /// Rounds half away from zero after clamping to [-scale, scale - 1].
+        template <typename Int>
+        Int Quantize(float sample, double scale)
+        {
+            const double value = std::min(std::max(sample * scale, -scale), scale - 1.0);
+            return static_cast<Int>(value < 0.0 ? value - 0.5 : value + 0.5);
+        }
+    }
+
+    bool UsesRf64(const WavLayout &layout, uint64_t dataBytes, size_t headerBytes)
+    {
+        if (layout.container == WavContainer::Rf64)
+            return true;
+        return layout.container == WavContainer::Wav &&
+               headerBytes - 8 + dataBytes + (dataBytes & 1) > 0xFFFFFFFFull;
+    }
+
+    std::vector<uint8_t> BuildWavHeader(const WavLayout &layout, uint64_t dataBytes, size_t headerBytes)
+    {
+        if (headerBytes % 8 != 0)
+            throw std::runtime_error("[x] WAV header size must be a multiple of 8");
+        if (layout.container == WavContainer::Flac)
+            throw std::runtime_error("[x] FLAC has no WAV header");
+        if (layout.container == WavContainer::W64)
+            return W64Header(layout, dataBytes, headerBytes);
+        return RiffHeader(layout, dataBytes, headerBytes, UsesRf64(layout, dataBytes, headerBytes));
+    }
+
+    void EncodeSamples(const float *src, uint8_t *dst, size_t count, SampleEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case SampleEncoding::Unsigned8:
+            for (size_t i = 0; i < count; ++i)
+                dst[i] = static_cast<uint8_t>(Quantize<int32_t>(src[i], 128.0) + 128);
+            break;
+        case SampleEncoding::Int16:
+            for (size_t i = 0; i < count; ++i, dst += 2)
+                PutU16(dst, static_cast<uint16_t>(Quantize<int32_t>(src[i], 32768.0)));
+            break;
+        case SampleEncoding::Int24:
+            for (size_t i = 0; i < count; ++i, dst += 3)
+            {
+                const uint32_t value = static_cast<uint32_t>(Quantize<int32_t>(src[i], 8388608.0));
+                dst[0] = static_cast<uint8_t>(value);
+                dst[1] = static_cast<uint8_t>(value >> 8);
+                dst[2] = static_cast<uint8_t>(value >> 16);
+            }
+            break;
+        case SampleEncoding::Int32:
+            for (size_t i = 0; i < count; ++i, dst += 4)
+                PutU32(dst, static_cast<uint32_t>(Quantize<int64_t>(src[i], 2147483648.0)));
+            break;
+        case SampleEncoding::Float32:
+            for (size_t i = 0; i < count; ++i, dst += 4)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, &src[i], sizeof(bits));
+                PutU32(dst, bits);
+            }
+            break;
+        case SampleEncoding::Float64:
+            for (size_t i = 0; i < count; ++i, dst += 8)
+            {
+                const double value = src[i];
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                PutU64(dst, bits);
+            }
+            break;
+        }
+    }
+
+    void QuantizeSamples(const float *src, int32_t *dst, size_t count, unsigned bits)
+    {
+        const double scale = static_cast<double>(uint64_t(1) << (bits - 1));
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<int32_t>(Quantize<int64_t>(src[i], scale));
+    }
+}
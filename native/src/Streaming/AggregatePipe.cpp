@@ -0,0 +1,197 @@
+#include "Streaming/AggregatePipe.h"
+#include "Streaming/PassthroughPipe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Streaming
+{
+    namespace
+    {
+        /// Upper bound on the correction a tap may apply, in ppm.
+        constexpr double kMaxCorrectionPpm = 2000.0;
+    }
+
+    AggregateSource::AggregateSource(unsigned channels, double sampleRate, double historyMs)
+        : m_channels(channels ? channels : 1),
+          m_sampleRate(sampleRate),
+          m_ring(static_cast<size_t>(std::ceil(std::max(1.0, historyMs) * sampleRate / 1000.0)) * m_channels)
+    {
+    }
+
+    /**
+     * @brief Publishes the samples first, then the timeline that makes them current.
+     */
+    void AggregateSource::Push(const float *input, size_t frames, double timeSeconds)
+    {
+        m_ring.Write(input, std::min(frames, HistoryFrames()) * m_channels);
+
+        const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_stampFrames.store(WrittenFrames(), std::memory_order_relaxed);
+        m_stampTime.store(timeSeconds, std::memory_order_relaxed);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Reads the timeline pair consistently (retrying over a concurrent Push) and
+     *        extrapolates it.
+     */
+    double AggregateSource::FramesAt(double timeSeconds) const
+    {
+        uint32_t sequence = 0;
+        uint64_t frames = 0;
+        double stamp = 0.0;
+        for (;;)
+        {
+            sequence = m_sequence.load(std::memory_order_acquire);
+            if (sequence & 1u)
+                continue;
+            frames = m_stampFrames.load(std::memory_order_relaxed);
+            stamp = m_stampTime.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == sequence)
+                break;
+        }
+        if (sequence == 0)
+            return -1.0;
+        return static_cast<double>(frames) + (timeSeconds - stamp) * m_sampleRate;
+    }
+
+    AggregateTap::AggregateTap(const AggregateSource &source, unsigned channels, double sampleRate,
+                               double targetLatencyMs, double delayMs, size_t maxRenderFrames)
+        : m_source(source),
+          m_channels(channels ? channels : 1),
+          m_sourceChannels(source.Channels()),
+          m_sourceRate(source.SampleRate()),
+          m_resampler(m_sourceChannels, m_sourceRate, sampleRate,
+                      static_cast<size_t>(std::ceil(maxRenderFrames * m_sourceRate / sampleRate * 1.01)) + 8),
+          m_controller(m_sourceRate / sampleRate, m_sourceRate, 0.0, kMaxCorrectionPpm),
+          m_delaySeconds(delayMs / 1000.0),
+          m_targetSeconds(targetLatencyMs / 1000.0)
+    {
+        // The first block after a seek also fills the filter's lookahead
+        m_inputFrames = static_cast<size_t>(std::ceil(maxRenderFrames * m_sourceRate / sampleRate * 1.01)) + 8 + m_resampler.Taps();
+        m_input.assign(m_inputFrames * m_sourceChannels, 0.0f);
+        m_resampled.assign(maxRenderFrames * m_sourceChannels, 0.0f);
+    }
+
+    void AggregateTap::SetDelay(double delayMs)
+    {
+        m_delaySeconds.store(delayMs / 1000.0, std::memory_order_relaxed);
+    }
+
+    void AggregateTap::SetTargetLatency(double targetLatencyMs)
+    {
+        m_targetSeconds.store(targetLatencyMs / 1000.0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drops the current position; the next block seeks to the right source frame.
+     */
+    void AggregateTap::Realign()
+    {
+        m_aligning = true;
+        m_aligned.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Moves the read position to the whole frame at @p sourceFrame, restarting the
+     *        converter there. The drift estimate is kept: the clocks did not change.
+     * @return False while that frame (or the block after it) is not in the ring.
+     */
+    bool AggregateTap::Seek(double sourceFrame)
+    {
+        if (sourceFrame < 0.0)
+            return false;
+
+        const uint64_t start = static_cast<uint64_t>(sourceFrame);
+        const uint64_t written = m_source.WrittenFrames();
+        if (written < start + m_resampler.Taps() || written - start > m_source.HistoryFrames())
+            return false;
+
+        m_cursor = start * m_sourceChannels;
+        m_resampler.Reset();
+        m_controller.ResetFill();
+        m_aligning = false;
+        m_aligned.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Produces one block, steering the read position onto the source frame that
+     *        must be heard when the block's first frame is.
+     *
+     * The controller's "fill" is the alignment error in source frames (positive = late)
+     * with a target of zero, so it trims the ratio until the error vanishes and its
+     * integrator settles on the endpoint's clock drift.
+     */
+    void AggregateTap::Pull(float *output, size_t frames, double timeSeconds)
+    {
+        const double elapsed = m_lastTime < 0.0 ? 0.0 : timeSeconds - m_lastTime;
+        m_lastTime = timeSeconds;
+        m_renderedFrames.fetch_add(frames, std::memory_order_relaxed);
+
+        const double delay = m_delaySeconds.load(std::memory_order_relaxed);
+        const double target = m_targetSeconds.load(std::memory_order_relaxed);
+        if (delay != m_appliedDelay || target != m_appliedTarget)
+        {
+            m_appliedDelay = delay;
+            m_appliedTarget = target;
+            Realign();
+        }
+
+        const double wanted = m_source.FramesAt(timeSeconds + delay - target);
+        if (m_aligning && !Seek(wanted))
+        {
+            std::memset(output, 0, frames * m_channels * sizeof(float));
+            return;
+        }
+
+        const double playing = static_cast<double>(m_cursor / m_sourceChannels) - m_resampler.PendingFrames();
+        m_resampler.SetRatio(m_controller.Update(wanted - playing, elapsed));
+        m_errorFrames.store(m_controller.SmoothedFill(), std::memory_order_relaxed);
+        m_correctionPpm.store(m_controller.CorrectionPpm(), std::memory_order_relaxed);
+
+        const size_t want = std::min(m_resampler.InputFramesWanted(frames), m_inputFrames);
+        const Dsp::BroadcastRing<float>::ReadResult read = m_source.Ring().Read(m_cursor, m_input.data(), want * m_sourceChannels);
+        if (read.lapped)
+        {
+            // Fell a whole ring behind (the render thread stalled): jump back in on time
+            std::memset(output, 0, frames * m_channels * sizeof(float));
+            m_laps.fetch_add(1, std::memory_order_relaxed);
+            Realign();
+            return;
+        }
+        m_resampler.Push(m_input.data(), read.count / m_sourceChannels);
+
+        const size_t produced = m_resampler.Pull(m_resampled.data(), frames);
+        MapChannels(m_resampled.data(), m_sourceChannels, output, m_channels, produced);
+        if (produced < frames)
+        {
+            // Source ran dry: pad, then seek again once it is back
+            std::memset(output + produced * m_channels, 0, (frames - produced) * m_channels * sizeof(float));
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+            Realign();
+        }
+    }
+
+    /**
+     * @brief Reads the counters; values are individually consistent, not as a set.
+     */
+    TapStats AggregateTap::Stats() const
+    {
+        TapStats stats;
+        stats.aligned = m_aligned.load(std::memory_order_relaxed);
+        stats.underruns = m_underruns.load(std::memory_order_relaxed);
+        stats.laps = m_laps.load(std::memory_order_relaxed);
+        stats.renderedFrames = m_renderedFrames.load(std::memory_order_relaxed);
+        stats.delayMs = m_delaySeconds.load(std::memory_order_relaxed) * 1000.0;
+        stats.targetMs = m_targetSeconds.load(std::memory_order_relaxed) * 1000.0;
+        stats.errorMs = m_errorFrames.load(std::memory_order_relaxed) * 1000.0 / m_sourceRate;
+        stats.correctionPpm = m_correctionPpm.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
@@ -0,0 +1,321 @@
+#include "Streaming/AggregateRenderer.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/MmcssScope.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr REFERENCE_TIME kCaptureBufferDuration = 200000; ///< 20 ms, in 100 ns units.
+        constexpr double kMarginMs = 3.0;  ///< Filter lookahead plus scheduling slack.
+        constexpr double kHistoryMs = 500.0; ///< Source audio kept beyond the shared latency.
+
+        /// QueryPerformanceCounter in seconds, the clock of IAudioCaptureClient timestamps.
+        double QpcSeconds()
+        {
+            static const double frequency = []()
+            {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return static_cast<double>(value.QuadPart);
+            }();
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            return static_cast<double>(counter.QuadPart) / frequency;
+        }
+    }
+
+    AggregateRenderer::AggregateRenderer(AggregateOptions options)
+        : m_options(std::move(options))
+    {
+        if (m_options.endpoints.empty())
+            m_options.endpoints.push_back(AggregateEndpoint());
+    }
+
+    AggregateRenderer::~AggregateRenderer()
+    {
+        Stop();
+    }
+
+    /**
+     * @brief Opens one output endpoint for event-driven rendering.
+     */
+    void AggregateRenderer::OpenOutput(Output &output, const AggregateEndpoint &endpoint)
+    {
+        output.id = ResolveEndpointId(endpoint.id, eRender);
+        OpenRenderStream(output.id, false, output.stream);
+        output.delayMs = endpoint.delayMs >= 0.0 ? endpoint.delayMs : output.stream.streamLatencyMs;
+    }
+
+    /**
+     * @brief Shortest shared latency at which @p output still finds its audio captured:
+     *        its delay and buffer, one capture period and the filter lookahead.
+     */
+    double AggregateRenderer::RequiredLatencyMs(const Output &output) const
+    {
+        const double bufferMs = 1000.0 * output.stream.bufferFrames / output.stream.sampleRate;
+        return output.delayMs + bufferMs + m_captureStream.periodMs + kMarginMs;
+    }
+
+    /**
+     * @brief Opens everything, picks the shared latency and starts the streaming threads.
+     *
+     * The shared latency is the requested one, raised to what the slowest endpoint needs.
+     */
+    void AggregateRenderer::Start()
+    {
+        if (m_running)
+            return;
+
+        m_outputs.clear();
+        try
+        {
+            OpenCaptureStream(m_options.sourceId, m_options.loopback, kCaptureBufferDuration, m_captureStream);
+            for (const AggregateEndpoint &endpoint : m_options.endpoints)
+            {
+                m_outputs.push_back(std::make_unique<Output>());
+                OpenOutput(*m_outputs.back(), endpoint);
+            }
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+
+        double latencyMs = m_options.latencyMs;
+        for (const std::unique_ptr<Output> &output : m_outputs)
+            latencyMs = std::max(latencyMs, RequiredLatencyMs(*output));
+        m_latencyMs = latencyMs;
+        m_historyMs = latencyMs + kHistoryMs;
+
+        m_source = std::make_unique<AggregateSource>(m_captureStream.channels, m_captureStream.sampleRate, m_historyMs);
+        for (const std::unique_ptr<Output> &output : m_outputs)
+            output->tap = std::make_unique<AggregateTap>(*m_source, output->stream.channels, output->stream.sampleRate, latencyMs,
+                                                         output->delayMs, output->stream.bufferFrames);
+        m_error = nullptr;
+
+        bool started = SUCCEEDED(m_captureStream.client->Start());
+        for (const std::unique_ptr<Output> &output : m_outputs)
+            started = started && SUCCEEDED(output->stream.client->Start());
+        if (!started)
+        {
+            Release();
+            throw std::runtime_error("[x] Failed to start streams");
+        }
+
+        m_running = true;
+        m_captureThread = std::thread(&AggregateRenderer::CaptureLoop, this);
+        for (const std::unique_ptr<Output> &output : m_outputs)
+        {
+            output->running = true;
+            output->thread = std::thread(&AggregateRenderer::RenderLoop, this, std::ref(*output));
+        }
+    }
+
+    /**
+     * @brief Records why the source stopped and makes every thread exit.
+     */
+    void AggregateRenderer::Fail(const char *message)
+    {
+        const char *expected = nullptr;
+        m_error.compare_exchange_strong(expected, message);
+        m_running = false;
+        if (m_captureStream.event)
+            SetEvent(m_captureStream.event);
+        for (const std::unique_ptr<Output> &output : m_outputs)
+            SetEvent(output->stream.event);
+    }
+
+    /**
+     * @brief Capture thread: publishes each packet to the shared source, stamped with the
+     *        QPC time its last frame was captured.
+     */
+    void AggregateRenderer::CaptureLoop()
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        std::vector<float> silence;
+        const DWORD pollMs = static_cast<DWORD>(std::max(1.0, m_captureStream.periodMs / 2.0));
+
+        while (m_running)
+        {
+            if (m_captureStream.event)
+                WaitForSingleObject(m_captureStream.event, 200);
+            else
+                Sleep(pollMs);
+
+            UINT32 packetFrames = 0;
+            while (m_running && SUCCEEDED(m_captureStream.capture->GetNextPacketSize(&packetFrames)) && packetFrames > 0)
+            {
+                BYTE *data = nullptr;
+                UINT32 frames = 0;
+                DWORD flags = 0;
+                UINT64 qpcPosition = 0;
+                HRESULT hr = m_captureStream.capture->GetBuffer(&data, &frames, &flags, nullptr, &qpcPosition);
+                if (FAILED(hr))
+                {
+                    Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Source device removed" : "Capture failed");
+                    return;
+                }
+
+                double endTime = QpcSeconds();
+                if (qpcPosition != 0 && !(flags & AUDCLNT_BUFFERFLAGS_TIMESTAMP_ERROR))
+                    endTime = qpcPosition * 1e-7 + static_cast<double>(frames) / m_captureStream.sampleRate;
+
+                const float *samples = reinterpret_cast<const float *>(data);
+                if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
+                {
+                    // Grows only until it covers the largest packet seen
+                    if (silence.size() < size_t(frames) * m_captureStream.channels)
+                        silence.resize(size_t(frames) * m_captureStream.channels, 0.0f);
+                    samples = silence.data();
+                }
+                m_source->Push(samples, frames, endTime);
+                m_captureStream.capture->ReleaseBuffer(frames);
+            }
+        }
+    }
+
+    /**
+     * @brief Render thread of one endpoint: on each device period, fills the free part of
+     *        its buffer. The new audio starts playing once the queued (padding) frames have.
+     */
+    void AggregateRenderer::RenderLoop(Output &output)
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        const auto fail = [&output](HRESULT hr)
+        {
+            const char *expected = nullptr;
+            output.error.compare_exchange_strong(expected, hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Output device removed" : "Render failed");
+            output.running = false;
+        };
+
+        while (m_running && output.running)
+        {
+            if (WaitForSingleObject(output.stream.event, 200) != WAIT_OBJECT_0)
+                continue;
+
+            UINT32 padding = 0;
+            HRESULT hr = output.stream.client->GetCurrentPadding(&padding);
+            if (FAILED(hr))
+                return fail(hr);
+
+            const UINT32 frames = output.stream.bufferFrames - padding;
+            if (frames == 0)
+                continue;
+
+            BYTE *data = nullptr;
+            hr = output.stream.render->GetBuffer(frames, &data);
+            if (FAILED(hr))
+                return fail(hr);
+            const double time = QpcSeconds() + static_cast<double>(padding) / output.stream.sampleRate;
+            output.tap->Pull(reinterpret_cast<float *>(data), frames, time);
+            output.stream.render->ReleaseBuffer(frames, 0);
+        }
+    }
+
+    /**
+     * @brief Updates one endpoint's delay, raising the shared latency for every endpoint
+     *        if that one could no longer keep up with it.
+     */
+    bool AggregateRenderer::SetDelay(size_t index, double delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        if (index >= m_outputs.size() || !m_source)
+            return false;
+
+        Output &output = *m_outputs[index];
+        const double previous = output.delayMs;
+        output.delayMs = delayMs >= 0.0 ? delayMs : output.stream.streamLatencyMs;
+
+        // The source only keeps kHistoryMs beyond the latency chosen at start
+        const double needed = RequiredLatencyMs(output);
+        if (needed + m_captureStream.periodMs > m_historyMs)
+        {
+            output.delayMs = previous;
+            return false;
+        }
+        if (needed > m_latencyMs)
+        {
+            m_latencyMs = needed;
+            for (const std::unique_ptr<Output> &each : m_outputs)
+                each->tap->SetTargetLatency(needed);
+        }
+        output.tap->SetDelay(output.delayMs);
+        return true;
+    }
+
+    /**
+     * @brief Joins every thread, stops the streams and releases every COM object.
+     */
+    void AggregateRenderer::Stop()
+    {
+        m_running = false;
+        if (m_captureStream.event)
+            SetEvent(m_captureStream.event);
+        for (const std::unique_ptr<Output> &output : m_outputs)
+        {
+            if (output->stream.event)
+                SetEvent(output->stream.event);
+        }
+        if (m_captureThread.joinable())
+            m_captureThread.join();
+        for (const std::unique_ptr<Output> &output : m_outputs)
+        {
+            if (output->thread.joinable())
+                output->thread.join();
+        }
+        Release();
+    }
+
+    void AggregateRenderer::Release()
+    {
+        CloseCaptureStream(m_captureStream);
+
+        for (const std::unique_ptr<Output> &output : m_outputs)
+        {
+            CloseRenderStream(output->stream);
+            output->running = false;
+        }
+    }
+
+    /**
+     * @brief Returns the source format plus every endpoint's tap counters.
+     */
+    AggregateStats AggregateRenderer::Stats() const
+    {
+        AggregateStats stats;
+        stats.sourceRate = m_captureStream.sampleRate;
+        stats.sourceChannels = m_captureStream.channels;
+        stats.running = m_running;
+        if (const char *error = m_error.load())
+            stats.error = error;
+
+        for (const std::unique_ptr<Output> &output : m_outputs)
+        {
+            AggregateEndpointStats endpoint;
+            endpoint.id = output->id;
+            if (output->tap)
+                endpoint.tap = output->tap->Stats();
+            endpoint.sampleRate = output->stream.sampleRate;
+            endpoint.channels = output->stream.channels;
+            endpoint.running = m_running && output->running;
+            if (const char *error = output->error.load())
+                endpoint.error = error;
+            stats.endpoints.push_back(std::move(endpoint));
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,234 @@
+#include "Streaming/CaptureRecorder.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/MmcssScope.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr REFERENCE_TIME kBufferDuration = 2000000; ///< 200 ms, in 100 ns units: slack for a late capture thread.
+        constexpr double kGapSeconds = 0.05;  ///< Timestamp jumps beyond this are filled with silence.
+        constexpr double kIdleSeconds = 0.2;  ///< Loopback silent for this long is filled from the clock...
+        constexpr double kIdleLagSeconds = 0.1; ///< ...up to this far behind it, so late packets still fit.
+
+        /// QueryPerformanceCounter in seconds, the clock of IAudioCaptureClient timestamps.
+        double QpcSeconds()
+        {
+            static const double frequency = []()
+            {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return static_cast<double>(value.QuadPart);
+            }();
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            return static_cast<double>(counter.QuadPart) / frequency;
+        }
+    }
+
+    CaptureRecorder::CaptureRecorder(CaptureRecorderOptions options)
+        : m_options(std::move(options))
+    {
+    }
+
+    CaptureRecorder::~CaptureRecorder()
+    {
+        Stop();
+    }
+
+    void CaptureRecorder::Start()
+    {
+        if (m_running)
+            return;
+
+        try
+        {
+            OpenCaptureStream(m_options.deviceId, m_options.loopback, kBufferDuration, m_stream);
+
+            RecordingOptions file = m_options.file;
+            file.layout.sampleRate = m_stream.sampleRate;
+            file.layout.channels = m_stream.channels;
+            m_sink = std::make_unique<RecordingSink>(std::move(file));
+            m_sink->Open();
+            m_silence.assign(size_t(m_stream.sampleRate / 10) * m_stream.channels, 0.0f);
+
+            if (FAILED(m_stream.client->Start()))
+                throw std::runtime_error("[x] Failed to start recording stream");
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+
+        m_error = nullptr;
+        m_running = true;
+        m_thread = std::thread(&CaptureRecorder::CaptureLoop, this);
+    }
+
+    void CaptureRecorder::Stop()
+    {
+        m_running = false;
+        if (m_thread.joinable())
+            m_thread.join();
+        Release();
+    }
+
+    /**
+     * @brief Stops the stream, finishes the file and releases every COM object.
+     */
+    void CaptureRecorder::Release()
+    {
+        CloseCaptureStream(m_stream);
+        if (m_sink)
+            m_sink->Close();
+    }
+
+    void CaptureRecorder::Fail(const char *message)
+    {
+        const char *expected = nullptr;
+        m_error.compare_exchange_strong(expected, message);
+        m_running = false;
+    }
+
+    /**
+     * @brief Appends @p frames of silence (a gap in loopback, or a packet flagged silent).
+     */
+    void CaptureRecorder::PushSilence(uint64_t frames)
+    {
+        const size_t chunk = m_silence.size() / m_stream.channels;
+        while (frames > 0)
+        {
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(frames, chunk));
+            m_sink->Push(m_silence.data(), count);
+            frames -= count;
+        }
+    }
+
+    /**
+     * @brief Capture thread: drains every packet into the sink. Packet timestamps keep
+     *        the file in real time: a jump is filled with silence, and in loopback a
+     *        stretch with no packets at all is filled from the clock as it happens (so
+     *        the file stays current during hours of silence) and trimmed back if audio
+     *        then turns out to have started earlier.
+     */
+    void CaptureRecorder::CaptureLoop()
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        const DWORD pollMs = static_cast<DWORD>(std::max(1.0, m_stream.periodMs / 2.0));
+        const double rate = static_cast<double>(m_stream.sampleRate);
+        double expectedStart = m_options.loopback ? QpcSeconds() : 0.0; ///< Where the next packet should begin; 0 = unknown.
+        bool filledIdle = m_options.loopback;
+
+        const auto timedPush = [this](const auto &push)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            push();
+            const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                               std::chrono::steady_clock::now() - start)
+                                                               .count());
+            if (elapsed > m_maxPushNs.load(std::memory_order_relaxed))
+                m_maxPushNs.store(elapsed, std::memory_order_relaxed);
+        };
+
+        while (m_running)
+        {
+            if (m_stream.event)
+                WaitForSingleObject(m_stream.event, 200);
+            else
+                Sleep(pollMs);
+
+            UINT32 packetFrames = 0;
+            HRESULT hr = S_OK;
+            while (m_running && SUCCEEDED(hr = m_stream.capture->GetNextPacketSize(&packetFrames)) && packetFrames > 0)
+            {
+                BYTE *data = nullptr;
+                UINT32 frames = 0;
+                DWORD flags = 0;
+                UINT64 qpcPosition = 0;
+                hr = m_stream.capture->GetBuffer(&data, &frames, &flags, nullptr, &qpcPosition);
+                if (FAILED(hr))
+                    break;
+
+                if (flags & AUDCLNT_BUFFERFLAGS_DATA_DISCONTINUITY)
+                    m_glitches.fetch_add(1, std::memory_order_relaxed);
+
+                UINT32 skip = 0;
+                uint64_t gap = 0;
+                if (qpcPosition != 0 && !(flags & AUDCLNT_BUFFERFLAGS_TIMESTAMP_ERROR))
+                {
+                    const double start = qpcPosition * 1e-7;
+                    if (expectedStart > 0.0 && start - expectedStart > kGapSeconds)
+                        gap = static_cast<uint64_t>(std::llround((start - expectedStart) * rate));
+                    else if (expectedStart > 0.0 && start < expectedStart && filledIdle)
+                        skip = static_cast<UINT32>(std::min<double>(frames, std::llround((expectedStart - start) * rate)));
+                    expectedStart = start + frames / rate;
+                    filledIdle = false;
+                }
+                else if (expectedStart > 0.0)
+                {
+                    expectedStart += frames / rate;
+                }
+
+                timedPush([&]()
+                          {
+                    if (gap > 0)
+                    {
+                        PushSilence(gap);
+                        m_gapFrames.fetch_add(gap, std::memory_order_relaxed);
+                    }
+                    if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
+                        PushSilence(frames - skip);
+                    else
+                        m_sink->Push(reinterpret_cast<const float *>(data) + size_t(skip) * m_stream.channels, frames - skip); });
+                m_stream.capture->ReleaseBuffer(frames);
+            }
+            if (FAILED(hr))
+            {
+                Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Recording device removed" : "Capture failed");
+                return;
+            }
+
+            // Nothing is playing, so loopback delivers nothing: keep the file in real time
+            if (m_options.loopback && expectedStart > 0.0)
+            {
+                const double behind = QpcSeconds() - expectedStart;
+                if (behind > kIdleSeconds)
+                {
+                    const uint64_t fill = static_cast<uint64_t>((behind - kIdleLagSeconds) * rate);
+                    timedPush([&]()
+                              { PushSilence(fill); });
+                    m_gapFrames.fetch_add(fill, std::memory_order_relaxed);
+                    expectedStart += fill / rate;
+                    filledIdle = true;
+                }
+            }
+        }
+    }
+
+    CaptureRecorderStats CaptureRecorder::Stats() const
+    {
+        CaptureRecorderStats stats;
+        if (m_sink)
+            stats.file = m_sink->Stats();
+        stats.sampleRate = m_stream.sampleRate;
+        stats.channels = m_stream.channels;
+        stats.gapFrames = m_gapFrames.load(std::memory_order_relaxed);
+        stats.glitches = m_glitches.load(std::memory_order_relaxed);
+        stats.maxPushUs = m_maxPushNs.load(std::memory_order_relaxed) / 1000.0;
+        stats.running = m_running.load();
+        if (const char *error = m_error.load())
+            stats.error = error;
+        return stats;
+    }
+}
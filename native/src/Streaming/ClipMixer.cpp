@@ -0,0 +1,388 @@
+#include "Streaming/ClipMixer.h"
+#include "Streaming/PassthroughPipe.h"
+
+#include "Dsp/PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Streaming
+{
+    namespace
+    {
+        /// Input frames fed to the resampler per step of an offline conversion.
+        constexpr size_t kConvertChunk = 4096;
+
+        size_t BufferBytes(size_t frames, unsigned channels) { return frames * channels * sizeof(float); }
+    }
+
+    /**
+     * @brief Resamples in the narrower of the two channel layouts, mapping channels
+     *        before (downmix) or after (upmix) so no work is spent on duplicates.
+     */
+    std::vector<float> ConvertClip(const ClipBuffer &source, uint32_t sampleRate, unsigned channels)
+    {
+        const unsigned work = std::min(source.channels, channels);
+        std::vector<float> mapped;
+        const float *input = source.samples.data();
+        if (work != source.channels)
+        {
+            mapped.resize(source.frames * work);
+            MapChannels(input, source.channels, mapped.data(), work, source.frames);
+            input = mapped.data();
+        }
+
+        std::vector<float> resampled;
+        if (sampleRate == source.sampleRate)
+        {
+            resampled.assign(input, input + source.frames * work);
+        }
+        else
+        {
+            const uint64_t outFrames = (static_cast<uint64_t>(source.frames) * sampleRate + source.sampleRate - 1) / source.sampleRate;
+            const double ratio = static_cast<double>(source.sampleRate) / sampleRate;
+            const size_t outBlock = std::max<size_t>(1, static_cast<size_t>(kConvertChunk / ratio));
+            Dsp::PolyphaseResampler resampler(work, source.sampleRate, sampleRate, kConvertChunk);
+            const std::vector<float> silence(kConvertChunk * work, 0.0f);
+            resampled.resize(static_cast<size_t>(outFrames) * work);
+
+            // Past the end of the clip the filter is fed silence until its tail is out
+            size_t consumed = 0;
+            size_t produced = 0;
+            while (produced < outFrames)
+            {
+                size_t wanted = std::min(resampler.InputFramesWanted(outBlock), kConvertChunk);
+                if (consumed < source.frames)
+                {
+                    const size_t pushed = resampler.Push(input + consumed * work, std::min(wanted, source.frames - consumed));
+                    consumed += pushed;
+                }
+                else
+                {
+                    resampler.Push(silence.data(), wanted);
+                }
+                produced += resampler.Pull(resampled.data() + produced * work,
+                                           std::min<size_t>(outBlock, static_cast<size_t>(outFrames) - produced));
+            }
+        }
+
+        if (work == channels)
+            return resampled;
+        const size_t frames = resampled.size() / work;
+        std::vector<float> output(frames * channels);
+        MapChannels(resampled.data(), work, output.data(), channels, frames);
+        return output;
+    }
+
+    ClipPool::ClipPool(size_t budgetBytes)
+        : m_budget(budgetBytes)
+    {
+    }
+
+    uint32_t ClipPool::Add(Dsp::DecodedAudio audio)
+    {
+        if (audio.channels == 0 || audio.sampleRate == 0 || audio.Frames() == 0)
+            throw std::runtime_error("[x] Clip has no audio");
+
+        auto buffer = std::make_unique<ClipBuffer>();
+        buffer->sampleRate = audio.sampleRate;
+        buffer->channels = audio.channels;
+        buffer->frames = audio.Frames();
+        buffer->samples = std::move(audio.samples);
+        buffer->samples.resize(buffer->frames * buffer->channels);
+        const size_t bytes = BufferBytes(buffer->frames, buffer->channels);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CollectLocked();
+        if (m_bytes + bytes > m_budget)
+            throw std::runtime_error("[x] Clip pool is full");
+
+        const uint32_t id = m_nextId++;
+        if (m_nextId == 0)
+            m_nextId = 1;
+        buffer->clipId = id;
+        m_bytes += bytes;
+        m_clips[id].push_back(std::move(buffer));
+        return id;
+    }
+
+    /**
+     * @brief Returns the clip's buffer in the given format, converting the original into
+     *        a new one (checked against the budget) if there is none yet.
+     */
+    ClipBuffer *ClipPool::FindOrConvertLocked(uint32_t id, uint32_t sampleRate, unsigned channels)
+    {
+        auto it = m_clips.find(id);
+        if (it == m_clips.end())
+            return nullptr;
+        Buffers &buffers = it->second;
+        for (const std::unique_ptr<ClipBuffer> &buffer : buffers)
+        {
+            if (buffer->sampleRate == sampleRate && buffer->channels == channels)
+                return buffer.get();
+        }
+
+        const ClipBuffer &original = *buffers.front();
+        const uint64_t frames = (static_cast<uint64_t>(original.frames) * sampleRate + original.sampleRate - 1) / original.sampleRate;
+        const size_t bytes = BufferBytes(static_cast<size_t>(frames), channels);
+        CollectLocked();
+        if (m_bytes + bytes > m_budget)
+            throw std::runtime_error("[x] Clip pool is full");
+
+        auto buffer = std::make_unique<ClipBuffer>();
+        buffer->clipId = id;
+        buffer->sampleRate = sampleRate;
+        buffer->channels = channels;
+        buffer->samples = ConvertClip(original, sampleRate, channels);
+        buffer->frames = buffer->samples.size() / channels;
+        m_bytes += BufferBytes(buffer->frames, channels);
+        buffers.push_back(std::move(buffer));
+        return buffers.back().get();
+    }
+
+    bool ClipPool::Prepare(uint32_t id, uint32_t sampleRate, unsigned channels)
+    {
+        if (sampleRate == 0 || channels == 0)
+            throw std::runtime_error("[x] Invalid output format");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return FindOrConvertLocked(id, sampleRate, channels) != nullptr;
+    }
+
+    ClipBuffer *ClipPool::Acquire(uint32_t id, uint32_t sampleRate, unsigned channels)
+    {
+        if (sampleRate == 0 || channels == 0)
+            throw std::runtime_error("[x] Invalid output format");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ClipBuffer *buffer = FindOrConvertLocked(id, sampleRate, channels);
+        if (buffer)
+            buffer->voices.fetch_add(1, std::memory_order_relaxed);
+        return buffer;
+    }
+
+    bool ClipPool::Remove(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_clips.find(id);
+        if (it == m_clips.end())
+            return false;
+        for (std::unique_ptr<ClipBuffer> &buffer : it->second)
+            m_retired.push_back(std::move(buffer));
+        m_clips.erase(it);
+        CollectLocked();
+        return true;
+    }
+
+    void ClipPool::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &entry : m_clips)
+        {
+            for (std::unique_ptr<ClipBuffer> &buffer : entry.second)
+                m_retired.push_back(std::move(buffer));
+        }
+        m_clips.clear();
+        CollectLocked();
+    }
+
+    void ClipPool::Collect()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CollectLocked();
+    }
+
+    /**
+     * @brief Frees unreferenced retired buffers. The acquire load pairs with the release
+     *        decrement of the mixer that last read the samples.
+     */
+    void ClipPool::CollectLocked()
+    {
+        for (auto it = m_retired.begin(); it != m_retired.end();)
+        {
+            if ((*it)->voices.load(std::memory_order_acquire) != 0)
+            {
+                ++it;
+                continue;
+            }
+            m_bytes -= BufferBytes((*it)->frames, (*it)->channels);
+            it = m_retired.erase(it);
+        }
+    }
+
+    double ClipPool::DurationMs(uint32_t id) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_clips.find(id);
+        if (it == m_clips.end())
+            return -1.0;
+        const ClipBuffer &original = *it->second.front();
+        return original.frames * 1000.0 / original.sampleRate;
+    }
+
+    ClipPoolStats ClipPool::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ClipPoolStats stats;
+        stats.clips = m_clips.size();
+        for (const auto &entry : m_clips)
+            stats.buffers += entry.second.size();
+        stats.retired = m_retired.size();
+        stats.buffers += m_retired.size();
+        stats.bytes = m_bytes;
+        stats.budgetBytes = m_budget;
+        return stats;
+    }
+
+    ClipMixer::ClipMixer(unsigned channels, size_t maxVoices, size_t queueCapacity, const Dsp::SimdKernels *kernels)
+        : m_channels(channels ? channels : 1),
+          m_kernels(kernels ? kernels : &Dsp::ActiveKernels()),
+          m_commands(queueCapacity ? queueCapacity : 1),
+          m_voices(maxVoices ? maxVoices : 1)
+    {
+    }
+
+    /**
+     * @brief Runs once the render thread is gone, so reading the queue here is safe.
+     */
+    ClipMixer::~ClipMixer()
+    {
+        Command command;
+        while (m_commands.Read(&command, 1) == 1)
+        {
+            if (command.type == CommandType::Play)
+                command.clip->voices.fetch_sub(1, std::memory_order_release);
+        }
+        for (Voice &voice : m_voices)
+        {
+            if (voice.clip)
+                Finish(voice);
+        }
+    }
+
+    bool ClipMixer::Play(ClipBuffer *clip, float gain)
+    {
+        const Command command{CommandType::Play, clip, gain, clip->clipId};
+        if (m_commands.Write(&command, 1) == 1)
+            return true;
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool ClipMixer::Stop(uint32_t clipId)
+    {
+        const Command command{CommandType::Stop, nullptr, 0.0f, clipId};
+        return m_commands.Write(&command, 1) == 1;
+    }
+
+    /**
+     * @brief Drops the voice's reference; the release pairs with ClipPool::Collect().
+     */
+    void ClipMixer::Finish(Voice &voice)
+    {
+        voice.clip->voices.fetch_sub(1, std::memory_order_release);
+        voice.clip = nullptr;
+    }
+
+    /**
+     * @brief Starts a voice in a free slot, or in the slot of the voice with the fewest
+     *        frames left, or stops voices.
+     */
+    void ClipMixer::Apply(const Command &command)
+    {
+        if (command.type == CommandType::Stop)
+        {
+            for (Voice &voice : m_voices)
+            {
+                if (voice.clip && (command.clipId == 0 || voice.clip->clipId == command.clipId))
+                    Finish(voice);
+            }
+            return;
+        }
+
+        if (command.clip->channels != m_channels)
+        {
+            command.clip->voices.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        Voice *slot = nullptr;
+        size_t fewest = SIZE_MAX;
+        for (Voice &voice : m_voices)
+        {
+            if (!voice.clip)
+            {
+                slot = &voice;
+                break;
+            }
+            const size_t left = voice.clip->frames - voice.position;
+            if (left < fewest)
+            {
+                fewest = left;
+                slot = &voice;
+            }
+        }
+        if (slot->clip)
+        {
+            Finish(*slot);
+            m_stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        slot->clip = command.clip;
+        slot->position = 0;
+        slot->gain = command.gain;
+        m_started.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool ClipMixer::Render(float *output, size_t frames)
+    {
+        Command command;
+        while (m_commands.Read(&command, 1) == 1)
+            Apply(command);
+
+        std::memset(output, 0, frames * m_channels * sizeof(float));
+        bool mixed = false;
+        unsigned active = 0;
+        for (Voice &voice : m_voices)
+        {
+            if (!voice.clip)
+                continue;
+
+            const size_t count = std::min(frames, voice.clip->frames - voice.position);
+            const float *source = voice.clip->samples.data() + voice.position * m_channels;
+            const size_t samples = count * m_channels;
+            const size_t body = samples & ~size_t(7); // Kernel lengths are multiples of 8
+            m_kernels->mixAdd(output, source, voice.gain, body);
+            for (size_t i = body; i < samples; ++i)
+                output[i] += voice.gain * source[i];
+            mixed = true;
+
+            voice.position += count;
+            if (voice.position >= voice.clip->frames)
+            {
+                Finish(voice);
+                m_finished.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                ++active;
+            }
+        }
+        m_active.store(active, std::memory_order_relaxed);
+        m_renderedFrames.fetch_add(frames, std::memory_order_relaxed);
+        return mixed;
+    }
+
+    /**
+     * @brief Reads the counters; values are individually consistent, not as a set.
+     */
+    ClipMixerStats ClipMixer::Stats() const
+    {
+        ClipMixerStats stats;
+        stats.started = m_started.load(std::memory_order_relaxed);
+        stats.finished = m_finished.load(std::memory_order_relaxed);
+        stats.stolen = m_stolen.load(std::memory_order_relaxed);
+        stats.rejected = m_rejected.load(std::memory_order_relaxed);
+        stats.active = m_active.load(std::memory_order_relaxed);
+        stats.renderedFrames = m_renderedFrames.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
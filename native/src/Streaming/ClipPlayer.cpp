@@ -0,0 +1,181 @@
+#include "Streaming/ClipPlayer.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/MmcssScope.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        /// Engine periods kept written ahead: one being played, one being mixed.
+        constexpr UINT32 kPeriodsAhead = 2;
+    }
+
+    ClipPlayer::ClipPlayer(std::wstring deviceId, size_t maxVoices)
+        : m_deviceId(std::move(deviceId)), m_maxVoices(maxVoices)
+    {
+    }
+
+    ClipPlayer::~ClipPlayer()
+    {
+        Close();
+    }
+
+    void ClipPlayer::Open()
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        OpenLocked();
+    }
+
+    /**
+     * @brief Opens the stream, pre-fills it with silence and starts it together with the
+     *        render thread. A stream that failed (device removed) is released and opened
+     *        again.
+     */
+    void ClipPlayer::OpenLocked()
+    {
+        if (m_stream.client && !m_error.load())
+            return;
+        Release();
+
+        try
+        {
+            OpenRenderStream(m_deviceId, true, m_stream);
+            m_aheadFrames = std::min(m_stream.bufferFrames, m_stream.periodFrames * kPeriodsAhead);
+            m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            if (!m_wakeEvent)
+                throw std::runtime_error("[x] Failed to create wake event");
+
+            m_mixer = std::make_unique<ClipMixer>(m_stream.channels, m_maxVoices);
+            BYTE *data = nullptr;
+            if (SUCCEEDED(m_stream.render->GetBuffer(m_aheadFrames, &data)))
+                m_stream.render->ReleaseBuffer(m_aheadFrames, AUDCLNT_BUFFERFLAGS_SILENT);
+            if (FAILED(m_stream.client->Start()))
+                throw std::runtime_error("[x] Failed to start render stream");
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+
+        m_error = nullptr;
+        m_closing = false;
+        m_thread = std::thread(&ClipPlayer::RenderLoop, this);
+        m_warm = true;
+    }
+
+    bool ClipPlayer::Play(ClipPool &pool, uint32_t clipId, float gain)
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        OpenLocked();
+
+        ClipBuffer *clip = pool.Acquire(clipId, m_stream.sampleRate, m_stream.channels);
+        if (!clip)
+            return false;
+        if (!m_mixer->Play(clip, gain))
+        {
+            clip->voices.fetch_sub(1, std::memory_order_release);
+            throw std::runtime_error("[x] Too many clips started at once");
+        }
+        return true;
+    }
+
+    void ClipPlayer::Stop(uint32_t clipId)
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (m_mixer)
+            m_mixer->Stop(clipId);
+    }
+
+    void ClipPlayer::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        Release();
+    }
+
+    /**
+     * @brief Records why the stream stopped; the next Play() reopens it.
+     */
+    void ClipPlayer::Fail(const char *message)
+    {
+        const char *expected = nullptr;
+        m_error.compare_exchange_strong(expected, message);
+        m_warm = false;
+    }
+
+    /**
+     * @brief Render thread: on each engine period, tops the buffer up to the write-ahead
+     *        with the mix (flagged silent while no clip plays).
+     */
+    void ClipPlayer::RenderLoop()
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        HANDLE waits[2] = {m_stream.event, m_wakeEvent};
+        while (!m_closing)
+        {
+            if (WaitForMultipleObjects(2, waits, FALSE, 200) != WAIT_OBJECT_0 || m_error.load())
+                continue;
+
+            UINT32 padding = 0;
+            HRESULT hr = m_stream.client->GetCurrentPadding(&padding);
+            if (SUCCEEDED(hr) && padding < m_aheadFrames)
+            {
+                BYTE *data = nullptr;
+                const UINT32 frames = m_aheadFrames - padding;
+                hr = m_stream.render->GetBuffer(frames, &data);
+                if (SUCCEEDED(hr))
+                {
+                    const bool audible = m_mixer->Render(reinterpret_cast<float *>(data), frames);
+                    m_stream.render->ReleaseBuffer(frames, audible ? 0 : AUDCLNT_BUFFERFLAGS_SILENT);
+                }
+            }
+            if (FAILED(hr))
+                Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Render device removed" : "Render failed");
+        }
+    }
+
+    /**
+     * @brief Joins the render thread, then releases the mixer (dropping its clip
+     *        references) and every COM object. Called with the control mutex held.
+     */
+    void ClipPlayer::Release()
+    {
+        m_warm = false;
+        m_closing = true;
+        if (m_wakeEvent)
+            SetEvent(m_wakeEvent);
+        if (m_thread.joinable())
+            m_thread.join();
+
+        CloseRenderStream(m_stream);
+        if (m_wakeEvent)
+            CloseHandle(m_wakeEvent);
+        m_wakeEvent = nullptr;
+        m_mixer.reset();
+    }
+
+    ClipPlayerStats ClipPlayer::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        ClipPlayerStats stats;
+        stats.open = m_stream.client != nullptr && !m_error.load();
+        stats.lowLatency = m_stream.lowLatency;
+        stats.sampleRate = m_stream.sampleRate;
+        stats.channels = m_stream.channels;
+        stats.periodMs = m_stream.periodMs;
+        stats.latencyMs = m_stream.sampleRate ? m_aheadFrames * 1000.0 / m_stream.sampleRate + m_stream.streamLatencyMs : 0.0;
+        if (m_mixer)
+            stats.mixer = m_mixer->Stats();
+        if (const char *error = m_error.load())
+            stats.error = error;
+        return stats;
+    }
+}
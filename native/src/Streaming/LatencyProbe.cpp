@@ -0,0 +1,358 @@
+#include "Streaming/LatencyProbe.h"
+#include "Streaming/SharedModeClient.h"
+#include "Dsp/SignalGenerator.h"
+#include "Utility/MmcssScope.h"
+#include "Utility/SafeRelease.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr REFERENCE_TIME kRenderBufferDuration = 500000;  ///< 50 ms, in 100 ns units.
+        constexpr REFERENCE_TIME kCaptureBufferDuration = 2000000; ///< 200 ms.
+        constexpr double kWarmupMs = 300.0;
+        constexpr double kPreRollMs = 100.0;      ///< Search allowance for audio recorded before submission.
+        constexpr double kStimulusSeconds = 0.25; ///< Minimum stimulus length.
+        constexpr unsigned kMaxMlsOrder = 17;
+
+        /// QueryPerformanceCounter in 100 ns units, the unit of IAudioCaptureClient timestamps.
+        int64_t Now100ns()
+        {
+            static const int64_t frequency = []()
+            {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return value.QuadPart;
+            }();
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            return static_cast<int64_t>(static_cast<double>(counter.QuadPart) * 1e7 / static_cast<double>(frequency));
+        }
+
+        std::wstring EndpointId(IMMDevice *device)
+        {
+            std::wstring id;
+            LPWSTR value = nullptr;
+            if (SUCCEEDED(device->GetId(&value)) && value)
+            {
+                id = value;
+                CoTaskMemFree(value);
+            }
+            return id;
+        }
+
+        std::vector<float> MakeStimulus(LatencyStimulus type, double sampleRate, double levelDb)
+        {
+            unsigned order = 2;
+            while (order < kMaxMlsOrder && static_cast<double>((size_t(1) << order) - 1) < kStimulusSeconds * sampleRate)
+                ++order;
+            const float peak = static_cast<float>(std::pow(10.0, levelDb / 20.0));
+            if (type == LatencyStimulus::Mls)
+                return Dsp::MaximumLengthSequence(order, peak);
+
+            // A sweep of the same length, kept below the band edge of lossy codecs
+            const size_t frames = (size_t(1) << order) - 1;
+            Dsp::SignalSpec spec;
+            spec.type = Dsp::SignalType::Sweep;
+            spec.frequency = 100.0;
+            spec.endFrequency = std::min(16000.0, 0.45 * sampleRate);
+            spec.sweepSeconds = static_cast<double>(frames) / sampleRate;
+            spec.levelDb = levelDb;
+            std::vector<float> stimulus(frames);
+            Dsp::SignalGenerator(spec, sampleRate).Render(stimulus.data(), frames);
+            return stimulus;
+        }
+    }
+
+    LatencyProbe::LatencyProbe(LatencyOptions options)
+        : m_options(std::move(options))
+    {
+        m_options.trials = std::max(1u, m_options.trials);
+        m_options.maxLatencyMs = std::max(1.0, m_options.maxLatencyMs);
+        m_options.gapMs = std::max(0.0, m_options.gapMs);
+    }
+
+    LatencyProbe::~LatencyProbe()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Opens the render stream and the capture stream (loopback of the same endpoint,
+     *        or a microphone converted to the render rate) and starts both.
+     */
+    void LatencyProbe::Open()
+    {
+        IMMDevice *renderDevice = OpenEndpoint(m_options.renderId, eRender);
+        if (!renderDevice)
+            throw std::runtime_error("[x] Render endpoint not found");
+        m_report.renderId = EndpointId(renderDevice);
+        m_report.loopback = m_options.captureId.empty();
+
+        IMMDevice *captureDevice = nullptr;
+        if (m_report.loopback)
+        {
+            captureDevice = renderDevice;
+            captureDevice->AddRef();
+        }
+        else
+        {
+            captureDevice = OpenEndpoint(m_options.captureId, eCapture);
+            if (!captureDevice)
+            {
+                SafeRelease(renderDevice);
+                throw std::runtime_error("[x] Capture endpoint not found");
+            }
+        }
+        m_report.captureId = EndpointId(captureDevice);
+
+        WAVEFORMATEX *renderFormat = nullptr;
+        WAVEFORMATEX *captureFormat = nullptr;
+        try
+        {
+            m_renderClient = ActivateClient(renderDevice, &renderFormat);
+            m_captureClient = ActivateClient(captureDevice, &captureFormat);
+        }
+        catch (...)
+        {
+            CoTaskMemFree(renderFormat);
+            SafeRelease(renderDevice);
+            SafeRelease(captureDevice);
+            throw;
+        }
+        SafeRelease(renderDevice);
+        SafeRelease(captureDevice);
+
+        m_report.sampleRate = renderFormat->nSamplesPerSec;
+        m_renderChannels = renderFormat->nChannels;
+        m_captureChannels = captureFormat->nChannels;
+
+        // A microphone running at another rate is resampled by the engine, so the
+        // stimulus and the capture share one timeline
+        DWORD captureFlags = AUDCLNT_STREAMFLAGS_LOOPBACK;
+        if (!m_report.loopback)
+        {
+            captureFlags = AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM | AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY;
+            captureFormat->nSamplesPerSec = m_report.sampleRate;
+            captureFormat->nAvgBytesPerSec = m_report.sampleRate * captureFormat->nBlockAlign;
+        }
+
+        HRESULT hr = m_renderClient->Initialize(AUDCLNT_SHAREMODE_SHARED, 0, kRenderBufferDuration, 0, renderFormat, nullptr);
+        CoTaskMemFree(renderFormat);
+        if (FAILED(hr))
+        {
+            CoTaskMemFree(captureFormat);
+            throw std::runtime_error("[x] Failed to initialize render stream");
+        }
+        hr = m_captureClient->Initialize(AUDCLNT_SHAREMODE_SHARED, captureFlags, kCaptureBufferDuration, 0, captureFormat, nullptr);
+        CoTaskMemFree(captureFormat);
+        if (FAILED(hr))
+            throw std::runtime_error("[x] Failed to initialize capture stream");
+
+        if (FAILED(m_renderClient->GetBufferSize(&m_renderBufferFrames)))
+            throw std::runtime_error("[x] Failed to get render buffer size");
+        hr = m_renderClient->GetService(__uuidof(IAudioRenderClient), (void **)&m_render);
+        if (FAILED(hr) || !m_render)
+            throw std::runtime_error("[x] Failed to get render client");
+        hr = m_captureClient->GetService(__uuidof(IAudioCaptureClient), (void **)&m_capture);
+        if (FAILED(hr) || !m_capture)
+            throw std::runtime_error("[x] Failed to get capture client");
+
+        // Loopback only produces packets while the endpoint renders, so render starts first
+        ServiceRender();
+        if (FAILED(m_renderClient->Start()) || FAILED(m_captureClient->Start()))
+            throw std::runtime_error("[x] Failed to start streams");
+    }
+
+    void LatencyProbe::Release()
+    {
+        if (m_captureClient)
+            m_captureClient->Stop();
+        if (m_renderClient)
+            m_renderClient->Stop();
+        SafeRelease(m_capture);
+        SafeRelease(m_render);
+        SafeRelease(m_captureClient);
+        SafeRelease(m_renderClient);
+    }
+
+    /**
+     * @brief Tops up the render buffer with silence, or with the stimulus once armed.
+     *        The first stimulus frame is stamped with the time it was handed to the engine.
+     */
+    void LatencyProbe::ServiceRender()
+    {
+        UINT32 padding = 0;
+        HRESULT hr = m_renderClient->GetCurrentPadding(&padding);
+        if (FAILED(hr))
+            throw std::runtime_error(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "[x] Render device removed" : "[x] Render failed");
+        const UINT32 frames = m_renderBufferFrames - padding;
+        if (frames == 0)
+            return;
+
+        BYTE *data = nullptr;
+        hr = m_render->GetBuffer(frames, &data);
+        if (FAILED(hr))
+            throw std::runtime_error(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "[x] Render device removed" : "[x] Render failed");
+
+        float *out = reinterpret_cast<float *>(data);
+        std::fill(out, out + size_t(frames) * m_renderChannels, 0.0f);
+        const bool starting = m_armed && m_stimulusPosition == 0;
+        if (m_armed)
+        {
+            const size_t count = std::min<size_t>(frames, m_stimulus.size() - m_stimulusPosition);
+            for (size_t f = 0; f < count; ++f)
+            {
+                for (uint32_t c = 0; c < m_renderChannels; ++c)
+                    out[f * m_renderChannels + c] = m_stimulus[m_stimulusPosition + f];
+            }
+            m_stimulusPosition += count;
+            m_armed = m_stimulusPosition < m_stimulus.size();
+        }
+        m_render->ReleaseBuffer(frames, 0);
+
+        if (starting)
+        {
+            m_submitTime = Now100ns();
+            m_bufferMs = 1000.0 * padding / m_report.sampleRate;
+        }
+    }
+
+    /**
+     * @brief Drains captured packets, appending a mono mix of them to the recording while
+     *        a trial is recording.
+     */
+    void LatencyProbe::ServiceCapture()
+    {
+        UINT32 packetFrames = 0;
+        while (SUCCEEDED(m_capture->GetNextPacketSize(&packetFrames)) && packetFrames > 0)
+        {
+            BYTE *data = nullptr;
+            UINT32 frames = 0;
+            DWORD flags = 0;
+            UINT64 qpcPosition = 0;
+            HRESULT hr = m_capture->GetBuffer(&data, &frames, &flags, nullptr, &qpcPosition);
+            if (FAILED(hr))
+                throw std::runtime_error(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "[x] Capture device removed" : "[x] Capture failed");
+
+            if (m_recording && m_recordedFrames < m_recorded.size())
+            {
+                if (m_recordedFrames == 0)
+                    m_recordStartTime = static_cast<int64_t>(qpcPosition);
+                else if (flags & AUDCLNT_BUFFERFLAGS_DATA_DISCONTINUITY)
+                    m_glitched = true;
+
+                const size_t count = std::min<size_t>(frames, m_recorded.size() - m_recordedFrames);
+                const float *in = reinterpret_cast<const float *>(data);
+                for (size_t f = 0; f < count; ++f)
+                {
+                    float sum = 0.0f;
+                    if (!(flags & AUDCLNT_BUFFERFLAGS_SILENT))
+                    {
+                        for (uint32_t c = 0; c < m_captureChannels; ++c)
+                            sum += in[f * m_captureChannels + c];
+                    }
+                    m_recorded[m_recordedFrames + f] = sum / static_cast<float>(m_captureChannels);
+                }
+                m_recordedFrames += count;
+            }
+            m_capture->ReleaseBuffer(frames);
+        }
+    }
+
+    /// Keeps both streams serviced for @p milliseconds.
+    void LatencyProbe::Idle(double milliseconds)
+    {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(milliseconds);
+        while (std::chrono::steady_clock::now() < until)
+        {
+            ServiceRender();
+            ServiceCapture();
+            Sleep(1);
+        }
+    }
+
+    /**
+     * @brief Records from just before the stimulus until the longest searched latency has
+     *        passed, then locates the stimulus in the recording.
+     */
+    LatencyTrial LatencyProbe::RunTrial(Dsp::DelayEstimator &estimator)
+    {
+        m_recorded.assign(estimator.CaptureFrames(), 0.0f);
+        m_recordedFrames = 0;
+        m_stimulusPosition = 0;
+        m_glitched = false;
+        m_armed = false;
+        m_recording = true;
+
+        const double sampleRate = m_report.sampleRate;
+        const double expectedMs = 1000.0 * m_recorded.size() / sampleRate;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(2.0 * expectedMs + 1000.0);
+        bool submitted = false;
+        while (m_recordedFrames < m_recorded.size())
+        {
+            ServiceCapture();
+            // Submit once the recording has started, so the stimulus cannot predate it
+            if (!submitted && m_recordedFrames > 0)
+            {
+                m_armed = true;
+                submitted = true;
+            }
+            ServiceRender();
+            if (std::chrono::steady_clock::now() > deadline)
+                break;
+            Sleep(1);
+        }
+        m_recording = false;
+        m_armed = false;
+
+        LatencyTrial trial;
+        trial.glitched = m_glitched;
+        if (!submitted || m_stimulusPosition == 0)
+            return trial;
+
+        const Dsp::DelayEstimate estimate = estimator.Estimate(m_recorded.data(), m_recordedFrames);
+        trial.found = estimate.found;
+        trial.correlation = estimate.correlation;
+        trial.prominence = estimate.prominence;
+        if (estimate.found)
+        {
+            const double captured = static_cast<double>(m_recordStartTime) + estimate.lagFrames * 1e7 / sampleRate;
+            trial.latencyMs = (captured - static_cast<double>(m_submitTime)) / 1e4;
+            trial.bufferMs = m_bufferMs;
+        }
+        return trial;
+    }
+
+    LatencyReport LatencyProbe::Run()
+    {
+        MmcssScope mmcss;
+        Open();
+
+        m_stimulus = MakeStimulus(m_options.stimulus, m_report.sampleRate, m_options.levelDb);
+        m_report.stimulusFrames = m_stimulus.size();
+        const size_t maxLag = static_cast<size_t>((m_options.maxLatencyMs + kPreRollMs) * m_report.sampleRate / 1000.0);
+        Dsp::DelayEstimator estimator(m_stimulus.data(), m_stimulus.size(), maxLag);
+
+        Idle(kWarmupMs);
+        std::vector<double> latencies;
+        for (unsigned t = 0; t < m_options.trials; ++t)
+        {
+            m_report.trials.push_back(RunTrial(estimator));
+            if (m_report.trials.back().found)
+                latencies.push_back(m_report.trials.back().latencyMs);
+            Idle(m_options.gapMs);
+        }
+        Release();
+
+        m_report.stats = Dsp::SummarizeDelays(std::move(latencies));
+        return m_report;
+    }
+}
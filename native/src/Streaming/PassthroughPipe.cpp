@@ -0,0 +1,136 @@
+#include "Streaming/PassthroughPipe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Streaming
+{
+    namespace
+    {
+        /// Upper bound on the correction the controller may apply, in ppm.
+        constexpr double kMaxCorrectionPpm = 2000.0;
+    }
+
+    void MapChannels(const float *in, unsigned inChannels, float *out, unsigned outChannels, size_t frames)
+    {
+        for (size_t f = 0; f < frames; ++f, in += inChannels, out += outChannels)
+        {
+            if (outChannels == 1)
+            {
+                float sum = 0.0f;
+                for (unsigned c = 0; c < inChannels; ++c)
+                    sum += in[c];
+                out[0] = sum / static_cast<float>(inChannels);
+                continue;
+            }
+            for (unsigned c = 0; c < outChannels; ++c)
+                out[c] = inChannels == 1 ? in[0] : (c < inChannels ? in[c] : 0.0f);
+        }
+    }
+
+    PassthroughPipe::PassthroughPipe(unsigned channels, double captureRate, double renderRate,
+                                     double targetLatencyMs, size_t maxRenderFrames)
+        : m_channels(channels ? channels : 1),
+          m_targetFrames(std::max(1.0, targetLatencyMs * captureRate / 1000.0)),
+          m_captureRate(captureRate),
+          // Room for the target plus generous headroom for bursty capture periods
+          m_ring((static_cast<size_t>(m_targetFrames) * 4 + maxRenderFrames * 4) * m_channels),
+          m_resampler(m_channels, captureRate, renderRate,
+                      static_cast<size_t>(std::ceil(maxRenderFrames * captureRate / renderRate * 1.01)) + 8),
+          m_controller(captureRate / renderRate, captureRate, m_targetFrames, kMaxCorrectionPpm)
+    {
+        // The first block after a reset also fills the filter's lookahead
+        m_scratchFrames = static_cast<size_t>(std::ceil(maxRenderFrames * captureRate / renderRate * 1.01)) + 8 + m_resampler.Taps();
+        m_scratch.assign(m_scratchFrames * m_channels, 0.0f);
+    }
+
+    /**
+     * @brief Queues captured frames; anything that does not fit is dropped and counted.
+     *
+     * The ring capacity is a power of two and so, for 3- or 6-channel layouts, not a
+     * whole number of frames: writes are clamped to whole frames so a partial frame is
+     * never queued and the interleaving cannot rotate.
+     */
+    void PassthroughPipe::PushCapture(const float *input, size_t frames, double timeSeconds)
+    {
+        const size_t accepted = std::min(frames, m_ring.AvailableToWrite() / m_channels);
+        if (accepted > 0)
+            m_ring.Write(input, accepted * m_channels);
+        if (accepted < frames)
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+        m_capturedFrames.fetch_add(accepted, std::memory_order_relaxed);
+        m_lastCaptureTime.store(timeSeconds, std::memory_order_release);
+    }
+
+    size_t PassthroughPipe::BufferedFrames() const
+    {
+        return m_ring.AvailableToRead() / m_channels + m_resampler.BufferedFrames();
+    }
+
+    /**
+     * @brief Buffered frames extrapolated to @p timeSeconds at the nominal capture rate.
+     */
+    double PassthroughPipe::EstimatedFill(double timeSeconds) const
+    {
+        const double sinceCapture = timeSeconds - m_lastCaptureTime.load(std::memory_order_acquire);
+        return static_cast<double>(BufferedFrames()) + std::max(0.0, sinceCapture) * m_captureRate;
+    }
+
+    /**
+     * @brief Produces one render block, resampling buffered capture audio.
+     */
+    void PassthroughPipe::PullRender(float *output, size_t frames, double timeSeconds)
+    {
+        const double elapsed = m_lastRenderTime < 0.0 ? 0.0 : timeSeconds - m_lastRenderTime;
+        m_lastRenderTime = timeSeconds;
+
+        m_renderedFrames.fetch_add(frames, std::memory_order_relaxed);
+
+        if (m_priming)
+        {
+            if (static_cast<double>(BufferedFrames()) < m_targetFrames)
+            {
+                std::memset(output, 0, frames * m_channels * sizeof(float));
+                return;
+            }
+            m_priming = false;
+        }
+
+        m_resampler.SetRatio(m_controller.Update(EstimatedFill(timeSeconds), elapsed));
+        m_fillFrames.store(m_controller.SmoothedFill(), std::memory_order_relaxed);
+        m_correctionPpm.store(m_controller.CorrectionPpm(), std::memory_order_relaxed);
+
+        const size_t wanted = std::min({m_resampler.InputFramesWanted(frames), m_scratchFrames,
+                                        m_ring.AvailableToRead() / m_channels});
+        const size_t read = m_ring.Read(m_scratch.data(), wanted * m_channels) / m_channels;
+        m_resampler.Push(m_scratch.data(), read);
+
+        const size_t produced = m_resampler.Pull(output, frames);
+        if (produced < frames)
+        {
+            // Source ran dry: pad, then wait for the ring to refill to the target
+            std::memset(output + produced * m_channels, 0, (frames - produced) * m_channels * sizeof(float));
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+            m_priming = true;
+            m_resampler.Reset();
+            m_controller.Reset();
+        }
+    }
+
+    /**
+     * @brief Reads the counters; values are individually consistent, not as a set.
+     */
+    PipeStats PassthroughPipe::Stats() const
+    {
+        PipeStats stats;
+        stats.underruns = m_underruns.load(std::memory_order_relaxed);
+        stats.overruns = m_overruns.load(std::memory_order_relaxed);
+        stats.capturedFrames = m_capturedFrames.load(std::memory_order_relaxed);
+        stats.renderedFrames = m_renderedFrames.load(std::memory_order_relaxed);
+        stats.fillMs = m_fillFrames.load(std::memory_order_relaxed) * 1000.0 / m_captureRate;
+        stats.targetMs = m_targetFrames * 1000.0 / m_captureRate;
+        stats.correctionPpm = m_correctionPpm.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
@@ -0,0 +1,206 @@
+#include "Streaming/PassthroughRouter.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/MmcssScope.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr REFERENCE_TIME kCaptureBufferDuration = 200000; ///< 20 ms, in 100 ns units.
+        constexpr double kPipeMarginMs = 2.0;
+
+        /// Seconds on the clock shared by the capture and render threads.
+        double NowSeconds()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    PassthroughRouter::PassthroughRouter(RouterOptions options)
+        : m_options(std::move(options))
+    {
+    }
+
+    PassthroughRouter::~PassthroughRouter()
+    {
+        Stop();
+    }
+
+    /**
+     * @brief Opens both endpoints, sizes the pipe and starts the streaming threads.
+     */
+    void PassthroughRouter::Start()
+    {
+        if (m_running)
+            return;
+
+        try
+        {
+            OpenCaptureStream(m_options.captureId, m_options.loopback, kCaptureBufferDuration, m_captureStream);
+            OpenRenderStream(m_options.renderId, false, m_renderStream);
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+
+        // The ring can only stay non-empty if it holds at least one period of each device
+        const double latencyMs = std::max(m_options.latencyMs, m_captureStream.periodMs + m_renderStream.periodMs + kPipeMarginMs);
+        m_pipe = std::make_unique<PassthroughPipe>(m_renderStream.channels, m_captureStream.sampleRate, m_renderStream.sampleRate, latencyMs, m_renderStream.bufferFrames);
+        m_error = nullptr;
+
+        if (FAILED(m_captureStream.client->Start()) || FAILED(m_renderStream.client->Start()))
+        {
+            Release();
+            throw std::runtime_error("[x] Failed to start streams");
+        }
+
+        m_running = true;
+        m_captureThread = std::thread(&PassthroughRouter::CaptureLoop, this);
+        m_renderThread = std::thread(&PassthroughRouter::RenderLoop, this);
+    }
+
+    /**
+     * @brief Records why streaming stopped and makes both threads exit.
+     */
+    void PassthroughRouter::Fail(const char *message)
+    {
+        const char *expected = nullptr;
+        m_error.compare_exchange_strong(expected, message);
+        m_running = false;
+        if (m_captureStream.event)
+            SetEvent(m_captureStream.event);
+        if (m_renderStream.event)
+            SetEvent(m_renderStream.event);
+    }
+
+    /**
+     * @brief Capture thread: drains packets into the pipe, remapping channels as needed.
+     */
+    void PassthroughRouter::CaptureLoop()
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        std::vector<float> mapped;
+        const DWORD pollMs = static_cast<DWORD>(std::max(1.0, m_captureStream.periodMs / 2.0));
+
+        while (m_running)
+        {
+            if (m_captureStream.event)
+                WaitForSingleObject(m_captureStream.event, 200);
+            else
+                Sleep(pollMs);
+
+            UINT32 packetFrames = 0;
+            while (m_running && SUCCEEDED(m_captureStream.capture->GetNextPacketSize(&packetFrames)) && packetFrames > 0)
+            {
+                BYTE *data = nullptr;
+                UINT32 frames = 0;
+                DWORD flags = 0;
+                HRESULT hr = m_captureStream.capture->GetBuffer(&data, &frames, &flags, nullptr, nullptr);
+                if (FAILED(hr))
+                {
+                    Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Capture device removed" : "Capture failed");
+                    return;
+                }
+
+                // Mapped size only grows until it covers the largest packet seen
+                if (mapped.size() < size_t(frames) * m_renderStream.channels)
+                    mapped.resize(size_t(frames) * m_renderStream.channels);
+                if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
+                    std::fill(mapped.begin(), mapped.begin() + size_t(frames) * m_renderStream.channels, 0.0f);
+                else
+                    MapChannels(reinterpret_cast<const float *>(data), m_captureStream.channels, mapped.data(), m_renderStream.channels, frames);
+
+                m_captureStream.capture->ReleaseBuffer(frames);
+                m_pipe->PushCapture(mapped.data(), frames, NowSeconds());
+            }
+        }
+    }
+
+    /**
+     * @brief Render thread: on each device period, fills the free part of the render buffer.
+     */
+    void PassthroughRouter::RenderLoop()
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        while (m_running)
+        {
+            if (WaitForSingleObject(m_renderStream.event, 200) != WAIT_OBJECT_0)
+                continue;
+
+            UINT32 padding = 0;
+            HRESULT hr = m_renderStream.client->GetCurrentPadding(&padding);
+            if (FAILED(hr))
+            {
+                Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Render device removed" : "Render failed");
+                return;
+            }
+
+            const UINT32 frames = m_renderStream.bufferFrames - padding;
+            if (frames == 0)
+                continue;
+
+            BYTE *data = nullptr;
+            hr = m_renderStream.render->GetBuffer(frames, &data);
+            if (FAILED(hr))
+            {
+                Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Render device removed" : "Render failed");
+                return;
+            }
+            m_pipe->PullRender(reinterpret_cast<float *>(data), frames, NowSeconds());
+            m_renderStream.render->ReleaseBuffer(frames, 0);
+        }
+    }
+
+    /**
+     * @brief Joins the threads, stops both streams and releases every COM object.
+     */
+    void PassthroughRouter::Stop()
+    {
+        m_running = false;
+        if (m_captureStream.event)
+            SetEvent(m_captureStream.event);
+        if (m_renderStream.event)
+            SetEvent(m_renderStream.event);
+        if (m_captureThread.joinable())
+            m_captureThread.join();
+        if (m_renderThread.joinable())
+            m_renderThread.join();
+        Release();
+    }
+
+    void PassthroughRouter::Release()
+    {
+        CloseCaptureStream(m_captureStream);
+        CloseRenderStream(m_renderStream);
+    }
+
+    /**
+     * @brief Returns pipe counters plus the negotiated formats.
+     */
+    RouterStats PassthroughRouter::Stats() const
+    {
+        RouterStats stats;
+        if (m_pipe)
+            stats.pipe = m_pipe->Stats();
+        stats.captureRate = m_captureStream.sampleRate;
+        stats.renderRate = m_renderStream.sampleRate;
+        stats.running = m_running;
+        if (const char *error = m_error.load())
+            stats.error = error;
+        return stats;
+    }
+}
@@ -0,0 +1,354 @@
+#include "Streaming/RecordingSink.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr size_t kBlockAlignment = 64 * 1024; ///< Block sizes are a multiple of this (and so of any sector size).
+        constexpr size_t kPageBytes = 4096;
+        constexpr size_t kScratchFrames = 1024;       ///< Frames encoded per step of Push().
+        constexpr unsigned kMaxChannels = 32;
+
+        uint64_t ElapsedNs(std::chrono::steady_clock::time_point start)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now() - start)
+                                             .count());
+        }
+    }
+
+    RecordingSink::RecordingSink(RecordingOptions options)
+        : m_options(std::move(options)),
+          m_full(std::max<size_t>(m_options.blocks, 2)),
+          m_free(std::max<size_t>(m_options.blocks, 2))
+    {
+        m_options.blocks = std::max<size_t>(m_options.blocks, 2);
+        m_options.blockBytes = std::max<size_t>(m_options.blockBytes, 1) + kBlockAlignment - 1;
+        m_options.blockBytes -= m_options.blockBytes % kBlockAlignment;
+    }
+
+    RecordingSink::~RecordingSink()
+    {
+        Close();
+    }
+
+    void RecordingSink::Open()
+    {
+        const Dsp::WavLayout &layout = m_options.layout;
+        if (layout.channels == 0 || layout.channels > kMaxChannels || layout.sampleRate == 0)
+            throw std::runtime_error("[x] Unsupported recording format");
+        if (m_thread.joinable())
+            return;
+
+        std::vector<uint8_t> header;
+        if (layout.container == Dsp::WavContainer::Flac)
+        {
+            if (layout.encoding != Dsp::SampleEncoding::Int16 && layout.encoding != Dsp::SampleEncoding::Int24)
+                throw std::runtime_error("[x] FLAC recordings must be 16 or 24-bit");
+            Dsp::FlacFormat format;
+            format.sampleRate = layout.sampleRate;
+            format.channels = layout.channels;
+            format.bitsPerSample = static_cast<unsigned>(Dsp::BytesPerSample(layout.encoding) * 8);
+            m_flac = std::make_unique<Dsp::FlacEncoder>(format, m_options.flac);
+            header = m_flac->Header();
+
+            // Blocks hold whole FLAC frames, so only the last one written may be short
+            m_frameBytes = sizeof(int32_t) * layout.channels;
+            const size_t batch = m_frameBytes * m_flac->BlockSize();
+            m_options.blockBytes = std::max<size_t>(m_options.blockBytes / batch, 1) * batch;
+        }
+        else
+        {
+            header = Dsp::BuildWavHeader(layout, 0);
+            m_frameBytes = Dsp::BytesPerSample(layout.encoding) * layout.channels;
+        }
+        m_dataOffset = header.size();
+
+        if (!m_file.Open(m_options.path))
+            throw std::runtime_error("[x] Failed to create recording file");
+        if (!m_file.WriteAt(0, header.data(), header.size()))
+        {
+            m_file.Close();
+            throw std::runtime_error("[x] Failed to write recording header");
+        }
+
+        // One allocation for every block, aligned to a page for the OS copy (or DMA)
+        const size_t bytes = m_options.blocks * m_options.blockBytes;
+        m_storage.reset(new uint8_t[bytes + kPageBytes]);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.get());
+        m_blocks = m_storage.get() + ((kPageBytes - address % kPageBytes) % kPageBytes);
+        std::memset(m_blocks, 0, bytes); // fault the pages in here, not on the capture thread
+        m_blockFill.assign(m_options.blocks, 0);
+        m_scratch.resize(kScratchFrames * m_frameBytes);
+
+        m_current = 0;
+        m_fill = 0;
+        for (uint32_t index = 1; index < m_options.blocks; ++index)
+            m_free.Write(&index, 1);
+
+        m_stopping = false;
+        m_thread = std::thread(&RecordingSink::Run, this);
+    }
+
+    size_t RecordingSink::WritableFrames() const
+    {
+        if (m_frameBytes == 0)
+            return 0;
+        const size_t current = m_current == kNoBlock ? 0 : m_options.blockBytes - m_fill;
+        return (current + m_free.AvailableToRead() * m_options.blockBytes) / m_frameBytes;
+    }
+
+    /**
+     * @brief Encodes as many frames as the free blocks hold, a scratch-sized step at a
+     *        time, and copies the bytes across block boundaries (a frame may straddle two
+     *        blocks, which keeps every block write the same aligned size).
+     */
+    size_t RecordingSink::Push(const float *samples, size_t frames)
+    {
+        if (!m_blocks)
+            return 0;
+        const size_t accepted = std::min(frames, WritableFrames());
+        if (accepted < frames)
+            m_dropped.fetch_add(frames - accepted, std::memory_order_relaxed);
+
+        const unsigned channels = m_options.layout.channels;
+        size_t done = 0;
+        while (done < accepted)
+        {
+            const size_t step = std::min(accepted - done, kScratchFrames);
+            if (m_flac)
+                Dsp::QuantizeSamples(samples + done * channels, reinterpret_cast<int32_t *>(m_scratch.data()), step * channels,
+                                     m_flac->Format().bitsPerSample);
+            else
+                Dsp::EncodeSamples(samples + done * channels, m_scratch.data(), step * channels, m_options.layout.encoding);
+
+            const uint8_t *cursor = m_scratch.data();
+            size_t left = step * m_frameBytes;
+            while (left > 0)
+            {
+                if (m_current == kNoBlock)
+                {
+                    // WritableFrames() counted this block as free
+                    m_free.Read(&m_current, 1);
+                    m_fill = 0;
+                }
+                const size_t count = std::min(left, m_options.blockBytes - m_fill);
+                std::memcpy(Block(m_current) + m_fill, cursor, count);
+                m_fill += count;
+                cursor += count;
+                left -= count;
+                if (m_fill == m_options.blockBytes)
+                    Submit();
+            }
+            done += step;
+        }
+        m_frames.fetch_add(accepted, std::memory_order_relaxed);
+        return accepted;
+    }
+
+    /**
+     * @brief Queues the current block for the I/O thread, which finds it on its next poll.
+     *        Not signalling keeps the capture thread free of system calls, and keeps it
+     *        from being preempted by the thread it would wake.
+     */
+    void RecordingSink::Submit()
+    {
+        m_blockFill[m_current] = m_fill;
+        m_full.Write(&m_current, 1);
+        m_current = kNoBlock;
+        m_fill = 0;
+    }
+
+    void RecordingSink::Close()
+    {
+        if (!m_thread.joinable())
+        {
+            m_file.Close();
+            return;
+        }
+
+        // The capture thread has stopped, so this thread may act as the producer
+        if (m_current != kNoBlock && m_fill > 0)
+            Submit();
+        {
+            std::lock_guard<std::mutex> lock(m_threadMutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        m_file.Close();
+        m_flac.reset();
+        m_blocks = nullptr;
+        m_storage.reset();
+    }
+
+    void RecordingSink::Fail(const char *message)
+    {
+        const char *expected = nullptr;
+        m_error.compare_exchange_strong(expected, message);
+    }
+
+    /**
+     * @brief I/O thread: every poll interval, writes the blocks queued since the last one
+     *        and patches the header if the patch interval has passed; on stop, drains the
+     *        queue and writes the final header.
+     */
+    void RecordingSink::Run()
+    {
+        const auto patchInterval = std::chrono::milliseconds(m_options.patchIntervalMs);
+        const auto pollInterval = std::chrono::milliseconds(std::max<uint32_t>(m_options.pollIntervalMs, 1));
+        auto lastPatch = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(m_threadMutex);
+        for (;;)
+        {
+            m_wake.wait_for(lock, pollInterval, [this]()
+                            { return m_stopping; });
+            const bool stopping = m_stopping;
+            lock.unlock();
+
+            DrainBlocks();
+            const auto now = std::chrono::steady_clock::now();
+            if (stopping)
+            {
+                PatchHeader(true, true);
+                return;
+            }
+            if (m_options.patchIntervalMs > 0 && now - lastPatch >= patchInterval)
+            {
+                PatchHeader(m_options.syncOnPatch, false);
+                lastPatch = now;
+            }
+            lock.lock();
+        }
+    }
+
+    void RecordingSink::DrainBlocks()
+    {
+        const size_t depth = m_full.AvailableToRead();
+        if (depth > m_maxQueueDepth.load(std::memory_order_relaxed))
+            m_maxQueueDepth.store(depth, std::memory_order_relaxed);
+
+        uint32_t index = 0;
+        while (m_full.Read(&index, 1) == 1)
+        {
+            const size_t bytes = m_blockFill[index];
+            const size_t frames = bytes / m_frameBytes;
+            if (m_error.load())
+            {
+                m_dropped.fetch_add(frames, std::memory_order_relaxed);
+            }
+            else if (m_flac)
+            {
+                // The block goes back as soon as it is encoded, before the disk sees it
+                m_encoded.clear();
+                m_flac->Encode(reinterpret_cast<const int32_t *>(Block(index)), frames, m_encoded);
+                m_free.Write(&index, 1);
+                index = kNoBlock;
+
+                WriteData(m_encoded.data(), m_encoded.size(), frames);
+                m_encodedFrames += frames;
+                const double pcmBytes = double(m_encodedFrames) * m_options.layout.channels * (m_flac->Format().bitsPerSample / 8);
+                m_compression.store(m_dataBytes.load(std::memory_order_relaxed) / pcmBytes);
+                if (m_flac->EncodeSeconds() > 0.0)
+                    m_encodeRealtime.store(m_encodedFrames / double(m_options.layout.sampleRate) / m_flac->EncodeSeconds());
+            }
+            else
+            {
+                WriteData(Block(index), bytes, frames);
+            }
+            if (index != kNoBlock)
+                m_free.Write(&index, 1);
+        }
+    }
+
+    /**
+     * @brief Appends @p bytes of sample data holding @p frames frames after what is written.
+     */
+    void RecordingSink::WriteData(const uint8_t *data, size_t bytes, size_t frames)
+    {
+        const uint64_t offset = m_dataOffset + m_dataBytes.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        const bool written = m_file.WriteAt(offset, data, bytes);
+        const uint64_t elapsed = ElapsedNs(start);
+
+        if (written)
+        {
+            m_dataBytes.fetch_add(bytes, std::memory_order_relaxed);
+            m_writes.fetch_add(1, std::memory_order_relaxed);
+            m_writeNs += elapsed;
+            if (elapsed > m_maxWriteNs.load(std::memory_order_relaxed))
+                m_maxWriteNs.store(elapsed, std::memory_order_relaxed);
+            if (m_writeNs > 0)
+                m_writeMBps.store(m_dataBytes.load(std::memory_order_relaxed) * 1e3 / m_writeNs);
+        }
+        else
+        {
+            Fail("Disk write failed");
+            m_dropped.fetch_add(frames, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Rewrites the header with the size written so far. The data is flushed
+     *        first, so a header on disk never claims data that is not. The final patch
+     *        also adds the pad byte(s) RIFF and Wave64 expect after the data. A FLAC
+     *        header only changes once, at the end: until then the patch just flushes.
+     */
+    void RecordingSink::PatchHeader(bool sync, bool final)
+    {
+        if (!m_file.IsOpen() || (m_error.load() && !final))
+            return;
+        const uint64_t dataBytes = m_dataBytes.load(std::memory_order_relaxed);
+        const Dsp::WavLayout &layout = m_options.layout;
+
+        if (final && !m_flac)
+        {
+            const size_t alignment = layout.container == Dsp::WavContainer::W64 ? 8 : 2;
+            const size_t pad = static_cast<size_t>((alignment - dataBytes % alignment) % alignment);
+            const uint8_t zeros[8] = {};
+            if (pad > 0)
+                m_file.WriteAt(m_dataOffset + dataBytes, zeros, pad);
+        }
+        if (sync)
+            m_file.Sync();
+        if (m_flac && !final)
+            return;
+
+        const std::vector<uint8_t> header = m_flac ? m_flac->FinalHeader() : Dsp::BuildWavHeader(layout, dataBytes);
+        if (!m_file.WriteAt(0, header.data(), header.size()))
+        {
+            Fail("Header write failed");
+            return;
+        }
+        if (final && sync)
+            m_file.Sync();
+        m_patches.fetch_add(1, std::memory_order_relaxed);
+        m_rf64.store(Dsp::UsesRf64(layout, dataBytes), std::memory_order_relaxed);
+    }
+
+    RecordingStats RecordingSink::Stats() const
+    {
+        RecordingStats stats;
+        stats.frames = m_frames.load(std::memory_order_relaxed);
+        stats.droppedFrames = m_dropped.load(std::memory_order_relaxed);
+        stats.bytesWritten = m_dataBytes.load(std::memory_order_relaxed);
+        stats.writes = m_writes.load(std::memory_order_relaxed);
+        stats.headerPatches = m_patches.load(std::memory_order_relaxed);
+        stats.queueDepth = m_full.AvailableToRead();
+        stats.maxQueueDepth = m_maxQueueDepth.load(std::memory_order_relaxed);
+        stats.blocks = m_options.blocks;
+        stats.writeMBps = m_writeMBps.load();
+        stats.maxWriteMs = m_maxWriteNs.load(std::memory_order_relaxed) / 1e6;
+        stats.rf64 = m_rf64.load(std::memory_order_relaxed);
+        stats.compression = m_compression.load();
+        stats.encodeRealtime = m_encodeRealtime.load();
+        if (const char *error = m_error.load())
+            stats.error = error;
+        return stats;
+    }
+}
@@ -0,0 +1,249 @@
+#include "Streaming/SharedModeClient.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/DeviceUtils.h"
+#include "Utility/SafeRelease.h"
+
+#include <ksmedia.h>
+
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        bool IsFloat32(const WAVEFORMATEX *format)
+        {
+            if (format->wBitsPerSample != 32)
+                return false;
+            if (format->wFormatTag == WAVE_FORMAT_IEEE_FLOAT)
+                return true;
+            return format->wFormatTag == WAVE_FORMAT_EXTENSIBLE &&
+                   reinterpret_cast<const WAVEFORMATEXTENSIBLE *>(format)->SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
+        }
+    }
+
+    IMMDevice *OpenEndpoint(const std::wstring &id, EDataFlow flow)
+    {
+        if (!id.empty())
+            return GetDeviceById(id);
+
+        IMMDeviceEnumerator *enumerator = AudioRuntime::Instance().AcquireEnumerator();
+        if (!enumerator)
+            return nullptr;
+        IMMDevice *device = nullptr;
+        enumerator->GetDefaultAudioEndpoint(flow, eConsole, &device);
+        SafeRelease(enumerator);
+        return device;
+    }
+
+    std::wstring ResolveEndpointId(const std::wstring &id, EDataFlow flow)
+    {
+        if (!id.empty())
+            return id;
+        const char *missing = flow == eCapture ? "[x] No default capture endpoint" : "[x] No default render endpoint";
+        IMMDevice *device = OpenEndpoint(id, flow);
+        if (!device)
+            throw std::runtime_error(missing);
+        std::wstring resolved;
+        LPWSTR deviceId = nullptr;
+        if (SUCCEEDED(device->GetId(&deviceId)) && deviceId)
+        {
+            resolved = deviceId;
+            CoTaskMemFree(deviceId);
+        }
+        SafeRelease(device);
+        if (resolved.empty())
+            throw std::runtime_error(missing);
+        return resolved;
+    }
+
+    IAudioClient *ActivateClient(IMMDevice *device, WAVEFORMATEX **format)
+    {
+        IAudioClient *client = nullptr;
+        HRESULT hr = device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void **)&client);
+        if (FAILED(hr) || !client)
+            throw std::runtime_error("[x] Failed to activate audio client");
+
+        hr = client->GetMixFormat(format);
+        if (FAILED(hr) || !*format)
+        {
+            SafeRelease(client);
+            throw std::runtime_error("[x] Failed to read mix format");
+        }
+        if (!IsFloat32(*format))
+        {
+            CoTaskMemFree(*format);
+            *format = nullptr;
+            SafeRelease(client);
+            throw std::runtime_error("[x] Unsupported mix format (expected 32-bit float)");
+        }
+        return client;
+    }
+
+    void OpenCaptureStream(const std::wstring &id, bool loopback, REFERENCE_TIME bufferDuration, CaptureStream &stream)
+    {
+        CloseCaptureStream(stream);
+        IMMDevice *device = OpenEndpoint(id, loopback ? eRender : eCapture);
+        if (!device)
+            throw std::runtime_error("[x] Capture endpoint not found");
+
+        WAVEFORMATEX *format = nullptr;
+        try
+        {
+            stream.client = ActivateClient(device, &format);
+        }
+        catch (...)
+        {
+            SafeRelease(device);
+            throw;
+        }
+        SafeRelease(device);
+
+        try
+        {
+            // Event-driven loopback is unreliable on older Windows builds; loopback is polled
+            const DWORD flags = loopback ? AUDCLNT_STREAMFLAGS_LOOPBACK : AUDCLNT_STREAMFLAGS_EVENTCALLBACK;
+            HRESULT hr = stream.client->Initialize(AUDCLNT_SHAREMODE_SHARED, flags, bufferDuration, 0, format, nullptr);
+            stream.channels = format->nChannels;
+            stream.sampleRate = format->nSamplesPerSec;
+            CoTaskMemFree(format);
+            if (FAILED(hr))
+                throw std::runtime_error("[x] Failed to initialize capture stream");
+
+            REFERENCE_TIME period = 0;
+            if (SUCCEEDED(stream.client->GetDevicePeriod(&period, nullptr)))
+                stream.periodMs = period / 10000.0;
+
+            if (!loopback)
+            {
+                stream.event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+                if (!stream.event || FAILED(stream.client->SetEventHandle(stream.event)))
+                    throw std::runtime_error("[x] Failed to set capture event");
+            }
+
+            hr = stream.client->GetService(__uuidof(IAudioCaptureClient), (void **)&stream.capture);
+            if (FAILED(hr) || !stream.capture)
+                throw std::runtime_error("[x] Failed to get capture client");
+        }
+        catch (...)
+        {
+            CloseCaptureStream(stream);
+            throw;
+        }
+    }
+
+    void CloseCaptureStream(CaptureStream &stream)
+    {
+        if (stream.client)
+            stream.client->Stop();
+        SafeRelease(stream.capture);
+        SafeRelease(stream.client);
+        if (stream.event)
+            CloseHandle(stream.event);
+        stream.event = nullptr;
+    }
+
+    namespace
+    {
+        /**
+         * @brief Initializes @p client at the endpoint's minimum shared-mode engine period.
+         * @return The period in frames, or 0 if the endpoint or system does not allow it.
+         */
+        UINT32 InitializeLowLatency(IAudioClient *client, const WAVEFORMATEX *format, bool &belowDefault)
+        {
+            UINT32 periodFrames = 0;
+            IAudioClient3 *client3 = nullptr;
+            if (SUCCEEDED(client->QueryInterface(__uuidof(IAudioClient3), (void **)&client3)) && client3)
+            {
+                UINT32 defaultPeriod = 0, fundamental = 0, minPeriod = 0, maxPeriod = 0;
+                if (SUCCEEDED(client3->GetSharedModeEnginePeriod(format, &defaultPeriod, &fundamental, &minPeriod, &maxPeriod)) &&
+                    minPeriod > 0 &&
+                    SUCCEEDED(client3->InitializeSharedAudioStream(AUDCLNT_STREAMFLAGS_EVENTCALLBACK, minPeriod, format, nullptr)))
+                {
+                    periodFrames = minPeriod;
+                    belowDefault = minPeriod < defaultPeriod;
+                }
+                SafeRelease(client3);
+            }
+            return periodFrames;
+        }
+    }
+
+    void OpenRenderStream(const std::wstring &id, bool lowLatency, RenderStream &stream)
+    {
+        CloseRenderStream(stream);
+        IMMDevice *device = OpenEndpoint(id, eRender);
+        if (!device)
+            throw std::runtime_error("[x] Render endpoint not found");
+
+        WAVEFORMATEX *format = nullptr;
+        try
+        {
+            stream.client = ActivateClient(device, &format);
+            stream.channels = format->nChannels;
+            stream.sampleRate = format->nSamplesPerSec;
+            stream.lowLatency = false;
+
+            stream.periodFrames = lowLatency ? InitializeLowLatency(stream.client, format, stream.lowLatency) : 0;
+            if (stream.periodFrames == 0)
+            {
+                if (lowLatency)
+                {
+                    // A failed low-latency initialization can leave the client unusable: start over
+                    SafeRelease(stream.client);
+                    CoTaskMemFree(format);
+                    format = nullptr;
+                    stream.client = ActivateClient(device, &format);
+                }
+                const HRESULT hr = stream.client->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_EVENTCALLBACK, 0, 0, format, nullptr);
+                if (FAILED(hr))
+                    throw std::runtime_error("[x] Failed to initialize render stream");
+
+                REFERENCE_TIME period = 0;
+                if (SUCCEEDED(stream.client->GetDevicePeriod(&period, nullptr)))
+                    stream.periodFrames = static_cast<UINT32>(period * stream.sampleRate / 10000000);
+            }
+            CoTaskMemFree(format);
+            format = nullptr;
+            SafeRelease(device);
+
+            if (FAILED(stream.client->GetBufferSize(&stream.bufferFrames)))
+                throw std::runtime_error("[x] Failed to get render buffer size");
+            if (stream.periodFrames == 0)
+                stream.periodFrames = stream.bufferFrames / 2;
+            stream.periodMs = stream.periodFrames * 1000.0 / stream.sampleRate;
+
+            REFERENCE_TIME latency = 0;
+            stream.streamLatencyMs = SUCCEEDED(stream.client->GetStreamLatency(&latency)) ? latency / 10000.0 : 0.0;
+
+            stream.event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            if (!stream.event || FAILED(stream.client->SetEventHandle(stream.event)))
+                throw std::runtime_error("[x] Failed to set render event");
+
+            const HRESULT hr = stream.client->GetService(__uuidof(IAudioRenderClient), (void **)&stream.render);
+            if (FAILED(hr) || !stream.render)
+                throw std::runtime_error("[x] Failed to get render client");
+        }
+        catch (...)
+        {
+            if (format)
+                CoTaskMemFree(format);
+            SafeRelease(device);
+            CloseRenderStream(stream);
+            throw;
+        }
+    }
+
+    void CloseRenderStream(RenderStream &stream)
+    {
+        if (stream.client)
+            stream.client->Stop();
+        SafeRelease(stream.render);
+        SafeRelease(stream.client);
+        if (stream.event)
+            CloseHandle(stream.event);
+        stream.event = nullptr;
+    }
+}
@@ -0,0 +1,254 @@
+#include "Streaming/SignalPlayer.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/MmcssScope.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    SignalPlayer::SignalPlayer(std::wstring deviceId, Dsp::BlockPool &pool)
+        : m_deviceId(std::move(deviceId)), m_pool(pool)
+    {
+    }
+
+    SignalPlayer::~SignalPlayer()
+    {
+        Close();
+    }
+
+    void SignalPlayer::Open()
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        OpenLocked();
+    }
+
+    /**
+     * @brief Initializes an event-driven shared-mode stream and starts the idle render
+     *        thread. A stream that failed (device removed) is released and opened again.
+     */
+    void SignalPlayer::OpenLocked()
+    {
+        if (m_stream.client && !m_error.load())
+            return;
+        Release();
+
+        try
+        {
+            OpenRenderStream(m_deviceId, false, m_stream);
+            m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            if (!m_wakeEvent)
+                throw std::runtime_error("[x] Failed to create wake event");
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+
+        m_error = nullptr;
+        m_closing = false;
+        m_thread = std::thread(&SignalPlayer::RenderLoop, this);
+    }
+
+    /**
+     * @brief Makes the render thread leave the generator alone: clears m_playing, then
+     *        waits out a fill already in progress (at most one device period).
+     */
+    void SignalPlayer::Quiesce()
+    {
+        m_playing = false;
+        while (m_rendering.load())
+            std::this_thread::yield();
+    }
+
+    /**
+     * @brief Swaps in a new generator and restarts the stream with one pre-filled buffer.
+     */
+    void SignalPlayer::Play(const SignalOptions &options)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        OpenLocked();
+
+        Quiesce();
+        m_stream.client->Stop();
+        m_stream.client->Reset();
+
+        if (!m_scratch)
+            m_scratch = m_pool.Acquire();
+        if (!m_scratch)
+            throw std::runtime_error("[x] Too many test signals playing at once");
+
+        m_generator = std::make_unique<Dsp::SignalGenerator>(options.signal, m_stream.sampleRate);
+        m_channel = options.channel < static_cast<int>(m_stream.channels) ? options.channel : -1;
+        m_remaining = options.durationMs > 0.0
+                          ? static_cast<uint64_t>(std::llround(options.durationMs * m_stream.sampleRate / 1000.0))
+                          : UINT64_MAX;
+        m_finished = false;
+
+        // The first device period plays signal rather than the silence left by Reset()
+        BYTE *data = nullptr;
+        if (SUCCEEDED(m_stream.render->GetBuffer(m_stream.bufferFrames, &data)))
+        {
+            Fill(reinterpret_cast<float *>(data), m_stream.bufferFrames);
+            m_stream.render->ReleaseBuffer(m_stream.bufferFrames, 0);
+        }
+
+        m_playing = true;
+        if (FAILED(m_stream.client->Start()))
+        {
+            m_playing = false;
+            throw std::runtime_error("[x] Failed to start render stream");
+        }
+        m_lastStartMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    /**
+     * @brief Stops the stream but keeps it initialized; the scratch buffer goes back to
+     *        the pool.
+     */
+    void SignalPlayer::Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        if (!m_stream.client)
+            return;
+        Quiesce();
+        m_stream.client->Stop();
+        m_generator.reset();
+        m_pool.Release(m_scratch);
+        m_scratch = nullptr;
+    }
+
+    void SignalPlayer::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        Release();
+    }
+
+    /**
+     * @brief Records why the stream stopped and makes the render thread go idle.
+     */
+    void SignalPlayer::Fail(const char *message)
+    {
+        const char *expected = nullptr;
+        m_error.compare_exchange_strong(expected, message);
+        m_playing = false;
+    }
+
+    /**
+     * @brief Render thread: on each device period, fills the free part of the buffer.
+     *        Idle (no COM calls) while nothing is playing.
+     */
+    void SignalPlayer::RenderLoop()
+    {
+        COMInitializer com;
+        MmcssScope mmcss;
+
+        HANDLE waits[2] = {m_stream.event, m_wakeEvent};
+        while (!m_closing)
+        {
+            if (WaitForMultipleObjects(2, waits, FALSE, 200) != WAIT_OBJECT_0)
+                continue;
+
+            // Pairs with Quiesce(): either it sees m_rendering, or this sees !m_playing
+            m_rendering = true;
+            if (!m_playing)
+            {
+                m_rendering = false;
+                continue;
+            }
+
+            UINT32 padding = 0;
+            HRESULT hr = m_stream.client->GetCurrentPadding(&padding);
+            if (SUCCEEDED(hr) && padding < m_stream.bufferFrames)
+            {
+                BYTE *data = nullptr;
+                const UINT32 frames = m_stream.bufferFrames - padding;
+                hr = m_stream.render->GetBuffer(frames, &data);
+                if (SUCCEEDED(hr))
+                {
+                    Fill(reinterpret_cast<float *>(data), frames);
+                    m_stream.render->ReleaseBuffer(frames, 0);
+                }
+            }
+            if (FAILED(hr))
+                Fail(hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Render device removed" : "Render failed");
+            m_rendering = false;
+        }
+    }
+
+    /**
+     * @brief Generates mono blocks into the scratch buffer and writes them to the selected
+     *        channels; silence once the requested duration has been played.
+     */
+    void SignalPlayer::Fill(float *data, UINT32 frames)
+    {
+        const size_t blockFrames = m_pool.BlockFloats();
+        const UINT32 total = frames;
+        while (frames > 0)
+        {
+            const size_t count = std::min<size_t>(frames, blockFrames);
+            const size_t signal = static_cast<size_t>(std::min<uint64_t>(count, m_remaining));
+            m_generator->Render(m_scratch, signal);
+            std::fill(m_scratch + signal, m_scratch + count, 0.0f);
+            if (m_remaining != UINT64_MAX)
+            {
+                m_remaining -= signal;
+                if (m_remaining == 0)
+                    m_finished = true;
+            }
+
+            for (size_t f = 0; f < count; ++f, data += m_stream.channels)
+            {
+                for (uint32_t c = 0; c < m_stream.channels; ++c)
+                    data[c] = m_channel < 0 || static_cast<int>(c) == m_channel ? m_scratch[f] : 0.0f;
+            }
+            frames -= static_cast<UINT32>(count);
+        }
+        m_framesRendered += total;
+    }
+
+    /**
+     * @brief Joins the render thread and releases the stream, the scratch buffer and every
+     *        COM object. Called with the control mutex held.
+     */
+    void SignalPlayer::Release()
+    {
+        m_closing = true;
+        m_playing = false;
+        if (m_wakeEvent)
+            SetEvent(m_wakeEvent);
+        if (m_thread.joinable())
+            m_thread.join();
+
+        CloseRenderStream(m_stream);
+        if (m_wakeEvent)
+            CloseHandle(m_wakeEvent);
+        m_wakeEvent = nullptr;
+
+        m_generator.reset();
+        m_pool.Release(m_scratch);
+        m_scratch = nullptr;
+    }
+
+    SignalPlayerStats SignalPlayer::Stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_controlMutex);
+        SignalPlayerStats stats;
+        stats.open = m_stream.client != nullptr;
+        stats.playing = m_playing && !m_finished;
+        stats.sampleRate = m_stream.sampleRate;
+        stats.channels = m_stream.channels;
+        stats.framesRendered = m_framesRendered.load();
+        stats.lastStartMs = m_lastStartMs;
+        if (const char *error = m_error.load())
+            stats.error = error;
+        return stats;
+    }
+}
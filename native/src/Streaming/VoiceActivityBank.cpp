@@ -0,0 +1,146 @@
+#include "Streaming/VoiceActivityBank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr size_t kSilenceFrames = 1024;       ///< Frames of silence fed per detector call.
+        constexpr float kTieProbability = 0.05f;      ///< Probabilities this close count as a tie.
+    }
+
+    VoiceActivityBoard::VoiceActivityBoard(size_t slots)
+        : m_size(slots),
+          m_slots(new Slot[slots])
+    {
+    }
+
+    void VoiceActivityBoard::Publish(size_t index, const VoiceActivityState &state)
+    {
+        if (index >= m_size)
+            return;
+        Slot &slot = m_slots[index];
+        const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.probability.store(state.probability, std::memory_order_relaxed);
+        slot.levelDb.store(state.levelDb, std::memory_order_relaxed);
+        slot.noiseDb.store(state.noiseDb, std::memory_order_relaxed);
+        slot.flatness.store(state.flatness, std::memory_order_relaxed);
+        slot.zeroCrossings.store(state.zeroCrossings, std::memory_order_relaxed);
+        slot.speechSeconds.store(state.speechSeconds, std::memory_order_relaxed);
+        slot.updates.store(state.updates, std::memory_order_relaxed);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies a slot consistently, retrying over a concurrent Publish().
+     */
+    VoiceActivityState VoiceActivityBoard::Read(size_t index) const
+    {
+        VoiceActivityState state;
+        if (index >= m_size)
+            return state;
+        const Slot &slot = m_slots[index];
+        for (;;)
+        {
+            const uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1u)
+                continue;
+            state.probability = slot.probability.load(std::memory_order_relaxed);
+            state.levelDb = slot.levelDb.load(std::memory_order_relaxed);
+            state.noiseDb = slot.noiseDb.load(std::memory_order_relaxed);
+            state.flatness = slot.flatness.load(std::memory_order_relaxed);
+            state.zeroCrossings = slot.zeroCrossings.load(std::memory_order_relaxed);
+            state.speechSeconds = slot.speechSeconds.load(std::memory_order_relaxed);
+            state.updates = slot.updates.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+                break;
+        }
+        state.speaking = state.probability >= 0.5f;
+        return state;
+    }
+
+    int VoiceActivityBoard::MostActive() const
+    {
+        int best = -1;
+        VoiceActivityState bestState;
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            const VoiceActivityState state = Read(i);
+            if (!state.speaking)
+                continue;
+            const bool tie = best >= 0 && std::abs(state.probability - bestState.probability) <= kTieProbability;
+            const bool better = tie ? state.levelDb - state.noiseDb > bestState.levelDb - bestState.noiseDb
+                                    : best < 0 || state.probability > bestState.probability;
+            if (better)
+            {
+                best = static_cast<int>(i);
+                bestState = state;
+            }
+        }
+        return best;
+    }
+
+    VoiceActivityBank::VoiceActivityBank(size_t streams, const Dsp::VoiceActivityOptions &options)
+        : m_options(options),
+          m_streams(streams),
+          m_board(streams)
+    {
+    }
+
+    void VoiceActivityBank::Configure(size_t index, uint32_t sampleRate, unsigned channels)
+    {
+        if (index >= m_streams.size())
+            throw std::out_of_range("[x] No such voice activity stream");
+        Stream &stream = m_streams[index];
+        stream.detector = std::make_unique<Dsp::VoiceActivityDetector>(sampleRate, channels, m_options);
+        stream.channels = channels;
+        stream.speechSeconds = 0.0;
+        m_silence.resize(std::max(m_silence.size(), kSilenceFrames * channels), 0.0f);
+        m_board.Publish(index, VoiceActivityState{});
+    }
+
+    void VoiceActivityBank::Process(size_t index, const float *input, size_t frames)
+    {
+        if (index >= m_streams.size() || !m_streams[index].detector)
+            return;
+        Stream &stream = m_streams[index];
+        const size_t analyzed = stream.detector->Process(input, frames);
+        if (analyzed > 0)
+            Publish(index, stream, analyzed);
+    }
+
+    void VoiceActivityBank::ProcessSilence(size_t index, size_t frames)
+    {
+        while (frames > 0)
+        {
+            const size_t count = std::min(frames, kSilenceFrames);
+            Process(index, m_silence.data(), count);
+            frames -= count;
+        }
+    }
+
+    void VoiceActivityBank::Publish(size_t index, Stream &stream, size_t analyzed)
+    {
+        const Dsp::VoiceActivityDetector &detector = *stream.detector;
+        const Dsp::VoiceActivityFeatures &features = detector.Features();
+
+        VoiceActivityState state;
+        state.probability = detector.Probability();
+        state.levelDb = features.levelDb;
+        state.noiseDb = features.noiseDb;
+        state.flatness = features.flatness;
+        state.zeroCrossings = features.zeroCrossings;
+        state.speaking = state.probability >= 0.5f;
+        if (state.speaking)
+            stream.speechSeconds += analyzed * Dsp::VoiceActivityDetector::kFrame / detector.AnalysisRate();
+        state.speechSeconds = stream.speechSeconds;
+        state.updates = detector.AnalyzedFrames();
+        m_board.Publish(index, state);
+    }
+}
@@ -0,0 +1,270 @@
+#include "Streaming/VoiceActivityMonitor.h"
+#include "Streaming/SharedModeClient.h"
+#include "Utility/AudioRuntime.h"
+#include "Utility/COMInitializer.h"
+#include "Utility/SafeRelease.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+using namespace Utility;
+
+namespace Streaming
+{
+    namespace
+    {
+        constexpr REFERENCE_TIME kBufferDuration = 2000000; ///< 200 ms, in 100 ns units: slack for a late analysis thread.
+        constexpr double kLoadWindowSeconds = 1.0;          ///< Processing time is averaged over this much wall time.
+    }
+
+    VoiceActivityMonitor::VoiceActivityMonitor(VoiceActivityMonitorOptions options)
+        : m_options(std::move(options))
+    {
+    }
+
+    VoiceActivityMonitor::~VoiceActivityMonitor()
+    {
+        Stop();
+    }
+
+    /**
+     * @brief The requested endpoint IDs, or every active capture endpoint when none were.
+     */
+    std::vector<std::wstring> VoiceActivityMonitor::ResolveIds() const
+    {
+        if (!m_options.deviceIds.empty())
+        {
+            std::vector<std::wstring> ids;
+            for (const std::wstring &id : m_options.deviceIds)
+                ids.push_back(ResolveEndpointId(id, eCapture));
+            return ids;
+        }
+
+        IMMDeviceEnumerator *enumerator = AudioRuntime::Instance().AcquireEnumerator();
+        if (!enumerator)
+            throw std::runtime_error("[x] Failed to create device enumerator");
+        IMMDeviceCollection *devices = nullptr;
+        HRESULT hr = enumerator->EnumAudioEndpoints(eCapture, DEVICE_STATE_ACTIVE, &devices);
+        SafeRelease(enumerator);
+        if (FAILED(hr) || !devices)
+            throw std::runtime_error("[x] Failed to enumerate capture endpoints");
+
+        std::vector<std::wstring> ids;
+        UINT count = 0;
+        devices->GetCount(&count);
+        for (UINT i = 0; i < count; ++i)
+        {
+            IMMDevice *device = nullptr;
+            LPWSTR deviceId = nullptr;
+            if (SUCCEEDED(devices->Item(i, &device)) && device && SUCCEEDED(device->GetId(&deviceId)) && deviceId)
+            {
+                ids.emplace_back(deviceId);
+                CoTaskMemFree(deviceId);
+            }
+            SafeRelease(device);
+        }
+        SafeRelease(devices);
+        return ids;
+    }
+
+    void VoiceActivityMonitor::Start()
+    {
+        if (m_running)
+            return;
+
+        try
+        {
+            const std::vector<std::wstring> ids = ResolveIds();
+            if (ids.empty())
+                throw std::runtime_error("[x] No capture endpoints to monitor");
+            if (ids.size() > MAXIMUM_WAIT_OBJECTS)
+                throw std::runtime_error("[x] Too many capture endpoints (at most 64)");
+
+            m_inputs.clear();
+            m_bank = std::make_unique<VoiceActivityBank>(ids.size(), m_options.detector);
+            size_t opened = 0;
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                auto input = std::make_unique<Input>();
+                input->id = ids[i];
+                // One endpoint that cannot be opened (in exclusive use, ...) does not stop the rest
+                try
+                {
+                    OpenCaptureStream(input->id, false, kBufferDuration, input->stream);
+                    m_bank->Configure(i, input->stream.sampleRate, input->stream.channels);
+                    if (FAILED(input->stream.client->Start()))
+                        throw std::runtime_error("[x] Failed to start capture stream");
+                    input->running = true;
+                    ++opened;
+                }
+                catch (const std::exception &)
+                {
+                    CloseInput(*input);
+                    input->error = "Failed to open capture endpoint";
+                }
+                m_inputs.push_back(std::move(input));
+            }
+            if (opened == 0)
+                throw std::runtime_error("[x] No capture endpoint could be opened");
+        }
+        catch (...)
+        {
+            Release();
+            throw;
+        }
+
+        m_error = nullptr;
+        m_load = 0.0;
+        m_running = true;
+        m_thread = std::thread(&VoiceActivityMonitor::MonitorLoop, this);
+    }
+
+    void VoiceActivityMonitor::Stop()
+    {
+        m_running = false;
+        if (m_thread.joinable())
+            m_thread.join();
+        Release();
+    }
+
+    /**
+     * @brief Stops one stream and releases its COM objects and event.
+     */
+    void VoiceActivityMonitor::CloseInput(Input &input)
+    {
+        CloseCaptureStream(input.stream);
+        input.running = false;
+    }
+
+    void VoiceActivityMonitor::Release()
+    {
+        for (auto &input : m_inputs)
+            CloseInput(*input);
+    }
+
+    /**
+     * @brief Feeds every pending packet of one endpoint to the bank.
+     * @return False once the endpoint has failed.
+     */
+    bool VoiceActivityMonitor::Drain(size_t index, Input &input)
+    {
+        UINT32 packetFrames = 0;
+        HRESULT hr = S_OK;
+        while (SUCCEEDED(hr = input.stream.capture->GetNextPacketSize(&packetFrames)) && packetFrames > 0)
+        {
+            BYTE *data = nullptr;
+            UINT32 frames = 0;
+            DWORD flags = 0;
+            hr = input.stream.capture->GetBuffer(&data, &frames, &flags, nullptr, nullptr);
+            if (FAILED(hr))
+                break;
+            if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
+                m_bank->ProcessSilence(index, frames);
+            else
+                m_bank->Process(index, reinterpret_cast<const float *>(data), frames);
+            input.stream.capture->ReleaseBuffer(frames);
+        }
+        if (FAILED(hr))
+        {
+            const char *expected = nullptr;
+            input.error.compare_exchange_strong(expected, hr == AUDCLNT_E_DEVICE_INVALIDATED ? "Capture device removed"
+                                                                                              : "Capture failed");
+            input.running = false;
+            m_bank->Configure(index, input.stream.sampleRate, input.stream.channels); // a removed microphone is not speaking
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Analysis thread: waits on every endpoint's event at once and drains the
+     *        streams that have data. Analysis is not time-critical (the 200 ms buffers
+     *        absorb a late wake-up), so the thread runs at normal priority.
+     */
+    void VoiceActivityMonitor::MonitorLoop()
+    {
+        COMInitializer com;
+
+        std::vector<HANDLE> events;
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < m_inputs.size(); ++i)
+        {
+            if (m_inputs[i]->running)
+            {
+                events.push_back(m_inputs[i]->stream.event);
+                owners.push_back(i);
+            }
+        }
+
+        auto windowStart = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration busy{};
+        while (m_running && !events.empty())
+        {
+            const DWORD result = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, 200);
+            if (result == WAIT_FAILED)
+            {
+                const char *expected = nullptr;
+                m_error.compare_exchange_strong(expected, "Waiting for capture events failed");
+                break;
+            }
+
+            // Drain every stream, not just the one signalled: they tick at the same period
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t e = 0; e < events.size();)
+            {
+                if (Drain(owners[e], *m_inputs[owners[e]]))
+                {
+                    ++e;
+                    continue;
+                }
+                events.erase(events.begin() + e);
+                owners.erase(owners.begin() + e);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            busy += end - start;
+
+            const double window = std::chrono::duration<double>(end - windowStart).count();
+            if (window >= kLoadWindowSeconds)
+            {
+                m_load.store(std::chrono::duration<double>(busy).count() / window * 100.0, std::memory_order_relaxed);
+                windowStart = end;
+                busy = {};
+            }
+        }
+
+        if (m_running && events.empty())
+        {
+            const char *expected = nullptr;
+            m_error.compare_exchange_strong(expected, "Every capture endpoint failed");
+        }
+        m_running = false;
+    }
+
+    VoiceActivityMonitorStats VoiceActivityMonitor::Stats() const
+    {
+        VoiceActivityMonitorStats stats;
+        stats.running = m_running.load();
+        if (const char *error = m_error.load())
+            stats.error = error;
+        stats.loadPercent = m_load.load(std::memory_order_relaxed);
+        if (!m_bank)
+            return stats;
+
+        stats.mostActive = m_bank->Board().MostActive();
+        for (size_t i = 0; i < m_inputs.size(); ++i)
+        {
+            const Input &input = *m_inputs[i];
+            VoiceActivityEndpointStats endpoint;
+            endpoint.id = input.id;
+            endpoint.state = m_bank->Board().Read(i);
+            endpoint.sampleRate = input.stream.sampleRate;
+            endpoint.channels = input.stream.channels;
+            endpoint.running = input.running.load();
+            if (const char *error = input.error.load())
+                endpoint.error = error;
+            stats.endpoints.push_back(std::move(endpoint));
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,96 @@
+#include "Utility/AudioRuntime.h"
+#include "Utility/SafeRelease.h"
+#include "AudioSwitcher/IPolicyConfig.h"
+
+namespace Utility
+{
+    /**
+     * @brief Returns the process-wide runtime instance.
+     *
+     * The instance is intentionally leaked: COM objects must not be released from a
+     * static destructor after the apartment may already be gone.
+     */
+    AudioRuntime &AudioRuntime::Instance()
+    {
+        static AudioRuntime *instance = new AudioRuntime();
+        return *instance;
+    }
+
+    /**
+     * @brief Returns the cached enumerator, creating it (and pinning the MTA) on first use.
+     *
+     * @return IMMDeviceEnumerator* AddRef'd enumerator, or nullptr on failure.
+     */
+    IMMDeviceEnumerator *AudioRuntime::AcquireEnumerator()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_enumerator)
+        {
+            // Keep the MTA alive between calls so the cached enumerator stays valid
+            if (!m_mtaCookie && FAILED(CoIncrementMTAUsage(&m_mtaCookie)))
+                m_mtaCookie = nullptr;
+
+            HRESULT hr = CoCreateInstance(
+                __uuidof(MMDeviceEnumerator),
+                nullptr,
+                CLSCTX_ALL,
+                __uuidof(IMMDeviceEnumerator),
+                (void **)&m_enumerator);
+            if (FAILED(hr) || !m_enumerator)
+            {
+                m_enumerator = nullptr;
+                return nullptr;
+            }
+        }
+
+        m_enumerator->AddRef();
+        return m_enumerator;
+    }
+
+    /**
+     * @brief Returns the cached policy-config object, creating it on first use.
+     *
+     * @return IPolicyConfig* AddRef'd object, or nullptr on failure.
+     */
+    IPolicyConfig *AudioRuntime::AcquirePolicyConfig()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_policyConfig)
+        {
+            if (!m_mtaCookie && FAILED(CoIncrementMTAUsage(&m_mtaCookie)))
+                m_mtaCookie = nullptr;
+
+            HRESULT hr = CoCreateInstance(__uuidof(CPolicyConfigClient), nullptr, CLSCTX_ALL,
+                                          __uuidof(IPolicyConfig), (void **)&m_policyConfig);
+            if (FAILED(hr) || !m_policyConfig)
+            {
+                m_policyConfig = nullptr;
+                return nullptr;
+            }
+        }
+
+        m_policyConfig->AddRef();
+        return m_policyConfig;
+    }
+
+    /**
+     * @brief Reports whether the runtime has been set up by a native call.
+     */
+    bool AudioRuntime::IsInitialized() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_enumerator != nullptr;
+    }
+
+    /**
+     * @brief Releases cached objects; the MTA stays pinned for the next initialization.
+     */
+    void AudioRuntime::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SafeRelease(m_enumerator);
+        SafeRelease(m_policyConfig);
+    }
+}
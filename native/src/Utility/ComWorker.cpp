@@ -0,0 +1,94 @@
+#include "Utility/ComWorker.h"
+#include "Utility/COMInitializer.h"
+
+namespace Utility
+{
+    /**
+     * @brief Creates a worker and starts its detached thread.
+     *
+     * The thread holds a shared_ptr to the worker, which keeps the queue and state alive
+     * for as long as the thread runs, even after every other owner has dropped it.
+     *
+     * @return std::shared_ptr<ComWorker> The running worker.
+     */
+    std::shared_ptr<ComWorker> ComWorker::Create()
+    {
+        std::shared_ptr<ComWorker> worker(new ComWorker());
+        std::thread([self = worker]()
+                    { self->Run(); })
+            .detach();
+        return worker;
+    }
+
+    /**
+     * @brief Queues a task for the worker thread.
+     *
+     * @param task Callable to run on the worker thread.
+     * @return true if queued, false if the worker has been abandoned.
+     */
+    bool ComWorker::Post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_abandoned)
+                return false;
+            m_tasks.push_back(std::move(task));
+        }
+        m_cv.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Marks the worker as abandoned and drops any queued tasks.
+     *
+     * A task that is currently blocked in a driver call is not interrupted; the thread
+     * exits as soon as it returns.
+     */
+    void ComWorker::Abandon()
+    {
+        std::deque<std::function<void()>> dropped;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_abandoned = true;
+            dropped.swap(m_tasks);
+        }
+        m_cv.notify_one();
+        // Dropped tasks are destroyed here, outside the lock, which breaks their promises.
+    }
+
+    /**
+     * @brief Thread body: initializes COM once and executes tasks until abandoned.
+     */
+    void ComWorker::Run()
+    {
+        try
+        {
+            COMInitializer com;
+
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this]
+                              { return m_abandoned || !m_tasks.empty(); });
+                    if (m_abandoned)
+                        break;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+
+                m_busy.store(true, std::memory_order_release);
+                task();
+                m_busy.store(false, std::memory_order_release);
+            }
+        }
+        catch (...)
+        {
+            // COM initialization failed; fall through and drop remaining work below.
+        }
+
+        Abandon();
+        m_finished.store(true, std::memory_order_release);
+    }
+}
@@ -1,5 +1,7 @@
 #include "Utility/DeviceUtils.h"
 #include "Utility/SafeRelease.h"
+#include "Utility/AudioRuntime.h"
+#include "AudioSwitcher/ServiceRecovery.h"
 #include <windows.h>
 #include <mmdeviceapi.h>
 #include <endpointvolume.h>
@@ -124,15 +126,10 @@ namespace Utility
         IMMDeviceEnumerator *pEnum = nullptr;
         IMMDevice *pDefaultDevice = nullptr;
 
-        // Create the device enumerator COM object.
-        HRESULT hr = CoCreateInstance(
-            __uuidof(MMDeviceEnumerator),
-            nullptr,
-            CLSCTX_ALL,
-            __uuidof(IMMDeviceEnumerator),
-            (void **)&pEnum);
+        // Get the shared device enumerator (created lazily on first use).
+        pEnum = AudioRuntime::Instance().AcquireEnumerator();
 
-        if (FAILED(hr) || !pEnum)
+        if (!pEnum)
         {
             // if (comInitialized)
             // CoUninitialize();
@@ -140,7 +137,7 @@ namespace Utility
         }
 
         // Retrieve the default audio endpoint (render device for the console role).
-        hr = pEnum->GetDefaultAudioEndpoint(eRender, eConsole, &pDefaultDevice);
+        HRESULT hr = pEnum->GetDefaultAudioEndpoint(eRender, eConsole, &pDefaultDevice);
         SafeRelease(pEnum);
 
         // If retrieval fails, uninitialize COM if we initialized it and return nullptr.
@@ -148,6 +145,7 @@ namespace Utility
         {
             // if (comInitialized)
             // CoUninitialize();
+            AudioSwitcher::ServiceRecovery::Instance().Report(hr); // schedules recovery if audiosrv is gone
             return nullptr;
         }
 
@@ -266,4 +264,105 @@ namespace Utility
         }
     }
 
+    /**
+     * @brief Opens an audio endpoint directly by its ID.
+     *
+     * @param deviceId The device ID string (from IMMDevice::GetId()).
+     * @return IMMDevice* Pointer to the device, or nullptr on failure.
+     * @note Caller is responsible for releasing the returned pointer using `SafeRelease`.
+     */
+    IMMDevice *GetDeviceById(const std::wstring &deviceId)
+    {
+        IMMDevice *device = nullptr;
+
+        IMMDeviceEnumerator *pEnum = AudioRuntime::Instance().AcquireEnumerator();
+        if (!pEnum)
+            return nullptr;
+
+        HRESULT hr = pEnum->GetDevice(deviceId.c_str(), &device);
+        SafeRelease(pEnum);
+        if (FAILED(hr))
+            AudioSwitcher::ServiceRecovery::Instance().Report(hr);
+
+        return SUCCEEDED(hr) ? device : nullptr;
+    }
+
+    /**
+     * @brief Reads the mute state of a device through IAudioEndpointVolume.
+     *
+     * @param device A valid IMMDevice pointer (not owned).
+     * @param[out] mute Receives the current mute state.
+     * @return true if successful, false otherwise.
+     */
+    bool GetDeviceMute(IMMDevice *device, bool &mute)
+    {
+        if (!device)
+            return false;
+
+        IAudioEndpointVolume *endpointVolume = nullptr;
+        HRESULT hr = device->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr,
+                                      reinterpret_cast<void **>(&endpointVolume));
+        if (FAILED(hr) || !endpointVolume)
+            return false;
+
+        BOOL muted = FALSE;
+        hr = endpointVolume->GetMute(&muted);
+        SafeRelease(endpointVolume);
+
+        mute = muted != FALSE;
+        return SUCCEEDED(hr);
+    }
+
+    /**
+     * @brief Reads the master volume scalar of a device through IAudioEndpointVolume.
+     *
+     * @param device A valid IMMDevice pointer (not owned).
+     * @param[out] level Receives the scalar volume (0.0 - 1.0).
+     * @return true if successful, false otherwise.
+     */
+    bool GetDeviceVolume(IMMDevice *device, float &level)
+    {
+        if (!device)
+            return false;
+
+        IAudioEndpointVolume *endpointVolume = nullptr;
+        HRESULT hr = device->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr,
+                                      reinterpret_cast<void **>(&endpointVolume));
+        if (FAILED(hr) || !endpointVolume)
+            return false;
+
+        hr = endpointVolume->GetMasterVolumeLevelScalar(&level);
+        SafeRelease(endpointVolume);
+
+        return SUCCEEDED(hr);
+    }
+
+    /**
+     * @brief Sets the master volume scalar of a device through IAudioEndpointVolume.
+     *
+     * @param device A valid IMMDevice pointer (not owned).
+     * @param level Scalar volume; values outside 0.0 - 1.0 are clamped.
+     * @return true if successful, false otherwise.
+     */
+    bool SetDeviceVolume(IMMDevice *device, float level)
+    {
+        if (!device)
+            return false;
+
+        if (level < 0.0f)
+            level = 0.0f;
+        if (level > 1.0f)
+            level = 1.0f;
+
+        IAudioEndpointVolume *endpointVolume = nullptr;
+        HRESULT hr = device->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr,
+                                      reinterpret_cast<void **>(&endpointVolume));
+        if (FAILED(hr) || !endpointVolume)
+            return false;
+
+        hr = endpointVolume->SetMasterVolumeLevelScalar(level, nullptr);
+        SafeRelease(endpointVolume);
+
+        return SUCCEEDED(hr);
+    }
 }
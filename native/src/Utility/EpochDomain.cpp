@@ -0,0 +1,153 @@
+#include "Utility/EpochDomain.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Utility
+{
+    /**
+     * @brief One reader thread's announcement. Written only by its owner (except the
+     *        exited flag at thread exit); read by reclaiming writers.
+     */
+    struct alignas(64) EpochDomain::ReaderSlot
+    {
+        std::atomic<uint64_t> active{0}; ///< Epoch the thread pinned in, 0 when quiescent.
+        uint32_t depth = 0;              ///< Nesting of Guards (owner thread only).
+        std::atomic<bool> exited{false}; ///< Owner thread is gone; the slot can be dropped.
+    };
+
+    namespace
+    {
+        std::atomic<uint64_t> g_nextDomainId{1};
+
+        /**
+         * @brief The calling thread's slots, one per domain it has pinned. Marks them
+         *        exited when the thread ends; domains prune them on their next reclaim.
+         */
+        struct ThreadPins
+        {
+            struct Entry
+            {
+                uint64_t domain;
+                std::shared_ptr<void> slot; ///< EpochDomain::ReaderSlot, kept alive past the domain.
+                std::atomic<bool> *exited;
+            };
+
+            ~ThreadPins()
+            {
+                for (Entry &entry : entries)
+                    entry.exited->store(true, std::memory_order_release);
+            }
+
+            std::vector<Entry> entries;
+        };
+
+        thread_local ThreadPins t_pins;
+    }
+
+    EpochDomain::EpochDomain()
+        : m_id(g_nextDomainId.fetch_add(1))
+    {
+    }
+
+    EpochDomain::~EpochDomain()
+    {
+        for (const Retired &retired : m_retired)
+            retired.destroy(retired.object);
+    }
+
+    EpochDomain &EpochDomain::Global()
+    {
+        static EpochDomain *domain = new EpochDomain(); // leaked: readers may run during static destruction
+        return *domain;
+    }
+
+    EpochDomain::ReaderSlot &EpochDomain::LocalSlot()
+    {
+        for (const ThreadPins::Entry &entry : t_pins.entries)
+        {
+            if (entry.domain == m_id)
+                return *static_cast<ReaderSlot *>(entry.slot.get());
+        }
+
+        // First pin from this thread: register a slot (the only lock on this path)
+        auto slot = std::make_shared<ReaderSlot>();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_slots.push_back(slot);
+        }
+        t_pins.entries.push_back({m_id, slot, &slot->exited});
+        return *slot;
+    }
+
+    EpochDomain::Guard EpochDomain::Pin()
+    {
+        ReaderSlot &slot = LocalSlot();
+        if (slot.depth++ == 0)
+        {
+            // seq_cst: the announcement must be visible before the caller loads a pointer,
+            // so a writer that swapped it out either sees this epoch or the reader sees the
+            // new pointer.
+            slot.active.store(m_epoch.load());
+        }
+        return Guard(&slot);
+    }
+
+    EpochDomain::Guard::~Guard()
+    {
+        if (m_slot && --m_slot->depth == 0)
+            m_slot->active.store(0, std::memory_order_release);
+    }
+
+    void EpochDomain::Retire(void *object, void (*destroy)(void *))
+    {
+        if (!object)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_retired.push_back({object, destroy, m_epoch.fetch_add(1)});
+        }
+        Reclaim();
+    }
+
+    size_t EpochDomain::Reclaim()
+    {
+        std::vector<Retired> expired;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_retired.empty())
+                return 0;
+
+            uint64_t oldest = std::numeric_limits<uint64_t>::max();
+            auto keep = std::remove_if(m_slots.begin(), m_slots.end(), [&oldest](const std::shared_ptr<ReaderSlot> &slot)
+                                       {
+                const uint64_t active = slot->active.load();
+                if (active != 0)
+                    oldest = std::min(oldest, active);
+                return active == 0 && slot->exited.load(std::memory_order_acquire); });
+            m_slots.erase(keep, m_slots.end());
+
+            // A reader pinned in epoch e may hold anything unlinked in epoch e or later
+            auto split = std::partition(m_retired.begin(), m_retired.end(), [oldest](const Retired &retired)
+                                        { return retired.epoch >= oldest; });
+            expired.assign(split, m_retired.end());
+            m_retired.erase(split, m_retired.end());
+            m_reclaimed += expired.size();
+        }
+
+        for (const Retired &retired : expired)
+            retired.destroy(retired.object);
+        return expired.size();
+    }
+
+    EpochStats EpochDomain::Stats() const
+    {
+        EpochStats stats;
+        stats.epoch = m_epoch.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.readers = m_slots.size();
+        stats.pending = m_retired.size();
+        stats.reclaimed = m_reclaimed;
+        return stats;
+    }
+}
@@ -0,0 +1,540 @@
+#include "Utility/Logger.h"
+#include "Dsp/SpscRing.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace Utility
+{
+    /**
+     * @brief One thread's ring. Shared between the owning thread (producer) and the
+     *        logger (consumer); retired when the thread exits and freed once drained.
+     */
+    struct LogThreadBuffer
+    {
+        LogThreadBuffer(size_t records, uint32_t thread)
+            : ring(records), threadId(thread)
+        {
+        }
+
+        Dsp::SpscRing<LogRecord> ring;
+        const uint32_t threadId;
+        std::atomic<bool> retired{false};
+    };
+
+    namespace
+    {
+        std::atomic<uint64_t> g_nextInstanceId{1};
+
+        uint32_t CurrentThreadId()
+        {
+#ifdef _WIN32
+            return static_cast<uint32_t>(GetCurrentThreadId());
+#else
+            static std::atomic<uint32_t> nextId{1};
+            thread_local const uint32_t id = nextId.fetch_add(1);
+            return id;
+#endif
+        }
+
+        /**
+         * @brief The calling thread's rings, one per logger it has written to. Marks them
+         *        retired when the thread exits.
+         */
+        struct ThreadSlots
+        {
+            struct Slot
+            {
+                uint64_t owner;
+                std::shared_ptr<LogThreadBuffer> buffer;
+            };
+
+            ~ThreadSlots()
+            {
+                for (Slot &slot : slots)
+                    slot.buffer->retired.store(true, std::memory_order_release);
+            }
+
+            std::vector<Slot> slots;
+        };
+
+        thread_local ThreadSlots t_slots;
+
+        /// Appends printf output of any length.
+        void AppendFormatted(std::string &out, const char *format, ...)
+        {
+            char stack[128];
+            va_list args;
+            va_start(args, format);
+            va_list copy;
+            va_copy(copy, args);
+            const int length = std::vsnprintf(stack, sizeof(stack), format, args);
+            va_end(args);
+            if (length >= 0 && static_cast<size_t>(length) < sizeof(stack))
+            {
+                out.append(stack, static_cast<size_t>(length));
+            }
+            else if (length > 0)
+            {
+                const size_t offset = out.size();
+                out.resize(offset + static_cast<size_t>(length) + 1);
+                std::vsnprintf(&out[offset], static_cast<size_t>(length) + 1, format, copy);
+                out.resize(offset + static_cast<size_t>(length));
+            }
+            va_end(copy);
+        }
+
+        /// Appends wide code units as UTF-8 (UTF-16 with surrogates, or UTF-32).
+        void AppendUtf8(std::string &out, const uint8_t *data, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                wchar_t unit;
+                std::memcpy(&unit, data + i * sizeof(wchar_t), sizeof(wchar_t));
+                uint32_t cp = static_cast<uint32_t>(unit);
+                if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp < 0xDC00 && i + 1 < count)
+                {
+                    wchar_t low;
+                    std::memcpy(&low, data + (i + 1) * sizeof(wchar_t), sizeof(wchar_t));
+                    if (static_cast<uint32_t>(low) >= 0xDC00 && static_cast<uint32_t>(low) < 0xE000)
+                    {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<uint32_t>(low) - 0xDC00);
+                        ++i;
+                    }
+                }
+                if (cp < 0x80)
+                {
+                    out += static_cast<char>(cp);
+                }
+                else if (cp < 0x800)
+                {
+                    out += static_cast<char>(0xC0 | (cp >> 6));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                else if (cp < 0x10000)
+                {
+                    out += static_cast<char>(0xE0 | (cp >> 12));
+                    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                else
+                {
+                    out += static_cast<char>(0xF0 | (cp >> 18));
+                    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+            }
+        }
+
+        /// One decoded argument; string arguments point into the record.
+        struct Arg
+        {
+            uint8_t tag = 0;
+            uint8_t width = 8;
+            uint64_t bits = 0;
+            const uint8_t *data = nullptr;
+            size_t count = 0;
+
+            int64_t Signed() const { return static_cast<int64_t>(bits); }
+            double Double() const
+            {
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+        };
+
+        class ArgReader
+        {
+        public:
+            explicit ArgReader(const LogRecord &record) : m_record(record) {}
+
+            bool Next(Arg &arg)
+            {
+                if (m_offset >= m_record.size)
+                    return false;
+                arg.tag = m_record.payload[m_offset];
+                if (arg.tag == LogDetail::kString || arg.tag == LogDetail::kWideString)
+                {
+                    uint16_t length;
+                    std::memcpy(&length, &m_record.payload[m_offset + 1], sizeof(length));
+                    arg.count = length;
+                    arg.data = &m_record.payload[m_offset + 1 + sizeof(length)];
+                    m_offset += 1 + sizeof(length) + length * (arg.tag == LogDetail::kString ? 1 : sizeof(wchar_t));
+                }
+                else
+                {
+                    arg.width = m_record.payload[m_offset + 1];
+                    std::memcpy(&arg.bits, &m_record.payload[m_offset + 2], sizeof(arg.bits));
+                    m_offset += 2 + sizeof(arg.bits);
+                }
+                return true;
+            }
+
+        private:
+            const LogRecord &m_record;
+            size_t m_offset = 0;
+        };
+
+        /// Formats one argument with the flags/width/precision in @p spec and conversion @p conv.
+        void AppendArg(std::string &out, std::string spec, char conv, const Arg &arg)
+        {
+            const bool integerConv = std::strchr("diouxXc", conv) != nullptr;
+            const bool floatConv = std::strchr("fFeEgGaA", conv) != nullptr;
+
+            switch (arg.tag)
+            {
+            case LogDetail::kString:
+            case LogDetail::kWideString:
+            {
+                std::string text;
+                if (arg.tag == LogDetail::kString)
+                    text.assign(reinterpret_cast<const char *>(arg.data), arg.count);
+                else
+                    AppendUtf8(text, arg.data, arg.count);
+                AppendFormatted(out, (spec + "s").c_str(), text.c_str());
+                return;
+            }
+            case LogDetail::kDouble:
+                if (integerConv)
+                    AppendFormatted(out, (spec + "lld").c_str(), static_cast<long long>(arg.Double()));
+                else
+                    AppendFormatted(out, (spec + (floatConv ? std::string(1, conv) : "g")).c_str(), arg.Double());
+                return;
+            case LogDetail::kPointer:
+                AppendFormatted(out, (spec + "p").c_str(), reinterpret_cast<void *>(static_cast<uintptr_t>(arg.bits)));
+                return;
+            default:
+                break;
+            }
+
+            // Integers
+            if (floatConv)
+            {
+                const double value = arg.tag == LogDetail::kSigned ? static_cast<double>(arg.Signed()) : static_cast<double>(arg.bits);
+                AppendFormatted(out, (spec + conv).c_str(), value);
+            }
+            else if (conv == 'c')
+            {
+                AppendFormatted(out, (spec + "c").c_str(), static_cast<int>(arg.bits));
+            }
+            else if (arg.tag == LogDetail::kSigned && (!integerConv || conv == 'd' || conv == 'i'))
+            {
+                AppendFormatted(out, (spec + "lld").c_str(), static_cast<long long>(arg.Signed()));
+            }
+            else
+            {
+                // Hex/octal of a negative value shows the original type's width, as printf would
+                const uint64_t bits = arg.width < 8 ? arg.bits & ((uint64_t(1) << (arg.width * 8)) - 1) : arg.bits;
+                const char unsignedConv = (conv == 'd' || conv == 'i' || !integerConv) ? 'u' : conv;
+                AppendFormatted(out, (spec + "ll" + unsignedConv).c_str(), static_cast<unsigned long long>(bits));
+            }
+        }
+    }
+
+    Logger::Logger(size_t bufferRecords, std::chrono::milliseconds drainInterval)
+        : m_instanceId(g_nextInstanceId.fetch_add(1)),
+          m_bufferRecords(std::max<size_t>(bufferRecords, 1)),
+          m_drainInterval(drainInterval)
+    {
+    }
+
+    Logger::~Logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_threadMutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        if (m_thread.joinable())
+            m_thread.join();
+        Flush();
+    }
+
+    Logger &Logger::Instance()
+    {
+        static Logger *instance = new Logger();
+        return *instance;
+    }
+
+    void Logger::SetLevel(LogLevel level)
+    {
+        m_level.store(level, std::memory_order_relaxed);
+        if (level != LogLevel::Off)
+            StartThread();
+    }
+
+    void Logger::SetSink(Sink sink)
+    {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        m_sink.swap(sink);
+    }
+
+    LogThreadBuffer &Logger::CurrentBuffer()
+    {
+        for (auto &slot : t_slots.slots)
+        {
+            if (slot.owner == m_instanceId)
+                return *slot.buffer;
+        }
+
+        // First record from this thread: register a ring (the only lock on this path)
+        auto buffer = std::make_shared<LogThreadBuffer>(m_bufferRecords, CurrentThreadId());
+        {
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            m_buffers.push_back(buffer);
+        }
+        t_slots.slots.push_back({m_instanceId, buffer});
+        return *buffer;
+    }
+
+    void Logger::Begin(LogRecord &record, LogLevel level, const char *component, const char *format)
+    {
+        record.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+        record.component = component ? component : "";
+        record.format = format ? format : "";
+        record.level = level;
+        record.truncated = 0;
+        record.size = 0;
+    }
+
+    void Logger::Commit(LogRecord &record)
+    {
+        LogThreadBuffer &buffer = CurrentBuffer();
+        record.threadId = buffer.threadId;
+        if (buffer.ring.Write(&record, 1) == 0)
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Logger::StartThread()
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        if (m_thread.joinable() || m_stopping)
+            return;
+        m_thread = std::thread([this]()
+                               { Run(); });
+    }
+
+    void Logger::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_threadMutex);
+        while (!m_stopping)
+        {
+            m_wake.wait_for(lock, m_drainInterval, [this]()
+                            { return m_stopping; });
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+
+    void Logger::Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        DrainLocked();
+    }
+
+    void Logger::DrainLocked()
+    {
+        std::vector<std::shared_ptr<LogThreadBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            buffers = m_buffers;
+        }
+
+        m_scratch.clear();
+        std::vector<LogThreadBuffer *> finished;
+        for (const auto &buffer : buffers)
+        {
+            // Read the flag first: a retired thread cannot write after it, so once drained
+            // the ring is empty for good
+            const bool retired = buffer->retired.load(std::memory_order_acquire);
+            size_t available = buffer->ring.AvailableToRead();
+            while (available > 0)
+            {
+                const size_t offset = m_scratch.size();
+                m_scratch.resize(offset + available);
+                buffer->ring.Read(&m_scratch[offset], available);
+                available = buffer->ring.AvailableToRead();
+            }
+            if (retired)
+                finished.push_back(buffer.get());
+        }
+
+        if (!m_scratch.empty() && m_sink)
+        {
+            m_entries.resize(m_scratch.size());
+            for (size_t i = 0; i < m_scratch.size(); ++i)
+            {
+                const LogRecord &record = m_scratch[i];
+                LogEntry &entry = m_entries[i];
+                entry.timeUs = record.timeUs;
+                entry.threadId = record.threadId;
+                entry.level = record.level;
+                entry.component = record.component;
+                entry.message = FormatMessage(record);
+            }
+            std::stable_sort(m_entries.begin(), m_entries.end(), [](const LogEntry &a, const LogEntry &b)
+                             { return a.timeUs < b.timeUs; });
+            m_sink(m_entries);
+            m_written += m_entries.size();
+        }
+
+        if (!finished.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [&](const std::shared_ptr<LogThreadBuffer> &buffer)
+                                           { return std::find(finished.begin(), finished.end(), buffer.get()) != finished.end(); }),
+                            m_buffers.end());
+        }
+    }
+
+    std::string Logger::FormatMessage(const LogRecord &record)
+    {
+        std::string out;
+        ArgReader reader(record);
+        const char *f = record.format;
+        while (*f)
+        {
+            if (*f != '%')
+            {
+                out += *f++;
+                continue;
+            }
+            if (f[1] == '%')
+            {
+                out += '%';
+                f += 2;
+                continue;
+            }
+
+            // %[flags][width][.precision][length]conversion; length is implied by the argument
+            const char *start = f++;
+            std::string spec = "%";
+            while (*f && std::strchr("-+ #0", *f))
+                spec += *f++;
+            while (std::isdigit(static_cast<unsigned char>(*f)))
+                spec += *f++;
+            if (*f == '.')
+            {
+                spec += *f++;
+                while (std::isdigit(static_cast<unsigned char>(*f)))
+                    spec += *f++;
+            }
+            while (*f && std::strchr("hlLqjzt", *f))
+                ++f;
+            if (!*f)
+            {
+                out.append(start);
+                break;
+            }
+            const char conv = *f++;
+
+            Arg arg;
+            if (!reader.Next(arg))
+            {
+                out.append(start, static_cast<size_t>(f - start)); // missing argument
+                continue;
+            }
+            AppendArg(out, spec, conv, arg);
+        }
+        if (record.truncated)
+            out += " [truncated]";
+        return out;
+    }
+
+    LoggerStats Logger::Stats() const
+    {
+        LoggerStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            stats.threads = m_buffers.size();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            stats.written = m_written;
+        }
+        stats.dropped = m_dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    const char *Logger::LevelName(LogLevel level)
+    {
+        switch (level)
+        {
+        case LogLevel::Trace:
+            return "trace";
+        case LogLevel::Debug:
+            return "debug";
+        case LogLevel::Info:
+            return "info";
+        case LogLevel::Warn:
+            return "warn";
+        case LogLevel::Error:
+            return "error";
+        default:
+            return "off";
+        }
+    }
+
+    bool Logger::ParseLevel(const std::string &name, LogLevel &level)
+    {
+        for (LogLevel candidate : {LogLevel::Trace, LogLevel::Debug, LogLevel::Info, LogLevel::Warn, LogLevel::Error, LogLevel::Off})
+        {
+            if (name == LevelName(candidate))
+            {
+                level = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string Logger::FormatLine(const LogEntry &entry)
+    {
+        const std::time_t seconds = static_cast<std::time_t>(entry.timeUs / 1000000);
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &seconds);
+#else
+        gmtime_r(&seconds, &utc);
+#endif
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &utc);
+
+        std::string line;
+        AppendFormatted(line, "%s.%06lldZ %-5s [%s] (%u) ", stamp, static_cast<long long>(entry.timeUs % 1000000),
+                        LevelName(entry.level), entry.component, entry.threadId);
+        line += entry.message;
+        return line;
+    }
+
+    Logger::Sink Logger::FileSink(const std::string &path)
+    {
+        std::FILE *raw = std::fopen(path.c_str(), "a");
+        if (!raw)
+            return Sink();
+        std::shared_ptr<std::FILE> file(raw, [](std::FILE *f)
+                                        { std::fclose(f); });
+        return [file](const std::vector<LogEntry> &entries)
+        {
+            for (const LogEntry &entry : entries)
+            {
+                const std::string line = FormatLine(entry);
+                std::fwrite(line.data(), 1, line.size(), file.get());
+                std::fputc('\n', file.get());
+            }
+            std::fflush(file.get());
+        };
+    }
+}
@@ -0,0 +1,185 @@
+#include "Utility/OperationSupervisor.h"
+#include "Utility/Logger.h"
+
+#include <algorithm>
+
+namespace Utility
+{
+    namespace
+    {
+        /// How long a hung device fails fast before a single probe call is let through.
+        constexpr std::chrono::seconds kHungProbeInterval{30};
+
+        /// Upper bound on stuck worker threads kept alive at once.
+        constexpr size_t kMaxQuarantinedWorkers = 8;
+    }
+
+    /**
+     * @brief Returns the process-wide supervisor instance.
+     */
+    OperationSupervisor &OperationSupervisor::Instance()
+    {
+        static OperationSupervisor instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets the per-call deadline; 0 restores direct (unsupervised) execution.
+     *
+     * @param timeout Deadline applied to every supervised call.
+     */
+    void OperationSupervisor::SetTimeout(std::chrono::milliseconds timeout)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_timeout = timeout.count() > 0 ? timeout : std::chrono::milliseconds(0);
+    }
+
+    /**
+     * @brief Returns the current per-call deadline.
+     */
+    std::chrono::milliseconds OperationSupervisor::GetTimeout() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_timeout;
+    }
+
+    /**
+     * @brief Returns a copy of all tracked device health records.
+     */
+    std::vector<std::pair<std::wstring, DeviceHealth>> OperationSupervisor::GetHealth() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::pair<std::wstring, DeviceHealth>> health;
+        health.reserve(m_health.size());
+        for (const auto &entry : m_health)
+            health.emplace_back(entry.first.ToWString(), entry.second);
+        std::sort(health.begin(), health.end(),
+                  [](const auto &a, const auto &b)
+                  { return a.first < b.first; });
+        return health;
+    }
+
+    /**
+     * @brief Drops the health record for a device key.
+     *
+     * @param deviceKey Device id or pseudo key.
+     */
+    void OperationSupervisor::ResetHealth(const std::wstring &deviceKey)
+    {
+        const AudioSwitcher::EndpointKey key = AudioSwitcher::EndpointKey::Lookup(deviceKey);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_health.erase(key);
+    }
+
+    /**
+     * @brief Fails fast if the device is hung.
+     *
+     * Once the probe interval has elapsed the hang timestamp is pushed forward and one
+     * call is allowed through to find out whether the device has come back.
+     *
+     * @throws DeviceHungError if the device is hung and not due for a probe.
+     */
+    void OperationSupervisor::CheckHealth(AudioSwitcher::EndpointKey key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_health.find(key);
+        if (it == m_health.end() || it->second.state != DeviceHealthState::Hung)
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - it->second.hungSince >= kHungProbeInterval)
+        {
+            it->second.hungSince = now;
+            return;
+        }
+
+        throw DeviceHungError("[x] Device is not responding; skipping call until it recovers.");
+    }
+
+    /**
+     * @brief Returns the active worker, creating one if needed.
+     *
+     * Quarantined workers whose stuck call has returned are pruned here.
+     *
+     * @throws std::runtime_error if too many workers are stuck in driver calls.
+     */
+    std::shared_ptr<ComWorker> OperationSupervisor::AcquireWorker()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_quarantined.erase(
+            std::remove_if(m_quarantined.begin(), m_quarantined.end(),
+                           [](const std::shared_ptr<ComWorker> &w)
+                           { return w->IsFinished(); }),
+            m_quarantined.end());
+
+        if (!m_worker || m_worker->IsFinished())
+        {
+            if (m_quarantined.size() >= kMaxQuarantinedWorkers)
+                throw std::runtime_error("[x] Too many native calls are stuck in audio drivers.");
+            m_worker = ComWorker::Create();
+        }
+        return m_worker;
+    }
+
+    /**
+     * @brief Abandons a worker stuck in a call and schedules a fresh one for the next call.
+     *
+     * @param worker The worker that missed its deadline.
+     */
+    void OperationSupervisor::QuarantineWorker(const std::shared_ptr<ComWorker> &worker)
+    {
+        worker->Abandon();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_worker == worker)
+            m_worker.reset();
+        m_quarantined.push_back(worker);
+    }
+
+    /**
+     * @brief Records a call that finished before its deadline.
+     *
+     * A call slower than half the deadline marks the device Slow; a fast call clears it.
+     */
+    void OperationSupervisor::RecordCompletion(AudioSwitcher::EndpointKey key, double latencyMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DeviceHealth &health = m_health[key];
+        health.lastLatencyMs = latencyMs;
+        if (health.pending)
+            return; // An earlier call is still stuck; keep the Hung state.
+        health.state = latencyMs * 2 > static_cast<double>(m_timeout.count())
+                           ? DeviceHealthState::Slow
+                           : DeviceHealthState::Healthy;
+    }
+
+    /**
+     * @brief Marks a device Hung after a missed deadline.
+     */
+    void OperationSupervisor::RecordTimeout(AudioSwitcher::EndpointKey key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DeviceHealth &health = m_health[key];
+        health.state = DeviceHealthState::Hung;
+        health.pending = true;
+        health.timeouts++;
+        health.hungSince = std::chrono::steady_clock::now();
+        AUDIO_LOG(Warn, "supervisor", "Call on %s missed its %lld ms deadline (%u timeouts); marked hung",
+                  key.ToWString(), static_cast<long long>(m_timeout.count()), health.timeouts);
+    }
+
+    /**
+     * @brief Called from the quarantined worker when its stuck call finally returns.
+     *
+     * The device is considered recovered but Slow until a normal call completes in time.
+     */
+    void OperationSupervisor::RecordLateCompletion(AudioSwitcher::EndpointKey key, double latencyMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DeviceHealth &health = m_health[key];
+        health.lastLatencyMs = latencyMs;
+        health.pending = false;
+        health.state = DeviceHealthState::Slow;
+    }
+}
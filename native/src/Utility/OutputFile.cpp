@@ -0,0 +1,112 @@
+#include "Utility/OutputFile.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include "Utility/StringUtils.h"
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Utility
+{
+    OutputFile::~OutputFile()
+    {
+        Close();
+    }
+
+#ifdef _WIN32
+    bool OutputFile::Open(const std::string &path)
+    {
+        Close();
+        // Sequential-scan keeps cache manager read-ahead off the write path
+        HANDLE handle = CreateFileW(Utf8ToWString(path).c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                    CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            return false;
+        m_handle = handle;
+        return true;
+    }
+
+    bool OutputFile::IsOpen() const
+    {
+        return m_handle != nullptr;
+    }
+
+    bool OutputFile::WriteAt(uint64_t offset, const void *data, size_t bytes)
+    {
+        const char *cursor = static_cast<const char *>(data);
+        while (bytes > 0)
+        {
+            // The handle is synchronous: the OVERLAPPED only carries the offset
+            OVERLAPPED position = {};
+            position.Offset = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            const DWORD chunk = static_cast<DWORD>(std::min<size_t>(bytes, 1u << 30));
+            DWORD written = 0;
+            if (!WriteFile(static_cast<HANDLE>(m_handle), cursor, chunk, &written, &position) || written == 0)
+                return false;
+            cursor += written;
+            offset += written;
+            bytes -= written;
+        }
+        return true;
+    }
+
+    bool OutputFile::Sync()
+    {
+        return m_handle && FlushFileBuffers(static_cast<HANDLE>(m_handle));
+    }
+
+    void OutputFile::Close()
+    {
+        if (m_handle)
+            CloseHandle(static_cast<HANDLE>(m_handle));
+        m_handle = nullptr;
+    }
+#else
+    bool OutputFile::Open(const std::string &path)
+    {
+        Close();
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return m_fd >= 0;
+    }
+
+    bool OutputFile::IsOpen() const
+    {
+        return m_fd >= 0;
+    }
+
+    bool OutputFile::WriteAt(uint64_t offset, const void *data, size_t bytes)
+    {
+        const char *cursor = static_cast<const char *>(data);
+        while (bytes > 0)
+        {
+            const ssize_t written = ::pwrite(m_fd, cursor, bytes, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            cursor += written;
+            offset += static_cast<uint64_t>(written);
+            bytes -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool OutputFile::Sync()
+    {
+        return m_fd >= 0 && ::fsync(m_fd) == 0;
+    }
+
+    void OutputFile::Close()
+    {
+        if (m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
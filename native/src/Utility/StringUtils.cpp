@@ -0,0 +1,51 @@
+#include "Utility/StringUtils.h"
+#include <windows.h>
+
+namespace Utility
+{
+    /**
+     * @brief Converts a wide Unicode string (std::wstring) to a UTF-8 encoded std::string.
+     *
+     * Uses Windows API `WideCharToMultiByte` to perform the conversion.
+     *
+     * @param wstr The wide-character string to convert.
+     * @return std::string UTF-8 encoded version of the input.
+     */
+    std::string WStringToUtf8(const std::wstring &wstr)
+    {
+        if (wstr.empty())
+            return {};
+
+        int sizeNeeded = WideCharToMultiByte(
+            CP_UTF8, 0, wstr.c_str(), static_cast<int>(wstr.size()),
+            nullptr, 0, nullptr, nullptr);
+
+        std::string result(sizeNeeded, 0);
+        WideCharToMultiByte(
+            CP_UTF8, 0, wstr.c_str(), static_cast<int>(wstr.size()),
+            &result[0], sizeNeeded, nullptr, nullptr);
+
+        return result;
+    }
+
+    /**
+     * @brief Converts a UTF-8 encoded string to a wide character string.
+     *
+     * Uses Windows API `MultiByteToWideChar` with the CP_UTF8 code page.
+     * Empty input returns an empty string without calling the API.
+     *
+     * @param str The input UTF-8 encoded string to convert.
+     * @return std::wstring The converted wide character string.
+     * @warning The input string must be valid UTF-8 encoded text.
+     */
+    std::wstring Utf8ToWString(const std::string &str)
+    {
+        if (str.empty())
+            return {};
+
+        int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), static_cast<int>(str.size()), nullptr, 0);
+        std::wstring result(sizeNeeded, 0);
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), static_cast<int>(str.size()), &result[0], sizeNeeded);
+        return result;
+    }
+}
@@ -10,74 +10,31 @@
 #include <napi.h>
 #include <Windows.h>
 #include <string>
-#include <iostream>
 #include "AudioSwitcher/AudioSwitcher.h"
+#include "AudioSwitcher/DefaultHistory.h"
+#include "AudioSwitcher/DeviceSnapshot.h"
+#include "AudioSwitcher/ServiceRecovery.h"
 #include "Utility/COMInitializer.h"
 #include <mmdeviceapi.h>
 #include "Utility/DeviceUtils.h"
 #include <Utility/SafeRelease.h>
+#include "Utility/Logger.h"
+#include "Utility/OperationSupervisor.h"
+#include "Utility/StringUtils.h"
+#include "Bindings/BindingUtils.h"
 using namespace AudioSwitcher;
 using namespace Utility;
+using namespace Bindings;
 
 /**
- * @brief Converts a wide Unicode string (std::wstring) to a UTF-8 encoded std::string.
- *
- * Uses Windows API `WideCharToMultiByte` to perform the conversion.
- *
- * @param wstr The wide-character string to convert.
- * @return std::string UTF-8 encoded version of the input.
- */
-std::string WStringToUtf8(const std::wstring &wstr)
-{
-    if (wstr.empty())
-        return {};
-
-    int sizeNeeded = WideCharToMultiByte(
-        CP_UTF8, 0, wstr.c_str(), static_cast<int>(wstr.size()),
-        nullptr, 0, nullptr, nullptr);
-
-    std::string result(sizeNeeded, 0);
-    WideCharToMultiByte(
-        CP_UTF8, 0, wstr.c_str(), static_cast<int>(wstr.size()),
-        &result[0], sizeNeeded, nullptr, nullptr);
-
-    return result;
-}
-
-/**
- * @file    StringConversion.h
- * @brief   Contains UTF-8 to wide string conversion utilities.
- */
-
-/**
- * @brief   Converts a UTF-8 encoded string to a wide character string.
- *
- * @details This function converts a UTF-8 encoded std::string to a std::wstring
- *          using Windows API MultiByteToWideChar function with CP_UTF8 code page.
- *          The function handles empty strings efficiently by returning an empty wstring.
- *
- * @param   str The input UTF-8 encoded string to convert.
- *
- * @return  std::wstring The converted wide character string.
- *
- * @note    This function is Windows-specific as it uses the Windows API.
- * @warning The input string must be valid UTF-8 encoded text.
- *
- * @example
- * std::string utf8Str = u8;
- * std::wstring wideStr = Utf8ToWString(utf8Str);
- * // wideStr now contains the wide character version
+ * @brief   Plain device record produced on the worker thread and converted to JS on the main thread.
  */
-std::wstring Utf8ToWString(const std::string &str)
+struct DeviceListEntry
 {
-    if (str.empty())
-        return {};
-
-    int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), static_cast<int>(str.size()), nullptr, 0);
-    std::wstring result(sizeNeeded, 0);
-    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), static_cast<int>(str.size()), &result[0], sizeNeeded);
-    return result;
-}
+    std::wstring id;
+    std::wstring name;
+    bool isDefault = false;
+};
 
 /**
  * @brief   Retrieves a list of available audio playback devices with default status.
@@ -124,57 +81,53 @@ Napi::Value ListDevices(const Napi::CallbackInfo &info)
 
     try
     {
-        // Initialize COM for audio device operations
-        // std::cout << "[C++] Initializing COM..." << std::endl;
-        COMInitializer com;
-
-        // Get current default device ID to compare against all devices
-        IMMDevice *defaultDevice = Utility::GetDefaultAudioPlaybackDevice();
-        std::wstring defaultIdW = L"";
-        if (defaultDevice)
-        {
-            LPWSTR buffer = nullptr;
-            HRESULT hr = defaultDevice->GetId(&buffer);
-            if (SUCCEEDED(hr) && buffer)
+        // Enumeration runs under the watchdog so a stuck driver cannot freeze the JS thread
+        auto devices = OperationSupervisor::Instance().Run(L"enumerate", []()
+                                                           {
+            // Initialize COM for audio device operations
+            COMInitializer com;
+
+            // Get current default device ID to compare against all devices
+            IMMDevice *defaultDevice = Utility::GetDefaultAudioPlaybackDevice();
+            std::wstring defaultIdW = L"";
+            if (defaultDevice)
             {
-                defaultIdW = buffer;
-                CoTaskMemFree(buffer);
+                LPWSTR buffer = nullptr;
+                HRESULT hr = defaultDevice->GetId(&buffer);
+                if (SUCCEEDED(hr) && buffer)
+                {
+                    defaultIdW = buffer;
+                    CoTaskMemFree(buffer);
+                }
+                Utility::SafeRelease(defaultDevice);
             }
-            Utility::SafeRelease(defaultDevice);
-        }
 
-        std::string defaultIdUtf8 = WStringToUtf8(defaultIdW);
+            // Retrieve system audio devices and keep only plain data
+            const EndpointKey defaultKey = EndpointKey::Intern(defaultIdW);
+            std::vector<DeviceListEntry> entries;
+            for (const AudioDevice &device : AudioManager::listOutputDevices())
+                entries.push_back({device.id, device.name, device.key == defaultKey});
+            return entries; });
 
-        // std::cout << "[C++] COM initialized." << std::endl;
-        // Retrieve system audio devices
-        auto devices = AudioManager::listOutputDevices();
-        // std::cout << "[C++] Devices found: " << devices.size() << std::endl;
         // Create JavaScript array for results
         Napi::Array result = Napi::Array::New(env, devices.size());
         // Convert each device to JavaScript object
         for (size_t i = 0; i < devices.size(); ++i)
         {
-            // Convert wide strings to UTF-8 for JavaScript
-            std::string name = WStringToUtf8(devices[i].name);
-            std::string id = WStringToUtf8(devices[i].id);
-
-            // std::cout << "[C++] Device " << i << ": " << name << std::endl;
             // Create device object with name, ID and default status
             Napi::Object obj = Napi::Object::New(env);
-            obj.Set("name", Napi::String::New(env, name));
-            obj.Set("id", Napi::String::New(env, id));
-            obj.Set("isDefault", Napi::Boolean::New(env, id == defaultIdUtf8));
+            obj.Set("name", Napi::String::New(env, WStringToUtf8(devices[i].name)));
+            obj.Set("id", Napi::String::New(env, WStringToUtf8(devices[i].id)));
+            obj.Set("isDefault", Napi::Boolean::New(env, devices[i].isDefault));
 
             result.Set(i, obj);
         }
 
         return result;
     }
-    catch (const std::exception &ex)
+    catch (...)
     {
-        std::cerr << "[C++] Exception: " << ex.what() << std::endl;
-        Napi::TypeError::New(env, ex.what()).ThrowAsJavaScriptException();
-        return env.Null();
+        return ThrowNativeError(env, nullptr);
     }
 }
 
@@ -232,19 +185,20 @@ Napi::Value SetDefaultPlaybackMute(const Napi::CallbackInfo &info)
 
     try
     {
-        // Initialize COM for audio device operations
-        COMInitializer com;
-
         // Attempt to set mute state and return operation result
-        bool success = Utility::SetDefaultPlaybackDeviceMute(mute);
+        bool success = OperationSupervisor::Instance().Run(L"default:render", [mute]()
+                                                           {
+            // Initialize COM for audio device operations
+            COMInitializer com;
+            return Utility::SetDefaultPlaybackDeviceMute(mute); });
+        if (success)
+            ServiceRecovery::Instance().RememberDefaultMute(mute); // replayed after a service restart
         return Napi::Boolean::New(env, success);
     }
     catch (...)
     {
         // Handle any errors during mute operation
-        Napi::Error::New(env, "Failed to set mute state for default playback device")
-            .ThrowAsJavaScriptException();
-        return env.Null();
+        return ThrowNativeError(env, "Failed to set mute state for default playback device");
     }
 }
 
@@ -259,10 +213,10 @@ Napi::Value SetDefaultPlaybackMute(const Napi::CallbackInfo &info)
  *          The operation performs these steps:
  *          1. Validates input parameters
  *          2. Initializes COM (required for Windows Core Audio API)
- *          3. Creates device enumerator instance
- *          4. Gets device interface directly by ID
- *          5. Applies mute state through Utility functions
- *          6. Returns operation success status
+ *          3. Gets device interface directly by ID through the shared enumerator
+ *             (created lazily on the first native call)
+ *          4. Applies mute state through Utility functions
+ *          5. Returns operation success status
  *
  * @param   info Napi::CallbackInfo containing:
  *              - deviceId: string (Device identifier from ListDevices())
@@ -317,47 +271,31 @@ Napi::Value MuteDeviceById(const Napi::CallbackInfo &info)
 
     try
     {
-        // Initialize COM for audio device operations (RAII ensures proper cleanup)
-        COMInitializer com;
-
-        // Create device enumerator instance
-        IMMDeviceEnumerator *enumerator = nullptr;
-        HRESULT hr = CoCreateInstance(
-            __uuidof(MMDeviceEnumerator),
-            nullptr,
-            CLSCTX_ALL,
-            __uuidof(IMMDeviceEnumerator),
-            (void **)&enumerator);
-
-        // Return false if enumerator creation failed
-        if (FAILED(hr) || !enumerator)
-        {
-            return Napi::Boolean::New(env, false);
-        }
+        bool result = OperationSupervisor::Instance().Run(deviceId, [deviceId, mute]()
+                                                          {
+            // Initialize COM for audio device operations (RAII ensures proper cleanup)
+            COMInitializer com;
 
-        // Get specific device interface by ID
-        IMMDevice *device = nullptr;
-        hr = enumerator->GetDevice(deviceId.c_str(), &device);
-        Utility::SafeRelease(enumerator); // Clean up enumerator immediately after use
+            // Get specific device interface by ID through the shared enumerator
+            IMMDevice *device = Utility::GetDeviceById(deviceId);
 
-        // Return false if device access failed
-        if (FAILED(hr) || !device)
-        {
-            return Napi::Boolean::New(env, false);
-        }
+            // Return false if device access failed
+            if (!device)
+                return false;
 
-        // Attempt mute operation and clean up device reference
-        bool result = Utility::MuteDevice(device, mute);
-        Utility::SafeRelease(device);
+            // Attempt mute operation and clean up device reference
+            bool muted = Utility::MuteDevice(device, mute);
+            Utility::SafeRelease(device);
+            return muted; });
 
+        if (result)
+            ServiceRecovery::Instance().RememberMute(deviceId, mute);
         return Napi::Boolean::New(env, result);
     }
     catch (...)
     {
         // Handle any unexpected errors during device operation
-        Napi::Error::New(env, "Failed to mute device - system error occurred")
-            .ThrowAsJavaScriptException();
-        return env.Null();
+        return ThrowNativeError(env, "Failed to mute device - system error occurred");
     }
 }
 
@@ -415,31 +353,146 @@ Napi::Value SetDefaultDevice(const Napi::CallbackInfo &info)
 
     try
     {
-        // Initialize COM for audio device operations
-        COMInitializer com;
-        // Get available output devices
-        auto devices = AudioManager::listOutputDevices();
-        // Verify device exists
-        auto it = std::find_if(devices.begin(), devices.end(), [&](const AudioDevice &dev)
-                               { return dev.id == deviceIdW; });
-
-        if (it == devices.end())
+        int outcome = OperationSupervisor::Instance().Run(deviceIdW, [deviceIdW]()
+                                                          {
+            // Initialize COM for audio device operations
+            COMInitializer com;
+            // Get available output devices
+            auto devices = AudioManager::listOutputDevices();
+            // Verify device exists. Looked up after enumeration, which interns any
+            // non-standard IDs the system reports; an unknown ID yields the empty key.
+            const EndpointKey key = EndpointKey::Lookup(deviceIdW);
+            auto it = std::find_if(devices.begin(), devices.end(), [&](const AudioDevice &dev)
+                                   { return dev.key == key; });
+
+            if (it == devices.end())
+                return -1;
+            // Attempt to set default device
+            return AudioManager::setDefaultOutputDevice(deviceIdW) ? 1 : 0; });
+
+        if (outcome < 0)
         {
-            std::wcerr << L"[C++] Device ID not found in list." << std::endl;
+            AUDIO_LOG(Warn, "setDefaultDevice", "Device ID not found in list: %s", deviceIdW);
             return Napi::Boolean::New(env, false);
         }
-        // Attempt to set default device
-        bool result = AudioManager::setDefaultOutputDevice(deviceIdW);
-        std::wcout << L"[C++] Set default result: " << (result ? L"Success" : L"Fail") << std::endl;
+        bool result = outcome > 0;
+        if (result)
+        {
+            DeviceSnapshot::Instance().Invalidate(); // default roles changed; rebuild on next query
+            ServiceRecovery::Instance().RememberDefault(static_cast<uint8_t>(eRender), deviceIdW);
+            const EndpointKey key = EndpointKey::Lookup(deviceIdW);
+            for (uint8_t role = 0; role < DefaultHistory::kRoles; ++role)
+                DefaultHistory::Instance().Record(static_cast<uint8_t>(eRender), role, key);
+        }
+        AUDIO_LOG(Info, "setDefaultDevice", "Set default %s: %s", deviceIdW, result ? "success" : "failed");
 
         return Napi::Boolean::New(env, result);
     }
-    catch (const std::exception &ex)
+    catch (...)
     {
-        std::cerr << "[C++] Exception: " << ex.what() << std::endl;
-        Napi::TypeError::New(env, ex.what()).ThrowAsJavaScriptException();
+        return ThrowNativeError(env, nullptr);
+    }
+}
+
+/**
+ * @brief   Configures the watchdog deadline applied to every native audio call.
+ *
+ * @details With a positive value, each call runs on a dedicated COM worker thread and the
+ *          JS caller receives an Error with `code === 'ETIMEDOUT'` if it does not complete
+ *          in time. The stuck worker is quarantined and replaced, and the device is marked
+ *          hung so later calls to it fail fast with `code === 'EDEVICEHUNG'` until the stuck
+ *          call returns. A value of 0 (default) runs calls directly on the JS thread.
+ *
+ * @param   info Napi::CallbackInfo containing:
+ *              - args[0]: Timeout in milliseconds (number, >= 0)
+ * @return  Napi::Value undefined
+ * @throws  Napi::TypeError When the argument is not a non-negative number
+ *
+ * @example
+ * // JavaScript usage:
+ * setOperationTimeout(2000);
+ */
+Napi::Value SetOperationTimeout(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() != 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().DoubleValue() < 0)
+    {
+        Napi::TypeError::New(env, "Expected one non-negative number (timeout in ms)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    int64_t timeoutMs = info[0].As<Napi::Number>().Int64Value();
+    OperationSupervisor::Instance().SetTimeout(std::chrono::milliseconds(timeoutMs));
+    return env.Undefined();
+}
+
+/**
+ * @brief   Returns the watchdog deadline in milliseconds (0 = supervision disabled).
+ *
+ * @param   info Napi::CallbackInfo (unused parameters)
+ * @return  Napi::Number Current timeout in milliseconds
+ */
+Napi::Value GetOperationTimeout(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    return Napi::Number::New(env, static_cast<double>(OperationSupervisor::Instance().GetTimeout().count()));
+}
+
+/**
+ * @brief   Returns the health records tracked by the watchdog.
+ *
+ * @details Keys are device IDs, or the pseudo keys `enumerate` and `default:render` for
+ *          calls that are not tied to a single device.
+ *
+ * @param   info Napi::CallbackInfo (unused parameters)
+ * @return  Napi::Array Array of objects in format:
+ *              `{ id: string, state: 'healthy'|'slow'|'hung', timeouts: number,
+ *                 lastLatencyMs: number, pending: boolean }`
+ */
+Napi::Value GetDeviceHealth(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    auto health = OperationSupervisor::Instance().GetHealth();
+    Napi::Array result = Napi::Array::New(env, health.size());
+    for (size_t i = 0; i < health.size(); ++i)
+    {
+        const DeviceHealth &record = health[i].second;
+        const char *state = record.state == DeviceHealthState::Hung   ? "hung"
+                            : record.state == DeviceHealthState::Slow ? "slow"
+                                                                      : "healthy";
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("id", Napi::String::New(env, WStringToUtf8(health[i].first)));
+        obj.Set("state", Napi::String::New(env, state));
+        obj.Set("timeouts", Napi::Number::New(env, record.timeouts));
+        obj.Set("lastLatencyMs", Napi::Number::New(env, record.lastLatencyMs));
+        obj.Set("pending", Napi::Boolean::New(env, record.pending));
+        result.Set(i, obj);
+    }
+    return result;
+}
+
+/**
+ * @brief   Clears the watchdog health record of a device so it is retried immediately.
+ *
+ * @param   info Napi::CallbackInfo containing:
+ *              - args[0]: Device ID string (or pseudo key)
+ * @return  Napi::Value undefined
+ */
+Napi::Value ResetDeviceHealth(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() != 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Device ID string expected").ThrowAsJavaScriptException();
         return env.Null();
     }
+
+    OperationSupervisor::Instance().ResetHealth(Utf8ToWString(info[0].As<Napi::String>().Utf8Value()));
+    return env.Undefined();
 }
 
 /**
@@ -452,6 +505,7 @@ Napi::Value SetDefaultDevice(const Napi::CallbackInfo &info)
  * audio.setDefaultDevice("deviceId");
  * audio.setDefaultPlaybackMute(true);
  * audio.muteDeviceById("deviceId", true);
+ * audio.setOperationTimeout(2000);
  * ```
  *
  * @param env The environment context
@@ -464,6 +518,25 @@ Napi::Object Init(Napi::Env env, Napi::Object exports)
     exports.Set("setDefaultDevice", Napi::Function::New(env, SetDefaultDevice));
     exports.Set("setDefaultPlaybackMute", Napi::Function::New(env, SetDefaultPlaybackMute));
     exports.Set("muteDeviceById", Napi::Function::New(env, MuteDeviceById));
+    exports.Set("setOperationTimeout", Napi::Function::New(env, SetOperationTimeout));
+    exports.Set("getOperationTimeout", Napi::Function::New(env, GetOperationTimeout));
+    exports.Set("getDeviceHealth", Napi::Function::New(env, GetDeviceHealth));
+    exports.Set("resetDeviceHealth", Napi::Function::New(env, ResetDeviceHealth));
+    InitRecoveryBindings(env, exports); // first, so its cache hooks run before the others
+    InitSnapshotBindings(env, exports);
+    InitRouterBindings(env, exports);
+    InitSessionBindings(env, exports);
+    InitNotificationBindings(env, exports);
+    InitLogBindings(env, exports);
+    InitSwitchBindings(env, exports);
+    InitAppRoutingBindings(env, exports);
+    InitTopologyBindings(env, exports);
+    InitSignalBindings(env, exports);
+    InitLatencyBindings(env, exports);
+    InitAggregateBindings(env, exports);
+    InitClipBindings(env, exports);
+    InitRecorderBindings(env, exports);
+    InitVoiceActivityBindings(env, exports);
     return exports;
 }
 
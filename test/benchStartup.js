@@ -0,0 +1,52 @@
+/**
+ * Startup benchmark: measures, in fresh Node processes, how long `require()` of the module
+ * takes versus the first native call (addon load + COM + enumerator setup) and a warm call.
+ *
+ * Usage: node ./test/benchStartup.js [runs]
+ */
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const RUNS = parseInt(process.argv[2], 10) || 10;
+const modulePath = path.join(__dirname, '..');
+
+const child = `
+const ms = (a, b) => Number(b - a) / 1e6;
+const t0 = process.hrtime.bigint();
+const audio = require(${JSON.stringify(modulePath)});
+const t1 = process.hrtime.bigint();
+let first = null, warm = null, error = null;
+try {
+    audio.listDevices();
+    const t2 = process.hrtime.bigint();
+    audio.listDevices();
+    const t3 = process.hrtime.bigint();
+    first = ms(t1, t2);
+    warm = ms(t2, t3);
+} catch (err) {
+    error = err.message;
+}
+process.stdout.write(JSON.stringify({ require: ms(t0, t1), first, warm, error }));
+`;
+
+function median(values) {
+    const sorted = values.slice().sort((a, b) => a - b);
+    return sorted[Math.floor(sorted.length / 2)];
+}
+
+const samples = [];
+for (let i = 0; i < RUNS; i++) {
+    samples.push(JSON.parse(execFileSync(process.execPath, ['-e', child], { encoding: 'utf8' })));
+}
+
+const requireMs = median(samples.map((s) => s.require));
+console.log(`[bench] ${RUNS} fresh processes`);
+console.log(`  require()          median ${requireMs.toFixed(3)} ms`);
+
+const ok = samples.filter((s) => s.first !== null);
+if (ok.length) {
+    console.log(`  first native call  median ${median(ok.map((s) => s.first)).toFixed(3)} ms (addon load + COM + enumerator)`);
+    console.log(`  warm native call   median ${median(ok.map((s) => s.warm)).toFixed(3)} ms`);
+} else {
+    console.log(`  first native call  unavailable: ${samples[0].error}`);
+}
@@ -0,0 +1,56 @@
+/**
+ * Switch-back benchmark (Windows, needs two active playback devices): measures toggling
+ * between two defaults with switchToPrevious() versus the listDevices() + setDefaultDevice()
+ * round trip a JS caller needed before, which enumerates every device on each switch.
+ * The original default is restored at the end.
+ *
+ * Usage: node ./test/benchSwitchBack.js [switches]
+ */
+const audio = require('..');
+
+const SWITCHES = parseInt(process.argv[2], 10) || 20;
+
+function median(values) {
+    const sorted = values.slice().sort((a, b) => a - b);
+    return sorted[Math.floor(sorted.length / 2)];
+}
+
+function timeMs(fn) {
+    const t0 = process.hrtime.bigint();
+    fn();
+    return Number(process.hrtime.bigint() - t0) / 1e6;
+}
+
+const devices = audio.listDevices();
+const original = devices.find((d) => d.isDefault);
+const other = devices.find((d) => !d.isDefault);
+if (!original || !other) {
+    console.log('[bench] needs at least two active playback devices; skipped');
+    process.exit(0);
+}
+
+// Seed the history with the two endpoints to toggle between
+audio.setDefaultDevice(other.id);
+audio.setDefaultDevice(original.id);
+
+const listAndSet = [];
+let previousId = other.id;
+for (let i = 0; i < SWITCHES; i++) {
+    listAndSet.push(timeMs(() => {
+        const target = audio.listDevices().find((d) => d.id === previousId);
+        const current = audio.listDevices().find((d) => d.isDefault);
+        audio.setDefaultDevice(target.id);
+        previousId = current.id;
+    }));
+}
+
+const switchBack = [];
+for (let i = 0; i < SWITCHES; i++) {
+    switchBack.push(timeMs(() => audio.switchToPrevious('all')));
+}
+
+audio.setDefaultDevice(original.id);
+
+console.log(`[bench] ${SWITCHES} switches between "${original.name}" and "${other.name}"`);
+console.log(`  listDevices + setDefaultDevice  median ${median(listAndSet).toFixed(3)} ms`);
+console.log(`  switchToPrevious('all')         median ${median(switchBack).toFixed(3)} ms`);
@@ -0,0 +1,415 @@
+/**
+ * @file AggregateTests.cpp
+ * @brief Tests for the broadcast ring and the aggregate (multi-endpoint) output.
+ *
+ * A simulated source device captures a 200 Hz tone on its own clock; simulated endpoints
+ * with different rates, clock offsets, buffer depths and output delays pull from it.
+ * Alignment is checked against ground truth: the phase of what each endpoint "plays"
+ * at the moment it is heard, compared with the tone the source captured targetLatency
+ * earlier.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/BroadcastRing.h"
+#include "Streaming/AggregatePipe.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kToneHz = 200.0;
+    constexpr double kSourceRate = 48000.0;
+    constexpr size_t kSourceBlock = 480;
+    constexpr double kTargetMs = 120.0;
+
+    /**
+     * @brief A simulated render endpoint. Its delay plus buffer, one block and one
+     *        source packet must fit in kTargetMs, or the audio it needs is not captured yet.
+     */
+    struct SimEndpoint
+    {
+        double rate = 48000.0;
+        double ppm = 0.0;
+        unsigned channels = 2;
+        size_t block = 480;
+        double bufferMs = 20.0; ///< How far ahead of playback the endpoint pulls.
+        double delayMs = 0.0;   ///< Delay after the render buffer (converter, radio link).
+        double offset = 0.0;    ///< Time its first frame leaves the render buffer.
+
+        // Filled by the simulation
+        std::unique_ptr<Streaming::AggregateTap> tap;
+        std::vector<float> buffer;
+        uint64_t frames = 0;
+        double sumSin = 0.0;
+        double sumCos = 0.0;
+        size_t windowFrames = 0;
+        double maxErrorUs = 0.0;
+        size_t windows = 0;
+
+        double RealRate() const { return rate * (1.0 + ppm * 1e-6); }
+        double LeaveTime(uint64_t frame) const { return offset + static_cast<double>(frame) / RealRate(); }
+    };
+
+    /**
+     * @brief Drives one source (10 ms packets, clock offset by sourcePpm) and several
+     *        endpoints in time order.
+     */
+    class AggregateSim
+    {
+    public:
+        AggregateSim(double sourcePpm, std::vector<SimEndpoint> endpoints)
+            : m_sourceRealRate(kSourceRate * (1.0 + sourcePpm * 1e-6)),
+              m_source(2, kSourceRate, 1000.0),
+              m_endpoints(std::move(endpoints))
+        {
+            m_sourceBuffer.resize(kSourceBlock * 2);
+            for (SimEndpoint &endpoint : m_endpoints)
+            {
+                endpoint.tap = std::make_unique<Streaming::AggregateTap>(m_source, endpoint.channels, endpoint.rate, kTargetMs,
+                                                                         endpoint.delayMs, endpoint.block);
+                endpoint.buffer.resize(endpoint.block * endpoint.channels);
+            }
+        }
+
+        Streaming::AggregateSource &Source() { return m_source; }
+        std::vector<SimEndpoint> &Endpoints() { return m_endpoints; }
+
+        /// Stops source packets in [start, end) (the capture device stalls).
+        void StallSource(double start, double end)
+        {
+            m_stallStart = start;
+            m_stallEnd = end;
+        }
+
+        /// Advances until @p until, measuring alignment in 0.25 s windows after @p measureFrom.
+        void Run(double until, double measureFrom)
+        {
+            for (;;)
+            {
+                const double sourceTime = static_cast<double>(m_sourceFrames + kSourceBlock) / m_sourceRealRate;
+                SimEndpoint *next = nullptr;
+                double nextTime = sourceTime;
+                for (SimEndpoint &endpoint : m_endpoints)
+                {
+                    const double call = endpoint.LeaveTime(endpoint.frames) - endpoint.bufferMs / 1000.0;
+                    if (call < nextTime)
+                    {
+                        nextTime = call;
+                        next = &endpoint;
+                    }
+                }
+                if (nextTime >= until)
+                    return;
+
+                if (!next)
+                    CaptureBlock(sourceTime);
+                else
+                    RenderBlock(*next, measureFrom);
+            }
+        }
+
+    private:
+        void CaptureBlock(double endTime)
+        {
+            for (size_t i = 0; i < kSourceBlock; ++i)
+            {
+                const double n = static_cast<double>(m_sourceFrames + i);
+                const float sample = static_cast<float>(0.5 * std::sin(2.0 * kPi * kToneHz * n / kSourceRate));
+                m_sourceBuffer[i * 2] = sample;
+                m_sourceBuffer[i * 2 + 1] = sample;
+            }
+            m_sourceFrames += kSourceBlock;
+            if (endTime < m_stallStart || endTime >= m_stallEnd)
+                m_source.Push(m_sourceBuffer.data(), kSourceBlock, endTime);
+        }
+
+        /// Pulls one block and correlates it with the tone that should be heard.
+        void RenderBlock(SimEndpoint &endpoint, double measureFrom)
+        {
+            const double leave = endpoint.LeaveTime(endpoint.frames);
+            endpoint.tap->Pull(endpoint.buffer.data(), endpoint.block, leave);
+
+            for (size_t f = 0; f < endpoint.block; ++f)
+            {
+                const double heard = endpoint.LeaveTime(endpoint.frames + f) + endpoint.delayMs / 1000.0;
+                if (heard < measureFrom)
+                    continue;
+                const double sourceFrame = (heard - kTargetMs / 1000.0) * m_sourceRealRate;
+                const double theta = 2.0 * kPi * kToneHz * sourceFrame / kSourceRate;
+                const double sample = endpoint.buffer[f * endpoint.channels];
+                endpoint.sumSin += sample * std::sin(theta);
+                endpoint.sumCos += sample * std::cos(theta);
+                if (++endpoint.windowFrames >= static_cast<size_t>(endpoint.rate / 4))
+                    CloseWindow(endpoint);
+            }
+            endpoint.frames += endpoint.block;
+        }
+
+        /// Output ~ sin(theta + phi); playing late by d seconds gives phi = -w * d.
+        void CloseWindow(SimEndpoint &endpoint)
+        {
+            const double phi = std::atan2(endpoint.sumCos, endpoint.sumSin);
+            const double errorUs = -phi / (2.0 * kPi * kToneHz * m_sourceRealRate / kSourceRate) * 1e6;
+            endpoint.maxErrorUs = std::max(endpoint.maxErrorUs, std::fabs(errorUs));
+            ++endpoint.windows;
+            endpoint.sumSin = endpoint.sumCos = 0.0;
+            endpoint.windowFrames = 0;
+        }
+
+        double m_sourceRealRate;
+        Streaming::AggregateSource m_source;
+        std::vector<SimEndpoint> m_endpoints;
+        std::vector<float> m_sourceBuffer;
+        uint64_t m_sourceFrames = 0;
+        double m_stallStart = 1e9;
+        double m_stallEnd = 1e9;
+    };
+
+    /// Speakers, a mono 44.1 kHz USB device and a 96 kHz interface behind a Bluetooth-like delay.
+    std::vector<SimEndpoint> RoomEndpoints()
+    {
+        std::vector<SimEndpoint> endpoints(3);
+        endpoints[0].ppm = 150.0;
+        endpoints[0].delayMs = 5.0;
+        endpoints[0].offset = 0.013;
+
+        endpoints[1].rate = 44100.0;
+        endpoints[1].ppm = -120.0;
+        endpoints[1].channels = 1;
+        endpoints[1].block = 441;
+        endpoints[1].bufferMs = 30.0;
+        endpoints[1].delayMs = 12.0;
+        endpoints[1].offset = 0.021;
+
+        endpoints[2].rate = 96000.0;
+        endpoints[2].ppm = 40.0;
+        endpoints[2].block = 672;
+        endpoints[2].bufferMs = 15.0;
+        endpoints[2].delayMs = 70.0;
+        endpoints[2].offset = 0.002;
+        return endpoints;
+    }
+}
+
+TEST_CASE("BroadcastRing gives every reader the full stream")
+{
+    Dsp::BroadcastRing<float> ring(100);
+    CHECK(ring.Capacity() == 128);
+
+    float data[40];
+    for (int i = 0; i < 40; ++i)
+        data[i] = static_cast<float>(i);
+    ring.Write(data, 40);
+
+    uint64_t fast = 0;
+    uint64_t slow = 0;
+    float out[40] = {};
+    CHECK(ring.Read(fast, out, 40).count == 40);
+    CHECK(out[39] == 39.0f && fast == 40);
+    CHECK(ring.Read(slow, out, 10).count == 10);
+    CHECK(out[0] == 0.0f && out[9] == 9.0f);
+    CHECK(ring.Read(fast, out, 10).count == 0);
+    CHECK(ring.Read(slow, out, 40).count == 30);
+    CHECK(out[0] == 10.0f);
+}
+
+TEST_CASE("BroadcastRing laps a reader that falls a ring behind")
+{
+    Dsp::BroadcastRing<float> ring(16);
+    float data[12] = {};
+    uint64_t cursor = 0;
+    for (int i = 0; i < 2; ++i)
+        ring.Write(data, 12);
+
+    float out[16];
+    const Dsp::BroadcastRing<float>::ReadResult result = ring.Read(cursor, out, 16);
+    CHECK(result.lapped);
+    CHECK(result.count == 0);
+    CHECK(cursor == 24);
+
+    ring.Write(data, 4);
+    CHECK(ring.Read(cursor, out, 16).count == 4);
+}
+
+TEST_CASE("BroadcastRing readers see consistent data across threads")
+{
+    // Values are their own stream position, so any torn or stale read is visible
+    Dsp::BroadcastRing<uint32_t> ring(4096);
+    constexpr uint32_t kCount = 2000000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&]()
+                         {
+        uint32_t block[61];
+        for (uint32_t next = 0; next < kCount; next += 61)
+        {
+            for (uint32_t i = 0; i < 61; ++i)
+                block[i] = next + i;
+            ring.Write(block, 61);
+            if ((next / 61) % 8 == 0)
+                std::this_thread::yield();
+        }
+        done = true; });
+
+    std::vector<int> consistent(3, 1);
+    std::vector<uint64_t> received(3, 0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&, r]()
+                             {
+            const size_t chunk = 37 + 40 * static_cast<size_t>(r);
+            std::vector<uint32_t> out(chunk);
+            uint64_t cursor = 0;
+            while (!done || cursor < ring.Head())
+            {
+                const uint64_t start = cursor;
+                const Dsp::BroadcastRing<uint32_t>::ReadResult result = ring.Read(cursor, out.data(), chunk);
+                for (size_t i = 0; i < result.count; ++i)
+                    consistent[r] &= out[i] == static_cast<uint32_t>(start + i);
+                received[r] += result.count;
+                if (r == 2)
+                    std::this_thread::yield(); // slow reader, lapped from time to time
+            } });
+    }
+    producer.join();
+    for (std::thread &reader : readers)
+        reader.join();
+
+    for (int r = 0; r < 3; ++r)
+    {
+        CHECK(consistent[r] == 1);
+        CHECK(received[r] > 0);
+    }
+}
+
+TEST_CASE("AggregateSource extrapolates its timeline")
+{
+    Streaming::AggregateSource source(2, 48000.0, 100.0);
+    CHECK(source.FramesAt(1.0) < 0.0);
+    CHECK(source.HistoryFrames() >= 4800);
+
+    std::vector<float> block(480 * 2, 0.0f);
+    source.Push(block.data(), 480, 0.01);
+    source.Push(block.data(), 480, 0.02);
+    CHECK(source.WrittenFrames() == 960);
+    CHECK_NEAR(source.FramesAt(0.02), 960.0, 1e-9);
+    CHECK_NEAR(source.FramesAt(0.025), 1200.0, 1e-6);
+    CHECK_NEAR(source.FramesAt(0.0), 0.0, 1e-6);
+}
+
+TEST_CASE("AggregateTap aligns endpoints with different clocks and delays")
+{
+    AggregateSim sim(80.0, RoomEndpoints());
+    sim.Run(60.0, 30.0);
+
+    for (SimEndpoint &endpoint : sim.Endpoints())
+    {
+        const Streaming::TapStats stats = endpoint.tap->Stats();
+        CHECK(stats.aligned);
+        CHECK(stats.underruns == 0);
+        CHECK(stats.laps == 0);
+        CHECK(endpoint.windows > 100);
+        // Within one 48 kHz sample of where the source says it should be
+        CHECK(endpoint.maxErrorUs < 20.0);
+        CHECK(std::fabs(stats.errorMs) < 0.02);
+        // Source frames per endpoint frame must grow by the relative clock offset
+        CHECK_NEAR(stats.correctionPpm, 80.0 - endpoint.ppm, 5.0);
+    }
+}
+
+TEST_CASE("AggregateTap realigns when the endpoint delay changes")
+{
+    AggregateSim sim(0.0, RoomEndpoints());
+    sim.Run(20.0, 1e9);
+
+    // A Bluetooth link reconnects with a longer delay: the measured value is updated
+    SimEndpoint &endpoint = sim.Endpoints()[2];
+    endpoint.delayMs = 85.0;
+    endpoint.tap->SetDelay(85.0);
+    sim.Run(40.0, 21.0);
+
+    CHECK(endpoint.tap->Stats().aligned);
+    CHECK_NEAR(endpoint.tap->Stats().delayMs, 85.0, 1e-9);
+    for (SimEndpoint &each : sim.Endpoints())
+        CHECK(each.maxErrorUs < 20.0);
+}
+
+TEST_CASE("AggregateTap recovers from a source stall")
+{
+    AggregateSim sim(-50.0, RoomEndpoints());
+    sim.StallSource(10.0, 10.5);
+    sim.Run(40.0, 1e9);
+
+    for (SimEndpoint &endpoint : sim.Endpoints())
+    {
+        const Streaming::TapStats stats = endpoint.tap->Stats();
+        CHECK(stats.underruns >= 1);
+        CHECK(stats.aligned);
+        CHECK(std::fabs(stats.errorMs) < 0.02);
+    }
+}
+
+TEST_CASE("AggregateTap skips ahead after falling a ring behind")
+{
+    Streaming::AggregateSource source(1, 48000.0, 50.0);
+    Streaming::AggregateTap tap(source, 1, 48000.0, 20.0, 0.0, 480);
+    std::vector<float> in(480, 0.5f);
+    std::vector<float> out(480);
+
+    double time = 0.0;
+    for (int i = 0; i < 10; ++i)
+    {
+        time += 0.01;
+        source.Push(in.data(), 480, time);
+        tap.Pull(out.data(), 480, time);
+    }
+    CHECK(tap.Stats().aligned);
+
+    // The render thread stalls for longer than the history
+    for (int i = 0; i < 20; ++i)
+    {
+        time += 0.01;
+        source.Push(in.data(), 480, time);
+    }
+    tap.Pull(out.data(), 480, time);
+    CHECK(tap.Stats().laps == 1);
+    CHECK(out[0] == 0.0f);
+
+    time += 0.01;
+    source.Push(in.data(), 480, time);
+    tap.Pull(out.data(), 480, time);
+    CHECK(tap.Stats().aligned);
+    CHECK_NEAR(out[240], 0.5, 1e-3);
+}
+
+BENCH_CASE("AggregateTap cost per endpoint (stereo 48k -> 44.1k)")
+{
+    Streaming::AggregateSource source(2, 48000.0, 500.0);
+    std::vector<Streaming::AggregateTap *> taps;
+    for (int i = 0; i < 4; ++i)
+        taps.push_back(new Streaming::AggregateTap(source, 2, 44100.0, 100.0, 0.0, 441));
+    std::vector<float> in(480 * 2, 0.1f);
+    std::vector<float> out(441 * 2);
+
+    const int blocks = 50000;
+    const double seconds = TestHarness::TimeSeconds([&]()
+                                                    {
+        for (int i = 0; i < blocks; ++i)
+        {
+            source.Push(in.data(), 480, i * 0.01);
+            for (Streaming::AggregateTap *tap : taps)
+                tap->Pull(out.data(), 441, i * 0.01);
+        } });
+    TestHarness::BenchReport("ns per 10 ms block per endpoint", seconds * 1e9 / (blocks * taps.size()), "ns");
+    TestHarness::BenchReport("realtime factor (4 endpoints)", blocks * 0.01 / seconds, "x");
+    for (Streaming::AggregateTap *tap : taps)
+        delete tap;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file AppRoutingTests.cpp
+ * @brief Tests for the per-application routing table against a simulated audio policy
+ *        (process list plus per-process endpoint assignments). The benchmark compares
+ *        applying a scene change as one batch with applying it one assignment at a time.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/AppRouting.h"
+
+#include <map>
+#include <tuple>
+
+using namespace AudioSwitcher;
+
+namespace
+{
+    constexpr uint8_t kRender = 0;
+    constexpr uint8_t kCapture = 1;
+    constexpr uint8_t kConsole = 0;
+    constexpr uint8_t kMultimedia = 1;
+    constexpr int32_t kInvalidArg = static_cast<int32_t>(0x80070057);
+
+    const std::wstring kHeadset = L"{0.0.0.00000000}.{headset}";
+    const std::wstring kSpeakers = L"{0.0.0.00000000}.{speakers}";
+    const std::wstring kHeadsetMic = L"{0.0.1.00000000}.{headset-mic}";
+
+    /**
+     * @brief What Windows would do, in memory: a process list and the endpoint each
+     *        process is routed to. Counts listings and writes.
+     */
+    class SimulatedAppPolicy : public AppPolicy
+    {
+    public:
+        void Start(uint32_t pid, const std::wstring &exe) { processes.push_back({pid, AppRoutingTable::NormalizeExe(exe)}); }
+
+        void Exit(uint32_t pid)
+        {
+            for (auto it = processes.begin(); it != processes.end(); ++it)
+            {
+                if (it->pid == pid)
+                {
+                    processes.erase(it);
+                    break;
+                }
+            }
+            for (auto it = routes.begin(); it != routes.end();)
+                it = std::get<0>(it->first) == pid ? routes.erase(it) : std::next(it);
+        }
+
+        std::wstring RouteOf(uint32_t pid, uint8_t flow, uint8_t role) const
+        {
+            auto it = routes.find({pid, flow, role});
+            return it == routes.end() ? std::wstring() : it->second;
+        }
+
+        bool ListProcesses(std::vector<AppProcess> &out) override
+        {
+            ++listings;
+            out = processes;
+            return true;
+        }
+
+        int32_t SetEndpoint(uint32_t pid, uint8_t flow, uint8_t role, const std::wstring &deviceId) override
+        {
+            ++writes;
+            bool running = false;
+            for (const AppProcess &process : processes)
+                running = running || process.pid == pid;
+            if (!running)
+                return kInvalidArg;
+            if (deviceId.empty())
+                routes.erase({pid, flow, role});
+            else
+                routes[{pid, flow, role}] = deviceId;
+            return 0;
+        }
+
+        int32_t ClearAll() override
+        {
+            routes.clear();
+            return 0;
+        }
+
+        std::vector<AppProcess> processes;
+        std::map<std::tuple<uint32_t, uint8_t, uint8_t>, std::wstring> routes;
+        int listings = 0;
+        int writes = 0;
+    };
+
+    AppAssignment ByExe(const std::wstring &exe, const std::wstring &id, uint8_t flow = kRender, uint8_t role = kConsole)
+    {
+        return AppAssignment{{0, AppRoutingTable::NormalizeExe(exe)}, flow, role, id};
+    }
+
+    AppAssignment ByPid(uint32_t pid, const std::wstring &id, uint8_t flow = kRender, uint8_t role = kConsole)
+    {
+        return AppAssignment{{pid, L""}, flow, role, id};
+    }
+}
+
+TEST_CASE("App routing normalizes executable names and paths")
+{
+    CHECK(AppRoutingTable::NormalizeExe(L"Teams.exe") == L"teams.exe");
+    CHECK(AppRoutingTable::NormalizeExe(L"C:\\Program Files\\Mozilla Firefox\\FIREFOX.EXE") == L"firefox.exe");
+    CHECK(AppRoutingTable::NormalizeExe(L"/opt/app/Bin") == L"bin");
+}
+
+TEST_CASE("App routing applies a scene with one process listing and caches routes")
+{
+    auto policy = std::make_shared<SimulatedAppPolicy>();
+    policy->Start(100, L"ms-teams.exe");
+    policy->Start(200, L"chrome.exe");
+    policy->Start(201, L"chrome.exe");
+    policy->Start(300, L"game.exe");
+    AppRoutingTable table(policy);
+
+    const AppBatchResult result = table.Apply({
+        ByExe(L"MS-Teams.exe", kHeadset),
+        ByExe(L"ms-teams.exe", kHeadsetMic, kCapture),
+        ByExe(L"chrome.exe", kSpeakers),
+        ByPid(300, kSpeakers, kRender, kMultimedia),
+        ByExe(L"obs64.exe", kSpeakers), // not running
+    });
+    CHECK(policy->listings == 1);
+    CHECK(result.applied == 5);
+    CHECK(result.unresolved == 1);
+    CHECK(result.failed == 0);
+    CHECK(policy->RouteOf(100, kRender, kConsole) == kHeadset);
+    CHECK(policy->RouteOf(100, kCapture, kConsole) == kHeadsetMic);
+    CHECK(policy->RouteOf(200, kRender, kConsole) == kSpeakers);
+    CHECK(policy->RouteOf(201, kRender, kConsole) == kSpeakers);
+    CHECK(policy->RouteOf(300, kRender, kMultimedia) == kSpeakers);
+
+    // The table answers from memory, including the unresolved assignment
+    const std::vector<AppRoute> routes = table.Routes();
+    CHECK(routes.size() == 5);
+    int chromePids = 0;
+    for (const AppRoute &route : routes)
+    {
+        if (route.assignment.target.exe == L"chrome.exe")
+            chromePids = static_cast<int>(route.pids.size());
+        if (route.assignment.target.exe == L"obs64.exe")
+            CHECK(route.pids.empty());
+    }
+    CHECK(chromePids == 2);
+    CHECK(policy->listings == 1);
+}
+
+TEST_CASE("App routing skips writes already in effect and lets later entries win")
+{
+    auto policy = std::make_shared<SimulatedAppPolicy>();
+    policy->Start(100, L"teams.exe");
+    policy->Start(200, L"chrome.exe");
+    AppRoutingTable table(policy);
+
+    table.Apply({ByExe(L"teams.exe", kHeadset), ByExe(L"chrome.exe", kSpeakers)});
+    const int writes = policy->writes;
+
+    // Same scene again: nothing to write
+    AppBatchResult result = table.Apply({ByExe(L"teams.exe", kHeadset), ByExe(L"chrome.exe", kSpeakers)});
+    CHECK(result.unchanged == 2);
+    CHECK(result.applied == 0);
+    CHECK(policy->writes == writes);
+
+    // Only the changed app is written; the last entry for an app wins
+    result = table.Apply({ByExe(L"chrome.exe", kHeadset), ByExe(L"teams.exe", kHeadset), ByExe(L"chrome.exe", kSpeakers)});
+    CHECK(result.applied == 0);
+    CHECK(result.unchanged == 2);
+    result = table.Apply({ByExe(L"chrome.exe", kSpeakers), ByExe(L"chrome.exe", kHeadset)});
+    CHECK(result.applied == 1);
+    CHECK(policy->RouteOf(200, kRender, kConsole) == kHeadset);
+
+    // An empty ID returns the app to the system default and drops it from the table
+    result = table.Apply({ByExe(L"chrome.exe", L"")});
+    CHECK(result.applied == 1);
+    CHECK(policy->RouteOf(200, kRender, kConsole).empty());
+    CHECK(table.Routes().size() == 1);
+
+    // After a service restart nothing is assumed about what Windows holds
+    table.Invalidate();
+    result = table.Apply({ByExe(L"teams.exe", kHeadset)});
+    CHECK(result.applied == 1);
+}
+
+TEST_CASE("App routing reconciles new processes and reports failures")
+{
+    auto policy = std::make_shared<SimulatedAppPolicy>();
+    policy->Start(200, L"chrome.exe");
+    AppRoutingTable table(policy);
+
+    AppBatchResult result = table.Apply({ByExe(L"chrome.exe", kSpeakers), ByExe(L"teams.exe", kHeadset)});
+    CHECK(result.applied == 1);
+    CHECK(result.unresolved == 1);
+
+    // Teams starts, chrome opens a second process, the first chrome process exits
+    policy->Start(100, L"Teams.exe");
+    policy->Start(202, L"chrome.exe");
+    policy->Exit(200);
+    result = table.Reconcile();
+    CHECK(result.applied == 2);
+    CHECK(result.unresolved == 0);
+    CHECK(policy->RouteOf(100, kRender, kConsole) == kHeadset);
+    CHECK(policy->RouteOf(202, kRender, kConsole) == kSpeakers);
+
+    // A pid assignment for a process that is gone fails with the policy's status
+    result = table.Apply({ByPid(999, kSpeakers)});
+    CHECK(result.failed == 1);
+    CHECK(result.lastError == kInvalidArg);
+    bool reported = false;
+    for (const AppRoute &route : table.Routes())
+        reported = reported || (route.assignment.target.pid == 999 && route.status == kInvalidArg);
+    CHECK(reported);
+
+    CHECK(table.Clear() == 0);
+    CHECK(table.Routes().empty());
+    CHECK(policy->routes.empty());
+}
+
+BENCH_CASE("App routing: scene change as one batch vs one call per app")
+{
+    constexpr int kProcesses = 300;
+    constexpr int kApps = 12;
+    constexpr int kScenes = 2000;
+
+    auto policy = std::make_shared<SimulatedAppPolicy>();
+    for (int i = 0; i < kProcesses; ++i)
+        policy->Start(static_cast<uint32_t>(1000 + i), L"app" + std::to_wstring(i % (kApps * 4)) + L".exe");
+
+    std::vector<AppAssignment> sceneA, sceneB;
+    for (int app = 0; app < kApps; ++app)
+    {
+        const std::wstring exe = L"app" + std::to_wstring(app) + L".exe";
+        sceneA.push_back(ByExe(exe, app % 2 ? kHeadset : kSpeakers));
+        sceneB.push_back(ByExe(exe, app % 3 ? kHeadset : kSpeakers));
+    }
+
+    AppRoutingTable batched(policy);
+    policy->listings = policy->writes = 0;
+    const double batchSeconds = TestHarness::TimeSeconds([&]()
+                                                         {
+        for (int n = 0; n < kScenes; ++n)
+            batched.Apply(n % 2 ? sceneB : sceneA); });
+    const int batchListings = policy->listings;
+    const int batchWrites = policy->writes;
+
+    AppRoutingTable single(policy);
+    policy->listings = policy->writes = 0;
+    const double singleSeconds = TestHarness::TimeSeconds([&]()
+                                                          {
+        for (int n = 0; n < kScenes; ++n)
+        {
+            single.Invalidate(); // a caller without the table cannot skip writes
+            for (const AppAssignment &assignment : n % 2 ? sceneB : sceneA)
+                single.Apply({assignment});
+        } });
+
+    TestHarness::BenchReport("Batched scene change", batchSeconds / kScenes * 1e6, "us");
+    TestHarness::BenchReport("  process listings per scene", static_cast<double>(batchListings) / kScenes, "");
+    TestHarness::BenchReport("  policy writes per scene", static_cast<double>(batchWrites) / kScenes, "");
+    TestHarness::BenchReport("One call per app", singleSeconds / kScenes * 1e6, "us");
+    TestHarness::BenchReport("  process listings per scene", static_cast<double>(policy->listings) / kScenes, "");
+    TestHarness::BenchReport("  policy writes per scene", static_cast<double>(policy->writes) / kScenes, "");
+}
@@ -0,0 +1,188 @@
+/**
+ * @file DefaultHistoryTests.cpp
+ * @brief Tests for the per-role MRU history of default endpoints behind switchToPrevious()
+ *        and cycleDefault(). The benchmark measures resolving the "switch back" target from
+ *        memory against the previous JS-side approach of listing every device and
+ *        searching the copies by ID string.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/DefaultHistory.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace AudioSwitcher;
+
+namespace
+{
+    constexpr uint8_t kRender = 0;
+    constexpr uint8_t kCapture = 1;
+    constexpr uint8_t kConsole = 0;
+    constexpr uint8_t kCommunications = 2;
+
+    std::wstring EndpointId(int index, int flow = 0)
+    {
+        wchar_t buffer[64];
+        swprintf(buffer, 64, L"{0.0.%d.00000000}.{%08x-1111-4222-8333-444455556666}", flow, index);
+        return buffer;
+    }
+
+    EndpointKey Key(int index, int flow = 0)
+    {
+        return EndpointKey::Intern(EndpointId(index, flow));
+    }
+
+    std::unordered_set<EndpointKey, EndpointKeyHash> Present(std::initializer_list<int> indices)
+    {
+        std::unordered_set<EndpointKey, EndpointKeyHash> present;
+        for (int index : indices)
+            present.insert(Key(index));
+        return present;
+    }
+}
+
+TEST_CASE("Default history keeps an MRU list per flow and role")
+{
+    DefaultHistory history;
+    CHECK(history.Current(kRender, kConsole).Empty());
+    CHECK(history.Record(kRender, kConsole, Key(1)));
+    CHECK(history.Record(kRender, kConsole, Key(2)));
+    CHECK(history.Record(kRender, kConsole, Key(3)));
+    CHECK(!history.Record(kRender, kConsole, Key(3))); // already current
+    CHECK(history.Record(kRender, kConsole, Key(1)));   // moves to the front, no duplicate
+
+    const std::vector<EndpointKey> expected = {Key(1), Key(3), Key(2)};
+    CHECK(history.Entries(kRender, kConsole) == expected);
+    CHECK(history.Current(kRender, kConsole) == Key(1));
+
+    // Roles and flows are independent
+    CHECK(history.Entries(kRender, kCommunications).empty());
+    history.Record(kCapture, kConsole, Key(9, 1));
+    CHECK(history.Current(kCapture, kConsole) == Key(9, 1));
+    CHECK(history.Current(kRender, kConsole) == Key(1));
+
+    // Out-of-range and empty input is ignored
+    CHECK(!history.Record(2, kConsole, Key(4)));
+    CHECK(!history.Record(kRender, 3, Key(4)));
+    CHECK(!history.Record(kRender, kConsole, EndpointKey()));
+
+    history.Clear();
+    CHECK(history.Entries(kRender, kConsole).empty());
+}
+
+TEST_CASE("Default history drops the oldest entry beyond its depth")
+{
+    DefaultHistory history;
+    for (int i = 0; i < static_cast<int>(DefaultHistory::kDepth) + 3; ++i)
+        history.Record(kRender, kConsole, Key(i));
+
+    const std::vector<EndpointKey> entries = history.Entries(kRender, kConsole);
+    CHECK(entries.size() == DefaultHistory::kDepth);
+    CHECK(entries.front() == Key(static_cast<int>(DefaultHistory::kDepth) + 2));
+    CHECK(entries.back() == Key(3));
+
+    // Re-recording the oldest entry keeps the size and moves it to the front
+    history.Record(kRender, kConsole, Key(3));
+    CHECK(history.Entries(kRender, kConsole).size() == DefaultHistory::kDepth);
+    CHECK(history.Current(kRender, kConsole) == Key(3));
+}
+
+TEST_CASE("Default history resolves the previous available endpoint")
+{
+    DefaultHistory history;
+    history.Record(kRender, kConsole, Key(1)); // speakers
+    history.Record(kRender, kConsole, Key(2)); // headset
+    history.Record(kRender, kConsole, Key(3)); // HDMI
+
+    auto present = Present({1, 2, 3});
+    auto available = [&](const EndpointKey &key)
+    { return present.count(key) != 0; };
+
+    CHECK(history.Previous(kRender, kConsole, Key(3), available) == Key(2));
+
+    // The headset was unplugged: skip to the one before it
+    present = Present({1, 3});
+    CHECK(history.Previous(kRender, kConsole, Key(3), available) == Key(1));
+
+    // The live default differs from the front entry (a change was missed): still skipped
+    present = Present({1, 2, 3});
+    CHECK(history.Previous(kRender, kConsole, Key(2), available) == Key(3));
+
+    // Nothing else available
+    present = Present({3});
+    CHECK(history.Previous(kRender, kConsole, Key(3), available).Empty());
+    CHECK(history.Previous(kRender, kCommunications, Key(3), available).Empty());
+}
+
+TEST_CASE("Cycling picks the candidate after the current default and wraps")
+{
+    const std::vector<EndpointKey> candidates = {Key(1), Key(2), Key(3)};
+    CHECK(DefaultHistory::CycleAfter(candidates, Key(1)) == Key(2));
+    CHECK(DefaultHistory::CycleAfter(candidates, Key(3)) == Key(1));
+    CHECK(DefaultHistory::CycleAfter(candidates, Key(7)) == Key(1)); // current is filtered out
+    CHECK(DefaultHistory::CycleAfter({}, Key(1)).Empty());
+    CHECK(DefaultHistory::CycleAfter({Key(1)}, Key(1)) == Key(1)); // caller treats "same" as no-op
+}
+
+BENCH_CASE("Switch-back target: MRU history vs list-and-search")
+{
+    constexpr int kEndpoints = 12;
+    constexpr int kIterations = 200000;
+
+    struct Endpoint
+    {
+        std::wstring id;
+        EndpointKey key;
+        std::wstring name;
+    };
+    std::vector<Endpoint> table;
+    for (int i = 0; i < kEndpoints; ++i)
+        table.push_back({EndpointId(i), Key(i), L"Endpoint " + std::to_wstring(i)});
+
+    DefaultHistory history;
+    history.Record(kRender, kConsole, table[4].key);
+    history.Record(kRender, kConsole, table[9].key);
+    const std::wstring previousId = table[4].id;
+    const std::wstring currentId = table[9].id;
+
+    // Snapshot path: the current default comes from the table, availability from a scan
+    // of its keys, and the result is an index into the table (no strings touched)
+    size_t sink = 0;
+    const double historySeconds = TestHarness::TimeSeconds([&]()
+                                                           {
+        for (int n = 0; n < kIterations; ++n)
+        {
+            const EndpointKey target = history.Previous(kRender, kConsole, table[9].key, [&](const EndpointKey &key)
+                                                        {
+                for (const Endpoint &endpoint : table)
+                    if (endpoint.key == key)
+                        return true;
+                return false; });
+            sink += static_cast<size_t>(target.Hash() & 1);
+        } });
+
+    // Previous approach: every switch lists all devices (copying id and name, as the
+    // binding does) and finds the remembered ID among them by string comparison
+    const double listSeconds = TestHarness::TimeSeconds([&]()
+                                                        {
+        for (int n = 0; n < kIterations; ++n)
+        {
+            std::vector<std::pair<std::wstring, std::wstring>> listed;
+            listed.reserve(table.size());
+            for (const Endpoint &endpoint : table)
+                listed.emplace_back(endpoint.id, endpoint.name);
+            for (const auto &device : listed)
+                if (device.first == previousId && device.first != currentId)
+                {
+                    sink += device.first.size() & 1;
+                    break;
+                }
+        } });
+
+    TestHarness::BenchReport("Resolve from MRU history", historySeconds / kIterations * 1e9, "ns");
+    TestHarness::BenchReport("List + search by ID (excl. COM)", listSeconds / kIterations * 1e9, "ns");
+    TestHarness::BenchReport("Checksum", static_cast<double>(sink & 1), "");
+}
@@ -0,0 +1,228 @@
+/**
+ * @file EndpointKeyTests.cpp
+ * @brief Tests for 128-bit endpoint keys: packing, round trips, interning of
+ *        non-standard IDs, a fuzz pass over mutated IDs, and lookup cost against
+ *        wide-string comparison.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/EndpointKey.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace AudioSwitcher;
+
+namespace
+{
+    /// Random standard endpoint ID (version 4 GUID, lowercase).
+    std::string RandomId(std::mt19937_64 &rng, int flow)
+    {
+        static const char kHex[] = "0123456789abcdef";
+        std::string id = "{0.0." + std::to_string(flow) + ".00000000}.{";
+        for (int i = 0; i < 32; ++i)
+        {
+            if (i == 8 || i == 12 || i == 16 || i == 20)
+                id += '-';
+            int value = static_cast<int>(rng() & 0xF);
+            if (i == 12)
+                value = 4;
+            if (i == 16)
+                value = 8 | (value & 3);
+            id += kHex[value];
+        }
+        return id + "}";
+    }
+
+    std::wstring Widen(const std::string &ascii) { return std::wstring(ascii.begin(), ascii.end()); }
+}
+
+TEST_CASE("Endpoint key packs standard IDs and round-trips them")
+{
+    const std::string render = "{0.0.0.00000000}.{5b3a8fe1-2a0e-4d43-bc1a-5d0e1f8c1234}";
+    const std::string capture = "{0.0.1.00000000}.{5b3a8fe1-2a0e-4d43-bc1a-5d0e1f8c1234}";
+
+    const EndpointKey renderKey = EndpointKey::Lookup(render);
+    const EndpointKey captureKey = EndpointKey::Lookup(capture);
+    CHECK(renderKey.IsPacked());
+    CHECK(captureKey.IsPacked());
+    CHECK(renderKey.Flow() == 0);
+    CHECK(captureKey.Flow() == 1);
+    CHECK(renderKey != captureKey); // same GUID, different flow
+    CHECK(renderKey.ToUtf8() == render);
+    CHECK(captureKey.ToUtf8() == capture);
+    CHECK(EndpointKey::Lookup(Widen(render)) == renderKey);
+    CHECK(renderKey.ToWString() == Widen(render));
+}
+
+TEST_CASE("Endpoint key interns non-standard IDs and looks them up without adding")
+{
+    const std::wstring virtualId = L"SWD\\MMDEVAPI\\VirtualCable.Output";
+    const std::string upper = "{0.0.0.00000000}.{5B3A8FE1-2A0E-4D43-BC1A-5D0E1F8C1234}";
+    const std::string version1 = "{0.0.0.00000000}.{5b3a8fe1-2a0e-1d43-bc1a-5d0e1f8c1234}";
+
+    CHECK(EndpointKey::Lookup(virtualId).Empty());
+    const EndpointKey key = EndpointKey::Intern(virtualId);
+    CHECK(!key.Empty());
+    CHECK(!key.IsPacked());
+    CHECK(key.Flow() == -1);
+    CHECK(EndpointKey::Lookup(virtualId) == key);
+    CHECK(EndpointKey::Intern(virtualId) == key);
+    CHECK(key.ToWString() == virtualId);
+
+    // Narrow and wide spellings of the same ID share a slot, including non-ASCII ones
+    const std::wstring accented = L"Virtual \u00e9\u4e2d\U0001F3A7 Mic";
+    const EndpointKey wideKey = EndpointKey::Intern(accented);
+    CHECK(EndpointKey::Lookup(std::string("Virtual \xc3\xa9\xe4\xb8\xad\xf0\x9f\x8e\xa7 Mic")) == wideKey);
+    CHECK(wideKey.ToWString() == accented);
+
+    // Not in the packed form, so they must stay distinct from the lowercase v4 spelling
+    const EndpointKey upperKey = EndpointKey::Intern(upper);
+    const EndpointKey v1Key = EndpointKey::Intern(version1);
+    CHECK(!upperKey.IsPacked() && !v1Key.IsPacked());
+    CHECK(upperKey.ToUtf8() == upper);
+    CHECK(v1Key.ToUtf8() == version1);
+    CHECK(upperKey != EndpointKey::Lookup(std::string("{0.0.0.00000000}.{5b3a8fe1-2a0e-4d43-bc1a-5d0e1f8c1234}")));
+
+    CHECK(EndpointKey().Empty());
+    CHECK(EndpointKey::Lookup(std::string()).Empty());
+    CHECK(EndpointKey().ToUtf8().empty());
+}
+
+TEST_CASE("Endpoint key fuzz: mutated IDs round-trip and keys agree with string equality")
+{
+    std::mt19937_64 rng(0xE17D);
+    const std::string alphabet = "{}.-0123456789abcdefABCDEFxyz \\#\x01";
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string id = RandomId(rng, static_cast<int>(rng() & 1));
+        switch (rng() % 6)
+        {
+        case 0: // keep as is
+            break;
+        case 1: // replace one character
+            id[rng() % id.size()] = alphabet[rng() % alphabet.size()];
+            break;
+        case 2: // truncate
+            id.resize(rng() % id.size());
+            break;
+        case 3: // insert
+            id.insert(id.begin() + static_cast<std::ptrdiff_t>(rng() % id.size()), alphabet[rng() % alphabet.size()]);
+            break;
+        case 4: // uppercase one hex digit
+            std::transform(id.begin() + 20, id.begin() + 21, id.begin() + 20, [](char c)
+                           { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+            break;
+        default: // flip the flow digit to something unexpected
+            id[5] = static_cast<char>('0' + rng() % 10);
+            break;
+        }
+        ids.push_back(id);
+        if (rng() % 4 == 0)
+            ids.push_back(id); // duplicates must map to the same key
+    }
+
+    std::vector<EndpointKey> keys;
+    for (const std::string &id : ids)
+    {
+        const EndpointKey key = EndpointKey::Intern(id);
+        CHECK(key.ToUtf8() == id || id.empty());
+        CHECK(EndpointKey::Lookup(Widen(id)) == key);
+        keys.push_back(key);
+    }
+
+    // Key equality must match string equality exactly
+    std::unordered_map<EndpointKey, std::string, EndpointKeyHash> byKey;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        auto inserted = byKey.emplace(keys[i], ids[i]);
+        CHECK(inserted.first->second == ids[i]);
+    }
+    const std::set<std::string> distinct(ids.begin(), ids.end());
+    CHECK(byKey.size() == distinct.size());
+}
+
+TEST_CASE("Endpoint key hash spreads packed and interned keys")
+{
+    std::mt19937_64 rng(7);
+    std::unordered_map<EndpointKey, int, EndpointKeyHash> map;
+    for (int i = 0; i < 4096; ++i)
+        map.emplace(EndpointKey::Lookup(RandomId(rng, i & 1)), i);
+    for (int i = 0; i < 256; ++i)
+        map.emplace(EndpointKey::Intern("virtual-" + std::to_string(i)), i);
+
+    size_t longest = 0;
+    for (size_t b = 0; b < map.bucket_count(); ++b)
+        longest = std::max(longest, map.bucket_size(b));
+    CHECK(map.size() == 4096 + 256);
+    CHECK(longest <= 8);
+}
+
+BENCH_CASE("Endpoint lookup: 128-bit key vs wide-string compare")
+{
+    constexpr int kDevices = 16;
+    constexpr int kLookups = 2000000;
+
+    // Real IDs share their first 18 characters, so string compares scan past the prefix
+    std::mt19937_64 rng(42);
+    std::vector<std::wstring> ids;
+    std::vector<EndpointKey> keys;
+    for (int i = 0; i < kDevices; ++i)
+    {
+        ids.push_back(Widen(RandomId(rng, i % 2)));
+        keys.push_back(EndpointKey::Lookup(ids.back()));
+    }
+    std::vector<std::wstring> probes(ids);
+    std::vector<EndpointKey> probeKeys(keys);
+
+    volatile size_t sink = 0;
+    const double linearString = TestHarness::TimeSeconds([&]()
+                                                         {
+        for (int i = 0; i < kLookups; ++i)
+        {
+            const std::wstring &probe = probes[i % kDevices];
+            sink = static_cast<size_t>(std::find(ids.begin(), ids.end(), probe) - ids.begin());
+        } });
+    const double linearKey = TestHarness::TimeSeconds([&]()
+                                                      {
+        for (int i = 0; i < kLookups; ++i)
+        {
+            const EndpointKey &probe = probeKeys[i % kDevices];
+            sink = static_cast<size_t>(std::find(keys.begin(), keys.end(), probe) - keys.begin());
+        } });
+
+    std::unordered_map<std::wstring, int> stringMap;
+    std::unordered_map<EndpointKey, int, EndpointKeyHash> keyMap;
+    for (int i = 0; i < kDevices; ++i)
+    {
+        stringMap.emplace(ids[i], i);
+        keyMap.emplace(keys[i], i);
+    }
+    const double hashedString = TestHarness::TimeSeconds([&]()
+                                                         {
+        for (int i = 0; i < kLookups; ++i)
+            sink = static_cast<size_t>(stringMap.find(probes[i % kDevices])->second); });
+    const double hashedKey = TestHarness::TimeSeconds([&]()
+                                                      {
+        for (int i = 0; i < kLookups; ++i)
+            sink = static_cast<size_t>(keyMap.find(probeKeys[i % kDevices])->second); });
+
+    const double parse = TestHarness::TimeSeconds([&]()
+                                                  {
+        for (int i = 0; i < kLookups; ++i)
+            sink = static_cast<size_t>(EndpointKey::Lookup(probes[i % kDevices]).Hash()); });
+    (void)sink;
+
+    TestHarness::BenchReport("Linear find, wstring ==", linearString / kLookups * 1e9, "ns");
+    TestHarness::BenchReport("Linear find, key ==", linearKey / kLookups * 1e9, "ns");
+    TestHarness::BenchReport("unordered_map<wstring>::find", hashedString / kLookups * 1e9, "ns");
+    TestHarness::BenchReport("unordered_map<EndpointKey>::find", hashedKey / kLookups * 1e9, "ns");
+    TestHarness::BenchReport("Parse wstring -> key", parse / kLookups * 1e9, "ns");
+}
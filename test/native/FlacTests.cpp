@@ -0,0 +1,395 @@
+/**
+ * @file FlacTests.cpp
+ * @brief FLAC encoder tests: bit-exact round trips through the decoder, MD5, thread
+ *        independence, damaged and cut-short streams, FLAC recordings, and an
+ *        encoding-speed benchmark.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/FlacDecoder.h"
+#include "Dsp/FlacEncoder.h"
+#include "Dsp/WavEncoder.h"
+#include "Streaming/RecordingSink.h"
+#include "Utility/Md5.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Dsp;
+using namespace Streaming;
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    /// Deterministic white noise in [-1, 1).
+    struct Noise
+    {
+        uint32_t state = 0x12345678u;
+        float Next()
+        {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<float>(static_cast<int32_t>(state)) / 2147483648.0f;
+        }
+    };
+
+    /// Something like music: a few decaying partials per channel, slow swells, a noise floor.
+    std::vector<float> Music(size_t frames, unsigned channels, uint32_t rate, float noiseLevel = 1e-4f)
+    {
+        Noise noise;
+        std::vector<float> samples(frames * channels);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const double t = double(i) / rate;
+            const double swell = 0.6 + 0.4 * std::sin(2.0 * kPi * 0.3 * t);
+            for (unsigned c = 0; c < channels; ++c)
+            {
+                double value = 0.0;
+                for (int h = 1; h <= 5; ++h)
+                    value += std::sin(2.0 * kPi * 220.0 * h * t * (1.0 + 0.002 * c) + c) / (h * 2.5);
+                samples[i * channels + c] = static_cast<float>(0.5 * swell * value) + noiseLevel * noise.Next();
+            }
+        }
+        return samples;
+    }
+
+    std::vector<int32_t> Quantized(const std::vector<float> &samples, unsigned bits)
+    {
+        std::vector<int32_t> values(samples.size());
+        QuantizeSamples(samples.data(), values.data(), samples.size(), bits);
+        return values;
+    }
+
+    std::vector<uint8_t> EncodeAll(const std::vector<int32_t> &samples, const FlacFormat &format,
+                                   FlacEncoderOptions options = {})
+    {
+        if (options.threads == 0)
+            options.threads = 1;
+        FlacEncoder encoder(format, options);
+        std::vector<uint8_t> stream = encoder.Header();
+        encoder.Encode(samples.data(), samples.size() / format.channels, stream);
+        const std::vector<uint8_t> header = encoder.FinalHeader();
+        std::copy(header.begin(), header.end(), stream.begin());
+        return stream;
+    }
+
+    std::vector<uint8_t> ReadFile(const std::string &path)
+    {
+        std::vector<uint8_t> bytes;
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            return bytes;
+        uint8_t chunk[65536];
+        size_t count = 0;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + count);
+        std::fclose(file);
+        return bytes;
+    }
+
+    std::string Hex(const uint8_t digest[16])
+    {
+        static const char kDigits[] = "0123456789abcdef";
+        std::string text;
+        for (int i = 0; i < 16; ++i)
+        {
+            text += kDigits[digest[i] >> 4];
+            text += kDigits[digest[i] & 15];
+        }
+        return text;
+    }
+}
+
+TEST_CASE("MD5 matches the RFC 1321 test vectors, in one piece or many")
+{
+    const char *inputs[] = {"", "abc", "message digest",
+                            "12345678901234567890123456789012345678901234567890123456789012345678901234567890"};
+    const char *digests[] = {"d41d8cd98f00b204e9800998ecf8427e", "900150983cd24fb0d6963f7d28e17f72",
+                             "f96b697d7cb7938d525a2f31aaf161d0", "57edf4a22be3c955ac49da2e2107b67a"};
+    for (int i = 0; i < 4; ++i)
+    {
+        const std::string text = inputs[i];
+        Utility::Md5 whole;
+        whole.Update(text.data(), text.size());
+        Utility::Md5 pieces;
+        for (size_t at = 0; at < text.size(); at += 7)
+            pieces.Update(text.data() + at, std::min<size_t>(7, text.size() - at));
+
+        uint8_t a[16], b[16];
+        whole.Finish(a);
+        pieces.Finish(b);
+        CHECK(Hex(a) == digests[i]);
+        CHECK(Hex(b) == digests[i]);
+    }
+}
+
+TEST_CASE("FLAC round trips are bit-exact across signals, widths, channel counts and frame sizes")
+{
+    struct Case
+    {
+        const char *name;
+        unsigned channels;
+        unsigned bits;
+        unsigned blockSize;
+        size_t frames;
+    };
+    const Case cases[] = {
+        {"stereo 24-bit", 2, 24, 4096, 48000},
+        {"stereo 16-bit", 2, 16, 4096, 30000},
+        {"mono 24-bit, 1152-frame blocks", 1, 24, 1152, 20000},
+        {"5.1 16-bit", 6, 16, 4096, 9000},
+        {"8 channels 24-bit, odd block size", 8, 24, 1000, 4321},
+        {"stereo 8-bit, 192-frame blocks", 2, 8, 192, 5000},
+        {"stereo 24-bit, tiny final frame", 2, 24, 4096, 4096 * 3 + 1},
+    };
+
+    for (const Case &test : cases)
+    {
+        FlacFormat format;
+        format.channels = test.channels;
+        format.bitsPerSample = test.bits;
+        FlacEncoderOptions options;
+        options.blockSize = test.blockSize;
+
+        // Music, full-scale noise, silence and clipped extremes, back to back
+        std::vector<float> signal = Music(test.frames, test.channels, format.sampleRate);
+        Noise noise;
+        for (size_t i = signal.size() / 4; i < signal.size() / 2; ++i)
+            signal[i] = noise.Next();
+        for (size_t i = signal.size() / 2; i < signal.size() * 5 / 8; ++i)
+            signal[i] = 0.0f;
+        for (size_t i = signal.size() * 5 / 8; i < signal.size() * 11 / 16; ++i)
+            signal[i] = (i / 37) % 2 ? 1.5f : -1.5f;
+
+        const std::vector<int32_t> input = Quantized(signal, test.bits);
+        const std::vector<uint8_t> stream = EncodeAll(input, format, options);
+        const FlacPcm decoded = DecodeFlacPcm(stream.data(), stream.size());
+
+        CHECK(decoded.sampleRate == format.sampleRate);
+        CHECK(decoded.channels == test.channels);
+        CHECK(decoded.bitsPerSample == test.bits);
+        CHECK(decoded.samples == input);
+        CHECK(decoded.md5Checked);
+        CHECK(!decoded.truncated);
+        if (decoded.samples != input)
+            std::printf("      mismatch in %s\n", test.name);
+    }
+
+    // Correlated stereo and 16-bit audio carried at 24 bits compress well
+    FlacFormat format;
+    const std::vector<float> music = Music(48000, 2, 48000);
+    const std::vector<int32_t> music24 = Quantized(music, 24);
+    const std::vector<uint8_t> stream = EncodeAll(music24, format);
+    CHECK(stream.size() < music24.size() * 3 * 6 / 10);
+
+    std::vector<int32_t> padded = Quantized(music, 16);
+    for (int32_t &value : padded)
+        value *= 256;
+    const std::vector<uint8_t> paddedStream = EncodeAll(padded, format);
+    CHECK(paddedStream.size() < padded.size() * 2 * 6 / 10);
+    CHECK(DecodeFlacPcm(paddedStream.data(), paddedStream.size()).samples == padded);
+}
+
+TEST_CASE("FLAC output does not depend on thread count or on how the input is split")
+{
+    FlacFormat format;
+    const std::vector<int32_t> input = Quantized(Music(4096 * 20 + 100, 2, 48000, 1e-3f), 24);
+    const size_t frames = input.size() / 2;
+
+    FlacEncoderOptions single;
+    single.threads = 1;
+    FlacEncoder one(format, single);
+    std::vector<uint8_t> a;
+    one.Encode(input.data(), frames, a);
+
+    FlacEncoderOptions pool;
+    pool.threads = 4;
+    FlacEncoder four(format, pool);
+    std::vector<uint8_t> b;
+    four.Encode(input.data(), 4096 * 8, b);
+    four.Encode(input.data() + 4096 * 8 * 2, 4096 * 4, b);
+    four.Encode(input.data() + 4096 * 12 * 2, frames - 4096 * 12, b);
+
+    CHECK(a == b);
+    const FlacTotals ta = one.Totals();
+    const FlacTotals tb = four.Totals();
+    CHECK(ta.frames == frames && tb.frames == frames);
+    CHECK(std::equal(ta.md5, ta.md5 + 16, tb.md5));
+    CHECK(ta.minFrameBytes > 0 && ta.minFrameBytes <= ta.maxFrameBytes);
+    CHECK(one.FinalHeader() == four.FinalHeader());
+
+    // Only the last frame may be short
+    bool threw = false;
+    try
+    {
+        four.Encode(input.data(), 4096, b);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST_CASE("FLAC decoding stops at the last whole frame of a cut-short stream and rejects damage")
+{
+    FlacFormat format;
+    const std::vector<int32_t> input = Quantized(Music(4096 * 6, 2, 48000), 24);
+
+    // As a crashed recorder leaves it: the first header (totals unknown), frames, then a partial frame
+    FlacEncoderOptions options;
+    options.threads = 1;
+    FlacEncoder encoder(format, options);
+    std::vector<uint8_t> stream = encoder.Header();
+    encoder.Encode(input.data(), 4096 * 4, stream);
+    const size_t fourFrames = stream.size();
+    encoder.Encode(input.data() + 4096 * 4 * 2, 4096 * 2, stream);
+
+    std::vector<uint8_t> cut(stream.begin(), stream.begin() + (fourFrames + stream.size()) / 2);
+    FlacPcm decoded = DecodeFlacPcm(cut.data(), cut.size());
+    CHECK(decoded.Frames() == 4096 * 5 || decoded.Frames() == 4096 * 4);
+    CHECK(std::equal(decoded.samples.begin(), decoded.samples.end(), input.begin()));
+    CHECK(!decoded.md5Checked);
+
+    // A tail of zeros (blocks allocated but never written) ends it the same way
+    std::vector<uint8_t> zeroTail(stream.begin(), stream.begin() + fourFrames);
+    zeroTail.resize(zeroTail.size() + 4096, 0);
+    decoded = DecodeFlacPcm(zeroTail.data(), zeroTail.size());
+    CHECK(decoded.Frames() == 4096 * 4);
+
+    // A flipped bit inside a frame fails its CRC
+    std::vector<uint8_t> damaged = stream;
+    damaged[kFlacHeaderBytes + 200] ^= 0x10;
+    bool threw = false;
+    try
+    {
+        DecodeFlacPcm(damaged.data(), damaged.size());
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(IsFlac(stream.data(), stream.size()));
+    CHECK(!IsFlac(reinterpret_cast<const uint8_t *>("RIFF"), 4));
+}
+
+TEST_CASE("FLAC recording is decodable while running and bit-exact after Close")
+{
+    const std::string path = "native_tests_recording.flac";
+    WavLayout layout;
+    layout.channels = 2;
+    layout.encoding = SampleEncoding::Int24;
+    layout.container = WavContainer::Flac;
+
+    RecordingOptions options;
+    options.path = path;
+    options.layout = layout;
+    options.blockBytes = 64 * 1024;
+    options.blocks = 4;
+    options.pollIntervalMs = 5;
+    options.patchIntervalMs = 20;
+    options.syncOnPatch = false;
+    options.flac.threads = 2;
+
+    const std::vector<float> signal = Music(48000 * 2 + 123, 2, 48000);
+    RecordingSink sink(options);
+    sink.Open();
+    const size_t half = signal.size() / 4;
+    for (size_t frame = 0; frame < half;)
+    {
+        const size_t step = std::min<size_t>(480, half - frame);
+        while (sink.WritableFrames() < step)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        frame += sink.Push(signal.data() + frame * 2, step);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    // Mid-recording: a valid stream of whatever frames have reached the file
+    const std::vector<int32_t> expected = Quantized(signal, 24);
+    std::vector<uint8_t> partial = ReadFile(path);
+    const FlacPcm running = DecodeFlacPcm(partial.data(), partial.size());
+    CHECK(running.Frames() > 0);
+    CHECK(std::equal(running.samples.begin(), running.samples.end(), expected.begin()));
+
+    for (size_t frame = half; frame < signal.size() / 2;)
+    {
+        const size_t step = std::min<size_t>(480, signal.size() / 2 - frame);
+        while (sink.WritableFrames() < step)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        frame += sink.Push(signal.data() + frame * 2, step);
+    }
+    sink.Close();
+
+    const RecordingStats stats = sink.Stats();
+    const std::vector<uint8_t> file = ReadFile(path);
+    const FlacPcm decoded = DecodeFlacPcm(file.data(), file.size());
+    CHECK(stats.droppedFrames == 0);
+    CHECK(decoded.samples == expected);
+    CHECK(decoded.md5Checked);
+    CHECK(stats.bytesWritten + kFlacHeaderBytes == file.size());
+    CHECK(stats.compression > 0.0 && stats.compression < 0.6);
+    CHECK(stats.encodeRealtime > 1.0);
+    std::remove(path.c_str());
+
+    // FLAC holds integers of at most 24 bits
+    options.layout.encoding = SampleEncoding::Float32;
+    RecordingSink floats(options);
+    bool threw = false;
+    try
+    {
+        floats.Open();
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+BENCH_CASE("FLAC encoding speed (x realtime per core) and size, 48 kHz stereo")
+{
+    constexpr size_t kFrames = 48000 * 60;
+    const std::vector<float> music = Music(kFrames, 2, 48000);
+
+    for (unsigned bits : {16u, 24u})
+    {
+        const std::vector<int32_t> input = Quantized(music, bits);
+        FlacFormat format;
+        format.bitsPerSample = bits;
+        const std::string label = bits == 16 ? "s16 stereo" : "s24 stereo";
+
+        FlacEncoderOptions options;
+        options.threads = 1;
+        FlacEncoder encoder(format, options);
+        std::vector<uint8_t> stream = encoder.Header();
+        stream.reserve(input.size() * 4);
+        const double seconds = TestHarness::TimeSeconds([&]()
+                                                        { encoder.Encode(input.data(), kFrames, stream); });
+        const double audioSeconds = double(kFrames) / 48000.0;
+        TestHarness::BenchReport((label + " encode, one core").c_str(), audioSeconds / seconds, "x realtime");
+        TestHarness::BenchReport((label + " CPU per 1 s of audio").c_str(), seconds / audioSeconds * 1e3, "ms");
+        TestHarness::BenchReport((label + " size vs PCM").c_str(), stream.size() * 100.0 / (input.size() * bits / 8), "%");
+
+        const double decodeSeconds = TestHarness::TimeSeconds([&]()
+                                                              { CHECK(DecodeFlacPcm(stream.data(), stream.size()).Frames() == kFrames); });
+        TestHarness::BenchReport((label + " decode + verify").c_str(), audioSeconds / decodeSeconds, "x realtime");
+    }
+
+    // The same minute spread over every core
+    FlacEncoderOptions options;
+    FlacFormat format;
+    FlacEncoder encoder(format, options);
+    const std::vector<int32_t> input = Quantized(music, 24);
+    std::vector<uint8_t> stream;
+    const double seconds = TestHarness::TimeSeconds([&]()
+                                                    { encoder.Encode(input.data(), kFrames, stream); });
+    TestHarness::BenchReport(("s24 stereo encode, " + std::to_string(encoder.Threads()) + " thread(s)").c_str(),
+                             kFrames / 48000.0 / seconds, "x realtime");
+}
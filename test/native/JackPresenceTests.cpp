@@ -0,0 +1,122 @@
+/**
+ * @file JackPresenceTests.cpp
+ * @brief Tests for jack presence summaries and the plug transitions the tracker reports
+ *        from endpoint notifications.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/JackPresence.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace AudioSwitcher;
+
+namespace
+{
+    EndpointKey Key(int index)
+    {
+        wchar_t id[64];
+        swprintf(id, 64, L"{0.0.0.00000000}.{%08x-1111-4222-8333-444444444444}", index);
+        return EndpointKey::Intern(id);
+    }
+
+    JackDescription Jack(uint32_t color, uint8_t connectionType, uint8_t geoLocation, bool connected)
+    {
+        JackDescription jack;
+        jack.color = color;
+        jack.connectionType = connectionType;
+        jack.geoLocation = geoLocation;
+        jack.connected = connected;
+        return jack;
+    }
+
+    JackState State(bool connected)
+    {
+        JackState state;
+        state.loaded = true;
+        state.present = true;
+        state.connected = connected;
+        return state;
+    }
+}
+
+TEST_CASE("Jack summary reports the connected jack, else the first one")
+{
+    JackState none = SummarizeJacks({});
+    CHECK(none.loaded);
+    CHECK(!none.present);
+    CHECK(!none.connected);
+
+    // Front green jack empty, rear lime jack in use: the one in use describes the endpoint
+    JackState rear = SummarizeJacks({Jack(0x00ff00, 1, 2, false), Jack(0x80ff00, 1, 1, true)});
+    CHECK(rear.present);
+    CHECK(rear.connected);
+    CHECK(rear.color == 0x80ff00);
+    CHECK(rear.geoLocation == 1);
+
+    JackState empty = SummarizeJacks({Jack(0xff0000, 5, 1, false), Jack(0x00ff00, 1, 2, false)});
+    CHECK(empty.present);
+    CHECK(!empty.connected);
+    CHECK(empty.color == 0xff0000);
+    CHECK(empty.connectionType == 5);
+}
+
+TEST_CASE("Jack tracker reports plug and unplug transitions once")
+{
+    JackTracker tracker;
+    tracker.Seed(Key(1), State(false));
+
+    CHECK(tracker.Update(Key(1), State(true), false) == JackTracker::Change::Connected);
+    // Repeated property changes with the plug still in are not new connections
+    CHECK(tracker.Update(Key(1), State(true), false) == JackTracker::Change::None);
+    CHECK(tracker.Update(Key(1), State(true), true) == JackTracker::Change::None);
+    CHECK(tracker.Update(Key(1), State(false), false) == JackTracker::Change::Disconnected);
+    CHECK(tracker.Update(Key(1), State(false), false) == JackTracker::Change::None);
+
+    JackState found;
+    CHECK(tracker.Find(Key(1), found));
+    CHECK(found.loaded && !found.connected);
+}
+
+TEST_CASE("Jack tracker only reports unknown endpoints that just appeared")
+{
+    JackTracker tracker;
+
+    // A property change on an endpoint never seen before says nothing about a plug event
+    CHECK(tracker.Update(Key(2), State(true), false) == JackTracker::Change::None);
+    CHECK(tracker.Update(Key(2), State(true), false) == JackTracker::Change::None);
+
+    // An endpoint that becomes active with something plugged in is a connection
+    CHECK(tracker.Update(Key(3), State(true), true) == JackTracker::Change::Connected);
+
+    tracker.Forget(Key(3));
+    JackState found;
+    CHECK(!tracker.Find(Key(3), found));
+    CHECK(tracker.Find(Key(2), found));
+
+    tracker.Clear();
+    CHECK(!tracker.Find(Key(2), found));
+    CHECK(tracker.Update(EndpointKey(), State(true), true) == JackTracker::Change::None);
+}
+
+TEST_CASE("Jack tracker counts each plug once under concurrent updates")
+{
+    JackTracker tracker;
+    tracker.Seed(Key(4), State(false));
+
+    // Several callback threads race to report the same plug: exactly one sees it
+    std::atomic<int> connected{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            if (tracker.Update(Key(4), State(true), false) == JackTracker::Change::Connected)
+                ++connected; });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    CHECK(connected.load() == 1);
+}
@@ -0,0 +1,328 @@
+/**
+ * @file LatencyTests.cpp
+ * @brief Tests for the latency measurement DSP: the FFT and correlation kernels on every
+ *        SIMD level, maximum length sequences, and delay estimation on synthetic captures.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/DelayEstimator.h"
+#include "Dsp/Fft.h"
+#include "Dsp/SignalGenerator.h"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Dsp;
+
+namespace
+{
+    constexpr double kRate = 48000.0;
+    constexpr double kPi = 3.14159265358979323846;
+
+    std::vector<const SimdKernels *> AllKernels()
+    {
+        std::vector<const SimdKernels *> kernels;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2})
+        {
+            if (const SimdKernels *k = KernelsFor(level))
+                kernels.push_back(k);
+        }
+        return kernels;
+    }
+
+    std::vector<float> RandomSignal(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        std::vector<float> values(count);
+        for (float &value : values)
+            value = uniform(random);
+        return values;
+    }
+
+    /**
+     * @brief @p reference delayed by @p delay frames (fractional delays use a
+     *        Blackman-windowed sinc), scaled by @p gain, plus white noise at @p noiseRms.
+     */
+    std::vector<float> Delayed(const std::vector<float> &reference, size_t frames, double delay, float gain,
+                               float noiseRms = 0.0f, uint32_t seed = 7)
+    {
+        constexpr int kHalfTaps = 32;
+        std::vector<float> capture(frames, 0.0f);
+        const double whole = std::floor(delay);
+        const double fraction = delay - whole;
+        for (int tap = -kHalfTaps; tap <= kHalfTaps; ++tap)
+        {
+            const double x = tap - fraction;
+            double weight = 1.0;
+            if (fraction != 0.0)
+            {
+                const double window = 0.42 + 0.5 * std::cos(kPi * x / (kHalfTaps + 1)) + 0.08 * std::cos(2.0 * kPi * x / (kHalfTaps + 1));
+                weight = (x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x)) * window;
+            }
+            else if (tap != 0)
+                continue;
+            for (size_t n = 0; n < reference.size(); ++n)
+            {
+                const long long index = static_cast<long long>(n) + static_cast<long long>(whole) + tap;
+                if (index >= 0 && index < static_cast<long long>(frames))
+                    capture[static_cast<size_t>(index)] += static_cast<float>(gain * weight * reference[n]);
+            }
+        }
+        if (noiseRms > 0.0f)
+        {
+            std::mt19937 random(seed);
+            std::normal_distribution<float> normal(0.0f, noiseRms);
+            for (float &sample : capture)
+                sample += normal(random);
+        }
+        return capture;
+    }
+}
+
+TEST_CASE("FFT matches a direct DFT and round-trips on every SIMD level")
+{
+    constexpr size_t kSize = 64;
+    const std::vector<float> re = RandomSignal(kSize, 1);
+    const std::vector<float> im = RandomSignal(kSize, 2);
+
+    std::vector<std::complex<double>> expected(kSize);
+    for (size_t k = 0; k < kSize; ++k)
+    {
+        for (size_t n = 0; n < kSize; ++n)
+            expected[k] += std::complex<double>(re[n], im[n]) * std::polar(1.0, -2.0 * kPi * double(k * n) / kSize);
+    }
+
+    for (const SimdKernels *kernels : AllKernels())
+    {
+        Fft fft(kSize, kernels);
+        std::vector<float> outRe = re, outIm = im;
+        fft.Forward(outRe.data(), outIm.data());
+        double error = 0.0;
+        for (size_t k = 0; k < kSize; ++k)
+            error = std::max(error, std::abs(std::complex<double>(outRe[k], outIm[k]) - expected[k]));
+        CHECK(error < 1e-4);
+
+        // A large transform comes back to the input within float rounding
+        Fft large(1 << 16, kernels);
+        std::vector<float> bigRe = RandomSignal(large.Size(), 3), bigIm(large.Size(), 0.0f);
+        const std::vector<float> original = bigRe;
+        large.Forward(bigRe.data(), bigIm.data());
+        large.Inverse(bigRe.data(), bigIm.data());
+        float worst = 0.0f;
+        for (size_t i = 0; i < original.size(); ++i)
+            worst = std::max({worst, std::fabs(bigRe[i] - original[i]), std::fabs(bigIm[i])});
+        CHECK(worst < 1e-5f);
+    }
+
+    bool threw = false;
+    try
+    {
+        Fft bad(48);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(Fft::SizeFor(1000) == 1024);
+    CHECK(Fft::SizeFor(1024) == 1024);
+}
+
+TEST_CASE("Correlation kernels agree with the scalar reference")
+{
+    constexpr size_t kCount = 1000; // multiple of 8, not of 16
+    const std::vector<float> aRe = RandomSignal(kCount, 4), aIm = RandomSignal(kCount, 5);
+    const std::vector<float> bRe = RandomSignal(kCount, 6), bIm = RandomSignal(kCount, 7);
+    const SimdKernels &scalar = *KernelsFor(SimdLevel::Scalar);
+
+    std::vector<float> expectedRe(kCount), expectedIm(kCount);
+    scalar.multiplyConjugate(expectedRe.data(), expectedIm.data(), aRe.data(), aIm.data(), bRe.data(), bIm.data(), kCount);
+    CHECK_NEAR(expectedRe[10], aRe[10] * bRe[10] + aIm[10] * bIm[10], 1e-6);
+    CHECK_NEAR(expectedIm[10], aIm[10] * bRe[10] - aRe[10] * bIm[10], 1e-6);
+
+    for (const SimdKernels *kernels : AllKernels())
+    {
+        // In place, as the estimator uses it
+        std::vector<float> re = aRe, im = aIm;
+        kernels->multiplyConjugate(re.data(), im.data(), re.data(), im.data(), bRe.data(), bIm.data(), kCount);
+        float worst = 0.0f;
+        for (size_t i = 0; i < kCount; ++i)
+            worst = std::max({worst, std::fabs(re[i] - expectedRe[i]), std::fabs(im[i] - expectedIm[i])});
+        CHECK(worst < 1e-6f);
+
+        // The peak is the largest magnitude, negative or not, and the first of equal ones
+        std::vector<float> values = RandomSignal(kCount, 8);
+        values[777] = -3.0f;
+        CHECK(kernels->peak(values.data(), kCount) == 777);
+        values[123] = 3.0f;
+        CHECK(kernels->peak(values.data(), kCount) == 123);
+        values[999] = 4.0f;
+        CHECK(kernels->peak(values.data(), kCount) == 999);
+    }
+}
+
+TEST_CASE("Maximum length sequences visit every state")
+{
+    for (unsigned order = 2; order <= 20; ++order)
+    {
+        const std::vector<float> sequence = MaximumLengthSequence(order, 0.5f);
+        const size_t length = (size_t(1) << order) - 1;
+        CHECK(sequence.size() == length);
+
+        // Maximal iff every run of `order` bits (read circularly) is distinct and non-zero
+        std::vector<bool> seen(length + 1, false);
+        size_t window = 0;
+        const size_t mask = length;
+        for (size_t i = 0; i < order - 1; ++i)
+            window = (window << 1) | (sequence[i] > 0.0f ? 1 : 0);
+        size_t distinct = 0;
+        for (size_t i = order - 1; i < length + order - 1; ++i)
+        {
+            window = ((window << 1) | (sequence[i % length] > 0.0f ? 1 : 0)) & mask;
+            if (window != 0 && !seen[window])
+            {
+                seen[window] = true;
+                ++distinct;
+            }
+        }
+        if (distinct != length)
+            TestHarness::ReportFailure(__FILE__, __LINE__, "MLS order " + std::to_string(order) + " is not maximal");
+    }
+
+    // The defining property: circular autocorrelation of L at lag 0 and -1 elsewhere
+    const std::vector<float> mls = MaximumLengthSequence(10, 1.0f);
+    for (size_t lag : {0u, 1u, 5u, 500u, 1022u})
+    {
+        double sum = 0.0;
+        for (size_t n = 0; n < mls.size(); ++n)
+            sum += double(mls[n]) * mls[(n + lag) % mls.size()];
+        CHECK_NEAR(sum, lag == 0 ? 1023.0 : -1.0, 1e-9);
+    }
+}
+
+TEST_CASE("Delay estimator finds integer and fractional delays on every SIMD level")
+{
+    const std::vector<float> mls = MaximumLengthSequence(14, 0.25f);
+    constexpr size_t kMaxLag = 48000;
+
+    for (const SimdKernels *kernels : AllKernels())
+    {
+        DelayEstimator estimator(mls.data(), mls.size(), kMaxLag, 10.0f, kernels);
+        CHECK(estimator.FftSize() == 65536);
+
+        for (double delay : {0.0, 1.0, 4800.0, 23456.0, double(kMaxLag)})
+        {
+            const std::vector<float> capture = Delayed(mls, estimator.CaptureFrames(), delay, 0.5f);
+            const DelayEstimate estimate = estimator.Estimate(capture.data(), capture.size());
+            CHECK(estimate.found);
+            CHECK_NEAR(estimate.lagFrames, delay, 1e-3);
+            CHECK(estimate.correlation > 0.99f);
+        }
+
+        for (double delay : {1234.25, 1234.5, 30000.8})
+        {
+            const std::vector<float> capture = Delayed(mls, estimator.CaptureFrames(), delay, 0.5f);
+            const DelayEstimate estimate = estimator.Estimate(capture.data(), capture.size());
+            CHECK(estimate.found);
+            CHECK_NEAR(estimate.lagFrames, delay, 0.25);
+        }
+    }
+}
+
+TEST_CASE("Delay estimator survives noise, attenuation and inversion, and rejects absence")
+{
+    const std::vector<float> mls = MaximumLengthSequence(14, 0.25f);
+    DelayEstimator estimator(mls.data(), mls.size(), 24000);
+
+    // -26 dB gain under noise 6 dB louder than the attenuated stimulus
+    std::vector<float> capture = Delayed(mls, estimator.CaptureFrames(), 9000.0, -0.05f, 0.025f);
+    DelayEstimate estimate = estimator.Estimate(capture.data(), capture.size());
+    CHECK(estimate.found);
+    CHECK_NEAR(estimate.lagFrames, 9000.0, 0.5);
+    CHECK(estimate.correlation < 0.6f);
+
+    // A truncated capture is zero-padded
+    capture = Delayed(mls, 20000, 2000.0, 0.3f);
+    estimate = estimator.Estimate(capture.data(), capture.size());
+    CHECK(estimate.found);
+    CHECK_NEAR(estimate.lagFrames, 2000.0, 1e-3);
+
+    // Noise alone has no prominent peak
+    std::vector<float> silence(estimator.CaptureFrames(), 0.0f);
+    CHECK(!estimator.Estimate(silence.data(), silence.size()).found);
+    const std::vector<float> noise = Delayed(std::vector<float>(), estimator.CaptureFrames(), 0.0, 0.0f, 0.1f);
+    CHECK(!estimator.Estimate(noise.data(), noise.size()).found);
+}
+
+TEST_CASE("Delay estimator locates a chirp")
+{
+    SignalSpec spec;
+    spec.type = SignalType::Sweep;
+    spec.frequency = 100.0;
+    spec.endFrequency = 16000.0;
+    spec.sweepSeconds = 16383.0 / kRate;
+    spec.levelDb = -12.0;
+    std::vector<float> chirp(16383);
+    SignalGenerator(spec, kRate).Render(chirp.data(), chirp.size());
+
+    DelayEstimator estimator(chirp.data(), chirp.size(), 48000);
+    for (double delay : {333.0, 7200.5, 47000.0})
+    {
+        const std::vector<float> capture = Delayed(chirp, estimator.CaptureFrames(), delay, 0.7f, 0.01f);
+        const DelayEstimate estimate = estimator.Estimate(capture.data(), capture.size());
+        CHECK(estimate.found);
+        CHECK_NEAR(estimate.lagFrames, delay, 0.25);
+    }
+}
+
+TEST_CASE("Delay statistics summarize repeated measurements")
+{
+    const DelayStatistics empty = SummarizeDelays({});
+    CHECK(empty.count == 0);
+    CHECK(empty.mean == 0.0);
+
+    const DelayStatistics stats = SummarizeDelays({40.0, 10.0, 30.0, 20.0, 50.0});
+    CHECK(stats.count == 5);
+    CHECK_NEAR(stats.min, 10.0, 1e-12);
+    CHECK_NEAR(stats.max, 50.0, 1e-12);
+    CHECK_NEAR(stats.mean, 30.0, 1e-12);
+    CHECK_NEAR(stats.median, 30.0, 1e-12);
+    CHECK_NEAR(stats.p95, 48.0, 1e-12);
+    CHECK_NEAR(stats.stdDev, std::sqrt(200.0), 1e-12);
+}
+
+BENCH_CASE("Delay estimation cost")
+{
+    const std::vector<float> mls = MaximumLengthSequence(14, 0.25f);
+    const std::vector<float> capture = Delayed(mls, mls.size() + 48000, 12345.0, 0.5f, 0.01f);
+    double sink = 0.0;
+
+    for (const SimdKernels *kernels : AllKernels())
+    {
+        Fft fft(65536, kernels);
+        std::vector<float> re = RandomSignal(fft.Size(), 9), im(fft.Size(), 0.0f);
+        constexpr int kTransforms = 200;
+        const double fftSeconds = TestHarness::TimeSeconds([&]()
+                                                           {
+            for (int n = 0; n < kTransforms; ++n)
+                fft.Forward(re.data(), im.data());
+            sink += re[1]; });
+        std::string label = std::string("FFT 65536 (") + kernels->name + ")";
+        TestHarness::BenchReport(label.c_str(), fftSeconds / kTransforms * 1e6, "us");
+
+        DelayEstimator estimator(mls.data(), mls.size(), 48000, 10.0f, kernels);
+        constexpr int kEstimates = 50;
+        const double seconds = TestHarness::TimeSeconds([&]()
+                                                        {
+            for (int n = 0; n < kEstimates; ++n)
+                sink += estimator.Estimate(capture.data(), capture.size()).lagFrames; });
+        label = std::string("Estimate, 1 s search (") + kernels->name + ")";
+        TestHarness::BenchReport(label.c_str(), seconds / kEstimates * 1e3, "ms");
+    }
+    TestHarness::BenchReport("Checksum", sink == 12345.0 ? 1.0 : 0.0, "");
+}
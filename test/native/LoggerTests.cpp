@@ -0,0 +1,264 @@
+/**
+ * @file LoggerTests.cpp
+ * @brief Tests for the asynchronous per-thread logger.
+ */
+
+#include "TestHarness.h"
+
+#include "Utility/Logger.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Utility;
+using namespace std::chrono_literals;
+
+namespace
+{
+    /// Sink that keeps copies of every record.
+    struct Capture
+    {
+        std::mutex mutex;
+        std::vector<LogEntry> records;
+
+        Logger::Sink Sink()
+        {
+            return [this](const std::vector<LogEntry> &batch)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                records.insert(records.end(), batch.begin(), batch.end());
+            };
+        }
+    };
+
+    int g_evaluations = 0;
+
+    int CountEvaluation()
+    {
+        return ++g_evaluations;
+    }
+
+    /// Logger whose background thread effectively never drains, so tests control Flush().
+    constexpr auto kManualDrain = std::chrono::milliseconds(3600 * 1000);
+}
+
+TEST_CASE("Logger is off by default and skips argument evaluation")
+{
+    CHECK(Logger::Instance().Level() == LogLevel::Off);
+    AUDIO_LOG(Error, "test", "value %d", CountEvaluation());
+    CHECK(g_evaluations == 0);
+
+    Logger logger;
+    Capture capture;
+    logger.SetSink(capture.Sink());
+    logger.Write(LogLevel::Error, "test", "dropped");
+    logger.Flush();
+    CHECK(capture.records.empty());
+    CHECK(logger.Stats().threads == 0);
+}
+
+TEST_CASE("Logger filters by level and formats records")
+{
+    Logger logger(64, kManualDrain);
+    Capture capture;
+    logger.SetSink(capture.Sink());
+    logger.SetLevel(LogLevel::Warn);
+
+    logger.Write(LogLevel::Info, "snapshot", "ignored");
+    logger.Write(LogLevel::Warn, "snapshot", "device %s missing (%d)", "{0.0.1}", 7);
+    logger.Write(LogLevel::Error, "binding", "%s", std::string(400, 'x').c_str());
+    logger.Flush();
+
+    CHECK(capture.records.size() == 2);
+    if (capture.records.size() == 2)
+    {
+        const LogEntry &warn = capture.records[0];
+        CHECK(warn.level == LogLevel::Warn);
+        CHECK(std::strcmp(warn.component, "snapshot") == 0);
+        CHECK(warn.message == "device {0.0.1} missing (7)");
+
+        const std::string line = Logger::FormatLine(warn);
+        CHECK(line.find("warn  [snapshot]") != std::string::npos);
+        CHECK(line.find("device {0.0.1} missing (7)") != std::string::npos);
+        CHECK(line.size() > 27 && line[10] == 'T' && line[26] == 'Z');
+
+        const std::string &longMessage = capture.records[1].message;
+        CHECK(longMessage.size() < kLogPayloadCapacity + 20);
+        CHECK(longMessage.find(" [truncated]") != std::string::npos);
+    }
+    CHECK(logger.Stats().written == 2);
+    CHECK(logger.Stats().dropped == 0);
+
+    LogLevel parsed = LogLevel::Off;
+    CHECK(Logger::ParseLevel("debug", parsed) && parsed == LogLevel::Debug);
+    CHECK(!Logger::ParseLevel("verbose", parsed));
+}
+
+TEST_CASE("Logger formats stored arguments on the drain thread")
+{
+    Logger logger(64, kManualDrain);
+    Capture capture;
+    logger.SetSink(capture.Sink());
+    logger.SetLevel(LogLevel::Trace);
+
+    const std::wstring wide = L"Speakers \u00e9";
+    logger.Write(LogLevel::Info, "fmt", "%s|%ls|%s", std::string("narrow"), wide, L"lit");
+    logger.Write(LogLevel::Info, "fmt", "%5d|%-3u|%08.3f|%x|%c|%lld", -42, 7u, 3.14159, 255u, 'Z', static_cast<long long>(1) << 40);
+    logger.Write(LogLevel::Info, "fmt", "%.2f%% of %d (%s)", 0.5f, 10);
+    logger.Write(LogLevel::Info, "fmt", "hr=0x%08lX ok=%d", static_cast<int32_t>(0x88890004u), true);
+    logger.Flush();
+
+    CHECK(capture.records.size() == 4);
+    if (capture.records.size() == 4)
+    {
+        CHECK(capture.records[0].message == "narrow|Speakers \xc3\xa9|lit");
+        CHECK(capture.records[1].message == "  -42|7  |0003.142|ff|Z|1099511627776");
+        CHECK(capture.records[2].message == "0.50% of 10 (%s)");
+        CHECK(capture.records[3].message == "hr=0x88890004 ok=1");
+    }
+}
+
+TEST_CASE("Logger drops records when a thread's ring is full instead of blocking")
+{
+    Logger logger(16, kManualDrain);
+    Capture capture;
+    logger.SetSink(capture.Sink());
+    logger.SetLevel(LogLevel::Info);
+
+    for (int i = 0; i < 100; ++i)
+        logger.Write(LogLevel::Info, "test", "%d", i);
+    logger.Flush();
+
+    CHECK(capture.records.size() == 16);
+    CHECK(logger.Stats().dropped == 84);
+    if (!capture.records.empty())
+        CHECK(capture.records[0].message == "0");
+}
+
+TEST_CASE("Logger keeps per-thread order across threads and frees rings of exited threads")
+{
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 1000;
+
+    Logger logger(2048, 2ms);
+    Capture capture;
+    logger.SetSink(capture.Sink());
+    logger.SetLevel(LogLevel::Debug);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t)
+        threads.emplace_back([&logger, t]()
+                             {
+            for (int i = 0; i < kPerThread; ++i)
+                logger.Write(LogLevel::Debug, "worker", "%d %d", t, i); });
+    for (std::thread &thread : threads)
+        thread.join();
+
+    logger.Flush();
+    CHECK(capture.records.size() == static_cast<size_t>(kThreads * kPerThread));
+
+    std::vector<int> next(kThreads, 0);
+    bool ordered = true;
+    for (const LogEntry &entry : capture.records)
+    {
+        int t = -1;
+        int i = -1;
+        std::sscanf(entry.message.c_str(), "%d %d", &t, &i);
+        ordered = ordered && t >= 0 && t < kThreads && i == next[t];
+        if (t >= 0 && t < kThreads)
+            next[t] = i + 1;
+    }
+    CHECK(ordered);
+
+    // The exited threads' rings are released by the next drain pass
+    logger.Flush();
+    CHECK(logger.Stats().threads == 0);
+    CHECK(logger.Stats().dropped == 0);
+}
+
+TEST_CASE("Logger file sink appends one line per record")
+{
+    const std::string path = "native_tests_logger.log";
+    std::remove(path.c_str());
+    {
+        Logger logger(64, kManualDrain);
+        Logger::Sink sink = Logger::FileSink(path);
+        CHECK(static_cast<bool>(sink));
+        logger.SetSink(sink);
+        logger.SetLevel(LogLevel::Info);
+        logger.Write(LogLevel::Info, "file", "first");
+        logger.Write(LogLevel::Error, "file", "second");
+    } // destructor drains
+
+    std::FILE *file = std::fopen(path.c_str(), "r");
+    CHECK(file != nullptr);
+    if (file)
+    {
+        char line[512];
+        std::vector<std::string> lines;
+        while (std::fgets(line, sizeof(line), file))
+            lines.push_back(line);
+        std::fclose(file);
+        CHECK(lines.size() == 2);
+        if (lines.size() == 2)
+        {
+            CHECK(lines[0].find("info  [file]") != std::string::npos && lines[0].find("first") != std::string::npos);
+            CHECK(lines[1].find("error [file]") != std::string::npos);
+        }
+    }
+    std::remove(path.c_str());
+    CHECK(!Logger::FileSink("/nonexistent-dir/x/y.log"));
+}
+
+BENCH_CASE("Logger cost per call")
+{
+    constexpr int kCalls = 1000000;
+    constexpr int kBurst = 1 << 15; ///< Per thread: exactly one ring, so the producer is measured alone
+
+    const double disabled = TestHarness::TimeSeconds([&]()
+                                                     {
+        for (int i = 0; i < kCalls; ++i)
+            AUDIO_LOG(Info, "bench", "call %d", i); });
+    TestHarness::BenchReport("Disabled AUDIO_LOG", disabled / kCalls * 1e9, "ns/call");
+
+    Logger logger(kBurst, kManualDrain);
+    std::atomic<uint64_t> received{0};
+    logger.SetSink([&](const std::vector<LogEntry> &entries)
+                   { received += entries.size(); });
+    logger.SetLevel(LogLevel::Info);
+
+    for (int threads : {1, 4})
+    {
+        std::vector<double> perCall(threads, 0.0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&logger, &perCall, t]()
+                                 {
+                auto burst = [&logger]()
+                {
+                    for (int i = 0; i < kBurst; ++i)
+                        logger.Write(LogLevel::Info, "bench", "device %s volume %.2f step %d", "{0.0.0.00000000}", 0.5, i);
+                };
+                burst(); // registers the ring and faults its pages in
+                logger.Flush();
+                perCall[t] = TestHarness::TimeSeconds(burst) / kBurst * 1e9; });
+        for (std::thread &worker : workers)
+            worker.join();
+
+        double average = 0.0;
+        for (double value : perCall)
+            average += value / threads;
+        const std::string label = "Enabled Write, " + std::to_string(threads) + " thread(s)";
+        TestHarness::BenchReport(label.c_str(), average, "ns/call");
+
+        const double drain = TestHarness::TimeSeconds([&]()
+                                                      { logger.Flush(); });
+        TestHarness::BenchReport("  drain + format on logger thread", drain / (threads * kBurst) * 1e9, "ns/record");
+    }
+    TestHarness::BenchReport("Dropped", static_cast<double>(logger.Stats().dropped), "records");
+}
@@ -0,0 +1,386 @@
+/**
+ * @file NotificationTests.cpp
+ * @brief Tests for the MPSC queue and the notification dispatcher (batching, folding,
+ *        repeat suppression, metrics).
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/NotificationDispatcher.h"
+#include "Utility/MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace AudioSwitcher;
+using namespace std::chrono_literals;
+
+namespace
+{
+    /**
+     * @brief Sink that records batches and lets the test wait for them.
+     */
+    class Collector
+    {
+    public:
+        NotificationDispatcher::Sink Sink()
+        {
+            return [this](std::vector<Notification> &&batch)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_batches.push_back(std::move(batch));
+                m_changed.notify_all();
+            };
+        }
+
+        /// Waits until at least @p count batches arrived; returns false on timeout.
+        bool WaitBatches(size_t count, std::chrono::milliseconds timeout = 2000ms)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            return m_changed.wait_for(lock, timeout, [&]()
+                                      { return m_batches.size() >= count; });
+        }
+
+        std::vector<std::vector<Notification>> Batches()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_batches;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        std::vector<std::vector<Notification>> m_batches;
+    };
+
+    Notification Volume(const std::wstring &id, float volume, bool muted = false)
+    {
+        Notification n;
+        n.kind = NotificationKind::VolumeChanged;
+        n.deviceId = id;
+        n.volume = volume;
+        n.muted = muted;
+        return n;
+    }
+
+    Notification Default(uint8_t flow, uint8_t role, const std::wstring &id)
+    {
+        Notification n;
+        n.kind = NotificationKind::DefaultChanged;
+        n.flow = flow;
+        n.role = role;
+        n.deviceId = id;
+        return n;
+    }
+
+    Notification Presence(NotificationKind kind, const std::wstring &id)
+    {
+        Notification n;
+        n.kind = kind;
+        n.deviceId = id;
+        return n;
+    }
+
+    DispatcherOptions Window(std::chrono::microseconds window)
+    {
+        DispatcherOptions options;
+        options.batchWindow = window;
+        return options;
+    }
+}
+
+TEST_CASE("MpscQueue keeps per-producer order across concurrent producers")
+{
+    constexpr uint32_t kProducers = 4;
+    constexpr uint32_t kPerProducer = 100000;
+    Utility::MpscQueue<uint64_t> queue;
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; ++p)
+        producers.emplace_back([&queue, p]()
+                               {
+            for (uint32_t i = 0; i < kPerProducer; ++i)
+                queue.Push((static_cast<uint64_t>(p) << 32) | i); });
+
+    std::vector<uint32_t> next(kProducers, 0);
+    uint64_t received = 0;
+    bool ordered = true;
+    while (received < static_cast<uint64_t>(kProducers) * kPerProducer)
+    {
+        uint64_t value = 0;
+        if (!queue.TryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const uint32_t producer = static_cast<uint32_t>(value >> 32);
+        const uint32_t sequence = static_cast<uint32_t>(value);
+        ordered = ordered && producer < kProducers && sequence == next[producer];
+        if (producer < kProducers)
+            next[producer] = sequence + 1;
+        ++received;
+    }
+    for (std::thread &producer : producers)
+        producer.join();
+
+    CHECK(ordered);
+    CHECK(queue.Size() == 0);
+    CHECK(queue.HighWater() >= 1);
+    CHECK(queue.HighWater() <= static_cast<size_t>(kProducers) * kPerProducer);
+}
+
+TEST_CASE("Dispatcher folds a burst into one batch, keeping first position and last payload")
+{
+    Collector collector;
+    NotificationDispatcher dispatcher(collector.Sink(), Window(100ms));
+
+    for (int i = 1; i <= 100; ++i)
+        dispatcher.Post(Volume(L"A", i / 100.0f));
+    dispatcher.Post(Volume(L"B", 0.25f));
+    dispatcher.Post(Volume(L"A", 0.5f, true));
+
+    CHECK(collector.WaitBatches(1));
+    auto batches = collector.Batches();
+    CHECK(batches.size() == 1);
+    if (batches.size() == 1 && batches[0].size() == 2)
+    {
+        CHECK(batches[0][0].deviceId == L"A");
+        CHECK(batches[0][0].volume == 0.5f);
+        CHECK(batches[0][0].muted);
+        CHECK(batches[0][0].coalesced == 100);
+        CHECK(batches[0][1].deviceId == L"B");
+        CHECK(batches[0][1].coalesced == 0);
+    }
+    else
+    {
+        CHECK(false);
+    }
+
+    const DispatcherStats stats = dispatcher.Stats();
+    CHECK(stats.posted == 102);
+    CHECK(stats.coalesced == 100);
+    CHECK(stats.delivered == 2);
+    CHECK(stats.batches == 1);
+}
+
+TEST_CASE("Dispatcher drops default and volume notifications that repeat the delivered value")
+{
+    Collector collector;
+    NotificationDispatcher dispatcher(collector.Sink(), Window(0us));
+
+    dispatcher.Post(Volume(L"A", 0.5f));
+    CHECK(collector.WaitBatches(1));
+    dispatcher.Post(Volume(L"A", 0.5f));
+    dispatcher.Post(Default(0, 1, L"A"));
+    CHECK(collector.WaitBatches(2));
+    dispatcher.Post(Default(0, 1, L"A"));
+    dispatcher.Post(Volume(L"A", 0.6f));
+    CHECK(collector.WaitBatches(3));
+
+    auto batches = collector.Batches();
+    size_t volumes = 0;
+    size_t defaults = 0;
+    for (const auto &batch : batches)
+        for (const Notification &n : batch)
+            (n.kind == NotificationKind::VolumeChanged ? volumes : defaults)++;
+    CHECK(volumes == 2);
+    CHECK(defaults == 1);
+    CHECK(dispatcher.Stats().suppressed == 2);
+}
+
+TEST_CASE("Dispatcher keeps default changes per role apart and settles flapping devices")
+{
+    Collector collector;
+    NotificationDispatcher dispatcher(collector.Sink(), Window(100ms));
+
+    dispatcher.Post(Default(0, 0, L"A"));
+    dispatcher.Post(Default(0, 1, L"A"));
+    dispatcher.Post(Default(1, 0, L"M"));
+    dispatcher.Post(Presence(NotificationKind::DeviceAdded, L"X"));
+    dispatcher.Post(Presence(NotificationKind::DeviceRemoved, L"X"));
+    dispatcher.Post(Default(0, 0, L"B"));
+
+    CHECK(collector.WaitBatches(1));
+    auto batches = collector.Batches();
+    CHECK(batches.size() == 1 && batches[0].size() == 4);
+    if (batches.size() == 1 && batches[0].size() == 4)
+    {
+        CHECK(batches[0][0].deviceId == L"B"); // render/console: latest wins
+        CHECK(batches[0][1].role == 1);
+        CHECK(batches[0][2].flow == 1);
+        CHECK(batches[0][3].kind == NotificationKind::DeviceRemoved);
+    }
+}
+
+TEST_CASE("Dispatcher delivers service restarts and forgets what was sent before them")
+{
+    Collector collector;
+    NotificationDispatcher dispatcher(collector.Sink(), Window(0us));
+
+    // One post at a time, so each delivered notification is its own batch
+    dispatcher.Post(Volume(L"A", 0.5f));
+    CHECK(collector.WaitBatches(1));
+    dispatcher.Post(Default(0, 0, L"A"));
+    CHECK(collector.WaitBatches(2));
+
+    Notification restarted;
+    restarted.kind = NotificationKind::ServiceRestarted;
+    dispatcher.Post(restarted);
+    CHECK(collector.WaitBatches(3));
+
+    // Same values as before the restart: delivered again, since they may have been reset
+    dispatcher.Post(Volume(L"A", 0.5f));
+    CHECK(collector.WaitBatches(4));
+    dispatcher.Post(Default(0, 0, L"A"));
+    CHECK(collector.WaitBatches(5));
+
+    auto batches = collector.Batches();
+    CHECK(batches.size() == 5);
+    if (batches.size() == 5)
+    {
+        CHECK(batches[2].size() == 1 && batches[2][0].kind == NotificationKind::ServiceRestarted);
+        CHECK(batches[3][0].kind == NotificationKind::VolumeChanged);
+        CHECK(batches[4][0].kind == NotificationKind::DefaultChanged);
+    }
+    CHECK(dispatcher.Stats().suppressed == 0);
+}
+
+TEST_CASE("Dispatcher runs its loop inside the thread scope and reports metrics")
+{
+    Collector collector;
+    std::atomic<bool> scoped{false};
+    std::atomic<bool> released{false};
+    std::thread::id loopThread;
+
+    DispatcherOptions options = Window(0us);
+    options.threadScope = [&](const std::function<void()> &loop)
+    {
+        loopThread = std::this_thread::get_id();
+        scoped = true;
+        loop();
+        released = true;
+    };
+
+    {
+        // Hold the first batch in the sink so later callbacks pile up in the queue
+        std::mutex gateMutex;
+        std::condition_variable gate;
+        bool open = false;
+        NotificationDispatcher dispatcher([&](std::vector<Notification> &&batch)
+                                          {
+            {
+                std::unique_lock<std::mutex> lock(gateMutex);
+                gate.wait(lock, [&]() { return open; });
+            }
+            collector.Sink()(std::move(batch)); },
+                                          options);
+
+        dispatcher.Post(Volume(L"first", 0.1f));
+        std::this_thread::sleep_for(5ms);
+        for (int i = 0; i < 50; ++i)
+            dispatcher.Post(Volume(L"dev" + std::to_wstring(i), 0.2f));
+        CHECK(dispatcher.Stats().queueDepth == 50);
+        std::this_thread::sleep_for(20ms);
+        {
+            std::lock_guard<std::mutex> lock(gateMutex);
+            open = true;
+        }
+        gate.notify_all();
+
+        CHECK(collector.WaitBatches(2));
+        for (const auto &batch : collector.Batches())
+            dispatcher.RecordDelivery(batch);
+
+        const DispatcherStats stats = dispatcher.Stats();
+        CHECK(stats.queueHighWater >= 50);
+        CHECK(stats.delivered == 51);
+        CHECK(stats.dispatch.count == 51);
+        CHECK(stats.delivery.count == 51);
+        CHECK(stats.dispatch.maxUs >= 15000.0); // the 50 waited behind the gate
+        CHECK(stats.delivery.averageUs >= stats.dispatch.averageUs);
+
+        dispatcher.ResetLatency();
+        CHECK(dispatcher.Stats().dispatch.count == 0);
+        CHECK(scoped);
+        CHECK(loopThread != std::this_thread::get_id());
+    }
+    CHECK(released);
+}
+
+TEST_CASE("Dispatcher closes a batch at the window while callbacks keep arriving")
+{
+    Collector collector;
+    NotificationDispatcher dispatcher(collector.Sink(), Window(20ms));
+
+    // Drag one endpoint's volume faster than the dispatcher drains it, so the queue is
+    // never empty, for far longer than the window
+    std::atomic<bool> dragging{true};
+    std::thread slider([&]()
+                       {
+        for (int i = 0; dragging && i < 2000000; ++i)
+            dispatcher.Post(Volume(L"slider", static_cast<float>(i)));
+        dragging = false; });
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool delivered = collector.WaitBatches(1, 500ms);
+    const auto waited = std::chrono::steady_clock::now() - start;
+    const bool stillDragging = dragging.load();
+    CHECK(collector.WaitBatches(3, 500ms));
+    dragging = false;
+    slider.join();
+
+    CHECK(delivered);
+    CHECK(stillDragging);
+    CHECK(waited < 100ms);
+    for (const auto &batch : collector.Batches())
+        CHECK(batch.size() == 1); // every batch folds the drag into its latest value
+    CHECK(dispatcher.Stats().dispatch.maxUs < 100000.0);
+}
+
+BENCH_CASE("Dispatcher throughput and latency (4 producers)")
+{
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 50000;
+
+    std::atomic<uint64_t> received{0};
+    NotificationDispatcher dispatcher([&](std::vector<Notification> &&batch)
+                                      { received += batch.size(); },
+                                      Window(0us));
+
+    const double seconds = TestHarness::TimeSeconds([&]()
+                                                    {
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p)
+            producers.emplace_back([&dispatcher, p]()
+                                   {
+                // Each producer drags one endpoint's volume, like a slider would
+                for (int i = 0; i < kPerProducer; ++i)
+                    dispatcher.Post(Volume(std::to_wstring(p), static_cast<float>(i))); });
+        for (std::thread &producer : producers)
+            producer.join(); });
+
+    while (dispatcher.Stats().queueDepth > 0)
+        std::this_thread::sleep_for(1ms);
+
+    const DispatcherStats stats = dispatcher.Stats();
+    TestHarness::BenchReport("Post() throughput", kProducers * kPerProducer / seconds / 1e6, "M/s");
+    TestHarness::BenchReport("Delivered (after folding)", static_cast<double>(stats.delivered), "notifications");
+    TestHarness::BenchReport("Batches", static_cast<double>(stats.batches), "");
+    TestHarness::BenchReport("Queue high-water mark", static_cast<double>(stats.queueHighWater), "entries");
+    TestHarness::BenchReport("Dispatch latency (average)", stats.dispatch.averageUs, "us");
+    TestHarness::BenchReport("Dispatch latency (max)", stats.dispatch.maxUs, "us");
+
+    // Idle-to-wake latency: one callback at a time
+    dispatcher.ResetLatency();
+    for (int i = 0; i < 200; ++i)
+    {
+        dispatcher.Post(Volume(L"idle", static_cast<float>(i)));
+        std::this_thread::sleep_for(1ms);
+    }
+    std::this_thread::sleep_for(5ms);
+    TestHarness::BenchReport("Wake-up latency (average)", dispatcher.Stats().dispatch.averageUs, "us");
+}
@@ -0,0 +1,260 @@
+/**
+ * @file PassthroughTests.cpp
+ * @brief Tests for the SPSC ring, drift controller and passthrough pipe.
+ *
+ * Device clocks are simulated: a capture "device" delivers fixed-size blocks on its own
+ * clock, which runs fast or slow relative to the render "device" by a given ppm offset.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/DriftController.h"
+#include "Dsp/SpscRing.h"
+#include "Streaming/PassthroughPipe.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    // Must exceed one capture period plus one render period, or the ring can run dry
+    // whenever two render periods fall between consecutive capture packets.
+    constexpr double kLatencyMs = 30.0;
+
+    struct DriftRun
+    {
+        Streaming::PipeStats settled; ///< Counters at the end of the settling period.
+        Streaming::PipeStats final;   ///< Counters at the end of the run.
+        double maxFillErrorMs = 0.0;  ///< Worst smoothed fill error after settling.
+    };
+
+    /**
+     * @brief Runs a passthrough pipe between two simulated device clocks.
+     *
+     * @param ppm Capture clock offset relative to its nominal rate.
+     * @param captureBlock Frames per capture period.
+     * @param renderBlock Frames per render period.
+     */
+    DriftRun SimulateDrift(double ppm, double captureRate, double renderRate, size_t captureBlock,
+                           size_t renderBlock, double settleSeconds, double totalSeconds)
+    {
+        const unsigned channels = 2;
+        Streaming::PassthroughPipe pipe(channels, captureRate, renderRate, kLatencyMs, renderBlock);
+
+        const double capturePeriod = captureBlock / (captureRate * (1.0 + ppm * 1e-6));
+        const double renderPeriod = renderBlock / renderRate;
+
+        std::vector<float> captureBuffer(captureBlock * channels);
+        std::vector<float> renderBuffer(renderBlock * channels);
+        double phase = 0.0;
+
+        double nextCapture = capturePeriod;
+        double nextRender = renderPeriod;
+        DriftRun run;
+        bool settled = false;
+
+        while (std::min(nextCapture, nextRender) < totalSeconds)
+        {
+            if (nextCapture <= nextRender)
+            {
+                for (size_t i = 0; i < captureBlock; ++i)
+                {
+                    const float sample = static_cast<float>(0.5 * std::sin(phase));
+                    phase += 2.0 * kPi * 1000.0 / captureRate;
+                    captureBuffer[i * channels] = sample;
+                    captureBuffer[i * channels + 1] = sample;
+                }
+                pipe.PushCapture(captureBuffer.data(), captureBlock, nextCapture);
+                nextCapture += capturePeriod;
+            }
+            else
+            {
+                pipe.PullRender(renderBuffer.data(), renderBlock, nextRender);
+                nextRender += renderPeriod;
+
+                if (!settled && nextRender >= settleSeconds)
+                {
+                    settled = true;
+                    run.settled = pipe.Stats();
+                }
+                if (settled)
+                {
+                    const Streaming::PipeStats stats = pipe.Stats();
+                    run.maxFillErrorMs = std::max(run.maxFillErrorMs, std::fabs(stats.fillMs - stats.targetMs));
+                }
+            }
+        }
+
+        run.final = pipe.Stats();
+        return run;
+    }
+}
+
+TEST_CASE("SpscRing preserves order across threads")
+{
+    Dsp::SpscRing<uint32_t> ring(1000);
+    CHECK(ring.Capacity() == 1024);
+
+    constexpr uint32_t kCount = 2000000;
+    std::thread producer([&ring]()
+                         {
+        uint32_t next = 0;
+        uint32_t block[37];
+        while (next < kCount)
+        {
+            const uint32_t n = std::min<uint32_t>(37, kCount - next);
+            for (uint32_t i = 0; i < n; ++i)
+                block[i] = next + i;
+            next += static_cast<uint32_t>(ring.Write(block, n));
+        } });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    uint32_t block[53];
+    while (expected < kCount)
+    {
+        const size_t n = ring.Read(block, 53);
+        for (size_t i = 0; i < n; ++i)
+            ordered = ordered && block[i] == expected++;
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(ring.AvailableToRead() == 0);
+}
+
+TEST_CASE("SpscRing reports full and empty")
+{
+    Dsp::SpscRing<float> ring(8);
+    float data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    CHECK(ring.Write(data, 10) == 8);
+    CHECK(ring.AvailableToWrite() == 0);
+    CHECK(ring.Discard(3) == 3);
+    float out[8] = {};
+    CHECK(ring.Read(out, 8) == 5);
+    CHECK(out[0] == 4.0f && out[4] == 8.0f);
+    CHECK(ring.Read(out, 1) == 0);
+}
+
+TEST_CASE("DriftController converges to the clock offset")
+{
+    for (double ppm : {200.0, -200.0})
+    {
+        // Integrate fill directly: producer at (1 + ppm), consumer at the corrected ratio
+        Dsp::DriftController controller(1.0, 48000.0, 960.0);
+        double fill = 960.0;
+        double ratio = 1.0;
+        for (int step = 0; step < 6000; ++step)
+        {
+            fill += 480.0 * (1.0 + ppm * 1e-6) - 480.0 * ratio;
+            ratio = controller.Update(fill, 0.01);
+        }
+        CHECK_NEAR(controller.CorrectionPpm(), ppm, 5.0);
+        CHECK_NEAR(controller.SmoothedFill(), 960.0, 5.0);
+    }
+}
+
+TEST_CASE("PassthroughPipe holds the latency target with +200 ppm drift")
+{
+    const DriftRun run = SimulateDrift(200.0, 48000.0, 48000.0, 480, 480, 30.0, 120.0);
+    CHECK(run.final.underruns == 0);
+    CHECK(run.final.overruns == 0);
+    CHECK_NEAR(run.final.correctionPpm, 200.0, 20.0);
+    CHECK(run.maxFillErrorMs < 2.0);
+}
+
+TEST_CASE("PassthroughPipe holds the latency target with -200 ppm drift")
+{
+    const DriftRun run = SimulateDrift(-200.0, 48000.0, 48000.0, 480, 480, 30.0, 120.0);
+    CHECK(run.final.underruns == 0);
+    CHECK(run.final.overruns == 0);
+    CHECK_NEAR(run.final.correctionPpm, -200.0, 20.0);
+    CHECK(run.maxFillErrorMs < 2.0);
+}
+
+TEST_CASE("PassthroughPipe bridges mismatched rates and periods")
+{
+    // 44.1 kHz capture in 10 ms blocks feeding a 48 kHz render device with 3 ms periods
+    const DriftRun run = SimulateDrift(150.0, 44100.0, 48000.0, 441, 144, 30.0, 120.0);
+    CHECK(run.settled.underruns == run.final.underruns);
+    CHECK(run.final.overruns == 0);
+    CHECK_NEAR(run.final.correctionPpm, 150.0, 30.0);
+    CHECK(run.maxFillErrorMs < 3.0);
+}
+
+TEST_CASE("PassthroughPipe counts underruns when capture stalls")
+{
+    Streaming::PassthroughPipe pipe(1, 48000.0, 48000.0, 10.0, 480);
+    std::vector<float> block(480, 0.25f);
+    std::vector<float> out(480);
+
+    pipe.PushCapture(block.data(), 480, 0.01);
+    pipe.PullRender(out.data(), 480, 0.01); // 10 ms buffered: primed
+    pipe.PullRender(out.data(), 480, 0.02); // nothing new arrived
+    CHECK(pipe.Stats().underruns == 1);
+
+    // While re-priming the pipe outputs silence without counting further underruns
+    pipe.PullRender(out.data(), 480, 0.03);
+    CHECK(pipe.Stats().underruns == 1);
+    CHECK(out[0] == 0.0f);
+}
+
+TEST_CASE("PassthroughPipe counts overruns when render stalls")
+{
+    Streaming::PassthroughPipe pipe(1, 48000.0, 48000.0, 10.0, 480);
+    std::vector<float> block(480, 0.25f);
+    for (int i = 0; i < 64; ++i)
+        pipe.PushCapture(block.data(), 480, i * 0.01);
+    CHECK(pipe.Stats().overruns > 0);
+    CHECK(pipe.Stats().capturedFrames < 64u * 480u);
+}
+
+TEST_CASE("PassthroughPipe keeps 5.1 channel order across an overrun")
+{
+    // 6 channels never divide the power-of-two ring, so the overflow lands mid-frame
+    const unsigned channels = 6;
+    Streaming::PassthroughPipe pipe(channels, 48000.0, 48000.0, 10.0, 480);
+    std::vector<float> block(480 * channels);
+    for (size_t i = 0; i < block.size(); ++i)
+        block[i] = static_cast<float>(i % channels + 1);
+    for (int i = 0; i < 64; ++i)
+        pipe.PushCapture(block.data(), 480, i * 0.01);
+    CHECK(pipe.Stats().overruns > 0);
+
+    // Drain well past the overflow point and keep feeding: every frame must read 1..6
+    std::vector<float> out(480 * channels);
+    bool ordered = true;
+    for (int i = 0; i < 200; ++i)
+    {
+        pipe.PushCapture(block.data(), 480, 0.64 + i * 0.01);
+        pipe.PullRender(out.data(), 480, 0.64 + i * 0.01);
+        if (i < 20)
+            continue; // let the resampler's filter fill with steady input
+        for (size_t f = 0; f < 480; ++f)
+            for (unsigned c = 0; c < channels; ++c)
+                ordered = ordered && std::fabs(out[f * channels + c] - static_cast<float>(c + 1)) < 0.01f;
+    }
+    CHECK(ordered);
+    CHECK(pipe.Stats().underruns == 0);
+}
+
+BENCH_CASE("PassthroughPipe render cost (stereo, 44.1k -> 48k)")
+{
+    Streaming::PassthroughPipe pipe(2, 44100.0, 48000.0, 20.0, 480);
+    std::vector<float> in(441 * 2, 0.1f);
+    std::vector<float> out(480 * 2);
+    const int blocks = 200000;
+    const double seconds = TestHarness::TimeSeconds([&]()
+                                                    {
+        for (int i = 0; i < blocks; ++i)
+        {
+            pipe.PushCapture(in.data(), 441, i * 0.01);
+            pipe.PullRender(out.data(), 480, i * 0.01);
+        } });
+    TestHarness::BenchReport("ns per 10 ms block", seconds * 1e9 / blocks, "ns");
+    TestHarness::BenchReport("realtime factor", blocks * 0.01 / seconds, "x");
+}
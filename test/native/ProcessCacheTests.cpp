@@ -0,0 +1,343 @@
+/**
+ * @file ProcessCacheTests.cpp
+ * @brief Tests for the process-info cache and session reconciliation against a fake,
+ *        scriptable process table.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/ProcessInfoCache.h"
+#include "AudioSwitcher/SessionProcessTracker.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace AudioSwitcher;
+
+namespace
+{
+    /**
+     * @brief In-memory process table. Query() can be held open with a gate to simulate a
+     *        slow OpenProcess, and a hook can swap the process table mid-query.
+     */
+    class FakeProcessTable : public ProcessTable
+    {
+    public:
+        struct Process
+        {
+            uint64_t startTime;
+            std::wstring name;
+            bool accessible;
+        };
+
+        void Start(uint32_t pid, uint64_t startTime, const std::wstring &name, bool accessible = true)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_processes[pid] = Process{startTime, name, accessible};
+        }
+
+        void Exit(uint32_t pid)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_processes.erase(pid);
+        }
+
+        /// While closed, Query() blocks.
+        void SetGate(bool open)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_gateOpen = open;
+            }
+            m_gate.notify_all();
+        }
+
+        /// Runs once inside the next Query(), after the first start-time read.
+        void OnNextQuery(std::function<void()> hook)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_hook = std::move(hook);
+        }
+
+        bool GetStartTime(uint32_t pid, uint64_t &startTime) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_processes.find(pid);
+            if (it == m_processes.end())
+                return false;
+            startTime = it->second.startTime;
+            return true;
+        }
+
+        bool Query(uint32_t pid, ProcessInfo &info) override
+        {
+            std::function<void()> hook;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                ++queries;
+                m_gate.wait(lock, [this]
+                            { return m_gateOpen; });
+                hook.swap(m_hook);
+            }
+            if (hook)
+                hook();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_processes.find(pid);
+            if (it == m_processes.end())
+                return false;
+            info.accessible = it->second.accessible;
+            info.name = it->second.accessible ? it->second.name : L"";
+            info.path = it->second.accessible ? L"C:\\Apps\\" + it->second.name : L"";
+            return true;
+        }
+
+        std::atomic<int> queries{0};
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_gate;
+        bool m_gateOpen = true;
+        std::function<void()> m_hook;
+        std::map<uint32_t, Process> m_processes;
+    };
+
+    ProcessLookup Resolve(ProcessInfoCache &cache, uint32_t pid)
+    {
+        cache.Lookup(pid);
+        cache.WaitIdle();
+        return cache.Lookup(pid);
+    }
+
+    SessionInfo Session(const std::wstring &id, uint32_t pid, int state = 1)
+    {
+        SessionInfo session;
+        session.sessionId = id;
+        session.pid = pid;
+        session.state = state;
+        return session;
+    }
+
+    /// Reconciles one listing, lets the resolvers finish, then reconciles it again.
+    std::vector<SessionInfo> ListResolved(SessionProcessTracker &tracker, ProcessInfoCache &cache,
+                                          std::vector<SessionInfo> sessions)
+    {
+        tracker.Reconcile(L"speakers", sessions);
+        cache.WaitIdle();
+        tracker.Reconcile(L"speakers", sessions);
+        return sessions;
+    }
+}
+
+TEST_CASE("ProcessInfoCache resolves in the background and then hits")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(100, 1, L"chrome.exe");
+    ProcessInfoCache cache(table);
+
+    CHECK(cache.Lookup(100).state == ProcessLookup::State::Pending);
+    cache.WaitIdle();
+
+    const ProcessLookup lookup = cache.Lookup(100);
+    CHECK(lookup.state == ProcessLookup::State::Ready);
+    CHECK(lookup.info.name == L"chrome.exe");
+    CHECK(lookup.key.startTime == 1);
+
+    for (int i = 0; i < 100; ++i)
+        cache.Lookup(100);
+    CHECK(table->queries == 1);
+    CHECK(cache.Stats().hits == 101);
+}
+
+TEST_CASE("ProcessInfoCache never blocks the caller on a slow process table")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(200, 5, L"slow.exe");
+    table->SetGate(false);
+    ProcessInfoCache cache(table);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; ++i)
+        CHECK(cache.Lookup(200).state == ProcessLookup::State::Pending);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CHECK(ms < 100.0);
+
+    table->SetGate(true);
+    cache.WaitIdle();
+    CHECK(table->queries == 1); // Duplicate misses are coalesced
+    CHECK(cache.Lookup(200).state == ProcessLookup::State::Ready);
+}
+
+TEST_CASE("ProcessInfoCache invalidation is keyed by process instance")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(300, 10, L"old.exe");
+    ProcessInfoCache cache(table);
+    const ProcessLookup old = Resolve(cache, 300);
+    CHECK(old.info.name == L"old.exe");
+
+    // A stale key (different start time) does not remove the live entry
+    cache.Invalidate(ProcessKey{300, 9});
+    CHECK(cache.Lookup(300).state == ProcessLookup::State::Ready);
+
+    // The old process exits, a new one reuses the pid, and the old session expires
+    table->Exit(300);
+    table->Start(300, 20, L"new.exe");
+    cache.Invalidate(old.key);
+    CHECK(cache.Stats().invalidations == 1);
+
+    const ProcessLookup fresh = Resolve(cache, 300);
+    CHECK(fresh.state == ProcessLookup::State::Ready);
+    CHECK(fresh.info.name == L"new.exe");
+    CHECK(fresh.key.startTime == 20);
+}
+
+TEST_CASE("ProcessInfoCache discards results when the pid is reused mid-query")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(400, 1, L"first.exe");
+    table->OnNextQuery([&table]()
+                       {
+        table->Exit(400);
+        table->Start(400, 2, L"second.exe"); });
+    ProcessInfoCache cache(table);
+
+    const ProcessLookup lookup = Resolve(cache, 400);
+    CHECK(lookup.state == ProcessLookup::State::Ready);
+    CHECK(lookup.info.name == L"second.exe");
+    CHECK(lookup.key.startTime == 2);
+    CHECK(table->queries == 2);
+}
+
+TEST_CASE("ProcessInfoCache remembers exited processes until invalidated")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    ProcessInfoCache cache(table);
+
+    CHECK(Resolve(cache, 500).state == ProcessLookup::State::Gone);
+    cache.Lookup(500);
+    CHECK(table->queries == 0); // GetStartTime failed; Query never ran and is not retried
+
+    table->Start(500, 3, L"reborn.exe");
+    CHECK(cache.Lookup(500).state == ProcessLookup::State::Gone);
+    cache.InvalidatePid(500);
+    CHECK(Resolve(cache, 500).info.name == L"reborn.exe");
+}
+
+TEST_CASE("ProcessInfoCache caches inaccessible processes")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(600, 4, L"audiodg.exe", false);
+    ProcessInfoCache cache(table);
+
+    const ProcessLookup lookup = Resolve(cache, 600);
+    CHECK(lookup.state == ProcessLookup::State::Ready);
+    CHECK(!lookup.info.accessible);
+    cache.Lookup(600);
+    CHECK(table->queries == 1);
+}
+
+TEST_CASE("ProcessInfoCache evicts the least recently used entry")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    for (uint32_t pid = 1; pid <= 4; ++pid)
+        table->Start(pid, pid, L"p" + std::to_wstring(pid) + L".exe");
+    ProcessInfoCache cache(table, 2, 3);
+
+    Resolve(cache, 1);
+    Resolve(cache, 2);
+    Resolve(cache, 3);
+    cache.Lookup(1); // 2 is now the least recently used
+    Resolve(cache, 4);
+
+    const ProcessCacheStats stats = cache.Stats();
+    CHECK(stats.size == 3);
+    CHECK(stats.evictions == 1);
+    CHECK(cache.Lookup(1).state == ProcessLookup::State::Ready);
+    CHECK(cache.Lookup(3).state == ProcessLookup::State::Ready);
+    CHECK(cache.Lookup(4).state == ProcessLookup::State::Ready);
+    CHECK(cache.Lookup(2).state == ProcessLookup::State::Pending);
+}
+
+TEST_CASE("ProcessInfoCache resolves many pids concurrently")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    for (uint32_t pid = 1000; pid < 1500; ++pid)
+        table->Start(pid, pid * 7, L"app.exe");
+    ProcessInfoCache cache(table, 4, 1024);
+
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; ++t)
+    {
+        callers.emplace_back([&cache]()
+                             {
+            for (uint32_t pid = 1000; pid < 1500; ++pid)
+                cache.Lookup(pid); });
+    }
+    for (std::thread &caller : callers)
+        caller.join();
+    cache.WaitIdle();
+
+    CHECK(table->queries == 500);
+    CHECK(cache.Stats().size == 500);
+    CHECK(cache.Lookup(1234).key.startTime == 1234u * 7);
+}
+
+TEST_CASE("Session reconciliation never names a reused pid after the dead process")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(700, 10, L"old.exe");
+    ProcessInfoCache cache(table);
+    SessionProcessTracker tracker(cache);
+
+    std::vector<SessionInfo> listing = ListResolved(tracker, cache, {Session(L"a", 700)});
+    CHECK(listing[0].process.info.name == L"old.exe");
+
+    // Between two polls the old process exits and a new one starts with the same pid:
+    // its session appears, listed before the old one's, which is gone from the listing
+    table->Exit(700);
+    table->Start(700, 20, L"new.exe");
+    listing = {Session(L"b", 700)};
+    tracker.Reconcile(L"speakers", listing);
+    CHECK(listing[0].process.state == ProcessLookup::State::Pending);
+    CHECK(listing[0].process.info.name != L"old.exe");
+
+    cache.WaitIdle();
+    tracker.Reconcile(L"speakers", listing);
+    CHECK(listing[0].process.info.name == L"new.exe");
+    CHECK(listing[0].process.key.startTime == 20);
+
+    // Once the new session ends as well, its entry is dropped rather than left to linger
+    listing.clear();
+    tracker.Reconcile(L"speakers", listing);
+    CHECK(cache.Stats().size == 0);
+}
+
+TEST_CASE("Session reconciliation describes an expired session by its own process")
+{
+    auto table = std::make_shared<FakeProcessTable>();
+    table->Start(710, 10, L"old.exe");
+    ProcessInfoCache cache(table);
+    SessionProcessTracker tracker(cache);
+    ListResolved(tracker, cache, {Session(L"a", 710)});
+
+    // The new process's session comes first; the old session is listed as expired
+    table->Exit(710);
+    table->Start(710, 20, L"new.exe");
+    std::vector<SessionInfo> listing = {Session(L"b", 710), Session(L"a", 710, kSessionStateExpired)};
+    tracker.Reconcile(L"speakers", listing);
+    CHECK(listing[0].process.state == ProcessLookup::State::Pending);
+    CHECK(listing[1].process.state == ProcessLookup::State::Ready);
+    CHECK(listing[1].process.info.name == L"old.exe");
+
+    // A session that was still pending when it vanished drops whatever its pid resolved to
+    cache.WaitIdle();
+    listing.clear();
+    tracker.Reconcile(L"speakers", listing);
+    CHECK(cache.Stats().size == 0);
+}
@@ -0,0 +1,367 @@
+/**
+ * @file RecorderTests.cpp
+ * @brief WAV/RF64/Wave64 header and sample encoding tests, crash-safe recording sink
+ *        tests, and a sustained write benchmark with a synthetic capture source.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/WavDecoder.h"
+#include "Dsp/WavEncoder.h"
+#include "Streaming/RecordingSink.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Dsp;
+using namespace Streaming;
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    std::vector<float> Sine(size_t frames, unsigned channels, double frequency, uint32_t rate, float amplitude)
+    {
+        std::vector<float> samples(frames * channels);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            for (unsigned c = 0; c < channels; ++c)
+                samples[i * channels + c] = static_cast<float>(amplitude * std::sin(2.0 * kPi * frequency * (c + 1) * i / rate));
+        }
+        return samples;
+    }
+
+    std::vector<uint8_t> ReadFile(const std::string &path)
+    {
+        std::vector<uint8_t> bytes;
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            return bytes;
+        uint8_t chunk[65536];
+        size_t count = 0;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + count);
+        std::fclose(file);
+        return bytes;
+    }
+
+    uint32_t ReadU32(const uint8_t *p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint64_t ReadU64(const uint8_t *p) { return ReadU32(p) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32); }
+
+    /// Largest difference between two sample sequences (over the shorter one).
+    double MaxError(const std::vector<float> &a, const float *b, size_t count)
+    {
+        double error = 0.0;
+        for (size_t i = 0; i < count && i < a.size(); ++i)
+            error = std::max(error, static_cast<double>(std::fabs(a[i] - b[i])));
+        return error;
+    }
+
+    RecordingOptions Options(const std::string &path, WavLayout layout)
+    {
+        RecordingOptions options;
+        options.path = path;
+        options.layout = layout;
+        options.blockBytes = 64 * 1024;
+        options.blocks = 4;
+        options.pollIntervalMs = 5;
+        options.patchIntervalMs = 20;
+        options.syncOnPatch = false;
+        return options;
+    }
+}
+
+TEST_CASE("WAV, RF64 and Wave64 headers decode with every encoding")
+{
+    const std::vector<float> source = Sine(1001, 2, 440.0, 48000, 0.8f);
+    struct Expectation
+    {
+        SampleEncoding encoding;
+        double tolerance;
+    };
+    const Expectation encodings[] = {
+        {SampleEncoding::Unsigned8, 1.0 / 128},
+        {SampleEncoding::Int16, 1.0 / 32768},
+        {SampleEncoding::Int24, 1.0 / 8388608},
+        {SampleEncoding::Int32, 1e-7},
+        {SampleEncoding::Float32, 0.0},
+        {SampleEncoding::Float64, 0.0},
+    };
+
+    for (WavContainer container : {WavContainer::Wav, WavContainer::Rf64, WavContainer::W64})
+    {
+        for (const Expectation &expectation : encodings)
+        {
+            WavLayout layout;
+            layout.sampleRate = 44100;
+            layout.channels = 2;
+            layout.encoding = expectation.encoding;
+            layout.container = container;
+
+            const size_t dataBytes = source.size() * BytesPerSample(layout.encoding);
+            std::vector<uint8_t> file = BuildWavHeader(layout, dataBytes);
+            CHECK(file.size() == kWavHeaderBytes);
+            file.resize(kWavHeaderBytes + dataBytes);
+            EncodeSamples(source.data(), file.data() + kWavHeaderBytes, source.size(), layout.encoding);
+
+            CHECK(IsWav(file.data(), file.size()));
+            const DecodedAudio audio = DecodeWav(file.data(), file.size());
+            CHECK(audio.sampleRate == 44100);
+            CHECK(audio.channels == 2);
+            CHECK(audio.Frames() == 1001);
+            CHECK(MaxError(source, audio.samples.data(), audio.samples.size()) <= expectation.tolerance * 0.5 + 1e-7);
+        }
+    }
+
+    // Full scale clamps instead of wrapping
+    const float extremes[] = {1.5f, -1.5f, 1.0f, -1.0f};
+    uint8_t encoded[8];
+    EncodeSamples(extremes, encoded, 4, SampleEncoding::Int16);
+    CHECK(encoded[0] == 0xFF && encoded[1] == 0x7F);
+    CHECK(encoded[2] == 0x00 && encoded[3] == 0x80);
+    CHECK(encoded[4] == 0xFF && encoded[5] == 0x7F);
+    CHECK(encoded[6] == 0x00 && encoded[7] == 0x80);
+}
+
+TEST_CASE("WAV header is promoted to RF64 in place past 4 GB")
+{
+    WavLayout layout;
+    layout.channels = 6;
+    layout.encoding = SampleEncoding::Int24;
+
+    const uint64_t small = 1000 * 18;
+    const uint64_t large = 5ull << 30;
+    const std::vector<uint8_t> riff = BuildWavHeader(layout, small);
+    const std::vector<uint8_t> rf64 = BuildWavHeader(layout, large);
+    CHECK(!UsesRf64(layout, small));
+    CHECK(UsesRf64(layout, large));
+
+    CHECK(std::memcmp(riff.data(), "RIFF", 4) == 0 && std::memcmp(riff.data() + 12, "JUNK", 4) == 0);
+    CHECK(ReadU32(riff.data() + 4) == kWavHeaderBytes - 8 + small);
+    CHECK(ReadU32(riff.data() + kWavHeaderBytes - 4) == small);
+
+    CHECK(std::memcmp(rf64.data(), "RF64", 4) == 0 && std::memcmp(rf64.data() + 12, "ds64", 4) == 0);
+    CHECK(ReadU32(rf64.data() + 4) == 0xFFFFFFFFu);
+    CHECK(ReadU64(rf64.data() + 20) == kWavHeaderBytes - 8 + large);
+    CHECK(ReadU64(rf64.data() + 28) == large);
+    CHECK(ReadU64(rf64.data() + 36) == large / 18);
+    CHECK(ReadU32(rf64.data() + kWavHeaderBytes - 4) == 0xFFFFFFFFu);
+
+    // Only the size fields differ: the fmt chunk and data offset do not move
+    CHECK(std::memcmp(riff.data() + 48, rf64.data() + 48, kWavHeaderBytes - 56) == 0);
+    CHECK(std::memcmp(rf64.data() + kWavHeaderBytes - 8, "data", 4) == 0);
+
+    // A truncated RF64 file (size larger than what is there) reads to its end
+    std::vector<uint8_t> file = rf64;
+    const std::vector<float> samples = Sine(10, 6, 100.0, 48000, 0.5f);
+    file.resize(kWavHeaderBytes + samples.size() * 3);
+    EncodeSamples(samples.data(), file.data() + kWavHeaderBytes, samples.size(), SampleEncoding::Int24);
+    const DecodedAudio audio = DecodeWav(file.data(), file.size());
+    CHECK(audio.channels == 6);
+    CHECK(audio.Frames() == 10);
+
+    bool threw = false;
+    try
+    {
+        BuildWavHeader(layout, 0, 64);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST_CASE("Recording sink file is valid while recording and complete after close")
+{
+    const std::string path = "native_tests_recording.wav";
+    WavLayout layout;
+    layout.sampleRate = 48000;
+    layout.channels = 2;
+    layout.encoding = SampleEncoding::Float32;
+
+    const std::vector<float> source = Sine(48000, 2, 330.0, 48000, 0.7f);
+    {
+        RecordingSink sink(Options(path, layout));
+        sink.Open();
+
+        // A bit more than two blocks: two are written, the rest is still buffered
+        const size_t pushed = 20000;
+        for (size_t done = 0; done < pushed; done += 480)
+            CHECK(sink.Push(source.data() + done * 2, std::min<size_t>(480, pushed - done)) == std::min<size_t>(480, pushed - done));
+
+        RecordingStats stats;
+        for (int wait = 0; wait < 500; ++wait)
+        {
+            stats = sink.Stats();
+            if (stats.bytesWritten >= 2 * 64 * 1024 && stats.headerPatches > 0)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        stats = sink.Stats();
+        CHECK(stats.bytesWritten == 2 * 64 * 1024);
+        CHECK(stats.headerPatches > 0);
+        CHECK(stats.frames == pushed);
+
+        // What a crash right now would leave behind: a valid file of the written blocks
+        const std::vector<uint8_t> partial = ReadFile(path);
+        const DecodedAudio audio = DecodeWav(partial.data(), partial.size());
+        CHECK(audio.Frames() == 2 * 64 * 1024 / 8);
+        CHECK(MaxError(source, audio.samples.data(), audio.samples.size()) == 0.0);
+
+        CHECK(sink.Push(source.data() + pushed * 2, 48000 - pushed) == 48000 - pushed);
+        sink.Close();
+        stats = sink.Stats();
+        CHECK(stats.droppedFrames == 0);
+        CHECK(stats.bytesWritten == 48000 * 8);
+        CHECK(stats.error.empty());
+    }
+
+    const std::vector<uint8_t> file = ReadFile(path);
+    CHECK(file.size() == kWavHeaderBytes + 48000 * 8);
+    const DecodedAudio audio = DecodeWav(file.data(), file.size());
+    CHECK(audio.Frames() == 48000);
+    CHECK(MaxError(source, audio.samples.data(), audio.samples.size()) == 0.0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Recording sink pads odd-sized Wave64 and 24-bit data")
+{
+    const std::string path = "native_tests_recording.w64";
+    for (WavContainer container : {WavContainer::Wav, WavContainer::W64})
+    {
+        WavLayout layout;
+        layout.sampleRate = 22050;
+        layout.channels = 1;
+        layout.encoding = SampleEncoding::Int24;
+        layout.container = container;
+
+        const std::vector<float> source = Sine(12345, 1, 1000.0, 22050, 0.9f);
+        {
+            RecordingSink sink(Options(path, layout));
+            sink.Open();
+            CHECK(sink.Push(source.data(), source.size()) == source.size());
+        } // destructor closes
+
+        const std::vector<uint8_t> file = ReadFile(path);
+        const size_t alignment = container == WavContainer::W64 ? 8 : 2;
+        CHECK(file.size() % alignment == 0);
+        CHECK(file.size() >= kWavHeaderBytes + 12345 * 3);
+        const DecodedAudio audio = DecodeWav(file.data(), file.size());
+        CHECK(audio.Frames() == 12345);
+        CHECK(MaxError(source, audio.samples.data(), audio.samples.size()) <= 1.0 / 8388608);
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Recording sink drops frames instead of blocking when every block is queued")
+{
+    const std::string path = "native_tests_recording_full.wav";
+    WavLayout layout;
+    layout.channels = 2;
+    layout.encoding = SampleEncoding::Float32;
+    RecordingOptions options = Options(path, layout);
+    options.blocks = 2;
+
+    const std::vector<float> source = Sine(100000, 2, 200.0, 48000, 0.5f);
+    RecordingSink sink(options);
+    sink.Open();
+    CHECK(sink.WritableFrames() == 2 * 64 * 1024 / 8);
+
+    // One push larger than all the blocks: the excess is counted, nothing waits
+    const size_t accepted = sink.Push(source.data(), 100000);
+    CHECK(accepted == 2 * 64 * 1024 / 8);
+    CHECK(sink.Stats().droppedFrames == 100000 - accepted);
+    sink.Close();
+
+    const std::vector<uint8_t> file = ReadFile(path);
+    const DecodedAudio audio = DecodeWav(file.data(), file.size());
+    CHECK(audio.Frames() == accepted);
+    CHECK(sink.Stats().maxQueueDepth >= 1);
+
+    // Unwritable paths fail at open, not on the capture thread
+    options.path = "/nonexistent-dir/x/y.wav";
+    RecordingSink bad(options);
+    bool threw = false;
+    try
+    {
+        bad.Open();
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(bad.Push(source.data(), 10) == 0);
+    std::remove(path.c_str());
+}
+
+BENCH_CASE("Recording sink sustained write rate with a synthetic capture source")
+{
+    const std::string path = "native_tests_recording_bench.wav";
+    constexpr size_t kPacket = 480; // 10 ms at 48 kHz
+    constexpr uint64_t kTotalBytes = 512ull << 20;
+    const std::vector<float> packet = Sine(kPacket, 2, 440.0, 48000, 0.5f);
+
+    for (SampleEncoding encoding : {SampleEncoding::Float32, SampleEncoding::Int24})
+    {
+        WavLayout layout;
+        layout.channels = 2;
+        layout.encoding = encoding;
+        RecordingOptions options;
+        options.path = path;
+        options.layout = layout;
+        options.pollIntervalMs = 1; // the source runs far faster than real time
+        options.patchIntervalMs = 1000;
+        options.syncOnPatch = false;
+
+        RecordingSink sink(options);
+        sink.Open();
+        const size_t frameBytes = BytesPerSample(encoding) * 2;
+        const uint64_t packets = kTotalBytes / (kPacket * frameBytes);
+
+        std::vector<double> pushTimes;
+        pushTimes.reserve(static_cast<size_t>(packets));
+        const double seconds = TestHarness::TimeSeconds([&]()
+                                                        {
+            for (uint64_t p = 0; p < packets; ++p)
+            {
+                // Faster than real time: wait for the disk rather than drop
+                while (sink.WritableFrames() < kPacket)
+                    std::this_thread::yield();
+                const auto start = std::chrono::steady_clock::now();
+                sink.Push(packet.data(), kPacket);
+                pushTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+            sink.Close(); });
+
+        double pushSeconds = 0.0;
+        for (double time : pushTimes)
+            pushSeconds += time;
+        std::sort(pushTimes.begin(), pushTimes.end());
+
+        const RecordingStats stats = sink.Stats();
+        const std::string label = encoding == SampleEncoding::Float32 ? "f32 stereo" : "s24 stereo";
+        TestHarness::BenchReport((label + " sustained (incl. close + fsync)").c_str(), stats.bytesWritten / seconds / 1e6, "MB/s");
+        TestHarness::BenchReport((label + " disk write rate").c_str(), stats.writeMBps, "MB/s");
+        TestHarness::BenchReport((label + " realtime factor").c_str(), stats.frames / seconds / 48000.0, "x");
+        TestHarness::BenchReport((label + " Push per 10 ms packet (mean)").c_str(), pushSeconds / packets * 1e6, "us");
+        TestHarness::BenchReport((label + " Push per 10 ms packet (p99.9)").c_str(), pushTimes[pushTimes.size() * 999 / 1000] * 1e6, "us");
+        TestHarness::BenchReport((label + " Push per 10 ms packet (max)").c_str(), pushTimes.back() * 1e6, "us");
+        TestHarness::BenchReport((label + " max queue depth").c_str(), static_cast<double>(stats.maxQueueDepth), "blocks");
+        TestHarness::BenchReport((label + " slowest block write").c_str(), stats.maxWriteMs, "ms");
+        CHECK(stats.droppedFrames == 0);
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,260 @@
+/**
+ * @file ResamplerTests.cpp
+ * @brief Quality, streaming and SIMD consistency tests for the polyphase resampler.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/PolyphaseResampler.h"
+#include "Dsp/SimdKernels.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    /// Every kernel level the running CPU supports.
+    std::vector<const Dsp::SimdKernels *> SupportedKernels()
+    {
+        std::vector<const Dsp::SimdKernels *> kernels;
+        for (Dsp::SimdLevel level : {Dsp::SimdLevel::Scalar, Dsp::SimdLevel::Sse, Dsp::SimdLevel::Avx2})
+        {
+            if (const Dsp::SimdKernels *k = Dsp::KernelsFor(level))
+                kernels.push_back(k);
+        }
+        return kernels;
+    }
+
+    /**
+     * @brief Streams @p input (mono) through a resampler in blocks of @p block output frames.
+     */
+    std::vector<float> Convert(const std::vector<float> &input, double inRate, double outRate, size_t block,
+                               const Dsp::SimdKernels *kernels = nullptr)
+    {
+        const size_t maxInput = static_cast<size_t>(block * inRate / outRate) + 16;
+        Dsp::PolyphaseResampler resampler(1, inRate, outRate, maxInput, kernels);
+        std::vector<float> output;
+        std::vector<float> out(block);
+        size_t consumed = 0;
+
+        while (consumed < input.size())
+        {
+            const size_t wanted = std::min(resampler.InputFramesWanted(block), input.size() - consumed);
+            consumed += resampler.Push(input.data() + consumed, wanted);
+            const size_t produced = resampler.Pull(out.data(), block);
+            output.insert(output.end(), out.begin(), out.begin() + produced);
+            if (produced == 0 && wanted == 0)
+                break;
+        }
+        return output;
+    }
+
+    std::vector<float> Sine(double freq, double rate, size_t frames, double amplitude = 0.5)
+    {
+        std::vector<float> signal(frames);
+        for (size_t i = 0; i < frames; ++i)
+            signal[i] = static_cast<float>(amplitude * std::sin(2.0 * kPi * freq * i / rate));
+        return signal;
+    }
+
+    /**
+     * @brief THD+N in dB: residual after a least-squares fit of a sine at @p freq plus DC.
+     */
+    double ThdNDb(const std::vector<float> &signal, double freq, double rate, size_t skip)
+    {
+        // Normal equations for [sin, cos, 1]
+        double m[3][3] = {};
+        double v[3] = {};
+        for (size_t i = skip; i < signal.size() - skip; ++i)
+        {
+            const double basis[3] = {std::sin(2.0 * kPi * freq * i / rate), std::cos(2.0 * kPi * freq * i / rate), 1.0};
+            for (int r = 0; r < 3; ++r)
+            {
+                v[r] += basis[r] * signal[i];
+                for (int c = 0; c < 3; ++c)
+                    m[r][c] += basis[r] * basis[c];
+            }
+        }
+        // Gaussian elimination (the system is small and well conditioned)
+        for (int col = 0; col < 3; ++col)
+        {
+            for (int row = col + 1; row < 3; ++row)
+            {
+                const double f = m[row][col] / m[col][col];
+                for (int c = col; c < 3; ++c)
+                    m[row][c] -= f * m[col][c];
+                v[row] -= f * v[col];
+            }
+        }
+        double x[3];
+        for (int row = 2; row >= 0; --row)
+        {
+            double sum = v[row];
+            for (int c = row + 1; c < 3; ++c)
+                sum -= m[row][c] * x[c];
+            x[row] = sum / m[row][row];
+        }
+
+        double signalPower = 0.0;
+        double residualPower = 0.0;
+        for (size_t i = skip; i < signal.size() - skip; ++i)
+        {
+            const double fit = x[0] * std::sin(2.0 * kPi * freq * i / rate) + x[1] * std::cos(2.0 * kPi * freq * i / rate) + x[2];
+            signalPower += fit * fit;
+            residualPower += (signal[i] - fit) * (signal[i] - fit);
+        }
+        return 10.0 * std::log10(residualPower / signalPower);
+    }
+
+    double RmsDb(const std::vector<float> &signal, size_t skip)
+    {
+        double power = 0.0;
+        for (size_t i = skip; i < signal.size() - skip; ++i)
+            power += double(signal[i]) * signal[i];
+        return 10.0 * std::log10(power / (signal.size() - 2 * skip) + 1e-30);
+    }
+}
+
+TEST_CASE("SIMD kernels match the scalar kernels")
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> a(264), b(264), expected(264), actual(264);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = dist(rng);
+        b[i] = dist(rng);
+    }
+
+    const Dsp::SimdKernels *scalar = Dsp::KernelsFor(Dsp::SimdLevel::Scalar);
+    for (const Dsp::SimdKernels *kernels : SupportedKernels())
+    {
+        for (size_t count : {8u, 16u, 24u, 64u, 264u})
+        {
+            CHECK_NEAR(kernels->dot(a.data(), b.data(), count), scalar->dot(a.data(), b.data(), count), 1e-4);
+            scalar->lerp(expected.data(), a.data(), b.data(), 0.3f, count);
+            kernels->lerp(actual.data(), a.data(), b.data(), 0.3f, count);
+            for (size_t i = 0; i < count; ++i)
+                CHECK_NEAR(actual[i], expected[i], 1e-6);
+
+            std::copy(b.begin(), b.end(), expected.begin());
+            std::copy(b.begin(), b.end(), actual.begin());
+            scalar->mixAdd(expected.data(), a.data(), 0.7f, count);
+            kernels->mixAdd(actual.data(), a.data(), 0.7f, count);
+            for (size_t i = 0; i < count; ++i)
+                CHECK_NEAR(actual[i], expected[i], 1e-6);
+        }
+    }
+    std::printf("    active kernels: %s\n", Dsp::ActiveKernels().name);
+}
+
+TEST_CASE("PolyphaseResampler THD+N at common rate pairs")
+{
+    const double rates[][2] = {{44100, 48000}, {48000, 44100}, {96000, 48000}, {48000, 96000}, {44100, 96000}};
+    for (const auto &pair : rates)
+    {
+        for (double freq : {997.0, 7001.0})
+        {
+            const std::vector<float> output = Convert(Sine(freq, pair[0], 48000), pair[0], pair[1], 480);
+            const double thdn = ThdNDb(output, freq, pair[1], 512);
+            std::printf("    %6.0f -> %6.0f Hz, %5.0f Hz tone: THD+N %.1f dB\n", pair[0], pair[1], freq, thdn);
+            CHECK(thdn < -90.0);
+        }
+    }
+}
+
+TEST_CASE("PolyphaseResampler suppresses content above the output Nyquist")
+{
+    // 23 kHz cannot be represented at 44.1 kHz; anything left over is aliasing
+    const std::vector<float> output = Convert(Sine(23000.0, 48000.0, 48000), 48000.0, 44100.0, 441);
+    const double level = RmsDb(output, 512) - RmsDb(Sine(23000.0, 48000.0, 48000), 0);
+    std::printf("    23 kHz alias at 44.1 kHz: %.1f dB\n", level);
+    CHECK(level < -80.0);
+}
+
+TEST_CASE("PolyphaseResampler keeps the passband flat")
+{
+    for (double freq : {100.0, 5000.0, 15000.0, 17500.0})
+    {
+        const std::vector<float> output = Convert(Sine(freq, 48000.0, 48000), 48000.0, 44100.0, 441);
+        const double gain = RmsDb(output, 512) - RmsDb(Sine(freq, 48000.0, 48000), 0);
+        CHECK_NEAR(gain, 0.0, 0.1);
+    }
+}
+
+TEST_CASE("PolyphaseResampler output does not depend on block size")
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> noise(20000);
+    for (float &sample : noise)
+        sample = dist(rng);
+
+    const std::vector<float> reference = Convert(noise, 44100.0, 48000.0, 480);
+    for (size_t block : {1u, 7u, 64u, 1000u})
+    {
+        const std::vector<float> output = Convert(noise, 44100.0, 48000.0, block);
+        const size_t common = std::min(output.size(), reference.size());
+        CHECK(common + 2 >= reference.size());
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < common; ++i)
+            maxDiff = std::max(maxDiff, std::fabs(output[i] - reference[i]));
+        CHECK(maxDiff == 0.0f);
+    }
+}
+
+TEST_CASE("PolyphaseResampler produces the expected number of frames")
+{
+    const std::vector<float> output = Convert(std::vector<float>(441000, 0.0f), 44100.0, 48000.0, 480);
+    // 10 s in, 10 s out, minus the filter delay and the final partial block
+    CHECK_NEAR(static_cast<double>(output.size()), 480000.0, 600.0);
+}
+
+TEST_CASE("PolyphaseResampler kernel levels agree")
+{
+    const std::vector<float> input = Sine(1234.5, 44100.0, 20000);
+    const std::vector<float> reference = Convert(input, 44100.0, 48000.0, 480, Dsp::KernelsFor(Dsp::SimdLevel::Scalar));
+    for (const Dsp::SimdKernels *kernels : SupportedKernels())
+    {
+        const std::vector<float> output = Convert(input, 44100.0, 48000.0, 480, kernels);
+        CHECK(output.size() == reference.size());
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < std::min(output.size(), reference.size()); ++i)
+            maxDiff = std::max(maxDiff, std::fabs(output[i] - reference[i]));
+        CHECK(maxDiff < 1e-5f);
+    }
+}
+
+BENCH_CASE("PolyphaseResampler throughput (stereo)")
+{
+    const double pairs[][2] = {{44100, 48000}, {96000, 48000}};
+    for (const auto &pair : pairs)
+    {
+        for (const Dsp::SimdKernels *kernels : SupportedKernels())
+        {
+            const size_t block = 480;
+            const size_t maxInput = static_cast<size_t>(block * pair[0] / pair[1]) + 16;
+            Dsp::PolyphaseResampler resampler(2, pair[0], pair[1], maxInput, kernels);
+            std::vector<float> in(maxInput * 2, 0.25f);
+            std::vector<float> out(block * 2);
+
+            size_t frames = 0;
+            const double seconds = TestHarness::TimeSeconds([&]()
+                                                            {
+                for (int i = 0; i < 20000; ++i)
+                {
+                    resampler.Push(in.data(), resampler.InputFramesWanted(block));
+                    frames += resampler.Pull(out.data(), block);
+                } });
+
+            char label[96];
+            std::snprintf(label, sizeof(label), "%.0f -> %.0f %s (%zu taps)", pair[0], pair[1], kernels->name, resampler.Taps());
+            TestHarness::BenchReport(label, frames / seconds / 1e6, "Mframes/s");
+            std::snprintf(label, sizeof(label), "%.0f -> %.0f %s realtime", pair[0], pair[1], kernels->name);
+            TestHarness::BenchReport(label, frames / seconds / pair[1], "x");
+        }
+    }
+}
@@ -0,0 +1,268 @@
+/**
+ * @file ServiceRecoveryTests.cpp
+ * @brief Tests for audio-service restart recovery against a fake service that stays down
+ *        for a configurable number of probes: backoff timing, hook and replay order,
+ *        folding of concurrent reports, and the listener event.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/ServiceRecovery.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioSwitcher;
+using namespace std::chrono_literals;
+
+namespace
+{
+    /**
+     * @brief Records probe times and the order of every recovery step.
+     */
+    struct FakeService
+    {
+        std::atomic<int> downFor{0}; ///< Probes still to fail.
+        std::mutex mutex;
+        std::vector<std::chrono::steady_clock::time_point> probes;
+        std::vector<std::string> steps;
+
+        bool Probe()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            probes.push_back(std::chrono::steady_clock::now());
+            steps.push_back("probe");
+            return downFor.fetch_sub(1) <= 0;
+        }
+
+        void Step(const std::string &step)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            steps.push_back(step);
+        }
+    };
+
+    RecoveryOptions FastOptions()
+    {
+        RecoveryOptions options;
+        options.initialDelay = 5ms;
+        options.maxDelay = 40ms;
+        return options;
+    }
+
+    const std::wstring kSpeakers = L"{0.0.0.00000000}.{11111111-2222-4333-8444-555555555555}";
+    const std::wstring kHeadset = L"{0.0.0.00000000}.{aaaaaaaa-bbbb-4ccc-8ddd-eeeeeeeeeeee}";
+    const std::wstring kMic = L"{0.0.1.00000000}.{99999999-8888-4777-8666-555555555555}";
+}
+
+TEST_CASE("Service recovery: classifies service-lost HRESULTs")
+{
+    CHECK(IsServiceLostError(ServiceHResult::ServiceNotRunning));
+    CHECK(IsServiceLostError(ServiceHResult::ServerDied));
+    CHECK(IsServiceLostError(ServiceHResult::Disconnected));
+    CHECK(IsServiceLostError(ServiceHResult::ServerUnavailable));
+    CHECK(!IsServiceLostError(0));
+    CHECK(!IsServiceLostError(static_cast<int32_t>(0x80070490))); // E_NOTFOUND: one device, not the service
+    CHECK(!IsServiceLostError(static_cast<int32_t>(0x88890004))); // AUDCLNT_E_DEVICE_INVALIDATED
+
+    // Without a probe losses are counted and thrown but nothing recovers
+    ServiceRecovery recovery;
+    CHECK(!recovery.Report(0));
+    bool threw = false;
+    try
+    {
+        recovery.ThrowIfLost(ServiceHResult::ServiceNotRunning, "ListDevices");
+    }
+    catch (const ServiceLostError &ex)
+    {
+        threw = ex.HResult() == ServiceHResult::ServiceNotRunning &&
+                std::string(ex.what()).find("ListDevices") != std::string::npos;
+    }
+    CHECK(threw);
+    recovery.ThrowIfLost(0, "ListDevices"); // success HRESULTs pass through
+    CHECK(recovery.Stats().detections == 1);
+    CHECK(!recovery.Stats().recovering);
+}
+
+TEST_CASE("Service recovery: probes with exponential backoff until the service answers")
+{
+    FakeService service;
+    service.downFor = 4;
+    ServiceRecovery recovery;
+    recovery.Configure([&]()
+                       { return service.Probe(); },
+                       FastOptions());
+
+    const auto reported = std::chrono::steady_clock::now();
+    CHECK(recovery.Report(ServiceHResult::ServiceNotRunning));
+    CHECK(recovery.Stats().recovering);
+    CHECK(recovery.WaitUntilHealthy(5s));
+
+    const RecoveryStats stats = recovery.Stats();
+    CHECK(!stats.recovering);
+    CHECK(stats.attempts == 5);
+    CHECK(stats.restarts == 1);
+    CHECK(stats.lastCause == ServiceHResult::ServiceNotRunning);
+    CHECK(stats.lastDowntimeMs > 0);
+
+    // Delays 5, 10, 20, 40, 40 (capped): gaps must never shrink and must respect the floor
+    std::lock_guard<std::mutex> lock(service.mutex);
+    CHECK(service.probes.size() == 5);
+    CHECK(service.probes[0] - reported >= 5ms);
+    const std::chrono::milliseconds floors[] = {10ms, 20ms, 40ms, 40ms};
+    for (size_t i = 1; i < service.probes.size(); ++i)
+        CHECK(service.probes[i] - service.probes[i - 1] >= floors[i - 1]);
+}
+
+TEST_CASE("Service recovery: hooks run in order, then defaults, default mute and mutes replay")
+{
+    FakeService service;
+    service.downFor = 1;
+    ServiceRecovery recovery;
+    recovery.Configure([&]()
+                       { return service.Probe(); },
+                       FastOptions());
+    recovery.AddHook([&]()
+                     { service.Step("runtime"); });
+    const uint64_t removed = recovery.AddHook([&]()
+                                              { service.Step("removed"); });
+    recovery.AddHook([&]()
+                     { service.Step("notifier"); });
+    recovery.RemoveHook(removed);
+
+    ReplayActions actions;
+    actions.setDefault = [&](const std::wstring &id, uint8_t flow)
+    {
+        service.Step("default " + std::to_string(flow) + (id == kHeadset ? " headset" : " mic"));
+        return true;
+    };
+    actions.setDefaultMute = [&](bool mute)
+    {
+        service.Step(std::string("default mute ") + (mute ? "on" : "off"));
+        return true;
+    };
+    actions.setMute = [&](const std::wstring &id, bool mute)
+    {
+        service.Step(std::string(id == kSpeakers ? "speakers" : "headset") + (mute ? " on" : " off"));
+        return id != kHeadset; // one replay fails; recovery still completes
+    };
+    recovery.SetReplay(actions);
+
+    // Only the latest write per target is replayed; mutes keep first-set order
+    recovery.RememberDefault(0, kSpeakers);
+    recovery.RememberDefault(1, kMic);
+    recovery.RememberDefault(0, kHeadset);
+    recovery.RememberMute(kSpeakers, true);
+    recovery.RememberMute(kHeadset, true);
+    recovery.RememberMute(kSpeakers, false);
+    recovery.RememberDefaultMute(true);
+    CHECK(recovery.Desired().mutes.size() == 2);
+
+    std::vector<RecoveryEvent> events;
+    std::mutex eventsMutex;
+    recovery.AddListener([&](const RecoveryEvent &event)
+                         {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.push_back(event); });
+
+    recovery.Report(ServiceHResult::ServerDied);
+    CHECK(recovery.WaitUntilHealthy(5s));
+
+    // The listener runs after the healthy wake-up; give it a moment
+    for (int i = 0; i < 500; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lock(eventsMutex);
+            if (!events.empty())
+                break;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+
+    const std::vector<std::string> expected = {
+        "probe", "probe", "runtime", "notifier",
+        "default 0 headset", "default 1 mic", "default mute on",
+        "speakers off", "headset on"};
+    {
+        std::lock_guard<std::mutex> lock(service.mutex);
+        CHECK(service.steps == expected);
+    }
+
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    CHECK(events.size() == 1);
+    if (!events.empty())
+    {
+        CHECK(events[0].generation == 1);
+        CHECK(events[0].attempts == 2);
+        CHECK(events[0].cause == ServiceHResult::ServerDied);
+        CHECK(events[0].replayed == 4);
+        CHECK(events[0].replayFailed == 1);
+    }
+}
+
+TEST_CASE("Service recovery: concurrent reports fold into one recovery")
+{
+    FakeService service;
+    service.downFor = 2;
+    ServiceRecovery recovery;
+    recovery.Configure([&]()
+                       { return service.Probe(); },
+                       FastOptions());
+
+    std::atomic<int> restarts{0};
+    recovery.AddListener([&](const RecoveryEvent &)
+                         { ++restarts; });
+
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 8; ++t)
+        callers.emplace_back([&]()
+                             {
+            for (int i = 0; i < 25; ++i)
+                recovery.Report(ServiceHResult::Disconnected); });
+    for (std::thread &caller : callers)
+        caller.join();
+
+    CHECK(recovery.WaitUntilHealthy(5s));
+    std::this_thread::sleep_for(20ms);
+    const RecoveryStats stats = recovery.Stats();
+    CHECK(stats.detections == 200);
+    CHECK(stats.restarts == 1);
+    CHECK(restarts == 1);
+
+    // A later loss starts a fresh recovery with its own attempt count
+    service.downFor = 0;
+    recovery.Report(ServiceHResult::ServiceNotRunning);
+    CHECK(recovery.WaitUntilHealthy(5s));
+    CHECK(recovery.Stats().restarts == 2);
+    CHECK(recovery.Stats().attempts == 1);
+}
+
+TEST_CASE("Service recovery: losing the service again mid-replay retries")
+{
+    FakeService service;
+    ServiceRecovery recovery;
+    recovery.Configure([&]()
+                       { return service.Probe(); },
+                       FastOptions());
+
+    std::atomic<int> replays{0};
+    ReplayActions actions;
+    actions.setDefaultMute = [&](bool)
+    {
+        if (replays++ == 0)
+            throw ServiceLostError("[x] gone again", ServiceHResult::ServiceNotRunning);
+        return true;
+    };
+    recovery.SetReplay(actions);
+    recovery.RememberDefaultMute(false);
+
+    recovery.Report(ServiceHResult::ServiceNotRunning);
+    CHECK(recovery.WaitUntilHealthy(5s));
+    CHECK(replays == 2);
+    CHECK(recovery.Stats().attempts == 2);
+    CHECK(recovery.Stats().restarts == 1);
+}
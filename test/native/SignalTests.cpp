@@ -0,0 +1,354 @@
+/**
+ * @file SignalTests.cpp
+ * @brief Spectral accuracy tests for the test-signal generators (sine, sweep, white and
+ *        pink noise, clicks) on every SIMD level, and the lock-free block pool.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/BlockPool.h"
+#include "Dsp/SignalGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <thread>
+#include <vector>
+
+using namespace Dsp;
+
+namespace
+{
+    constexpr double kRate = 48000.0;
+    constexpr double kPi = 3.14159265358979323846;
+
+    std::vector<const SimdKernels *> AllKernels()
+    {
+        std::vector<const SimdKernels *> kernels;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2})
+        {
+            if (const SimdKernels *k = KernelsFor(level))
+                kernels.push_back(k);
+        }
+        return kernels;
+    }
+
+    std::vector<float> Generate(const SignalSpec &spec, size_t frames, const SimdKernels *kernels = nullptr,
+                                size_t chunk = 441)
+    {
+        // An odd chunk size exercises the kernel padding and block boundaries
+        SignalGenerator generator(spec, kRate, kernels);
+        std::vector<float> samples(frames);
+        for (size_t i = 0; i < frames; i += chunk)
+            generator.Render(samples.data() + i, std::min(chunk, frames - i));
+        return samples;
+    }
+
+    /// In-place radix-2 FFT (size must be a power of two).
+    void Fft(std::vector<std::complex<double>> &data)
+    {
+        const size_t n = data.size();
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+        for (size_t len = 2; len <= n; len <<= 1)
+        {
+            const std::complex<double> step = std::polar(1.0, -2.0 * kPi / static_cast<double>(len));
+            for (size_t i = 0; i < n; i += len)
+            {
+                std::complex<double> w = 1.0;
+                for (size_t k = 0; k < len / 2; ++k, w *= step)
+                {
+                    const std::complex<double> u = data[i + k];
+                    const std::complex<double> v = data[i + k + len / 2] * w;
+                    data[i + k] = u + v;
+                    data[i + k + len / 2] = u - v;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Averaged power spectrum (Welch, no overlap) of @p samples, Hann-windowed
+     *        unless the signal is periodic in @p size (coherent sampling).
+     */
+    std::vector<double> PowerSpectrum(const std::vector<float> &samples, size_t size, bool window = true)
+    {
+        std::vector<double> power(size / 2, 0.0);
+        std::vector<std::complex<double>> frame(size);
+        const size_t segments = samples.size() / size;
+        for (size_t s = 0; s < segments; ++s)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                const double gain = window ? 0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(i) / static_cast<double>(size)) : 1.0;
+                frame[i] = samples[s * size + i] * gain;
+            }
+            Fft(frame);
+            for (size_t k = 0; k < size / 2; ++k)
+                power[k] += std::norm(frame[k]);
+        }
+        return power;
+    }
+
+    double BandPower(const std::vector<double> &power, size_t size, double low, double high)
+    {
+        const size_t first = static_cast<size_t>(low * size / kRate);
+        const size_t last = std::min(power.size(), static_cast<size_t>(high * size / kRate));
+        double sum = 0.0;
+        for (size_t k = first; k < last; ++k)
+            sum += power[k];
+        return sum;
+    }
+
+    double Rms(const std::vector<float> &samples)
+    {
+        double sum = 0.0;
+        for (float s : samples)
+            sum += double(s) * s;
+        return std::sqrt(sum / static_cast<double>(samples.size()));
+    }
+
+    double Db(double ratio) { return 10.0 * std::log10(ratio); }
+}
+
+TEST_CASE("Sine is pure and on frequency on every SIMD level")
+{
+    // Exactly 1361 cycles in the analysis window (~996.8 Hz, coprime with the window
+    // length so the phase visits every position): no leakage without a window
+    constexpr size_t kSize = 1 << 16;
+    constexpr size_t kBin = 1361;
+    SignalSpec spec;
+    spec.frequency = kBin * kRate / kSize;
+    spec.levelDb = -6.0;
+
+    for (const SimdKernels *kernels : AllKernels())
+    {
+        const std::vector<float> samples = Generate(spec, kSize, kernels);
+        const std::vector<double> power = PowerSpectrum(samples, kSize, false);
+
+        double rest = 0.0;
+        for (size_t k = 1; k < power.size(); ++k)
+            rest += k == kBin ? 0.0 : power[k];
+        const double sinadDb = Db(power[kBin] / rest);
+        CHECK(sinadDb > 110.0);
+
+        size_t peak = 0;
+        for (size_t k = 1; k < power.size(); ++k)
+            peak = power[k] > power[peak] ? k : peak;
+        CHECK(peak == kBin);
+
+        // Harmonic distortion is what a polynomial sine would show first
+        for (size_t harmonic = 2; harmonic <= 5; ++harmonic)
+            CHECK(Db(power[kBin * harmonic] / power[kBin]) < -120.0);
+
+        // Peak level: -6 dBFS = 0.501
+        const float maxSample = *std::max_element(samples.begin(), samples.end());
+        CHECK_NEAR(maxSample, 0.50119, 1e-4);
+    }
+}
+
+TEST_CASE("Sine stays on frequency over a long run")
+{
+    SignalSpec spec;
+    spec.frequency = 1000.0;
+    SignalGenerator generator(spec, kRate);
+
+    // 60 s in 10 ms blocks: count rising zero crossings
+    std::vector<float> block(480);
+    float previous = 0.0f;
+    uint64_t crossings = 0;
+    for (int b = 0; b < 6000; ++b)
+    {
+        generator.Render(block.data(), block.size());
+        for (float s : block)
+        {
+            crossings += previous < 0.0f && s >= 0.0f;
+            previous = s;
+        }
+    }
+    CHECK(crossings >= 59999 && crossings <= 60000);
+}
+
+TEST_CASE("Sweep rises exponentially and restarts after its period")
+{
+    SignalSpec spec;
+    spec.type = SignalType::Sweep;
+    spec.frequency = 100.0;
+    spec.endFrequency = 10000.0;
+    spec.sweepSeconds = 1.0;
+    const std::vector<float> samples = Generate(spec, static_cast<size_t>(kRate * 1.5));
+
+    // Instantaneous frequency from zero crossings in 20 ms windows
+    auto frequencyAt = [&](double seconds)
+    {
+        const size_t start = static_cast<size_t>(seconds * kRate);
+        const size_t length = static_cast<size_t>(0.02 * kRate);
+        int crossings = 0;
+        for (size_t i = start + 1; i < start + length; ++i)
+            crossings += samples[i - 1] < 0.0f && samples[i] >= 0.0f;
+        return crossings / 0.02;
+    };
+    // f(t) = 100 * 100^t: 1 kHz at 0.5 s, ~6.3 kHz at 0.9 s, back to the start after 1 s
+    CHECK_NEAR(frequencyAt(0.49), 1000.0, 100.0);
+    CHECK_NEAR(frequencyAt(0.89), 100.0 * std::pow(100.0, 0.9), 350.0);
+    CHECK_NEAR(frequencyAt(1.19), 100.0 * std::pow(100.0, 0.2), 100.0);
+
+    // Equal energy per octave is the point of a log sweep (pink-like spectrum)
+    constexpr size_t kSize = 1 << 16;
+    spec.sweepSeconds = kSize / kRate;
+    const std::vector<double> power = PowerSpectrum(Generate(spec, kSize), kSize, false);
+    const double reference = BandPower(power, kSize, 250.0, 500.0);
+    for (double low : {500.0, 1000.0, 2000.0})
+        CHECK(std::fabs(Db(BandPower(power, kSize, low, 2.0 * low) / reference)) < 0.5);
+}
+
+TEST_CASE("White noise is flat and at its RMS level")
+{
+    SignalSpec spec;
+    spec.type = SignalType::WhiteNoise;
+    spec.levelDb = -20.0;
+    const std::vector<float> samples = Generate(spec, 1 << 20);
+    CHECK_NEAR(Db(Rms(samples) * Rms(samples)), -20.0, 0.1);
+
+    constexpr size_t kSize = 1 << 12;
+    const std::vector<double> power = PowerSpectrum(samples, kSize);
+    // Equal bandwidths carry equal power
+    const double reference = BandPower(power, kSize, 1000.0, 3000.0);
+    for (double low : {100.0, 5000.0, 12000.0, 20000.0})
+        CHECK(std::fabs(Db(BandPower(power, kSize, low, low + 2000.0) / reference)) < 0.5);
+
+    // Same seed, same sequence; different seed, different sequence
+    const std::vector<float> first(samples.begin(), samples.begin() + 64);
+    CHECK(Generate(spec, 64) == first);
+    spec.seed = 7;
+    CHECK(Generate(spec, 64) != first);
+}
+
+TEST_CASE("Pink noise falls 3 dB per octave and is at its RMS level")
+{
+    SignalSpec spec;
+    spec.type = SignalType::PinkNoise;
+    spec.levelDb = -20.0;
+    const std::vector<float> samples = Generate(spec, 1 << 21);
+    CHECK_NEAR(Db(Rms(samples) * Rms(samples)), -20.0, 0.25);
+
+    // Pink noise carries equal power per octave
+    constexpr size_t kSize = 1 << 13;
+    const std::vector<double> power = PowerSpectrum(samples, kSize);
+    const double reference = BandPower(power, kSize, 1000.0, 2000.0);
+    for (double low : {62.5, 125.0, 250.0, 500.0, 2000.0, 4000.0, 8000.0})
+        CHECK(std::fabs(Db(BandPower(power, kSize, low, 2.0 * low) / reference)) < 1.0);
+}
+
+TEST_CASE("Clicks are single samples at the set interval")
+{
+    SignalSpec spec;
+    spec.type = SignalType::Clicks;
+    spec.clickSeconds = 0.25;
+    spec.levelDb = 0.0;
+    const std::vector<float> samples = Generate(spec, static_cast<size_t>(kRate), nullptr, 1000);
+
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        if (samples[i] != 0.0f)
+        {
+            positions.push_back(i);
+            CHECK_NEAR(samples[i], 1.0, 1e-6);
+        }
+    }
+    CHECK(positions == std::vector<size_t>({0, 12000, 24000, 36000}));
+}
+
+TEST_CASE("Block pool hands out each block once and bounds concurrent streams")
+{
+    BlockPool pool(3, 256);
+    float *a = pool.Acquire();
+    float *b = pool.Acquire();
+    float *c = pool.Acquire();
+    CHECK(a && b && c && a != b && b != c && a != c);
+    CHECK(pool.Acquire() == nullptr);
+    CHECK(pool.InUse() == 3);
+    pool.Release(b);
+    CHECK(pool.Acquire() == b);
+    pool.Release(a);
+    pool.Release(b);
+    pool.Release(c);
+    pool.Release(nullptr);
+    CHECK(pool.InUse() == 0);
+
+    // Threads write their id across a block while holding it; a block handed out twice
+    // would show another thread's id
+    BlockPool shared(8, 64);
+    std::atomic<int> collisions{0};
+    std::vector<std::thread> threads;
+    for (int t = 1; t <= 8; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (int n = 0; n < 20000; ++n)
+            {
+                float *block = shared.Acquire();
+                if (!block)
+                    continue;
+                std::fill(block, block + 64, static_cast<float>(t));
+                if (std::any_of(block, block + 64, [t](float v) { return v != static_cast<float>(t); }))
+                    ++collisions;
+                shared.Release(block);
+            } });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    CHECK(collisions.load() == 0);
+    CHECK(shared.InUse() == 0);
+}
+
+BENCH_CASE("Signal generation cost per sample")
+{
+    constexpr size_t kFrames = 480; // one 10 ms period at 48 kHz
+    constexpr int kPeriods = 20000;
+    std::vector<float> buffer(kFrames);
+    double sink = 0.0;
+
+    for (const SimdKernels *kernels : AllKernels())
+    {
+        SignalSpec spec;
+        SignalGenerator generator(spec, kRate, kernels);
+        const double seconds = TestHarness::TimeSeconds([&]()
+                                                        {
+            for (int p = 0; p < kPeriods; ++p)
+                generator.Render(buffer.data(), kFrames);
+            sink += buffer[7]; });
+        const std::string label = std::string("Sine (") + kernels->name + ")";
+        TestHarness::BenchReport(label.c_str(), seconds / (kPeriods * double(kFrames)) * 1e9, "ns/sample");
+    }
+
+    for (SignalType type : {SignalType::Sweep, SignalType::PinkNoise})
+    {
+        SignalSpec spec;
+        spec.type = type;
+        SignalGenerator generator(spec, kRate);
+        const double seconds = TestHarness::TimeSeconds([&]()
+                                                        {
+            for (int p = 0; p < kPeriods; ++p)
+                generator.Render(buffer.data(), kFrames);
+            sink += buffer[7]; });
+        TestHarness::BenchReport(type == SignalType::Sweep ? "Sweep" : "Pink noise",
+                                 seconds / (kPeriods * double(kFrames)) * 1e9, "ns/sample");
+    }
+
+    BlockPool pool(16, 4096);
+    const double poolSeconds = TestHarness::TimeSeconds([&]()
+                                                        {
+        for (int n = 0; n < 1000000; ++n)
+            pool.Release(pool.Acquire()); });
+    TestHarness::BenchReport("Block pool acquire + release", poolSeconds / 1e6 * 1e9, "ns");
+    TestHarness::BenchReport("Checksum", sink == 12345.0 ? 1.0 : 0.0, "");
+}
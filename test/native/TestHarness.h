@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * @file TestHarness.h
+ * @brief Minimal self-registering test and benchmark harness for the portable native code.
+ *
+ * The DSP and data-structure code under native/ has no Windows dependencies, so it is
+ * tested on any platform through the `native_tests` gyp target instead of pulling in a
+ * third-party framework. TEST_CASE bodies use CHECK/CHECK_NEAR; BENCH_CASE bodies run
+ * only with `--bench` and report through BenchReport().
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace TestHarness
+{
+    struct Case
+    {
+        const char *name;
+        std::function<void()> body;
+        bool benchmark;
+    };
+
+    inline std::vector<Case> &Registry()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    /// Failures recorded by the currently running case.
+    inline int &Failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    struct Registrar
+    {
+        Registrar(const char *name, std::function<void()> body, bool benchmark)
+        {
+            Registry().push_back({name, std::move(body), benchmark});
+        }
+    };
+
+    inline void ReportFailure(const char *file, int line, const std::string &message)
+    {
+        ++Failures();
+        std::fprintf(stderr, "    [x] %s:%d: %s\n", file, line, message.c_str());
+    }
+
+    /// Prints one benchmark result line.
+    inline void BenchReport(const char *label, double value, const char *unit)
+    {
+        std::printf("    %-44s %14.2f %s\n", label, value, unit);
+    }
+
+    /// Seconds elapsed while running @p fn.
+    inline double TimeSeconds(const std::function<void()> &fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+#define TH_CONCAT_INNER(a, b) a##b
+#define TH_CONCAT(a, b) TH_CONCAT_INNER(a, b)
+
+#define TH_REGISTER(name, benchmark)                                                              \
+    static void TH_CONCAT(th_case_, __LINE__)();                                                  \
+    static TestHarness::Registrar TH_CONCAT(th_reg_, __LINE__)(name, TH_CONCAT(th_case_, __LINE__), \
+                                                               benchmark);                         \
+    static void TH_CONCAT(th_case_, __LINE__)()
+
+/// Declares a test case.
+#define TEST_CASE(name) TH_REGISTER(name, false)
+
+/// Declares a benchmark (run with --bench).
+#define BENCH_CASE(name) TH_REGISTER(name, true)
+
+#define CHECK(expr)                                                            \
+    do                                                                         \
+    {                                                                          \
+        if (!(expr))                                                           \
+            TestHarness::ReportFailure(__FILE__, __LINE__, "CHECK(" #expr ")"); \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                    \
+    do                                                                                             \
+    {                                                                                              \
+        const double th_a = static_cast<double>(actual);                                           \
+        const double th_e = static_cast<double>(expected);                                         \
+        if (!(std::fabs(th_a - th_e) <= static_cast<double>(tolerance)))                           \
+            TestHarness::ReportFailure(__FILE__, __LINE__,                                         \
+                                       std::string(#actual " = ") + std::to_string(th_a) +          \
+                                           ", expected " + std::to_string(th_e) + " +/- " #tolerance); \
+    } while (0)
@@ -0,0 +1,45 @@
+/**
+ * @file TestMain.cpp
+ * @brief Entry point for the native_tests executable.
+ *
+ * Usage: native_tests [--bench] [filter]
+ *   --bench  Run benchmarks instead of tests
+ *   filter   Only run cases whose name contains this substring
+ */
+
+#include "TestHarness.h"
+
+#include <cstring>
+
+int main(int argc, char **argv)
+{
+    bool bench = false;
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--bench") == 0)
+            bench = true;
+        else
+            filter = argv[i];
+    }
+
+    int run = 0;
+    int failed = 0;
+    for (const TestHarness::Case &testCase : TestHarness::Registry())
+    {
+        if (testCase.benchmark != bench)
+            continue;
+        if (filter && !std::strstr(testCase.name, filter))
+            continue;
+
+        std::printf("[%s] %s\n", bench ? "bench" : "test", testCase.name);
+        TestHarness::Failures() = 0;
+        testCase.body();
+        ++run;
+        if (TestHarness::Failures() > 0)
+            ++failed;
+    }
+
+    std::printf("\n%d case(s) run, %d failed\n", run, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file TopologyTests.cpp
+ * @brief Tests for the per-endpoint topology graph cache: graphs are built once, served
+ *        from memory, and rebuilt only after an invalidation.
+ */
+
+#include "TestHarness.h"
+
+#include "AudioSwitcher/TopologyGraph.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace AudioSwitcher;
+
+namespace
+{
+    EndpointKey Key(int index)
+    {
+        wchar_t id[64];
+        swprintf(id, 64, L"{0.0.0.00000000}.{%08x-aaaa-4bbb-8ccc-dddddddddddd}", index);
+        return EndpointKey::Intern(id);
+    }
+
+    /// A small render graph: connector → volume → mute → DAC → speaker jack connector.
+    std::shared_ptr<const EndpointTopology> SpeakerGraph(uint32_t hardwareSupport)
+    {
+        auto topology = std::make_shared<EndpointTopology>();
+        topology->hardwareSupport = hardwareSupport;
+        auto add = [&](TopologyPartType type, const char *subType, uint8_t controls)
+        {
+            TopologyPart part;
+            part.localId = static_cast<uint32_t>(topology->parts.size());
+            part.type = type;
+            part.subType = subType;
+            part.controls = controls;
+            if (!topology->parts.empty())
+                topology->parts.back().links.push_back(part.localId);
+            topology->parts.push_back(part);
+        };
+        add(TopologyPartType::Connector, "other", 0);
+        add(TopologyPartType::Subunit, "volume", TopologyControl::Volume);
+        add(TopologyPartType::Subunit, "mute", TopologyControl::Mute);
+        add(TopologyPartType::Subunit, "dac", TopologyControl::PeakMeter);
+        add(TopologyPartType::Connector, "speaker", 0);
+        topology->jacks.push_back(JackDescription{0x00ff00, 1, 2, 0, 0, true});
+        return topology;
+    }
+}
+
+TEST_CASE("Topology graph summarizes controls and hardware support")
+{
+    auto hardware = SpeakerGraph(HardwareSupport::Volume | HardwareSupport::Mute | HardwareSupport::Meter);
+    CHECK(hardware->Controls() == (TopologyControl::Volume | TopologyControl::Mute | TopologyControl::PeakMeter));
+    CHECK(hardware->HardwareVolumeAndMute());
+
+    auto software = SpeakerGraph(HardwareSupport::Meter);
+    CHECK(!software->HardwareVolumeAndMute());
+    CHECK(!SpeakerGraph(HardwareSupport::Volume)->HardwareVolumeAndMute());
+}
+
+TEST_CASE("Topology cache walks once and serves hits until invalidated")
+{
+    TopologyCache cache;
+    int walks = 0;
+    auto build = [&]()
+    {
+        ++walks;
+        return SpeakerGraph(HardwareSupport::Volume);
+    };
+
+    auto first = cache.Get(Key(1), build);
+    auto second = cache.Get(Key(1), build);
+    CHECK(walks == 1);
+    CHECK(first == second);
+    CHECK(cache.Peek(Key(1)) == first);
+    CHECK(!cache.Peek(Key(2)));
+
+    cache.Get(Key(2), build);
+    CHECK(walks == 2);
+
+    // Only the invalidated endpoint is walked again
+    cache.Invalidate(Key(1));
+    CHECK(!cache.Peek(Key(1)));
+    cache.Get(Key(1), build);
+    cache.Get(Key(2), build);
+    CHECK(walks == 3);
+
+    TopologyCacheStats stats = cache.Stats();
+    CHECK(stats.builds == 3);
+    CHECK(stats.hits == 2);
+    CHECK(stats.invalidations == 1);
+    CHECK(stats.size == 2);
+
+    cache.Clear();
+    CHECK(cache.Stats().size == 0);
+    CHECK(cache.Stats().invalidations == 3);
+}
+
+TEST_CASE("Topology cache keeps neither failed walks nor walks that raced a change")
+{
+    TopologyCache cache;
+
+    // A missing endpoint yields null, which is not cached
+    CHECK(!cache.Get(Key(1), []() { return std::shared_ptr<const EndpointTopology>(); }));
+    CHECK(cache.Stats().size == 0);
+
+    // A notification arrives while the walk runs: the caller gets its result, but the
+    // next query walks again instead of serving a graph that may predate the change
+    auto racing = cache.Get(Key(1), [&]()
+                            {
+        cache.Invalidate(Key(1));
+        return SpeakerGraph(0); });
+    CHECK(racing != nullptr);
+    CHECK(!cache.Peek(Key(1)));
+
+    int walks = 0;
+    cache.Get(Key(1), [&]()
+              {
+        ++walks;
+        return SpeakerGraph(0); });
+    CHECK(walks == 1);
+    CHECK(cache.Peek(Key(1)) != nullptr);
+}
+
+TEST_CASE("Topology cache is safe under concurrent queries and invalidations")
+{
+    TopologyCache cache;
+    std::atomic<bool> stop{false};
+    std::atomic<int> walks{0};
+    std::atomic<int> nulls{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&, t]()
+                             {
+            for (int n = 0; n < 20000; ++n)
+            {
+                auto graph = cache.Get(Key((n + t) % 8), [&]()
+                                       {
+                    ++walks;
+                    return SpeakerGraph(HardwareSupport::Mute); });
+                if (!graph || graph->parts.size() != 5)
+                    ++nulls;
+            } });
+    }
+    std::thread invalidator([&]()
+                            {
+        for (int n = 0; !stop.load(); ++n)
+        {
+            cache.Invalidate(Key(n % 8));
+            std::this_thread::yield();
+        } });
+    for (std::thread &reader : readers)
+        reader.join();
+    stop = true;
+    invalidator.join();
+
+    CHECK(nulls.load() == 0);
+    CHECK(walks.load() >= 8);
+    CHECK(cache.Stats().builds == static_cast<uint64_t>(walks.load()));
+}
+
+BENCH_CASE("Topology query: cache hit")
+{
+    constexpr int kIterations = 1000000;
+    TopologyCache cache;
+    std::vector<EndpointKey> keys;
+    for (int i = 0; i < 8; ++i)
+    {
+        keys.push_back(Key(i));
+        cache.Get(keys.back(), []()
+                  { return SpeakerGraph(HardwareSupport::Volume | HardwareSupport::Mute); });
+    }
+
+    size_t sink = 0;
+    const double seconds = TestHarness::TimeSeconds([&]()
+                                                    {
+        for (int n = 0; n < kIterations; ++n)
+        {
+            auto graph = cache.Get(keys[n & 7], []()
+                                   { return std::shared_ptr<const EndpointTopology>(); });
+            sink += graph->hardwareSupport;
+        } });
+
+    TestHarness::BenchReport("Cached graph lookup", seconds / kIterations * 1e9, "ns");
+    TestHarness::BenchReport("Checksum", static_cast<double>(sink & 1), "");
+}
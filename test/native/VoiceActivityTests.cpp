@@ -0,0 +1,351 @@
+/**
+ * @file VoiceActivityTests.cpp
+ * @brief Voice activity detection on synthetic fixtures: formant-synthesized speech
+ *        against silence, steady and bursty noise and clicks, across rates and channel
+ *        layouts, and the multi-stream bank that picks the microphone being spoken into.
+ */
+
+#include "TestHarness.h"
+
+#include "Dsp/SignalGenerator.h"
+#include "Dsp/VoiceActivity.h"
+#include "Streaming/VoiceActivityBank.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Dsp;
+using namespace Streaming;
+
+namespace
+{
+    constexpr double kPi = 3.14159265358979323846;
+
+    /**
+     * @brief Speech-like fixture: a glottal pulse train with a drifting pitch through
+     *        three formant resonators, in syllables of varying vowels with short gaps
+     *        between them, at @p levelDb RMS over the voiced parts.
+     */
+    std::vector<float> Speech(double rate, double seconds, double levelDb, uint32_t seed = 7)
+    {
+        static const double kVowels[][3] = {
+            {730, 1090, 2440}, {270, 2290, 3010}, {300, 870, 2240}, {530, 1840, 2480}, {570, 840, 2410},
+        };
+        const size_t total = static_cast<size_t>(seconds * rate);
+        std::vector<float> out(total, 0.0f);
+        uint32_t state = seed;
+        const auto random = [&state]()
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return (state & 0xFFFFFF) / double(0x1000000);
+        };
+
+        size_t position = 0;
+        double phase = 0.0;
+        double voicedEnergy = 0.0;
+        size_t voiced = 0;
+        while (position < total)
+        {
+            const size_t length = std::min(total - position, static_cast<size_t>((0.12 + 0.16 * random()) * rate));
+            const double *formants = kVowels[static_cast<size_t>(random() * 5) % 5];
+            double y[3][2] = {};
+            double glottal = 0.0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                const double t = (position + i) / rate;
+                const double pitch = 130.0 + 30.0 * std::sin(2.0 * kPi * 0.7 * t);
+                phase += pitch / rate;
+                double x = 0.0;
+                if (phase >= 1.0)
+                {
+                    phase -= 1.0;
+                    x = 1.0;
+                }
+                glottal = 0.9 * glottal + x; // glottal roll-off
+                double v = glottal;
+                for (int f = 0; f < 3; ++f)
+                {
+                    const double r = std::exp(-kPi * (80.0 + 20.0 * f) / rate);
+                    const double a1 = 2.0 * r * std::cos(2.0 * kPi * formants[f] / rate);
+                    const double s = (1.0 - r) * v + a1 * y[f][0] - r * r * y[f][1];
+                    y[f][1] = y[f][0];
+                    y[f][0] = s;
+                    v = s;
+                }
+                const double edge = std::min(1.0, std::min(i, length - i) / (0.02 * rate));
+                out[position + i] = static_cast<float>(v * edge);
+                voicedEnergy += v * v * edge * edge;
+                ++voiced;
+            }
+            position += length;
+            position += static_cast<size_t>((0.04 + 0.08 * random()) * rate); // gap
+        }
+
+        const double gain = std::pow(10.0, levelDb / 20.0) / std::sqrt(voicedEnergy / std::max<size_t>(voiced, 1));
+        for (float &sample : out)
+            sample = static_cast<float>(sample * gain);
+        return out;
+    }
+
+    std::vector<float> Noise(SignalType type, double rate, double seconds, double levelDb, uint32_t seed = 3)
+    {
+        SignalSpec spec;
+        spec.type = type;
+        spec.levelDb = levelDb;
+        spec.seed = seed;
+        spec.clickSeconds = 0.15;
+        SignalGenerator generator(spec, rate);
+        std::vector<float> out(static_cast<size_t>(seconds * rate));
+        generator.Render(out.data(), out.size());
+        return out;
+    }
+
+    /// @p a with @p b added from frame @p offset on.
+    std::vector<float> Mix(std::vector<float> a, const std::vector<float> &b, size_t offset = 0)
+    {
+        for (size_t i = 0; i < b.size() && offset + i < a.size(); ++i)
+            a[offset + i] += b[i];
+        return a;
+    }
+
+    /// Copies a mono signal to every channel.
+    std::vector<float> Spread(const std::vector<float> &mono, unsigned channels)
+    {
+        std::vector<float> out(mono.size() * channels);
+        for (size_t i = 0; i < mono.size(); ++i)
+            std::fill_n(out.begin() + i * channels, channels, mono[i]);
+        return out;
+    }
+
+    /**
+     * @brief Runs a detector over @p signal in 10 ms packets and returns the probability
+     *        at the end of every packet.
+     */
+    std::vector<float> Track(const std::vector<float> &signal, double rate, unsigned channels = 1)
+    {
+        VoiceActivityDetector detector(static_cast<uint32_t>(rate), channels);
+        const size_t packet = static_cast<size_t>(rate / 100);
+        const size_t frames = signal.size() / channels;
+        std::vector<float> track;
+        for (size_t f = 0; f < frames; f += packet)
+        {
+            detector.Process(signal.data() + f * channels, std::min(packet, frames - f));
+            track.push_back(detector.Probability());
+        }
+        return track;
+    }
+
+    /// Share of the packets in [@p from, @p to) seconds of a track that read as speaking.
+    double SpeakingShare(const std::vector<float> &track, double from, double to)
+    {
+        const size_t begin = static_cast<size_t>(from * 100);
+        const size_t end = std::min(track.size(), static_cast<size_t>(to * 100));
+        size_t speaking = 0;
+        for (size_t i = begin; i < end; ++i)
+            speaking += track[i] >= 0.5f;
+        return end > begin ? double(speaking) / (end - begin) : 0.0;
+    }
+
+    /// First time (seconds) at or after @p from that the track reads as speaking, or -1.
+    double FirstSpeaking(const std::vector<float> &track, double from)
+    {
+        for (size_t i = static_cast<size_t>(from * 100); i < track.size(); ++i)
+        {
+            if (track[i] >= 0.5f)
+                return i / 100.0;
+        }
+        return -1.0;
+    }
+}
+
+TEST_CASE("Voice activity follows synthetic speech over a quiet room")
+{
+    constexpr double kRate = 48000.0;
+    // 2 s of room noise, 3 s of speech, 2 s of room noise
+    std::vector<float> room = Noise(SignalType::PinkNoise, kRate, 7.0, -60.0);
+    const std::vector<float> signal = Mix(room, Speech(kRate, 3.0, -26.0), static_cast<size_t>(2.0 * kRate));
+    const std::vector<float> track = Track(signal, kRate);
+
+    CHECK(SpeakingShare(track, 0.3, 2.0) == 0.0);
+    const double onset = FirstSpeaking(track, 1.9);
+    CHECK(onset >= 2.0 && onset < 2.1);
+    CHECK(SpeakingShare(track, 2.1, 5.0) > 0.95);
+    // Hangover bridges the gaps between syllables, then the probability lets go
+    CHECK(SpeakingShare(track, 5.8, 7.0) == 0.0);
+    CHECK(track.back() < 0.05f);
+}
+
+TEST_CASE("Voice activity ignores silence, steady noise, noise bursts and clicks")
+{
+    constexpr double kRate = 48000.0;
+
+    const std::vector<float> silence(static_cast<size_t>(3.0 * kRate), 0.0f);
+    CHECK(SpeakingShare(Track(silence, kRate), 0.0, 3.0) == 0.0);
+
+    for (SignalType type : {SignalType::WhiteNoise, SignalType::PinkNoise})
+    {
+        CHECK(SpeakingShare(Track(Noise(type, kRate, 4.0, -30.0), kRate), 0.0, 4.0) == 0.0);
+
+        // Half-second bursts 30 dB over a quiet room: loud enough, but not speech
+        std::vector<float> bursty = Noise(SignalType::PinkNoise, kRate, 6.0, -65.0);
+        const std::vector<float> burst = Noise(type, kRate, 0.5, -35.0, 11);
+        for (double start = 0.5; start < 6.0; start += 1.0)
+            bursty = Mix(bursty, burst, static_cast<size_t>(start * kRate));
+        CHECK(SpeakingShare(Track(bursty, kRate), 0.0, 6.0) < 0.02);
+    }
+
+    const std::vector<float> clicks = Mix(Noise(SignalType::PinkNoise, kRate, 4.0, -65.0),
+                                          Noise(SignalType::Clicks, kRate, 4.0, -10.0));
+    CHECK(SpeakingShare(Track(clicks, kRate), 0.0, 4.0) == 0.0);
+}
+
+TEST_CASE("Voice activity agrees across sample rates and channel layouts")
+{
+    struct Layout
+    {
+        double rate;
+        unsigned channels;
+    };
+    std::vector<double> shares;
+    for (Layout layout : {Layout{16000.0, 1}, Layout{44100.0, 2}, Layout{48000.0, 1}, Layout{96000.0, 6}})
+    {
+        const std::vector<float> mono = Mix(Noise(SignalType::PinkNoise, layout.rate, 6.0, -60.0),
+                                            Speech(layout.rate, 3.0, -30.0), static_cast<size_t>(1.5 * layout.rate));
+        const std::vector<float> track = Track(Spread(mono, layout.channels), layout.rate, layout.channels);
+        CHECK(SpeakingShare(track, 0.3, 1.5) == 0.0);
+        shares.push_back(SpeakingShare(track, 1.6, 4.5));
+        CHECK(SpeakingShare(track, 5.3, 6.0) == 0.0);
+    }
+    for (double share : shares)
+        CHECK(share > 0.95);
+}
+
+TEST_CASE("Voice activity bank publishes every stream and picks the closest speaking microphone")
+{
+    constexpr double kRate = 48000.0;
+    constexpr size_t kPacket = 480;
+    const size_t frames = static_cast<size_t>(3.0 * kRate);
+
+    // 0: room noise only; 1: the talker heard from across the room; 2: the talker's own
+    // microphone; 3: a muted microphone (silent packets); 4: never configured
+    const std::vector<float> speech = Speech(kRate, 3.0, -24.0);
+    std::vector<float> far(speech);
+    for (float &sample : far)
+        sample *= 0.05f; // -26 dB
+    std::vector<std::vector<float>> inputs = {
+        Noise(SignalType::PinkNoise, kRate, 3.0, -58.0, 21),
+        Mix(Noise(SignalType::PinkNoise, kRate, 3.0, -70.0, 22), far),
+        Mix(Noise(SignalType::PinkNoise, kRate, 3.0, -62.0, 23), speech),
+    };
+
+    VoiceActivityBank bank(5);
+    for (size_t i = 0; i < 4; ++i)
+        bank.Configure(i, static_cast<uint32_t>(kRate), 1);
+    CHECK(bank.Board().MostActive() == -1);
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::thread reader([&]()
+                       {
+        std::vector<uint64_t> last(bank.Size(), 0);
+        while (!done.load())
+        {
+            for (size_t i = 0; i < bank.Size(); ++i)
+            {
+                const VoiceActivityState state = bank.Board().Read(i);
+                if (state.probability < 0.0f || state.probability > 1.0f || state.updates < last[i] ||
+                    state.speaking != (state.probability >= 0.5f))
+                    consistent = false;
+                last[i] = state.updates;
+            }
+        } });
+
+    for (size_t f = 0; f < frames; f += kPacket)
+    {
+        for (size_t i = 0; i < inputs.size(); ++i)
+            bank.Process(i, inputs[i].data() + f, kPacket);
+        bank.ProcessSilence(3, kPacket);
+        bank.Process(4, inputs[0].data() + f, kPacket);
+    }
+    done = true;
+    reader.join();
+    CHECK(consistent.load());
+
+    const VoiceActivityBoard &board = bank.Board();
+    CHECK(board.Size() == 5);
+    for (size_t i = 0; i < 4; ++i)
+        CHECK(board.Read(i).updates == frames / 3 / VoiceActivityDetector::kFrame);
+    CHECK(board.Read(4).updates == 0);
+    CHECK(board.Read(9).updates == 0);
+
+    CHECK(board.Read(0).speechSeconds == 0.0);
+    CHECK(board.Read(1).speechSeconds > 2.0);
+    CHECK(board.Read(2).speechSeconds > 2.5);
+    CHECK(board.Read(3).speechSeconds == 0.0);
+    CHECK(board.Read(2).levelDb > board.Read(1).levelDb + 20.0f);
+    CHECK(board.MostActive() == 2);
+
+    bank.Configure(2, 16000, 2);
+    CHECK(board.Read(2).updates == 0);
+    CHECK(board.MostActive() == 1);
+
+    bool threw = false;
+    try
+    {
+        bank.Configure(5, 48000, 1);
+    }
+    catch (const std::out_of_range &)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+BENCH_CASE("Voice activity cost for 16 microphones at 48 kHz on one thread")
+{
+    constexpr double kRate = 48000.0;
+    constexpr size_t kMics = 16;
+    constexpr size_t kPacket = 480; // 10 ms
+    constexpr double kSeconds = 30.0;
+
+    const std::vector<float> speech = Mix(Noise(SignalType::PinkNoise, kRate, 10.0, -60.0), Speech(kRate, 10.0, -26.0));
+    VoiceActivityBank bank(kMics);
+    for (size_t i = 0; i < kMics; ++i)
+        bank.Configure(i, static_cast<uint32_t>(kRate), 1);
+
+    const size_t packets = static_cast<size_t>(kSeconds * kRate / kPacket);
+    const size_t span = speech.size() / kPacket;
+    const double seconds = TestHarness::TimeSeconds([&]()
+                                                    {
+        for (size_t p = 0; p < packets; ++p)
+        {
+            for (size_t i = 0; i < kMics; ++i)
+                bank.Process(i, speech.data() + ((p + i * 37) % span) * kPacket, kPacket);
+        } });
+
+    const double load = seconds / kSeconds * 100.0;
+    TestHarness::BenchReport("16 mono mics, CPU per 10 ms of audio", seconds / packets * 1e6, "us");
+    TestHarness::BenchReport("16 mono mics, core load", load, "%");
+    CHECK(load < 2.0);
+
+    const std::vector<float> stereo = Spread(speech, 2);
+    VoiceActivityBank stereoBank(kMics);
+    for (size_t i = 0; i < kMics; ++i)
+        stereoBank.Configure(i, static_cast<uint32_t>(kRate), 2);
+    const double stereoSeconds = TestHarness::TimeSeconds([&]()
+                                                          {
+        for (size_t p = 0; p < packets; ++p)
+        {
+            for (size_t i = 0; i < kMics; ++i)
+                stereoBank.Process(i, stereo.data() + ((p + i * 37) % span) * kPacket * 2, kPacket);
+        } });
+    TestHarness::BenchReport("16 stereo mics, core load", stereoSeconds / kSeconds * 100.0, "%");
+    CHECK(stereoSeconds / kSeconds * 100.0 < 2.0);
+}
@@ -0,0 +1,36 @@
+const { getDeviceSnapshot, startAggregate, getAggregateStats, stopAggregate } = require('../index');
+
+// Step 1: play what the default output is playing on every other render endpoint
+const outputs = getDeviceSnapshot({ refresh: true }).filter((e) => e.flow === 'render');
+const others = outputs.filter((e) => !e.isDefault);
+
+if (!others.length) {
+    console.log('❌ Need at least two render endpoints.');
+    process.exit(1);
+}
+
+console.log('\n🔊 Mirroring the default output to:\n');
+others.forEach((e, index) => console.log(`${index + 1}. ${e.name}`));
+
+const id = startAggregate({ loopback: true, endpoints: others.map((e) => e.id) });
+console.log(`\n✅ Aggregate ${id} started. Play something on the default output...`);
+
+// Step 2: print per-endpoint alignment for 20 seconds
+const timer = setInterval(() => {
+    const s = getAggregateStats(id);
+    console.log(`   source ${s.sourceRate} Hz | latency ${s.latencyMs.toFixed(1)} ms`);
+    s.endpoints.forEach((e, index) => {
+        console.log(
+            `     ${index + 1}. ${e.sampleRate} Hz | delay ${e.delayMs.toFixed(1)} ms | error ${(e.errorMs * 1000).toFixed(1)} µs | ` +
+                `drift ${e.driftPpm.toFixed(1)} ppm | underruns ${e.underruns} | ${e.aligned ? 'aligned' : 'aligning'}` +
+                (e.error ? ` | ❌ ${e.error}` : '')
+        );
+    });
+    if (!s.running) console.log(`❌ Aggregate stopped: ${s.error}`);
+}, 1000);
+
+setTimeout(() => {
+    clearInterval(timer);
+    stopAggregate(id);
+    console.log('🛑 Aggregate stopped.');
+}, 20000);
@@ -0,0 +1,25 @@
+const { listDevices, listAudioSessions, setAppEndpoint, setAppEndpoints, getAppEndpoints, clearAppEndpoints } = require('../index');
+
+// Step 1: pick an app that is playing audio and a device that is not the default
+const sessions = listAudioSessions({ waitForNames: true }).filter((s) => !s.isSystemSounds && s.processName);
+const devices = listDevices();
+const other = devices.find((d) => !d.isDefault);
+if (!sessions.length || !other) {
+    console.log('⚠️ Needs an app with an audio session and two playback devices; skipped.');
+    process.exit(0);
+}
+const app = sessions[0].processName;
+console.log(`\n🗂️ Routing ${app} to ${other.name}`);
+console.log('   result:', setAppEndpoint(app, other.id));
+
+// Step 2: the same scene again is served from the table (no writes)
+const scene = [{ app, id: other.id }, { app: 'not-running.exe', id: other.id }];
+let start = process.hrtime.bigint();
+console.log('\n🔁 Repeated scene:', setAppEndpoints(scene), `in ${(Number(process.hrtime.bigint() - start) / 1e6).toFixed(3)} ms`);
+console.log('📋 Table:', getAppEndpoints());
+
+// Step 3: back to the system default
+start = process.hrtime.bigint();
+console.log('\n↩️ Reset:', setAppEndpoints([{ app, id: null }, { app: 'not-running.exe', id: null }]),
+    `in ${(Number(process.hrtime.bigint() - start) / 1e6).toFixed(3)} ms`);
+console.log('🧹 Cleared all:', clearAppEndpoints());
@@ -0,0 +1,20 @@
+const { getAudioEffects } = require('../index');
+
+// First call reads every endpoint once; later calls are served from the snapshot
+let start = process.hrtime.bigint();
+const effects = getAudioEffects({ refresh: true });
+const firstMs = Number(process.hrtime.bigint() - start) / 1e6;
+
+start = process.hrtime.bigint();
+getAudioEffects();
+const cachedMs = Number(process.hrtime.bigint() - start) / 1e6;
+
+console.log('\n🎛️ Enhancements / spatial sound:\n');
+effects.forEach((e, index) => {
+    const spatial = e.flow === 'render' ? `, spatial ${e.spatialAudio}${e.spatialMaxObjects ? ` (${e.spatialMaxObjects} objects)` : ''}` : '';
+    console.log(`${index + 1}. [${e.flow}] ${e.name}: enhancements ${e.enhancements}${spatial}`);
+});
+
+const flagged = effects.filter((e) => e.enhancements === 'enabled' || e.spatialAudio === 'enabled');
+console.log(`\n⚠️ ${flagged.length} endpoint(s) with latency-adding processing`);
+console.log(`⏱️ First query ${firstMs.toFixed(1)} ms, cached query ${cachedMs.toFixed(2)} ms`);
@@ -0,0 +1,21 @@
+const { listAudioSessions, getSessionCacheStats } = require('../index');
+
+// Step 1: first listing returns immediately, even before process names are known
+let start = process.hrtime.bigint();
+let sessions = listAudioSessions();
+console.log(`\n🧩 First listing: ${sessions.length} session(s) in ${Number(process.hrtime.bigint() - start) / 1e6} ms`);
+console.log(`   ${sessions.filter((s) => !s.processResolved).length} still resolving in the background`);
+
+// Step 2: wait for the resolver pool, then print the sessions
+sessions = listAudioSessions({ waitForNames: true });
+console.log('\n🔊 Audio sessions:\n');
+sessions.forEach((s, index) => {
+    const name = s.isSystemSounds ? 'System Sounds' : s.processName || `(pid ${s.pid}, not accessible)`;
+    console.log(`${index + 1}. ${name} [${s.state}] volume ${Math.round(s.volume * 100)}%${s.muted ? ' (muted)' : ''}`);
+});
+
+// Step 3: later listings are served from the process cache
+start = process.hrtime.bigint();
+for (let i = 0; i < 100; i++) listAudioSessions();
+console.log(`\n⚡ 100 cached listings in ${(Number(process.hrtime.bigint() - start) / 1e6).toFixed(1)} ms`);
+console.log('📊 Cache:', getSessionCacheStats());
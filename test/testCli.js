@@ -0,0 +1,40 @@
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const exe = path.join(__dirname, '..', 'build', 'Release', 'audioswitch.exe');
+
+function run(args, input) {
+    const start = process.hrtime.bigint();
+    const output = execFileSync(exe, args, { input, encoding: 'utf8' });
+    const ms = Number(process.hrtime.bigint() - start) / 1e6;
+    return { output, ms };
+}
+
+// Step 1: list devices as JSON
+const list = run(['--json', 'list']);
+const devices = JSON.parse(list.output);
+console.log(`[✓] list: ${devices.length} devices in ${list.ms.toFixed(1)} ms (process spawn included)`);
+if (!devices.length) {
+    console.log('❌ No playback devices found.');
+    process.exit(1);
+}
+
+const current = devices.find((d) => d.isDefault) || devices[0];
+
+// Step 2: one process, one COM context, many commands
+const script = [
+    '# re-apply the current default and read back its state',
+    `set-default "${current.id}"`,
+    `volume "${current.id}"`,
+    `format "${current.id}"`,
+    'volume default',
+].join('\n');
+
+const batch = run(['--json', 'batch', '-'], script);
+const results = batch.output.trim().split('\n').map((line) => JSON.parse(line));
+results.forEach((r) => console.log(`${r.ok ? '✅' : '❌'} ${r.command} ${JSON.stringify(r)}`));
+console.log(`[✓] batch: ${results.length} commands in ${batch.ms.toFixed(1)} ms`);
+
+// Step 3: a single switch, the login-script case
+const single = run(['set-default', current.id]);
+console.log(`[✓] set-default: ${single.output.trim()} in ${single.ms.toFixed(1)} ms`);
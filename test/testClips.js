@@ -0,0 +1,67 @@
+const { getDeviceSnapshot, loadClip, playClip, getClipStats, unloadClip, stopClips } = require('../index');
+
+// Step 1: build a short "ding" (880 Hz, 150 ms, decaying) as a 16-bit mono WAV in memory
+const rate = 44100;
+const frames = Math.round(rate * 0.15);
+const wav = Buffer.alloc(44 + frames * 2);
+wav.write('RIFF', 0);
+wav.writeUInt32LE(36 + frames * 2, 4);
+wav.write('WAVEfmt ', 8);
+wav.writeUInt32LE(16, 16);
+wav.writeUInt16LE(1, 20);
+wav.writeUInt16LE(1, 22);
+wav.writeUInt32LE(rate, 24);
+wav.writeUInt32LE(rate * 2, 28);
+wav.writeUInt16LE(2, 32);
+wav.writeUInt16LE(16, 34);
+wav.write('data', 36);
+wav.writeUInt32LE(frames * 2, 40);
+for (let i = 0; i < frames; i++) {
+    const sample = Math.sin((2 * Math.PI * 880 * i) / rate) * Math.exp(-i / (rate * 0.04)) * 0.5;
+    wav.writeInt16LE(Math.round(sample * 32767), 44 + i * 2);
+}
+
+const outputs = getDeviceSnapshot({ refresh: true }).filter((e) => e.flow === 'render');
+if (!outputs.length) {
+    console.log('❌ No render endpoints.');
+    process.exit(1);
+}
+
+// Step 2: load it for every render endpoint (converts once per mix format, warms the streams)
+const { clipId, durationMs, deviceIds } = loadClip(wav, { deviceIds: outputs.map((e) => e.id) });
+console.log(`\n🛎️ Clip ${clipId} loaded (${durationMs.toFixed(0)} ms) for ${deviceIds.length} endpoint(s).\n`);
+
+getClipStats().players.forEach((p) => {
+    const name = (outputs.find((e) => e.id === p.deviceId) || {}).name || p.deviceId;
+    console.log(
+        `   ${name}: ${p.sampleRate} Hz x${p.channels} | period ${p.periodMs.toFixed(2)} ms` +
+            `${p.lowLatency ? ' (low latency)' : ''} | start latency ~${p.latencyMs.toFixed(1)} ms`
+    );
+});
+
+// Step 3: play the ding on each endpoint in turn, then eight overlapping ones
+let index = 0;
+const timer = setInterval(() => {
+    if (index >= deviceIds.length) {
+        clearInterval(timer);
+        const started = process.hrtime.bigint();
+        for (let n = 0; n < 8; n++) playClip(clipId, deviceIds[0], 0.3);
+        const us = Number(process.hrtime.bigint() - started) / 1000 / 8;
+        console.log(`\n⏱️ playClip() call cost: ${us.toFixed(1)} µs each (8 overlapping voices)`);
+
+        setTimeout(() => {
+            const s = getClipStats();
+            console.log(`\n📊 Pool: ${s.clips} clip(s), ${s.buffers} buffer(s), ${(s.bytes / 1024).toFixed(0)} KB`);
+            s.players.forEach((p) =>
+                console.log(`   started ${p.started} | finished ${p.finished} | stolen ${p.stolen}${p.error ? ` | ❌ ${p.error}` : ''}`)
+            );
+            unloadClip(clipId);
+            stopClips(null, { release: true });
+            console.log('🛑 Clips released.');
+        }, 1000);
+        return;
+    }
+    const name = (outputs.find((e) => e.id === deviceIds[index]) || {}).name;
+    console.log(`🔔 ${name}`);
+    playClip(clipId, deviceIds[index++]);
+}, 700);
@@ -0,0 +1,100 @@
+/**
+ * Load test for daemon mode: 50 concurrent clients against one daemon backed by the
+ * simulated backend, so it runs anywhere (no Windows audio stack needed).
+ *
+ * Usage: node ./test/testDaemonLoad.js [clients] [requestsPerClient]
+ */
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const assert = require('assert');
+const { DaemonServer, startDaemonServer } = require('../lib/daemon/server');
+const { connectDaemon } = require('../lib/daemon/client');
+const { createSimulatedBackend } = require('../lib/simulatedBackend');
+
+const CLIENTS = parseInt(process.argv[2], 10) || 50;
+const REQUESTS_PER_CLIENT = parseInt(process.argv[3], 10) || 200;
+
+const socketPath = process.platform === 'win32'
+    ? `\\\\.\\pipe\\node-windows-audio-manager-test-${process.pid}`
+    : path.join(os.tmpdir(), `node-windows-audio-manager-test-${process.pid}.sock`);
+
+function percentile(sorted, p) {
+    return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+async function runClient(index, devices, latencies) {
+    const client = await connectDaemon({ path: socketPath });
+    let events = 0;
+    client.on('devicesChanged', () => events++);
+    await client.subscribe();
+
+    for (let i = 0; i < REQUESTS_PER_CLIENT; i++) {
+        const start = process.hrtime.bigint();
+        // Mostly queries, with a sprinkling of commands like a real kiosk
+        if (i % 20 === index % 20) {
+            const target = devices[(index + i) % devices.length];
+            assert.strictEqual(await client.setDefaultDevice(target.id), true);
+        } else if (i % 10 === 5) {
+            assert.strictEqual(await client.muteDeviceById(devices[i % devices.length].id, i % 2 === 0), true);
+        } else {
+            const list = await client.listDevices();
+            assert.strictEqual(list.length, devices.length);
+            assert.strictEqual(list.filter((d) => d.isDefault).length, 1);
+        }
+        latencies.push(Number(process.hrtime.bigint() - start) / 1e6);
+    }
+
+    // Unknown opcodes and bad ids must come back as errors / false, not kill the daemon
+    await assert.rejects(client.request(0xff), /Unknown opcode 255/);
+    assert.strictEqual(await client.setDefaultDevice('{0.0.0.00000000}.{missing}'), false);
+    await client.ping();
+
+    client.close();
+    return events;
+}
+
+(async () => {
+    // Leftover from a crashed daemon: nobody answers on it, so it is replaced
+    if (process.platform !== 'win32') fs.writeFileSync(socketPath, '');
+
+    const backend = createSimulatedBackend({ deviceCount: 6 });
+    const daemon = await startDaemonServer({ backend, path: socketPath, pollIntervalMs: 0 });
+    const devices = backend.listDevices();
+    const baselineEnumerations = backend.calls.listDevices;
+
+    console.log(`[JS] Daemon listening on ${socketPath}`);
+
+    // A second daemon on the same path must fail, not steal the live daemon's socket
+    const rival = new DaemonServer({ backend, path: socketPath, pollIntervalMs: 0 });
+    await assert.rejects(rival.listen(), { code: 'EADDRINUSE' });
+    await rival.close();
+    const survivor = await connectDaemon({ path: socketPath });
+    await survivor.ping();
+    survivor.close();
+    console.log(`[JS] ${CLIENTS} clients x ${REQUESTS_PER_CLIENT} requests`);
+
+    const latencies = [];
+    const started = Date.now();
+    const events = await Promise.all(
+        Array.from({ length: CLIENTS }, (_, i) => runClient(i, devices, latencies))
+    );
+    const elapsedMs = Date.now() - started;
+
+    latencies.sort((a, b) => a - b);
+    const total = latencies.length;
+    console.log(`[✓] ${total} requests in ${elapsedMs} ms (${Math.round(total / (elapsedMs / 1000))} req/s)`);
+    console.log(`    latency p50=${percentile(latencies, 0.5).toFixed(3)} ms p99=${percentile(latencies, 0.99).toFixed(3)} ms max=${latencies[total - 1].toFixed(3)} ms`);
+    console.log(`    backend calls=${daemon.stats.backendCalls} (listDevices=${backend.calls.listDevices}) for ${daemon.stats.requests} daemon requests`);
+    console.log(`    events delivered=${events.reduce((a, b) => a + b, 0)}`);
+
+    // Queries are served from the snapshot: enumeration happens once per command, not per query
+    assert.ok(backend.calls.listDevices - baselineEnumerations <= backend.calls.setDefaultDevice);
+    assert.ok(events.every((n) => n > 0), 'every subscriber should have seen devicesChanged');
+
+    await daemon.close();
+    console.log('[✓] Daemon load test passed.');
+})().catch((err) => {
+    console.error('[x] Daemon load test failed:', err);
+    process.exit(1);
+});
@@ -0,0 +1,23 @@
+const { getDeviceSnapshot, startNotifications, stopNotifications, setDefaultDevice } = require('../index');
+
+// Step 1: jack presence of every endpoint, read once and cached with the snapshot
+getDeviceSnapshot({ jacks: true }).forEach((d) => {
+    const jack = d.jack && d.jack.present
+        ? `${d.jack.connectionType} ${d.jack.geoLocation} ${d.jack.color} ${d.jack.connected ? 'plugged' : 'empty'}`
+        : 'no jack';
+    console.log(`${d.flow === 'render' ? '🔊' : '🎙️'} ${d.name}: ${jack}`);
+});
+
+// Step 2: plug headphones or a mic into a non-default jack within 30 seconds
+console.log('\n🎧 Plug something into a jack (30 s)...');
+startNotifications((events) => {
+    for (const e of events) {
+        if (e.type !== 'jackConnected') continue;
+        console.log(`🔌 ${e.flow} jack connected: ${e.deviceId} (${e.jack ? e.jack.color : '?'})`);
+        if (e.flow === 'render') console.log(`   switched: ${setDefaultDevice(e.deviceId)}`);
+    }
+});
+setTimeout(() => {
+    stopNotifications();
+    console.log('✅ Done');
+}, 30000);
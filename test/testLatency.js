@@ -0,0 +1,23 @@
+const { getDeviceSnapshot, measureLatency } = require('../index');
+
+(async () => {
+    const endpoints = getDeviceSnapshot();
+    const mic = endpoints.find((e) => e.flow === 'capture');
+    const renders = endpoints.filter((e) => e.flow === 'render');
+
+    for (const device of renders) {
+        // Step 1: engine path only (loopback)
+        const engine = await measureLatency({ deviceId: device.id, trials: 10, levelDb: -24 });
+        console.log(`\n⏱️ ${device.name} (loopback, ${engine.sampleRate} Hz)`);
+        console.log(`   median ${engine.stats.medianMs.toFixed(2)} ms, p95 ${engine.stats.p95Ms.toFixed(2)} ms, ${engine.stats.count}/${engine.trials.length} found`);
+
+        // Step 2: the whole path, heard by a microphone
+        if (!mic) continue;
+        const heard = await measureLatency({ deviceId: device.id, captureId: mic.id, stimulus: 'chirp', trials: 10, levelDb: -18 });
+        console.log(`🎙️ ${device.name} → ${mic.name}`);
+        console.log(`   median ${heard.stats.medianMs.toFixed(2)} ms, p95 ${heard.stats.p95Ms.toFixed(2)} ms, ${heard.stats.count}/${heard.trials.length} found`);
+        heard.trials
+            .filter((t) => !t.found)
+            .forEach((t) => console.log(`   ⚠️ not found (correlation ${t.correlation.toFixed(2)}, prominence ${t.prominence.toFixed(1)})`));
+    }
+})().catch((err) => console.error('❌', err.message));
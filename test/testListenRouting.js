@@ -0,0 +1,40 @@
+const readline = require('readline');
+const { getDeviceSnapshot, getListenRouting, setListenRouting } = require('../index');
+
+// Step 1: show the current routing topology (served from the native snapshot)
+const endpoints = getDeviceSnapshot({ refresh: true });
+const mics = endpoints.filter((e) => e.flow === 'capture');
+const outputs = endpoints.filter((e) => e.flow === 'render');
+
+if (!mics.length || !outputs.length) {
+    console.log('❌ Need at least one capture and one render endpoint.');
+    process.exit(1);
+}
+
+console.log('\n🎙️ Listen routing:\n');
+getListenRouting().forEach((route, index) => {
+    const target = route.targetId ? route.targetName || route.targetId : 'Default Playback Device';
+    console.log(`${index + 1}. ${route.name} → ${route.enabled ? target : '(off)'}`);
+});
+
+// Step 2: toggle routing for a chosen microphone onto the first output
+const rl = readline.createInterface({ input: process.stdin, output: process.stdout });
+
+rl.question('\n🔧 Enter the number of the capture device to toggle: ', (input) => {
+    const index = parseInt(input) - 1;
+    if (isNaN(index) || index < 0 || index >= mics.length) {
+        console.log('❌ Invalid choice.');
+        rl.close();
+        return;
+    }
+
+    const mic = mics[index];
+    const enable = !mic.listen.enabled;
+    const [ok] = setListenRouting([{ deviceId: mic.id, enabled: enable, targetId: outputs[0].id }]);
+    console.log(ok ? `✅ Listening ${enable ? `on "${outputs[0].name}"` : 'disabled'} for "${mic.name}".` : '❌ Failed to change routing.');
+
+    // The snapshot reflects the change without re-enumerating
+    const route = getListenRouting().find((r) => r.deviceId === mic.id);
+    console.log(`   Snapshot now: enabled=${route.enabled}, target=${route.targetName || route.targetId || 'default'}`);
+    rl.close();
+});
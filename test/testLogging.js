@@ -0,0 +1,27 @@
+const { setLogging, getLogStats, listDevices, setDefaultDevice } = require('../index');
+
+// Step 1: route native log records to JS
+const received = [];
+setLogging({
+    level: 'debug',
+    callback: (records) => {
+        for (const r of records) {
+            received.push(r);
+            console.log(`📝 ${new Date(r.time).toISOString()} ${r.level.padEnd(5)} [${r.component}] (${r.thread}) ${r.message}`);
+        }
+    },
+});
+
+// Step 2: exercise a few native paths that log
+const devices = listDevices();
+console.log(`\n🔍 ${devices.length} device(s); re-selecting the current default and trying a bogus id...`);
+const current = devices.find((d) => d.isDefault);
+if (current) setDefaultDevice(current.id);
+setDefaultDevice('{0.0.0.00000000}.{not-a-device}');
+
+// Step 3: records arrive asynchronously from the logger thread
+setTimeout(() => {
+    console.log(`\n📊 ${received.length} record(s) received`, getLogStats());
+    setLogging(null);
+    console.log('🔕 Logging disabled:', getLogStats().level);
+}, 200);
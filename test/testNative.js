@@ -0,0 +1,25 @@
+/**
+ * Builds (if needed) and runs the portable native test executable.
+ *
+ * On Windows the target is opt-in: `npx node-gyp rebuild -- -Dnative_tests=1`.
+ * Usage: node test/testNative.js [--bench] [filter]
+ */
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const exe = path.join(__dirname, '..', 'build', 'Release', process.platform === 'win32' ? 'native_tests.exe' : 'native_tests');
+
+if (!fs.existsSync(exe)) {
+    console.log('🔨 native_tests not built yet, running node-gyp rebuild...');
+    const gypArgs = process.platform === 'win32' ? ['node-gyp', 'rebuild', '--', '-Dnative_tests=1'] : ['node-gyp', 'rebuild'];
+    const build = spawnSync('npx', gypArgs, { cwd: path.join(__dirname, '..'), stdio: 'inherit', shell: true });
+    if (build.status !== 0 || !fs.existsSync(exe)) {
+        console.log('❌ Failed to build native_tests.');
+        process.exit(1);
+    }
+}
+
+const result = spawnSync(exe, process.argv.slice(2), { stdio: 'inherit' });
+console.log(result.status === 0 ? '✅ Native tests passed.' : '❌ Native tests failed.');
+process.exit(result.status === null ? 1 : result.status);
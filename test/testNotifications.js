@@ -0,0 +1,37 @@
+const { startNotifications, stopNotifications, getNotificationStats } = require('../index');
+
+const DURATION_MS = 20000;
+
+// Batches arrive on the JS thread from the native dispatcher (registered with MMCSS "Audio")
+startNotifications((events) => {
+    console.log(`\n🔔 Batch of ${events.length} event(s):`);
+    for (const e of events) {
+        const folded = e.coalesced ? ` (+${e.coalesced} folded)` : '';
+        switch (e.type) {
+            case 'defaultChanged':
+                console.log(`   🎚️ Default ${e.flow}/${e.role} → ${e.deviceId || '(none)'}${folded}`);
+                break;
+            case 'volumeChanged':
+                console.log(`   🔊 ${e.deviceId}: ${Math.round(e.volume * 100)}%${e.muted ? ' (muted)' : ''}${folded}`);
+                break;
+            case 'stateChanged':
+                console.log(`   🔌 ${e.deviceId}: ${e.state}${folded}`);
+                break;
+            default:
+                console.log(`   ℹ️ ${e.type}: ${e.deviceId}${folded}`);
+        }
+    }
+}, { batchWindowMs: 5, mmcss: 'Audio' });
+
+console.log(`👂 Listening for ${DURATION_MS / 1000} s — change the default device or drag a volume slider...`);
+
+setTimeout(() => {
+    const stats = getNotificationStats();
+    stopNotifications();
+    console.log('\n📊 Dispatcher stats:');
+    console.log(`   ${stats.posted} callbacks → ${stats.delivered} events in ${stats.batches} batches` +
+        ` (${stats.coalesced} folded, ${stats.suppressed} repeats dropped)`);
+    console.log(`   Queue high-water mark: ${stats.queueHighWater}, MMCSS: ${stats.mmcss ? '✅' : '❌'}, endpoints watched: ${stats.watchedEndpoints}`);
+    console.log(`   ⏱️ Dispatch latency avg ${stats.dispatchLatencyUs.average.toFixed(0)} µs / max ${stats.dispatchLatencyUs.max.toFixed(0)} µs`);
+    console.log(`   ⏱️ JS delivery latency avg ${stats.deliveryLatencyUs.average.toFixed(0)} µs / max ${stats.deliveryLatencyUs.max.toFixed(0)} µs`);
+}, DURATION_MS);
@@ -0,0 +1,39 @@
+const {
+    listDevices,
+    muteDeviceById,
+    setOperationTimeout,
+    getOperationTimeout,
+    getDeviceHealth,
+} = require('../index');
+
+// Give every native call a 1.5 s deadline
+setOperationTimeout(1500);
+console.log(`[JS] Operation timeout: ${getOperationTimeout()} ms`);
+
+const devices = listDevices();
+if (!devices.length) {
+    console.log('❌ No playback devices found.');
+    process.exit(1);
+}
+
+// Touch every device once so the watchdog has a health record for each
+devices.forEach((device) => {
+    try {
+        const muted = muteDeviceById(device.id, false);
+        console.log(`${muted ? '✅' : '❌'} ${device.name}`);
+    } catch (err) {
+        if (err.code === 'ETIMEDOUT' || err.code === 'EDEVICEHUNG') {
+            console.log(`⏱️ ${device.name}: ${err.code} (${err.message})`);
+        } else {
+            throw err;
+        }
+    }
+});
+
+console.log('\n🩺 Device health:\n');
+getDeviceHealth().forEach((record) => {
+    console.log(`- ${record.id}: ${record.state} (timeouts=${record.timeouts}, last=${record.lastLatencyMs.toFixed(1)} ms${record.pending ? ', stuck call pending' : ''})`);
+});
+
+// Restore direct execution
+setOperationTimeout(0);
@@ -0,0 +1,46 @@
+const readline = require('readline');
+const { getDeviceSnapshot, startPassthrough, getPassthroughStats, stopPassthrough } = require('../index');
+
+// Step 1: pick a source and a destination
+const endpoints = getDeviceSnapshot({ refresh: true });
+const mics = endpoints.filter((e) => e.flow === 'capture');
+const outputs = endpoints.filter((e) => e.flow === 'render');
+
+if (!mics.length || !outputs.length) {
+    console.log('❌ Need at least one capture and one render endpoint.');
+    process.exit(1);
+}
+
+console.log('\n🎙️ Capture devices:\n');
+mics.forEach((mic, index) => console.log(`${index + 1}. ${mic.name}`));
+
+const rl = readline.createInterface({ input: process.stdin, output: process.stdout });
+
+rl.question('\n🔧 Enter the number of the capture device to route: ', (input) => {
+    const index = parseInt(input) - 1;
+    if (isNaN(index) || index < 0 || index >= mics.length) {
+        console.log('❌ Invalid choice.');
+        rl.close();
+        return;
+    }
+
+    // Step 2: stream it to the default output for 20 seconds, printing the counters
+    const route = startPassthrough({ captureId: mics[index].id, latencyMs: 30 });
+    console.log(`✅ Routing "${mics[index].name}" to the default output (route ${route}). Speak now...`);
+
+    const timer = setInterval(() => {
+        const s = getPassthroughStats(route);
+        console.log(
+            `   ${s.captureRate} → ${s.renderRate} Hz | latency ${s.latencyMs.toFixed(1)}/${s.targetLatencyMs.toFixed(1)} ms | ` +
+                `drift ${s.driftPpm.toFixed(1)} ppm | underruns ${s.underruns} | overruns ${s.overruns}`
+        );
+        if (!s.running) console.log(`❌ Route stopped: ${s.error}`);
+    }, 1000);
+
+    setTimeout(() => {
+        clearInterval(timer);
+        stopPassthrough(route);
+        console.log('🛑 Passthrough stopped.');
+        rl.close();
+    }, 20000);
+});
@@ -0,0 +1,38 @@
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { startRecording, getRecordingStats, stopRecording } = require('../index');
+
+const seconds = Number(process.argv[2]) || 10;
+const file = path.join(os.tmpdir(), `loopback-${Date.now()}.wav`);
+
+// Step 1: record what the default output plays (play something to hear it in the file)
+const id = startRecording(file, { format: 's24', patchIntervalMs: 500 });
+console.log(`\n⏺️ Recording the default output for ${seconds} s to ${file}\n`);
+
+// Step 2: every second, show progress and check the file on disk is already a valid WAV
+const timer = setInterval(() => {
+    const s = getRecordingStats(id);
+    const header = Buffer.alloc(4096);
+    const fd = fs.openSync(file, 'r');
+    fs.readSync(fd, header, 0, header.length, 0);
+    fs.closeSync(fd);
+    const declared = header.readUInt32LE(4092);
+    console.log(
+        `   ${(s.durationMs / 1000).toFixed(1)} s | ${(s.bytesWritten / 1048576).toFixed(2)} MB on disk` +
+            ` (header says ${(declared / 1048576).toFixed(2)} MB) | queue ${s.queueDepth}/${s.blocks}` +
+            ` | ${s.writeMBps.toFixed(0)} MB/s | push max ${s.maxPushUs.toFixed(0)} µs` +
+            ` | silence filled ${(s.gapFrames / s.sampleRate).toFixed(1)} s${s.error ? ` | ❌ ${s.error}` : ''}`
+    );
+}, 1000);
+
+// Step 3: stop, then read the finished header back
+setTimeout(() => {
+    clearInterval(timer);
+    const s = stopRecording(id);
+    const header = fs.readFileSync(file).subarray(0, 4096);
+    console.log(`\n🛑 Stopped: ${(s.durationMs / 1000).toFixed(2)} s, ${s.sampleRate} Hz x${s.channels}`);
+    console.log(`   ${header.toString('ascii', 0, 4)} file, data ${header.readUInt32LE(4092)} bytes, ${s.headerPatches} header patches`);
+    console.log(`   dropped ${s.droppedFrames} frame(s), ${s.glitches} glitch(es), max queue ${s.maxQueueDepth}/${s.blocks}`);
+    console.log(`\n📁 ${file}`);
+}, seconds * 1000);
@@ -0,0 +1,121 @@
+/**
+ * Audio service restart recovery through the daemon, against the simulated backend so it
+ * runs anywhere: clients set a default and mutes, the "service" restarts and forgets them,
+ * calls fail with ESERVICELOST meanwhile, and the daemon replays the state once it is back.
+ *
+ * Usage: node ./test/testServiceRecovery.js [downMs]
+ */
+const os = require('os');
+const path = require('path');
+const assert = require('assert');
+const { startDaemonServer } = require('../lib/daemon/server');
+const { connectDaemon } = require('../lib/daemon/client');
+const { createSimulatedBackend } = require('../lib/simulatedBackend');
+
+const DOWN_MS = parseInt(process.argv[2], 10) || 300;
+
+const socketPath = process.platform === 'win32'
+    ? `\\\\.\\pipe\\node-windows-audio-manager-recovery-${process.pid}`
+    : path.join(os.tmpdir(), `node-windows-audio-manager-recovery-${process.pid}.sock`);
+
+function once(emitter, event, timeoutMs) {
+    return new Promise((resolve, reject) => {
+        const timer = setTimeout(() => reject(new Error(`Timed out waiting for ${event}`)), timeoutMs);
+        emitter.once(event, (value) => {
+            clearTimeout(timer);
+            resolve(value);
+        });
+    });
+}
+
+(async () => {
+    const backend = createSimulatedBackend({ deviceCount: 4 });
+    const daemon = await startDaemonServer({
+        backend,
+        path: socketPath,
+        pollIntervalMs: 0,
+        recovery: { initialDelayMs: 20, maxDelayMs: 200 },
+    });
+    const client = await connectDaemon({ path: socketPath });
+    await client.subscribe();
+
+    const devices = await client.listDevices();
+    const target = devices[2];
+    assert.strictEqual(await client.setDefaultDevice(target.id), true);
+    assert.strictEqual(await client.setDefaultPlaybackMute(true), true);
+    assert.strictEqual(await client.muteDeviceById(devices[3].id, true), true);
+    assert.strictEqual(await client.muteDeviceById(devices[3].id, false), true); // latest write wins
+    assert.strictEqual(await client.muteDeviceById(devices[1].id, true), true);
+    console.log(`[JS] Default set to ${target.name}, two devices muted`);
+
+    // Restart the service: state is lost and commands fail fast with a machine-readable code
+    const restartedAt = Date.now();
+    backend.restartService({ downMs: DOWN_MS });
+    const restarted = once(client, 'serviceRestarted', DOWN_MS + 5000);
+    await assert.rejects(client.setDefaultDevice(devices[0].id), (err) => err.code === 'ESERVICELOST');
+    assert.strictEqual(daemon.recovery.stats.recovering, true);
+    console.log('[✓] Commands fail with ESERVICELOST while the service is down');
+
+    // More failures during the outage fold into the same recovery
+    await assert.rejects(client.muteDeviceById(devices[0].id, true), (err) => err.code === 'ESERVICELOST');
+
+    const event = await restarted;
+    const elapsed = Date.now() - restartedAt;
+    console.log(`[✓] serviceRestarted after ${elapsed} ms: ${JSON.stringify(event)}`);
+    assert.strictEqual(event.generation, 1);
+    assert.strictEqual(event.replayed, 4); // default, default mute, two device mutes
+    assert.strictEqual(event.replayFailed, 0);
+    assert.ok(elapsed >= DOWN_MS, 'cannot recover before the service is back');
+    assert.ok(daemon.recovery.stats.attempts > 1, 'probes while down should back off and retry');
+    assert.strictEqual(daemon.recovery.stats.detections, 2);
+    assert.strictEqual(daemon.recovery.stats.restarts, 1);
+
+    // Desired state is back, including the default-mute that followed the default
+    const after = await client.listDevices();
+    assert.strictEqual(after.find((d) => d.isDefault).id, target.id);
+    assert.strictEqual(backend.devices[2].muted, true);
+    assert.strictEqual(backend.devices[3].muted, false);
+    assert.strictEqual(backend.devices[1].muted, true);
+    assert.strictEqual(backend.devices[0].muted, false); // the failed write was never recorded
+    console.log('[✓] Default device and mutes replayed');
+
+    // Commands work again and a second restart is a fresh recovery
+    assert.strictEqual(await client.setDefaultDevice(devices[1].id), true);
+    backend.restartService({ downMs: 50 });
+    const again = once(client, 'serviceRestarted', 5000);
+    await assert.rejects(client.listDevices().then(() => client.setDefaultPlaybackMute(false)));
+    assert.strictEqual((await again).generation, 2);
+    assert.strictEqual((await client.listDevices()).find((d) => d.isDefault).id, devices[1].id);
+    console.log('[✓] Second restart recovered');
+
+    client.close();
+    await daemon.close();
+
+    // A backend that recovers natively (the addon) replays its own state: the daemon only
+    // reports the restart
+    const native = { ...createSimulatedBackend({ deviceCount: 2 }), recoversNatively: true };
+    const nativeDaemon = await startDaemonServer({
+        backend: native,
+        path: socketPath,
+        pollIntervalMs: 0,
+        recovery: { initialDelayMs: 20, maxDelayMs: 200 },
+    });
+    const nativeClient = await connectDaemon({ path: socketPath });
+    await nativeClient.subscribe();
+    assert.strictEqual(await nativeClient.muteDeviceById(native.devices[1].id, true), true);
+    native.restartService({ downMs: 50 });
+    const reported = once(nativeClient, 'serviceRestarted', 5000);
+    await assert.rejects(nativeClient.setDefaultPlaybackMute(true), (err) => err.code === 'ESERVICELOST');
+    const nativeEvent = await reported;
+    assert.strictEqual(nativeEvent.replayed, 0);
+    assert.strictEqual(nativeEvent.replayFailed, 0);
+    assert.strictEqual(native.calls.muteDeviceById, 1, 'the daemon must not replay over the addon');
+    console.log('[✓] Native recovery is reported without a second replay');
+
+    nativeClient.close();
+    await nativeDaemon.close();
+    console.log('[✓] Service recovery test passed.');
+})().catch((err) => {
+    console.error('[x] Service recovery test failed:', err);
+    process.exit(1);
+});
@@ -0,0 +1,34 @@
+const { listDevices, prepareTestSignal, playTestSignal, getTestSignals, stopTestSignal } = require('../index');
+
+const wait = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+(async () => {
+    const devices = listDevices();
+
+    // Step 1: open every stream once, so each start below is a warm restart
+    let start = process.hrtime.bigint();
+    const ids = prepareTestSignal(devices.map((d) => d.id));
+    console.log(`\n📢 Opened ${ids.length} stream(s) in ${(Number(process.hrtime.bigint() - start) / 1e6).toFixed(1)} ms`);
+
+    // Step 2: one signal per endpoint in turn
+    const signals = [
+        { type: 'sine', frequency: 1000 },
+        { type: 'pink' },
+        { type: 'sweep', frequency: 50, endFrequency: 16000, sweepMs: 2000 },
+        { type: 'clicks', intervalMs: 250, levelDb: -12 },
+    ];
+    for (const device of devices) {
+        for (const signal of signals) {
+            const result = playTestSignal({ deviceId: device.id, levelDb: -20, ...signal });
+            console.log(`🔊 ${device.name}: ${signal.type} (${result.sampleRate} Hz, ${result.channels} ch) started in ${result.startMs.toFixed(2)} ms`);
+            await wait(1000);
+        }
+        stopTestSignal(device.id);
+    }
+
+    // Step 3: every endpoint at once
+    devices.forEach((d, i) => playTestSignal({ deviceId: d.id, frequency: 440 * (i + 1), durationMs: 2000 }));
+    await wait(2500);
+    console.log('\n📊', getTestSignals());
+    console.log(`✅ Stopped ${stopTestSignal(null, { release: true })} stream(s)`);
+})();
@@ -0,0 +1,21 @@
+const { getDeviceSnapshot, getDeviceTopology, getTopologyCacheStats } = require('../index');
+
+// Step 1: first call walks every endpoint's graph
+let start = process.hrtime.bigint();
+const topologies = getDeviceTopology();
+console.log(`\n🧬 Walked ${topologies.length} endpoint(s) in ${(Number(process.hrtime.bigint() - start) / 1e6).toFixed(1)} ms`);
+
+const names = new Map(getDeviceSnapshot().map((d) => [d.id, d.name]));
+topologies.forEach((t) => {
+    const hw = Object.entries(t.hardware).filter(([, v]) => v).map(([k]) => k);
+    console.log(`\n🔊 ${names.get(t.id) || t.id}`);
+    console.log(`   hardware: ${hw.length ? hw.join(', ') : 'none (software volume/mute)'}`);
+    console.log(`   path: ${t.parts.map((p) => `${p.name || p.subType}${p.controls.length ? ` [${p.controls.join('/')}]` : ''}`).join(' → ')}`);
+    t.jacks.forEach((j) => console.log(`   jack: ${j.connectionType} ${j.geoLocation} ${j.color} ${j.connected ? 'plugged' : 'empty'}`));
+});
+
+// Step 2: later queries are served from the cache
+start = process.hrtime.bigint();
+for (let i = 0; i < 100; i++) getDeviceTopology();
+console.log(`\n⚡ 100 cached queries in ${(Number(process.hrtime.bigint() - start) / 1e6).toFixed(1)} ms`);
+console.log('📊 Cache:', getTopologyCacheStats());
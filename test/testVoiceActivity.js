@@ -0,0 +1,36 @@
+const { getDeviceSnapshot, startVoiceActivity, getVoiceActivity, stopVoiceActivity } = require('../index');
+
+const seconds = Number(process.argv[2]) || 20;
+const names = new Map(getDeviceSnapshot({ refresh: true }).map((e) => [e.id, e.name]));
+
+// Step 1: listen on every active microphone at once
+const id = startVoiceActivity();
+const { endpoints } = getVoiceActivity(id);
+console.log(`\n🗣️ Listening on ${endpoints.length} microphone(s) for ${seconds} s; speak into one of them.\n`);
+endpoints.forEach((e) =>
+    console.log(`   ${names.get(e.id) || e.id}: ${e.sampleRate} Hz x${e.channels}${e.error ? ` | ❌ ${e.error}` : ''}`)
+);
+console.log('');
+
+// Step 2: every half second, show each microphone's probability and which one wins
+const timer = setInterval(() => {
+    const s = getVoiceActivity(id);
+    const bars = s.endpoints
+        .map((e) => `${(names.get(e.id) || e.id).slice(0, 18).padEnd(18)} ${'█'.repeat(Math.round(e.probability * 10)).padEnd(10, '·')}`)
+        .join(' | ');
+    const active = s.activeDeviceId ? names.get(s.activeDeviceId) || s.activeDeviceId : '-';
+    console.log(`   ${bars} | active: ${active} | load ${s.loadPercent.toFixed(2)} %`);
+}, 500);
+
+// Step 3: stop and show how long each microphone heard speech
+setTimeout(() => {
+    clearInterval(timer);
+    const s = stopVoiceActivity(id);
+    console.log('\n🛑 Stopped.');
+    s.endpoints.forEach((e) =>
+        console.log(
+            `   ${names.get(e.id) || e.id}: speech ${(e.speechMs / 1000).toFixed(1)} s, noise floor ${e.noiseDb.toFixed(1)} dBFS` +
+                `${e.error ? ` | ❌ ${e.error}` : ''}`
+        )
+    );
+}, seconds * 1000);